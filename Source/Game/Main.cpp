@@ -12,7 +12,6 @@
 #include "Common.h"
 
 #include <cstdio>
-#include <fstream>
 #include <memory>
 
 #include "Cube/Cube.h"
@@ -24,6 +23,8 @@
 #include "Scene/Scene.h"
 #include "Scene/Voxel.h"
 #include "Shader/SkyMapVertexShader.h"
+#include "Shader/TerrainVertexShader.h"
+#include "Shader/VoxelVertexShader.h"
 
 /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
   Function: wWinMain
@@ -53,11 +54,9 @@ INT WINAPI wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance,
 
     std::unique_ptr<library::Game> game = std::make_unique<library::Game>(L"Game Graphics Programming Assignment 3: Cube Mapping");
 
-    std::ofstream sceneFile;
-    sceneFile.open("HeightMap.txt");
-    constexpr const UINT MAP_WIDTH = 0;
-    constexpr const UINT MAP_HEIGHT = 0;
-    constexpr const UINT MAP_DEPTH = 0;
+    constexpr const UINT MAP_WIDTH = 2048;
+    constexpr const UINT MAP_HEIGHT = 64;
+    constexpr const UINT MAP_DEPTH = 2048;
     XMFLOAT4 aColors[] =
     {
         XMFLOAT4(0.0f,      0.666f, 0.0f,   1.0f),  // GRASSLAND
@@ -77,139 +76,15 @@ INT WINAPI wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance,
         XMFLOAT4(0.15f,     0.372f, 0.15f,  1.0f),  // TROPICAL_RAIN_FOREST
     };
 
-    sceneFile << MAP_WIDTH << " " << MAP_HEIGHT << " " << MAP_DEPTH << ' ' << ARRAYSIZE(aColors) << '\n';
-
+    std::vector<XMFLOAT3> aPalette;
+    aPalette.reserve(ARRAYSIZE(aColors));
     for (UINT colorIdx = 0; colorIdx < ARRAYSIZE(aColors); ++colorIdx)
     {
-        sceneFile << aColors[colorIdx].x << ' ' <<
-            aColors[colorIdx].y << ' ' <<
-            aColors[colorIdx].z << '\n';
+        aPalette.push_back(XMFLOAT3(aColors[colorIdx].x, aColors[colorIdx].y, aColors[colorIdx].z));
     }
 
-    for (UINT z = 0u; z < MAP_DEPTH; ++z)
-    {
-        for (UINT x = 0u; x < MAP_WIDTH; ++x)
-        {
-            FLOAT height = 0.0f;
-
-            FLOAT frequencySum = 0.0f;
-            for (UINT i = 0; i < 4; ++i)
-            {
-                FLOAT frequency = pow(2.0f, static_cast<FLOAT>(i));
-                frequencySum += 1.0f / frequency;
-                height += library::Scene::GetPerlin2d(frequency * static_cast<FLOAT>(x), frequency * static_cast<FLOAT>(z), 0.1f, 4u) / frequency;
-            }
-            height /= frequencySum;
-            height = pow(height * 1.2f, 1.25f);
-
-            assert(height >= 0.0f);
-
-            FLOAT moisture = 0.0f;
-
-            frequencySum = 0.0f;
-            for (UINT i = 0; i < 4; ++i)
-            {
-                FLOAT frequency = pow(2.0f, static_cast<FLOAT>(i));
-                frequencySum += 1.0f / frequency;
-                moisture += library::Scene::GetPerlin2d(frequency * static_cast<FLOAT>(x), frequency * static_cast<FLOAT>(z), 0.1f, 4u) / frequency;
-            }
-            moisture /= frequencySum;
-            moisture = pow(moisture * 1.2f, 1.25f);
-
-            library::eBlockType blockType = library::eBlockType::GRASSLAND;
-
-            if (height < 0.1f)
-            {
-                blockType = library::eBlockType::OCEAN;
-            }
-            else if (height < 0.12f)
-            {
-                blockType = library::eBlockType::SAND;
-            }
-            else if (height > 0.8f)
-            {
-                if (moisture < 0.1f)
-                {
-                    blockType = library::eBlockType::SCORCHED;
-                }
-                else if (moisture < 0.2f)
-                {
-                    blockType = library::eBlockType::BARE;
-                }
-                else if (moisture < 0.5f)
-                {
-                    blockType = library::eBlockType::TUNDRA;
-                }
-                else
-                {
-                    blockType = library::eBlockType::SNOW;
-                }
-            }
-            else if (height > 0.6f)
-            {
-                if (moisture < 0.33f)
-                {
-                    blockType = library::eBlockType::TEMPERATE_DESERT;
-                }
-                else if (moisture < 0.66f)
-                {
-                    blockType = library::eBlockType::SHRUBLAND;
-                }
-                else
-                {
-                    blockType = library::eBlockType::TAIGA;
-                }
-            }
-            else if (height > 0.3f)
-            {
-                if (moisture < 0.16f)
-                {
-                    blockType = library::eBlockType::TEMPERATE_DESERT;
-                }
-                else if (moisture < 0.5f)
-                {
-                    blockType = library::eBlockType::GRASSLAND;
-                }
-                else if (moisture < 0.83f)
-                {
-                    blockType = library::eBlockType::TEMPERATE_DECIDUOUS_FOREST;
-                }
-                else
-                {
-                    blockType = library::eBlockType::TEMPERATE_RAIN_FOREST;
-                }
-            }
-            else
-            {
-
-                if (moisture < 0.16f)
-                {
-                    blockType = library::eBlockType::SUBTROPICAL_DESERT;
-                }
-                else if (moisture < 0.33f)
-                {
-                    blockType = library::eBlockType::GRASSLAND;
-                }
-                else if (moisture < 0.66f)
-                {
-                    blockType = library::eBlockType::TROPICAL_SEASONAL_FOREST;
-                }
-                else
-                {
-                    blockType = library::eBlockType::TROPICAL_RAIN_FOREST;
-                }
-            }
-
-            sceneFile << static_cast<CHAR>(blockType);
-
-            sceneFile << height << ' ';
-        }
-        sceneFile << '\n';
-    }
-    sceneFile << std::endl;
-    sceneFile.close();
-
-	std::shared_ptr<library::Scene> mainScene = std::make_shared<library::Scene>(L"HeightMap.txt");
+    // Chunks are generated around the camera as it moves
+    std::shared_ptr<library::Scene> mainScene = std::make_shared<library::Scene>(0u, MAP_WIDTH, MAP_HEIGHT, MAP_DEPTH, aPalette, library::eVoxelRenderMode::GREEDY_MESH);
 
 	// Phong
 	std::shared_ptr<library::VertexShader> phongVertexShader = std::make_shared<library::VertexShader>(L"Shaders/PhongShaders.fxh", "VSPhong", "vs_5_0");
@@ -218,11 +93,22 @@ INT WINAPI wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance,
 		return 0;
 	}
 	// Voxel
-	std::shared_ptr<library::VertexShader> voxelVertexShader = std::make_shared<library::VertexShader>(L"Shaders/VoxelShaders.fxh", "VSVoxel", "vs_5_0");
+	std::shared_ptr<library::VertexShader> voxelVertexShader = std::make_shared<library::VoxelVertexShader>(L"Shaders/VoxelShaders.fxh", "VSVoxel", "vs_5_0");
 	if (FAILED(mainScene->AddVertexShader(L"VoxelShader", voxelVertexShader)))
 	{
 		return 0;
 	}
+	std::shared_ptr<library::VertexShader> voxelMeshVertexShader = std::make_shared<library::VertexShader>(L"Shaders/VoxelShaders.fxh", "VSVoxelMesh", "vs_5_0");
+	if (FAILED(mainScene->AddVertexShader(L"VoxelMeshShader", voxelMeshVertexShader)))
+	{
+		return 0;
+	}
+	// Terrain
+	std::shared_ptr<library::VertexShader> terrainVertexShader = std::make_shared<library::TerrainVertexShader>(L"Shaders/VoxelShaders.fxh", "VSTerrain", "vs_5_0");
+	if (FAILED(mainScene->AddVertexShader(L"TerrainShader", terrainVertexShader)))
+	{
+		return 0;
+	}
 	// Light Cube
 	std::shared_ptr<library::VertexShader> lightVertexShader = std::make_shared<library::VertexShader>(L"Shaders/PhongShaders.fxh", "VSLightCube", "vs_5_0");
 	if (FAILED(mainScene->AddVertexShader(L"LightShader", lightVertexShader)))
@@ -261,6 +147,12 @@ INT WINAPI wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance,
 	{
 		return 0;
 	}
+	// Terrain
+	std::shared_ptr<library::PixelShader> terrainPixelShader = std::make_shared<library::PixelShader>(L"Shaders/VoxelShaders.fxh", "PSTerrain", "ps_5_0");
+	if (FAILED(mainScene->AddPixelShader(L"TerrainShader", terrainPixelShader)))
+	{
+		return 0;
+	}
 	// Light Cube
 	std::shared_ptr<library::PixelShader> lightPixelShader = std::make_shared<library::PixelShader>(L"Shaders/PhongShaders.fxh", "PSLightCube", "ps_5_0");
 	if (FAILED(mainScene->AddPixelShader(L"LightShader", lightPixelShader)))
@@ -296,6 +188,21 @@ INT WINAPI wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance,
 		return 0;
 	}
 
+	if (FAILED(mainScene->SetVertexShaderOfVoxelMesh(L"VoxelMeshShader")))
+	{
+		return 0;
+	}
+
+	if (FAILED(mainScene->SetVertexShaderOfTerrain(L"TerrainShader")))
+	{
+		return 0;
+	}
+
+	if (FAILED(mainScene->SetPixelShaderOfTerrain(L"TerrainShader")))
+	{
+		return 0;
+	}
+
 	game->GetRenderer()->SetShadowMapShaders(shadowMapVertexShader, shadowMapPixelShader);
 
 	std::shared_ptr<library::Skybox> skybox = std::make_shared<library::Skybox>(L"Content/Common/Maskonaive2_1024.dds", 800.0f);
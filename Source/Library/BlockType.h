@@ -0,0 +1,37 @@
+/*+===================================================================
+  File:      BLOCKTYPE.H
+
+  Summary:   BlockType header file contains the declaration of the
+             block types of a voxel map, shared by the Windows
+             renderer and the headless terrain tools.
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+namespace library
+{
+    /*E+E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E
+        Enum:     eBlockType
+        Summary:  Enumeration of block types
+    E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E-E*/
+    enum class eBlockType : CHAR
+    {
+        GRASSLAND = 21,
+        SNOW,
+        OCEAN,
+        SAND,
+        SCORCHED,
+        BARE,
+        TUNDRA,
+        TEMPERATE_DESERT,
+        SHRUBLAND,
+        TAIGA,
+        TEMPERATE_DECIDUOUS_FOREST,
+        TEMPERATE_RAIN_FOREST,
+        SUBTROPICAL_DESERT,
+        TROPICAL_SEASONAL_FOREST,
+        TROPICAL_RAIN_FOREST,
+        COUNT,
+    };
+}
@@ -40,6 +40,7 @@
 #include <unordered_set>
 #include <vector>
 
+#include "BlockType.h"
 #include "Resource.h"
 
 constexpr LPCWSTR PSZ_COURSE_TITLE = L"Game Graphics Programming";
@@ -76,26 +77,14 @@ namespace library
     };
 
     /*E+E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E
-        Enum:     eBlockType
-        Summary:  Enumeration of block types
+        Enum:     eVoxelRenderMode
+        Summary:  Enumeration of the ways the voxel map is drawn
     E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E-E*/
-    enum class eBlockType : CHAR
+    enum class eVoxelRenderMode : BYTE
     {
-        GRASSLAND = 21,
-        SNOW,
-        OCEAN,
-        SAND,
-        SCORCHED,
-        BARE,
-        TUNDRA,
-        TEMPERATE_DESERT,
-        SHRUBLAND,
-        TAIGA,
-        TEMPERATE_DECIDUOUS_FOREST,
-        TEMPERATE_RAIN_FOREST,
-        SUBTROPICAL_DESERT,
-        TROPICAL_SEASONAL_FOREST,
-        TROPICAL_RAIN_FOREST,
+        INSTANCED,
+        GREEDY_MESH,
+        HEIGHTFIELD,
         COUNT,
     };
 }
\ No newline at end of file
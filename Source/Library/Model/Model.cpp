@@ -1,5 +1,7 @@
 ﻿#include "Model/Model.h"
 
+#include <cfloat>
+
 #include "assimp/Importer.hpp"	// C++ importer interface
 #include "assimp/scene.h"		// output data structure
 #include "assimp/postprocess.h"	// post processing flags
@@ -294,6 +296,21 @@ namespace library
         return m_boneNameToIndexMap;
     }
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+        Method:   Model::HasAnimations
+
+        Summary:  Returns whether the model is animated, so its meshes
+                  can move out of their bounds in the bind pose
+
+        Returns:  BOOL
+                    TRUE if the model file has animations
+
+     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL Model::HasAnimations() const
+    {
+        return m_pScene && m_pScene->HasAnimations();
+    }
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
         Method:   Model::countVerticesAndIndices
 
@@ -680,11 +697,16 @@ namespace library
                   Index of mesh
                 const aiMesh* pMesh
                   Point to an assimp mesh object
+
+      Modifies: [m_aVertices, m_aNormalData, m_aIndices, m_aMeshes].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     void Model::initSingleMesh(_In_ UINT uMeshIndex, _In_ const aiMesh* pMesh)
     {
         const aiVector3D zero3d(0.0f, 0.0f, 0.0f);
 
+        XMVECTOR minCorner = XMVectorReplicate(FLT_MAX);
+        XMVECTOR maxCorner = XMVectorReplicate(-FLT_MAX);
+
         // Populate the vertex attribute vector
         for (UINT i = 0u; i < pMesh->mNumVertices; ++i)
         {
@@ -703,6 +725,9 @@ namespace library
 
             m_aVertices.push_back(vertex);
 
+            minCorner = XMVectorMin(minCorner, XMLoadFloat3(&vertex.Position));
+            maxCorner = XMVectorMax(maxCorner, XMLoadFloat3(&vertex.Position));
+
             NormalData normalData =
             {
                 .Tangent = XMFLOAT3(tangent.x, tangent.y, tangent.z),
@@ -730,6 +755,13 @@ namespace library
             m_aIndices.push_back(aIndices[2]);
         }
 
+        // Bounds of the mesh in the bind pose
+        if (pMesh->mNumVertices > 0u)
+        {
+            BoundingBox::CreateFromPoints(m_aMeshes[uMeshIndex].boundingBox, minCorner, maxCorner);
+            m_aMeshes[uMeshIndex].bHasBoundingBox = TRUE;
+        }
+
         initMeshBones(uMeshIndex, pMesh);
     }
 
@@ -57,6 +57,8 @@ namespace library
                 GetNumIndices
                   Pure virtual function that returns the number of
                   indices
+                HasAnimations
+                  Returns whether the model is animated
                 Model
                   Constructor.
                 ~Model
@@ -84,6 +86,7 @@ namespace library
 
         std::vector<XMMATRIX>& GetBoneTransforms();
         const std::unordered_map<std::string, UINT>& GetBoneNameToIndexMap() const;
+        BOOL HasAnimations() const;
 
     protected:
         struct VertexBoneData
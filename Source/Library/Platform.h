@@ -0,0 +1,142 @@
+/*+===================================================================
+  File:      PLATFORM.H
+
+  Summary:   Platform header file that the parts of the Library
+             without Direct3D include instead of Common.h, so they
+             also build without the Windows SDK, e.g. to generate
+             maps on Linux servers. On Windows it is Common.h.
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#ifdef _WIN32
+
+#include "Common.h"
+
+#else
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+typedef int BOOL;
+typedef std::int32_t HRESULT;
+typedef char CHAR;
+typedef wchar_t WCHAR;
+typedef unsigned char BYTE;
+typedef unsigned short WORD;
+typedef int INT;
+typedef unsigned int UINT;
+typedef std::int64_t INT64;
+typedef std::uint64_t UINT64;
+typedef float FLOAT;
+typedef double DOUBLE;
+typedef const wchar_t* PCWSTR;
+
+#ifndef TRUE
+#define TRUE 1
+#endif // ! TRUE
+
+#ifndef FALSE
+#define FALSE 0
+#endif // ! FALSE
+
+#define S_OK static_cast<HRESULT>(0)
+#define E_FAIL static_cast<HRESULT>(0x80004005u)
+#define E_INVALIDARG static_cast<HRESULT>(0x80070057u)
+#define E_OUTOFMEMORY static_cast<HRESULT>(0x8007000Eu)
+#define SUCCEEDED(hr) (static_cast<HRESULT>(hr) >= 0)
+#define FAILED(hr) (static_cast<HRESULT>(hr) < 0)
+
+#define ARRAYSIZE(a) (sizeof(a) / sizeof(*(a)))
+
+#define _In_
+#define _In_opt_
+#define _In_reads_(size)
+#define _In_reads_opt_(size)
+#define _Inout_
+#define _Out_
+#define _Out_opt_
+#define _Out_writes_(size)
+#define _Out_writes_opt_(size)
+
+// Direct3D objects are only passed through by pointer, e.g. to a mock context
+struct ID3D11Buffer;
+struct ID3D11DepthStencilView;
+struct ID3D11InputLayout;
+struct ID3D11PixelShader;
+struct ID3D11RenderTargetView;
+struct ID3D11SamplerState;
+struct ID3D11ShaderResourceView;
+struct ID3D11VertexShader;
+enum DXGI_FORMAT : int;
+
+// The formats the headless parts bind, with their values in dxgiformat.h
+constexpr const DXGI_FORMAT DXGI_FORMAT_R16_UINT = static_cast<DXGI_FORMAT>(57);
+
+// Storage types of DirectXMath with the same layout, e.g. for the
+// palette of a voxel map, the vertices of a greedy mesh and the cells
+// of an octree
+namespace DirectX
+{
+    struct XMFLOAT2
+    {
+        float x;
+        float y;
+
+        XMFLOAT2() = default;
+        constexpr XMFLOAT2(float _x, float _y) : x(_x), y(_y) {}
+    };
+
+    struct XMFLOAT3
+    {
+        float x;
+        float y;
+        float z;
+
+        XMFLOAT3() = default;
+        constexpr XMFLOAT3(float _x, float _y, float _z) : x(_x), y(_y), z(_z) {}
+    };
+
+    struct XMFLOAT4
+    {
+        float x;
+        float y;
+        float z;
+        float w;
+
+        XMFLOAT4() = default;
+        constexpr XMFLOAT4(float _x, float _y, float _z, float _w) : x(_x), y(_y), z(_z), w(_w) {}
+    };
+
+    struct XMINT3
+    {
+        std::int32_t x;
+        std::int32_t y;
+        std::int32_t z;
+
+        XMINT3() = default;
+        constexpr XMINT3(std::int32_t _x, std::int32_t _y, std::int32_t _z) : x(_x), y(_y), z(_z) {}
+    };
+
+    struct XMUINT3
+    {
+        std::uint32_t x;
+        std::uint32_t y;
+        std::uint32_t z;
+
+        XMUINT3() = default;
+        constexpr XMUINT3(uint32_t _x, uint32_t _y, uint32_t _z) : x(_x), y(_y), z(_z) {}
+    };
+}
+
+using namespace DirectX;
+
+#include "BlockType.h"
+
+#endif // _WIN32
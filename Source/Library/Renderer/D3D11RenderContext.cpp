@@ -0,0 +1,237 @@
+#include "Renderer/D3D11RenderContext.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   D3D11RenderContext::D3D11RenderContext
+
+      Summary:  Constructor
+
+      Args:     ID3D11DeviceContext* pImmediateContext
+                  The Direct3D context to call
+
+      Modifies: [m_immediateContext].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    D3D11RenderContext::D3D11RenderContext(_In_ ID3D11DeviceContext* pImmediateContext)
+        : m_immediateContext(pImmediateContext)
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   D3D11RenderContext::IASetInputLayout
+
+      Summary:  Binds an input layout
+
+      Args:     ID3D11InputLayout* pInputLayout
+                  Input layout, or null
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void D3D11RenderContext::IASetInputLayout(_In_opt_ ID3D11InputLayout* pInputLayout)
+    {
+        m_immediateContext->IASetInputLayout(pInputLayout);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   D3D11RenderContext::IASetVertexBuffers
+
+      Summary:  Binds vertex buffers
+
+      Args:     UINT uStartSlot
+                  First slot
+                UINT uNumBuffers
+                  Number of slots
+                ID3D11Buffer* const* ppVertexBuffers
+                  Buffer of every slot
+                const UINT* puStrides
+                  Stride of every slot
+                const UINT* puOffsets
+                  Offset of every slot
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void D3D11RenderContext::IASetVertexBuffers(_In_ UINT uStartSlot, _In_ UINT uNumBuffers, _In_reads_(uNumBuffers) ID3D11Buffer* const* ppVertexBuffers, _In_reads_(uNumBuffers) const UINT* puStrides, _In_reads_(uNumBuffers) const UINT* puOffsets)
+    {
+        m_immediateContext->IASetVertexBuffers(uStartSlot, uNumBuffers, ppVertexBuffers, puStrides, puOffsets);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   D3D11RenderContext::IASetIndexBuffer
+
+      Summary:  Binds an index buffer
+
+      Args:     ID3D11Buffer* pIndexBuffer
+                  Index buffer, or null
+                DXGI_FORMAT format
+                  Format of the indices
+                UINT uOffset
+                  Offset of the first index
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void D3D11RenderContext::IASetIndexBuffer(_In_opt_ ID3D11Buffer* pIndexBuffer, _In_ DXGI_FORMAT format, _In_ UINT uOffset)
+    {
+        m_immediateContext->IASetIndexBuffer(pIndexBuffer, format, uOffset);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   D3D11RenderContext::VSSetShader
+
+      Summary:  Binds a vertex shader
+
+      Args:     ID3D11VertexShader* pVertexShader
+                  Vertex shader, or null
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void D3D11RenderContext::VSSetShader(_In_opt_ ID3D11VertexShader* pVertexShader)
+    {
+        m_immediateContext->VSSetShader(pVertexShader, nullptr, 0u);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   D3D11RenderContext::PSSetShader
+
+      Summary:  Binds a pixel shader
+
+      Args:     ID3D11PixelShader* pPixelShader
+                  Pixel shader, or null
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void D3D11RenderContext::PSSetShader(_In_opt_ ID3D11PixelShader* pPixelShader)
+    {
+        m_immediateContext->PSSetShader(pPixelShader, nullptr, 0u);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   D3D11RenderContext::VSSetConstantBuffers
+
+      Summary:  Binds constant buffers to the vertex shader
+
+      Args:     UINT uStartSlot
+                  First slot
+                UINT uNumBuffers
+                  Number of slots
+                ID3D11Buffer* const* ppConstantBuffers
+                  Buffer of every slot
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void D3D11RenderContext::VSSetConstantBuffers(_In_ UINT uStartSlot, _In_ UINT uNumBuffers, _In_reads_(uNumBuffers) ID3D11Buffer* const* ppConstantBuffers)
+    {
+        m_immediateContext->VSSetConstantBuffers(uStartSlot, uNumBuffers, ppConstantBuffers);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   D3D11RenderContext::PSSetConstantBuffers
+
+      Summary:  Binds constant buffers to the pixel shader
+
+      Args:     UINT uStartSlot
+                  First slot
+                UINT uNumBuffers
+                  Number of slots
+                ID3D11Buffer* const* ppConstantBuffers
+                  Buffer of every slot
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void D3D11RenderContext::PSSetConstantBuffers(_In_ UINT uStartSlot, _In_ UINT uNumBuffers, _In_reads_(uNumBuffers) ID3D11Buffer* const* ppConstantBuffers)
+    {
+        m_immediateContext->PSSetConstantBuffers(uStartSlot, uNumBuffers, ppConstantBuffers);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   D3D11RenderContext::VSSetShaderResources
+
+      Summary:  Binds shader resource views to the vertex shader
+
+      Args:     UINT uStartSlot
+                  First slot
+                UINT uNumViews
+                  Number of slots
+                ID3D11ShaderResourceView* const* ppShaderResourceViews
+                  View of every slot
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void D3D11RenderContext::VSSetShaderResources(_In_ UINT uStartSlot, _In_ UINT uNumViews, _In_reads_(uNumViews) ID3D11ShaderResourceView* const* ppShaderResourceViews)
+    {
+        m_immediateContext->VSSetShaderResources(uStartSlot, uNumViews, ppShaderResourceViews);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   D3D11RenderContext::PSSetShaderResources
+
+      Summary:  Binds shader resource views to the pixel shader
+
+      Args:     UINT uStartSlot
+                  First slot
+                UINT uNumViews
+                  Number of slots
+                ID3D11ShaderResourceView* const* ppShaderResourceViews
+                  View of every slot
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void D3D11RenderContext::PSSetShaderResources(_In_ UINT uStartSlot, _In_ UINT uNumViews, _In_reads_(uNumViews) ID3D11ShaderResourceView* const* ppShaderResourceViews)
+    {
+        m_immediateContext->PSSetShaderResources(uStartSlot, uNumViews, ppShaderResourceViews);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   D3D11RenderContext::PSSetSamplers
+
+      Summary:  Binds samplers to the pixel shader
+
+      Args:     UINT uStartSlot
+                  First slot
+                UINT uNumSamplers
+                  Number of slots
+                ID3D11SamplerState* const* ppSamplers
+                  Sampler of every slot
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void D3D11RenderContext::PSSetSamplers(_In_ UINT uStartSlot, _In_ UINT uNumSamplers, _In_reads_(uNumSamplers) ID3D11SamplerState* const* ppSamplers)
+    {
+        m_immediateContext->PSSetSamplers(uStartSlot, uNumSamplers, ppSamplers);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   D3D11RenderContext::OMSetRenderTargets
+
+      Summary:  Binds render targets and a depth stencil view
+
+      Args:     UINT uNumViews
+                  Number of render targets
+                ID3D11RenderTargetView* const* ppRenderTargetViews
+                  View of every render target
+                ID3D11DepthStencilView* pDepthStencilView
+                  Depth stencil view, or null
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void D3D11RenderContext::OMSetRenderTargets(_In_ UINT uNumViews, _In_reads_opt_(uNumViews) ID3D11RenderTargetView* const* ppRenderTargetViews, _In_opt_ ID3D11DepthStencilView* pDepthStencilView)
+    {
+        m_immediateContext->OMSetRenderTargets(uNumViews, ppRenderTargetViews, pDepthStencilView);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   D3D11RenderContext::DrawIndexed
+
+      Summary:  Draws indexed primitives
+
+      Args:     UINT uIndexCount
+                  Number of indices
+                UINT uStartIndexLocation
+                  First index
+                INT iBaseVertexLocation
+                  Added to every index
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void D3D11RenderContext::DrawIndexed(_In_ UINT uIndexCount, _In_ UINT uStartIndexLocation, _In_ INT iBaseVertexLocation)
+    {
+        m_immediateContext->DrawIndexed(uIndexCount, uStartIndexLocation, iBaseVertexLocation);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   D3D11RenderContext::DrawIndexedInstanced
+
+      Summary:  Draws instances of indexed primitives
+
+      Args:     UINT uIndexCountPerInstance
+                  Number of indices of an instance
+                UINT uInstanceCount
+                  Number of instances
+                UINT uStartIndexLocation
+                  First index
+                INT iBaseVertexLocation
+                  Added to every index
+                UINT uStartInstanceLocation
+                  First instance
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void D3D11RenderContext::DrawIndexedInstanced(_In_ UINT uIndexCountPerInstance, _In_ UINT uInstanceCount, _In_ UINT uStartIndexLocation, _In_ INT iBaseVertexLocation, _In_ UINT uStartInstanceLocation)
+    {
+        m_immediateContext->DrawIndexedInstanced(uIndexCountPerInstance, uInstanceCount, uStartIndexLocation, iBaseVertexLocation, uStartInstanceLocation);
+    }
+
+}
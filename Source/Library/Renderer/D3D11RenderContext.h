@@ -0,0 +1,84 @@
+/*+===================================================================
+  File:      D3D11RENDERCONTEXT.H
+
+  Summary:   D3D11RenderContext header file contains declarations of
+             the D3D11RenderContext class that forwards the calls of
+             a RenderContext to a Direct3D 11 immediate context.
+
+  Classes: D3D11RenderContext
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Renderer/RenderContext.h"
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    D3D11RenderContext
+
+      Summary:  RenderContext that calls the immediate context for
+                every call, as is
+
+      Methods:  IASetInputLayout
+                  Binds an input layout
+                IASetVertexBuffers
+                  Binds vertex buffers
+                IASetIndexBuffer
+                  Binds an index buffer
+                VSSetShader
+                  Binds a vertex shader
+                PSSetShader
+                  Binds a pixel shader
+                VSSetConstantBuffers
+                  Binds constant buffers to the vertex shader
+                PSSetConstantBuffers
+                  Binds constant buffers to the pixel shader
+                VSSetShaderResources
+                  Binds shader resource views to the vertex shader
+                PSSetShaderResources
+                  Binds shader resource views to the pixel shader
+                PSSetSamplers
+                  Binds samplers to the pixel shader
+                OMSetRenderTargets
+                  Binds render targets and a depth stencil view
+                DrawIndexed
+                  Draws indexed primitives
+                DrawIndexedInstanced
+                  Draws instances of indexed primitives
+                D3D11RenderContext
+                  Constructor.
+                ~D3D11RenderContext
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class D3D11RenderContext final : public RenderContext
+    {
+    public:
+        D3D11RenderContext(_In_ ID3D11DeviceContext* pImmediateContext);
+        D3D11RenderContext(const D3D11RenderContext& other) = delete;
+        D3D11RenderContext(D3D11RenderContext&& other) = delete;
+        D3D11RenderContext& operator=(const D3D11RenderContext& other) = delete;
+        D3D11RenderContext& operator=(D3D11RenderContext&& other) = delete;
+        virtual ~D3D11RenderContext() = default;
+
+        void IASetInputLayout(_In_opt_ ID3D11InputLayout* pInputLayout) override;
+        void IASetVertexBuffers(_In_ UINT uStartSlot, _In_ UINT uNumBuffers, _In_reads_(uNumBuffers) ID3D11Buffer* const* ppVertexBuffers, _In_reads_(uNumBuffers) const UINT* puStrides, _In_reads_(uNumBuffers) const UINT* puOffsets) override;
+        void IASetIndexBuffer(_In_opt_ ID3D11Buffer* pIndexBuffer, _In_ DXGI_FORMAT format, _In_ UINT uOffset) override;
+        void VSSetShader(_In_opt_ ID3D11VertexShader* pVertexShader) override;
+        void PSSetShader(_In_opt_ ID3D11PixelShader* pPixelShader) override;
+        void VSSetConstantBuffers(_In_ UINT uStartSlot, _In_ UINT uNumBuffers, _In_reads_(uNumBuffers) ID3D11Buffer* const* ppConstantBuffers) override;
+        void PSSetConstantBuffers(_In_ UINT uStartSlot, _In_ UINT uNumBuffers, _In_reads_(uNumBuffers) ID3D11Buffer* const* ppConstantBuffers) override;
+        void VSSetShaderResources(_In_ UINT uStartSlot, _In_ UINT uNumViews, _In_reads_(uNumViews) ID3D11ShaderResourceView* const* ppShaderResourceViews) override;
+        void PSSetShaderResources(_In_ UINT uStartSlot, _In_ UINT uNumViews, _In_reads_(uNumViews) ID3D11ShaderResourceView* const* ppShaderResourceViews) override;
+        void PSSetSamplers(_In_ UINT uStartSlot, _In_ UINT uNumSamplers, _In_reads_(uNumSamplers) ID3D11SamplerState* const* ppSamplers) override;
+        void OMSetRenderTargets(_In_ UINT uNumViews, _In_reads_opt_(uNumViews) ID3D11RenderTargetView* const* ppRenderTargetViews, _In_opt_ ID3D11DepthStencilView* pDepthStencilView) override;
+        void DrawIndexed(_In_ UINT uIndexCount, _In_ UINT uStartIndexLocation, _In_ INT iBaseVertexLocation) override;
+        void DrawIndexedInstanced(_In_ UINT uIndexCountPerInstance, _In_ UINT uInstanceCount, _In_ UINT uStartIndexLocation, _In_ INT iBaseVertexLocation, _In_ UINT uStartInstanceLocation) override;
+
+    private:
+        ComPtr<ID3D11DeviceContext> m_immediateContext;
+    };
+}
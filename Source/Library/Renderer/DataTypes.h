@@ -2,22 +2,24 @@
 
 #include "Common.h"
 
+#include "Renderer/InstanceData.h"
+#include "Renderer/VertexData.h"
+
 namespace library
 {
 #define NUM_LIGHTS (1)
 #define MAX_NUM_BONES (256)
 #define MAX_NUM_BONES_PER_VERTEX (16)
+#define MAX_NUM_BLOCK_TYPES (128)
+#define MAX_NUM_TERRAIN_LODS (12)
 
-	struct SimpleVertex
+	// Patch of the heightfield terrain in columns, read by the shaders as R32G32B32A32_FLOAT
+	struct TerrainPatchData
 	{
-		XMFLOAT3 Position;
-		XMFLOAT2 TexCoord;
-		XMFLOAT3 Normal;
-	};
-
-	struct InstanceData
-	{
-		XMMATRIX Transformation;
+		FLOAT X;
+		FLOAT Z;
+		FLOAT Size;
+		FLOAT Lod;
 	};
 
 	struct AnimationData
@@ -51,6 +53,20 @@ namespace library
 	};
 
 
+	// Color of each block type, indexed by the block type of a cube instance
+	struct CBVoxelPalette
+	{
+		XMFLOAT4 Colors[MAX_NUM_BLOCK_TYPES];
+	};
+
+	// Camera in columns and cubes from the corner of the map, and the distances each level of detail of the terrain morphs between
+	struct CBTerrain
+	{
+		XMFLOAT4 Eye;
+		XMFLOAT4 MorphRanges[MAX_NUM_TERRAIN_LODS];
+		XMUINT4 MapSize;
+	};
+
 	struct CBSkinning
 	{
 		XMMATRIX BoneTransforms[MAX_NUM_BONES];
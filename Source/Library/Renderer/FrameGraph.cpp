@@ -0,0 +1,801 @@
+#include "Renderer/FrameGraph.h"
+
+#include <algorithm>
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrameGraph::FrameGraph
+
+      Summary:  Constructor
+
+      Modifies: [m_aTextures, m_aPasses, m_aPhysicalTextures,
+                 m_aExecutionOrder, m_aFinalUnbindSlots, m_stats].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    FrameGraph::FrameGraph()
+        : m_aTextures()
+        , m_aPasses()
+        , m_aPhysicalTextures()
+        , m_aExecutionOrder()
+        , m_aFinalUnbindSlots()
+        , m_stats()
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrameGraph::Reset
+
+      Summary:  Removes every pass and texture, so the passes of the
+                next frame can be declared. The capacity of the arrays
+                is kept
+
+      Modifies: [m_aTextures, m_aPasses, m_aPhysicalTextures,
+                 m_aExecutionOrder, m_aFinalUnbindSlots].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void FrameGraph::Reset()
+    {
+        m_aTextures.clear();
+        m_aPasses.clear();
+        m_aPhysicalTextures.clear();
+        m_aExecutionOrder.clear();
+        m_aFinalUnbindSlots.clear();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrameGraph::CreateTexture
+
+      Summary:  Adds a transient texture, which only lives while the
+                passes of the frame use it
+
+      Args:     PCWSTR pszName
+                  Name of the texture
+                const FrameGraphTextureDesc& desc
+                  Description of the texture
+
+      Modifies: [m_aTextures].
+
+      Returns:  UINT
+                  Index of the texture
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT FrameGraph::CreateTexture(_In_ PCWSTR pszName, _In_ const FrameGraphTextureDesc& desc)
+    {
+        m_aTextures.push_back(Texture{
+            .name = pszName,
+            .desc = desc,
+            .views = FrameGraphViews{ .pRenderTargetView = nullptr, .pDepthStencilView = nullptr, .pShaderResourceView = nullptr },
+            .bImported = FALSE,
+            .bOutput = FALSE,
+            .uPhysicalTexture = INVALID_INDEX,
+            .uFirstUse = INVALID_INDEX,
+            .uLastUse = INVALID_INDEX
+        });
+
+        return static_cast<UINT>(m_aTextures.size() - 1u);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrameGraph::ImportTexture
+
+      Summary:  Adds a texture that lives out of the graph, e.g. the
+                back buffer, through the views it is bound with
+
+      Args:     PCWSTR pszName
+                  Name of the texture
+                const FrameGraphViews& views
+                  Views of the texture
+                BOOL bIsOutput
+                  Whether the texture is a result of the frame, so its
+                  last writer is never culled
+
+      Modifies: [m_aTextures].
+
+      Returns:  UINT
+                  Index of the texture
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT FrameGraph::ImportTexture(_In_ PCWSTR pszName, _In_ const FrameGraphViews& views, _In_ BOOL bIsOutput)
+    {
+        m_aTextures.push_back(Texture{
+            .name = pszName,
+            .desc = FrameGraphTextureDesc{},
+            .views = views,
+            .bImported = TRUE,
+            .bOutput = bIsOutput,
+            .uPhysicalTexture = INVALID_INDEX,
+            .uFirstUse = INVALID_INDEX,
+            .uLastUse = INVALID_INDEX
+        });
+
+        return static_cast<UINT>(m_aTextures.size() - 1u);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrameGraph::AddPass
+
+      Summary:  Adds a pass after the ones already added
+
+      Args:     PCWSTR pszName
+                  Name of the pass
+                std::function<void()> execute
+                  Draws of the pass, called once its targets and shader
+                  resources are bound
+
+      Modifies: [m_aPasses].
+
+      Returns:  UINT
+                  Index of the pass
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT FrameGraph::AddPass(_In_ PCWSTR pszName, _In_ std::function<void()> execute)
+    {
+        m_aPasses.push_back(Pass{
+            .name = pszName,
+            .execute = std::move(execute),
+            .aReads = {},
+            .aWrites = {},
+            .aDependencies = {},
+            .aUnbindSlots = {},
+            .bSideEffects = FALSE,
+            .bCulled = FALSE
+        });
+
+        return static_cast<UINT>(m_aPasses.size() - 1u);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrameGraph::Read
+
+      Summary:  Declares that a pass reads a texture through its shader
+                resource view bound to a slot of the pixel shader
+
+      Args:     UINT uPass
+                  Index of the pass
+                UINT uTexture
+                  Index of the texture
+                UINT uSlot
+                  Shader resource slot of the pixel shader
+
+      Modifies: [m_aPasses].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void FrameGraph::Read(_In_ UINT uPass, _In_ UINT uTexture, _In_ UINT uSlot)
+    {
+        if (uPass < m_aPasses.size())
+        {
+            m_aPasses[uPass].aReads.push_back(Access{ .uTexture = uTexture, .uSlot = uSlot, .usage = eFrameGraphUsage::RENDER_TARGET, .bKeepContents = TRUE });
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrameGraph::Write
+
+      Summary:  Declares that a pass writes a texture as a render
+                target, in the order of the declarations, or as the
+                depth stencil
+
+      Args:     UINT uPass
+                  Index of the pass
+                UINT uTexture
+                  Index of the texture
+                eFrameGraphUsage usage
+                  How the texture is bound
+                BOOL bKeepContents
+                  Whether the pass draws over the contents of the last
+                  writer instead of replacing them
+
+      Modifies: [m_aPasses].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void FrameGraph::Write(_In_ UINT uPass, _In_ UINT uTexture, _In_ eFrameGraphUsage usage, _In_ BOOL bKeepContents)
+    {
+        if (uPass < m_aPasses.size())
+        {
+            m_aPasses[uPass].aWrites.push_back(Access{ .uTexture = uTexture, .uSlot = INVALID_INDEX, .usage = usage, .bKeepContents = bKeepContents });
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrameGraph::SetSideEffects
+
+      Summary:  Keeps a pass whether its results are read or not, e.g.
+                a pass that reads back to the CPU
+
+      Args:     UINT uPass
+                  Index of the pass
+
+      Modifies: [m_aPasses].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void FrameGraph::SetSideEffects(_In_ UINT uPass)
+    {
+        if (uPass < m_aPasses.size())
+        {
+            m_aPasses[uPass].bSideEffects = TRUE;
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrameGraph::Compile
+
+      Summary:  Finds the passes each pass depends on, culls the passes
+                no kept pass depends on, aliases the transient textures
+                of the kept passes and plans the unbinds
+
+      Modifies: [m_aTextures, m_aPasses, m_aPhysicalTextures,
+                 m_aExecutionOrder, m_aFinalUnbindSlots, m_stats].
+
+      Returns:  BOOL
+                  FALSE if a pass reads or keeps a transient texture no
+                  pass wrote before it, accesses a texture that does not
+                  exist, reads and writes the same texture, or binds too
+                  many targets or a slot out of range
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL FrameGraph::Compile()
+    {
+        m_aPhysicalTextures.clear();
+        m_aExecutionOrder.clear();
+        m_aFinalUnbindSlots.clear();
+        m_stats = FrameGraphStats{
+            .uNumPasses = static_cast<UINT>(m_aPasses.size()),
+            .uNumCulledPasses = 0u,
+            .uNumTransientTextures = 0u,
+            .uNumPhysicalTextures = 0u,
+            .uTransientBytes = 0u,
+            .uAllocatedBytes = 0u
+        };
+
+        std::vector<UINT> aLastWriters;
+        if (!findDependencies(aLastWriters))
+        {
+            return FALSE;
+        }
+
+        cullPasses(aLastWriters);
+        aliasTextures();
+        planUnbinds();
+
+        return TRUE;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrameGraph::Execute
+
+      Summary:  Runs the kept passes in order. Before each pass, the
+                shader resources viewing a texture it writes are
+                unbound, its targets are bound, or none if it writes
+                nothing so no target of the previous pass stays bound,
+                and then its shader resources. The shader resources
+                still bound are unbound at the end, so the textures
+                can be written by the first pass of the next frame
+
+      Args:     RenderContext* pContext
+                  Context the views are bound through
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void FrameGraph::Execute(_In_ RenderContext* pContext)
+    {
+        ID3D11ShaderResourceView* const pNullView = nullptr;
+        for (UINT uPassIdx : m_aExecutionOrder)
+        {
+            Pass& pass = m_aPasses[uPassIdx];
+            for (UINT uSlot : pass.aUnbindSlots)
+            {
+                pContext->PSSetShaderResources(uSlot, 1u, &pNullView);
+            }
+
+            ID3D11RenderTargetView* apRenderTargetViews[MAX_RENDER_TARGETS] = {};
+            UINT uNumRenderTargets = 0u;
+            ID3D11DepthStencilView* pDepthStencilView = nullptr;
+            for (const Access& write : pass.aWrites)
+            {
+                const FrameGraphViews& views = GetViews(write.uTexture);
+                if (write.usage == eFrameGraphUsage::RENDER_TARGET)
+                {
+                    apRenderTargetViews[uNumRenderTargets++] = views.pRenderTargetView;
+                }
+                else
+                {
+                    pDepthStencilView = views.pDepthStencilView;
+                }
+            }
+            pContext->OMSetRenderTargets(uNumRenderTargets, apRenderTargetViews, pDepthStencilView);
+
+            for (const Access& read : pass.aReads)
+            {
+                ID3D11ShaderResourceView* const pView = GetViews(read.uTexture).pShaderResourceView;
+                pContext->PSSetShaderResources(read.uSlot, 1u, &pView);
+            }
+
+            if (pass.execute)
+            {
+                pass.execute();
+            }
+        }
+
+        for (UINT uSlot : m_aFinalUnbindSlots)
+        {
+            pContext->PSSetShaderResources(uSlot, 1u, &pNullView);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrameGraph::GetNumPhysicalTextures
+
+      Summary:  Returns the number of textures the transient textures
+                of the kept passes share
+
+      Returns:  UINT
+                  Number of physical textures
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT FrameGraph::GetNumPhysicalTextures() const
+    {
+        return static_cast<UINT>(m_aPhysicalTextures.size());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrameGraph::GetPhysicalTextureDesc
+
+      Summary:  Returns the description of a physical texture, which
+                the renderer creates it with
+
+      Args:     UINT uPhysicalTexture
+                  Index of the physical texture
+
+      Returns:  const FrameGraphTextureDesc&
+                  Description of the texture
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const FrameGraphTextureDesc& FrameGraph::GetPhysicalTextureDesc(_In_ UINT uPhysicalTexture) const
+    {
+        return m_aPhysicalTextures[uPhysicalTexture].desc;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrameGraph::SetPhysicalTextureViews
+
+      Summary:  Sets the views of a physical texture the renderer
+                created, which every transient texture sharing it is
+                bound with
+
+      Args:     UINT uPhysicalTexture
+                  Index of the physical texture
+                const FrameGraphViews& views
+                  Views of the texture
+
+      Modifies: [m_aPhysicalTextures].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void FrameGraph::SetPhysicalTextureViews(_In_ UINT uPhysicalTexture, _In_ const FrameGraphViews& views)
+    {
+        m_aPhysicalTextures[uPhysicalTexture].views = views;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrameGraph::GetPhysicalTexture
+
+      Summary:  Returns the physical texture of a transient texture
+
+      Args:     UINT uTexture
+                  Index of the texture
+
+      Returns:  UINT
+                  Index of the physical texture, or INVALID_INDEX if
+                  the texture is imported or no kept pass uses it
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT FrameGraph::GetPhysicalTexture(_In_ UINT uTexture) const
+    {
+        return m_aTextures[uTexture].uPhysicalTexture;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrameGraph::GetViews
+
+      Summary:  Returns the views of a texture, those of its physical
+                texture if it is transient, e.g. for a pass to clear
+                its targets
+
+      Args:     UINT uTexture
+                  Index of the texture
+
+      Returns:  const FrameGraphViews&
+                  Views of the texture, null if it has none
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const FrameGraphViews& FrameGraph::GetViews(_In_ UINT uTexture) const
+    {
+        static const FrameGraphViews s_nullViews = { .pRenderTargetView = nullptr, .pDepthStencilView = nullptr, .pShaderResourceView = nullptr };
+
+        const Texture& texture = m_aTextures[uTexture];
+        if (texture.bImported)
+        {
+            return texture.views;
+        }
+
+        return texture.uPhysicalTexture == INVALID_INDEX ? s_nullViews : m_aPhysicalTextures[texture.uPhysicalTexture].views;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrameGraph::GetPassName
+
+      Summary:  Returns the name of a pass
+
+      Args:     UINT uPass
+                  Index of the pass
+
+      Returns:  PCWSTR
+                  Name of the pass
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    PCWSTR FrameGraph::GetPassName(_In_ UINT uPass) const
+    {
+        return m_aPasses[uPass].name.c_str();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrameGraph::GetNumExecutedPasses
+
+      Summary:  Returns the number of passes the last compile kept
+
+      Returns:  UINT
+                  Number of kept passes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT FrameGraph::GetNumExecutedPasses() const
+    {
+        return static_cast<UINT>(m_aExecutionOrder.size());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrameGraph::GetExecutedPass
+
+      Summary:  Returns a kept pass in execution order
+
+      Args:     UINT uIndex
+                  Position of the pass in the execution order
+
+      Returns:  UINT
+                  Index of the pass
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT FrameGraph::GetExecutedPass(_In_ UINT uIndex) const
+    {
+        return m_aExecutionOrder[uIndex];
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrameGraph::IsPassCulled
+
+      Summary:  Returns whether the last compile culled a pass
+
+      Args:     UINT uPass
+                  Index of the pass
+
+      Returns:  BOOL
+                  TRUE if no kept pass depends on the pass
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL FrameGraph::IsPassCulled(_In_ UINT uPass) const
+    {
+        return m_aPasses[uPass].bCulled;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrameGraph::GetStats
+
+      Summary:  Returns the statistics of the last compile
+
+      Returns:  const FrameGraphStats&
+                  Passes, transient textures and their memory
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const FrameGraphStats& FrameGraph::GetStats() const
+    {
+        return m_stats;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrameGraph::findDependencies
+
+      Summary:  Walks the passes in order, remembering the last writer
+                of each texture, and makes every pass depend on the
+                last writers of the textures it reads or keeps
+
+      Args:     std::vector<UINT>& aLastWriters
+                  Receives the last pass writing each texture, or
+                  INVALID_INDEX
+
+      Modifies: [m_aPasses].
+
+      Returns:  BOOL
+                  FALSE if the passes are not valid
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL FrameGraph::findDependencies(_Out_ std::vector<UINT>& aLastWriters)
+    {
+        aLastWriters.assign(m_aTextures.size(), INVALID_INDEX);
+
+        for (UINT uPassIdx = 0u; uPassIdx < static_cast<UINT>(m_aPasses.size()); ++uPassIdx)
+        {
+            Pass& pass = m_aPasses[uPassIdx];
+            pass.aDependencies.clear();
+
+            for (const Access& read : pass.aReads)
+            {
+                if (read.uTexture >= m_aTextures.size() || read.uSlot >= NUM_SHADER_RESOURCE_SLOTS)
+                {
+                    return FALSE;
+                }
+
+                if (aLastWriters[read.uTexture] != INVALID_INDEX)
+                {
+                    pass.aDependencies.push_back(aLastWriters[read.uTexture]);
+                }
+                else if (!m_aTextures[read.uTexture].bImported)
+                {
+                    return FALSE;
+                }
+            }
+
+            UINT uNumRenderTargets = 0u;
+            UINT uNumDepthStencils = 0u;
+            for (size_t i = 0u; i < pass.aWrites.size(); ++i)
+            {
+                const Access& write = pass.aWrites[i];
+                if (write.uTexture >= m_aTextures.size())
+                {
+                    return FALSE;
+                }
+
+                // A texture cannot be a target and a shader resource of a pass, or two of its targets
+                for (const Access& read : pass.aReads)
+                {
+                    if (read.uTexture == write.uTexture)
+                    {
+                        return FALSE;
+                    }
+                }
+                for (size_t j = 0u; j < i; ++j)
+                {
+                    if (pass.aWrites[j].uTexture == write.uTexture)
+                    {
+                        return FALSE;
+                    }
+                }
+
+                if (write.usage == eFrameGraphUsage::RENDER_TARGET ? ++uNumRenderTargets > MAX_RENDER_TARGETS : ++uNumDepthStencils > 1u)
+                {
+                    return FALSE;
+                }
+
+                if (write.bKeepContents)
+                {
+                    if (aLastWriters[write.uTexture] != INVALID_INDEX)
+                    {
+                        pass.aDependencies.push_back(aLastWriters[write.uTexture]);
+                    }
+                    else if (!m_aTextures[write.uTexture].bImported)
+                    {
+                        return FALSE;
+                    }
+                }
+            }
+
+            for (const Access& write : pass.aWrites)
+            {
+                aLastWriters[write.uTexture] = uPassIdx;
+            }
+
+            std::sort(pass.aDependencies.begin(), pass.aDependencies.end());
+            pass.aDependencies.erase(std::unique(pass.aDependencies.begin(), pass.aDependencies.end()), pass.aDependencies.end());
+        }
+
+        return TRUE;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrameGraph::cullPasses
+
+      Summary:  Keeps the passes with side effects, the last writers
+                of the output textures and every pass they depend on,
+                and culls the others. The kept passes run in the order
+                they were added, which every dependency follows
+
+      Args:     const std::vector<UINT>& aLastWriters
+                  Last pass writing each texture, or INVALID_INDEX
+
+      Modifies: [m_aPasses, m_aExecutionOrder, m_stats].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void FrameGraph::cullPasses(_In_ const std::vector<UINT>& aLastWriters)
+    {
+        std::vector<UINT> aPending;
+        for (UINT uPassIdx = 0u; uPassIdx < static_cast<UINT>(m_aPasses.size()); ++uPassIdx)
+        {
+            m_aPasses[uPassIdx].bCulled = TRUE;
+            if (m_aPasses[uPassIdx].bSideEffects)
+            {
+                aPending.push_back(uPassIdx);
+            }
+        }
+
+        for (size_t i = 0u; i < m_aTextures.size(); ++i)
+        {
+            if (m_aTextures[i].bOutput && aLastWriters[i] != INVALID_INDEX)
+            {
+                aPending.push_back(aLastWriters[i]);
+            }
+        }
+
+        while (!aPending.empty())
+        {
+            Pass& pass = m_aPasses[aPending.back()];
+            aPending.pop_back();
+            if (pass.bCulled)
+            {
+                pass.bCulled = FALSE;
+                aPending.insert(aPending.end(), pass.aDependencies.begin(), pass.aDependencies.end());
+            }
+        }
+
+        for (UINT uPassIdx = 0u; uPassIdx < static_cast<UINT>(m_aPasses.size()); ++uPassIdx)
+        {
+            if (m_aPasses[uPassIdx].bCulled)
+            {
+                ++m_stats.uNumCulledPasses;
+            }
+            else
+            {
+                m_aExecutionOrder.push_back(uPassIdx);
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrameGraph::aliasTextures
+
+      Summary:  Finds the first and last kept pass using each transient
+                texture and, from the earliest first use, gives each
+                one the first physical texture of the same description
+                whose last use is before its first use, or a new one.
+                Direct3D 11 has no placed resources, so textures share
+                memory by sharing a whole texture
+
+      Modifies: [m_aTextures, m_aPhysicalTextures, m_stats].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void FrameGraph::aliasTextures()
+    {
+        for (Texture& texture : m_aTextures)
+        {
+            texture.uPhysicalTexture = INVALID_INDEX;
+            texture.uFirstUse = INVALID_INDEX;
+            texture.uLastUse = INVALID_INDEX;
+        }
+
+        auto use = [this](_In_ UINT uTexture, _In_ UINT uOrder)
+        {
+            Texture& texture = m_aTextures[uTexture];
+            texture.uFirstUse = std::min(texture.uFirstUse, uOrder);
+            texture.uLastUse = texture.uLastUse == INVALID_INDEX ? uOrder : std::max(texture.uLastUse, uOrder);
+        };
+
+        for (UINT uOrder = 0u; uOrder < static_cast<UINT>(m_aExecutionOrder.size()); ++uOrder)
+        {
+            const Pass& pass = m_aPasses[m_aExecutionOrder[uOrder]];
+            for (const Access& read : pass.aReads)
+            {
+                use(read.uTexture, uOrder);
+            }
+            for (const Access& write : pass.aWrites)
+            {
+                use(write.uTexture, uOrder);
+            }
+        }
+
+        std::vector<UINT> aTransients;
+        for (UINT i = 0u; i < static_cast<UINT>(m_aTextures.size()); ++i)
+        {
+            if (!m_aTextures[i].bImported && m_aTextures[i].uFirstUse != INVALID_INDEX)
+            {
+                aTransients.push_back(i);
+            }
+        }
+        std::stable_sort(aTransients.begin(), aTransients.end(), [this](_In_ UINT uA, _In_ UINT uB)
+        {
+            return m_aTextures[uA].uFirstUse < m_aTextures[uB].uFirstUse;
+        });
+
+        for (UINT uTextureIdx : aTransients)
+        {
+            Texture& texture = m_aTextures[uTextureIdx];
+            const UINT64 uBytes = static_cast<UINT64>(texture.desc.uWidth) * texture.desc.uHeight * texture.desc.uBytesPerTexel;
+
+            UINT uPhysicalIdx = 0u;
+            while (uPhysicalIdx < m_aPhysicalTextures.size())
+            {
+                const PhysicalTexture& physical = m_aPhysicalTextures[uPhysicalIdx];
+                if (physical.uLastUse < texture.uFirstUse
+                    && physical.desc.uWidth == texture.desc.uWidth
+                    && physical.desc.uHeight == texture.desc.uHeight
+                    && physical.desc.format == texture.desc.format
+                    && physical.desc.uBytesPerTexel == texture.desc.uBytesPerTexel)
+                {
+                    break;
+                }
+                ++uPhysicalIdx;
+            }
+
+            if (uPhysicalIdx == m_aPhysicalTextures.size())
+            {
+                m_aPhysicalTextures.push_back(PhysicalTexture{
+                    .desc = texture.desc,
+                    .views = FrameGraphViews{ .pRenderTargetView = nullptr, .pDepthStencilView = nullptr, .pShaderResourceView = nullptr },
+                    .uLastUse = texture.uLastUse
+                });
+                m_stats.uAllocatedBytes += uBytes;
+            }
+            else
+            {
+                m_aPhysicalTextures[uPhysicalIdx].uLastUse = texture.uLastUse;
+            }
+
+            texture.uPhysicalTexture = uPhysicalIdx;
+            ++m_stats.uNumTransientTextures;
+            m_stats.uTransientBytes += uBytes;
+        }
+
+        m_stats.uNumPhysicalTextures = static_cast<UINT>(m_aPhysicalTextures.size());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrameGraph::planUnbinds
+
+      Summary:  Follows which texture each shader resource slot views
+                through the kept passes, and unbinds a slot before a
+                pass writes the texture it views, or a texture sharing
+                its physical texture, and at the end of the frame
+
+      Modifies: [m_aPasses, m_aFinalUnbindSlots].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void FrameGraph::planUnbinds()
+    {
+        std::vector<UINT> aBoundIds;
+        for (UINT uPassIdx : m_aExecutionOrder)
+        {
+            Pass& pass = m_aPasses[uPassIdx];
+            pass.aUnbindSlots.clear();
+
+            for (const Access& write : pass.aWrites)
+            {
+                const UINT uId = getBindingId(write.uTexture);
+                for (UINT uSlot = 0u; uSlot < static_cast<UINT>(aBoundIds.size()); ++uSlot)
+                {
+                    if (aBoundIds[uSlot] == uId)
+                    {
+                        pass.aUnbindSlots.push_back(uSlot);
+                        aBoundIds[uSlot] = INVALID_INDEX;
+                    }
+                }
+            }
+
+            for (const Access& read : pass.aReads)
+            {
+                if (read.uSlot >= aBoundIds.size())
+                {
+                    aBoundIds.resize(read.uSlot + 1u, INVALID_INDEX);
+                }
+                aBoundIds[read.uSlot] = getBindingId(read.uTexture);
+            }
+        }
+
+        for (UINT uSlot = 0u; uSlot < static_cast<UINT>(aBoundIds.size()); ++uSlot)
+        {
+            if (aBoundIds[uSlot] != INVALID_INDEX)
+            {
+                m_aFinalUnbindSlots.push_back(uSlot);
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrameGraph::getBindingId
+
+      Summary:  Returns the same id for textures bound through the same
+                views, the index of an imported texture and the index
+                of the physical texture of a transient one after them
+
+      Args:     UINT uTexture
+                  Index of the texture
+
+      Returns:  UINT
+                  Id of the views of the texture
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT FrameGraph::getBindingId(_In_ UINT uTexture) const
+    {
+        const Texture& texture = m_aTextures[uTexture];
+        return texture.bImported ? uTexture : static_cast<UINT>(m_aTextures.size()) + texture.uPhysicalTexture;
+    }
+}
@@ -0,0 +1,261 @@
+/*+===================================================================
+  File:      FRAMEGRAPH.H
+
+  Summary:   FrameGraph header file contains declarations of the
+             FrameGraph class that orders the passes of a frame by the
+             textures they read and write, culls the passes whose
+             results are never read, aliases the transient textures
+             and binds them, without Direct3D.
+
+  Classes: FrameGraph
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Platform.h"
+
+#include <functional>
+
+#include "Renderer/RenderContext.h"
+
+namespace library
+{
+    /*E+E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E
+        Enum:     eFrameGraphUsage
+        Summary:  Enumeration of how a pass writes a texture
+    E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E-E*/
+    enum class eFrameGraphUsage : BYTE
+    {
+        RENDER_TARGET,
+        DEPTH_STENCIL,
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   FrameGraphTextureDesc
+
+      Summary:  Description of a transient texture. Transient textures
+                with the same description share a texture when their
+                lifetimes do not overlap
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct FrameGraphTextureDesc
+    {
+        UINT uWidth;
+        UINT uHeight;
+        DXGI_FORMAT format;
+        UINT uBytesPerTexel;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   FrameGraphViews
+
+      Summary:  Views a texture is bound through, null for the ones it
+                does not have
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct FrameGraphViews
+    {
+        ID3D11RenderTargetView* pRenderTargetView;
+        ID3D11DepthStencilView* pDepthStencilView;
+        ID3D11ShaderResourceView* pShaderResourceView;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   FrameGraphStats
+
+      Summary:  Passes and transient textures of the last compiled
+                frame, and the memory the transient textures ask for
+                against the memory of the textures they share
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct FrameGraphStats
+    {
+        UINT uNumPasses;
+        UINT uNumCulledPasses;
+        UINT uNumTransientTextures;
+        UINT uNumPhysicalTextures;
+        UINT64 uTransientBytes;
+        UINT64 uAllocatedBytes;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    FrameGraph
+
+      Summary:  Passes of a frame and the textures they read as shader
+                resources and write as render targets or depth stencil.
+                The passes run in the order they are added, and a write
+                replaces the contents of a texture unless the pass
+                keeps them, so a pass depends on the last pass before
+                it that wrote each texture it reads or keeps. Compiling
+                keeps the passes with side effects and the last writers
+                of the output textures, then every pass they depend on,
+                and culls the others. Transient textures live from the
+                first to the last kept pass using them, and take the
+                first physical texture of the same description free
+                for their whole lifetime, so the graph only describes
+                the physical textures and the renderer creates them.
+                Executing binds the targets and shader resources of
+                every kept pass before it runs, and unbinds the shader
+                resources before a pass writes their texture and at
+                the end of the frame
+
+      Methods:  Reset
+                  Removes every pass and texture
+                CreateTexture
+                  Adds a transient texture
+                ImportTexture
+                  Adds a texture that lives out of the graph
+                AddPass
+                  Adds a pass
+                Read
+                  Declares a texture a pass reads
+                Write
+                  Declares a texture a pass writes
+                SetSideEffects
+                  Keeps a pass whether its results are read or not
+                Compile
+                  Orders and culls the passes and aliases the
+                  transient textures
+                Execute
+                  Runs the kept passes
+                GetNumPhysicalTextures
+                  Returns the number of textures the transient ones
+                  share
+                GetPhysicalTextureDesc
+                  Returns the description of a physical texture
+                SetPhysicalTextureViews
+                  Sets the views of a physical texture
+                GetPhysicalTexture
+                  Returns the physical texture of a transient texture
+                GetViews
+                  Returns the views of a texture
+                GetPassName
+                  Returns the name of a pass
+                GetNumExecutedPasses
+                  Returns the number of kept passes
+                GetExecutedPass
+                  Returns a kept pass in execution order
+                IsPassCulled
+                  Returns whether a pass was culled
+                GetStats
+                  Returns the statistics of the last compile
+                FrameGraph
+                  Constructor.
+                ~FrameGraph
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class FrameGraph final
+    {
+    public:
+        static constexpr const UINT INVALID_INDEX = ~0u;
+        static constexpr const UINT MAX_RENDER_TARGETS = 8u;
+        static constexpr const UINT NUM_SHADER_RESOURCE_SLOTS = 128u;
+
+    public:
+        FrameGraph();
+        FrameGraph(const FrameGraph& other) = delete;
+        FrameGraph(FrameGraph&& other) = delete;
+        FrameGraph& operator=(const FrameGraph& other) = delete;
+        FrameGraph& operator=(FrameGraph&& other) = delete;
+        ~FrameGraph() = default;
+
+        void Reset();
+
+        UINT CreateTexture(_In_ PCWSTR pszName, _In_ const FrameGraphTextureDesc& desc);
+        UINT ImportTexture(_In_ PCWSTR pszName, _In_ const FrameGraphViews& views, _In_ BOOL bIsOutput);
+
+        UINT AddPass(_In_ PCWSTR pszName, _In_ std::function<void()> execute);
+        void Read(_In_ UINT uPass, _In_ UINT uTexture, _In_ UINT uSlot);
+        void Write(_In_ UINT uPass, _In_ UINT uTexture, _In_ eFrameGraphUsage usage, _In_ BOOL bKeepContents);
+        void SetSideEffects(_In_ UINT uPass);
+
+        BOOL Compile();
+        void Execute(_In_ RenderContext* pContext);
+
+        UINT GetNumPhysicalTextures() const;
+        const FrameGraphTextureDesc& GetPhysicalTextureDesc(_In_ UINT uPhysicalTexture) const;
+        void SetPhysicalTextureViews(_In_ UINT uPhysicalTexture, _In_ const FrameGraphViews& views);
+        UINT GetPhysicalTexture(_In_ UINT uTexture) const;
+        const FrameGraphViews& GetViews(_In_ UINT uTexture) const;
+
+        PCWSTR GetPassName(_In_ UINT uPass) const;
+        UINT GetNumExecutedPasses() const;
+        UINT GetExecutedPass(_In_ UINT uIndex) const;
+        BOOL IsPassCulled(_In_ UINT uPass) const;
+        const FrameGraphStats& GetStats() const;
+
+    private:
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+            Struct:   Texture
+            Summary:  Texture of the graph, its views if it is imported,
+                      and the physical texture and execution lifetime
+                      of a transient texture
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct Texture
+        {
+            std::wstring name;
+            FrameGraphTextureDesc desc;
+            FrameGraphViews views;
+            BOOL bImported;
+            BOOL bOutput;
+            UINT uPhysicalTexture;
+            UINT uFirstUse;
+            UINT uLastUse;
+        };
+
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+            Struct:   Access
+            Summary:  Texture a pass reads at a shader resource slot or
+                      writes with a usage
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct Access
+        {
+            UINT uTexture;
+            UINT uSlot;
+            eFrameGraphUsage usage;
+            BOOL bKeepContents;
+        };
+
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+            Struct:   Pass
+            Summary:  Pass of the graph, what it reads and writes, the
+                      passes it depends on and the shader resource
+                      slots to unbind before it runs
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct Pass
+        {
+            std::wstring name;
+            std::function<void()> execute;
+            std::vector<Access> aReads;
+            std::vector<Access> aWrites;
+            std::vector<UINT> aDependencies;
+            std::vector<UINT> aUnbindSlots;
+            BOOL bSideEffects;
+            BOOL bCulled;
+        };
+
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+            Struct:   PhysicalTexture
+            Summary:  Texture shared by transient textures, and the last
+                      pass of the execution order that uses it
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct PhysicalTexture
+        {
+            FrameGraphTextureDesc desc;
+            FrameGraphViews views;
+            UINT uLastUse;
+        };
+
+        BOOL findDependencies(_Out_ std::vector<UINT>& aLastWriters);
+        void cullPasses(_In_ const std::vector<UINT>& aLastWriters);
+        void aliasTextures();
+        void planUnbinds();
+        UINT getBindingId(_In_ UINT uTexture) const;
+
+    private:
+        std::vector<Texture> m_aTextures;
+        std::vector<Pass> m_aPasses;
+        std::vector<PhysicalTexture> m_aPhysicalTextures;
+        std::vector<UINT> m_aExecutionOrder;
+        std::vector<UINT> m_aFinalUnbindSlots;
+        FrameGraphStats m_stats;
+    };
+}
@@ -0,0 +1,370 @@
+#include "Renderer/FrustumCuller.h"
+
+#include <cmath>
+
+// FRUSTUM_CULLER_SCALAR leaves only the loop over single boxes, for the tests and benchmarks of the other paths
+#if defined(__AVX__) && !defined(FRUSTUM_CULLER_SCALAR)
+#define FRUSTUM_CULLER_AVX
+#include <immintrin.h>
+#endif
+
+#if (defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)) && !defined(FRUSTUM_CULLER_SCALAR)
+#define FRUSTUM_CULLER_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrustumCuller::FrustumCuller
+
+      Summary:  Constructor. The planes cull nothing until a view
+                projection matrix is set
+
+      Modifies: [m_aPlanes, m_aCentersX, m_aCentersY, m_aCentersZ,
+                 m_aExtentsX, m_aExtentsY, m_aExtentsZ, m_aVisible,
+                 m_uNumVisible].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    FrustumCuller::FrustumCuller()
+        : m_aPlanes()
+        , m_aCentersX()
+        , m_aCentersY()
+        , m_aCentersZ()
+        , m_aExtentsX()
+        , m_aExtentsY()
+        , m_aExtentsZ()
+        , m_aVisible()
+        , m_uNumVisible(0u)
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrustumCuller::ExtractPlanes
+
+      Summary:  Extracts the planes of the frustum from the columns of
+                a view projection matrix that transforms row vectors,
+                as in DirectXMath, to a clip space whose depth is from
+                0 to 1. The normals of the planes point into the
+                frustum and are not normalized, which the tests do not
+                need
+
+      Args:     const FLOAT* pViewProjection
+                  Row-major view projection matrix, e.g. &XMFLOAT4X4::_11
+                FLOAT aPlanes[NUM_PLANES][4]
+                  Receives the normal and the distance of each plane
+
+      Modifies: [aPlanes].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void FrustumCuller::ExtractPlanes(_In_reads_(16) const FLOAT* pViewProjection, _Out_ FLOAT aPlanes[NUM_PLANES][4])
+    {
+        for (UINT i = 0u; i < 4u; ++i)
+        {
+            const FLOAT x = pViewProjection[i * 4u];
+            const FLOAT y = pViewProjection[i * 4u + 1u];
+            const FLOAT z = pViewProjection[i * 4u + 2u];
+            const FLOAT w = pViewProjection[i * 4u + 3u];
+
+            aPlanes[0][i] = w + x; // Left
+            aPlanes[1][i] = w - x; // Right
+            aPlanes[2][i] = w + y; // Bottom
+            aPlanes[3][i] = w - y; // Top
+            aPlanes[4][i] = z;     // Near
+            aPlanes[5][i] = w - z; // Far
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrustumCuller::SetViewProjection
+
+      Summary:  Extracts the planes of the frustum the boxes are tested
+                against
+
+      Args:     const FLOAT* pViewProjection
+                  Row-major view projection matrix, e.g. &XMFLOAT4X4::_11
+
+      Modifies: [m_aPlanes].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void FrustumCuller::SetViewProjection(_In_reads_(16) const FLOAT* pViewProjection)
+    {
+        ExtractPlanes(pViewProjection, m_aPlanes);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrustumCuller::Clear
+
+      Summary:  Removes every box, keeping the memory for the boxes of
+                the next frame
+
+      Modifies: [m_aCentersX, m_aCentersY, m_aCentersZ, m_aExtentsX,
+                 m_aExtentsY, m_aExtentsZ, m_aVisible, m_uNumVisible].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void FrustumCuller::Clear()
+    {
+        m_aCentersX.clear();
+        m_aCentersY.clear();
+        m_aCentersZ.clear();
+        m_aExtentsX.clear();
+        m_aExtentsY.clear();
+        m_aExtentsZ.clear();
+        m_aVisible.clear();
+        m_uNumVisible = 0u;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrustumCuller::AddBox
+
+      Summary:  Adds a world space axis-aligned bounding box
+
+      Args:     const FLOAT* pCenter
+                  Center of the box, e.g. &BoundingBox::Center.x
+                const FLOAT* pExtents
+                  Half of the size of the box along each axis
+
+      Modifies: [m_aCentersX, m_aCentersY, m_aCentersZ, m_aExtentsX,
+                 m_aExtentsY, m_aExtentsZ].
+
+      Returns:  UINT
+                  Index of the box
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT FrustumCuller::AddBox(_In_reads_(3) const FLOAT* pCenter, _In_reads_(3) const FLOAT* pExtents)
+    {
+        const UINT uIndex = GetNumBoxes();
+
+        m_aCentersX.push_back(pCenter[0]);
+        m_aCentersY.push_back(pCenter[1]);
+        m_aCentersZ.push_back(pCenter[2]);
+        m_aExtentsX.push_back(pExtents[0]);
+        m_aExtentsY.push_back(pExtents[1]);
+        m_aExtentsZ.push_back(pExtents[2]);
+
+        return uIndex;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrustumCuller::Cull
+
+      Summary:  Tests every box against the planes. The distance of the
+                center of a box to a plane plus the projection of its
+                extents on the normal is negative when the whole box
+                is behind the plane. Blocks of 8 boxes are tested with
+                AVX where the target is built with it, blocks of 4
+                with SSE2, and the last boxes one at a time
+
+      Modifies: [m_aVisible, m_uNumVisible].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void FrustumCuller::Cull()
+    {
+        const UINT uNumBoxes = GetNumBoxes();
+        m_aVisible.resize(uNumBoxes);
+
+        // Stores through BYTE may alias anything, so the arrays and the count are kept in locals
+        BYTE* pVisible = m_aVisible.data();
+        UINT uNumVisible = 0u;
+#if defined(FRUSTUM_CULLER_AVX) || defined(FRUSTUM_CULLER_SSE2)
+        const FLOAT* pCentersX = m_aCentersX.data();
+        const FLOAT* pCentersY = m_aCentersY.data();
+        const FLOAT* pCentersZ = m_aCentersZ.data();
+        const FLOAT* pExtentsX = m_aExtentsX.data();
+        const FLOAT* pExtentsY = m_aExtentsY.data();
+        const FLOAT* pExtentsZ = m_aExtentsZ.data();
+#endif
+
+        UINT i = 0u;
+#ifdef FRUSTUM_CULLER_AVX
+        {
+            const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+            __m256 aPlanes[NUM_PLANES][4];
+            __m256 aAbsNormals[NUM_PLANES][3];
+            for (UINT uPlane = 0u; uPlane < NUM_PLANES; ++uPlane)
+            {
+                for (UINT j = 0u; j < 4u; ++j)
+                {
+                    aPlanes[uPlane][j] = _mm256_set1_ps(m_aPlanes[uPlane][j]);
+                }
+                for (UINT j = 0u; j < 3u; ++j)
+                {
+                    aAbsNormals[uPlane][j] = _mm256_and_ps(aPlanes[uPlane][j], absMask);
+                }
+            }
+
+            const __m256 zero = _mm256_setzero_ps();
+            for (; i + 8u <= uNumBoxes; i += 8u)
+            {
+                const __m256 centersX = _mm256_loadu_ps(pCentersX + i);
+                const __m256 centersY = _mm256_loadu_ps(pCentersY + i);
+                const __m256 centersZ = _mm256_loadu_ps(pCentersZ + i);
+                const __m256 extentsX = _mm256_loadu_ps(pExtentsX + i);
+                const __m256 extentsY = _mm256_loadu_ps(pExtentsY + i);
+                const __m256 extentsZ = _mm256_loadu_ps(pExtentsZ + i);
+
+                __m256 visible = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+                for (UINT uPlane = 0u; uPlane < NUM_PLANES; ++uPlane)
+                {
+                    __m256 distance = _mm256_add_ps(_mm256_mul_ps(aPlanes[uPlane][0], centersX), aPlanes[uPlane][3]);
+                    distance = _mm256_add_ps(distance, _mm256_mul_ps(aPlanes[uPlane][1], centersY));
+                    distance = _mm256_add_ps(distance, _mm256_mul_ps(aPlanes[uPlane][2], centersZ));
+                    distance = _mm256_add_ps(distance, _mm256_mul_ps(aAbsNormals[uPlane][0], extentsX));
+                    distance = _mm256_add_ps(distance, _mm256_mul_ps(aAbsNormals[uPlane][1], extentsY));
+                    distance = _mm256_add_ps(distance, _mm256_mul_ps(aAbsNormals[uPlane][2], extentsZ));
+                    visible = _mm256_and_ps(visible, _mm256_cmp_ps(distance, zero, _CMP_GE_OQ));
+                }
+
+                const INT iMask = _mm256_movemask_ps(visible);
+                for (UINT j = 0u; j < 8u; ++j)
+                {
+                    pVisible[i + j] = static_cast<BYTE>((iMask >> j) & 1);
+                    uNumVisible += pVisible[i + j];
+                }
+            }
+        }
+#endif
+#ifdef FRUSTUM_CULLER_SSE2
+        {
+            const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+            __m128 aPlanes[NUM_PLANES][4];
+            __m128 aAbsNormals[NUM_PLANES][3];
+            for (UINT uPlane = 0u; uPlane < NUM_PLANES; ++uPlane)
+            {
+                for (UINT j = 0u; j < 4u; ++j)
+                {
+                    aPlanes[uPlane][j] = _mm_set1_ps(m_aPlanes[uPlane][j]);
+                }
+                for (UINT j = 0u; j < 3u; ++j)
+                {
+                    aAbsNormals[uPlane][j] = _mm_and_ps(aPlanes[uPlane][j], absMask);
+                }
+            }
+
+            const __m128 zero = _mm_setzero_ps();
+            for (; i + 4u <= uNumBoxes; i += 4u)
+            {
+                const __m128 centersX = _mm_loadu_ps(pCentersX + i);
+                const __m128 centersY = _mm_loadu_ps(pCentersY + i);
+                const __m128 centersZ = _mm_loadu_ps(pCentersZ + i);
+                const __m128 extentsX = _mm_loadu_ps(pExtentsX + i);
+                const __m128 extentsY = _mm_loadu_ps(pExtentsY + i);
+                const __m128 extentsZ = _mm_loadu_ps(pExtentsZ + i);
+
+                __m128 visible = _mm_castsi128_ps(_mm_set1_epi32(-1));
+                for (UINT uPlane = 0u; uPlane < NUM_PLANES; ++uPlane)
+                {
+                    __m128 distance = _mm_add_ps(_mm_mul_ps(aPlanes[uPlane][0], centersX), aPlanes[uPlane][3]);
+                    distance = _mm_add_ps(distance, _mm_mul_ps(aPlanes[uPlane][1], centersY));
+                    distance = _mm_add_ps(distance, _mm_mul_ps(aPlanes[uPlane][2], centersZ));
+                    distance = _mm_add_ps(distance, _mm_mul_ps(aAbsNormals[uPlane][0], extentsX));
+                    distance = _mm_add_ps(distance, _mm_mul_ps(aAbsNormals[uPlane][1], extentsY));
+                    distance = _mm_add_ps(distance, _mm_mul_ps(aAbsNormals[uPlane][2], extentsZ));
+                    visible = _mm_and_ps(visible, _mm_cmpge_ps(distance, zero));
+                }
+
+                const INT iMask = _mm_movemask_ps(visible);
+                for (UINT j = 0u; j < 4u; ++j)
+                {
+                    pVisible[i + j] = static_cast<BYTE>((iMask >> j) & 1);
+                    uNumVisible += pVisible[i + j];
+                }
+            }
+        }
+#endif
+        for (; i < uNumBoxes; ++i)
+        {
+            pVisible[i] = static_cast<BYTE>(isBoxVisible(i));
+            uNumVisible += pVisible[i];
+        }
+
+        m_uNumVisible = uNumVisible;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrustumCuller::IsVisible
+
+      Summary:  Returns whether a box was in the frustum when the boxes
+                were last culled
+
+      Args:     UINT uIndex
+                  Index of the box
+
+      Returns:  BOOL
+                  TRUE if the box is in or crosses the frustum
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL FrustumCuller::IsVisible(_In_ UINT uIndex) const
+    {
+        assert(uIndex < m_aVisible.size());
+
+        return m_aVisible[uIndex] != 0u;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrustumCuller::GetNumBoxes
+
+      Summary:  Returns the number of boxes
+
+      Returns:  UINT
+                  Number of boxes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT FrustumCuller::GetNumBoxes() const
+    {
+        return static_cast<UINT>(m_aCentersX.size());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrustumCuller::GetNumVisible
+
+      Summary:  Returns the number of boxes in the frustum when the
+                boxes were last culled
+
+      Returns:  UINT
+                  Number of visible boxes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT FrustumCuller::GetNumVisible() const
+    {
+        return m_uNumVisible;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrustumCuller::GetNumCulled
+
+      Summary:  Returns the number of boxes out of the frustum when the
+                boxes were last culled
+
+      Returns:  UINT
+                  Number of culled boxes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT FrustumCuller::GetNumCulled() const
+    {
+        return static_cast<UINT>(m_aVisible.size()) - m_uNumVisible;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrustumCuller::isBoxVisible
+
+      Summary:  Tests a single box against the planes, the same way as
+                the blocks of boxes
+
+      Args:     UINT uIndex
+                  Index of the box
+
+      Returns:  BOOL
+                  TRUE if the box is not entirely behind a plane
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL FrustumCuller::isBoxVisible(_In_ UINT uIndex) const
+    {
+        for (UINT uPlane = 0u; uPlane < NUM_PLANES; ++uPlane)
+        {
+            const FLOAT* pPlane = m_aPlanes[uPlane];
+
+            FLOAT distance = pPlane[0] * m_aCentersX[uIndex] + pPlane[3];
+            distance += pPlane[1] * m_aCentersY[uIndex];
+            distance += pPlane[2] * m_aCentersZ[uIndex];
+            distance += std::fabs(pPlane[0]) * m_aExtentsX[uIndex];
+            distance += std::fabs(pPlane[1]) * m_aExtentsY[uIndex];
+            distance += std::fabs(pPlane[2]) * m_aExtentsZ[uIndex];
+            if (!(distance >= 0.0f))
+            {
+                return FALSE;
+            }
+        }
+
+        return TRUE;
+    }
+}
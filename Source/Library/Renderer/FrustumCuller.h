@@ -0,0 +1,95 @@
+/*+===================================================================
+  File:      FRUSTUMCULLER.H
+
+  Summary:   FrustumCuller header file contains declarations of the
+             FrustumCuller class that tests axis-aligned bounding
+             boxes against the view frustum, without Direct3D.
+
+  Classes: FrustumCuller
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Platform.h"
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    FrustumCuller
+
+      Summary:  Keeps a list of world space axis-aligned bounding boxes
+                and finds the ones inside or crossing the frustum of a
+                view projection matrix. The boxes are kept as separate
+                arrays of their components, so the planes are tested
+                against 8 boxes at a time with AVX where the target is
+                built with it, and 4 boxes at a time with SSE2
+                otherwise. A box is culled when it is entirely behind
+                one of the planes, so a few boxes near the corners of
+                the frustum stay visible without being in it
+
+      Methods:  ExtractPlanes
+                  Extracts the planes of the frustum of a view
+                  projection matrix
+                SetViewProjection
+                  Sets the frustum the boxes are tested against
+                Clear
+                  Removes every box
+                AddBox
+                  Adds a box and returns its index
+                Cull
+                  Finds the boxes in the frustum
+                IsVisible
+                  Returns whether a box is in the frustum
+                GetNumBoxes
+                  Returns the number of boxes
+                GetNumVisible
+                  Returns the number of boxes in the frustum
+                GetNumCulled
+                  Returns the number of boxes out of the frustum
+                FrustumCuller
+                  Constructor.
+                ~FrustumCuller
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class FrustumCuller final
+    {
+    public:
+        static constexpr const UINT NUM_PLANES = 6u;
+
+        static void ExtractPlanes(_In_reads_(16) const FLOAT* pViewProjection, _Out_ FLOAT aPlanes[NUM_PLANES][4]);
+
+    public:
+        FrustumCuller();
+        FrustumCuller(const FrustumCuller& other) = delete;
+        FrustumCuller(FrustumCuller&& other) = delete;
+        FrustumCuller& operator=(const FrustumCuller& other) = delete;
+        FrustumCuller& operator=(FrustumCuller&& other) = delete;
+        ~FrustumCuller() = default;
+
+        void SetViewProjection(_In_reads_(16) const FLOAT* pViewProjection);
+
+        void Clear();
+        UINT AddBox(_In_reads_(3) const FLOAT* pCenter, _In_reads_(3) const FLOAT* pExtents);
+        void Cull();
+
+        BOOL IsVisible(_In_ UINT uIndex) const;
+        UINT GetNumBoxes() const;
+        UINT GetNumVisible() const;
+        UINT GetNumCulled() const;
+
+    private:
+        BOOL isBoxVisible(_In_ UINT uIndex) const;
+
+    private:
+        FLOAT m_aPlanes[NUM_PLANES][4];
+        std::vector<FLOAT> m_aCentersX;
+        std::vector<FLOAT> m_aCentersY;
+        std::vector<FLOAT> m_aCentersZ;
+        std::vector<FLOAT> m_aExtentsX;
+        std::vector<FLOAT> m_aExtentsY;
+        std::vector<FLOAT> m_aExtentsZ;
+        std::vector<BYTE> m_aVisible;
+        UINT m_uNumVisible;
+    };
+}
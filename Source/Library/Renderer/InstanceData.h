@@ -0,0 +1,96 @@
+/*+===================================================================
+  File:      INSTANCEDATA.H
+
+  Summary:   InstanceData header file contains the declaration of the
+             instance of a cube of the voxel map and the functions
+             packing and unpacking it, without Direct3D.
+
+  Classes: InstanceData
+
+  Functions: PackInstance, UnpackInstance
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Platform.h"
+
+#include <cstring>
+
+namespace library
+{
+    // Cube at a grid cell of a level of detail of the voxel map, read by the shaders as R16G16B16A16_UINT
+    struct InstanceData
+    {
+        WORD X;
+        WORD Y;
+        WORD Z;
+        CHAR BlockType;
+        BYTE Lod;
+    };
+    static_assert(sizeof(InstanceData) == 8u);
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: PackInstance
+
+      Summary:  Packs the cube at a grid cell of a level of detail
+
+      Args:     UINT uLod
+                  Level of detail, a cell spans 2^uLod cubes, below 256
+                UINT x, UINT y, UINT z
+                  Grid cell of the level, each below 65536
+                CHAR blockType
+                  Block type of the cube, 0 for air
+
+      Returns:  InstanceData
+                  Packed instance
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    inline InstanceData PackInstance(_In_ UINT uLod, _In_ UINT x, _In_ UINT y, _In_ UINT z, _In_ CHAR blockType)
+    {
+        assert(uLod <= 0xFFu && x <= 0xFFFFu && y <= 0xFFFFu && z <= 0xFFFFu);
+
+        return InstanceData
+        {
+            .X = static_cast<WORD>(x),
+            .Y = static_cast<WORD>(y),
+            .Z = static_cast<WORD>(z),
+            .BlockType = blockType,
+            .Lod = static_cast<BYTE>(uLod)
+        };
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: UnpackInstance
+
+      Summary:  Unpacks an instance the way the shaders read it, as
+                four 16-bit unsigned integers whose last one holds the
+                block type in its low byte and the level of detail in
+                its high byte
+
+      Args:     const InstanceData& instance
+                  Packed instance
+                UINT aCell[3]
+                  Receives the grid cell of the level
+                UINT& uLod
+                  Receives the level of detail
+                CHAR& blockType
+                  Receives the block type
+
+      Returns:  BOOL
+                  FALSE for air, which the shaders do not draw
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    inline BOOL UnpackInstance(_In_ const InstanceData& instance, _Out_writes_(3) UINT aCell[3], _Out_ UINT& uLod, _Out_ CHAR& blockType)
+    {
+        WORD aGrid[4];
+        static_assert(sizeof(aGrid) == sizeof(InstanceData));
+        std::memcpy(aGrid, &instance, sizeof(aGrid));
+
+        aCell[0] = aGrid[0];
+        aCell[1] = aGrid[1];
+        aCell[2] = aGrid[2];
+        uLod = aGrid[3] >> 8u;
+        blockType = static_cast<CHAR>(aGrid[3] & 0xFFu);
+
+        return blockType != 0;
+    }
+}
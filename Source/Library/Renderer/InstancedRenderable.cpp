@@ -37,7 +37,7 @@ namespace library
     InstancedRenderable::InstancedRenderable(std::vector<InstanceData>&& aInstanceData, const XMFLOAT4& outputColor) :
         Renderable(outputColor),
         m_instanceBuffer(),
-        m_aInstanceData()
+        m_aInstanceData(std::move(aInstanceData))
     {}
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
@@ -56,7 +56,7 @@ namespace library
     
     void InstancedRenderable::SetInstanceData(std::vector<InstanceData>&& aInstanceData)
     {
-        m_aInstanceData = aInstanceData;
+        m_aInstanceData = std::move(aInstanceData);
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
@@ -94,6 +94,20 @@ namespace library
         return numberOfInstances;
     }
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   InstancedRenderable::GetInstanceData
+
+      Summary:  Returns the instance data the instance buffer was
+                created from
+
+      Returns:  const std::vector<InstanceData>&
+                  Instance data
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const std::vector<InstanceData>& InstancedRenderable::GetInstanceData() const
+    {
+        return m_aInstanceData;
+    }
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   InstancedRenderable::initializeInstance
 
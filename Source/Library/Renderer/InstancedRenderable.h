@@ -29,6 +29,8 @@ namespace library
                   Returns a instance buffer
                 GetNumInstances
                   Returns the number of instance data
+                GetInstanceData
+                  Returns the instance data
                 initializeInstance
                   Initialize the instance buffer
                 InstancedRenderable
@@ -54,6 +56,7 @@ namespace library
 
         virtual ComPtr<ID3D11Buffer>& GetInstanceBuffer();
         virtual UINT GetNumInstances() const;
+        const std::vector<InstanceData>& GetInstanceData() const;
 
         UINT GetNumVertices() const override = 0;
         UINT GetNumIndices() const override = 0;
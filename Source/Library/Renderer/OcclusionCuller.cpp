@@ -0,0 +1,829 @@
+#include "Renderer/OcclusionCuller.h"
+
+#include <cfloat>
+#include <cmath>
+
+// OCCLUSION_CULLER_SCALAR finds the spans one scanline at a time, for the tests and benchmarks of the SSE2 path
+#if (defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)) && !defined(OCCLUSION_CULLER_SCALAR)
+#define OCCLUSION_CULLER_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::OcclusionCuller
+
+      Summary:  Constructor. Rounds the size of the buffer up to whole
+                tiles and starts uNumThreads - 1 threads, the thread
+                calling Rasterize is the last one
+
+      Args:     UINT uWidth
+                  Width of the buffer in pixels
+                UINT uHeight
+                  Height of the buffer in pixels
+                UINT uNumThreads
+                  Number of threads rasterizing bins, 0 for the number
+                  of hardware threads
+
+      Modifies: [m_aViewProjection, m_uWidth, m_uHeight, m_uNumTilesX,
+                 m_uNumTilesY, m_aTiles, m_aTriangles, m_aBins,
+                 m_aClipPositions, m_aThreads, m_mutex, m_jobCondition,
+                 m_doneCondition, m_uJobId, m_uNumBusyThreads, m_bStop,
+                 m_uNextBinIdx].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    OcclusionCuller::OcclusionCuller(_In_ UINT uWidth, _In_ UINT uHeight, _In_ UINT uNumThreads)
+        : m_aViewProjection()
+        , m_uWidth(0u)
+        , m_uHeight(0u)
+        , m_uNumTilesX(std::max((uWidth + TILE_WIDTH - 1u) / TILE_WIDTH, 1u))
+        , m_uNumTilesY(std::max((uHeight + TILE_HEIGHT - 1u) / TILE_HEIGHT, 1u))
+        , m_aTiles()
+        , m_aTriangles()
+        , m_aBins()
+        , m_aClipPositions()
+        , m_aThreads()
+        , m_mutex()
+        , m_jobCondition()
+        , m_doneCondition()
+        , m_uJobId(0u)
+        , m_uNumBusyThreads(0u)
+        , m_bStop(FALSE)
+        , m_uNextBinIdx(0u)
+    {
+        m_uWidth = m_uNumTilesX * TILE_WIDTH;
+        m_uHeight = m_uNumTilesY * TILE_HEIGHT;
+        m_aTiles.resize(static_cast<size_t>(m_uNumTilesX) * m_uNumTilesY);
+        m_aBins.resize(m_uNumTilesY);
+
+        for (UINT i = 0u; i < 4u; ++i)
+        {
+            m_aViewProjection[i * 5u] = 1.0f;
+        }
+
+        Clear();
+
+        if (uNumThreads == 0u)
+        {
+            uNumThreads = std::max(std::thread::hardware_concurrency(), 1u);
+        }
+
+        m_aThreads.reserve(uNumThreads - 1u);
+        for (UINT i = 1u; i < uNumThreads; ++i)
+        {
+            m_aThreads.emplace_back(&OcclusionCuller::work, this);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::~OcclusionCuller
+
+      Summary:  Destructor. Stops and joins the threads
+
+      Modifies: [m_aThreads, m_bStop].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    OcclusionCuller::~OcclusionCuller()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_bStop = TRUE;
+        }
+        m_jobCondition.notify_all();
+
+        for (std::thread& thread : m_aThreads)
+        {
+            thread.join();
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::SetViewProjection
+
+      Summary:  Sets the view projection matrix the occluders added
+                next and the boxes tested are transformed with
+
+      Args:     const FLOAT* pViewProjection
+                  Row-major view projection matrix that transforms row
+                  vectors, e.g. &XMFLOAT4X4::_11
+
+      Modifies: [m_aViewProjection].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void OcclusionCuller::SetViewProjection(_In_reads_(16) const FLOAT* pViewProjection)
+    {
+        std::copy(pViewProjection, pViewProjection + 16, m_aViewProjection);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::Clear
+
+      Summary:  Removes every occluder, so every box is visible until
+                occluders are rasterized again
+
+      Modifies: [m_aTiles, m_aTriangles, m_aBins].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void OcclusionCuller::Clear()
+    {
+        for (Tile& tile : m_aTiles)
+        {
+            std::fill(tile.aMasks, tile.aMasks + TILE_HEIGHT, 0u);
+            tile.referenceDepth = 1.0f;
+            tile.workingDepth = 0.0f;
+        }
+
+        m_aTriangles.clear();
+        for (std::vector<UINT>& aBin : m_aBins)
+        {
+            aBin.clear();
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::AddOccluder
+
+      Summary:  Transforms the vertices of an indexed triangle list to
+                clip space, clips its triangles against the near plane
+                and sets up and bins the ones in the frustum. Both
+                sides of a triangle occlude, so the winding does not
+                matter
+
+      Args:     const FLOAT* pWorld
+                  Row-major world matrix of the mesh
+                const FLOAT* pPositions
+                  Position of the first vertex, e.g.
+                  &SimpleVertex::Position.x
+                UINT uStride
+                  Bytes from a position to the next
+                UINT uNumVertices
+                  Number of vertices
+                const WORD* pIndices
+                  3 indices per triangle
+                UINT uNumIndices
+                  Number of indices
+
+      Modifies: [m_aTriangles, m_aBins, m_aClipPositions].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void OcclusionCuller::AddOccluder(_In_reads_(16) const FLOAT* pWorld, _In_ const FLOAT* pPositions, _In_ UINT uStride, _In_ UINT uNumVertices, _In_reads_(uNumIndices) const WORD* pIndices, _In_ UINT uNumIndices)
+    {
+        FLOAT aWorldViewProjection[16];
+        for (UINT i = 0u; i < 4u; ++i)
+        {
+            for (UINT j = 0u; j < 4u; ++j)
+            {
+                aWorldViewProjection[i * 4u + j] = pWorld[i * 4u] * m_aViewProjection[j]
+                    + pWorld[i * 4u + 1u] * m_aViewProjection[4u + j]
+                    + pWorld[i * 4u + 2u] * m_aViewProjection[8u + j]
+                    + pWorld[i * 4u + 3u] * m_aViewProjection[12u + j];
+            }
+        }
+
+        m_aClipPositions.resize(static_cast<size_t>(uNumVertices) * 4u);
+        const BYTE* pVertex = reinterpret_cast<const BYTE*>(pPositions);
+        for (UINT i = 0u; i < uNumVertices; ++i, pVertex += uStride)
+        {
+            const FLOAT* pPosition = reinterpret_cast<const FLOAT*>(pVertex);
+            for (UINT j = 0u; j < 4u; ++j)
+            {
+                m_aClipPositions[i * 4u + j] = pPosition[0] * aWorldViewProjection[j]
+                    + pPosition[1] * aWorldViewProjection[4u + j]
+                    + pPosition[2] * aWorldViewProjection[8u + j]
+                    + aWorldViewProjection[12u + j];
+            }
+        }
+
+        for (UINT i = 0u; i + 3u <= uNumIndices; i += 3u)
+        {
+            assert(pIndices[i] < uNumVertices && pIndices[i + 1u] < uNumVertices && pIndices[i + 2u] < uNumVertices);
+            addTriangle(&m_aClipPositions[pIndices[i] * 4u], &m_aClipPositions[pIndices[i + 1u] * 4u], &m_aClipPositions[pIndices[i + 2u] * 4u]);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::Rasterize
+
+      Summary:  Draws the triangles of every bin into its row of tiles.
+                A single bin is drawn on the calling thread, more are
+                handed to the threads of the pool and the calling
+                thread. Only one thread may call Rasterize at a time
+
+      Modifies: [m_aTiles, m_uJobId, m_uNumBusyThreads,
+                 m_uNextBinIdx].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void OcclusionCuller::Rasterize()
+    {
+        if (m_aTriangles.empty())
+        {
+            return;
+        }
+
+        if (m_aBins.size() == 1u || m_aThreads.empty())
+        {
+            for (UINT uBinIdx = 0u; uBinIdx < static_cast<UINT>(m_aBins.size()); ++uBinIdx)
+            {
+                rasterizeBin(uBinIdx);
+            }
+            return;
+        }
+
+        run();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::IsBoxVisible
+
+      Summary:  Returns whether a world space axis-aligned bounding box
+                may be in front of the rasterized occluders. The
+                nearest depth of the corners of the box is compared
+                with the depths of the pixels its screen rectangle
+                touches, a whole tile at a time where both layers are
+                nearer or farther than the box, and a row of the
+                coverage at a time otherwise. The depth of the box is
+                pulled nearer by DEPTH_BIAS, so a box is not culled by
+                the faces it holds, e.g. a chunk by its own mesh.
+                Boxes crossing the near plane are visible, boxes off
+                the buffer are not
+
+      Args:     const FLOAT* pCenter
+                  Center of the box, e.g. &BoundingBox::Center.x
+                const FLOAT* pExtents
+                  Half of the size of the box along each axis
+
+      Returns:  BOOL
+                  FALSE if the box is behind the occluders at every
+                  pixel
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL OcclusionCuller::IsBoxVisible(_In_reads_(3) const FLOAT* pCenter, _In_reads_(3) const FLOAT* pExtents) const
+    {
+        FLOAT minX = FLT_MAX;
+        FLOAT minY = FLT_MAX;
+        FLOAT maxX = -FLT_MAX;
+        FLOAT maxY = -FLT_MAX;
+        FLOAT minDepth = FLT_MAX;
+        for (UINT uCorner = 0u; uCorner < 8u; ++uCorner)
+        {
+            const FLOAT x = pCenter[0] + ((uCorner & 1u) ? pExtents[0] : -pExtents[0]);
+            const FLOAT y = pCenter[1] + ((uCorner & 2u) ? pExtents[1] : -pExtents[1]);
+            const FLOAT z = pCenter[2] + ((uCorner & 4u) ? pExtents[2] : -pExtents[2]);
+
+            FLOAT aClip[4];
+            for (UINT j = 0u; j < 4u; ++j)
+            {
+                aClip[j] = x * m_aViewProjection[j] + y * m_aViewProjection[4u + j] + z * m_aViewProjection[8u + j] + m_aViewProjection[12u + j];
+            }
+
+            if (aClip[2] < 0.0f || aClip[3] <= 0.0f)
+            {
+                return TRUE;
+            }
+
+            const FLOAT invW = 1.0f / aClip[3];
+            const FLOAT screenX = (aClip[0] * invW * 0.5f + 0.5f) * static_cast<FLOAT>(m_uWidth);
+            const FLOAT screenY = (0.5f - aClip[1] * invW * 0.5f) * static_cast<FLOAT>(m_uHeight);
+            minX = std::min(minX, screenX);
+            maxX = std::max(maxX, screenX);
+            minY = std::min(minY, screenY);
+            maxY = std::max(maxY, screenY);
+            minDepth = std::min(minDepth, aClip[2] * invW);
+        }
+        minDepth -= DEPTH_BIAS;
+
+        if (maxX < 0.0f || maxY < 0.0f || minX >= static_cast<FLOAT>(m_uWidth) || minY >= static_cast<FLOAT>(m_uHeight))
+        {
+            return FALSE;
+        }
+
+        const INT iMinColumn = static_cast<INT>(std::max(minX, 0.0f));
+        const INT iMaxColumn = static_cast<INT>(std::min(maxX, static_cast<FLOAT>(m_uWidth - 1u)));
+        const INT iMinRow = static_cast<INT>(std::max(minY, 0.0f));
+        const INT iMaxRow = static_cast<INT>(std::min(maxY, static_cast<FLOAT>(m_uHeight - 1u)));
+
+        for (INT iTileY = iMinRow / static_cast<INT>(TILE_HEIGHT); iTileY <= iMaxRow / static_cast<INT>(TILE_HEIGHT); ++iTileY)
+        {
+            const INT iFirstRow = iTileY * static_cast<INT>(TILE_HEIGHT);
+            for (INT iTileX = iMinColumn / static_cast<INT>(TILE_WIDTH); iTileX <= iMaxColumn / static_cast<INT>(TILE_WIDTH); ++iTileX)
+            {
+                const Tile& tile = m_aTiles[static_cast<size_t>(iTileY) * m_uNumTilesX + iTileX];
+                if (minDepth >= tile.referenceDepth)
+                {
+                    continue;
+                }
+
+                if (minDepth < tile.workingDepth)
+                {
+                    return TRUE;
+                }
+
+                // Only the pixels out of the working layer may be behind the box
+                const INT iFirstColumn = iTileX * static_cast<INT>(TILE_WIDTH);
+                const INT iLow = std::max(iMinColumn - iFirstColumn, 0);
+                const INT iHigh = std::min(iMaxColumn - iFirstColumn, static_cast<INT>(TILE_WIDTH) - 1);
+                const UINT uColumns = (~0u >> (TILE_WIDTH - 1u - static_cast<UINT>(iHigh))) & (~0u << iLow);
+                for (INT iRow = std::max(iMinRow, iFirstRow); iRow <= std::min(iMaxRow, iFirstRow + static_cast<INT>(TILE_HEIGHT) - 1); ++iRow)
+                {
+                    if (uColumns & ~tile.aMasks[iRow - iFirstRow])
+                    {
+                        return TRUE;
+                    }
+                }
+            }
+        }
+
+        return FALSE;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::GetMaxDepth
+
+      Summary:  Returns the depth every rasterized surface at the center
+                of a pixel is nearer than, e.g. to draw the buffer
+
+      Args:     UINT uX, UINT uY
+                  Pixel, from the top left corner of the buffer
+
+      Returns:  FLOAT
+                  Farthest depth of the pixel
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    FLOAT OcclusionCuller::GetMaxDepth(_In_ UINT uX, _In_ UINT uY) const
+    {
+        assert(uX < m_uWidth && uY < m_uHeight);
+
+        const Tile& tile = m_aTiles[static_cast<size_t>(uY / TILE_HEIGHT) * m_uNumTilesX + uX / TILE_WIDTH];
+        if ((tile.aMasks[uY % TILE_HEIGHT] >> (uX % TILE_WIDTH)) & 1u)
+        {
+            return std::min(tile.workingDepth, tile.referenceDepth);
+        }
+
+        return tile.referenceDepth;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::GetWidth
+
+      Summary:  Returns the width of the buffer, a multiple of
+                TILE_WIDTH
+
+      Returns:  UINT
+                  Width in pixels
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT OcclusionCuller::GetWidth() const
+    {
+        return m_uWidth;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::GetHeight
+
+      Summary:  Returns the height of the buffer, a multiple of
+                TILE_HEIGHT
+
+      Returns:  UINT
+                  Height in pixels
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT OcclusionCuller::GetHeight() const
+    {
+        return m_uHeight;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::GetNumTriangles
+
+      Summary:  Returns the number of triangles set up since the last
+                Clear, after clipping and without those out of the
+                frustum or covering no pixel
+
+      Returns:  UINT
+                  Number of triangles
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT OcclusionCuller::GetNumTriangles() const
+    {
+        return static_cast<UINT>(m_aTriangles.size());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::GetNumThreads
+
+      Summary:  Returns the number of threads rasterizing bins,
+                including the thread calling Rasterize
+
+      Returns:  UINT
+                  Number of threads
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT OcclusionCuller::GetNumThreads() const
+    {
+        return static_cast<UINT>(m_aThreads.size()) + 1u;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::addTriangle
+
+      Summary:  Drops a clip space triangle out of the frustum, and
+                clips a triangle crossing the near plane into 1 or 2
+                triangles in front of it
+
+      Args:     const FLOAT* pA, const FLOAT* pB, const FLOAT* pC
+                  Clip space x, y, z and w of the vertices
+
+      Modifies: [m_aTriangles, m_aBins].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void OcclusionCuller::addTriangle(_In_reads_(4) const FLOAT* pA, _In_reads_(4) const FLOAT* pB, _In_reads_(4) const FLOAT* pC)
+    {
+        const FLOAT* apVertices[3] = { pA, pB, pC };
+
+        // Entirely out of one plane of the frustum
+        UINT uOutside = ~0u;
+        for (const FLOAT* pVertex : apVertices)
+        {
+            uOutside &= (pVertex[0] < -pVertex[3] ? 1u : 0u)
+                | (pVertex[0] > pVertex[3] ? 2u : 0u)
+                | (pVertex[1] < -pVertex[3] ? 4u : 0u)
+                | (pVertex[1] > pVertex[3] ? 8u : 0u)
+                | (pVertex[2] < 0.0f ? 16u : 0u)
+                | (pVertex[2] > pVertex[3] ? 32u : 0u);
+        }
+        if (uOutside != 0u)
+        {
+            return;
+        }
+
+        if (pA[2] >= 0.0f && pB[2] >= 0.0f && pC[2] >= 0.0f)
+        {
+            setupTriangle(pA, pB, pC);
+            return;
+        }
+
+        FLOAT aPolygon[4][4];
+        UINT uNumVertices = 0u;
+        for (UINT i = 0u; i < 3u; ++i)
+        {
+            const FLOAT* pFrom = apVertices[i];
+            const FLOAT* pTo = apVertices[(i + 1u) % 3u];
+            if (pFrom[2] >= 0.0f)
+            {
+                std::copy(pFrom, pFrom + 4, aPolygon[uNumVertices++]);
+            }
+
+            if ((pFrom[2] >= 0.0f) != (pTo[2] >= 0.0f))
+            {
+                const FLOAT t = pFrom[2] / (pFrom[2] - pTo[2]);
+                for (UINT j = 0u; j < 4u; ++j)
+                {
+                    aPolygon[uNumVertices][j] = pFrom[j] + t * (pTo[j] - pFrom[j]);
+                }
+                ++uNumVertices;
+            }
+        }
+
+        for (UINT i = 1u; i + 1u < uNumVertices; ++i)
+        {
+            setupTriangle(aPolygon[0], aPolygon[i], aPolygon[i + 1u]);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::setupTriangle
+
+      Summary:  Projects a clip space triangle in front of the near
+                plane to the buffer, finds its edges, depth plane and
+                the pixels its bounds hold, and adds it to the bins of
+                the rows of tiles it overlaps. A pixel is covered when
+                its center is in the triangle, on an edge included, so
+                neighboring triangles leave no gap. An edge is set up
+                from its upper vertex, whatever triangle it is in, so
+                both triangles sharing it find the same spans
+
+      Args:     const FLOAT* pA, const FLOAT* pB, const FLOAT* pC
+                  Clip space x, y, z and w of the vertices
+
+      Modifies: [m_aTriangles, m_aBins].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void OcclusionCuller::setupTriangle(_In_reads_(4) const FLOAT* pA, _In_reads_(4) const FLOAT* pB, _In_reads_(4) const FLOAT* pC)
+    {
+        const FLOAT* apVertices[3] = { pA, pB, pC };
+        FLOAT aX[3];
+        FLOAT aY[3];
+        FLOAT aDepths[3];
+        for (UINT i = 0u; i < 3u; ++i)
+        {
+            const FLOAT invW = 1.0f / apVertices[i][3];
+            aX[i] = (apVertices[i][0] * invW * 0.5f + 0.5f) * static_cast<FLOAT>(m_uWidth);
+            aY[i] = (0.5f - apVertices[i][1] * invW * 0.5f) * static_cast<FLOAT>(m_uHeight);
+            aDepths[i] = apVertices[i][2] * invW;
+        }
+
+        const FLOAT area = (aX[1] - aX[0]) * (aY[2] - aY[0]) - (aX[2] - aX[0]) * (aY[1] - aY[0]);
+        if (!(std::abs(area) > 0.0f))
+        {
+            return;
+        }
+
+        // Pixels whose centers are within the bounds, clamped before the conversion as projected vertices may be far off the buffer
+        auto firstPixel = [](_In_ FLOAT minimum, _In_ UINT uSize)
+        {
+            return static_cast<INT>(std::ceil(std::clamp(minimum - 0.5f, 0.0f, static_cast<FLOAT>(uSize))));
+        };
+        auto lastPixel = [](_In_ FLOAT maximum, _In_ UINT uSize)
+        {
+            return static_cast<INT>(std::floor(std::clamp(maximum - 0.5f, -1.0f, static_cast<FLOAT>(uSize - 1u))));
+        };
+
+        Triangle triangle;
+        triangle.iMinColumn = firstPixel(std::min({ aX[0], aX[1], aX[2] }), m_uWidth);
+        triangle.iMaxColumn = lastPixel(std::max({ aX[0], aX[1], aX[2] }), m_uWidth);
+        triangle.iMinRow = firstPixel(std::min({ aY[0], aY[1], aY[2] }), m_uHeight);
+        triangle.iMaxRow = lastPixel(std::max({ aY[0], aY[1], aY[2] }), m_uHeight);
+        if (triangle.iMinColumn > triangle.iMaxColumn || triangle.iMinRow > triangle.iMaxRow)
+        {
+            return;
+        }
+
+        for (UINT i = 0u; i < 3u; ++i)
+        {
+            UINT uFrom = i;
+            UINT uTo = (i + 1u) % 3u;
+            const UINT uOther = (i + 2u) % 3u;
+            if (aY[uTo] < aY[uFrom] || (aY[uTo] == aY[uFrom] && aX[uTo] < aX[uFrom]))
+            {
+                std::swap(uFrom, uTo);
+            }
+
+            triangle.aLeftSlopes[i] = 0.0f;
+            triangle.aLeftOffsets[i] = -FLT_MAX;
+            triangle.aRightSlopes[i] = 0.0f;
+            triangle.aRightOffsets[i] = FLT_MAX;
+
+            // The rows of the vertices already bound the triangle along a horizontal edge
+            if (aY[uTo] == aY[uFrom])
+            {
+                continue;
+            }
+
+            const FLOAT slope = (aX[uTo] - aX[uFrom]) / (aY[uTo] - aY[uFrom]);
+            const FLOAT offset = aX[uFrom] - slope * aY[uFrom];
+            if (aX[uOther] > slope * aY[uOther] + offset)
+            {
+                triangle.aLeftSlopes[i] = slope;
+                triangle.aLeftOffsets[i] = offset;
+            }
+            else
+            {
+                triangle.aRightSlopes[i] = slope;
+                triangle.aRightOffsets[i] = offset;
+            }
+        }
+
+        triangle.depthDx = ((aDepths[1] - aDepths[0]) * (aY[2] - aY[0]) - (aDepths[2] - aDepths[0]) * (aY[1] - aY[0])) / area;
+        triangle.depthDy = ((aX[1] - aX[0]) * (aDepths[2] - aDepths[0]) - (aX[2] - aX[0]) * (aDepths[1] - aDepths[0])) / area;
+        triangle.depth = aDepths[0] - triangle.depthDx * aX[0] - triangle.depthDy * aY[0];
+        triangle.minDepth = std::min({ aDepths[0], aDepths[1], aDepths[2] });
+        triangle.maxDepth = std::max({ aDepths[0], aDepths[1], aDepths[2] });
+
+        const UINT uTriangleIdx = static_cast<UINT>(m_aTriangles.size());
+        m_aTriangles.push_back(triangle);
+        for (INT iTileY = triangle.iMinRow / static_cast<INT>(TILE_HEIGHT); iTileY <= triangle.iMaxRow / static_cast<INT>(TILE_HEIGHT); ++iTileY)
+        {
+            m_aBins[iTileY].push_back(uTriangleIdx);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::computeSpans
+
+      Summary:  Finds the first and last pixel whose center is in a
+                triangle on each scanline of a row of tiles, 4
+                scanlines at a time with SSE2. Scanlines out of the
+                triangle get a first pixel after their last
+
+      Args:     const Triangle& triangle
+                  Triangle to rasterize
+                INT iFirstRow
+                  First scanline of the row of tiles
+                INT* pLefts
+                  Receives the first pixel of each scanline
+                INT* pRights
+                  Receives the last pixel of each scanline
+
+      Modifies: [pLefts, pRights].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void OcclusionCuller::computeSpans(_In_ const Triangle& triangle, _In_ INT iFirstRow, _Out_writes_(TILE_HEIGHT) INT* pLefts, _Out_writes_(TILE_HEIGHT) INT* pRights) const
+    {
+        const FLOAT minLeft = static_cast<FLOAT>(triangle.iMinColumn);
+        const FLOAT maxLeft = static_cast<FLOAT>(triangle.iMaxColumn + 1);
+        const FLOAT minRight = static_cast<FLOAT>(triangle.iMinColumn - 1);
+        const FLOAT maxRight = static_cast<FLOAT>(triangle.iMaxColumn);
+#ifdef OCCLUSION_CULLER_SSE2
+        const __m128i minRow = _mm_set1_epi32(triangle.iMinRow);
+        const __m128i maxRow = _mm_set1_epi32(triangle.iMaxRow);
+        const __m128i emptyLeft = _mm_set1_epi32(triangle.iMaxColumn + 1);
+        const __m128i emptyRight = _mm_set1_epi32(triangle.iMinColumn - 1);
+        for (UINT uRow = 0u; uRow < TILE_HEIGHT; uRow += 4u)
+        {
+            const __m128i rows = _mm_add_epi32(_mm_set1_epi32(iFirstRow + static_cast<INT>(uRow)), _mm_setr_epi32(0, 1, 2, 3));
+            const __m128 centers = _mm_add_ps(_mm_cvtepi32_ps(rows), _mm_set1_ps(0.5f));
+
+            __m128 lefts = _mm_set1_ps(-FLT_MAX);
+            __m128 rights = _mm_set1_ps(FLT_MAX);
+            for (UINT i = 0u; i < 3u; ++i)
+            {
+                lefts = _mm_max_ps(lefts, _mm_add_ps(_mm_mul_ps(_mm_set1_ps(triangle.aLeftSlopes[i]), centers), _mm_set1_ps(triangle.aLeftOffsets[i])));
+                rights = _mm_min_ps(rights, _mm_add_ps(_mm_mul_ps(_mm_set1_ps(triangle.aRightSlopes[i]), centers), _mm_set1_ps(triangle.aRightOffsets[i])));
+            }
+
+            // Pixel x is covered when x + 0.5 is in the span, so the first pixel is the ceiling of left - 0.5 and the last the floor of right - 0.5
+            lefts = _mm_min_ps(_mm_max_ps(_mm_sub_ps(lefts, _mm_set1_ps(0.5f)), _mm_set1_ps(minLeft)), _mm_set1_ps(maxLeft));
+            rights = _mm_min_ps(_mm_max_ps(_mm_sub_ps(rights, _mm_set1_ps(0.5f)), _mm_set1_ps(minRight)), _mm_set1_ps(maxRight));
+            __m128i firstPixels = _mm_cvttps_epi32(lefts);
+            firstPixels = _mm_sub_epi32(firstPixels, _mm_castps_si128(_mm_cmplt_ps(_mm_cvtepi32_ps(firstPixels), lefts)));
+            __m128i lastPixels = _mm_cvttps_epi32(rights);
+            lastPixels = _mm_add_epi32(lastPixels, _mm_castps_si128(_mm_cmpgt_ps(_mm_cvtepi32_ps(lastPixels), rights)));
+
+            const __m128i outside = _mm_or_si128(_mm_cmplt_epi32(rows, minRow), _mm_cmpgt_epi32(rows, maxRow));
+            firstPixels = _mm_or_si128(_mm_and_si128(outside, emptyLeft), _mm_andnot_si128(outside, firstPixels));
+            lastPixels = _mm_or_si128(_mm_and_si128(outside, emptyRight), _mm_andnot_si128(outside, lastPixels));
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(pLefts + uRow), firstPixels);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(pRights + uRow), lastPixels);
+        }
+#else
+        for (UINT uRow = 0u; uRow < TILE_HEIGHT; ++uRow)
+        {
+            const INT iRow = iFirstRow + static_cast<INT>(uRow);
+            if (iRow < triangle.iMinRow || iRow > triangle.iMaxRow)
+            {
+                pLefts[uRow] = triangle.iMaxColumn + 1;
+                pRights[uRow] = triangle.iMinColumn - 1;
+                continue;
+            }
+
+            const FLOAT center = static_cast<FLOAT>(iRow) + 0.5f;
+            FLOAT left = -FLT_MAX;
+            FLOAT right = FLT_MAX;
+            for (UINT i = 0u; i < 3u; ++i)
+            {
+                left = std::max(left, triangle.aLeftSlopes[i] * center + triangle.aLeftOffsets[i]);
+                right = std::min(right, triangle.aRightSlopes[i] * center + triangle.aRightOffsets[i]);
+            }
+
+            pLefts[uRow] = static_cast<INT>(std::ceil(std::min(std::max(left - 0.5f, minLeft), maxLeft)));
+            pRights[uRow] = static_cast<INT>(std::floor(std::min(std::max(right - 0.5f, minRight), maxRight)));
+        }
+#endif
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::rasterizeBin
+
+      Summary:  Draws the triangles of a bin into its row of tiles, in
+                the order they were added. A triangle is skipped in a
+                tile its nearest depth is behind. Otherwise its
+                coverage joins the working layer with its farthest
+                depth over the tile, clamped to the reference depth.
+                The working layer is dropped first when it is farther
+                from the triangle than from the reference layer, and
+                becomes the reference layer once it covers the tile
+
+      Args:     UINT uBinIdx
+                  Index of the bin and of its row of tiles
+
+      Modifies: [m_aTiles].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void OcclusionCuller::rasterizeBin(_In_ UINT uBinIdx)
+    {
+        const INT iFirstRow = static_cast<INT>(uBinIdx * TILE_HEIGHT);
+        Tile* pTiles = m_aTiles.data() + static_cast<size_t>(uBinIdx) * m_uNumTilesX;
+
+        INT aLefts[TILE_HEIGHT];
+        INT aRights[TILE_HEIGHT];
+        for (UINT uTriangleIdx : m_aBins[uBinIdx])
+        {
+            const Triangle& triangle = m_aTriangles[uTriangleIdx];
+            computeSpans(triangle, iFirstRow, aLefts, aRights);
+
+            // Depths are bounded over the pixel centers of the triangle and the tile
+            const FLOAT minY = static_cast<FLOAT>(std::max(triangle.iMinRow, iFirstRow)) + 0.5f;
+            const FLOAT maxY = static_cast<FLOAT>(std::min(triangle.iMaxRow, iFirstRow + static_cast<INT>(TILE_HEIGHT) - 1)) + 0.5f;
+            const FLOAT minDepthY = triangle.depthDy * (triangle.depthDy > 0.0f ? minY : maxY);
+            const FLOAT maxDepthY = triangle.depthDy * (triangle.depthDy > 0.0f ? maxY : minY);
+
+            for (INT iTileX = triangle.iMinColumn / static_cast<INT>(TILE_WIDTH); iTileX <= triangle.iMaxColumn / static_cast<INT>(TILE_WIDTH); ++iTileX)
+            {
+                Tile& tile = pTiles[iTileX];
+                const INT iFirstColumn = iTileX * static_cast<INT>(TILE_WIDTH);
+                const FLOAT minX = static_cast<FLOAT>(std::max(triangle.iMinColumn, iFirstColumn)) + 0.5f;
+                const FLOAT maxX = static_cast<FLOAT>(std::min(triangle.iMaxColumn, iFirstColumn + static_cast<INT>(TILE_WIDTH) - 1)) + 0.5f;
+
+                const FLOAT minDepth = std::max(triangle.depth + triangle.depthDx * (triangle.depthDx > 0.0f ? minX : maxX) + minDepthY, triangle.minDepth);
+                if (minDepth >= tile.referenceDepth)
+                {
+                    continue;
+                }
+
+                UINT aMasks[TILE_HEIGHT];
+                UINT uCovered = 0u;
+                for (UINT uRow = 0u; uRow < TILE_HEIGHT; ++uRow)
+                {
+                    const INT iLow = std::max(aLefts[uRow] - iFirstColumn, 0);
+                    const INT iHigh = std::min(aRights[uRow] - iFirstColumn, static_cast<INT>(TILE_WIDTH) - 1);
+                    aMasks[uRow] = iLow <= iHigh ? (~0u >> (TILE_WIDTH - 1u - static_cast<UINT>(iHigh))) & (~0u << iLow) : 0u;
+                    uCovered |= aMasks[uRow];
+                }
+
+                if (uCovered == 0u)
+                {
+                    continue;
+                }
+
+                const FLOAT maxDepth = std::min({ triangle.depth + triangle.depthDx * (triangle.depthDx > 0.0f ? maxX : minX) + maxDepthY, triangle.maxDepth, tile.referenceDepth });
+                const BOOL bDropWorkingLayer = tile.workingDepth - maxDepth > tile.referenceDepth - tile.workingDepth;
+
+                UINT uFull = ~0u;
+                for (UINT uRow = 0u; uRow < TILE_HEIGHT; ++uRow)
+                {
+                    tile.aMasks[uRow] = (bDropWorkingLayer ? 0u : tile.aMasks[uRow]) | aMasks[uRow];
+                    uFull &= tile.aMasks[uRow];
+                }
+                tile.workingDepth = bDropWorkingLayer ? maxDepth : std::max(tile.workingDepth, maxDepth);
+
+                if (uFull == ~0u)
+                {
+                    std::fill(tile.aMasks, tile.aMasks + TILE_HEIGHT, 0u);
+                    tile.referenceDepth = tile.workingDepth;
+                    tile.workingDepth = 0.0f;
+                }
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::run
+
+      Summary:  Hands the bins to the threads of the pool, rasterizes
+                bins and waits until every thread is done
+
+      Modifies: [m_uJobId, m_uNumBusyThreads, m_uNextBinIdx].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void OcclusionCuller::run()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_uNextBinIdx = 0u;
+            m_uNumBusyThreads = static_cast<UINT>(m_aThreads.size());
+            ++m_uJobId;
+        }
+        m_jobCondition.notify_all();
+
+        rasterizeBins();
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_doneCondition.wait(lock, [this]() { return m_uNumBusyThreads == 0u; });
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::work
+
+      Summary:  Loop of a thread of the pool, which waits for a job,
+                rasterizes bins until none is left and reports that it
+                is done
+
+      Modifies: [m_uNumBusyThreads].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void OcclusionCuller::work()
+    {
+        UINT64 uJobId = 0u;
+        for (;;)
+        {
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_jobCondition.wait(lock, [this, &uJobId]() { return m_bStop || m_uJobId != uJobId; });
+                if (m_bStop)
+                {
+                    return;
+                }
+
+                uJobId = m_uJobId;
+            }
+
+            rasterizeBins();
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (--m_uNumBusyThreads == 0u)
+            {
+                m_doneCondition.notify_one();
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::rasterizeBins
+
+      Summary:  Claims and rasterizes bins until none is left
+
+      Modifies: [m_aTiles, m_uNextBinIdx].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void OcclusionCuller::rasterizeBins()
+    {
+        const UINT uNumBins = static_cast<UINT>(m_aBins.size());
+        for (UINT uBinIdx = m_uNextBinIdx++; uBinIdx < uNumBins; uBinIdx = m_uNextBinIdx++)
+        {
+            rasterizeBin(uBinIdx);
+        }
+    }
+}
@@ -0,0 +1,175 @@
+/*+===================================================================
+  File:      OCCLUSIONCULLER.H
+
+  Summary:   OcclusionCuller header file contains declarations of the
+             OcclusionCuller class that rasterizes occluders into a
+             low resolution masked depth buffer and tests bounding
+             boxes against it, on a pool of threads, without
+             Direct3D.
+
+  Classes: OcclusionCuller
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Platform.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    OcclusionCuller
+
+      Summary:  Masked software occlusion culling. The buffer is split
+                into TILE_WIDTH x TILE_HEIGHT tiles, and a tile keeps
+                one bit per pixel and two depths instead of a depth
+                per pixel: the reference depth, which every surface
+                of the tile is nearer than, and the working depth,
+                which the surfaces of the pixels whose bit is set are
+                nearer than. A triangle merges its coverage and
+                farthest depth into the working layer, which replaces
+                the reference layer once it covers the whole tile, or
+                is dropped when the triangle is much nearer than it.
+                The depth of a pixel is only ever overestimated, so a
+                box is culled only if it is behind every surface
+                drawn over it. The triangles are set up and binned by
+                rows of tiles on the calling thread, and the threads
+                of the pool claim the bins one at a time and
+                rasterize their triangles in order, so the buffer is
+                identical for any number of threads. The spans of 4
+                scanlines of a triangle are found at a time with SSE2.
+                Depths are those of the clip space of Direct3D, from
+                0 at the near plane to 1 at the far plane
+
+      Methods:  SetViewProjection
+                  Sets the view projection matrix of the occluders
+                  and boxes
+                Clear
+                  Removes every occluder
+                AddOccluder
+                  Sets up and bins the triangles of a mesh
+                Rasterize
+                  Draws the binned triangles into the buffer
+                IsBoxVisible
+                  Returns whether a box may be in front of the
+                  occluders
+                GetMaxDepth
+                  Returns the depth every surface of a pixel is
+                  nearer than
+                GetWidth
+                  Returns the width of the buffer
+                GetHeight
+                  Returns the height of the buffer
+                GetNumTriangles
+                  Returns the number of triangles set up
+                GetNumThreads
+                  Returns the number of threads rasterizing bins
+                OcclusionCuller
+                  Constructor.
+                ~OcclusionCuller
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class OcclusionCuller final
+    {
+    public:
+        static constexpr const UINT TILE_WIDTH = 32u;
+        static constexpr const UINT TILE_HEIGHT = 8u;
+        static constexpr const UINT DEFAULT_WIDTH = 256u;
+        static constexpr const UINT DEFAULT_HEIGHT = 144u;
+        static constexpr const FLOAT DEPTH_BIAS = 1.0e-6f;
+
+    public:
+        OcclusionCuller(_In_ UINT uWidth = DEFAULT_WIDTH, _In_ UINT uHeight = DEFAULT_HEIGHT, _In_ UINT uNumThreads = 0u);
+        OcclusionCuller(const OcclusionCuller& other) = delete;
+        OcclusionCuller(OcclusionCuller&& other) = delete;
+        OcclusionCuller& operator=(const OcclusionCuller& other) = delete;
+        OcclusionCuller& operator=(OcclusionCuller&& other) = delete;
+        ~OcclusionCuller();
+
+        void SetViewProjection(_In_reads_(16) const FLOAT* pViewProjection);
+
+        void Clear();
+        void AddOccluder(_In_reads_(16) const FLOAT* pWorld, _In_ const FLOAT* pPositions, _In_ UINT uStride, _In_ UINT uNumVertices, _In_reads_(uNumIndices) const WORD* pIndices, _In_ UINT uNumIndices);
+        void Rasterize();
+
+        BOOL IsBoxVisible(_In_reads_(3) const FLOAT* pCenter, _In_reads_(3) const FLOAT* pExtents) const;
+        FLOAT GetMaxDepth(_In_ UINT uX, _In_ UINT uY) const;
+
+        UINT GetWidth() const;
+        UINT GetHeight() const;
+        UINT GetNumTriangles() const;
+        UINT GetNumThreads() const;
+
+    private:
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+            Struct:   Tile
+            Summary:  Coverage of the working layer, one row of bits per
+                      scanline, and the depths of both layers
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct Tile
+        {
+            UINT aMasks[TILE_HEIGHT];
+            FLOAT referenceDepth;
+            FLOAT workingDepth;
+        };
+
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+            Struct:   Triangle
+            Summary:  Screen space triangle as the x of its left and
+                      right edges along a scanline, slope * y + offset,
+                      with edges that do not bound a side pushed out of
+                      the buffer, its depth plane and the pixels whose
+                      centers its bounds hold
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct Triangle
+        {
+            FLOAT aLeftSlopes[3];
+            FLOAT aLeftOffsets[3];
+            FLOAT aRightSlopes[3];
+            FLOAT aRightOffsets[3];
+            FLOAT depth;
+            FLOAT depthDx;
+            FLOAT depthDy;
+            FLOAT minDepth;
+            FLOAT maxDepth;
+            INT iMinColumn;
+            INT iMaxColumn;
+            INT iMinRow;
+            INT iMaxRow;
+        };
+
+        void addTriangle(_In_reads_(4) const FLOAT* pA, _In_reads_(4) const FLOAT* pB, _In_reads_(4) const FLOAT* pC);
+        void setupTriangle(_In_reads_(4) const FLOAT* pA, _In_reads_(4) const FLOAT* pB, _In_reads_(4) const FLOAT* pC);
+        void computeSpans(_In_ const Triangle& triangle, _In_ INT iFirstRow, _Out_writes_(TILE_HEIGHT) INT* pLefts, _Out_writes_(TILE_HEIGHT) INT* pRights) const;
+        void rasterizeBin(_In_ UINT uBinIdx);
+
+        void run();
+        void work();
+        void rasterizeBins();
+
+    private:
+        FLOAT m_aViewProjection[16];
+        UINT m_uWidth;
+        UINT m_uHeight;
+        UINT m_uNumTilesX;
+        UINT m_uNumTilesY;
+        std::vector<Tile> m_aTiles;
+        std::vector<Triangle> m_aTriangles;
+        std::vector<std::vector<UINT>> m_aBins;
+        std::vector<FLOAT> m_aClipPositions;
+        std::vector<std::thread> m_aThreads;
+        std::mutex m_mutex;
+        std::condition_variable m_jobCondition;
+        std::condition_variable m_doneCondition;
+        UINT64 m_uJobId;
+        UINT m_uNumBusyThreads;
+        BOOL m_bStop;
+        std::atomic<UINT> m_uNextBinIdx;
+    };
+}
@@ -0,0 +1,77 @@
+/*+===================================================================
+  File:      RENDERCONTEXT.H
+
+  Summary:   RenderContext header file contains declarations of the
+             RenderContext interface the renderer binds its state and
+             draws through, without Direct3D.
+
+  Classes: RenderContext
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Platform.h"
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    RenderContext
+
+      Summary:  Interface of the calls of the immediate context that
+                bind the state of a draw and draw. The arguments are
+                those of the ID3D11DeviceContext methods of the same
+                names, without the class instances of the shaders.
+                Direct3D objects are only passed through, so the
+                interface also builds without the Windows SDK and can
+                be implemented by a mock recording the calls
+
+      Methods:  IASetInputLayout
+                  Binds an input layout
+                IASetVertexBuffers
+                  Binds vertex buffers
+                IASetIndexBuffer
+                  Binds an index buffer
+                VSSetShader
+                  Binds a vertex shader
+                PSSetShader
+                  Binds a pixel shader
+                VSSetConstantBuffers
+                  Binds constant buffers to the vertex shader
+                PSSetConstantBuffers
+                  Binds constant buffers to the pixel shader
+                VSSetShaderResources
+                  Binds shader resource views to the vertex shader
+                PSSetShaderResources
+                  Binds shader resource views to the pixel shader
+                PSSetSamplers
+                  Binds samplers to the pixel shader
+                OMSetRenderTargets
+                  Binds render targets and a depth stencil view
+                DrawIndexed
+                  Draws indexed primitives
+                DrawIndexedInstanced
+                  Draws instances of indexed primitives
+                ~RenderContext
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class RenderContext
+    {
+    public:
+        virtual ~RenderContext() = default;
+
+        virtual void IASetInputLayout(_In_opt_ ID3D11InputLayout* pInputLayout) = 0;
+        virtual void IASetVertexBuffers(_In_ UINT uStartSlot, _In_ UINT uNumBuffers, _In_reads_(uNumBuffers) ID3D11Buffer* const* ppVertexBuffers, _In_reads_(uNumBuffers) const UINT* puStrides, _In_reads_(uNumBuffers) const UINT* puOffsets) = 0;
+        virtual void IASetIndexBuffer(_In_opt_ ID3D11Buffer* pIndexBuffer, _In_ DXGI_FORMAT format, _In_ UINT uOffset) = 0;
+        virtual void VSSetShader(_In_opt_ ID3D11VertexShader* pVertexShader) = 0;
+        virtual void PSSetShader(_In_opt_ ID3D11PixelShader* pPixelShader) = 0;
+        virtual void VSSetConstantBuffers(_In_ UINT uStartSlot, _In_ UINT uNumBuffers, _In_reads_(uNumBuffers) ID3D11Buffer* const* ppConstantBuffers) = 0;
+        virtual void PSSetConstantBuffers(_In_ UINT uStartSlot, _In_ UINT uNumBuffers, _In_reads_(uNumBuffers) ID3D11Buffer* const* ppConstantBuffers) = 0;
+        virtual void VSSetShaderResources(_In_ UINT uStartSlot, _In_ UINT uNumViews, _In_reads_(uNumViews) ID3D11ShaderResourceView* const* ppShaderResourceViews) = 0;
+        virtual void PSSetShaderResources(_In_ UINT uStartSlot, _In_ UINT uNumViews, _In_reads_(uNumViews) ID3D11ShaderResourceView* const* ppShaderResourceViews) = 0;
+        virtual void PSSetSamplers(_In_ UINT uStartSlot, _In_ UINT uNumSamplers, _In_reads_(uNumSamplers) ID3D11SamplerState* const* ppSamplers) = 0;
+        virtual void OMSetRenderTargets(_In_ UINT uNumViews, _In_reads_opt_(uNumViews) ID3D11RenderTargetView* const* ppRenderTargetViews, _In_opt_ ID3D11DepthStencilView* pDepthStencilView) = 0;
+        virtual void DrawIndexed(_In_ UINT uIndexCount, _In_ UINT uStartIndexLocation, _In_ INT iBaseVertexLocation) = 0;
+        virtual void DrawIndexedInstanced(_In_ UINT uIndexCountPerInstance, _In_ UINT uInstanceCount, _In_ UINT uStartIndexLocation, _In_ INT iBaseVertexLocation, _In_ UINT uStartInstanceLocation) = 0;
+    };
+}
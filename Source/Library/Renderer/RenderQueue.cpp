@@ -0,0 +1,304 @@
+#include "Renderer/RenderQueue.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   RenderQueue::RenderQueue
+
+      Summary:  Constructor
+
+      Modifies: [m_aCommands, m_aKeys, m_aSortedKeys, m_vertexShaderIds,
+                 m_pixelShaderIds, m_materialIds, m_constantIds,
+                 m_geometryIds].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    RenderQueue::RenderQueue()
+        : m_aCommands()
+        , m_aKeys()
+        , m_aSortedKeys()
+        , m_vertexShaderIds()
+        , m_pixelShaderIds()
+        , m_materialIds()
+        , m_constantIds()
+        , m_geometryIds()
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   RenderQueue::Clear
+
+      Summary:  Empties the queue for a new frame. The vectors keep
+                their capacity, so a frame with as many draws as the
+                previous one does not allocate
+
+      Modifies: [m_aCommands, m_aKeys, m_vertexShaderIds,
+                 m_pixelShaderIds, m_materialIds, m_constantIds,
+                 m_geometryIds].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void RenderQueue::Clear()
+    {
+        m_aCommands.clear();
+        m_aKeys.clear();
+        m_vertexShaderIds.clear();
+        m_pixelShaderIds.clear();
+        m_materialIds.clear();
+        m_constantIds.clear();
+        m_geometryIds.clear();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   RenderQueue::Push
+
+      Summary:  Adds a draw with its key. The shaders, the material,
+                the constant buffer and the geometry are numbered in
+                the order they are first pushed in the frame, so the
+                draws of one object stay together among the draws of
+                the same state. The material is the textures and
+                samplers of the draw, the geometry its vertex and
+                index buffers. Ids past the bits of their field wrap,
+                which only makes the sort group less of the state
+
+      Args:     eRenderPass pass
+                  Pass of the draw
+                FLOAT depth
+                  Distance from the camera, the draws of one
+                  material and constant buffer are submitted from the
+                  nearest
+                const DrawCommand& command
+                  State and arguments of the draw
+
+      Modifies: [m_aCommands, m_aKeys, m_vertexShaderIds,
+                 m_pixelShaderIds, m_materialIds, m_constantIds,
+                 m_geometryIds].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void RenderQueue::Push(_In_ eRenderPass pass, _In_ FLOAT depth, _In_ const DrawCommand& command)
+    {
+        constexpr const UINT NUM_SHADER_ID_BITS = NUM_SHADER_BITS / 2u;
+        constexpr const UINT64 SHADER_ID_MASK = (1ull << NUM_SHADER_ID_BITS) - 1ull;
+
+        const UINT64 uVertexShader = getId(m_vertexShaderIds, hashPointers(command.pVertexShader, command.pInputLayout, nullptr)) & SHADER_ID_MASK;
+        const UINT64 uPixelShader = getId(m_pixelShaderIds, hashPointers(command.pPixelShader, nullptr, nullptr)) & SHADER_ID_MASK;
+        const UINT64 uShader = (uVertexShader << NUM_SHADER_ID_BITS) | uPixelShader;
+        const UINT64 uMaterial = getId(m_materialIds, hashPointers(command.apShaderResourceViews[0], command.apShaderResourceViews[1], command.apSamplers[0])) & ((1ull << NUM_MATERIAL_BITS) - 1ull);
+        const UINT64 uConstant = getId(m_constantIds, hashPointers(command.pConstantBuffer, command.apVSConstantBuffers[0], command.apVSConstantBuffers[1])) & ((1ull << NUM_CONSTANT_BITS) - 1ull);
+        const UINT64 uGeometry = getId(m_geometryIds, hashPointers(command.apVertexBuffers[0], command.apVertexBuffers[2], command.pIndexBuffer)) & ((1ull << NUM_GEOMETRY_BITS) - 1ull);
+
+        // The bits of a positive float sort like its value, the highest ones below the sign bit are its exponent and leading mantissa
+        const UINT64 uDepth = (std::bit_cast<UINT>(std::max(depth, 0.0f)) >> (31u - NUM_DEPTH_BITS)) & ((1ull << NUM_DEPTH_BITS) - 1ull);
+
+        UINT64 uKey = static_cast<UINT64>(pass);
+        uKey = (uKey << NUM_SHADER_BITS) | uShader;
+        uKey = (uKey << NUM_MATERIAL_BITS) | uMaterial;
+        uKey = (uKey << NUM_CONSTANT_BITS) | uConstant;
+        uKey = (uKey << NUM_DEPTH_BITS) | uDepth;
+        uKey = (uKey << NUM_GEOMETRY_BITS) | uGeometry;
+
+        m_aKeys.push_back(DrawKey{ .uKey = uKey, .uCommand = static_cast<UINT>(m_aCommands.size()) });
+        m_aCommands.push_back(command);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   RenderQueue::Sort
+
+      Summary:  Sorts the keys with a least significant digit radix
+                sort of 8 bit digits. The counts of every digit are
+                taken in one sweep, and a digit all the keys share is
+                skipped, so the pass and the high ids of a small frame
+                cost nothing. Draws with equal keys keep the order
+                they were pushed in
+
+      Modifies: [m_aKeys, m_aSortedKeys].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void RenderQueue::Sort()
+    {
+        constexpr const UINT NUM_DIGITS = sizeof(UINT64);
+        constexpr const UINT NUM_BUCKETS = 256u;
+
+        if (m_aKeys.size() < 2u)
+        {
+            return;
+        }
+
+        UINT aauCounts[NUM_DIGITS][NUM_BUCKETS] = {};
+        for (const DrawKey& key : m_aKeys)
+        {
+            for (UINT uDigit = 0u; uDigit < NUM_DIGITS; ++uDigit)
+            {
+                ++aauCounts[uDigit][(key.uKey >> (uDigit * 8u)) & 0xFFull];
+            }
+        }
+
+        m_aSortedKeys.resize(m_aKeys.size());
+        for (UINT uDigit = 0u; uDigit < NUM_DIGITS; ++uDigit)
+        {
+            const UINT uShift = uDigit * 8u;
+            if (aauCounts[uDigit][(m_aKeys[0].uKey >> uShift) & 0xFFull] == m_aKeys.size())
+            {
+                continue;
+            }
+
+            UINT auOffsets[NUM_BUCKETS];
+            UINT uOffset = 0u;
+            for (UINT uBucket = 0u; uBucket < NUM_BUCKETS; ++uBucket)
+            {
+                auOffsets[uBucket] = uOffset;
+                uOffset += aauCounts[uDigit][uBucket];
+            }
+
+            for (const DrawKey& key : m_aKeys)
+            {
+                m_aSortedKeys[auOffsets[(key.uKey >> uShift) & 0xFFull]++] = key;
+            }
+            m_aKeys.swap(m_aSortedKeys);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   RenderQueue::Submit
+
+      Summary:  Draws the commands in the order of their keys, binding
+                every slot a command sets. Consecutive draws mostly
+                bind the same state, so submitting through a
+                StateFilteringContext drops most of the binds
+
+      Args:     RenderContext* pRenderContext
+                  The context to bind and draw with
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void RenderQueue::Submit(_In_ RenderContext* pRenderContext)
+    {
+        for (const DrawKey& key : m_aKeys)
+        {
+            const DrawCommand& command = m_aCommands[key.uCommand];
+
+            if (command.pInputLayout)
+            {
+                pRenderContext->IASetInputLayout(command.pInputLayout);
+            }
+
+            if (command.pVertexShader)
+            {
+                pRenderContext->VSSetShader(command.pVertexShader);
+            }
+
+            if (command.pPixelShader)
+            {
+                pRenderContext->PSSetShader(command.pPixelShader);
+            }
+
+            for (UINT uSlot = 0u; uSlot < DrawCommand::NUM_VERTEX_BUFFERS; ++uSlot)
+            {
+                if (command.apVertexBuffers[uSlot])
+                {
+                    const UINT uOffset = 0u;
+                    pRenderContext->IASetVertexBuffers(uSlot, 1u, &command.apVertexBuffers[uSlot], &command.auStrides[uSlot], &uOffset);
+                }
+            }
+
+            if (command.pIndexBuffer)
+            {
+                pRenderContext->IASetIndexBuffer(command.pIndexBuffer, DXGI_FORMAT_R16_UINT, 0u);
+            }
+
+            if (command.pConstantBuffer)
+            {
+                pRenderContext->VSSetConstantBuffers(2u, 1u, &command.pConstantBuffer);
+                pRenderContext->PSSetConstantBuffers(2u, 1u, &command.pConstantBuffer);
+            }
+
+            for (UINT uSlot = 0u; uSlot < DrawCommand::NUM_VS_CONSTANT_BUFFERS; ++uSlot)
+            {
+                if (command.apVSConstantBuffers[uSlot])
+                {
+                    pRenderContext->VSSetConstantBuffers(4u + uSlot, 1u, &command.apVSConstantBuffers[uSlot]);
+                }
+            }
+
+            if (command.pVSShaderResourceView)
+            {
+                pRenderContext->VSSetShaderResources(2u, 1u, &command.pVSShaderResourceView);
+            }
+
+            for (UINT uSlot = 0u; uSlot < DrawCommand::NUM_TEXTURES; ++uSlot)
+            {
+                if (command.apShaderResourceViews[uSlot])
+                {
+                    pRenderContext->PSSetShaderResources(uSlot, 1u, &command.apShaderResourceViews[uSlot]);
+                }
+
+                if (command.apSamplers[uSlot])
+                {
+                    pRenderContext->PSSetSamplers(uSlot, 1u, &command.apSamplers[uSlot]);
+                }
+            }
+
+            if (command.uNumInstances > 0u)
+            {
+                pRenderContext->DrawIndexedInstanced(command.uNumIndices, command.uNumInstances, command.uStartIndex, command.iBaseVertex, command.uStartInstance);
+            }
+            else
+            {
+                pRenderContext->DrawIndexed(command.uNumIndices, command.uStartIndex, command.iBaseVertex);
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   RenderQueue::GetNumCommands
+
+      Summary:  Returns the number of draws in the queue
+
+      Returns:  UINT
+                  Number of draws pushed since the last Clear
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT RenderQueue::GetNumCommands() const
+    {
+        return static_cast<UINT>(m_aCommands.size());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   RenderQueue::getId
+
+      Summary:  Returns the id of some state, numbering new state in
+                the order it is seen
+
+      Args:     std::unordered_map<UINT64, UINT>& ids
+                  Ids of the state seen so far
+                UINT64 uHash
+                  Hash of the state
+
+      Modifies: [ids].
+
+      Returns:  UINT
+                  Id of the state
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT RenderQueue::getId(_Inout_ std::unordered_map<UINT64, UINT>& ids, _In_ UINT64 uHash)
+    {
+        return ids.try_emplace(uHash, static_cast<UINT>(ids.size())).first->second;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   RenderQueue::hashPointers
+
+      Summary:  Hashes up to three pointers with FNV-1a over their
+                values. Two states that collide only share an id, the
+                commands still bind their own state
+
+      Args:     const void* pFirst, const void* pSecond,
+                const void* pThird
+                  Pointers to hash, null for the unused ones
+
+      Returns:  UINT64
+                  Hash of the pointers
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT64 RenderQueue::hashPointers(_In_ const void* pFirst, _In_ const void* pSecond, _In_ const void* pThird)
+    {
+        const UINT64 auValues[] = { reinterpret_cast<UINT64>(pFirst), reinterpret_cast<UINT64>(pSecond), reinterpret_cast<UINT64>(pThird) };
+
+        UINT64 uHash = 14695981039346656037ull;
+        for (UINT64 uValue : auValues)
+        {
+            uHash = (uHash ^ uValue) * 1099511628211ull;
+        }
+
+        return uHash;
+    }
+}
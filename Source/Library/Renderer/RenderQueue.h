@@ -0,0 +1,152 @@
+/*+===================================================================
+  File:      RENDERQUEUE.H
+
+  Summary:   RenderQueue header file contains declarations of the
+             RenderQueue class that sorts the draws of a frame by the
+             state they bind before submitting them, without Direct3D.
+
+  Classes: RenderQueue
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Platform.h"
+
+#include <algorithm>
+#include <bit>
+#include <unordered_map>
+
+#include "Renderer/RenderContext.h"
+
+namespace library
+{
+    /*E+E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E
+        Enum:     eRenderPass
+        Summary:  Enumeration of the passes of the frame, in the order
+                  their draws are submitted
+    E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E-E*/
+    enum class eRenderPass : BYTE
+    {
+        GEOMETRY,
+        SKYBOX,
+        COUNT,
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+        Struct:   DrawCommand
+        Summary:  Every state a draw binds and the arguments of the
+                  draw. A null pointer is a slot the shaders do not
+                  read, so whatever is bound there is left as it is.
+                  The vertex shader constant buffers are b4 and b5,
+                  its shader resource view t2, and the pixel shader
+                  textures t0 and t1
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct DrawCommand
+    {
+        static constexpr const UINT NUM_VERTEX_BUFFERS = 3u;
+        static constexpr const UINT NUM_VS_CONSTANT_BUFFERS = 2u;
+        static constexpr const UINT NUM_TEXTURES = 2u;
+
+        ID3D11InputLayout* pInputLayout;
+        ID3D11VertexShader* pVertexShader;
+        ID3D11PixelShader* pPixelShader;
+        ID3D11Buffer* apVertexBuffers[NUM_VERTEX_BUFFERS];
+        UINT auStrides[NUM_VERTEX_BUFFERS];
+        ID3D11Buffer* pIndexBuffer;
+        ID3D11Buffer* pConstantBuffer;
+        ID3D11Buffer* apVSConstantBuffers[NUM_VS_CONSTANT_BUFFERS];
+        ID3D11ShaderResourceView* pVSShaderResourceView;
+        ID3D11ShaderResourceView* apShaderResourceViews[NUM_TEXTURES];
+        ID3D11SamplerState* apSamplers[NUM_TEXTURES];
+        UINT uNumIndices;
+        UINT uStartIndex;
+        INT iBaseVertex;
+        UINT uNumInstances;
+        UINT uStartInstance;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+        Struct:   DrawKey
+        Summary:  Sort key of a draw and the index of its command
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct DrawKey
+    {
+        UINT64 uKey;
+        UINT uCommand;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    RenderQueue
+
+      Summary:  Queue of the draws of a frame. Every draw gets a 64 bit
+                key packing, from the highest bits, its pass, its
+                shaders, its material, its constant buffer, its depth
+                and its geometry, so sorting the keys puts the draws
+                sharing the most costly state next to each other, and
+                the draws of one state front to back. The geometry
+                comes last, the chunks of a voxel map change it on
+                almost every draw, so it would only break up the
+                groups of one material and their order by depth. The keys are sorted with a radix sort,
+                and the commands are submitted in that order, so the
+                binds of consecutive draws mostly repeat and are
+                dropped by a StateFilteringContext
+
+      Methods:  Clear
+                  Empties the queue for a new frame
+                Push
+                  Adds a draw
+                Sort
+                  Sorts the draws by their keys
+                Submit
+                  Binds the state and draws in sorted order
+                GetNumCommands
+                  Returns the number of draws in the queue
+                RenderQueue
+                  Constructor.
+                ~RenderQueue
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class RenderQueue final
+    {
+    public:
+        static constexpr const UINT NUM_PASS_BITS = 4u;
+        static constexpr const UINT NUM_SHADER_BITS = 12u;
+        static constexpr const UINT NUM_MATERIAL_BITS = 10u;
+        static constexpr const UINT NUM_CONSTANT_BITS = 10u;
+        static constexpr const UINT NUM_DEPTH_BITS = 18u;
+        static constexpr const UINT NUM_GEOMETRY_BITS = 10u;
+
+        static_assert(NUM_PASS_BITS + NUM_SHADER_BITS + NUM_MATERIAL_BITS + NUM_CONSTANT_BITS + NUM_DEPTH_BITS + NUM_GEOMETRY_BITS == 64u, "The fields of a key fill 64 bits");
+        static_assert(static_cast<UINT>(eRenderPass::COUNT) <= (1u << NUM_PASS_BITS), "Every pass fits in the pass field of a key");
+
+    public:
+        RenderQueue();
+        RenderQueue(const RenderQueue& other) = delete;
+        RenderQueue(RenderQueue&& other) = delete;
+        RenderQueue& operator=(const RenderQueue& other) = delete;
+        RenderQueue& operator=(RenderQueue&& other) = delete;
+        ~RenderQueue() = default;
+
+        void Clear();
+        void Push(_In_ eRenderPass pass, _In_ FLOAT depth, _In_ const DrawCommand& command);
+        void Sort();
+        void Submit(_In_ RenderContext* pRenderContext);
+
+        UINT GetNumCommands() const;
+
+    private:
+        static UINT getId(_Inout_ std::unordered_map<UINT64, UINT>& ids, _In_ UINT64 uHash);
+        static UINT64 hashPointers(_In_ const void* pFirst, _In_ const void* pSecond, _In_ const void* pThird);
+
+    private:
+        std::vector<DrawCommand> m_aCommands;
+        std::vector<DrawKey> m_aKeys;
+        std::vector<DrawKey> m_aSortedKeys;
+        std::unordered_map<UINT64, UINT> m_vertexShaderIds;
+        std::unordered_map<UINT64, UINT> m_pixelShaderIds;
+        std::unordered_map<UINT64, UINT> m_materialIds;
+        std::unordered_map<UINT64, UINT> m_constantIds;
+        std::unordered_map<UINT64, UINT> m_geometryIds;
+    };
+}
@@ -1,5 +1,7 @@
 ﻿#include "Renderer/Renderable.h"
 
+#include <cfloat>
+
 #include "assimp/Importer.hpp"	// C++ importer interface
 #include "assimp/scene.h"		// output data structure
 #include "assimp/postprocess.h"	// post processing flags
@@ -195,6 +197,9 @@ namespace library
 			};
 		*/
 
+		// Meshes of models already have the bounds of their vertices
+		calculateBoundingBoxes();
+
 		if (m_aNormalData.empty())
 		{
 			calculateNormalMapVectors();
@@ -561,6 +566,40 @@ namespace library
 		return static_cast<UINT>(m_aMaterials.size());
 	}
 
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderable::calculateBoundingBoxes
+
+	  Summary:  Calculate the axis-aligned bounding box in object space
+				of the vertices indexed by every mesh that has none
+
+	  Modifies: [m_aMeshes].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Renderable::calculateBoundingBoxes()
+	{
+		const SimpleVertex* aVertices = getVertices();
+		const WORD* aIndices = getIndices();
+
+		for (BasicMeshEntry& mesh : m_aMeshes)
+		{
+			if (mesh.bHasBoundingBox || mesh.uNumIndices == 0u)
+			{
+				continue;
+			}
+
+			XMVECTOR minCorner = XMVectorReplicate(FLT_MAX);
+			XMVECTOR maxCorner = XMVectorReplicate(-FLT_MAX);
+			for (UINT i = 0u; i < mesh.uNumIndices; ++i)
+			{
+				const XMVECTOR position = XMLoadFloat3(&aVertices[mesh.uBaseVertex + aIndices[mesh.uBaseIndex + i]].Position);
+				minCorner = XMVectorMin(minCorner, position);
+				maxCorner = XMVectorMax(maxCorner, position);
+			}
+
+			BoundingBox::CreateFromPoints(mesh.boundingBox, minCorner, maxCorner);
+			mesh.bHasBoundingBox = TRUE;
+		}
+	}
+
 	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
 	  Method:   Renderable::calculateNormalMapVectors
 
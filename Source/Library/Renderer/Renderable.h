@@ -13,6 +13,8 @@
 
 #include "Common.h"
 
+#include <DirectXCollision.h>
+
 #include "Renderer/DataTypes.h"
 #include "Shader/PixelShader.h"
 #include "Shader/VertexShader.h"
@@ -63,6 +65,8 @@ namespace library
                 , uBaseVertex(0u)
                 , uBaseIndex(0u)
                 , uMaterialIndex(INVALID_MATERIAL)
+                , boundingBox()
+                , bHasBoundingBox(FALSE)
             {
             }
 
@@ -70,6 +74,8 @@ namespace library
             UINT uBaseVertex;
             UINT uBaseIndex;
             UINT uMaterialIndex;
+            BoundingBox boundingBox;
+            BOOL bHasBoundingBox;
         };
 
     public:
@@ -125,6 +131,7 @@ namespace library
             _In_ ID3D11DeviceContext* pImmediateContext
         );
 
+        void calculateBoundingBoxes();
         void calculateNormalMapVectors();
         void calculateTangentBitangent(_In_ const SimpleVertex& v1, _In_ const SimpleVertex& v2, _In_ const SimpleVertex& v3, _Out_ XMFLOAT3& tangent, _Out_ XMFLOAT3& bitangent);
 
@@ -22,8 +22,17 @@ namespace library
 				  m_swapChain1, m_renderTargetView, m_depthStencil,
 				  m_depthStencilView, m_cbChangeOnResize, m_cbShadowMatrix,
 				  m_pszMainSceneName, m_camera, m_projection, m_scenes
-				  m_invalidTexture, m_shadowMapTexture, m_shadowVertexShader,
-				  m_shadowPixelShader].
+				  m_invalidTexture, m_shadowVertexShader,
+				  m_shadowPixelShader, m_uNumDrawCalls, m_renderQueue,
+				  m_renderContext, m_frustumCuller, m_voxelChunkCuller,
+				  m_voxelInstanceCuller, m_aVoxelInstanceSpans,
+				  m_visibleVoxelInstanceBuffer,
+				  m_uMaxNumVisibleVoxelInstances,
+				  m_uNumVisibleVoxelInstances, m_visibleMapInstances,
+				  m_aVisibleVoxelInstances, m_occlusionCuller,
+				  m_aVisibleVoxelChunks, m_uNumOccludedMeshes,
+				  m_frameGraph, m_shadowMapDesc, m_uShadowMap,
+				  m_aFrameGraphTextures].
 	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
 	Renderer::Renderer() :
 		m_driverType(D3D_DRIVER_TYPE_NULL)
@@ -51,9 +60,27 @@ namespace library
 		, m_scenes(std::unordered_map<std::wstring, std::shared_ptr<Scene>>())
 		, m_invalidTexture(std::make_shared<Texture>(L"Content/Common/InvalidTexture.png"))
 		, m_cbShadowMatrix(nullptr)
-		, m_shadowMapTexture()
 		, m_shadowVertexShader()
 		, m_shadowPixelShader()
+		, m_uNumDrawCalls(0u)
+		, m_renderQueue()
+		, m_renderContext()
+		, m_frustumCuller()
+		, m_voxelChunkCuller()
+		, m_voxelInstanceCuller()
+		, m_aVoxelInstanceSpans()
+		, m_visibleVoxelInstanceBuffer()
+		, m_uMaxNumVisibleVoxelInstances(0u)
+		, m_uNumVisibleVoxelInstances(0u)
+		, m_visibleMapInstances()
+		, m_aVisibleVoxelInstances()
+		, m_occlusionCuller()
+		, m_aVisibleVoxelChunks()
+		, m_uNumOccludedMeshes(0u)
+		, m_frameGraph()
+		, m_shadowMapDesc()
+		, m_uShadowMap(FrameGraph::INVALID_INDEX)
+		, m_aFrameGraphTextures()
 	{
 	}
 
@@ -266,7 +293,10 @@ namespace library
 		if (FAILED(hr))
 			return hr;
 
-		m_immediateContext->OMSetRenderTargets(1, m_renderTargetView.GetAddressOf(), m_depthStencilView.Get());
+		// Every bind of the renderer goes through the state filter, which drops the binds of what is already bound
+		m_renderContext = std::make_shared<StateFilteringContext>(std::make_shared<D3D11RenderContext>(m_immediateContext.Get()));
+
+		m_renderContext->OMSetRenderTargets(1, m_renderTargetView.GetAddressOf(), m_depthStencilView.Get());
 
 		// Setup the viewport
 		D3D11_VIEWPORT vp =
@@ -307,7 +337,7 @@ namespace library
 			.Projection = XMMatrixTranspose(m_projection)
 		};
 		m_immediateContext->UpdateSubresource(m_cbChangeOnResize.Get(), 0, nullptr, &cbChangesOnResize, 0, 0);
-		m_immediateContext->VSSetConstantBuffers(1, 1, m_cbChangeOnResize.GetAddressOf());
+		m_renderContext->VSSetConstantBuffers(1, 1, m_cbChangeOnResize.GetAddressOf());
 
 		bd.ByteWidth = sizeof(CBLights);
 		bd.Usage = D3D11_USAGE_DEFAULT;
@@ -320,8 +350,8 @@ namespace library
 			return hr;
 		}
 
-		m_immediateContext->VSSetConstantBuffers(3, 1, m_cbLights.GetAddressOf());
-		m_immediateContext->PSSetConstantBuffers(3, 1, m_cbLights.GetAddressOf());
+		m_renderContext->VSSetConstantBuffers(3, 1, m_cbLights.GetAddressOf());
+		m_renderContext->PSSetConstantBuffers(3, 1, m_cbLights.GetAddressOf());
 
 		// Shadow Constant Buffer
 		bd.ByteWidth = sizeof(CBShadowMatrix);
@@ -335,11 +365,8 @@ namespace library
 			return hr;
 		}
 
-		// Initialize shadow map texture
-		m_shadowMapTexture = std::make_shared<RenderTexture>(width, height);
-
-		hr = m_shadowMapTexture->Initialize(m_d3dDevice.Get(), m_immediateContext.Get());
-		if (FAILED(hr)) return hr;
+		// The shadow map is a transient texture of the frame graph, created with the first frame
+		m_shadowMapDesc = FrameGraphTextureDesc{ .uWidth = width, .uHeight = height, .format = DXGI_FORMAT_R32G32B32A32_FLOAT, .uBytesPerTexel = 16u };
 
 		hr = m_camera.Initialize(m_d3dDevice.Get());
 		if (FAILED(hr)) return hr;
@@ -672,22 +699,78 @@ namespace library
 		m_scenes[m_pszMainSceneName]->Update(deltaTime);
 
 		m_camera.Update(deltaTime);
+
+		m_scenes[m_pszMainSceneName]->UpdateVoxelStreaming(m_camera.GetEye());
+		m_scenes[m_pszMainSceneName]->UpdateVoxelLods(m_camera.GetEye());
+
+		// The previous instances stay in the buffer if it cannot be mapped
+		m_scenes[m_pszMainSceneName]->UpdateVoxelInstances(m_immediateContext.Get());
+
+		// The previous patches are drawn again if their buffer cannot be mapped
+		m_scenes[m_pszMainSceneName]->UpdateTerrain(m_immediateContext.Get(), m_camera.GetEye());
 	}
 
 	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
 	  Method:   Renderer::Render
 
-	  Summary:  Render the frame
+	  Summary:  Render the frame. The shadow pass and the main pass
+				are declared in the frame graph every frame with the
+				textures they read and write, and the graph binds and
+				unbinds them
+
+	  Modifies: [m_uNumDrawCalls, m_frameGraph, m_uShadowMap,
+				 m_aFrameGraphTextures].
 	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
 	/*--------------------------------------------------------------------
 	 TODO: Renderer::Render definition (remove the comment)
    --------------------------------------------------------------------*/
 	void Renderer::Render()
 	{
+		m_uNumDrawCalls = 0u;
+		m_renderContext->ResetCounts();
+
+		// The back buffer and the depth buffer live out of the graph, the shadow map only between the passes that write and read it
+		m_frameGraph.Reset();
+		const UINT uBackBuffer = m_frameGraph.ImportTexture(L"BackBuffer", FrameGraphViews{ .pRenderTargetView = m_renderTargetView.Get(), .pDepthStencilView = nullptr, .pShaderResourceView = nullptr }, TRUE);
+		const UINT uDepthStencil = m_frameGraph.ImportTexture(L"DepthStencil", FrameGraphViews{ .pRenderTargetView = nullptr, .pDepthStencilView = m_depthStencilView.Get(), .pShaderResourceView = nullptr }, FALSE);
+		m_uShadowMap = m_frameGraph.CreateTexture(L"ShadowMap", m_shadowMapDesc);
+
+		const UINT uShadowPass = m_frameGraph.AddPass(L"Shadow", [this]() { RenderSceneToTexture(); });
+		m_frameGraph.Write(uShadowPass, m_uShadowMap, eFrameGraphUsage::RENDER_TARGET, FALSE);
+		m_frameGraph.Write(uShadowPass, uDepthStencil, eFrameGraphUsage::DEPTH_STENCIL, FALSE);
+
+		const UINT uMainPass = m_frameGraph.AddPass(L"Main", [this]() { renderMainPass(); });
+		m_frameGraph.Read(uMainPass, m_uShadowMap, 2u);
+		m_frameGraph.Write(uMainPass, uBackBuffer, eFrameGraphUsage::RENDER_TARGET, FALSE);
+		m_frameGraph.Write(uMainPass, uDepthStencil, eFrameGraphUsage::DEPTH_STENCIL, FALSE);
+
+		if (m_frameGraph.Compile() && SUCCEEDED(createFrameGraphTextures()))
+		{
+			m_frameGraph.Execute(m_renderContext.get());
+		}
 
-		RenderSceneToTexture();
+		// Unbind vertex slots so the shadow pass of the next frame doesn't complain
+		ID3D11Buffer* nullVB[3] = { nullptr, nullptr, nullptr };
+		UINT zero[3] = { 0u, 0u, 0u };
+		m_renderContext->IASetVertexBuffers( 0, 3, nullVB, zero, zero);
 
+		// present the information rendered to the back buffer to the front buffer
+	
+		m_swapChain->Present(0, 0);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::renderMainPass
 
+	  Summary:  Draws the scene to the back buffer, shadowed by the
+				shadow map the frame graph binds to t2
+
+	  Modifies: [m_uNumDrawCalls, m_renderQueue, m_frustumCuller,
+				 m_voxelChunkCuller, m_occlusionCuller,
+				 m_aVisibleVoxelChunks, m_uNumOccludedMeshes].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Renderer::renderMainPass()
+	{
 		// Clear the backbuffer
 		constexpr float clearColor[4] = { 0.0f, 0.125f, 0.6f, 1.0f };
 		m_immediateContext->ClearRenderTargetView(m_renderTargetView.Get(), clearColor);
@@ -704,8 +787,8 @@ namespace library
 		};
 		m_immediateContext->UpdateSubresource(m_camera.GetConstantBuffer().Get(), 0, nullptr, &cbView, 0, 0);
 
-		m_immediateContext->VSSetConstantBuffers(0, 1, m_camera.GetConstantBuffer().GetAddressOf());
-		m_immediateContext->PSSetConstantBuffers(0, 1, m_camera.GetConstantBuffer().GetAddressOf());
+		m_renderContext->VSSetConstantBuffers(0, 1, m_camera.GetConstantBuffer().GetAddressOf());
+		m_renderContext->PSSetConstantBuffers(0, 1, m_camera.GetConstantBuffer().GetAddressOf());
 
 		const auto& mainScene = m_scenes[m_pszMainSceneName];
 
@@ -730,11 +813,11 @@ namespace library
 
 		m_immediateContext->UpdateSubresource(m_cbLights.Get(), 0, nullptr, &cbLights, 0, 0);
 
-		m_immediateContext->PSSetConstantBuffers(3, 1, m_cbLights.GetAddressOf());
+		m_renderContext->PSSetConstantBuffers(3, 1, m_cbLights.GetAddressOf());
 
-		// Shadow
-		m_immediateContext->PSSetShaderResources(2, 1, m_shadowMapTexture->GetShaderResourceView().GetAddressOf());
-		m_immediateContext->PSSetSamplers(2, 1, m_shadowMapTexture->GetSamplerState().GetAddressOf());
+		// Shadow, the frame graph binds the shadow map
+		const std::shared_ptr<RenderTexture>& shadowMap = m_aFrameGraphTextures[m_frameGraph.GetPhysicalTexture(m_uShadowMap)];
+		m_renderContext->PSSetSamplers(2, 1, shadowMap->GetSamplerState().GetAddressOf());
 
 		// Environment
 		const auto& skybox = mainScene->GetSkyBox();
@@ -744,103 +827,186 @@ namespace library
 			const auto& envTexView = material->pDiffuse->GetTextureResourceView();
 			const auto& envSampler = Texture::s_samplers[static_cast<size_t>(material->pDiffuse->GetSamplerType())];
 
-			m_immediateContext->PSSetShaderResources(3, 1, envTexView.GetAddressOf());
-			m_immediateContext->PSSetSamplers(3, 1, envSampler.GetAddressOf());
+			m_renderContext->PSSetShaderResources(3, 1, envTexView.GetAddressOf());
+			m_renderContext->PSSetSamplers(3, 1, envSampler.GetAddressOf());
 		}
 
-		// For each renderables
-		for (const auto& iterr : mainScene->GetRenderables())
+		// Every draw of the frame is queued with the state it binds, then sorted by that state and submitted
+		m_renderQueue.Clear();
+
+		const XMVECTOR eye = m_camera.GetEye();
+		auto getDepth = [&eye](_In_ FXMVECTOR position)
 		{
-			const auto& renderable = iterr.second;
+			return XMVectorGetX(XMVector3Length(XMVectorSubtract(position, eye)));
+		};
 
-			// Set the vertex buffer
-			UINT stride = sizeof(SimpleVertex);
-			UINT offset = 0;
+		// The shaders, the geometry and the constant buffer of an object, common to its meshes
+		auto getCommand = [](_In_ Renderable& renderable)
+		{
+			DrawCommand command = {
+				.pInputLayout = renderable.GetVertexLayout().Get(),
+				.pVertexShader = renderable.GetVertexShader().Get(),
+				.pPixelShader = renderable.GetPixelShader().Get(),
+				.apVertexBuffers = { renderable.GetVertexBuffer().Get(), renderable.GetNormalBuffer().Get(), nullptr },
+				.auStrides = { sizeof(SimpleVertex), sizeof(NormalData), 0u },
+				.pIndexBuffer = renderable.GetIndexBuffer().Get(),
+				.pConstantBuffer = renderable.GetConstantBuffer().Get()
+			};
+			return command;
+		};
 
-			m_immediateContext->IASetVertexBuffers(0, 1, renderable->GetVertexBuffer().GetAddressOf(), &stride, &offset);
+		// The diffuse texture of a material, and its normal map if the object has them
+		auto setMaterial = [](_Inout_ DrawCommand& command, _In_ const std::shared_ptr<Material>& material, _In_ BOOL bHasNormalMap)
+		{
+			command.apShaderResourceViews[0] = material->pDiffuse->GetTextureResourceView().Get();
+			command.apSamplers[0] = Texture::s_samplers[static_cast<size_t>(material->pDiffuse->GetSamplerType())].Get();
 
-			// Set the normal buffer
-			UINT norStride = sizeof(NormalData);
-			UINT norOffset = 0;
+			if (bHasNormalMap)
+			{
+				command.apShaderResourceViews[1] = material->pNormal->GetTextureResourceView().Get();
+				command.apSamplers[1] = Texture::s_samplers[static_cast<size_t>(material->pNormal->GetSamplerType())].Get();
+			}
+		};
 
-			m_immediateContext->IASetVertexBuffers(1, 1, renderable->GetNormalBuffer().GetAddressOf(), &norStride, &norOffset);
+		// The meshes of the renderables and of the models that are not animated are culled against the frustum of the camera
+		XMFLOAT4X4 viewProjection;
+		XMStoreFloat4x4(&viewProjection, m_camera.GetView() * m_projection);
+		m_frustumCuller.SetViewProjection(&viewProjection._11);
+		m_frustumCuller.Clear();
 
-			// Set the index buffer
-			m_immediateContext->IASetIndexBuffer(renderable->GetIndexBuffer().Get(), DXGI_FORMAT_R16_UINT, 0);
+		std::vector<BoundingBox> aBoundingBoxes;
+		auto addBoundingBoxes = [this, &aBoundingBoxes](_In_ const Renderable& renderable)
+		{
+			for (UINT i = 0u; i < renderable.GetNumMeshes(); ++i)
+			{
+				const auto& mesh = renderable.GetMesh(i);
+				if (mesh.bHasBoundingBox)
+				{
+					BoundingBox boundingBox;
+					mesh.boundingBox.Transform(boundingBox, renderable.GetWorldMatrix());
+					m_frustumCuller.AddBox(&boundingBox.Center.x, &boundingBox.Extents.x);
+					aBoundingBoxes.push_back(boundingBox);
+				}
+			}
+		};
 
-			// Set the input layout
-			m_immediateContext->IASetInputLayout(renderable->GetVertexLayout().Get());
+		for (const auto& iterr : mainScene->GetRenderables())
+		{
+			addBoundingBoxes(*iterr.second);
+		}
 
-			// Create and update renderable constant buffer
-			CBChangesEveryFrame cbRenderable = {
-				.World = XMMatrixTranspose(renderable->GetWorldMatrix()),
-				.OutputColor = renderable->GetOutputColor(),
-				.HasNormalMap = renderable->HasNormalMap()
-			};
+		for (const auto& iterr : mainScene->GetModels())
+		{
+			if (!iterr.second->HasAnimations())
+			{
+				addBoundingBoxes(*iterr.second);
+			}
+		}
 
-			m_immediateContext->UpdateSubresource( renderable->GetConstantBuffer().Get(), 0, nullptr, &cbRenderable, 0, 0);
+		m_frustumCuller.Cull();
 
-			// Set shaders
-			m_immediateContext->VSSetShader(renderable->GetVertexShader().Get(), nullptr, 0);
-			m_immediateContext->PSSetShader(renderable->GetPixelShader().Get(), nullptr, 0);
+		const auto& voxels = mainScene->GetVoxels();
+		const auto& voxelChunks = mainScene->GetVoxelChunks();
 
-			// Set renderable constant buffer
-			m_immediateContext->VSSetConstantBuffers(2, 1, renderable->GetConstantBuffer().GetAddressOf());
-			m_immediateContext->PSSetConstantBuffers(2, 1, renderable->GetConstantBuffer().GetAddressOf());
+		// The chunks of the voxel map are culled against the frustum as a whole
+		m_voxelChunkCuller.SetViewProjection(&viewProjection._11);
+		m_voxelChunkCuller.Clear();
+		for (const auto& chunk : voxelChunks)
+		{
+			m_voxelChunkCuller.AddBox(&chunk->GetBoundingBox().Center.x, &chunk->GetBoundingBox().Extents.x);
+		}
+		m_voxelChunkCuller.Cull();
 
-			const UINT numOfMesh = renderable->GetNumMeshes();
-			for (UINT i = 0; i < numOfMesh; i++)
+		// The greedy meshes of the chunks in the frustum are the occluders, the meshes and chunks hidden behind them are not drawn
+		m_occlusionCuller.SetViewProjection(&viewProjection._11);
+		m_occlusionCuller.Clear();
+		if (mainScene->GetVoxelRenderMode() == eVoxelRenderMode::GREEDY_MESH && !voxels.empty())
+		{
+			XMFLOAT4X4 voxelWorld;
+			XMStoreFloat4x4(&voxelWorld, voxels[0]->GetWorldMatrix());
+			for (UINT i = 0u; i < static_cast<UINT>(voxelChunks.size()); ++i)
 			{
-				const auto& mesh = renderable->GetMesh(i);
-
-				if (renderable->HasTexture())
+				const std::vector<SimpleVertex>& aVertices = voxelChunks[i]->GetMeshVertices();
+				const std::vector<WORD>& aIndices = voxelChunks[i]->GetMeshIndices();
+				if (m_voxelChunkCuller.IsVisible(i) && !aIndices.empty())
 				{
-					const auto& material = renderable->GetMaterial(mesh.uMaterialIndex);
-
-					const auto& diffuseView = material->pDiffuse->GetTextureResourceView();
-					const auto& diffuseSampler = Texture::s_samplers[static_cast<size_t>(material->pDiffuse->GetSamplerType())];
-
-					m_immediateContext->PSSetShaderResources(0, 1, diffuseView.GetAddressOf());
-					m_immediateContext->PSSetSamplers(0, 1, diffuseSampler.GetAddressOf());
-
-					if (renderable->HasNormalMap())
-					{
-						const auto& normalView = material->pNormal->GetTextureResourceView();
-						const auto& normalSampler = Texture::s_samplers[static_cast<size_t>(material->pNormal->GetSamplerType())];
-
-						m_immediateContext->PSSetShaderResources(1, 1, normalView.GetAddressOf());
-						m_immediateContext->PSSetSamplers(1, 1, normalSampler.GetAddressOf());
-					}
+					m_occlusionCuller.AddOccluder(&voxelWorld._11, &aVertices[0].Position.x, static_cast<UINT>(sizeof(SimpleVertex)), static_cast<UINT>(aVertices.size()), aIndices.data(), static_cast<UINT>(aIndices.size()));
 				}
+			}
+		}
+		m_occlusionCuller.Rasterize();
 
-				m_immediateContext->DrawIndexed(mesh.uNumIndices, mesh.uBaseIndex, static_cast<INT>(mesh.uBaseVertex));
+		m_uNumOccludedMeshes = 0u;
+		m_aVisibleVoxelChunks.resize(voxelChunks.size());
+		for (UINT i = 0u; i < static_cast<UINT>(voxelChunks.size()); ++i)
+		{
+			const BoundingBox& boundingBox = voxelChunks[i]->GetBoundingBox();
+			m_aVisibleVoxelChunks[i] = m_voxelChunkCuller.IsVisible(i) && m_occlusionCuller.IsBoxVisible(&boundingBox.Center.x, &boundingBox.Extents.x);
+			if (m_voxelChunkCuller.IsVisible(i) && !m_aVisibleVoxelChunks[i])
+			{
+				++m_uNumOccludedMeshes;
 			}
 		}
 
-		for (auto& vox : mainScene->GetVoxels())
+		// Queue every mesh of an object with its material, the culled meshes take their boxes in the order they were added
+		UINT uBoxIndex = 0u;
+		auto pushMeshes = [this, &setMaterial, &uBoxIndex, &aBoundingBoxes](_In_ eRenderPass pass, _In_ FLOAT depth, _In_ Renderable& renderable, _In_ const DrawCommand& common, _In_ BOOL bCull)
 		{
+			const UINT numOfMesh = renderable.GetNumMeshes();
+			for (UINT i = 0; i < numOfMesh; i++)
+			{
+				const auto& mesh = renderable.GetMesh(i);
+				if (bCull && mesh.bHasBoundingBox)
+				{
+					const BoundingBox& boundingBox = aBoundingBoxes[uBoxIndex];
+					if (!m_frustumCuller.IsVisible(uBoxIndex++))
+					{
+						continue;
+					}
 
-			UINT vtxStride = sizeof(SimpleVertex);
-			UINT vtxOffset = 0;
+					if (!m_occlusionCuller.IsBoxVisible(&boundingBox.Center.x, &boundingBox.Extents.x))
+					{
+						++m_uNumOccludedMeshes;
+						continue;
+					}
+				}
 
-			UINT norStride = sizeof(NormalData);
-			UINT norOffset = 0;
+				DrawCommand command = common;
+				if (renderable.HasTexture())
+				{
+					setMaterial(command, renderable.GetMaterial(mesh.uMaterialIndex), renderable.HasNormalMap());
+				}
+				command.uNumIndices = mesh.uNumIndices;
+				command.uStartIndex = mesh.uBaseIndex;
+				command.iBaseVertex = static_cast<INT>(mesh.uBaseVertex);
 
-			UINT insStride = sizeof(InstanceData);
-			UINT insOffset = 0;
+				m_renderQueue.Push(pass, depth, command);
+			}
+		};
 
-			m_immediateContext->IASetVertexBuffers(0, 1, vox->GetVertexBuffer().GetAddressOf(), &vtxStride, &vtxOffset);
+		// For each renderables
+		for (const auto& iterr : mainScene->GetRenderables())
+		{
+			const auto& renderable = iterr.second;
 
-			m_immediateContext->IASetVertexBuffers(1, 1,vox->GetNormalBuffer().GetAddressOf(), &norStride, &norOffset);
+			// Create and update renderable constant buffer
+			CBChangesEveryFrame cbRenderable = {
+				.World = XMMatrixTranspose(renderable->GetWorldMatrix()),
+				.OutputColor = renderable->GetOutputColor(),
+				.HasNormalMap = renderable->HasNormalMap()
+			};
 
-			m_immediateContext->IASetVertexBuffers(2, 1, vox->GetInstanceBuffer().GetAddressOf(),&insStride, &insOffset);
+			m_immediateContext->UpdateSubresource( renderable->GetConstantBuffer().Get(), 0, nullptr, &cbRenderable, 0, 0);
 
-			// Set the index buffer
-			m_immediateContext->IASetIndexBuffer(vox->GetIndexBuffer().Get(), DXGI_FORMAT_R16_UINT, 0);
+			pushMeshes(eRenderPass::GEOMETRY, getDepth(renderable->GetWorldMatrix().r[3]), *renderable, getCommand(*renderable), TRUE);
+		}
 
-			// Set the input layout
-			m_immediateContext->IASetInputLayout(vox->GetVertexLayout().Get());
+		// The cubes of the voxels in the frustum are compacted into the dynamic instance buffer, the whole instance buffers are drawn if it fails
+		const BOOL bCullVoxelInstances = SUCCEEDED(cullVoxelInstances(*mainScene, m_camera.GetView() * m_projection));
 
+		// The cube, constant buffer, shaders and material of a voxel, the instances index the colors of their block type
+		auto getVoxelCommand = [this, &mainScene, &getCommand, &setMaterial](_In_ const std::shared_ptr<Voxel>& vox)
+		{
 			// Create and update voxel constant buffer
 			CBChangesEveryFrame cbVoxel = {
 				.World = XMMatrixTranspose(vox->GetWorldMatrix()),
@@ -850,68 +1016,136 @@ namespace library
 
 			m_immediateContext->UpdateSubresource(vox->GetConstantBuffer().Get(), 0, nullptr, &cbVoxel, 0, 0);
 
-			// Set shaders
-			m_immediateContext->VSSetShader(vox->GetVertexShader().Get(), nullptr, 0);
-			m_immediateContext->PSSetShader(vox->GetPixelShader().Get(), nullptr, 0);
+			DrawCommand command = getCommand(*vox);
+			command.auStrides[2] = sizeof(InstanceData);
+			command.apVSConstantBuffers[0] = mainScene->GetVoxelPaletteConstantBuffer().Get();
+			command.uNumIndices = vox->GetNumIndices();
 
-			// Set constant buffer
-			m_immediateContext->VSSetConstantBuffers(2, 1, vox->GetConstantBuffer().GetAddressOf());
-			m_immediateContext->PSSetConstantBuffers(2, 1, vox->GetConstantBuffer().GetAddressOf());
+			// A voxel is a single cube mesh
+			if (vox->HasTexture())
+			{
+				setMaterial(command, vox->GetMaterial(vox->GetMesh(0).uMaterialIndex), vox->HasNormalMap());
+			}
+			return command;
+		};
 
+		// Every voxel shares the cube, the world matrix and the material, so the cubes of the whole map are a single draw
+		if (mainScene->GetVoxelRenderMode() == eVoxelRenderMode::INSTANCED && !voxels.empty() && mainScene->GetNumVoxelInstances() > 0u)
+		{
+			DrawCommand command = getVoxelCommand(voxels[0]);
+			if (bCullVoxelInstances)
+			{
+				command.apVertexBuffers[2] = m_visibleVoxelInstanceBuffer.Get();
+				command.uStartInstance = m_visibleMapInstances.uFirstSlot;
+				command.uNumInstances = m_visibleMapInstances.uNumSlots;
+			}
+			else
+			{
+				command.apVertexBuffers[2] = mainScene->GetVoxelInstanceBuffer().Get();
+				command.uNumInstances = mainScene->GetNumVoxelInstances();
+			}
 
-			const UINT numOfMesh = vox->GetNumMeshes();
-			for (UINT i = 0; i < numOfMesh; i++)
+			if (command.uNumInstances > 0u)
 			{
-				const auto& mesh = vox->GetMesh(i);
+				m_renderQueue.Push(eRenderPass::GEOMETRY, 0.0f, command);
+			}
+		}
 
-				if (vox->HasTexture())
-				{
-					const auto& material = vox->GetMaterial(mesh.uMaterialIndex);
+		const BOOL bDrawVoxelMeshes = mainScene->GetVoxelRenderMode() == eVoxelRenderMode::GREEDY_MESH && mainScene->GetVoxelMeshVertexShader();
+		for (size_t uVoxelIdx = 0u; uVoxelIdx < voxels.size(); ++uVoxelIdx)
+		{
+			const auto& vox = voxels[uVoxelIdx];
+			if (vox->GetNumInstances() == 0u && !bDrawVoxelMeshes)
+			{
+				continue;
+			}
 
-					const auto& diffuseView = material->pDiffuse->GetTextureResourceView();
-					const auto& diffuseSampler = Texture::s_samplers[static_cast<size_t>(material->pDiffuse->GetSamplerType())];
+			const DrawCommand voxelCommand = getVoxelCommand(vox);
 
-					m_immediateContext->PSSetShaderResources(0, 1, diffuseView.GetAddressOf());
-					m_immediateContext->PSSetSamplers(0, 1, diffuseSampler.GetAddressOf());
+			if (vox->GetNumInstances() > 0u)
+			{
+				DrawCommand command = voxelCommand;
+				if (bCullVoxelInstances)
+				{
+					command.apVertexBuffers[2] = m_visibleVoxelInstanceBuffer.Get();
+					command.uStartInstance = m_aVisibleVoxelInstances[uVoxelIdx].uFirstSlot;
+					command.uNumInstances = m_aVisibleVoxelInstances[uVoxelIdx].uNumSlots;
+				}
+				else
+				{
+					command.apVertexBuffers[2] = vox->GetInstanceBuffer().Get();
+					command.uNumInstances = vox->GetNumInstances();
+				}
 
-					if (vox->HasNormalMap())
-					{
-						const auto& normalView = material->pNormal->GetTextureResourceView();
-						const auto& normalSampler = Texture::s_samplers[static_cast<size_t>(material->pNormal->GetSamplerType())];
+				if (command.uNumInstances > 0u)
+				{
+					m_renderQueue.Push(eRenderPass::GEOMETRY, 0.0f, command);
+				}
+			}
 
-						m_immediateContext->PSSetShaderResources(1, 1, normalView.GetAddressOf());
-						m_immediateContext->PSSetSamplers(1, 1, normalSampler.GetAddressOf());
+			// Draw the faces of the voxel in the static mesh of each chunk with the material of the voxel
+			if (bDrawVoxelMeshes)
+			{
+				for (size_t uChunkIdx = 0u; uChunkIdx < voxelChunks.size(); ++uChunkIdx)
+				{
+					const auto& chunk = voxelChunks[uChunkIdx];
+					const VoxelMeshRange range = chunk->GetMeshRange(uVoxelIdx);
+					if (range.uNumIndices == 0u || !m_aVisibleVoxelChunks[uChunkIdx])
+					{
+						continue;
 					}
-				}
 
-				m_immediateContext->DrawIndexedInstanced(mesh.uNumIndices,vox->GetNumInstances(),mesh.uBaseIndex,static_cast<INT>(mesh.uBaseVertex),0);
+					DrawCommand command = voxelCommand;
+					command.pInputLayout = mainScene->GetVoxelMeshVertexShader()->GetVertexLayout().Get();
+					command.pVertexShader = mainScene->GetVoxelMeshVertexShader()->GetVertexShader().Get();
+					command.apVertexBuffers[0] = chunk->GetMeshVertexBuffer().Get();
+					command.pIndexBuffer = chunk->GetMeshIndexBuffer().Get();
+					command.uNumIndices = range.uNumIndices;
+					command.uStartIndex = range.uStartIndex;
+
+					m_renderQueue.Push(eRenderPass::GEOMETRY, getDepth(XMLoadFloat3(&chunk->GetBoundingBox().Center)), command);
+				}
 			}
 		}
 
-		for (auto& iterr : mainScene->GetModels())
+		// The grid of the terrain is drawn at every selected patch, one draw for the whole patches and one for the quarters
+		const std::shared_ptr<HeightfieldTerrain>& terrain = mainScene->GetTerrain();
+		if (terrain)
 		{
-			auto& model = iterr.second;
-
-			UINT stride0 = sizeof(SimpleVertex);
-			UINT offset0 = 0;
-
-			UINT stride1 = sizeof(NormalData);
-			UINT offset1 = 0;
-
-			UINT stride2 = sizeof(AnimationData);
-			UINT offset2 = 0;
-
-			m_immediateContext->IASetVertexBuffers( 0, 1, model->GetVertexBuffer().GetAddressOf(), &stride0, &offset0);
+			CBChangesEveryFrame cbTerrain = {
+				.World = XMMatrixTranspose(terrain->GetWorldMatrix()),
+				.OutputColor = terrain->GetOutputColor(),
+				.HasNormalMap = FALSE
+			};
+			m_immediateContext->UpdateSubresource(terrain->GetConstantBuffer().Get(), 0, nullptr, &cbTerrain, 0, 0);
 
-			m_immediateContext->IASetVertexBuffers( 1, 1, model->GetNormalBuffer().GetAddressOf(), &stride1, &offset1);
+			DrawCommand command = getCommand(*terrain);
+			command.apVertexBuffers[1] = terrain->GetPatchBuffer().Get();
+			command.auStrides[1] = sizeof(TerrainPatchData);
+			command.apVSConstantBuffers[0] = mainScene->GetVoxelPaletteConstantBuffer().Get();
+			command.apVSConstantBuffers[1] = terrain->GetTerrainConstantBuffer().Get();
+			command.pVSShaderResourceView = terrain->GetHeightTextureView().Get();
 
-			m_immediateContext->IASetVertexBuffers( 2, 1, model->GetAnimationBuffer().GetAddressOf(), &stride2, &offset2);
+			UINT uStartPatch = 0u;
+			for (UINT uMeshIdx = 0u; uMeshIdx < terrain->GetNumMeshes(); ++uMeshIdx)
+			{
+				const UINT uNumPatches = terrain->GetNumPatches(uMeshIdx);
+				if (uNumPatches > 0u)
+				{
+					command.uNumIndices = terrain->GetMesh(uMeshIdx).uNumIndices;
+					command.uStartIndex = terrain->GetMesh(uMeshIdx).uBaseIndex;
+					command.uNumInstances = uNumPatches;
+					command.uStartInstance = uStartPatch;
 
-			//index buffer
-			m_immediateContext->IASetIndexBuffer(model->GetIndexBuffer().Get(), DXGI_FORMAT_R16_UINT, 0);
+					m_renderQueue.Push(eRenderPass::GEOMETRY, 0.0f, command);
+				}
+				uStartPatch += uNumPatches;
+			}
+		}
 
-			// input layout
-			m_immediateContext->IASetInputLayout(model->GetVertexLayout().Get());
+		for (auto& iterr : mainScene->GetModels())
+		{
+			auto& model = iterr.second;
 
 			// Create and update renderable constant buffer
 			CBChangesEveryFrame cbRenderable = {
@@ -933,55 +1167,18 @@ namespace library
 			m_immediateContext->UpdateSubresource(
 				model->GetSkinningConstantBuffer().Get(), 0, nullptr, &cbSkinning, 0, 0);
 
-			// Set shaders
-			m_immediateContext->VSSetShader(model->GetVertexShader().Get(), nullptr, 0);
-			m_immediateContext->PSSetShader(model->GetPixelShader().Get(), nullptr, 0);
-
-			// Set renderable constant buffer
-			m_immediateContext->VSSetConstantBuffers(2, 1, model->GetConstantBuffer().GetAddressOf());
-			m_immediateContext->VSSetConstantBuffers(4, 1, model->GetSkinningConstantBuffer().GetAddressOf());
-			m_immediateContext->PSSetConstantBuffers(2, 1, model->GetConstantBuffer().GetAddressOf());
-
-
-			const UINT numOfMesh = model->GetNumMeshes();
-			for (UINT i = 0; i < numOfMesh; i++)
-			{
-				const auto& mesh = model->GetMesh(i);
-
-				if (model->HasTexture())
-				{
-					const auto& material = model->GetMaterial(mesh.uMaterialIndex);
-
-					const auto& diffuseView = material->pDiffuse->GetTextureResourceView();
-					const auto& diffuseSampler = Texture::s_samplers[static_cast<size_t>(material->pDiffuse->GetSamplerType())];
-
-					m_immediateContext->PSSetShaderResources(0, 1, diffuseView.GetAddressOf());
-					m_immediateContext->PSSetSamplers(0, 1, diffuseSampler.GetAddressOf());
+			DrawCommand command = getCommand(*model);
+			command.apVertexBuffers[2] = model->GetAnimationBuffer().Get();
+			command.auStrides[2] = sizeof(AnimationData);
+			command.apVSConstantBuffers[0] = model->GetSkinningConstantBuffer().Get();
 
-					if (model->HasNormalMap())
-					{
-						const auto& normalView = material->pNormal->GetTextureResourceView();
-						const auto& normalSampler = Texture::s_samplers[static_cast<size_t>(material->pNormal->GetSamplerType())];
-
-						m_immediateContext->PSSetShaderResources(1, 1, normalView.GetAddressOf());
-						m_immediateContext->PSSetSamplers(1, 1, normalSampler.GetAddressOf());
-					}
-				}
-
-				m_immediateContext->DrawIndexed(mesh.uNumIndices, mesh.uBaseIndex, static_cast<INT>(mesh.uBaseVertex));
-			}
+			// Skinned meshes move out of their bounds in the bind pose
+			pushMeshes(eRenderPass::GEOMETRY, getDepth(model->GetWorldMatrix().r[3]), *model, command, !model->HasAnimations());
 		}
 
 		const auto& skyBox = mainScene->GetSkyBox();
 		if (skyBox)
 		{
-			UINT stride = sizeof(SimpleVertex);
-			UINT offset = 0;
-
-			m_immediateContext->IASetVertexBuffers(0, 1, skyBox->GetVertexBuffer().GetAddressOf(), &stride, &offset);
-			m_immediateContext->IASetIndexBuffer(skyBox->GetIndexBuffer().Get(), DXGI_FORMAT_R16_UINT, 0);
-			m_immediateContext->IASetInputLayout(skyBox->GetVertexLayout().Get());
-
 			// Create and update renderable constant buffer
 			XMMATRIX world = skyBox->GetWorldMatrix();
 			world = world * XMMatrixTranslationFromVector(m_camera.GetEye());
@@ -993,49 +1190,15 @@ namespace library
 
 			m_immediateContext->UpdateSubresource(skyBox->GetConstantBuffer().Get(), 0, nullptr, &cbRenderable, 0, 0);
 
-			// Set shaders
-			m_immediateContext->VSSetShader(skyBox->GetVertexShader().Get(), nullptr, 0);
-			m_immediateContext->PSSetShader(skyBox->GetPixelShader().Get(), nullptr, 0);
-
-			// Set renderable constant buffer
-			m_immediateContext->VSSetConstantBuffers(2, 1, skyBox->GetConstantBuffer().GetAddressOf());
-			m_immediateContext->PSSetConstantBuffers(2, 1, skyBox->GetConstantBuffer().GetAddressOf());
-
-			const UINT numOfMesh = skyBox->GetNumMeshes();
-			for (UINT i = 0; i < numOfMesh; i++)
-			{
-				const auto& mesh = skyBox->GetMesh(i);
-
-				if (skyBox->HasTexture())
-				{
-					const auto& material = skyBox->GetMaterial(mesh.uMaterialIndex);
-
-					const auto& diffuseView = material->pDiffuse->GetTextureResourceView();
-					const auto& diffuseSampler = Texture::s_samplers[static_cast<size_t>(material->pDiffuse->GetSamplerType())];
-
-					m_immediateContext->PSSetShaderResources(0, 1, diffuseView.GetAddressOf());
-					m_immediateContext->PSSetSamplers(0, 1, diffuseSampler.GetAddressOf());
-				}
-
-				m_immediateContext->DrawIndexed(mesh.uNumIndices, mesh.uBaseIndex, static_cast<INT>(mesh.uBaseVertex));
-			}
+			// The sky only reads the diffuse texture of its material
+			DrawCommand command = getCommand(*skyBox);
+			command.apVertexBuffers[1] = nullptr;
+			pushMeshes(eRenderPass::SKYBOX, 0.0f, *skyBox, command, FALSE);
 		}
 
-		// Set Render Target View again (Present call for DXGI_SWAP_EFFECT_FLIP_SEQUENTIAL unbinds backbuffer 0)
-		m_immediateContext->OMSetRenderTargets(1, m_renderTargetView.GetAddressOf(), m_depthStencilView.Get());
-
-		// Unbind shadow texture so fake render can write to it
-		ID3D11ShaderResourceView* nullSRV[1] = { nullptr };
-		m_immediateContext->PSSetShaderResources(2, 1, nullSRV);
-
-		// Unbind vertex slots so RenderSceneToTexture doesn't complain
-		ID3D11Buffer* nullVB[3] = { nullptr, nullptr, nullptr };
-		UINT zero = 0;
-		m_immediateContext->IASetVertexBuffers( 0, 3, nullVB, &zero, &zero);
-
-		// present the information rendered to the back buffer to the front buffer
-	
-		m_swapChain->Present(0, 0);
+		m_renderQueue.Sort();
+		m_renderQueue.Submit(m_renderContext.get());
+		m_uNumDrawCalls += m_renderQueue.GetNumCommands();
 	}
 
 	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
@@ -1248,10 +1411,126 @@ namespace library
 		return m_driverType;
 	}
 
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::GetNumDrawCalls
+
+	  Summary:  Returns the number of draw calls of the last frame,
+				shadow map pass included
+
+	  Returns:  UINT
+				  Number of draw calls
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT Renderer::GetNumDrawCalls() const
+	{
+		return m_uNumDrawCalls;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::GetNumStateChanges
+
+	  Summary:  Returns the number of binds of the last frame that
+				reached the immediate context, shadow map pass
+				included
+
+	  Returns:  UINT
+				  Number of issued binds
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT Renderer::GetNumStateChanges() const
+	{
+		return m_renderContext->GetNumIssuedCalls();
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::GetNumSkippedStateChanges
+
+	  Summary:  Returns the number of binds of the last frame the state
+				filter dropped, since what they bind was bound
+
+	  Returns:  UINT
+				  Number of skipped binds
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT Renderer::GetNumSkippedStateChanges() const
+	{
+		return m_renderContext->GetNumSkippedCalls();
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::GetNumVisibleMeshes
+
+	  Summary:  Returns the number of meshes of the last frame that were
+				tested against the frustum and found in it
+
+	  Returns:  UINT
+				  Number of meshes in the frustum
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT Renderer::GetNumVisibleMeshes() const
+	{
+		return m_frustumCuller.GetNumVisible();
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::GetNumCulledMeshes
+
+	  Summary:  Returns the number of meshes of the last frame that were
+				out of the frustum and not drawn
+
+	  Returns:  UINT
+				  Number of culled meshes
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT Renderer::GetNumCulledMeshes() const
+	{
+		return m_frustumCuller.GetNumCulled();
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::GetNumVisibleVoxelInstances
+
+	  Summary:  Returns the number of cubes of voxels of the last frame
+				that were in the frustum and drawn
+
+	  Returns:  UINT
+				  Number of cubes in the frustum
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT Renderer::GetNumVisibleVoxelInstances() const
+	{
+		return m_uNumVisibleVoxelInstances;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::GetNumOccludedMeshes
+
+	  Summary:  Returns the number of meshes and chunks of the last
+				frame that were in the frustum but hidden behind the
+				occluders
+
+	  Returns:  UINT
+				  Number of occluded meshes and chunks
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT Renderer::GetNumOccludedMeshes() const
+	{
+		return m_uNumOccludedMeshes;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::GetFrameGraphStats
+
+	  Summary:  Returns the passes of the last frame the frame graph
+				ran and culled, and the memory of its transient
+				textures before and after they share textures
+
+	  Returns:  const FrameGraphStats&
+				  Statistics of the frame graph
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	const FrameGraphStats& Renderer::GetFrameGraphStats() const
+	{
+		return m_frameGraph.GetStats();
+	}
+
 	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
 	  Method:   Renderer::RenderSceneToTexture
 
-	  Summary:  Render scene to the texture
+	  Summary:  Render scene to the texture, the shadow map the frame
+				graph binds as the render target with the depth buffer
 	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
 	/*--------------------------------------------------------------------
 		TODO: Renderer::RenderSceneToTexture definition (remove the comment)
@@ -1259,17 +1538,8 @@ namespace library
 	
 	void Renderer::RenderSceneToTexture()
 	{
-		//Unbind current pixel shader resources
-		ID3D11ShaderResourceView* const pSRV[1] = { NULL };
-		m_immediateContext->PSSetShaderResources(0, 1, pSRV);
-		m_immediateContext->PSSetShaderResources(1, 1, pSRV);
-		m_immediateContext->PSSetShaderResources(2, 1, pSRV);
-
-		// Change render target to the shadow map texture
-		m_immediateContext->OMSetRenderTargets(1u, m_shadowMapTexture->GetRenderTargetView().GetAddressOf(), m_depthStencilView.Get());
-
 		// Clear render target view with white color
-		m_immediateContext->ClearRenderTargetView(m_shadowMapTexture->GetRenderTargetView().Get(), Colors::White);
+		m_immediateContext->ClearRenderTargetView(m_frameGraph.GetViews(m_uShadowMap).pRenderTargetView, Colors::White);
 
 		// Clear depth stencil view
 		m_immediateContext->ClearDepthStencilView(m_depthStencilView.Get(), D3D11_CLEAR_DEPTH, 1.0f, 0u);
@@ -1281,13 +1551,13 @@ namespace library
 			// Bind vertex buffer
 			UINT uStride = sizeof(SimpleVertex);
 			UINT uOffset = 0u;
-			m_immediateContext->IASetVertexBuffers(0u, 1u, renderable->second->GetVertexBuffer().GetAddressOf(), &uStride, &uOffset);
+			m_renderContext->IASetVertexBuffers(0u, 1u, renderable->second->GetVertexBuffer().GetAddressOf(), &uStride, &uOffset);
 
 			// Bind index buffer
-			m_immediateContext->IASetIndexBuffer(renderable->second->GetIndexBuffer().Get(), DXGI_FORMAT_R16_UINT, 0u);
+			m_renderContext->IASetIndexBuffer(renderable->second->GetIndexBuffer().Get(), DXGI_FORMAT_R16_UINT, 0u);
 
 			// Bind input layout
-			m_immediateContext->IASetInputLayout(m_shadowVertexShader->GetVertexLayout().Get());
+			m_renderContext->IASetInputLayout(m_shadowVertexShader->GetVertexLayout().Get());
 
 			// Update shadow matrix constant buffer
 			CBShadowMatrix cbShadowMatrix =
@@ -1300,51 +1570,56 @@ namespace library
 			m_immediateContext->UpdateSubresource(m_cbShadowMatrix.Get(), 0u, nullptr, &cbShadowMatrix, 0u, 0u);
 
 			// Bind vertex shader and constant buffer
-			m_immediateContext->VSSetShader(m_shadowVertexShader->GetVertexShader().Get(), nullptr, 0u);
-			m_immediateContext->VSSetConstantBuffers(0u, 1u, m_cbShadowMatrix.GetAddressOf());
+			m_renderContext->VSSetShader(m_shadowVertexShader->GetVertexShader().Get());
+			m_renderContext->VSSetConstantBuffers(0u, 1u, m_cbShadowMatrix.GetAddressOf());
 
 			// Bind pixel shader
-			m_immediateContext->PSSetShader(m_shadowPixelShader->GetPixelShader().Get(), nullptr, 0u);
+			m_renderContext->PSSetShader(m_shadowPixelShader->GetPixelShader().Get());
 
 			// Render the triangles
 			if (renderable->second->HasTexture())
 			{
 				for (UINT i = 0; i < renderable->second->GetNumMeshes(); ++i)
 				{
-					m_immediateContext->DrawIndexed(renderable->second->GetMesh(i).uNumIndices,
+					m_renderContext->DrawIndexed(renderable->second->GetMesh(i).uNumIndices,
 						renderable->second->GetMesh(i).uBaseIndex,
 						renderable->second->GetMesh(i).uBaseVertex);
+					++m_uNumDrawCalls;
 				}
 			}
 			else
 			{
-				m_immediateContext->DrawIndexed(renderable->second->GetNumIndices(), 0u, 0);
+				m_renderContext->DrawIndexed(renderable->second->GetNumIndices(), 0u, 0);
+				++m_uNumDrawCalls;
 			}
 		}
 
 		// For all voxels in main scene
-		std::vector<std::shared_ptr<Voxel>>::iterator voxel;
-		for (voxel = m_scenes[m_pszMainSceneName]->GetVoxels().begin(); voxel != m_scenes[m_pszMainSceneName]->GetVoxels().end(); ++voxel)
+		const std::vector<std::shared_ptr<Voxel>>& voxels = m_scenes[m_pszMainSceneName]->GetVoxels();
+		const std::vector<std::shared_ptr<VoxelChunk>>& voxelChunks = m_scenes[m_pszMainSceneName]->GetVoxelChunks();
+
+		// Render the instances in a buffer with the cube of a voxel
+		auto drawInstances = [this](_In_ const std::shared_ptr<Voxel>& voxel, _In_ const ComPtr<ID3D11Buffer>& instanceBuffer, _In_ UINT uNumInstances)
 		{
 			// Bind vertex buffer
 			UINT uStride = sizeof(SimpleVertex);
 			UINT uOffset = 0u;
-			m_immediateContext->IASetVertexBuffers(0u, 1u, voxel->get()->GetVertexBuffer().GetAddressOf(), &uStride, &uOffset);
+			m_renderContext->IASetVertexBuffers(0u, 1u, voxel->GetVertexBuffer().GetAddressOf(), &uStride, &uOffset);
 
 			// Bind instance buffer
-			uStride = sizeof(InstanceData);
-			m_immediateContext->IASetVertexBuffers(2u, 1u, voxel->get()->GetInstanceBuffer().GetAddressOf(), &uStride, &uOffset);
+			UINT uInstanceStride = sizeof(InstanceData);
+			m_renderContext->IASetVertexBuffers(2u, 1u, instanceBuffer.GetAddressOf(), &uInstanceStride, &uOffset);
 
 			// Bind index buffer
-			m_immediateContext->IASetIndexBuffer(voxel->get()->GetIndexBuffer().Get(), DXGI_FORMAT_R16_UINT, 0u);
+			m_renderContext->IASetIndexBuffer(voxel->GetIndexBuffer().Get(), DXGI_FORMAT_R16_UINT, 0u);
 
 			// Bind input layout
-			m_immediateContext->IASetInputLayout(m_shadowVertexShader->GetVertexLayout().Get());
+			m_renderContext->IASetInputLayout(m_shadowVertexShader->GetVertexLayout().Get());
 
 			// Update shadow matrix constant buffer
 			CBShadowMatrix cbShadowMatrix =
 			{
-				.World = XMMatrixTranspose(voxel->get()->GetWorldMatrix()),
+				.World = XMMatrixTranspose(voxel->GetWorldMatrix()),
 				.View = XMMatrixTranspose(m_scenes[m_pszMainSceneName]->GetPointLight(0ull)->GetViewMatrix()),
 				.Projection = XMMatrixTranspose(m_scenes[m_pszMainSceneName]->GetPointLight(0ull)->GetProjectionMatrix()),
 				.IsVoxel = TRUE
@@ -1352,27 +1627,61 @@ namespace library
 			m_immediateContext->UpdateSubresource(m_cbShadowMatrix.Get(), 0u, nullptr, &cbShadowMatrix, 0u, 0u);
 
 			// Bind vertex shader and constant buffer
-			m_immediateContext->VSSetShader(m_shadowVertexShader->GetVertexShader().Get(), nullptr, 0u);
-			m_immediateContext->VSSetConstantBuffers(0u, 1u, m_cbShadowMatrix.GetAddressOf());
+			m_renderContext->VSSetShader(m_shadowVertexShader->GetVertexShader().Get());
+			m_renderContext->VSSetConstantBuffers(0u, 1u, m_cbShadowMatrix.GetAddressOf());
 
 			// Bind pixel shader
-			m_immediateContext->PSSetShader(m_shadowPixelShader->GetPixelShader().Get(), nullptr, 0u);
+			m_renderContext->PSSetShader(m_shadowPixelShader->GetPixelShader().Get());
 
-			// Render the triangles
-			if (voxel->get()->HasTexture())
+			m_renderContext->DrawIndexedInstanced(voxel->GetNumIndices(), uNumInstances, 0u, 0, 0u);
+			++m_uNumDrawCalls;
+		};
+
+		// Every block type casts the same shadow, so the cubes of the whole map are a single draw
+		if (!voxels.empty() && m_scenes[m_pszMainSceneName]->GetNumVoxelInstances() > 0u)
+		{
+			drawInstances(voxels[0], m_scenes[m_pszMainSceneName]->GetVoxelInstanceBuffer(), m_scenes[m_pszMainSceneName]->GetNumVoxelInstances());
+		}
+
+		for (const std::shared_ptr<Voxel>& voxel : voxels)
+		{
+			if (voxel->GetNumInstances() > 0u)
 			{
-				for (UINT i = 0; i < voxel->get()->GetNumMeshes(); ++i)
-				{
-					m_immediateContext->DrawIndexedInstanced(voxel->get()->GetMesh(i).uNumIndices,
-						voxel->get()->GetNumInstances(),
-						voxel->get()->GetMesh(i).uBaseIndex,
-						voxel->get()->GetMesh(i).uBaseVertex,
-						0u);
-				}
+				drawInstances(voxel, voxel->GetInstanceBuffer(), voxel->GetNumInstances());
 			}
-			else
+		}
+
+		// The greedy meshes are relative to the corner of the map and every block type casts the same shadow
+		if (m_scenes[m_pszMainSceneName]->GetVoxelRenderMode() == eVoxelRenderMode::GREEDY_MESH)
+		{
+			const XMFLOAT3 origin = m_scenes[m_pszMainSceneName]->GetVoxelMapOrigin();
+			CBShadowMatrix cbShadowMatrix =
+			{
+				.World = XMMatrixTranspose(XMMatrixTranslation(origin.x, origin.y, origin.z)),
+				.View = XMMatrixTranspose(m_scenes[m_pszMainSceneName]->GetPointLight(0ull)->GetViewMatrix()),
+				.Projection = XMMatrixTranspose(m_scenes[m_pszMainSceneName]->GetPointLight(0ull)->GetProjectionMatrix()),
+				.IsVoxel = FALSE
+			};
+			m_immediateContext->UpdateSubresource(m_cbShadowMatrix.Get(), 0u, nullptr, &cbShadowMatrix, 0u, 0u);
+
+			m_renderContext->IASetInputLayout(m_shadowVertexShader->GetVertexLayout().Get());
+			m_renderContext->VSSetShader(m_shadowVertexShader->GetVertexShader().Get());
+			m_renderContext->VSSetConstantBuffers(0u, 1u, m_cbShadowMatrix.GetAddressOf());
+			m_renderContext->PSSetShader(m_shadowPixelShader->GetPixelShader().Get());
+
+			for (const std::shared_ptr<VoxelChunk>& chunk : voxelChunks)
 			{
-				m_immediateContext->DrawIndexedInstanced(voxel->get()->GetNumIndices(), voxel->get()->GetNumInstances(), 0u, 0, 0u);
+				if (chunk->GetNumMeshIndices() == 0u)
+				{
+					continue;
+				}
+
+				UINT uStride = sizeof(SimpleVertex);
+				UINT uOffset = 0u;
+				m_renderContext->IASetVertexBuffers(0u, 1u, chunk->GetMeshVertexBuffer().GetAddressOf(), &uStride, &uOffset);
+				m_renderContext->IASetIndexBuffer(chunk->GetMeshIndexBuffer().Get(), DXGI_FORMAT_R16_UINT, 0u);
+				m_renderContext->DrawIndexed(chunk->GetNumMeshIndices(), 0u, 0);
+				++m_uNumDrawCalls;
 			}
 		}
 
@@ -1383,13 +1692,13 @@ namespace library
 			// Bind vertex buffer
 			UINT uStride = sizeof(SimpleVertex);
 			UINT uOffset = 0u;
-			m_immediateContext->IASetVertexBuffers(0u, 1u, model->second->GetVertexBuffer().GetAddressOf(), &uStride, &uOffset);
+			m_renderContext->IASetVertexBuffers(0u, 1u, model->second->GetVertexBuffer().GetAddressOf(), &uStride, &uOffset);
 
 			// Bind index buffer
-			m_immediateContext->IASetIndexBuffer(model->second->GetIndexBuffer().Get(), DXGI_FORMAT_R16_UINT, 0u);
+			m_renderContext->IASetIndexBuffer(model->second->GetIndexBuffer().Get(), DXGI_FORMAT_R16_UINT, 0u);
 
 			// Bind input layout
-			m_immediateContext->IASetInputLayout(m_shadowVertexShader->GetVertexLayout().Get());
+			m_renderContext->IASetInputLayout(m_shadowVertexShader->GetVertexLayout().Get());
 
 			// Update shadow matrix constant buffer
 			CBShadowMatrix cbShadowMatrix =
@@ -1402,29 +1711,206 @@ namespace library
 			m_immediateContext->UpdateSubresource(m_cbShadowMatrix.Get(), 0u, nullptr, &cbShadowMatrix, 0u, 0u);
 
 			// Bind vertex shader and constant buffer
-			m_immediateContext->VSSetShader(m_shadowVertexShader->GetVertexShader().Get(), nullptr, 0u);
-			m_immediateContext->VSSetConstantBuffers(0u, 1u, m_cbShadowMatrix.GetAddressOf());
+			m_renderContext->VSSetShader(m_shadowVertexShader->GetVertexShader().Get());
+			m_renderContext->VSSetConstantBuffers(0u, 1u, m_cbShadowMatrix.GetAddressOf());
 
 			// Bind pixel shader
-			m_immediateContext->PSSetShader(m_shadowPixelShader->GetPixelShader().Get(), nullptr, 0u);
+			m_renderContext->PSSetShader(m_shadowPixelShader->GetPixelShader().Get());
 
 			// Render the triangles
 			if (model->second->HasTexture())
 			{
 				for (UINT i = 0; i < model->second->GetNumMeshes(); ++i)
 				{
-					m_immediateContext->DrawIndexed(model->second->GetMesh(i).uNumIndices,
+					m_renderContext->DrawIndexed(model->second->GetMesh(i).uNumIndices,
 						model->second->GetMesh(i).uBaseIndex,
 						model->second->GetMesh(i).uBaseVertex);
+					++m_uNumDrawCalls;
 				}
 			}
 			else
 			{
-				m_immediateContext->DrawIndexed(model->second->GetNumIndices(), 0u, 0);
+				m_renderContext->DrawIndexed(model->second->GetNumIndices(), 0u, 0);
+				++m_uNumDrawCalls;
+			}
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::cullVoxelInstances
+
+	  Summary:  Writes the cubes of the voxels of a scene in the frustum
+				to the dynamic instance buffer, the cubes of the map
+				first and then those of each voxel. The chunks of the
+				map out of the frustum or hidden behind the occluders
+				are dropped whole, and the cubes of the others are
+				tested on the threads of the instance culler. The
+				buffer grows to hold every cube to test and is
+				discarded every frame, so the GPU never waits for the
+				previous frame to be drawn
+
+	  Args:     Scene& scene
+				  Scene whose voxels are drawn
+				FXMMATRIX viewProjection
+				  View projection matrix of the camera
+
+	  Modifies: [m_voxelInstanceCuller, m_aVoxelInstanceSpans,
+				 m_visibleVoxelInstanceBuffer,
+				 m_uMaxNumVisibleVoxelInstances,
+				 m_uNumVisibleVoxelInstances, m_visibleMapInstances,
+				 m_aVisibleVoxelInstances].
+
+	  Returns:  HRESULT
+				  Status code
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT Renderer::cullVoxelInstances(_In_ Scene& scene, _In_ FXMMATRIX viewProjection)
+	{
+		const std::vector<std::shared_ptr<Voxel>>& voxels = scene.GetVoxels();
+		const std::vector<std::shared_ptr<VoxelChunk>>& voxelChunks = scene.GetVoxelChunks();
+
+		m_uNumVisibleVoxelInstances = 0u;
+		m_visibleMapInstances = VoxelSlotRange{ .uFirstSlot = 0u, .uNumSlots = 0u };
+		m_aVisibleVoxelInstances.assign(voxels.size(), VoxelSlotRange{ .uFirstSlot = 0u, .uNumSlots = 0u });
+
+		// Every cube of the visible chunks and of the voxels may be visible
+		m_aVoxelInstanceSpans.clear();
+		if (scene.GetVoxelRenderMode() == eVoxelRenderMode::INSTANCED && !voxels.empty())
+		{
+			for (size_t i = 0u; i < voxelChunks.size(); ++i)
+			{
+				const std::vector<InstanceData>& aInstanceData = voxelChunks[i]->GetInstanceData();
+				if (m_aVisibleVoxelChunks[i] && !aInstanceData.empty())
+				{
+					m_aVoxelInstanceSpans.push_back(InstanceSpan{ .pInstances = aInstanceData.data(), .uNumInstances = static_cast<UINT>(aInstanceData.size()) });
+				}
 			}
 		}
 
-		// Reset the render target to the original back buffer
-		m_immediateContext->OMSetRenderTargets(1u, m_renderTargetView.GetAddressOf(), m_depthStencilView.Get());
+		UINT uNumInstances = 0u;
+		for (const InstanceSpan& span : m_aVoxelInstanceSpans)
+		{
+			uNumInstances += span.uNumInstances;
+		}
+		for (const std::shared_ptr<Voxel>& voxel : voxels)
+		{
+			uNumInstances += voxel->GetNumInstances();
+		}
+
+		if (uNumInstances == 0u)
+		{
+			return S_OK;
+		}
+
+		if (uNumInstances > m_uMaxNumVisibleVoxelInstances)
+		{
+			const UINT uNumSlots = std::max(uNumInstances, m_uMaxNumVisibleVoxelInstances + m_uMaxNumVisibleVoxelInstances / 2u);
+
+			D3D11_BUFFER_DESC instBuffDesc =
+			{
+				.ByteWidth = static_cast<UINT>(sizeof(InstanceData)) * uNumSlots,
+				.Usage = D3D11_USAGE_DYNAMIC,
+				.BindFlags = D3D11_BIND_VERTEX_BUFFER,
+				.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE,
+				.MiscFlags = 0,
+				.StructureByteStride = 0
+			};
+
+			HRESULT hr = m_d3dDevice->CreateBuffer(&instBuffDesc, nullptr, m_visibleVoxelInstanceBuffer.ReleaseAndGetAddressOf());
+			if (FAILED(hr))
+			{
+				m_uMaxNumVisibleVoxelInstances = 0u;
+				return hr;
+			}
+
+			m_uMaxNumVisibleVoxelInstances = uNumSlots;
+		}
+
+		D3D11_MAPPED_SUBRESOURCE mappedInstances;
+		HRESULT hr = m_immediateContext->Map(m_visibleVoxelInstanceBuffer.Get(), 0u, D3D11_MAP_WRITE_DISCARD, 0u, &mappedInstances);
+		if (FAILED(hr))
+		{
+			return hr;
+		}
+
+		InstanceData* pVisible = static_cast<InstanceData*>(mappedInstances.pData);
+		XMFLOAT4X4 worldViewProjection;
+
+		// The cubes of the map are placed with the world matrix of the first voxel
+		if (!m_aVoxelInstanceSpans.empty())
+		{
+			XMStoreFloat4x4(&worldViewProjection, voxels[0]->GetWorldMatrix() * viewProjection);
+			m_visibleMapInstances.uNumSlots = m_voxelInstanceCuller.Cull(&worldViewProjection._11, m_aVoxelInstanceSpans.data(), static_cast<UINT>(m_aVoxelInstanceSpans.size()), pVisible);
+			m_uNumVisibleVoxelInstances = m_visibleMapInstances.uNumSlots;
+		}
+
+		for (size_t uVoxelIdx = 0u; uVoxelIdx < voxels.size(); ++uVoxelIdx)
+		{
+			const std::vector<InstanceData>& aInstanceData = voxels[uVoxelIdx]->GetInstanceData();
+			if (aInstanceData.empty())
+			{
+				continue;
+			}
+
+			const InstanceSpan span =
+			{
+				.pInstances = aInstanceData.data(),
+				.uNumInstances = static_cast<UINT>(aInstanceData.size())
+			};
+			XMStoreFloat4x4(&worldViewProjection, voxels[uVoxelIdx]->GetWorldMatrix() * viewProjection);
+
+			m_aVisibleVoxelInstances[uVoxelIdx].uFirstSlot = m_uNumVisibleVoxelInstances;
+			m_aVisibleVoxelInstances[uVoxelIdx].uNumSlots = m_voxelInstanceCuller.Cull(&worldViewProjection._11, &span, 1u, pVisible + m_uNumVisibleVoxelInstances);
+			m_uNumVisibleVoxelInstances += m_aVisibleVoxelInstances[uVoxelIdx].uNumSlots;
+		}
+
+		m_immediateContext->Unmap(m_visibleVoxelInstanceBuffer.Get(), 0u);
+
+		return S_OK;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::createFrameGraphTextures
+
+	  Summary:  Creates the textures the transient textures of the
+				compiled frame graph share and gives their views to
+				the graph. A texture is kept from frame to frame while
+				the graph asks for the same description
+
+	  Modifies: [m_aFrameGraphTextures, m_frameGraph].
+
+	  Returns:  HRESULT
+				  Status code
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT Renderer::createFrameGraphTextures()
+	{
+		if (m_aFrameGraphTextures.size() < m_frameGraph.GetNumPhysicalTextures())
+		{
+			m_aFrameGraphTextures.resize(m_frameGraph.GetNumPhysicalTextures());
+		}
+
+		for (UINT i = 0u; i < m_frameGraph.GetNumPhysicalTextures(); ++i)
+		{
+			const FrameGraphTextureDesc& desc = m_frameGraph.GetPhysicalTextureDesc(i);
+			std::shared_ptr<RenderTexture>& texture = m_aFrameGraphTextures[i];
+			if (!texture || texture->GetWidth() != desc.uWidth || texture->GetHeight() != desc.uHeight || texture->GetFormat() != desc.format)
+			{
+				texture = std::make_shared<RenderTexture>(desc.uWidth, desc.uHeight, desc.format);
+
+				HRESULT hr = texture->Initialize(m_d3dDevice.Get(), m_immediateContext.Get());
+				if (FAILED(hr))
+				{
+					texture.reset();
+					return hr;
+				}
+			}
+
+			m_frameGraph.SetPhysicalTextureViews(i, FrameGraphViews{
+				.pRenderTargetView = texture->GetRenderTargetView().Get(),
+				.pDepthStencilView = nullptr,
+				.pShaderResourceView = texture->GetShaderResourceView().Get()
+			});
+		}
+
+		return S_OK;
 	}
 }
\ No newline at end of file
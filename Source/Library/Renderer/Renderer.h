@@ -16,8 +16,15 @@
 #include "Camera/Camera.h"
 #include "Light/PointLight.h"
 #include "Model/Model.h"
+#include "Renderer/D3D11RenderContext.h"
 #include "Renderer/DataTypes.h"
+#include "Renderer/FrameGraph.h"
+#include "Renderer/FrustumCuller.h"
+#include "Renderer/OcclusionCuller.h"
 #include "Renderer/Renderable.h"
+#include "Renderer/RenderQueue.h"
+#include "Renderer/StateFilteringContext.h"
+#include "Renderer/VoxelInstanceCuller.h"
 #include "Scene/Scene.h"
 #include "Shader/PixelShader.h"
 #include "Shader/VertexShader.h"
@@ -43,6 +50,36 @@ namespace library
                   Renders the frame
                 GetDriverType
                   Returns the Direct3D driver type
+                GetNumDrawCalls
+                  Returns the number of draw calls of the last frame
+                GetNumStateChanges
+                  Returns the number of binds of the last frame
+                GetNumSkippedStateChanges
+                  Returns the number of binds of the last frame that
+                  were dropped
+                GetNumVisibleMeshes
+                  Returns the number of meshes of the last frame in
+                  the frustum
+                GetNumCulledMeshes
+                  Returns the number of meshes of the last frame out
+                  of the frustum
+                GetNumVisibleVoxelInstances
+                  Returns the number of cubes of voxels of the last
+                  frame in the frustum
+                GetNumOccludedMeshes
+                  Returns the number of meshes and chunks of the last
+                  frame hidden behind the occluders
+                GetFrameGraphStats
+                  Returns the passes and transient textures of the
+                  frame graph of the last frame
+                renderMainPass
+                  Draws the scene to the back buffer
+                createFrameGraphTextures
+                  Creates the textures the transient textures of the
+                  frame graph share
+                cullVoxelInstances
+                  Compacts the cubes of voxels in the frustum into the
+                  dynamic instance buffer
                 Renderer
                   Constructor.
                 ~Renderer
@@ -71,6 +108,19 @@ namespace library
         void RenderSceneToTexture();
 
         D3D_DRIVER_TYPE GetDriverType() const;
+        UINT GetNumDrawCalls() const;
+        UINT GetNumStateChanges() const;
+        UINT GetNumSkippedStateChanges() const;
+        UINT GetNumVisibleMeshes() const;
+        UINT GetNumCulledMeshes() const;
+        UINT GetNumVisibleVoxelInstances() const;
+        UINT GetNumOccludedMeshes() const;
+        const FrameGraphStats& GetFrameGraphStats() const;
+
+    private:
+        void renderMainPass();
+        HRESULT createFrameGraphTextures();
+        HRESULT cullVoxelInstances(_In_ Scene& scene, _In_ FXMMATRIX viewProjection);
 
     private:
         D3D_DRIVER_TYPE m_driverType;
@@ -94,8 +144,26 @@ namespace library
 
         std::unordered_map<std::wstring, std::shared_ptr<Scene>> m_scenes;
         std::shared_ptr<Texture> m_invalidTexture;
-        std::shared_ptr<RenderTexture> m_shadowMapTexture;
         std::shared_ptr<ShadowVertexShader> m_shadowVertexShader;
         std::shared_ptr<PixelShader> m_shadowPixelShader;
+        UINT m_uNumDrawCalls;
+        RenderQueue m_renderQueue;
+        std::shared_ptr<StateFilteringContext> m_renderContext;
+        FrustumCuller m_frustumCuller;
+        FrustumCuller m_voxelChunkCuller;
+        VoxelInstanceCuller m_voxelInstanceCuller;
+        std::vector<InstanceSpan> m_aVoxelInstanceSpans;
+        ComPtr<ID3D11Buffer> m_visibleVoxelInstanceBuffer;
+        UINT m_uMaxNumVisibleVoxelInstances;
+        UINT m_uNumVisibleVoxelInstances;
+        VoxelSlotRange m_visibleMapInstances;
+        std::vector<VoxelSlotRange> m_aVisibleVoxelInstances;
+        OcclusionCuller m_occlusionCuller;
+        std::vector<BYTE> m_aVisibleVoxelChunks;
+        UINT m_uNumOccludedMeshes;
+        FrameGraph m_frameGraph;
+        FrameGraphTextureDesc m_shadowMapDesc;
+        UINT m_uShadowMap;
+        std::vector<std::shared_ptr<RenderTexture>> m_aFrameGraphTextures;
     };
 }
\ No newline at end of file
@@ -0,0 +1,571 @@
+#include "Renderer/StateFilteringContext.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StateFilteringContext::StateFilteringContext
+
+      Summary:  Constructor. Nothing is known about the state bound to
+                the context yet
+
+      Args:     const std::shared_ptr<RenderContext>& context
+                  Context the binds that change something go to
+
+      Modifies: [m_context, m_pInputLayout, m_apVertexBuffers,
+                 m_auStrides, m_auOffsets, m_pIndexBuffer,
+                 m_indexFormat, m_uIndexOffset, m_pVertexShader,
+                 m_pPixelShader, m_apVSConstantBuffers,
+                 m_apPSConstantBuffers, m_apVSShaderResourceViews,
+                 m_apPSShaderResourceViews, m_apPSSamplers,
+                 m_uNumRenderTargets, m_apRenderTargetViews,
+                 m_pDepthStencilView, m_bInputLayoutKnown,
+                 m_bIndexBufferKnown, m_bVertexShaderKnown,
+                 m_bPixelShaderKnown, m_bRenderTargetsKnown,
+                 m_uKnownVertexBuffers, m_uKnownVSConstantBuffers,
+                 m_uKnownPSConstantBuffers, m_uKnownVSShaderResourceViews,
+                 m_uKnownPSShaderResourceViews, m_uKnownPSSamplers,
+                 m_uNumIssuedCalls, m_uNumSkippedCalls].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    StateFilteringContext::StateFilteringContext(_In_ const std::shared_ptr<RenderContext>& context)
+        : m_context(context)
+        , m_pInputLayout(nullptr)
+        , m_apVertexBuffers()
+        , m_auStrides()
+        , m_auOffsets()
+        , m_pIndexBuffer(nullptr)
+        , m_indexFormat()
+        , m_uIndexOffset(0u)
+        , m_pVertexShader(nullptr)
+        , m_pPixelShader(nullptr)
+        , m_apVSConstantBuffers()
+        , m_apPSConstantBuffers()
+        , m_apVSShaderResourceViews()
+        , m_apPSShaderResourceViews()
+        , m_apPSSamplers()
+        , m_uNumRenderTargets(0u)
+        , m_apRenderTargetViews()
+        , m_pDepthStencilView(nullptr)
+        , m_bInputLayoutKnown(FALSE)
+        , m_bIndexBufferKnown(FALSE)
+        , m_bVertexShaderKnown(FALSE)
+        , m_bPixelShaderKnown(FALSE)
+        , m_bRenderTargetsKnown(FALSE)
+        , m_uKnownVertexBuffers(0u)
+        , m_uKnownVSConstantBuffers(0u)
+        , m_uKnownPSConstantBuffers(0u)
+        , m_uKnownVSShaderResourceViews(0u)
+        , m_uKnownPSShaderResourceViews(0u)
+        , m_uKnownPSSamplers(0u)
+        , m_uNumIssuedCalls(0u)
+        , m_uNumSkippedCalls(0u)
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StateFilteringContext::IASetInputLayout
+
+      Summary:  Binds an input layout unless it is bound
+
+      Args:     ID3D11InputLayout* pInputLayout
+                  Input layout, or null
+
+      Modifies: [m_pInputLayout, m_bInputLayoutKnown, m_uNumIssuedCalls,
+                 m_uNumSkippedCalls].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void StateFilteringContext::IASetInputLayout(_In_opt_ ID3D11InputLayout* pInputLayout)
+    {
+        if (countCall(!m_bInputLayoutKnown || pInputLayout != m_pInputLayout))
+        {
+            m_context->IASetInputLayout(pInputLayout);
+            m_pInputLayout = pInputLayout;
+            m_bInputLayoutKnown = TRUE;
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StateFilteringContext::IASetVertexBuffers
+
+      Summary:  Binds the vertex buffers of the slots whose buffer,
+                stride or offset changes
+
+      Args:     UINT uStartSlot
+                  First slot
+                UINT uNumBuffers
+                  Number of slots
+                ID3D11Buffer* const* ppVertexBuffers
+                  Buffer of every slot
+                const UINT* puStrides
+                  Stride of every slot
+                const UINT* puOffsets
+                  Offset of every slot
+
+      Modifies: [m_apVertexBuffers, m_auStrides, m_auOffsets,
+                 m_uKnownVertexBuffers, m_uNumIssuedCalls,
+                 m_uNumSkippedCalls].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void StateFilteringContext::IASetVertexBuffers(_In_ UINT uStartSlot, _In_ UINT uNumBuffers, _In_reads_(uNumBuffers) ID3D11Buffer* const* ppVertexBuffers, _In_reads_(uNumBuffers) const UINT* puStrides, _In_reads_(uNumBuffers) const UINT* puOffsets)
+    {
+        UINT uFirst = UINT_MAX;
+        UINT uLast = 0u;
+        for (UINT i = 0u; i < uNumBuffers; ++i)
+        {
+            const UINT uSlot = uStartSlot + i;
+            if (uSlot < NUM_VERTEX_BUFFER_SLOTS
+                && (m_uKnownVertexBuffers & (1u << uSlot))
+                && m_apVertexBuffers[uSlot] == ppVertexBuffers[i]
+                && m_auStrides[uSlot] == puStrides[i]
+                && m_auOffsets[uSlot] == puOffsets[i])
+            {
+                continue;
+            }
+
+            uFirst = std::min(uFirst, i);
+            uLast = i;
+            if (uSlot < NUM_VERTEX_BUFFER_SLOTS)
+            {
+                m_apVertexBuffers[uSlot] = ppVertexBuffers[i];
+                m_auStrides[uSlot] = puStrides[i];
+                m_auOffsets[uSlot] = puOffsets[i];
+                m_uKnownVertexBuffers |= 1u << uSlot;
+            }
+        }
+
+        if (countCall(uFirst <= uLast))
+        {
+            m_context->IASetVertexBuffers(uStartSlot + uFirst, uLast - uFirst + 1u, ppVertexBuffers + uFirst, puStrides + uFirst, puOffsets + uFirst);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StateFilteringContext::IASetIndexBuffer
+
+      Summary:  Binds an index buffer unless it is bound with the same
+                format and offset
+
+      Args:     ID3D11Buffer* pIndexBuffer
+                  Index buffer, or null
+                DXGI_FORMAT format
+                  Format of the indices
+                UINT uOffset
+                  Offset of the first index
+
+      Modifies: [m_pIndexBuffer, m_indexFormat, m_uIndexOffset,
+                 m_bIndexBufferKnown, m_uNumIssuedCalls,
+                 m_uNumSkippedCalls].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void StateFilteringContext::IASetIndexBuffer(_In_opt_ ID3D11Buffer* pIndexBuffer, _In_ DXGI_FORMAT format, _In_ UINT uOffset)
+    {
+        if (countCall(!m_bIndexBufferKnown || pIndexBuffer != m_pIndexBuffer || format != m_indexFormat || uOffset != m_uIndexOffset))
+        {
+            m_context->IASetIndexBuffer(pIndexBuffer, format, uOffset);
+            m_pIndexBuffer = pIndexBuffer;
+            m_indexFormat = format;
+            m_uIndexOffset = uOffset;
+            m_bIndexBufferKnown = TRUE;
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StateFilteringContext::VSSetShader
+
+      Summary:  Binds a vertex shader unless it is bound
+
+      Args:     ID3D11VertexShader* pVertexShader
+                  Vertex shader, or null
+
+      Modifies: [m_pVertexShader, m_bVertexShaderKnown,
+                 m_uNumIssuedCalls, m_uNumSkippedCalls].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void StateFilteringContext::VSSetShader(_In_opt_ ID3D11VertexShader* pVertexShader)
+    {
+        if (countCall(!m_bVertexShaderKnown || pVertexShader != m_pVertexShader))
+        {
+            m_context->VSSetShader(pVertexShader);
+            m_pVertexShader = pVertexShader;
+            m_bVertexShaderKnown = TRUE;
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StateFilteringContext::PSSetShader
+
+      Summary:  Binds a pixel shader unless it is bound
+
+      Args:     ID3D11PixelShader* pPixelShader
+                  Pixel shader, or null
+
+      Modifies: [m_pPixelShader, m_bPixelShaderKnown, m_uNumIssuedCalls,
+                 m_uNumSkippedCalls].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void StateFilteringContext::PSSetShader(_In_opt_ ID3D11PixelShader* pPixelShader)
+    {
+        if (countCall(!m_bPixelShaderKnown || pPixelShader != m_pPixelShader))
+        {
+            m_context->PSSetShader(pPixelShader);
+            m_pPixelShader = pPixelShader;
+            m_bPixelShaderKnown = TRUE;
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StateFilteringContext::VSSetConstantBuffers
+
+      Summary:  Binds the constant buffers of the vertex shader slots
+                that change
+
+      Args:     UINT uStartSlot
+                  First slot
+                UINT uNumBuffers
+                  Number of slots
+                ID3D11Buffer* const* ppConstantBuffers
+                  Buffer of every slot
+
+      Modifies: [m_apVSConstantBuffers, m_uKnownVSConstantBuffers,
+                 m_uNumIssuedCalls, m_uNumSkippedCalls].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void StateFilteringContext::VSSetConstantBuffers(_In_ UINT uStartSlot, _In_ UINT uNumBuffers, _In_reads_(uNumBuffers) ID3D11Buffer* const* ppConstantBuffers)
+    {
+        UINT uFirst;
+        UINT uLast;
+        if (countCall(filterSlots(m_apVSConstantBuffers, m_uKnownVSConstantBuffers, NUM_CONSTANT_BUFFER_SLOTS, uStartSlot, uNumBuffers, ppConstantBuffers, uFirst, uLast)))
+        {
+            m_context->VSSetConstantBuffers(uStartSlot + uFirst, uLast - uFirst + 1u, ppConstantBuffers + uFirst);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StateFilteringContext::PSSetConstantBuffers
+
+      Summary:  Binds the constant buffers of the pixel shader slots
+                that change
+
+      Args:     UINT uStartSlot
+                  First slot
+                UINT uNumBuffers
+                  Number of slots
+                ID3D11Buffer* const* ppConstantBuffers
+                  Buffer of every slot
+
+      Modifies: [m_apPSConstantBuffers, m_uKnownPSConstantBuffers,
+                 m_uNumIssuedCalls, m_uNumSkippedCalls].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void StateFilteringContext::PSSetConstantBuffers(_In_ UINT uStartSlot, _In_ UINT uNumBuffers, _In_reads_(uNumBuffers) ID3D11Buffer* const* ppConstantBuffers)
+    {
+        UINT uFirst;
+        UINT uLast;
+        if (countCall(filterSlots(m_apPSConstantBuffers, m_uKnownPSConstantBuffers, NUM_CONSTANT_BUFFER_SLOTS, uStartSlot, uNumBuffers, ppConstantBuffers, uFirst, uLast)))
+        {
+            m_context->PSSetConstantBuffers(uStartSlot + uFirst, uLast - uFirst + 1u, ppConstantBuffers + uFirst);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StateFilteringContext::VSSetShaderResources
+
+      Summary:  Binds the views of the vertex shader slots that change
+
+      Args:     UINT uStartSlot
+                  First slot
+                UINT uNumViews
+                  Number of slots
+                ID3D11ShaderResourceView* const* ppShaderResourceViews
+                  View of every slot
+
+      Modifies: [m_apVSShaderResourceViews, m_uKnownVSShaderResourceViews,
+                 m_uNumIssuedCalls, m_uNumSkippedCalls].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void StateFilteringContext::VSSetShaderResources(_In_ UINT uStartSlot, _In_ UINT uNumViews, _In_reads_(uNumViews) ID3D11ShaderResourceView* const* ppShaderResourceViews)
+    {
+        UINT uFirst;
+        UINT uLast;
+        if (countCall(filterSlots(m_apVSShaderResourceViews, m_uKnownVSShaderResourceViews, NUM_SHADER_RESOURCE_SLOTS, uStartSlot, uNumViews, ppShaderResourceViews, uFirst, uLast)))
+        {
+            m_context->VSSetShaderResources(uStartSlot + uFirst, uLast - uFirst + 1u, ppShaderResourceViews + uFirst);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StateFilteringContext::PSSetShaderResources
+
+      Summary:  Binds the views of the pixel shader slots that change
+
+      Args:     UINT uStartSlot
+                  First slot
+                UINT uNumViews
+                  Number of slots
+                ID3D11ShaderResourceView* const* ppShaderResourceViews
+                  View of every slot
+
+      Modifies: [m_apPSShaderResourceViews, m_uKnownPSShaderResourceViews,
+                 m_uNumIssuedCalls, m_uNumSkippedCalls].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void StateFilteringContext::PSSetShaderResources(_In_ UINT uStartSlot, _In_ UINT uNumViews, _In_reads_(uNumViews) ID3D11ShaderResourceView* const* ppShaderResourceViews)
+    {
+        UINT uFirst;
+        UINT uLast;
+        if (countCall(filterSlots(m_apPSShaderResourceViews, m_uKnownPSShaderResourceViews, NUM_SHADER_RESOURCE_SLOTS, uStartSlot, uNumViews, ppShaderResourceViews, uFirst, uLast)))
+        {
+            m_context->PSSetShaderResources(uStartSlot + uFirst, uLast - uFirst + 1u, ppShaderResourceViews + uFirst);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StateFilteringContext::PSSetSamplers
+
+      Summary:  Binds the samplers of the pixel shader slots that change
+
+      Args:     UINT uStartSlot
+                  First slot
+                UINT uNumSamplers
+                  Number of slots
+                ID3D11SamplerState* const* ppSamplers
+                  Sampler of every slot
+
+      Modifies: [m_apPSSamplers, m_uKnownPSSamplers, m_uNumIssuedCalls,
+                 m_uNumSkippedCalls].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void StateFilteringContext::PSSetSamplers(_In_ UINT uStartSlot, _In_ UINT uNumSamplers, _In_reads_(uNumSamplers) ID3D11SamplerState* const* ppSamplers)
+    {
+        UINT uFirst;
+        UINT uLast;
+        if (countCall(filterSlots(m_apPSSamplers, m_uKnownPSSamplers, NUM_SAMPLER_SLOTS, uStartSlot, uNumSamplers, ppSamplers, uFirst, uLast)))
+        {
+            m_context->PSSetSamplers(uStartSlot + uFirst, uLast - uFirst + 1u, ppSamplers + uFirst);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StateFilteringContext::OMSetRenderTargets
+
+      Summary:  Binds render targets and a depth stencil view unless
+                the same ones are bound. Binding them forgets the
+                shader resource views, which Direct3D unbinds if they
+                view one of the targets
+
+      Args:     UINT uNumViews
+                  Number of render targets
+                ID3D11RenderTargetView* const* ppRenderTargetViews
+                  View of every render target
+                ID3D11DepthStencilView* pDepthStencilView
+                  Depth stencil view, or null
+
+      Modifies: [m_uNumRenderTargets, m_apRenderTargetViews,
+                 m_pDepthStencilView, m_bRenderTargetsKnown,
+                 m_uKnownVSShaderResourceViews,
+                 m_uKnownPSShaderResourceViews, m_uNumIssuedCalls,
+                 m_uNumSkippedCalls].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void StateFilteringContext::OMSetRenderTargets(_In_ UINT uNumViews, _In_reads_opt_(uNumViews) ID3D11RenderTargetView* const* ppRenderTargetViews, _In_opt_ ID3D11DepthStencilView* pDepthStencilView)
+    {
+        BOOL bChanged = !m_bRenderTargetsKnown || uNumViews != m_uNumRenderTargets || pDepthStencilView != m_pDepthStencilView || uNumViews > NUM_RENDER_TARGET_SLOTS;
+        for (UINT i = 0u; !bChanged && i < uNumViews; ++i)
+        {
+            bChanged = ppRenderTargetViews[i] != m_apRenderTargetViews[i];
+        }
+
+        if (countCall(bChanged))
+        {
+            m_context->OMSetRenderTargets(uNumViews, ppRenderTargetViews, pDepthStencilView);
+
+            m_uNumRenderTargets = uNumViews;
+            for (UINT i = 0u; i < std::min(uNumViews, NUM_RENDER_TARGET_SLOTS); ++i)
+            {
+                m_apRenderTargetViews[i] = ppRenderTargetViews[i];
+            }
+            m_pDepthStencilView = pDepthStencilView;
+            m_bRenderTargetsKnown = uNumViews <= NUM_RENDER_TARGET_SLOTS;
+
+            m_uKnownVSShaderResourceViews = 0u;
+            m_uKnownPSShaderResourceViews = 0u;
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StateFilteringContext::DrawIndexed
+
+      Summary:  Draws indexed primitives
+
+      Args:     UINT uIndexCount
+                  Number of indices
+                UINT uStartIndexLocation
+                  First index
+                INT iBaseVertexLocation
+                  Added to every index
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void StateFilteringContext::DrawIndexed(_In_ UINT uIndexCount, _In_ UINT uStartIndexLocation, _In_ INT iBaseVertexLocation)
+    {
+        m_context->DrawIndexed(uIndexCount, uStartIndexLocation, iBaseVertexLocation);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StateFilteringContext::DrawIndexedInstanced
+
+      Summary:  Draws instances of indexed primitives
+
+      Args:     UINT uIndexCountPerInstance
+                  Number of indices of an instance
+                UINT uInstanceCount
+                  Number of instances
+                UINT uStartIndexLocation
+                  First index
+                INT iBaseVertexLocation
+                  Added to every index
+                UINT uStartInstanceLocation
+                  First instance
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void StateFilteringContext::DrawIndexedInstanced(_In_ UINT uIndexCountPerInstance, _In_ UINT uInstanceCount, _In_ UINT uStartIndexLocation, _In_ INT iBaseVertexLocation, _In_ UINT uStartInstanceLocation)
+    {
+        m_context->DrawIndexedInstanced(uIndexCountPerInstance, uInstanceCount, uStartIndexLocation, iBaseVertexLocation, uStartInstanceLocation);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StateFilteringContext::Invalidate
+
+      Summary:  Forgets what every slot is bound to, e.g. after the
+                context was used without the filter, so the next bind
+                of every slot goes through
+
+      Modifies: [m_bInputLayoutKnown, m_bIndexBufferKnown,
+                 m_bVertexShaderKnown, m_bPixelShaderKnown,
+                 m_bRenderTargetsKnown, m_uKnownVertexBuffers,
+                 m_uKnownVSConstantBuffers, m_uKnownPSConstantBuffers,
+                 m_uKnownVSShaderResourceViews,
+                 m_uKnownPSShaderResourceViews, m_uKnownPSSamplers].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void StateFilteringContext::Invalidate()
+    {
+        m_bInputLayoutKnown = FALSE;
+        m_bIndexBufferKnown = FALSE;
+        m_bVertexShaderKnown = FALSE;
+        m_bPixelShaderKnown = FALSE;
+        m_bRenderTargetsKnown = FALSE;
+        m_uKnownVertexBuffers = 0u;
+        m_uKnownVSConstantBuffers = 0u;
+        m_uKnownPSConstantBuffers = 0u;
+        m_uKnownVSShaderResourceViews = 0u;
+        m_uKnownPSShaderResourceViews = 0u;
+        m_uKnownPSSamplers = 0u;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StateFilteringContext::ResetCounts
+
+      Summary:  Resets the numbers of issued and skipped binds, e.g. at
+                the start of a frame
+
+      Modifies: [m_uNumIssuedCalls, m_uNumSkippedCalls].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void StateFilteringContext::ResetCounts()
+    {
+        m_uNumIssuedCalls = 0u;
+        m_uNumSkippedCalls = 0u;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StateFilteringContext::GetNumIssuedCalls
+
+      Summary:  Returns the number of binds passed to the context since
+                the counts were reset
+
+      Returns:  UINT
+                  Number of issued binds
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT StateFilteringContext::GetNumIssuedCalls() const
+    {
+        return m_uNumIssuedCalls;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StateFilteringContext::GetNumSkippedCalls
+
+      Summary:  Returns the number of binds dropped since the counts
+                were reset
+
+      Returns:  UINT
+                  Number of skipped binds
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT StateFilteringContext::GetNumSkippedCalls() const
+    {
+        return m_uNumSkippedCalls;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StateFilteringContext::filterSlots
+
+      Summary:  Compares a bind of several slots with what they are
+                bound to, and records the slots that change
+
+      Args:     T** apBound
+                  What every tracked slot is bound to
+                UINT& uKnownSlots
+                  Mask of the tracked slots whose binding is known
+                UINT uNumSlots
+                  Number of tracked slots
+                UINT uStartSlot
+                  First slot of the bind
+                UINT uCount
+                  Number of slots of the bind
+                T* const* apItems
+                  What the bind binds to every slot
+                UINT& uFirst
+                  First item of the bind that changes its slot
+                UINT& uLast
+                  Last item of the bind that changes its slot
+
+      Modifies: [apBound, uKnownSlots, uFirst, uLast].
+
+      Returns:  BOOL
+                  TRUE if a slot changes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    template <typename T>
+    BOOL StateFilteringContext::filterSlots(_Inout_ T** apBound, _Inout_ UINT& uKnownSlots, _In_ UINT uNumSlots, _In_ UINT uStartSlot, _In_ UINT uCount, _In_reads_(uCount) T* const* apItems, _Out_ UINT& uFirst, _Out_ UINT& uLast)
+    {
+        uFirst = UINT_MAX;
+        uLast = 0u;
+        for (UINT i = 0u; i < uCount; ++i)
+        {
+            const UINT uSlot = uStartSlot + i;
+            if (uSlot < uNumSlots && (uKnownSlots & (1u << uSlot)) && apBound[uSlot] == apItems[i])
+            {
+                continue;
+            }
+
+            uFirst = std::min(uFirst, i);
+            uLast = i;
+            if (uSlot < uNumSlots)
+            {
+                apBound[uSlot] = apItems[i];
+                uKnownSlots |= 1u << uSlot;
+            }
+        }
+
+        return uFirst <= uLast;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StateFilteringContext::countCall
+
+      Summary:  Counts a bind as issued or skipped
+
+      Args:     BOOL bIssued
+                  Whether the bind goes to the context
+
+      Modifies: [m_uNumIssuedCalls, m_uNumSkippedCalls].
+
+      Returns:  BOOL
+                  bIssued
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL StateFilteringContext::countCall(_In_ BOOL bIssued)
+    {
+        if (bIssued)
+        {
+            ++m_uNumIssuedCalls;
+        }
+        else
+        {
+            ++m_uNumSkippedCalls;
+        }
+
+        return bIssued;
+    }
+}
@@ -0,0 +1,153 @@
+/*+===================================================================
+  File:      STATEFILTERINGCONTEXT.H
+
+  Summary:   StateFilteringContext header file contains declarations
+             of the StateFilteringContext class that drops the binds
+             of state that is already bound, without Direct3D.
+
+  Classes: StateFilteringContext
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Platform.h"
+
+#include <algorithm>
+#include <climits>
+
+#include "Renderer/RenderContext.h"
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    StateFilteringContext
+
+      Summary:  RenderContext between the renderer and another
+                context, keeping what every slot is bound to. A bind
+                of what is already bound is dropped, and a bind of
+                several slots is narrowed to the slots that change.
+                Every slot starts unknown, so the first bind of a slot
+                always goes through, and binding render targets
+                forgets the shader resource views, since Direct3D
+                unbinds the views of a resource bound as an output.
+                Slots past the ones tracked are always bound. Draws go
+                through as they are. Every bind of the context must go
+                through the filter, or Invalidate must be called after
+
+      Methods:  IASetInputLayout
+                  Binds an input layout
+                IASetVertexBuffers
+                  Binds vertex buffers
+                IASetIndexBuffer
+                  Binds an index buffer
+                VSSetShader
+                  Binds a vertex shader
+                PSSetShader
+                  Binds a pixel shader
+                VSSetConstantBuffers
+                  Binds constant buffers to the vertex shader
+                PSSetConstantBuffers
+                  Binds constant buffers to the pixel shader
+                VSSetShaderResources
+                  Binds shader resource views to the vertex shader
+                PSSetShaderResources
+                  Binds shader resource views to the pixel shader
+                PSSetSamplers
+                  Binds samplers to the pixel shader
+                OMSetRenderTargets
+                  Binds render targets and a depth stencil view
+                DrawIndexed
+                  Draws indexed primitives
+                DrawIndexedInstanced
+                  Draws instances of indexed primitives
+                Invalidate
+                  Forgets what every slot is bound to
+                ResetCounts
+                  Resets the numbers of issued and skipped binds
+                GetNumIssuedCalls
+                  Returns the number of binds passed to the context
+                GetNumSkippedCalls
+                  Returns the number of binds dropped
+                StateFilteringContext
+                  Constructor.
+                ~StateFilteringContext
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class StateFilteringContext final : public RenderContext
+    {
+    public:
+        static constexpr const UINT NUM_VERTEX_BUFFER_SLOTS = 16u;
+        static constexpr const UINT NUM_CONSTANT_BUFFER_SLOTS = 14u;
+        static constexpr const UINT NUM_SHADER_RESOURCE_SLOTS = 16u;
+        static constexpr const UINT NUM_SAMPLER_SLOTS = 16u;
+        static constexpr const UINT NUM_RENDER_TARGET_SLOTS = 8u;
+
+        static_assert(std::max({ NUM_VERTEX_BUFFER_SLOTS, NUM_CONSTANT_BUFFER_SLOTS, NUM_SHADER_RESOURCE_SLOTS, NUM_SAMPLER_SLOTS }) <= sizeof(UINT) * CHAR_BIT, "A mask has a bit for every tracked slot");
+
+    public:
+        StateFilteringContext(_In_ const std::shared_ptr<RenderContext>& context);
+        StateFilteringContext(const StateFilteringContext& other) = delete;
+        StateFilteringContext(StateFilteringContext&& other) = delete;
+        StateFilteringContext& operator=(const StateFilteringContext& other) = delete;
+        StateFilteringContext& operator=(StateFilteringContext&& other) = delete;
+        virtual ~StateFilteringContext() = default;
+
+        void IASetInputLayout(_In_opt_ ID3D11InputLayout* pInputLayout) override;
+        void IASetVertexBuffers(_In_ UINT uStartSlot, _In_ UINT uNumBuffers, _In_reads_(uNumBuffers) ID3D11Buffer* const* ppVertexBuffers, _In_reads_(uNumBuffers) const UINT* puStrides, _In_reads_(uNumBuffers) const UINT* puOffsets) override;
+        void IASetIndexBuffer(_In_opt_ ID3D11Buffer* pIndexBuffer, _In_ DXGI_FORMAT format, _In_ UINT uOffset) override;
+        void VSSetShader(_In_opt_ ID3D11VertexShader* pVertexShader) override;
+        void PSSetShader(_In_opt_ ID3D11PixelShader* pPixelShader) override;
+        void VSSetConstantBuffers(_In_ UINT uStartSlot, _In_ UINT uNumBuffers, _In_reads_(uNumBuffers) ID3D11Buffer* const* ppConstantBuffers) override;
+        void PSSetConstantBuffers(_In_ UINT uStartSlot, _In_ UINT uNumBuffers, _In_reads_(uNumBuffers) ID3D11Buffer* const* ppConstantBuffers) override;
+        void VSSetShaderResources(_In_ UINT uStartSlot, _In_ UINT uNumViews, _In_reads_(uNumViews) ID3D11ShaderResourceView* const* ppShaderResourceViews) override;
+        void PSSetShaderResources(_In_ UINT uStartSlot, _In_ UINT uNumViews, _In_reads_(uNumViews) ID3D11ShaderResourceView* const* ppShaderResourceViews) override;
+        void PSSetSamplers(_In_ UINT uStartSlot, _In_ UINT uNumSamplers, _In_reads_(uNumSamplers) ID3D11SamplerState* const* ppSamplers) override;
+        void OMSetRenderTargets(_In_ UINT uNumViews, _In_reads_opt_(uNumViews) ID3D11RenderTargetView* const* ppRenderTargetViews, _In_opt_ ID3D11DepthStencilView* pDepthStencilView) override;
+        void DrawIndexed(_In_ UINT uIndexCount, _In_ UINT uStartIndexLocation, _In_ INT iBaseVertexLocation) override;
+        void DrawIndexedInstanced(_In_ UINT uIndexCountPerInstance, _In_ UINT uInstanceCount, _In_ UINT uStartIndexLocation, _In_ INT iBaseVertexLocation, _In_ UINT uStartInstanceLocation) override;
+
+        void Invalidate();
+        void ResetCounts();
+        UINT GetNumIssuedCalls() const;
+        UINT GetNumSkippedCalls() const;
+
+    private:
+        template <typename T>
+        BOOL filterSlots(_Inout_ T** apBound, _Inout_ UINT& uKnownSlots, _In_ UINT uNumSlots, _In_ UINT uStartSlot, _In_ UINT uCount, _In_reads_(uCount) T* const* apItems, _Out_ UINT& uFirst, _Out_ UINT& uLast);
+        BOOL countCall(_In_ BOOL bIssued);
+
+    private:
+        std::shared_ptr<RenderContext> m_context;
+        ID3D11InputLayout* m_pInputLayout;
+        ID3D11Buffer* m_apVertexBuffers[NUM_VERTEX_BUFFER_SLOTS];
+        UINT m_auStrides[NUM_VERTEX_BUFFER_SLOTS];
+        UINT m_auOffsets[NUM_VERTEX_BUFFER_SLOTS];
+        ID3D11Buffer* m_pIndexBuffer;
+        DXGI_FORMAT m_indexFormat;
+        UINT m_uIndexOffset;
+        ID3D11VertexShader* m_pVertexShader;
+        ID3D11PixelShader* m_pPixelShader;
+        ID3D11Buffer* m_apVSConstantBuffers[NUM_CONSTANT_BUFFER_SLOTS];
+        ID3D11Buffer* m_apPSConstantBuffers[NUM_CONSTANT_BUFFER_SLOTS];
+        ID3D11ShaderResourceView* m_apVSShaderResourceViews[NUM_SHADER_RESOURCE_SLOTS];
+        ID3D11ShaderResourceView* m_apPSShaderResourceViews[NUM_SHADER_RESOURCE_SLOTS];
+        ID3D11SamplerState* m_apPSSamplers[NUM_SAMPLER_SLOTS];
+        UINT m_uNumRenderTargets;
+        ID3D11RenderTargetView* m_apRenderTargetViews[NUM_RENDER_TARGET_SLOTS];
+        ID3D11DepthStencilView* m_pDepthStencilView;
+        BOOL m_bInputLayoutKnown;
+        BOOL m_bIndexBufferKnown;
+        BOOL m_bVertexShaderKnown;
+        BOOL m_bPixelShaderKnown;
+        BOOL m_bRenderTargetsKnown;
+        UINT m_uKnownVertexBuffers;
+        UINT m_uKnownVSConstantBuffers;
+        UINT m_uKnownPSConstantBuffers;
+        UINT m_uKnownVSShaderResourceViews;
+        UINT m_uKnownPSShaderResourceViews;
+        UINT m_uKnownPSSamplers;
+        UINT m_uNumIssuedCalls;
+        UINT m_uNumSkippedCalls;
+    };
+}
@@ -0,0 +1,25 @@
+/*+===================================================================
+  File:      VERTEXDATA.H
+
+  Summary:   VertexData header file contains the declaration of the
+             vertex of the meshes, without Direct3D.
+
+  Classes: SimpleVertex
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Platform.h"
+
+namespace library
+{
+    // Vertex of the meshes, read by the shaders as R32G32B32_FLOAT, R32G32_FLOAT and R32G32B32_FLOAT
+    struct SimpleVertex
+    {
+        XMFLOAT3 Position;
+        XMFLOAT2 TexCoord;
+        XMFLOAT3 Normal;
+    };
+    static_assert(sizeof(SimpleVertex) == 32u);
+}
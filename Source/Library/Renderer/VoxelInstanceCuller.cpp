@@ -0,0 +1,386 @@
+#include "Renderer/VoxelInstanceCuller.h"
+
+#include <cmath>
+#include <cstring>
+
+// VOXEL_INSTANCE_CULLER_SCALAR leaves only the loop over single instances, for the tests and benchmarks of the SSE2 path
+#if (defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)) && !defined(VOXEL_INSTANCE_CULLER_SCALAR)
+#define VOXEL_INSTANCE_CULLER_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelInstanceCuller::CullInstances
+
+      Summary:  Writes the instances whose cube is in or crosses the
+                frustum, in their order. The cube of an instance at
+                grid cell g of level of detail l is centered at
+                (2g + 1) * 2^l with half extents 2^l, so the distance
+                of its far corner to a plane is
+                2^l * (n . (2g + 1) + |n.x| + |n.y| + |n.z|) + w and
+                the cube is culled when it is negative for a plane.
+                Blocks of 4 instances are tested with SSE2 and written
+                without branches, each instance to the next free slot
+                which only moves past it when it is visible, and the
+                last instances are tested one at a time
+
+      Args:     const FLOAT aPlanes[FrustumCuller::NUM_PLANES][4]
+                  Planes of the frustum in the space of the voxel, as
+                  extracted by FrustumCuller::ExtractPlanes
+                const InstanceData* pInstances
+                  Instances to test
+                UINT uNumInstances
+                  Number of instances
+                InstanceData* pVisible
+                  Receives the visible instances, must not overlap
+                  pInstances
+
+      Modifies: [pVisible].
+
+      Returns:  UINT
+                  Number of visible instances
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT VoxelInstanceCuller::CullInstances(_In_ const FLOAT aPlanes[FrustumCuller::NUM_PLANES][4], _In_reads_(uNumInstances) const InstanceData* pInstances, _In_ UINT uNumInstances, _Out_writes_(uNumInstances) InstanceData* pVisible)
+    {
+        UINT uNumVisible = 0u;
+
+        UINT i = 0u;
+#ifdef VOXEL_INSTANCE_CULLER_SSE2
+        {
+            __m128 aNormals[FrustumCuller::NUM_PLANES][3];
+            __m128 aExtents[FrustumCuller::NUM_PLANES];
+            __m128 aDistances[FrustumCuller::NUM_PLANES];
+            for (UINT uPlane = 0u; uPlane < FrustumCuller::NUM_PLANES; ++uPlane)
+            {
+                for (UINT j = 0u; j < 3u; ++j)
+                {
+                    aNormals[uPlane][j] = _mm_set1_ps(aPlanes[uPlane][j]);
+                }
+                aExtents[uPlane] = _mm_set1_ps(std::abs(aPlanes[uPlane][0]) + std::abs(aPlanes[uPlane][1]) + std::abs(aPlanes[uPlane][2]));
+                aDistances[uPlane] = _mm_set1_ps(aPlanes[uPlane][3]);
+            }
+
+            const __m128i zeroInt = _mm_setzero_si128();
+            const __m128i blockTypeMask = _mm_set1_epi32(0xFF);
+            const __m128i exponentBias = _mm_set1_epi32(127);
+            const __m128 zero = _mm_setzero_ps();
+            const __m128 one = _mm_set1_ps(1.0f);
+            for (; i + 4u <= uNumInstances; i += 4u)
+            {
+                // 4 instances of X, Y, Z, W words are transposed to a register of X, Y, Z and W words each
+                const __m128i instances01 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pInstances + i));
+                const __m128i instances23 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pInstances + i + 2u));
+                const __m128i lo = _mm_unpacklo_epi16(instances01, instances23);
+                const __m128i hi = _mm_unpackhi_epi16(instances01, instances23);
+                const __m128i xy = _mm_unpacklo_epi16(lo, hi);
+                const __m128i zw = _mm_unpackhi_epi16(lo, hi);
+                const __m128i gridW = _mm_unpackhi_epi16(zw, zeroInt);
+
+                const __m128 cellsX = _mm_add_ps(_mm_cvtepi32_ps(_mm_slli_epi32(_mm_unpacklo_epi16(xy, zeroInt), 1)), one);
+                const __m128 cellsY = _mm_add_ps(_mm_cvtepi32_ps(_mm_slli_epi32(_mm_unpackhi_epi16(xy, zeroInt), 1)), one);
+                const __m128 cellsZ = _mm_add_ps(_mm_cvtepi32_ps(_mm_slli_epi32(_mm_unpacklo_epi16(zw, zeroInt), 1)), one);
+
+                // 2^l is built from its exponent bits
+                const __m128 scales = _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(_mm_srli_epi32(gridW, 8), exponentBias), 23));
+
+                __m128 visible = _mm_castsi128_ps(_mm_xor_si128(_mm_cmpeq_epi32(_mm_and_si128(gridW, blockTypeMask), zeroInt), _mm_set1_epi32(-1)));
+                for (UINT uPlane = 0u; uPlane < FrustumCuller::NUM_PLANES; ++uPlane)
+                {
+                    __m128 distance = _mm_add_ps(_mm_mul_ps(aNormals[uPlane][0], cellsX), _mm_mul_ps(aNormals[uPlane][1], cellsY));
+                    distance = _mm_add_ps(distance, _mm_mul_ps(aNormals[uPlane][2], cellsZ));
+                    distance = _mm_add_ps(distance, aExtents[uPlane]);
+                    distance = _mm_add_ps(_mm_mul_ps(distance, scales), aDistances[uPlane]);
+                    visible = _mm_and_ps(visible, _mm_cmpge_ps(distance, zero));
+                }
+
+                const INT iMask = _mm_movemask_ps(visible);
+                for (UINT j = 0u; j < 4u; ++j)
+                {
+                    pVisible[uNumVisible] = pInstances[i + j];
+                    uNumVisible += static_cast<UINT>((iMask >> j) & 1);
+                }
+            }
+        }
+#endif
+        for (; i < uNumInstances; ++i)
+        {
+            pVisible[uNumVisible] = pInstances[i];
+            uNumVisible += static_cast<UINT>(isInstanceVisible(aPlanes, pInstances[i]));
+        }
+
+        return uNumVisible;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelInstanceCuller::VoxelInstanceCuller
+
+      Summary:  Constructor. Starts uNumThreads - 1 threads, the
+                thread calling Cull is the last one
+
+      Args:     UINT uNumThreads
+                  Number of threads culling batches, 0 for the number
+                  of hardware threads
+
+      Modifies: [m_aPlanes, m_aBatches, m_aNumVisible, m_aScratch,
+                 m_aThreads, m_mutex, m_jobCondition, m_doneCondition,
+                 m_uJobId, m_uNumBusyThreads, m_bStop,
+                 m_uNextBatchIdx].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    VoxelInstanceCuller::VoxelInstanceCuller(_In_ UINT uNumThreads)
+        : m_aPlanes()
+        , m_aBatches()
+        , m_aNumVisible()
+        , m_aScratch()
+        , m_aThreads()
+        , m_mutex()
+        , m_jobCondition()
+        , m_doneCondition()
+        , m_uJobId(0u)
+        , m_uNumBusyThreads(0u)
+        , m_bStop(FALSE)
+        , m_uNextBatchIdx(0u)
+    {
+        if (uNumThreads == 0u)
+        {
+            uNumThreads = std::max(std::thread::hardware_concurrency(), 1u);
+        }
+
+        m_aThreads.reserve(uNumThreads - 1u);
+        for (UINT i = 1u; i < uNumThreads; ++i)
+        {
+            m_aThreads.emplace_back(&VoxelInstanceCuller::work, this);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelInstanceCuller::~VoxelInstanceCuller
+
+      Summary:  Destructor. Stops and joins the threads
+
+      Modifies: [m_aThreads, m_bStop].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    VoxelInstanceCuller::~VoxelInstanceCuller()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_bStop = TRUE;
+        }
+        m_jobCondition.notify_all();
+
+        for (std::thread& thread : m_aThreads)
+        {
+            thread.join();
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelInstanceCuller::Cull
+
+      Summary:  Writes the visible instances of the spans, in their
+                order. A single batch is culled on the calling thread
+                straight to the output, more are handed to the threads
+                of the pool and the calling thread. Only one thread
+                may call Cull at a time
+
+      Args:     const FLOAT* pWorldViewProjection
+                  Row-major world view projection matrix of the voxel
+                  the instances are drawn with
+                const InstanceSpan* pSpans
+                  Spans of instances to test
+                UINT uNumSpans
+                  Number of spans
+                InstanceData* pVisible
+                  Receives the visible instances, with room for every
+                  instance of the spans, e.g. a mapped dynamic buffer
+
+      Modifies: [m_aPlanes, m_aBatches, m_aNumVisible, m_aScratch,
+                 m_uJobId, m_uNumBusyThreads, m_uNextBatchIdx,
+                 pVisible].
+
+      Returns:  UINT
+                  Number of visible instances
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT VoxelInstanceCuller::Cull(_In_reads_(16) const FLOAT* pWorldViewProjection, _In_reads_(uNumSpans) const InstanceSpan* pSpans, _In_ UINT uNumSpans, _Out_ InstanceData* pVisible)
+    {
+        FrustumCuller::ExtractPlanes(pWorldViewProjection, m_aPlanes);
+
+        m_aBatches.clear();
+        UINT uNumInstances = 0u;
+        for (UINT uSpanIdx = 0u; uSpanIdx < uNumSpans; ++uSpanIdx)
+        {
+            const InstanceSpan& span = pSpans[uSpanIdx];
+            for (UINT uFirst = 0u; uFirst < span.uNumInstances; uFirst += BATCH_SIZE)
+            {
+                const UINT uNumBatchInstances = std::min(span.uNumInstances - uFirst, BATCH_SIZE);
+                m_aBatches.push_back(Batch{ .pInstances = span.pInstances + uFirst, .uNumInstances = uNumBatchInstances, .uOffset = uNumInstances });
+                uNumInstances += uNumBatchInstances;
+            }
+        }
+
+        if (m_aBatches.empty())
+        {
+            return 0u;
+        }
+
+        if (m_aBatches.size() == 1u || m_aThreads.empty())
+        {
+            UINT uNumVisible = 0u;
+            for (const Batch& batch : m_aBatches)
+            {
+                uNumVisible += CullInstances(m_aPlanes, batch.pInstances, batch.uNumInstances, pVisible + uNumVisible);
+            }
+
+            return uNumVisible;
+        }
+
+        m_aNumVisible.resize(m_aBatches.size());
+        if (m_aScratch.size() < uNumInstances)
+        {
+            m_aScratch.resize(uNumInstances);
+        }
+
+        run();
+
+        UINT uNumVisible = 0u;
+        for (size_t uBatchIdx = 0u; uBatchIdx < m_aBatches.size(); ++uBatchIdx)
+        {
+            std::memcpy(pVisible + uNumVisible, m_aScratch.data() + m_aBatches[uBatchIdx].uOffset, sizeof(InstanceData) * m_aNumVisible[uBatchIdx]);
+            uNumVisible += m_aNumVisible[uBatchIdx];
+        }
+
+        return uNumVisible;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelInstanceCuller::GetNumThreads
+
+      Summary:  Returns the number of threads culling batches,
+                including the thread calling Cull
+
+      Returns:  UINT
+                  Number of threads
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT VoxelInstanceCuller::GetNumThreads() const
+    {
+        return static_cast<UINT>(m_aThreads.size()) + 1u;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelInstanceCuller::isInstanceVisible
+
+      Summary:  Returns whether the cube of an instance is in or
+                crosses the frustum
+
+      Args:     const FLOAT aPlanes[FrustumCuller::NUM_PLANES][4]
+                  Planes of the frustum in the space of the voxel
+                const InstanceData& instance
+                  Instance to test
+
+      Returns:  BOOL
+                  TRUE if the cube is solid and not behind a plane
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL VoxelInstanceCuller::isInstanceVisible(_In_ const FLOAT aPlanes[FrustumCuller::NUM_PLANES][4], _In_ const InstanceData& instance)
+    {
+        if (static_cast<BYTE>(instance.BlockType) == 0u)
+        {
+            return FALSE;
+        }
+
+        const FLOAT cellX = static_cast<FLOAT>(2u * instance.X + 1u);
+        const FLOAT cellY = static_cast<FLOAT>(2u * instance.Y + 1u);
+        const FLOAT cellZ = static_cast<FLOAT>(2u * instance.Z + 1u);
+        const FLOAT scale = static_cast<FLOAT>(1u << instance.Lod);
+        for (UINT uPlane = 0u; uPlane < FrustumCuller::NUM_PLANES; ++uPlane)
+        {
+            const FLOAT* pPlane = aPlanes[uPlane];
+            FLOAT distance = pPlane[0] * cellX + pPlane[1] * cellY;
+            distance = distance + pPlane[2] * cellZ;
+            distance = distance + (std::abs(pPlane[0]) + std::abs(pPlane[1]) + std::abs(pPlane[2]));
+            if (distance * scale + pPlane[3] < 0.0f)
+            {
+                return FALSE;
+            }
+        }
+
+        return TRUE;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelInstanceCuller::run
+
+      Summary:  Hands the batches to the threads of the pool, culls
+                batches and waits until every thread is done
+
+      Modifies: [m_uJobId, m_uNumBusyThreads, m_uNextBatchIdx].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelInstanceCuller::run()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_uNextBatchIdx = 0u;
+            m_uNumBusyThreads = static_cast<UINT>(m_aThreads.size());
+            ++m_uJobId;
+        }
+        m_jobCondition.notify_all();
+
+        cullBatches();
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_doneCondition.wait(lock, [this]() { return m_uNumBusyThreads == 0u; });
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelInstanceCuller::work
+
+      Summary:  Loop of a thread of the pool, which waits for a job,
+                culls batches until none is left and reports that it
+                is done
+
+      Modifies: [m_uNumBusyThreads].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelInstanceCuller::work()
+    {
+        UINT64 uJobId = 0u;
+        for (;;)
+        {
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_jobCondition.wait(lock, [this, &uJobId]() { return m_bStop || m_uJobId != uJobId; });
+                if (m_bStop)
+                {
+                    return;
+                }
+
+                uJobId = m_uJobId;
+            }
+
+            cullBatches();
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (--m_uNumBusyThreads == 0u)
+            {
+                m_doneCondition.notify_one();
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelInstanceCuller::cullBatches
+
+      Summary:  Claims batches and compacts their visible instances to
+                the scratch buffer at their offset until none is left
+
+      Modifies: [m_aNumVisible, m_aScratch, m_uNextBatchIdx].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelInstanceCuller::cullBatches()
+    {
+        const UINT uNumBatches = static_cast<UINT>(m_aBatches.size());
+        for (UINT uBatchIdx = m_uNextBatchIdx++; uBatchIdx < uNumBatches; uBatchIdx = m_uNextBatchIdx++)
+        {
+            const Batch& batch = m_aBatches[uBatchIdx];
+            m_aNumVisible[uBatchIdx] = CullInstances(m_aPlanes, batch.pInstances, batch.uNumInstances, m_aScratch.data() + batch.uOffset);
+        }
+    }
+}
@@ -0,0 +1,121 @@
+/*+===================================================================
+  File:      VOXELINSTANCECULLER.H
+
+  Summary:   VoxelInstanceCuller header file contains declarations of
+             the VoxelInstanceCuller class that compacts the instances
+             of the cubes of voxels in the view frustum, on a pool of
+             threads, without Direct3D.
+
+  Classes: VoxelInstanceCuller
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Platform.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "Renderer/FrustumCuller.h"
+#include "Renderer/InstanceData.h"
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   InstanceSpan
+
+      Summary:  Consecutive instances of cubes to cull, e.g. those of a
+                chunk of the voxel map
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct InstanceSpan
+    {
+        const InstanceData* pInstances;
+        UINT uNumInstances;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    VoxelInstanceCuller
+
+      Summary:  Tests the cubes of instances against the frustum of a
+                world view projection matrix and writes the ones inside
+                or crossing it, in their order, next to each other, so
+                they are drawn with one draw of the visible count. The
+                cubes are in the space of the voxel, as the voxel
+                vertex shader places them, and cubes of air are dropped
+                as the shader would. The spans are split into batches
+                of BATCH_SIZE instances that the threads of the pool
+                claim one at a time and compact into a scratch buffer
+                at the offset of their first instance, and the calling
+                thread then copies the batches in order to the output,
+                so the output is identical for any number of threads.
+                Blocks of 4 instances are tested with SSE2
+
+      Methods:  Cull
+                  Writes the visible instances of spans
+                CullInstances
+                  Writes the visible instances of an array on the
+                  calling thread
+                GetNumThreads
+                  Returns the number of threads culling batches
+                VoxelInstanceCuller
+                  Constructor.
+                ~VoxelInstanceCuller
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class VoxelInstanceCuller final
+    {
+    public:
+        static constexpr const UINT BATCH_SIZE = 4096u;
+
+        static UINT CullInstances(_In_ const FLOAT aPlanes[FrustumCuller::NUM_PLANES][4], _In_reads_(uNumInstances) const InstanceData* pInstances, _In_ UINT uNumInstances, _Out_writes_(uNumInstances) InstanceData* pVisible);
+
+    public:
+        VoxelInstanceCuller(_In_ UINT uNumThreads = 0u);
+        VoxelInstanceCuller(const VoxelInstanceCuller& other) = delete;
+        VoxelInstanceCuller(VoxelInstanceCuller&& other) = delete;
+        VoxelInstanceCuller& operator=(const VoxelInstanceCuller& other) = delete;
+        VoxelInstanceCuller& operator=(VoxelInstanceCuller&& other) = delete;
+        ~VoxelInstanceCuller();
+
+        UINT Cull(_In_reads_(16) const FLOAT* pWorldViewProjection, _In_reads_(uNumSpans) const InstanceSpan* pSpans, _In_ UINT uNumSpans, _Out_ InstanceData* pVisible);
+
+        UINT GetNumThreads() const;
+
+    private:
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+            Struct:   Batch
+            Summary:  Instances a thread culls at a time, and the offset
+                      of the first one in the scratch buffer
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct Batch
+        {
+            const InstanceData* pInstances;
+            UINT uNumInstances;
+            UINT uOffset;
+        };
+
+        static BOOL isInstanceVisible(_In_ const FLOAT aPlanes[FrustumCuller::NUM_PLANES][4], _In_ const InstanceData& instance);
+
+        void run();
+        void work();
+        void cullBatches();
+
+    private:
+        FLOAT m_aPlanes[FrustumCuller::NUM_PLANES][4];
+        std::vector<Batch> m_aBatches;
+        std::vector<UINT> m_aNumVisible;
+        std::vector<InstanceData> m_aScratch;
+        std::vector<std::thread> m_aThreads;
+        std::mutex m_mutex;
+        std::condition_variable m_jobCondition;
+        std::condition_variable m_doneCondition;
+        UINT64 m_uJobId;
+        UINT m_uNumBusyThreads;
+        BOOL m_bStop;
+        std::atomic<UINT> m_uNextBatchIdx;
+    };
+}
@@ -0,0 +1,138 @@
+#include "Scene/BiomeClassifier.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#define BIOME_CLASSIFIER_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BiomeClassifier::BiomeClassifier
+
+      Summary:  Constructor. Starts with the default table
+
+      Modifies: [m_table].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BiomeClassifier::BiomeClassifier()
+        : m_table(DEFAULT_TABLE)
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BiomeClassifier::SetRegions
+
+      Summary:  Rebuilds the table from a list of regions
+
+      Args:     const BiomeRegion* pRegions
+                  Regions, in order of priority
+                size_t uNumRegions
+                  Number of regions
+
+      Modifies: [m_table].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void BiomeClassifier::SetRegions(_In_reads_(uNumRegions) const BiomeRegion* pRegions, _In_ size_t uNumRegions)
+    {
+        m_table = BuildTable(pRegions, uNumRegions);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BiomeClassifier::Classify
+
+      Summary:  Returns the biome of a column
+
+      Args:     FLOAT height
+                  Height of the column
+                FLOAT moisture
+                  Moisture of the column
+
+      Returns:  eBlockType
+                  Biome of the column
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    eBlockType BiomeClassifier::Classify(_In_ FLOAT height, _In_ FLOAT moisture) const
+    {
+        return m_table[static_cast<size_t>(quantize(height)) * RESOLUTION + quantize(moisture)];
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BiomeClassifier::ClassifyRow
+
+      Summary:  Returns the biomes of a row of columns. The cells of
+                four columns at a time are computed with SSE2 where
+                the target has it, only the table reads are scalar
+
+      Args:     const FLOAT* pHeights
+                  Heights of the columns
+                const FLOAT* pMoistures
+                  Moistures of the columns
+                UINT uNumColumns
+                  Number of columns
+                eBlockType* pBlockTypes
+                  Receives the biomes
+
+      Modifies: [pBlockTypes].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void BiomeClassifier::ClassifyRow(_In_reads_(uNumColumns) const FLOAT* pHeights, _In_reads_(uNumColumns) const FLOAT* pMoistures, _In_ UINT uNumColumns, _Out_writes_(uNumColumns) eBlockType* pBlockTypes) const
+    {
+        UINT i = 0u;
+#ifdef BIOME_CLASSIFIER_SSE2
+        const __m128 stepsPerUnit = _mm_set1_ps(STEPS_PER_UNIT);
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 maxStep = _mm_set1_ps(static_cast<FLOAT>(RESOLUTION - 1u));
+        for (; i + 4u <= uNumColumns; i += 4u)
+        {
+            const __m128 heights = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(pHeights + i), stepsPerUnit), zero), maxStep);
+            const __m128 moistures = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(pMoistures + i), stepsPerUnit), zero), maxStep);
+            const __m128i cells = _mm_add_epi32(_mm_slli_epi32(_mm_cvttps_epi32(heights), RESOLUTION_BITS), _mm_cvttps_epi32(moistures));
+
+            alignas(16) INT aCells[4];
+            _mm_store_si128(reinterpret_cast<__m128i*>(aCells), cells);
+            pBlockTypes[i] = m_table[aCells[0]];
+            pBlockTypes[i + 1u] = m_table[aCells[1]];
+            pBlockTypes[i + 2u] = m_table[aCells[2]];
+            pBlockTypes[i + 3u] = m_table[aCells[3]];
+        }
+#endif
+        for (; i < uNumColumns; ++i)
+        {
+            pBlockTypes[i] = Classify(pHeights[i], pMoistures[i]);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BiomeClassifier::GetTable
+
+      Summary:  Returns the table the columns are classified with
+
+      Returns:  const Table&
+                  Biome of each cell, row by row along the height
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const BiomeClassifier::Table& BiomeClassifier::GetTable() const
+    {
+        return m_table;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BiomeClassifier::quantize
+
+      Summary:  Returns the step of a height or a moisture, clamped to
+                the table. NaN fails every compare and is clamped to
+                the first step, like the SSE2 path of ClassifyRow
+
+      Args:     FLOAT value
+                  Height or moisture
+
+      Returns:  UINT
+                  Step in [0, RESOLUTION)
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT BiomeClassifier::quantize(_In_ FLOAT value)
+    {
+        const FLOAT step = value * STEPS_PER_UNIT;
+        if (!(step > 0.0f))
+        {
+            return 0u;
+        }
+
+        return static_cast<UINT>(std::min(step, static_cast<FLOAT>(RESOLUTION - 1u)));
+    }
+}
@@ -0,0 +1,161 @@
+/*+===================================================================
+  File:      BIOMECLASSIFIER.H
+
+  Summary:   BiomeClassifier header file contains declarations of the
+             BiomeClassifier class that maps the height and moisture
+             of a column to its biome through a lookup table.
+
+  Classes: BiomeClassifier
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Platform.h"
+
+#include <algorithm>
+#include <array>
+#include <cfloat>
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+        Struct:   BiomeRegion
+        Summary:  Rectangle of heights and moistures, lower bounds
+                  included, that belongs to a biome
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct BiomeRegion
+    {
+        FLOAT MinHeight;
+        FLOAT MaxHeight;
+        FLOAT MinMoisture;
+        FLOAT MaxMoisture;
+        eBlockType BlockType;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    BiomeClassifier
+
+      Summary:  Quantizes the height and moisture of a column into
+                RESOLUTION steps of 1 / STEPS_PER_UNIT each and reads
+                the biome from a RESOLUTION x RESOLUTION table, without
+                any branch. The table is built from a list of regions,
+                the first region holding the center of a cell gives
+                its biome, so the thresholds are data. The default
+                table is built at compile time, and its thresholds are
+                multiples of the step so they fall on cell edges
+
+      Methods:  BuildTable
+                  Builds the table of a list of regions
+                SetRegions
+                  Rebuilds the table from a list of regions
+                Classify
+                  Returns the biome of a column
+                ClassifyRow
+                  Returns the biomes of a row of columns
+                GetTable
+                  Returns the table
+                BiomeClassifier
+                  Constructor.
+                ~BiomeClassifier
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class BiomeClassifier final
+    {
+    public:
+        static constexpr const UINT RESOLUTION_BITS = 7u;
+        static constexpr const UINT RESOLUTION = 1u << RESOLUTION_BITS;
+        static constexpr const FLOAT STEPS_PER_UNIT = 100.0f;
+
+        typedef std::array<eBlockType, static_cast<size_t>(RESOLUTION) * RESOLUTION> Table;
+
+        static constexpr const BiomeRegion DEFAULT_REGIONS[] =
+        {
+            { 0.0f,    0.1f,    0.0f,    FLT_MAX, eBlockType::OCEAN },
+            { 0.1f,    0.12f,   0.0f,    FLT_MAX, eBlockType::SAND },
+            { 0.8f,    FLT_MAX, 0.0f,    0.1f,    eBlockType::SCORCHED },
+            { 0.8f,    FLT_MAX, 0.1f,    0.2f,    eBlockType::BARE },
+            { 0.8f,    FLT_MAX, 0.2f,    0.5f,    eBlockType::TUNDRA },
+            { 0.8f,    FLT_MAX, 0.5f,    FLT_MAX, eBlockType::SNOW },
+            { 0.6f,    0.8f,    0.0f,    0.33f,   eBlockType::TEMPERATE_DESERT },
+            { 0.6f,    0.8f,    0.33f,   0.66f,   eBlockType::SHRUBLAND },
+            { 0.6f,    0.8f,    0.66f,   FLT_MAX, eBlockType::TAIGA },
+            { 0.3f,    0.6f,    0.0f,    0.16f,   eBlockType::TEMPERATE_DESERT },
+            { 0.3f,    0.6f,    0.16f,   0.5f,    eBlockType::GRASSLAND },
+            { 0.3f,    0.6f,    0.5f,    0.83f,   eBlockType::TEMPERATE_DECIDUOUS_FOREST },
+            { 0.3f,    0.6f,    0.83f,   FLT_MAX, eBlockType::TEMPERATE_RAIN_FOREST },
+            { 0.12f,   0.3f,    0.0f,    0.16f,   eBlockType::SUBTROPICAL_DESERT },
+            { 0.12f,   0.3f,    0.16f,   0.33f,   eBlockType::GRASSLAND },
+            { 0.12f,   0.3f,    0.33f,   0.66f,   eBlockType::TROPICAL_SEASONAL_FOREST },
+            { 0.12f,   0.3f,    0.66f,   FLT_MAX, eBlockType::TROPICAL_RAIN_FOREST },
+        };
+
+        /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+          Method:   BiomeClassifier::BuildTable
+
+          Summary:  Builds the table of a list of regions. A cell takes
+                    the biome of the first region holding its center,
+                    GRASSLAND if none does
+
+          Args:     const BiomeRegion* pRegions
+                      Regions, in order of priority
+                    size_t uNumRegions
+                      Number of regions
+
+          Returns:  Table
+                      Biome of each cell, row by row along the height
+        M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+        static constexpr Table BuildTable(_In_reads_(uNumRegions) const BiomeRegion* pRegions, _In_ size_t uNumRegions)
+        {
+            Table table{};
+            for (UINT uHeightIdx = 0u; uHeightIdx < RESOLUTION; ++uHeightIdx)
+            {
+                const FLOAT height = (static_cast<FLOAT>(uHeightIdx) + 0.5f) / STEPS_PER_UNIT;
+                for (UINT uMoistureIdx = 0u; uMoistureIdx < RESOLUTION; ++uMoistureIdx)
+                {
+                    const FLOAT moisture = (static_cast<FLOAT>(uMoistureIdx) + 0.5f) / STEPS_PER_UNIT;
+                    eBlockType blockType = eBlockType::GRASSLAND;
+                    for (size_t uRegionIdx = 0u; uRegionIdx < uNumRegions; ++uRegionIdx)
+                    {
+                        const BiomeRegion& region = pRegions[uRegionIdx];
+                        if (height >= region.MinHeight && height < region.MaxHeight && moisture >= region.MinMoisture && moisture < region.MaxMoisture)
+                        {
+                            blockType = region.BlockType;
+                            break;
+                        }
+                    }
+                    table[static_cast<size_t>(uHeightIdx) * RESOLUTION + uMoistureIdx] = blockType;
+                }
+            }
+
+            return table;
+        }
+
+        static const Table DEFAULT_TABLE;
+
+    public:
+        BiomeClassifier();
+        BiomeClassifier(const BiomeClassifier& other) = delete;
+        BiomeClassifier(BiomeClassifier&& other) = delete;
+        BiomeClassifier& operator=(const BiomeClassifier& other) = delete;
+        BiomeClassifier& operator=(BiomeClassifier&& other) = delete;
+        ~BiomeClassifier() = default;
+
+        void SetRegions(_In_reads_(uNumRegions) const BiomeRegion* pRegions, _In_ size_t uNumRegions);
+
+        eBlockType Classify(_In_ FLOAT height, _In_ FLOAT moisture) const;
+        void ClassifyRow(_In_reads_(uNumColumns) const FLOAT* pHeights, _In_reads_(uNumColumns) const FLOAT* pMoistures, _In_ UINT uNumColumns, _Out_writes_(uNumColumns) eBlockType* pBlockTypes) const;
+
+        const Table& GetTable() const;
+
+    private:
+        static UINT quantize(_In_ FLOAT value);
+
+    private:
+        Table m_table;
+    };
+
+    // Built by the compiler, BuildTable needs the class to be complete
+    inline constexpr const BiomeClassifier::Table BiomeClassifier::DEFAULT_TABLE = BiomeClassifier::BuildTable(BiomeClassifier::DEFAULT_REGIONS, std::size(BiomeClassifier::DEFAULT_REGIONS));
+}
+
@@ -0,0 +1,746 @@
+#include "Scene/ChunkCache.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // ! _WIN32
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ChunkCache::ChunkCache
+
+      Summary:  Constructor. Starts the thread writing the chunks
+
+      Args:     const std::filesystem::path& directory
+                  Directory of the cache, created on the first write
+                UINT64 uFingerprint
+                  Fingerprint of the generator of the chunks
+                UINT uHeight
+                  Number of cubes of the highest column of the map
+
+      Modifies: [m_directory, m_uFingerprint, m_uHeight, m_regionMutex,
+                 m_regions, m_writeMutex, m_writeCondition,
+                 m_flushCondition, m_aWrites, m_bStop, m_uNumHits,
+                 m_uNumMisses, m_writeThread].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ChunkCache::ChunkCache(_In_ const std::filesystem::path& directory, _In_ UINT64 uFingerprint, _In_ UINT uHeight)
+        : m_directory()
+        , m_uFingerprint(uFingerprint)
+        , m_uHeight(uHeight)
+        , m_regionMutex()
+        , m_regions()
+        , m_writeMutex()
+        , m_writeCondition()
+        , m_flushCondition()
+        , m_aWrites()
+        , m_bStop(FALSE)
+        , m_uNumHits(0u)
+        , m_uNumMisses(0u)
+        , m_writeThread()
+    {
+        CHAR szName[32];
+        std::snprintf(szName, sizeof(szName), "%016llx-%u", static_cast<unsigned long long>(uFingerprint), uHeight);
+        m_directory = directory / szName;
+
+        m_writeThread = std::thread(&ChunkCache::work, this);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ChunkCache::~ChunkCache
+
+      Summary:  Destructor. Writes the queued chunks, stops the thread
+                writing them and closes the regions
+
+      Modifies: [m_bStop, m_writeThread, m_regions].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ChunkCache::~ChunkCache()
+    {
+        Flush();
+
+        {
+            std::lock_guard<std::mutex> lock(m_writeMutex);
+            m_bStop = TRUE;
+        }
+        m_writeCondition.notify_all();
+
+        m_writeThread.join();
+
+        for (std::pair<const UINT64, std::unique_ptr<Region>>& region : m_regions)
+        {
+            unmapRegion(*region.second);
+#ifdef _WIN32
+            if (region.second->hFile != INVALID_HANDLE_VALUE)
+            {
+                CloseHandle(region.second->hFile);
+            }
+#else
+            if (region.second->iFile >= 0)
+            {
+                close(region.second->iFile);
+            }
+#endif // _WIN32
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ChunkCache::Load
+
+      Summary:  Reads the columns of a chunk, from the queue when it is
+                not written yet, otherwise from its region file. Safe
+                to call from several threads
+
+      Args:     UINT uChunkX, UINT uChunkZ
+                  Chunk column and row
+                WORD* pHeights
+                  Receives the number of cubes of each column, row by
+                  row
+                eBlockType* pBlockTypes
+                  Receives the block type of each column, row by row
+
+      Modifies: [m_uNumHits, m_uNumMisses, pHeights, pBlockTypes].
+
+      Returns:  BOOL
+                  TRUE if the chunk was cached and is intact
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL ChunkCache::Load(_In_ UINT uChunkX, _In_ UINT uChunkZ, _Out_writes_(CHUNK_SIZE * CHUNK_SIZE) WORD* pHeights, _Out_writes_(CHUNK_SIZE * CHUNK_SIZE) eBlockType* pBlockTypes)
+    {
+        BOOL bLoaded = FALSE;
+        BOOL bQueued = FALSE;
+        {
+            std::lock_guard<std::mutex> lock(m_writeMutex);
+            for (const Write& write : m_aWrites)
+            {
+                if (write.uChunkX == uChunkX && write.uChunkZ == uChunkZ)
+                {
+                    bQueued = TRUE;
+                    bLoaded = Decompress(write.aData.data(), write.aData.size(), pHeights, pBlockTypes);
+                    break;
+                }
+            }
+        }
+
+        if (!bQueued)
+        {
+            bLoaded = readChunk(uChunkX, uChunkZ, pHeights, pBlockTypes);
+        }
+
+        ++(bLoaded ? m_uNumHits : m_uNumMisses);
+        return bLoaded;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ChunkCache::Store
+
+      Summary:  Compresses the columns of a chunk and queues them for
+                the thread of the cache, without waiting for the write.
+                Safe to call from several threads
+
+      Args:     UINT uChunkX, UINT uChunkZ
+                  Chunk column and row
+                const WORD* pHeights
+                  Number of cubes of each column, row by row
+                const eBlockType* pBlockTypes
+                  Block type of each column, row by row
+
+      Modifies: [m_aWrites].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void ChunkCache::Store(_In_ UINT uChunkX, _In_ UINT uChunkZ, _In_reads_(CHUNK_SIZE * CHUNK_SIZE) const WORD* pHeights, _In_reads_(CHUNK_SIZE * CHUNK_SIZE) const eBlockType* pBlockTypes)
+    {
+        Write write = { .uChunkX = uChunkX, .uChunkZ = uChunkZ, .aData = std::vector<BYTE>() };
+        Compress(pHeights, pBlockTypes, write.aData);
+
+        {
+            std::lock_guard<std::mutex> lock(m_writeMutex);
+            m_aWrites.push_back(std::move(write));
+        }
+        m_writeCondition.notify_one();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ChunkCache::Flush
+
+      Summary:  Waits until every queued chunk is written
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void ChunkCache::Flush()
+    {
+        std::unique_lock<std::mutex> lock(m_writeMutex);
+        m_flushCondition.wait(lock, [this] { return m_aWrites.empty(); });
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ChunkCache::GetNumHits
+
+      Summary:  Returns the number of chunks Load found
+
+      Returns:  UINT
+                  Number of hits
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT ChunkCache::GetNumHits() const
+    {
+        return m_uNumHits.load();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ChunkCache::GetNumMisses
+
+      Summary:  Returns the number of chunks Load did not find or
+                found damaged
+
+      Returns:  UINT
+                  Number of misses
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT ChunkCache::GetNumMisses() const
+    {
+        return m_uNumMisses.load();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ChunkCache::work
+
+      Summary:  Loop of the thread of the cache. Writes the queued
+                chunks in order. A chunk leaves the queue once it is
+                written, so Load always finds it in one of them. A
+                chunk that cannot be written is dropped, it is
+                generated again next time
+
+      Modifies: [m_aWrites].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void ChunkCache::work()
+    {
+        std::unique_lock<std::mutex> lock(m_writeMutex);
+        for (;;)
+        {
+            m_writeCondition.wait(lock, [this] { return m_bStop || !m_aWrites.empty(); });
+            if (m_aWrites.empty())
+            {
+                return;
+            }
+
+            // Store only appends, so the front stays valid without the lock
+            const Write& write = m_aWrites.front();
+            lock.unlock();
+            writeChunk(write);
+            lock.lock();
+
+            m_aWrites.pop_front();
+            if (m_aWrites.empty())
+            {
+                m_flushCondition.notify_all();
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ChunkCache::readChunk
+
+      Summary:  Reads a chunk from the view of its region under a
+                shared lock. The region is only mapped again, under
+                the exclusive lock, when it is not mapped yet or the
+                chunk is not in the view, which is the case of chunks
+                written after it was mapped
+
+      Args:     UINT uChunkX, UINT uChunkZ
+                  Chunk column and row
+                WORD* pHeights
+                  Receives the number of cubes of each column
+                eBlockType* pBlockTypes
+                  Receives the block type of each column
+
+      Modifies: [m_regions, pHeights, pBlockTypes].
+
+      Returns:  BOOL
+                  TRUE if the chunk is in its region and intact
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL ChunkCache::readChunk(_In_ UINT uChunkX, _In_ UINT uChunkZ, _Out_writes_(CHUNK_SIZE * CHUNK_SIZE) WORD* pHeights, _Out_writes_(CHUNK_SIZE * CHUNK_SIZE) eBlockType* pBlockTypes)
+    {
+        Region& region = getRegion(uChunkX, uChunkZ);
+        const UINT uEntryIdx = getEntryIdx(uChunkX, uChunkZ);
+        {
+            std::shared_lock<std::shared_mutex> lock(region.mutex);
+            if (region.pView && readMappedChunk(region.pView, region.uViewSize, uEntryIdx, pHeights, pBlockTypes))
+            {
+                return TRUE;
+            }
+        }
+
+        std::lock_guard<std::shared_mutex> lock(region.mutex);
+        mapRegion(region);
+
+        return region.pView && readMappedChunk(region.pView, region.uViewSize, uEntryIdx, pHeights, pBlockTypes);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ChunkCache::readMappedChunk
+
+      Summary:  Validates the header of a mapped region and reads a
+                chunk from it, checking its entry against the size of
+                the file
+
+      Args:     const BYTE* pView
+                  View of the region file
+                size_t uSize
+                  Size of the file
+                UINT uEntryIdx
+                  Entry of the chunk in the region
+                WORD* pHeights
+                  Receives the number of cubes of each column
+                eBlockType* pBlockTypes
+                  Receives the block type of each column
+
+      Modifies: [pHeights, pBlockTypes].
+
+      Returns:  BOOL
+                  TRUE if the chunk is in the region and intact
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL ChunkCache::readMappedChunk(_In_reads_(uSize) const BYTE* pView, _In_ size_t uSize, _In_ UINT uEntryIdx, _Out_writes_(CHUNK_SIZE * CHUNK_SIZE) WORD* pHeights, _Out_writes_(CHUNK_SIZE * CHUNK_SIZE) eBlockType* pBlockTypes) const
+    {
+        if (uSize < sizeof(ChunkRegionHeader) + sizeof(ChunkRegionEntry) * REGION_SIZE * REGION_SIZE)
+        {
+            return FALSE;
+        }
+
+        ChunkRegionHeader header;
+        memcpy(&header, pView, sizeof(header));
+        if (memcmp(header.Magic, MAGIC, sizeof(MAGIC)) != 0 || header.Version != VERSION || header.Fingerprint != m_uFingerprint || header.Height != m_uHeight)
+        {
+            return FALSE;
+        }
+
+        ChunkRegionEntry entry;
+        memcpy(&entry, pView + sizeof(ChunkRegionHeader) + sizeof(ChunkRegionEntry) * uEntryIdx, sizeof(entry));
+        if (entry.Size == 0u || static_cast<UINT64>(entry.Offset) + entry.Size > uSize)
+        {
+            return FALSE;
+        }
+
+        return Decompress(pView + entry.Offset, entry.Size, pHeights, pBlockTypes);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ChunkCache::writeChunk
+
+      Summary:  Appends a compressed chunk to its region file and then
+                points its entry at it. Only the thread of the cache
+                writes, and no entry points past the chunks already
+                written, so the chunk is appended without the lock of
+                the region and the lock is only taken to patch the
+                entry. A region that fails to write is opened again
+                for the next chunk
+
+      Args:     const Write& write
+                  Compressed chunk
+
+      Modifies: [m_regions].
+
+      Returns:  BOOL
+                  TRUE if the chunk was written
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL ChunkCache::writeChunk(_In_ const Write& write)
+    {
+        Region& region = getRegion(write.uChunkX, write.uChunkZ);
+        if (!region.file.is_open() && !openRegionFile(region))
+        {
+            return FALSE;
+        }
+
+        region.file.seekp(0, std::ios::end);
+        const UINT64 uOffset = static_cast<UINT64>(region.file.tellp());
+        if (region.file.fail() || uOffset + write.aData.size() > UINT_MAX)
+        {
+            region.file.close();
+            return FALSE;
+        }
+
+        region.file.write(reinterpret_cast<const char*>(write.aData.data()), static_cast<std::streamsize>(write.aData.size()));
+        region.file.flush();
+        if (!region.file.fail())
+        {
+            const ChunkRegionEntry entry = { .Offset = static_cast<UINT>(uOffset), .Size = static_cast<UINT>(write.aData.size()) };
+
+            std::lock_guard<std::shared_mutex> lock(region.mutex);
+            region.file.seekp(static_cast<std::streamoff>(sizeof(ChunkRegionHeader) + sizeof(ChunkRegionEntry) * getEntryIdx(write.uChunkX, write.uChunkZ)));
+            region.file.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+            region.file.flush();
+        }
+
+        if (region.file.fail())
+        {
+            region.file.close();
+            return FALSE;
+        }
+
+        return TRUE;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ChunkCache::openRegionFile
+
+      Summary:  Opens the region file of the thread of the cache,
+                creating it with an empty table when it does not exist,
+                is shorter than its table or is not a region of this
+                cache. The view is unmapped before the file is cut
+
+      Args:     Region& region
+                  Region to open
+
+      Modifies: [region].
+
+      Returns:  BOOL
+                  TRUE if the region is open
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL ChunkCache::openRegionFile(_Inout_ Region& region) const
+    {
+        const ChunkRegionHeader header =
+        {
+            .Magic = { MAGIC[0], MAGIC[1], MAGIC[2], MAGIC[3] },
+            .Version = VERSION,
+            .Fingerprint = m_uFingerprint,
+            .Height = m_uHeight,
+            .Reserved = 0u
+        };
+        const std::vector<ChunkRegionEntry> aEntries(static_cast<size_t>(REGION_SIZE) * REGION_SIZE, ChunkRegionEntry{ .Offset = 0u, .Size = 0u });
+
+        std::error_code error;
+        std::filesystem::create_directories(m_directory, error);
+
+        region.file.open(region.path, std::ios::binary | std::ios::in | std::ios::out);
+        ChunkRegionHeader fileHeader = {};
+        if (region.file.is_open())
+        {
+            region.file.read(reinterpret_cast<char*>(&fileHeader), sizeof(fileHeader));
+            region.file.seekg(0, std::ios::end);
+            if (!region.file.fail() && memcmp(&fileHeader, &header, sizeof(header)) == 0 && static_cast<size_t>(region.file.tellg()) >= sizeof(header) + sizeof(ChunkRegionEntry) * aEntries.size())
+            {
+                return TRUE;
+            }
+        }
+
+        std::lock_guard<std::shared_mutex> lock(region.mutex);
+        unmapRegion(region);
+
+        region.file.close();
+        region.file.open(region.path, std::ios::binary | std::ios::in | std::ios::out | std::ios::trunc);
+        if (!region.file.is_open())
+        {
+            return FALSE;
+        }
+
+        region.file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        region.file.write(reinterpret_cast<const char*>(aEntries.data()), static_cast<std::streamsize>(sizeof(ChunkRegionEntry) * aEntries.size()));
+        region.file.flush();
+        if (region.file.fail())
+        {
+            region.file.close();
+            return FALSE;
+        }
+
+        return TRUE;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ChunkCache::getRegion
+
+      Summary:  Returns the region of a chunk, adding it unopened the
+                first time. Regions stay until the cache is destroyed
+
+      Args:     UINT uChunkX, UINT uChunkZ
+                  Chunk column and row
+
+      Modifies: [m_regions].
+
+      Returns:  Region&
+                  Region of the chunk
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ChunkCache::Region& ChunkCache::getRegion(_In_ UINT uChunkX, _In_ UINT uChunkZ)
+    {
+        const UINT64 uKey = (static_cast<UINT64>(uChunkX / REGION_SIZE) << 32u) | (uChunkZ / REGION_SIZE);
+
+        std::lock_guard<std::mutex> lock(m_regionMutex);
+        std::unique_ptr<Region>& region = m_regions[uKey];
+        if (!region)
+        {
+            region = std::make_unique<Region>();
+            region->path = getRegionPath(uChunkX, uChunkZ);
+#ifdef _WIN32
+            region->hFile = INVALID_HANDLE_VALUE;
+            region->hMapping = nullptr;
+#else
+            region->iFile = -1;
+#endif // _WIN32
+            region->pView = nullptr;
+            region->uViewSize = 0u;
+        }
+
+        return *region;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ChunkCache::getRegionPath
+
+      Summary:  Returns the path of the region file holding a chunk
+
+      Args:     UINT uChunkX, UINT uChunkZ
+                  Chunk column and row
+
+      Returns:  std::filesystem::path
+                  r.<region x>.<region z>.vxr in the directory of the
+                  cache
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::filesystem::path ChunkCache::getRegionPath(_In_ UINT uChunkX, _In_ UINT uChunkZ) const
+    {
+        return m_directory / ("r." + std::to_string(uChunkX / REGION_SIZE) + "." + std::to_string(uChunkZ / REGION_SIZE) + EXTENSION);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ChunkCache::getEntryIdx
+
+      Summary:  Returns the index of the entry of a chunk in the table
+                of its region
+
+      Args:     UINT uChunkX, UINT uChunkZ
+                  Chunk column and row
+
+      Returns:  UINT
+                  Entry of the chunk, row by row of chunks
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT ChunkCache::getEntryIdx(_In_ UINT uChunkX, _In_ UINT uChunkZ)
+    {
+        return (uChunkZ % REGION_SIZE) * REGION_SIZE + uChunkX % REGION_SIZE;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ChunkCache::mapRegion
+
+      Summary:  Opens the region file read-only if it is not yet, and
+                maps all of it again when its size changed since it was
+                mapped. The view is shared with the file, so entries
+                patched in the mapped part show without mapping again.
+                Called under the exclusive lock of the region
+
+      Args:     Region& region
+                  Region to map
+
+      Modifies: [region].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void ChunkCache::mapRegion(_Inout_ Region& region)
+    {
+#ifdef _WIN32
+        if (region.hFile == INVALID_HANDLE_VALUE)
+        {
+            region.hFile = CreateFileW(region.path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, nullptr);
+            if (region.hFile == INVALID_HANDLE_VALUE)
+            {
+                return;
+            }
+        }
+
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(region.hFile, &fileSize) || static_cast<size_t>(fileSize.QuadPart) == region.uViewSize)
+        {
+            return;
+        }
+
+        unmapRegion(region);
+        if (fileSize.QuadPart > 0)
+        {
+            region.hMapping = CreateFileMappingW(region.hFile, nullptr, PAGE_READONLY, 0u, 0u, nullptr);
+            if (region.hMapping)
+            {
+                region.pView = static_cast<const BYTE*>(MapViewOfFile(region.hMapping, FILE_MAP_READ, 0u, 0u, 0u));
+                region.uViewSize = region.pView ? static_cast<size_t>(fileSize.QuadPart) : 0u;
+            }
+        }
+#else
+        if (region.iFile < 0)
+        {
+            region.iFile = open(region.path.c_str(), O_RDONLY);
+            if (region.iFile < 0)
+            {
+                return;
+            }
+        }
+
+        struct stat fileStat;
+        if (fstat(region.iFile, &fileStat) != 0 || static_cast<size_t>(fileStat.st_size) == region.uViewSize)
+        {
+            return;
+        }
+
+        unmapRegion(region);
+        if (fileStat.st_size > 0)
+        {
+            void* pView = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_SHARED, region.iFile, 0);
+            if (pView != MAP_FAILED)
+            {
+                region.pView = static_cast<const BYTE*>(pView);
+                region.uViewSize = static_cast<size_t>(fileStat.st_size);
+            }
+        }
+#endif // _WIN32
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ChunkCache::unmapRegion
+
+      Summary:  Unmaps the view of a region, keeping its file open.
+                Called under the exclusive lock of the region
+
+      Args:     Region& region
+                  Region to unmap
+
+      Modifies: [region].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void ChunkCache::unmapRegion(_Inout_ Region& region)
+    {
+#ifdef _WIN32
+        if (region.pView)
+        {
+            UnmapViewOfFile(region.pView);
+        }
+        if (region.hMapping)
+        {
+            CloseHandle(region.hMapping);
+            region.hMapping = nullptr;
+        }
+#else
+        if (region.pView)
+        {
+            munmap(const_cast<BYTE*>(region.pView), region.uViewSize);
+        }
+#endif // _WIN32
+        region.pView = nullptr;
+        region.uViewSize = 0u;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ChunkCache::Compress
+
+      Summary:  Compresses the columns of a chunk. The heights are
+                stored as the zigzag-encoded difference to the previous
+                column, 7 bits per byte with the high bit set on every
+                byte but the last, so the gentle slopes of a height
+                field take one byte per column. The block types follow
+                as runs of at most 255 columns, a length and a type
+
+      Args:     const WORD* pHeights
+                  Number of cubes of each column, row by row
+                const eBlockType* pBlockTypes
+                  Block type of each column, row by row
+                std::vector<BYTE>& aData
+                  Receives the compressed chunk
+
+      Modifies: [aData].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void ChunkCache::Compress(_In_reads_(CHUNK_SIZE * CHUNK_SIZE) const WORD* pHeights, _In_reads_(CHUNK_SIZE * CHUNK_SIZE) const eBlockType* pBlockTypes, _Out_ std::vector<BYTE>& aData)
+    {
+        constexpr const UINT NUM_COLUMNS = CHUNK_SIZE * CHUNK_SIZE;
+
+        aData.clear();
+        aData.reserve(NUM_COLUMNS + NUM_COLUMNS / 4u);
+
+        INT iPrevHeight = 0;
+        for (UINT i = 0u; i < NUM_COLUMNS; ++i)
+        {
+            const INT iDelta = static_cast<INT>(pHeights[i]) - iPrevHeight;
+            UINT uZigzag = (static_cast<UINT>(iDelta) << 1u) ^ static_cast<UINT>(iDelta >> 31);
+            while (uZigzag >= 0x80u)
+            {
+                aData.push_back(static_cast<BYTE>(uZigzag | 0x80u));
+                uZigzag >>= 7u;
+            }
+            aData.push_back(static_cast<BYTE>(uZigzag));
+            iPrevHeight = static_cast<INT>(pHeights[i]);
+        }
+
+        for (UINT i = 0u; i < NUM_COLUMNS;)
+        {
+            UINT uRunLength = 1u;
+            while (i + uRunLength < NUM_COLUMNS && uRunLength < 0xFFu && pBlockTypes[i + uRunLength] == pBlockTypes[i])
+            {
+                ++uRunLength;
+            }
+
+            aData.push_back(static_cast<BYTE>(uRunLength));
+            aData.push_back(static_cast<BYTE>(pBlockTypes[i]));
+            i += uRunLength;
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ChunkCache::Decompress
+
+      Summary:  Decompresses the columns of a chunk written by
+                Compress, rejecting data that does not decode to
+                exactly one chunk of valid heights and block types
+
+      Args:     const BYTE* pData
+                  Compressed chunk
+                size_t uSize
+                  Size of the compressed chunk
+                WORD* pHeights
+                  Receives the number of cubes of each column
+                eBlockType* pBlockTypes
+                  Receives the block type of each column
+
+      Modifies: [pHeights, pBlockTypes].
+
+      Returns:  BOOL
+                  TRUE if the data is a valid chunk
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL ChunkCache::Decompress(_In_reads_(uSize) const BYTE* pData, _In_ size_t uSize, _Out_writes_(CHUNK_SIZE * CHUNK_SIZE) WORD* pHeights, _Out_writes_(CHUNK_SIZE * CHUNK_SIZE) eBlockType* pBlockTypes)
+    {
+        constexpr const UINT NUM_COLUMNS = CHUNK_SIZE * CHUNK_SIZE;
+
+        size_t uPos = 0u;
+        INT iHeight = 0;
+        for (UINT i = 0u; i < NUM_COLUMNS; ++i)
+        {
+            UINT uZigzag = 0u;
+            for (UINT uShift = 0u;; uShift += 7u)
+            {
+                if (uPos >= uSize || uShift > 28u)
+                {
+                    return FALSE;
+                }
+
+                const BYTE byte = pData[uPos++];
+                uZigzag |= static_cast<UINT>(byte & 0x7Fu) << uShift;
+                if ((byte & 0x80u) == 0u)
+                {
+                    break;
+                }
+            }
+
+            iHeight += static_cast<INT>(uZigzag >> 1u) ^ -static_cast<INT>(uZigzag & 1u);
+            if (iHeight < 0 || iHeight > 0xFFFF)
+            {
+                return FALSE;
+            }
+            pHeights[i] = static_cast<WORD>(iHeight);
+        }
+
+        for (UINT i = 0u; i < NUM_COLUMNS;)
+        {
+            if (uPos + 2u > uSize)
+            {
+                return FALSE;
+            }
+
+            const UINT uRunLength = pData[uPos];
+            const BYTE blockType = pData[uPos + 1u];
+            uPos += 2u;
+            if (uRunLength == 0u || i + uRunLength > NUM_COLUMNS || blockType < static_cast<BYTE>(eBlockType::GRASSLAND) || blockType >= static_cast<BYTE>(eBlockType::COUNT))
+            {
+                return FALSE;
+            }
+
+            std::fill(pBlockTypes + i, pBlockTypes + i + uRunLength, static_cast<eBlockType>(blockType));
+            i += uRunLength;
+        }
+
+        return uPos == uSize;
+    }
+}
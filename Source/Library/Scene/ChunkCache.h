@@ -0,0 +1,193 @@
+/*+===================================================================
+  File:      CHUNKCACHE.H
+
+  Summary:   ChunkCache header file contains declarations of the
+             region file format and the ChunkCache class that keeps
+             generated chunks on disk, so they are read back instead
+             of generated again.
+
+  Classes: ChunkCache
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Platform.h"
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+        Struct:   ChunkRegionHeader
+        Summary:  Header at the beginning of a region file. It is
+                  followed by REGION_SIZE * REGION_SIZE ChunkRegionEntry
+                  entries, row by row of chunks, then by the compressed
+                  chunks in the order they were written
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct ChunkRegionHeader
+    {
+        CHAR Magic[4];
+        UINT Version;
+        UINT64 Fingerprint;
+        UINT Height;
+        UINT Reserved;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+        Struct:   ChunkRegionEntry
+        Summary:  Offset from the beginning of a region file and size of
+                  a compressed chunk, 0 bytes while it is not written
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct ChunkRegionEntry
+    {
+        UINT Offset;
+        UINT Size;
+    };
+
+    static_assert(sizeof(ChunkRegionHeader) == 24u, "ChunkRegionHeader is part of the file format");
+    static_assert(sizeof(ChunkRegionEntry) == 8u, "ChunkRegionEntry is part of the file format");
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    ChunkCache
+
+      Summary:  Cache of the columns of generated chunks, keyed by the
+                fingerprint of the generator, the height of the map and
+                the chunk. The chunks of REGION_SIZE x REGION_SIZE
+                chunks share a region file, in a directory named after
+                the fingerprint and the height, so a generator with
+                other parameters, seed or version never reads them and
+                stale regions are left alone rather than overwritten.
+                A chunk is compressed as the zigzag deltas of its
+                heights in variable-length bytes and the runs of its
+                block types. Regions stay memory-mapped while the cache
+                lives, and chunks are written by a thread of the cache
+                after Store returns. Loads share the lock of a region,
+                the thread appends a chunk without it and only takes it
+                to patch the table, so chunks load in parallel with
+                each other and with the writes. Chunks still waiting to
+                be written are loaded from memory. A region is only
+                written by its cache while it is open
+
+      Methods:  Load
+                  Reads the columns of a chunk
+                Store
+                  Queues the columns of a chunk to be written
+                Flush
+                  Waits until every queued chunk is written
+                GetNumHits
+                  Returns the number of chunks loaded
+                GetNumMisses
+                  Returns the number of chunks not found
+                Compress
+                  Compresses the columns of a chunk
+                Decompress
+                  Decompresses the columns of a chunk
+                ChunkCache
+                  Constructor.
+                ~ChunkCache
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class ChunkCache final
+    {
+    public:
+        static constexpr const CHAR MAGIC[4] = { 'V', 'X', 'R', 'G' };
+        static constexpr const UINT VERSION = 1u;
+        static constexpr const UINT CHUNK_SIZE = 32u;
+        static constexpr const UINT REGION_SIZE = 32u;
+        static constexpr const CHAR EXTENSION[] = ".vxr";
+
+    public:
+        ChunkCache(_In_ const std::filesystem::path& directory, _In_ UINT64 uFingerprint, _In_ UINT uHeight);
+        ChunkCache(const ChunkCache& other) = delete;
+        ChunkCache(ChunkCache&& other) = delete;
+        ChunkCache& operator=(const ChunkCache& other) = delete;
+        ChunkCache& operator=(ChunkCache&& other) = delete;
+        ~ChunkCache();
+
+        BOOL Load(_In_ UINT uChunkX, _In_ UINT uChunkZ, _Out_writes_(CHUNK_SIZE * CHUNK_SIZE) WORD* pHeights, _Out_writes_(CHUNK_SIZE * CHUNK_SIZE) eBlockType* pBlockTypes);
+        void Store(_In_ UINT uChunkX, _In_ UINT uChunkZ, _In_reads_(CHUNK_SIZE * CHUNK_SIZE) const WORD* pHeights, _In_reads_(CHUNK_SIZE * CHUNK_SIZE) const eBlockType* pBlockTypes);
+        void Flush();
+
+        UINT GetNumHits() const;
+        UINT GetNumMisses() const;
+
+        static void Compress(_In_reads_(CHUNK_SIZE * CHUNK_SIZE) const WORD* pHeights, _In_reads_(CHUNK_SIZE * CHUNK_SIZE) const eBlockType* pBlockTypes, _Out_ std::vector<BYTE>& aData);
+        static BOOL Decompress(_In_reads_(uSize) const BYTE* pData, _In_ size_t uSize, _Out_writes_(CHUNK_SIZE * CHUNK_SIZE) WORD* pHeights, _Out_writes_(CHUNK_SIZE * CHUNK_SIZE) eBlockType* pBlockTypes);
+
+    private:
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+            Struct:   Write
+            Summary:  Compressed chunk waiting to be written
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct Write
+        {
+            UINT uChunkX;
+            UINT uChunkZ;
+            std::vector<BYTE> aData;
+        };
+
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+            Struct:   Region
+            Summary:  Region file with its read-only view, mapped again
+                      when a chunk is past its end, and the stream the
+                      thread of the cache writes it with. The view is
+                      read under a shared lock, the lock is exclusive
+                      only to patch the table or replace the view
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct Region
+        {
+            std::filesystem::path path;
+            std::shared_mutex mutex;
+#ifdef _WIN32
+            HANDLE hFile;
+            HANDLE hMapping;
+#else
+            int iFile;
+#endif // _WIN32
+            const BYTE* pView;
+            size_t uViewSize;
+            std::fstream file;
+        };
+
+        void work();
+        BOOL readChunk(_In_ UINT uChunkX, _In_ UINT uChunkZ, _Out_writes_(CHUNK_SIZE * CHUNK_SIZE) WORD* pHeights, _Out_writes_(CHUNK_SIZE * CHUNK_SIZE) eBlockType* pBlockTypes);
+        BOOL readMappedChunk(_In_reads_(uSize) const BYTE* pView, _In_ size_t uSize, _In_ UINT uEntryIdx, _Out_writes_(CHUNK_SIZE * CHUNK_SIZE) WORD* pHeights, _Out_writes_(CHUNK_SIZE * CHUNK_SIZE) eBlockType* pBlockTypes) const;
+        BOOL writeChunk(_In_ const Write& write);
+        BOOL openRegionFile(_Inout_ Region& region) const;
+        Region& getRegion(_In_ UINT uChunkX, _In_ UINT uChunkZ);
+        std::filesystem::path getRegionPath(_In_ UINT uChunkX, _In_ UINT uChunkZ) const;
+
+        static UINT getEntryIdx(_In_ UINT uChunkX, _In_ UINT uChunkZ);
+        static void mapRegion(_Inout_ Region& region);
+        static void unmapRegion(_Inout_ Region& region);
+
+    private:
+        std::filesystem::path m_directory;
+        UINT64 m_uFingerprint;
+        UINT m_uHeight;
+        std::mutex m_regionMutex;
+        std::unordered_map<UINT64, std::unique_ptr<Region>> m_regions;
+        std::mutex m_writeMutex;
+        std::condition_variable m_writeCondition;
+        std::condition_variable m_flushCondition;
+        std::deque<Write> m_aWrites;
+        BOOL m_bStop;
+        std::atomic<UINT> m_uNumHits;
+        std::atomic<UINT> m_uNumMisses;
+        std::thread m_writeThread;
+    };
+}
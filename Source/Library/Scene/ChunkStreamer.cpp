@@ -0,0 +1,555 @@
+#include "Scene/ChunkStreamer.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ChunkStreamer::ChunkStreamer
+
+      Summary:  Constructor. Starts the worker threads, each with a
+                generator of the seed that does not start threads, and
+                opens the cache of the generators
+
+      Args:     UINT uSeed
+                  Seed of the terrain
+                UINT uNumChunksX, UINT uNumChunksZ
+                  Number of chunks of the map along x and z
+                UINT uHeight
+                  Number of cubes of a column of height 1
+                FLOAT loadRadius
+                  Distance in chunks from the camera to the center of
+                  the chunks to load
+                FLOAT unloadRadius
+                  Distance in chunks beyond which chunks are evicted,
+                  at least loadRadius
+                UINT uMaxNumResident
+                  Budget of resident chunks, at least 1
+                const std::filesystem::path& cacheDirectory
+                  Directory of the chunk cache, empty for none
+                UINT uNumThreads
+                  Number of worker threads, at least 1
+
+      Modifies: [m_uNumChunksX, m_uNumChunksZ, m_uHeight, m_loadRadius,
+                 m_unloadRadius, m_uMaxNumResident, m_x, m_z,
+                 m_iCenterX, m_iCenterZ, m_residentChunks,
+                 m_requestedChunks, m_aReadyChunks, m_aGenerators,
+                 m_cache, m_aThreads, m_mutex, m_requestCondition, m_aRequests,
+                 m_aGeneratedChunks, m_aBuildRequests, m_aBuiltChunks,
+                 m_uNumBuilding, m_bStop].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ChunkStreamer::ChunkStreamer(_In_ UINT uSeed, _In_ UINT uNumChunksX, _In_ UINT uNumChunksZ, _In_ UINT uHeight, _In_ FLOAT loadRadius, _In_ FLOAT unloadRadius, _In_ UINT uMaxNumResident, _In_ const std::filesystem::path& cacheDirectory, _In_ UINT uNumThreads)
+        : m_uNumChunksX(uNumChunksX)
+        , m_uNumChunksZ(uNumChunksZ)
+        , m_uHeight(uHeight)
+        , m_loadRadius(loadRadius)
+        , m_unloadRadius(std::max(unloadRadius, loadRadius))
+        , m_uMaxNumResident(std::max(uMaxNumResident, 1u))
+        , m_x(0.0f)
+        , m_z(0.0f)
+        , m_iCenterX(INT_MIN)
+        , m_iCenterZ(INT_MIN)
+        , m_residentChunks()
+        , m_requestedChunks()
+        , m_aReadyChunks()
+        , m_aGenerators()
+        , m_cache()
+        , m_aThreads()
+        , m_mutex()
+        , m_requestCondition()
+        , m_aRequests()
+        , m_aGeneratedChunks()
+        , m_aBuildRequests()
+        , m_aBuiltChunks()
+        , m_uNumBuilding(0u)
+        , m_bStop(FALSE)
+    {
+        uNumThreads = std::max(uNumThreads, 1u);
+        m_aGenerators.reserve(uNumThreads);
+        for (UINT i = 0u; i < uNumThreads; ++i)
+        {
+            m_aGenerators.push_back(std::make_unique<TerrainGenerator>(uSeed, 1u));
+        }
+
+        if (!cacheDirectory.empty())
+        {
+            m_cache = std::make_unique<ChunkCache>(cacheDirectory, m_aGenerators.front()->GetFingerprint(), uHeight);
+        }
+
+        m_aThreads.reserve(uNumThreads);
+        for (UINT i = 0u; i < uNumThreads; ++i)
+        {
+            m_aThreads.emplace_back(&ChunkStreamer::work, this, std::ref(*m_aGenerators[i]));
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ChunkStreamer::~ChunkStreamer
+
+      Summary:  Destructor. Stops the worker threads once the chunks
+                they are generating or building are done, the queued
+                chunks are dropped
+
+      Modifies: [m_bStop, m_aThreads].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ChunkStreamer::~ChunkStreamer()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_bStop = TRUE;
+        }
+        m_requestCondition.notify_all();
+
+        for (std::thread& thread : m_aThreads)
+        {
+            thread.join();
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ChunkStreamer::Update
+
+      Summary:  Queues the chunks around the camera when it entered
+                another chunk, evicts the resident chunks beyond the
+                unload radius and promotes the nearest chunks that are
+                ready. A chunk is only promoted once a resident chunk
+                farther from the camera is evicted when the budget is
+                reached. The worker threads are never waited for, the
+                lock is only held to swap the queues
+
+      Args:     FLOAT x, FLOAT z
+                  Position of the camera, in columns of the map
+                UINT uMaxNumPromoted
+                  Number of chunks to promote at most
+                std::vector<StreamedChunk>& aPromoted
+                  Receives the chunks that became resident
+                std::vector<std::pair<UINT, UINT>>& aEvicted
+                  Receives the chunks that are no longer resident
+
+      Modifies: [m_x, m_z, m_iCenterX, m_iCenterZ, m_residentChunks,
+                 m_requestedChunks, m_aReadyChunks, m_aRequests,
+                 m_aGeneratedChunks].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void ChunkStreamer::Update(_In_ FLOAT x, _In_ FLOAT z, _In_ UINT uMaxNumPromoted, _Inout_ std::vector<StreamedChunk>& aPromoted, _Inout_ std::vector<std::pair<UINT, UINT>>& aEvicted)
+    {
+        m_x = x;
+        m_z = z;
+
+        const INT iCenterX = static_cast<INT>(std::floor(x / static_cast<FLOAT>(CHUNK_SIZE)));
+        const INT iCenterZ = static_cast<INT>(std::floor(z / static_cast<FLOAT>(CHUNK_SIZE)));
+        if (iCenterX != m_iCenterX || iCenterZ != m_iCenterZ)
+        {
+            m_iCenterX = iCenterX;
+            m_iCenterZ = iCenterZ;
+            requestChunks(iCenterX, iCenterZ);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            std::move(m_aGeneratedChunks.begin(), m_aGeneratedChunks.end(), std::back_inserter(m_aReadyChunks));
+            m_aGeneratedChunks.clear();
+        }
+
+        for (auto it = m_residentChunks.begin(); it != m_residentChunks.end();)
+        {
+            const UINT uChunkX = static_cast<UINT>(*it & 0xFFFFFFFFu);
+            const UINT uChunkZ = static_cast<UINT>(*it >> 32u);
+            if (getDistance(uChunkX, uChunkZ) > m_unloadRadius)
+            {
+                aEvicted.emplace_back(uChunkX, uChunkZ);
+                it = m_residentChunks.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+
+        // Nearest last, so promoting pops from the back
+        std::sort(m_aReadyChunks.begin(), m_aReadyChunks.end(),
+            [this](const StreamedChunk& a, const StreamedChunk& b)
+            {
+                return getDistance(a.ChunkX, a.ChunkZ) > getDistance(b.ChunkX, b.ChunkZ);
+            }
+        );
+
+        // The camera moved away from the chunks beyond the unload radius while they were generated
+        auto firstNear = std::find_if(m_aReadyChunks.begin(), m_aReadyChunks.end(),
+            [this](const StreamedChunk& chunk)
+            {
+                return getDistance(chunk.ChunkX, chunk.ChunkZ) <= m_unloadRadius;
+            }
+        );
+        for (auto it = m_aReadyChunks.begin(); it != firstNear; ++it)
+        {
+            m_requestedChunks.erase(getKey(it->ChunkX, it->ChunkZ));
+        }
+        m_aReadyChunks.erase(m_aReadyChunks.begin(), firstNear);
+
+        for (UINT uNumPromoted = 0u; uNumPromoted < uMaxNumPromoted && !m_aReadyChunks.empty();)
+        {
+            StreamedChunk& chunk = m_aReadyChunks.back();
+            const UINT64 uKey = getKey(chunk.ChunkX, chunk.ChunkZ);
+            m_requestedChunks.erase(uKey);
+
+            if (m_residentChunks.size() >= m_uMaxNumResident)
+            {
+                auto farthest = std::max_element(m_residentChunks.begin(), m_residentChunks.end(),
+                    [this](UINT64 uA, UINT64 uB)
+                    {
+                        return getDistance(static_cast<UINT>(uA & 0xFFFFFFFFu), static_cast<UINT>(uA >> 32u)) < getDistance(static_cast<UINT>(uB & 0xFFFFFFFFu), static_cast<UINT>(uB >> 32u));
+                    }
+                );
+
+                const UINT uFarthestX = static_cast<UINT>(*farthest & 0xFFFFFFFFu);
+                const UINT uFarthestZ = static_cast<UINT>(*farthest >> 32u);
+                if (getDistance(uFarthestX, uFarthestZ) <= getDistance(chunk.ChunkX, chunk.ChunkZ))
+                {
+                    m_aReadyChunks.pop_back();
+                    continue;
+                }
+
+                aEvicted.emplace_back(uFarthestX, uFarthestZ);
+                m_residentChunks.erase(farthest);
+            }
+
+            m_residentChunks.insert(uKey);
+            aPromoted.push_back(std::move(chunk));
+            m_aReadyChunks.pop_back();
+            ++uNumPromoted;
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ChunkStreamer::QueueBuild
+
+      Summary:  Queues a chunk for the worker threads to build, ahead
+                of the chunks to generate
+
+      Args:     StreamedChunkBuild&& build
+                  Columns of every level of detail of the chunk
+
+      Modifies: [m_aBuildRequests, m_uNumBuilding].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void ChunkStreamer::QueueBuild(_In_ StreamedChunkBuild&& build)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_aBuildRequests.push_back(std::move(build));
+            ++m_uNumBuilding;
+        }
+        m_requestCondition.notify_one();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ChunkStreamer::CollectBuilds
+
+      Summary:  Takes the chunks the worker threads built since the
+                last call, without waiting for the others
+
+      Args:     std::vector<StreamedChunkBuild>& aBuilt
+                  Receives the built chunks, in no particular order
+
+      Modifies: [m_aBuiltChunks, m_uNumBuilding].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void ChunkStreamer::CollectBuilds(_Inout_ std::vector<StreamedChunkBuild>& aBuilt)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_uNumBuilding -= static_cast<UINT>(m_aBuiltChunks.size());
+        std::move(m_aBuiltChunks.begin(), m_aBuiltChunks.end(), std::back_inserter(aBuilt));
+        m_aBuiltChunks.clear();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ChunkStreamer::IsResident
+
+      Summary:  Returns whether a chunk is resident
+
+      Args:     UINT uChunkX, UINT uChunkZ
+                  Chunk column and row
+
+      Returns:  BOOL
+                  TRUE if the chunk was promoted and not evicted since
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL ChunkStreamer::IsResident(_In_ UINT uChunkX, _In_ UINT uChunkZ) const
+    {
+        return m_residentChunks.contains(getKey(uChunkX, uChunkZ));
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ChunkStreamer::GetNumResident
+
+      Summary:  Returns the number of resident chunks
+
+      Returns:  UINT
+                  Number of resident chunks, at most the budget
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT ChunkStreamer::GetNumResident() const
+    {
+        return static_cast<UINT>(m_residentChunks.size());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ChunkStreamer::GetNumPending
+
+      Summary:  Returns the number of chunks queued, being generated
+                or ready but not promoted yet
+
+      Returns:  UINT
+                  Number of pending chunks
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT ChunkStreamer::GetNumPending() const
+    {
+        return static_cast<UINT>(m_requestedChunks.size());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ChunkStreamer::GetNumBuilding
+
+      Summary:  Returns the number of chunks queued, being built or
+                built but not collected yet
+
+      Returns:  UINT
+                  Number of builds
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT ChunkStreamer::GetNumBuilding() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_uNumBuilding;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ChunkStreamer::BuildChunk
+
+      Summary:  Builds the instances, or the greedy mesh, of every
+                level of detail of a chunk from its columns. The
+                border columns only cull the faces they cover, and the
+                cells and vertices are those of the whole level
+
+      Args:     StreamedChunkBuild& build
+                  Chunk whose levels hold their columns
+
+      Modifies: [build].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void ChunkStreamer::BuildChunk(_Inout_ StreamedChunkBuild& build)
+    {
+        for (UINT uLod = 0u; uLod < static_cast<UINT>(build.Levels.size()); ++uLod)
+        {
+            StreamedChunkLevel& level = build.Levels[uLod];
+            const UINT uWidth = level.Width + 2u;
+            const UINT uDepth = level.Depth + 2u;
+            const FLOAT cellSize = 2.0f * static_cast<FLOAT>(1u << uLod);
+            level.MinCorner = XMFLOAT3(0.0f, 0.0f, 0.0f);
+            level.MaxCorner = XMFLOAT3(0.0f, 0.0f, 0.0f);
+
+            if (build.GreedyMesh)
+            {
+                // The first column of the copy is the one before the chunk
+                GreedyMesher mesher(level.Columns.data(), uWidth, uDepth, build.NumBlockTypes);
+                mesher.Build(1u, 1u, level.Width + 1u, level.Depth + 1u, XMFLOAT3((static_cast<FLOAT>(level.BeginX) - 1.0f) * cellSize, 0.0f, (static_cast<FLOAT>(level.BeginZ) - 1.0f) * cellSize), cellSize);
+                level.Vertices = std::move(mesher.GetVertices());
+                level.Indices = std::move(mesher.GetIndices());
+                level.Ranges = std::move(mesher.GetRanges());
+
+                if (!level.Vertices.empty())
+                {
+                    level.MinCorner = level.Vertices.front().Position;
+                    level.MaxCorner = level.Vertices.front().Position;
+                    for (const SimpleVertex& vertex : level.Vertices)
+                    {
+                        level.MinCorner = XMFLOAT3(std::min(level.MinCorner.x, vertex.Position.x), std::min(level.MinCorner.y, vertex.Position.y), std::min(level.MinCorner.z, vertex.Position.z));
+                        level.MaxCorner = XMFLOAT3(std::max(level.MaxCorner.x, vertex.Position.x), std::max(level.MaxCorner.y, vertex.Position.y), std::max(level.MaxCorner.z, vertex.Position.z));
+                    }
+                }
+            }
+            else
+            {
+                VoxelInstanceBuilder builder(level.Columns.data(), uWidth, uDepth, build.NumBlockTypes);
+                builder.Build(uLod, 1u, 1u, level.Width + 1u, level.Depth + 1u, static_cast<INT>(level.BeginX) - 1, static_cast<INT>(level.BeginZ) - 1);
+                level.Instances = std::move(builder.GetInstances());
+
+                if (!level.Instances.empty())
+                {
+                    level.MinCorner = XMFLOAT3(static_cast<FLOAT>(level.BeginX) * cellSize, static_cast<FLOAT>(builder.GetMinHeight()) * cellSize, static_cast<FLOAT>(level.BeginZ) * cellSize);
+                    level.MaxCorner = XMFLOAT3(static_cast<FLOAT>(level.BeginX + level.Width) * cellSize, static_cast<FLOAT>(builder.GetMaxHeight()) * cellSize, static_cast<FLOAT>(level.BeginZ + level.Depth) * cellSize);
+                }
+            }
+
+            level.Columns.clear();
+            level.Columns.shrink_to_fit();
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ChunkStreamer::work
+
+      Summary:  Loop of a worker thread. Builds the queued chunks
+                first, as they already have columns waiting for them.
+                Otherwise reads the nearest queued chunk from the
+                cache, or generates it and hands it to the cache,
+                until the streamer stops
+
+      Args:     TerrainGenerator& generator
+                  Generator of the thread
+
+      Modifies: [m_aRequests, m_aGeneratedChunks, m_aBuildRequests,
+                 m_aBuiltChunks].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void ChunkStreamer::work(_In_ TerrainGenerator& generator)
+    {
+        std::vector<FLOAT> aHeights;
+        for (;;)
+        {
+            std::pair<UINT, UINT> request;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_requestCondition.wait(lock, [this] { return m_bStop || !m_aRequests.empty() || !m_aBuildRequests.empty(); });
+                if (m_bStop)
+                {
+                    return;
+                }
+
+                if (!m_aBuildRequests.empty())
+                {
+                    StreamedChunkBuild build = std::move(m_aBuildRequests.back());
+                    m_aBuildRequests.pop_back();
+                    lock.unlock();
+
+                    BuildChunk(build);
+
+                    lock.lock();
+                    m_aBuiltChunks.push_back(std::move(build));
+                    continue;
+                }
+
+                request = m_aRequests.back();
+                m_aRequests.pop_back();
+            }
+
+            StreamedChunk chunk =
+            {
+                .ChunkX = request.first,
+                .ChunkZ = request.second,
+                .Heights = std::vector<WORD>(static_cast<size_t>(CHUNK_SIZE) * CHUNK_SIZE),
+                .BlockTypes = std::vector<eBlockType>(static_cast<size_t>(CHUNK_SIZE) * CHUNK_SIZE)
+            };
+
+            if (!m_cache || !m_cache->Load(request.first, request.second, chunk.Heights.data(), chunk.BlockTypes.data()))
+            {
+                aHeights.resize(chunk.Heights.size());
+                generator.Generate(request.first * CHUNK_SIZE, request.second * CHUNK_SIZE, CHUNK_SIZE, CHUNK_SIZE, aHeights.data(), nullptr, chunk.BlockTypes.data());
+                for (size_t i = 0u; i < aHeights.size(); ++i)
+                {
+                    chunk.Heights[i] = static_cast<WORD>(static_cast<FLOAT>(m_uHeight) * aHeights[i]);
+                }
+
+                if (m_cache)
+                {
+                    m_cache->Store(request.first, request.second, chunk.Heights.data(), chunk.BlockTypes.data());
+                }
+            }
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_aGeneratedChunks.push_back(std::move(chunk));
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ChunkStreamer::requestChunks
+
+      Summary:  Replaces the queue with the chunks within the load
+                radius that are neither resident nor pending, nearest
+                first. Only the budget of nearest chunks is considered,
+                so a budget smaller than the ring does not load and
+                evict the same chunks over and over. Queued chunks
+                that were not taken by a worker are dropped
+
+      Args:     INT iCenterX, INT iCenterZ
+                  Chunk of the camera, possibly outside the map
+
+      Modifies: [m_requestedChunks, m_aRequests].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void ChunkStreamer::requestChunks(_In_ INT iCenterX, _In_ INT iCenterZ)
+    {
+        const INT iReach = static_cast<INT>(std::ceil(m_loadRadius));
+        const INT iBeginX = std::max(iCenterX - iReach, 0);
+        const INT iBeginZ = std::max(iCenterZ - iReach, 0);
+        const INT iEndX = std::min(iCenterX + iReach + 1, static_cast<INT>(std::min<UINT>(m_uNumChunksX, INT_MAX)));
+        const INT iEndZ = std::min(iCenterZ + iReach + 1, static_cast<INT>(std::min<UINT>(m_uNumChunksZ, INT_MAX)));
+
+        std::vector<std::pair<UINT, UINT>> aChunks;
+        for (INT iChunkZ = iBeginZ; iChunkZ < iEndZ; ++iChunkZ)
+        {
+            for (INT iChunkX = iBeginX; iChunkX < iEndX; ++iChunkX)
+            {
+                if (getDistance(static_cast<UINT>(iChunkX), static_cast<UINT>(iChunkZ)) <= m_loadRadius)
+                {
+                    aChunks.emplace_back(static_cast<UINT>(iChunkX), static_cast<UINT>(iChunkZ));
+                }
+            }
+        }
+
+        std::stable_sort(aChunks.begin(), aChunks.end(),
+            [this](const std::pair<UINT, UINT>& a, const std::pair<UINT, UINT>& b)
+            {
+                return getDistance(a.first, a.second) < getDistance(b.first, b.second);
+            }
+        );
+        aChunks.resize(std::min<size_t>(aChunks.size(), m_uMaxNumResident));
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const std::pair<UINT, UINT>& request : m_aRequests)
+        {
+            m_requestedChunks.erase(getKey(request.first, request.second));
+        }
+        m_aRequests.clear();
+
+        // Nearest last, so the workers pop from the back
+        for (auto it = aChunks.rbegin(); it != aChunks.rend(); ++it)
+        {
+            const UINT64 uKey = getKey(it->first, it->second);
+            if (!m_residentChunks.contains(uKey) && m_requestedChunks.insert(uKey).second)
+            {
+                m_aRequests.push_back(*it);
+            }
+        }
+
+        if (!m_aRequests.empty())
+        {
+            m_requestCondition.notify_all();
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ChunkStreamer::getDistance
+
+      Summary:  Returns the distance from the camera to the center of
+                a chunk
+
+      Args:     UINT uChunkX, UINT uChunkZ
+                  Chunk column and row
+
+      Returns:  FLOAT
+                  Distance in chunks
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    FLOAT ChunkStreamer::getDistance(_In_ UINT uChunkX, _In_ UINT uChunkZ) const
+    {
+        const FLOAT dx = static_cast<FLOAT>(uChunkX) + 0.5f - m_x / static_cast<FLOAT>(CHUNK_SIZE);
+        const FLOAT dz = static_cast<FLOAT>(uChunkZ) + 0.5f - m_z / static_cast<FLOAT>(CHUNK_SIZE);
+        return std::sqrt(dx * dx + dz * dz);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ChunkStreamer::getKey
+
+      Summary:  Packs the coordinates of a chunk into a key
+
+      Args:     UINT uChunkX, UINT uChunkZ
+                  Chunk column and row
+
+      Returns:  UINT64
+                  Row in the high half, column in the low half
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT64 ChunkStreamer::getKey(_In_ UINT uChunkX, _In_ UINT uChunkZ)
+    {
+        return (static_cast<UINT64>(uChunkZ) << 32u) | uChunkX;
+    }
+}
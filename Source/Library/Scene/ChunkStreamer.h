@@ -0,0 +1,190 @@
+/*+===================================================================
+  File:      CHUNKSTREAMER.H
+
+  Summary:   ChunkStreamer header file contains declarations of the
+             ChunkStreamer class that decides which chunks of a voxel
+             map to generate around the camera, and generates them and
+             builds their levels of detail on background threads,
+             without Direct3D.
+
+  Classes: ChunkStreamer
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Platform.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <condition_variable>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+
+#include "Scene/ChunkCache.h"
+#include "Scene/GreedyMesher.h"
+#include "Scene/TerrainGenerator.h"
+#include "Scene/VoxelInstanceBuilder.h"
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+        Struct:   StreamedChunk
+        Summary:  Number of cubes and block types of the CHUNK_SIZE x
+                  CHUNK_SIZE columns of a generated chunk, row by row
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct StreamedChunk
+    {
+        UINT ChunkX;
+        UINT ChunkZ;
+        std::vector<WORD> Heights;
+        std::vector<eBlockType> BlockTypes;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+        Struct:   StreamedChunkLevel
+        Summary:  Columns of a chunk at a level of detail with a border
+                  of one column on each side, empty outside of the map,
+                  and the instances or greedy mesh built from them.
+                  The corners are relative to the corner of the map
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct StreamedChunkLevel
+    {
+        UINT BeginX;
+        UINT BeginZ;
+        UINT Width;
+        UINT Depth;
+        std::vector<VoxelColumn> Columns;
+        std::vector<InstanceData> Instances;
+        std::vector<SimpleVertex> Vertices;
+        std::vector<WORD> Indices;
+        std::vector<VoxelMeshRange> Ranges;
+        XMFLOAT3 MinCorner;
+        XMFLOAT3 MaxCorner;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+        Struct:   StreamedChunkBuild
+        Summary:  Every level of detail of a chunk to build on the
+                  worker threads. The version is handed back untouched
+                  so the caller drops the builds of columns that
+                  changed again since
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct StreamedChunkBuild
+    {
+        UINT ChunkX;
+        UINT ChunkZ;
+        UINT Version;
+        BOOL GreedyMesh;
+        size_t NumBlockTypes;
+        std::vector<StreamedChunkLevel> Levels;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    ChunkStreamer
+
+      Summary:  Keeps the chunks within a load radius of the camera
+                resident. Whenever the camera enters another chunk,
+                the missing chunks are queued nearest first, and the
+                worker threads read them from the chunk cache, or
+                generate them with a generator of their own and store
+                them in the cache. Update never waits for them: it takes the chunks
+                that are ready, promotes a few of them per call, and
+                evicts the chunks beyond the unload radius, which is
+                larger so a camera going back and forth across a chunk
+                edge does not reload them. At most a budget of chunks
+                is resident, so only the nearest chunks are queued and
+                the farthest chunks are evicted first. The decisions
+                only depend on the positions given to Update and on
+                which chunks are ready, so a fake camera path drives
+                it without a window. The workers also build the levels
+                of detail of the chunks whose columns changed, before
+                generating any chunk, so only their upload is left to
+                the frame
+
+      Methods:  BuildChunk
+                  Builds every level of detail of a chunk
+                Update
+                  Promotes and evicts chunks around the camera
+                QueueBuild
+                  Queues a chunk to build on the worker threads
+                CollectBuilds
+                  Takes the chunks the worker threads built
+                IsResident
+                  Returns whether a chunk is resident
+                GetNumResident
+                  Returns the number of resident chunks
+                GetNumPending
+                  Returns the number of chunks not promoted yet
+                GetNumBuilding
+                  Returns the number of builds not collected yet
+                ChunkStreamer
+                  Constructor.
+                ~ChunkStreamer
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class ChunkStreamer final
+    {
+    public:
+        static constexpr const UINT CHUNK_SIZE = 32u;
+
+        static_assert(CHUNK_SIZE == ChunkCache::CHUNK_SIZE, "The cache holds streamed chunks");
+
+    public:
+        static void BuildChunk(_Inout_ StreamedChunkBuild& build);
+
+    public:
+        ChunkStreamer(_In_ UINT uSeed, _In_ UINT uNumChunksX, _In_ UINT uNumChunksZ, _In_ UINT uHeight, _In_ FLOAT loadRadius, _In_ FLOAT unloadRadius, _In_ UINT uMaxNumResident, _In_ const std::filesystem::path& cacheDirectory, _In_ UINT uNumThreads = 1u);
+        ChunkStreamer(const ChunkStreamer& other) = delete;
+        ChunkStreamer(ChunkStreamer&& other) = delete;
+        ChunkStreamer& operator=(const ChunkStreamer& other) = delete;
+        ChunkStreamer& operator=(ChunkStreamer&& other) = delete;
+        ~ChunkStreamer();
+
+        void Update(_In_ FLOAT x, _In_ FLOAT z, _In_ UINT uMaxNumPromoted, _Inout_ std::vector<StreamedChunk>& aPromoted, _Inout_ std::vector<std::pair<UINT, UINT>>& aEvicted);
+        void QueueBuild(_In_ StreamedChunkBuild&& build);
+        void CollectBuilds(_Inout_ std::vector<StreamedChunkBuild>& aBuilt);
+
+        BOOL IsResident(_In_ UINT uChunkX, _In_ UINT uChunkZ) const;
+        UINT GetNumResident() const;
+        UINT GetNumPending() const;
+        UINT GetNumBuilding() const;
+
+    private:
+        void work(_In_ TerrainGenerator& generator);
+        void requestChunks(_In_ INT iCenterX, _In_ INT iCenterZ);
+        FLOAT getDistance(_In_ UINT uChunkX, _In_ UINT uChunkZ) const;
+
+        static UINT64 getKey(_In_ UINT uChunkX, _In_ UINT uChunkZ);
+
+    private:
+        UINT m_uNumChunksX;
+        UINT m_uNumChunksZ;
+        UINT m_uHeight;
+        FLOAT m_loadRadius;
+        FLOAT m_unloadRadius;
+        UINT m_uMaxNumResident;
+        FLOAT m_x;
+        FLOAT m_z;
+        INT m_iCenterX;
+        INT m_iCenterZ;
+        std::unordered_set<UINT64> m_residentChunks;
+        std::unordered_set<UINT64> m_requestedChunks;
+        std::vector<StreamedChunk> m_aReadyChunks;
+        std::vector<std::unique_ptr<TerrainGenerator>> m_aGenerators;
+        std::unique_ptr<ChunkCache> m_cache;
+        std::vector<std::thread> m_aThreads;
+        mutable std::mutex m_mutex;
+        std::condition_variable m_requestCondition;
+        std::vector<std::pair<UINT, UINT>> m_aRequests;
+        std::vector<StreamedChunk> m_aGeneratedChunks;
+        std::vector<StreamedChunkBuild> m_aBuildRequests;
+        std::vector<StreamedChunkBuild> m_aBuiltChunks;
+        UINT m_uNumBuilding;
+        BOOL m_bStop;
+    };
+}
@@ -0,0 +1,335 @@
+#include "Scene/GreedyMesher.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   GreedyMesher::GreedyMesher
+
+      Summary:  Constructor
+
+      Args:     const VoxelColumn* pColumns
+                  Columns of the map in row-major (x fastest) order
+                UINT uWidth
+                  Width of the map
+                UINT uDepth
+                  Depth of the map
+                size_t uNumBlockTypes
+                  Number of block types, starting at GRASSLAND, that
+                  have a voxel. Columns of other types are empty
+
+      Modifies: [m_pColumns, m_uWidth, m_uDepth, m_origin, m_cellSize,
+                 m_aMask, m_aVertices, m_aTypeIndices, m_aIndices,
+                 m_aRanges].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    GreedyMesher::GreedyMesher(_In_ const VoxelColumn* pColumns, _In_ UINT uWidth, _In_ UINT uDepth, _In_ size_t uNumBlockTypes)
+        : m_pColumns(pColumns)
+        , m_uWidth(uWidth)
+        , m_uDepth(uDepth)
+        , m_origin()
+        , m_cellSize(1.0f)
+        , m_aMask()
+        , m_aVertices()
+        , m_aTypeIndices(uNumBlockTypes)
+        , m_aIndices()
+        , m_aRanges(uNumBlockTypes)
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   GreedyMesher::Build
+
+      Summary:  Meshes the columns [uBeginX, uEndX) x [uBeginZ, uEndZ).
+                For each of the six face directions the cells are
+                swept slice by slice: the exposed faces of a slice are
+                written into a mask holding their block type, then
+                each unvisited face is grown as wide as possible along
+                the first axis of the slice and as tall as possible
+                along the second one before being emitted as one quad
+
+      Args:     UINT uBeginX
+                  First column along the width
+                UINT uBeginZ
+                  First column along the depth
+                UINT uEndX
+                  Column past the last one along the width
+                UINT uEndZ
+                  Column past the last one along the depth
+                const XMFLOAT3& origin
+                  World position of the corner of the map at the
+                  lowest x, y and z
+                FLOAT cellSize
+                  Edge length of a cube
+
+      Modifies: [m_origin, m_cellSize, m_aMask, m_aVertices,
+                 m_aTypeIndices, m_aIndices, m_aRanges].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void GreedyMesher::Build(_In_ UINT uBeginX, _In_ UINT uBeginZ, _In_ UINT uEndX, _In_ UINT uEndZ, _In_ const XMFLOAT3& origin, _In_ FLOAT cellSize)
+    {
+        m_origin = origin;
+        m_cellSize = cellSize;
+        m_aVertices.clear();
+        m_aIndices.clear();
+        for (std::vector<WORD>& aIndices : m_aTypeIndices)
+        {
+            aIndices.clear();
+        }
+
+        UINT uMaxHeight = 0u;
+        for (UINT z = uBeginZ; z < uEndZ; ++z)
+        {
+            for (UINT x = uBeginX; x < uEndX; ++x)
+            {
+                if (getBlockType(static_cast<INT>(x), 0, static_cast<INT>(z)) != 0)
+                {
+                    uMaxHeight = std::max(uMaxHeight, static_cast<UINT>(m_pColumns[static_cast<size_t>(z) * m_uWidth + x].Height));
+                }
+            }
+        }
+
+        const UINT aBegin[3] = { uBeginX, 0u, uBeginZ };
+        const UINT aSize[3] = { uEndX - uBeginX, uMaxHeight, uEndZ - uBeginZ };
+        for (UINT uAxis = 0u; uAxis < 3u; ++uAxis)
+        {
+            // Cyclic order so that the first axis cross the second one is the face normal
+            const UINT uAxisU = (uAxis + 1u) % 3u;
+            const UINT uAxisV = (uAxis + 2u) % 3u;
+            const UINT uSizeU = aSize[uAxisU];
+            const UINT uSizeV = aSize[uAxisV];
+            m_aMask.resize(static_cast<size_t>(uSizeU) * static_cast<size_t>(uSizeV));
+
+            for (INT iDirection = -1; iDirection <= 1; iDirection += 2)
+            {
+                for (UINT uSlice = 0u; uSlice < aSize[uAxis]; ++uSlice)
+                {
+                    INT aCell[3];
+                    INT aNeighbor[3];
+                    aCell[uAxis] = static_cast<INT>(aBegin[uAxis] + uSlice);
+                    for (UINT v = 0u; v < uSizeV; ++v)
+                    {
+                        aCell[uAxisV] = static_cast<INT>(aBegin[uAxisV] + v);
+                        for (UINT u = 0u; u < uSizeU; ++u)
+                        {
+                            aCell[uAxisU] = static_cast<INT>(aBegin[uAxisU] + u);
+                            aNeighbor[0] = aCell[0];
+                            aNeighbor[1] = aCell[1];
+                            aNeighbor[2] = aCell[2];
+                            aNeighbor[uAxis] += iDirection;
+
+                            CHAR blockType = getBlockType(aCell[0], aCell[1], aCell[2]);
+                            if (blockType != 0 && getBlockType(aNeighbor[0], aNeighbor[1], aNeighbor[2]) != 0)
+                            {
+                                blockType = 0;
+                            }
+                            m_aMask[static_cast<size_t>(v) * uSizeU + u] = blockType;
+                        }
+                    }
+
+                    for (UINT v = 0u; v < uSizeV; ++v)
+                    {
+                        for (UINT u = 0u; u < uSizeU;)
+                        {
+                            const CHAR blockType = m_aMask[static_cast<size_t>(v) * uSizeU + u];
+                            if (blockType == 0)
+                            {
+                                ++u;
+                                continue;
+                            }
+
+                            UINT uQuadWidth = 1u;
+                            while (u + uQuadWidth < uSizeU && m_aMask[static_cast<size_t>(v) * uSizeU + u + uQuadWidth] == blockType)
+                            {
+                                ++uQuadWidth;
+                            }
+
+                            UINT uQuadHeight = 1u;
+                            for (; v + uQuadHeight < uSizeV; ++uQuadHeight)
+                            {
+                                const CHAR* pRow = &m_aMask[static_cast<size_t>(v + uQuadHeight) * uSizeU + u];
+                                if (std::any_of(pRow, pRow + uQuadWidth, [blockType](CHAR other) { return other != blockType; }))
+                                {
+                                    break;
+                                }
+                            }
+
+                            for (UINT h = 0u; h < uQuadHeight; ++h)
+                            {
+                                CHAR* pRow = &m_aMask[static_cast<size_t>(v + h) * uSizeU + u];
+                                std::fill(pRow, pRow + uQuadWidth, static_cast<CHAR>(0));
+                            }
+
+                            // Faces looking along the positive axis lie on the far side of their cube
+                            UINT aCorner[3];
+                            aCorner[uAxis] = aBegin[uAxis] + uSlice + (iDirection > 0 ? 1u : 0u);
+                            aCorner[uAxisU] = aBegin[uAxisU] + u;
+                            aCorner[uAxisV] = aBegin[uAxisV] + v;
+                            addQuad(blockType, uAxis, iDirection > 0, aCorner, uQuadWidth, uQuadHeight);
+
+                            u += uQuadWidth;
+                        }
+                    }
+                }
+            }
+        }
+
+        size_t uNumIndices = 0u;
+        for (const std::vector<WORD>& aIndices : m_aTypeIndices)
+        {
+            uNumIndices += aIndices.size();
+        }
+
+        m_aIndices.reserve(uNumIndices);
+        for (size_t uTypeIdx = 0u; uTypeIdx < m_aTypeIndices.size(); ++uTypeIdx)
+        {
+            m_aRanges[uTypeIdx] = VoxelMeshRange
+            {
+                .uStartIndex = static_cast<UINT>(m_aIndices.size()),
+                .uNumIndices = static_cast<UINT>(m_aTypeIndices[uTypeIdx].size())
+            };
+            m_aIndices.insert(m_aIndices.end(), m_aTypeIndices[uTypeIdx].begin(), m_aTypeIndices[uTypeIdx].end());
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   GreedyMesher::GetVertices
+
+      Summary:  Returns the vertices of the last mesh
+
+      Returns:  std::vector<SimpleVertex>&
+                  World space vertices
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::vector<SimpleVertex>& GreedyMesher::GetVertices()
+    {
+        return m_aVertices;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   GreedyMesher::GetIndices
+
+      Summary:  Returns the indices of the last mesh
+
+      Returns:  std::vector<WORD>&
+                  Indices grouped by block type
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::vector<WORD>& GreedyMesher::GetIndices()
+    {
+        return m_aIndices;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   GreedyMesher::GetRanges
+
+      Summary:  Returns the indices of each block type
+
+      Returns:  std::vector<VoxelMeshRange>&
+                  Range of the indices of each block type
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::vector<VoxelMeshRange>& GreedyMesher::GetRanges()
+    {
+        return m_aRanges;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   GreedyMesher::GetNumQuads
+
+      Summary:  Returns the number of quads of the last mesh
+
+      Returns:  UINT
+                  Number of quads
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT GreedyMesher::GetNumQuads() const
+    {
+        return static_cast<UINT>(m_aVertices.size() / 4u);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   GreedyMesher::getBlockType
+
+      Summary:  Returns the block type of a cell of the map
+
+      Args:     INT x, INT y, INT z
+                  Cell of the map, may lie outside of it
+
+      Returns:  CHAR
+                  Block type of the cube, 0 if the cell is empty
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    CHAR GreedyMesher::getBlockType(_In_ INT x, _In_ INT y, _In_ INT z) const
+    {
+        if (x < 0 || y < 0 || z < 0 || static_cast<UINT>(x) >= m_uWidth || static_cast<UINT>(z) >= m_uDepth)
+        {
+            return 0;
+        }
+
+        const VoxelColumn& column = m_pColumns[static_cast<size_t>(z) * m_uWidth + static_cast<size_t>(x)];
+        size_t uTypeIdx = static_cast<size_t>(column.BlockType) - static_cast<size_t>(eBlockType::GRASSLAND);
+        if (uTypeIdx >= m_aTypeIndices.size() || static_cast<UINT>(y) >= column.Height)
+        {
+            return 0;
+        }
+
+        return column.BlockType;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   GreedyMesher::addQuad
+
+      Summary:  Appends the two triangles of a merged face, wound
+                clockwise when seen from the side it faces
+
+      Args:     CHAR blockType
+                  Block type of the face
+                UINT uAxis
+                  Axis of the face normal, 0 for x, 1 for y, 2 for z
+                BOOL bPositive
+                  Whether the face looks along the positive axis
+                const UINT aCorner[3]
+                  Grid corner of the quad with the lowest coordinates
+                UINT uWidth
+                  Number of cells along the axis after uAxis
+                UINT uHeight
+                  Number of cells along the axis before uAxis
+
+      Modifies: [m_aVertices, m_aTypeIndices].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void GreedyMesher::addQuad(_In_ CHAR blockType, _In_ UINT uAxis, _In_ BOOL bPositive, _In_ const UINT aCorner[3], _In_ UINT uWidth, _In_ UINT uHeight)
+    {
+        const UINT uAxisU = (uAxis + 1u) % 3u;
+        const UINT uAxisV = (uAxis + 2u) % 3u;
+
+        FLOAT aNormal[3] = { 0.0f, 0.0f, 0.0f };
+        aNormal[uAxis] = bPositive ? 1.0f : -1.0f;
+
+        const WORD uBaseVertex = static_cast<WORD>(m_aVertices.size());
+        const UINT aOffsets[4][2] = { { 0u, 0u }, { uWidth, 0u }, { uWidth, uHeight }, { 0u, uHeight } };
+        for (const UINT* pOffset : aOffsets)
+        {
+            UINT aGrid[3] = { aCorner[0], aCorner[1], aCorner[2] };
+            aGrid[uAxisU] += pOffset[0];
+            aGrid[uAxisV] += pOffset[1];
+
+            m_aVertices.push_back(
+                SimpleVertex
+                {
+                    .Position = XMFLOAT3(
+                        m_origin.x + m_cellSize * static_cast<FLOAT>(aGrid[0]),
+                        m_origin.y + m_cellSize * static_cast<FLOAT>(aGrid[1]),
+                        m_origin.z + m_cellSize * static_cast<FLOAT>(aGrid[2])
+                    ),
+                    .TexCoord = XMFLOAT2(static_cast<FLOAT>(pOffset[0]), static_cast<FLOAT>(pOffset[1])),
+                    .Normal = XMFLOAT3(aNormal[0], aNormal[1], aNormal[2])
+                }
+            );
+        }
+
+        // The corners go from the first axis to the second one, which turns clockwise around the positive normal
+        std::vector<WORD>& aIndices = m_aTypeIndices[static_cast<size_t>(blockType) - static_cast<size_t>(eBlockType::GRASSLAND)];
+        const WORD aQuadIndices[2][6] =
+        {
+            { 0u, 3u, 2u, 0u, 2u, 1u },
+            { 0u, 1u, 2u, 0u, 2u, 3u }
+        };
+        for (WORD uIndex : aQuadIndices[bPositive ? 1 : 0])
+        {
+            aIndices.push_back(static_cast<WORD>(uBaseVertex + uIndex));
+        }
+    }
+}
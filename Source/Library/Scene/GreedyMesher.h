@@ -0,0 +1,91 @@
+/*+===================================================================
+  File:      GREEDYMESHER.H
+
+  Summary:   GreedyMesher header file contains declarations of the
+             GreedyMesher class that turns the columns of a voxel map
+             into a static triangle mesh per chunk, without Direct3D.
+
+  Classes: GreedyMesher
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Platform.h"
+
+#include <algorithm>
+
+#include "Renderer/VertexData.h"
+#include "Scene/VoxelMap.h"
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+        Struct:   VoxelMeshRange
+        Summary:  Indices of one block type inside the index buffer of
+                  a chunk mesh
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct VoxelMeshRange
+    {
+        UINT uStartIndex;
+        UINT uNumIndices;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    GreedyMesher
+
+      Summary:  Builds the visible faces of a rectangle of voxel map
+                columns. Faces between two solid cubes are culled,
+                cubes outside the rectangle included, and coplanar
+                faces of the same block type are merged into larger
+                quads. The indices are grouped by block type
+
+      Methods:  Build
+                  Meshes a rectangle of columns
+                GetVertices
+                  Returns the vertices of the last mesh
+                GetIndices
+                  Returns the indices of the last mesh
+                GetRanges
+                  Returns the indices of each block type
+                GetNumQuads
+                  Returns the number of quads of the last mesh
+                GreedyMesher
+                  Constructor.
+                ~GreedyMesher
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class GreedyMesher final
+    {
+    public:
+        GreedyMesher(_In_ const VoxelColumn* pColumns, _In_ UINT uWidth, _In_ UINT uDepth, _In_ size_t uNumBlockTypes);
+        GreedyMesher(const GreedyMesher& other) = delete;
+        GreedyMesher(GreedyMesher&& other) = delete;
+        GreedyMesher& operator=(const GreedyMesher& other) = delete;
+        GreedyMesher& operator=(GreedyMesher&& other) = delete;
+        ~GreedyMesher() = default;
+
+        void Build(_In_ UINT uBeginX, _In_ UINT uBeginZ, _In_ UINT uEndX, _In_ UINT uEndZ, _In_ const XMFLOAT3& origin, _In_ FLOAT cellSize);
+
+        std::vector<SimpleVertex>& GetVertices();
+        std::vector<WORD>& GetIndices();
+        std::vector<VoxelMeshRange>& GetRanges();
+        UINT GetNumQuads() const;
+
+    private:
+        CHAR getBlockType(_In_ INT x, _In_ INT y, _In_ INT z) const;
+        void addQuad(_In_ CHAR blockType, _In_ UINT uAxis, _In_ BOOL bPositive, _In_ const UINT aCorner[3], _In_ UINT uWidth, _In_ UINT uHeight);
+
+    private:
+        const VoxelColumn* m_pColumns;
+        UINT m_uWidth;
+        UINT m_uDepth;
+        XMFLOAT3 m_origin;
+        FLOAT m_cellSize;
+        std::vector<CHAR> m_aMask;
+        std::vector<SimpleVertex> m_aVertices;
+        std::vector<std::vector<WORD>> m_aTypeIndices;
+        std::vector<WORD> m_aIndices;
+        std::vector<VoxelMeshRange> m_aRanges;
+    };
+}
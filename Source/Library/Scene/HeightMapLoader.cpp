@@ -0,0 +1,482 @@
+#include "Scene/HeightMapLoader.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HeightMapLoader::Load
+
+      Summary:  Parses a text height map into its dimensions, palette
+                and columns. Columns past width * depth wrap around to
+                the first one. On several threads the body is split
+                into line-aligned ranges parsed concurrently, with the
+                same output as on one thread
+
+      Args:     const std::filesystem::path& filePath
+                  Path of the text height map
+                UINT uNumThreads
+                  Number of threads parsing the body, 1 to parse it
+                  while it is read
+                UINT aDimension[3]
+                  Receives the width, height and depth of the map
+                std::vector<XMFLOAT3>& aPalette
+                  Receives the color of each block type
+                std::vector<VoxelColumn>& aColumns
+                  Receives width * depth columns, x fastest
+
+      Returns:  HRESULT
+                  Status code, E_FAIL if the file cannot be opened
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT HeightMapLoader::Load(
+        _In_ const std::filesystem::path& filePath,
+        _In_ UINT uNumThreads,
+        _Out_writes_(3) UINT aDimension[3],
+        _Out_ std::vector<XMFLOAT3>& aPalette,
+        _Out_ std::vector<VoxelColumn>& aColumns
+    )
+    {
+        aDimension[0] = aDimension[1] = aDimension[2] = 0u;
+        aPalette.clear();
+        aColumns.clear();
+
+        std::ifstream inputFile;
+        inputFile.open(filePath.string());
+        if (!inputFile.is_open())
+        {
+            return E_FAIL;
+        }
+
+        UINT aHeader[4];
+        readHeader(inputFile, aHeader, aPalette, aColumns);
+        aDimension[0] = aHeader[0];
+        aDimension[1] = aHeader[1];
+        aDimension[2] = aHeader[2];
+
+        if (uNumThreads > 1u)
+        {
+            std::error_code errorCode;
+            const std::uintmax_t uFileSize = std::filesystem::file_size(filePath, errorCode);
+            loadParallel(inputFile, errorCode ? 0u : static_cast<UINT64>(uFileSize), uNumThreads, aHeader[1], aColumns);
+        }
+        else
+        {
+            load(inputFile, aHeader[1], aColumns);
+        }
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HeightMapLoader::readHeader
+
+      Summary:  Reads the dimensions and the palette of a text height
+                map and allocates the columns of the map
+
+      Args:     std::istream& inputFile
+                  Stream positioned at the beginning of the height map
+                UINT aDimension[4]
+                  Receives the width, height, depth and number of colors
+                std::vector<XMFLOAT3>& aPalette
+                  Receives the colors of the palette
+                std::vector<VoxelColumn>& aColumns
+                  Receives width * depth empty columns
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void HeightMapLoader::readHeader(_In_ std::istream& inputFile, _Out_writes_(4) UINT aDimension[4], _Out_ std::vector<XMFLOAT3>& aPalette, _Out_ std::vector<VoxelColumn>& aColumns)
+    {
+        std::string trash;
+        UINT uDimensionIdx = 0u;
+        for (UINT i = 0u; i < 4u; ++i)
+        {
+            aDimension[i] = 0u;
+        }
+
+        while (!inputFile.eof() && uDimensionIdx < 4u)
+        {
+            inputFile >> aDimension[uDimensionIdx];
+
+            if (inputFile.fail())
+            {
+                if (inputFile.eof())
+                {
+                    break;
+                }
+                inputFile.clear();
+                inputFile >> trash;
+            }
+            else
+            {
+                ++uDimensionIdx;
+            }
+        }
+
+        XMFLOAT3 color;
+        while (!inputFile.eof() && aPalette.size() < aDimension[3])
+        {
+            inputFile >> color.x >> color.y >> color.z;
+
+            if (inputFile.fail())
+            {
+                if (inputFile.eof())
+                {
+                    break;
+                }
+                inputFile.clear();
+                inputFile >> trash;
+            }
+            else
+            {
+                aPalette.push_back(color);
+            }
+        }
+
+        aColumns.assign(
+            static_cast<size_t>(aDimension[0]) * static_cast<size_t>(aDimension[2]),
+            VoxelColumn{ .BlockType = 0, .Reserved = 0u, .Height = 0u }
+        );
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HeightMapLoader::load
+
+      Summary:  Parses the body of a text height map while it is read
+
+      Args:     std::istream& inputFile
+                  Stream positioned after the palette
+                UINT uMapHeight
+                  Height of the map
+                std::vector<VoxelColumn>& aColumns
+                  Columns of the map
+
+      Modifies: [aColumns].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void HeightMapLoader::load(_In_ std::istream& inputFile, _In_ UINT uMapHeight, _Inout_ std::vector<VoxelColumn>& aColumns)
+    {
+        std::string trash;
+        size_t uColumnIdx = 0u;
+        CHAR voxelType;
+        FLOAT height;
+        while (!inputFile.eof())
+        {
+            inputFile >> voxelType >> height;
+
+            if (inputFile.fail())
+            {
+                if (inputFile.eof())
+                {
+                    break;
+                }
+                inputFile.clear();
+                inputFile >> trash;
+            }
+            else if (static_cast<CHAR>(eBlockType::GRASSLAND) <= voxelType && voxelType < static_cast<CHAR>(eBlockType::COUNT) && !aColumns.empty())
+            {
+                aColumns[uColumnIdx] = getVoxelColumn(
+                    HeightMapRecord
+                    {
+                        .BlockType = voxelType,
+                        .Height = static_cast<UINT>(static_cast<FLOAT>(uMapHeight) * height)
+                    }
+                );
+
+                if (++uColumnIdx >= aColumns.size())
+                {
+                    uColumnIdx = 0u;
+                }
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HeightMapLoader::loadParallel
+
+      Summary:  Parses the body of a text height map on several
+                threads. The body is split into line-aligned ranges
+                parsed concurrently, the records that run past a range
+                are parsed again from where they begin, and each range
+                writes its records into the columns that follow the
+                records of the previous ranges, so the output is the
+                same as HeightMapLoader::load
+
+      Args:     std::istream& inputFile
+                  Stream positioned after the palette
+                UINT64 uFileSize
+                  Size of the file, to reserve the body, or 0
+                UINT uNumThreads
+                  Number of worker threads
+                UINT uMapHeight
+                  Height of the map
+                std::vector<VoxelColumn>& aColumns
+                  Columns of the map
+
+      Modifies: [aColumns].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void HeightMapLoader::loadParallel(_In_ std::istream& inputFile, _In_ UINT64 uFileSize, _In_ UINT uNumThreads, _In_ UINT uMapHeight, _Inout_ std::vector<VoxelColumn>& aColumns)
+    {
+        const size_t uNumColumns = aColumns.size();
+        if (uNumColumns == 0u)
+        {
+            return;
+        }
+
+        std::string body;
+        body.reserve(static_cast<size_t>(uFileSize));
+
+        CHAR aBuffer[65536];
+        while (inputFile.read(aBuffer, sizeof(aBuffer)) || inputFile.gcount() > 0)
+        {
+            body.append(aBuffer, static_cast<size_t>(inputFile.gcount()));
+        }
+
+        const CHAR* pBodyEnd = body.data() + body.size();
+        const size_t uRangeSize = body.size() / uNumThreads + 1u;
+
+        std::vector<HeightMapRange> aRanges;
+        aRanges.reserve(uNumThreads + 1u);
+        for (const CHAR* pRangeBegin = body.data(); pRangeBegin < pBodyEnd;)
+        {
+            const CHAR* pRangeEnd = pRangeBegin + std::min(uRangeSize, static_cast<size_t>(pBodyEnd - pRangeBegin));
+            pRangeEnd = std::find(pRangeEnd, pBodyEnd, '\n');
+            if (pRangeEnd < pBodyEnd)
+            {
+                ++pRangeEnd;
+            }
+
+            aRanges.push_back(
+                HeightMapRange
+                {
+                    .pBegin = pRangeBegin,
+                    .pEnd = pRangeEnd,
+                    .pDangling = nullptr,
+                    .aRecords = std::vector<HeightMapRecord>()
+                }
+            );
+            pRangeBegin = pRangeEnd;
+        }
+
+        std::vector<std::thread> aThreads;
+        aThreads.reserve(aRanges.size());
+        for (size_t uRangeIdx = 0u; uRangeIdx < aRanges.size(); ++uRangeIdx)
+        {
+            aThreads.emplace_back(
+                parseRange,
+                std::ref(aRanges[uRangeIdx]),
+                aRanges[uRangeIdx].pBegin,
+                static_cast<BOOL>(uRangeIdx + 1u == aRanges.size()),
+                uMapHeight
+            );
+        }
+        for (std::thread& thread : aThreads)
+        {
+            thread.join();
+        }
+        aThreads.clear();
+
+        size_t uNumRecords = 0u;
+        std::vector<size_t> aFirstColumns(aRanges.size(), 0u);
+        for (size_t uRangeIdx = 0u; uRangeIdx < aRanges.size(); ++uRangeIdx)
+        {
+            if (uRangeIdx > 0u)
+            {
+                if (aRanges[uRangeIdx - 1u].pDangling)
+                {
+                    parseRange(aRanges[uRangeIdx], aRanges[uRangeIdx - 1u].pDangling, uRangeIdx + 1u == aRanges.size(), uMapHeight);
+                }
+                aFirstColumns[uRangeIdx] = (aFirstColumns[uRangeIdx - 1u] + aRanges[uRangeIdx - 1u].aRecords.size()) % uNumColumns;
+            }
+            uNumRecords += aRanges[uRangeIdx].aRecords.size();
+        }
+
+        auto fillColumns = [&aColumns, &aRanges, &aFirstColumns, uNumColumns](size_t uRangeIdx)
+        {
+            size_t uColumnIdx = aFirstColumns[uRangeIdx];
+            for (const HeightMapRecord& record : aRanges[uRangeIdx].aRecords)
+            {
+                aColumns[uColumnIdx] = getVoxelColumn(record);
+                if (++uColumnIdx >= uNumColumns)
+                {
+                    uColumnIdx = 0u;
+                }
+            }
+        };
+
+        // Records that wrap around overwrite earlier columns, so they are written in file order
+        if (uNumRecords > uNumColumns)
+        {
+            for (size_t uRangeIdx = 0u; uRangeIdx < aRanges.size(); ++uRangeIdx)
+            {
+                fillColumns(uRangeIdx);
+            }
+            return;
+        }
+
+        for (size_t uRangeIdx = 0u; uRangeIdx < aRanges.size(); ++uRangeIdx)
+        {
+            aThreads.emplace_back(fillColumns, uRangeIdx);
+        }
+        for (std::thread& thread : aThreads)
+        {
+            thread.join();
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HeightMapLoader::parseRange
+
+      Summary:  Parses the records of a text height map range with
+                std::from_chars. Tokens are consumed the same way as
+                the stream extraction of HeightMapLoader::load: a block
+                type is the next non-space character, a height that
+                fails to parse skips the following token, and block
+                types out of range are ignored
+
+      Args:     HeightMapRange& range
+                  Range to parse
+                const CHAR* pBegin
+                  Where to start parsing, range.pBegin or a dangling
+                  record of the previous range
+                BOOL bEndOfFile
+                  Whether range.pEnd is the end of the file
+                UINT uMapHeight
+                  Height of the map
+
+      Modifies: [range].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void HeightMapLoader::parseRange(_Inout_ HeightMapRange& range, _In_ const CHAR* pBegin, _In_ BOOL bEndOfFile, _In_ UINT uMapHeight)
+    {
+        const CHAR* pEnd = range.pEnd;
+        auto isSpace = [](CHAR c)
+        {
+            return c == ' ' || ('\t' <= c && c <= '\r');
+        };
+        auto isDigit = [](CHAR c)
+        {
+            return '0' <= c && c <= '9';
+        };
+
+        range.aRecords.clear();
+        range.pDangling = nullptr;
+
+        const CHAR* p = pBegin;
+        while (p < pEnd)
+        {
+            const CHAR* pRecord = p;
+            while (p < pEnd && isSpace(*p))
+            {
+                ++p;
+            }
+            if (p == pEnd)
+            {
+                break;
+            }
+
+            CHAR voxelType = *p++;
+            while (p < pEnd && isSpace(*p))
+            {
+                ++p;
+            }
+
+            const CHAR* pNumber = p;
+            if (p < pEnd && (*p == '+' || *p == '-'))
+            {
+                ++p;
+            }
+            BOOL bHasMantissa = FALSE;
+            while (p < pEnd && isDigit(*p))
+            {
+                bHasMantissa = TRUE;
+                ++p;
+            }
+            if (p < pEnd && *p == '.')
+            {
+                ++p;
+                while (p < pEnd && isDigit(*p))
+                {
+                    bHasMantissa = TRUE;
+                    ++p;
+                }
+            }
+            if (bHasMantissa && p < pEnd && (*p == 'e' || *p == 'E'))
+            {
+                ++p;
+                if (p < pEnd && (*p == '+' || *p == '-'))
+                {
+                    ++p;
+                }
+                while (p < pEnd && isDigit(*p))
+                {
+                    ++p;
+                }
+            }
+
+            if (p == pEnd && !bEndOfFile)
+            {
+                range.pDangling = pRecord;
+                break;
+            }
+
+            const CHAR* pDigits = (pNumber < p && *pNumber == '+') ? pNumber + 1 : pNumber;
+            DOUBLE value = 0.0;
+            std::from_chars_result result = std::from_chars(pDigits, p, value);
+            const CHAR* pExponent = std::find_if(pDigits, p, [](CHAR c) { return c == 'e' || c == 'E'; });
+            if (result.ec == std::errc::result_out_of_range && result.ptr == p && pExponent + 1 < p && pExponent[1] == '-')
+            {
+                // Underflow reads as zero, overflow fails
+                value = 0.0;
+                result.ec = std::errc();
+            }
+
+            FLOAT height = static_cast<FLOAT>(value);
+            if (pDigits == p || result.ec != std::errc() || result.ptr != p || std::abs(value) > static_cast<DOUBLE>(FLT_MAX))
+            {
+                if (p == pEnd)
+                {
+                    break;
+                }
+
+                while (p < pEnd && isSpace(*p))
+                {
+                    ++p;
+                }
+                while (p < pEnd && !isSpace(*p))
+                {
+                    ++p;
+                }
+                if (p == pEnd && !bEndOfFile)
+                {
+                    range.pDangling = pRecord;
+                    break;
+                }
+            }
+            else if (static_cast<CHAR>(eBlockType::GRASSLAND) <= voxelType && voxelType < static_cast<CHAR>(eBlockType::COUNT))
+            {
+                range.aRecords.push_back(
+                    HeightMapRecord
+                    {
+                        .BlockType = voxelType,
+                        .Height = static_cast<UINT>(static_cast<FLOAT>(uMapHeight) * height)
+                    }
+                );
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HeightMapLoader::getVoxelColumn
+
+      Summary:  Packs a parsed height map record into a column
+
+      Args:     const HeightMapRecord& record
+                  Parsed record
+
+      Returns:  VoxelColumn
+                  Column with the height clamped to its range
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    VoxelColumn HeightMapLoader::getVoxelColumn(_In_ const HeightMapRecord& record)
+    {
+        return VoxelColumn
+        {
+            .BlockType = record.BlockType,
+            .Reserved = 0u,
+            .Height = static_cast<WORD>(std::min(record.Height, 0xFFFFu))
+        };
+    }
+}
@@ -0,0 +1,86 @@
+/*+===================================================================
+  File:      HEIGHTMAPLOADER.H
+
+  Summary:   HeightMapLoader header file contains declarations of the
+             HeightMapLoader class that parses a text height map into
+             the columns of a voxel map, on one or several threads,
+             without Direct3D.
+
+  Classes: HeightMapLoader
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Platform.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <charconv>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+#include "Scene/VoxelMap.h"
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+        Struct:   HeightMapRecord
+        Summary:  Column parsed from the body of a text height map.
+                  Height is the number of stacked cubes
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct HeightMapRecord
+    {
+        CHAR BlockType;
+        UINT Height;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+        Struct:   HeightMapRange
+        Summary:  Line-aligned part of a text height map body parsed by
+                  one worker thread. pDangling points at the record
+                  that runs past pEnd, or is nullptr
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct HeightMapRange
+    {
+        const CHAR* pBegin;
+        const CHAR* pEnd;
+        const CHAR* pDangling;
+        std::vector<HeightMapRecord> aRecords;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    HeightMapLoader
+
+      Summary:  Parser of text height maps. Only the columns of the map
+                are kept, 4 bytes each, so its peak memory is the
+                columns plus, on several threads, the body of the file
+                and 8 bytes per parsed record
+
+      Methods:  Load
+                  Parses a text height map
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class HeightMapLoader final
+    {
+    public:
+        static HRESULT Load(
+            _In_ const std::filesystem::path& filePath,
+            _In_ UINT uNumThreads,
+            _Out_writes_(3) UINT aDimension[3],
+            _Out_ std::vector<XMFLOAT3>& aPalette,
+            _Out_ std::vector<VoxelColumn>& aColumns
+        );
+
+    public:
+        HeightMapLoader() = delete;
+
+    private:
+        static void readHeader(_In_ std::istream& inputFile, _Out_writes_(4) UINT aDimension[4], _Out_ std::vector<XMFLOAT3>& aPalette, _Out_ std::vector<VoxelColumn>& aColumns);
+        static void load(_In_ std::istream& inputFile, _In_ UINT uMapHeight, _Inout_ std::vector<VoxelColumn>& aColumns);
+        static void loadParallel(_In_ std::istream& inputFile, _In_ UINT64 uFileSize, _In_ UINT uNumThreads, _In_ UINT uMapHeight, _Inout_ std::vector<VoxelColumn>& aColumns);
+        static void parseRange(_Inout_ HeightMapRange& range, _In_ const CHAR* pBegin, _In_ BOOL bEndOfFile, _In_ UINT uMapHeight);
+        static VoxelColumn getVoxelColumn(_In_ const HeightMapRecord& record);
+    };
+}
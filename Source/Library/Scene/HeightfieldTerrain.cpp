@@ -0,0 +1,390 @@
+#include "Scene/HeightfieldTerrain.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HeightfieldTerrain::HeightfieldTerrain
+
+      Summary:  Constructor. Every column starts flat at height 0
+
+      Args:     UINT uWidth
+                  Number of columns along the width
+                UINT uDepth
+                  Number of columns along the depth
+                UINT uNumLods
+                  Number of levels of detail of the quadtree
+                FLOAT lodDistance
+                  Range of the finest level, in columns
+                FLOAT morphRatio
+                  Part of the range of a level where its vertices
+                  morph onto the coarser level
+
+      Modifies: [m_uWidth, m_uDepth, m_quadtree, m_aVertices,
+                 m_aIndices, m_aTexels, m_dirtyBox, m_bDirty,
+                 m_aPatches, m_aQuarterPatches, m_auNumPatches,
+                 m_uMaxNumPatches, m_heightTexture,
+                 m_heightTextureView, m_patchBuffer, m_cbTerrain].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HeightfieldTerrain::HeightfieldTerrain(_In_ UINT uWidth, _In_ UINT uDepth, _In_ UINT uNumLods, _In_ FLOAT lodDistance, _In_ FLOAT morphRatio)
+        : Renderable(XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f))
+        , m_uWidth(uWidth)
+        , m_uDepth(uDepth)
+        , m_quadtree(uWidth, uDepth, uNumLods, lodDistance, morphRatio)
+        , m_aVertices()
+        , m_aIndices()
+        , m_aTexels(static_cast<size_t>(uWidth) * uDepth * 2u, 0u)
+        , m_dirtyBox()
+        , m_bDirty(FALSE)
+        , m_aPatches()
+        , m_aQuarterPatches()
+        , m_auNumPatches()
+        , m_uMaxNumPatches(m_quadtree.GetMaxNumPatches())
+        , m_heightTexture()
+        , m_heightTextureView()
+        , m_patchBuffer()
+        , m_cbTerrain()
+    {
+        buildGrid();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HeightfieldTerrain::Initialize
+
+      Summary:  Creates the buffers of the grid, the texture of the
+                columns, the buffer of the patches and the constant
+                buffer of the morph ranges
+
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the buffers
+                ID3D11DeviceContext* pImmediateContext
+                  The Direct3D context to set buffers
+
+      Modifies: [m_vertexBuffer, m_indexBuffer, m_constantBuffer,
+                 m_normalBuffer, m_heightTexture, m_heightTextureView,
+                 m_patchBuffer, m_cbTerrain, m_bDirty].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT HeightfieldTerrain::Initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext)
+    {
+        if (m_uWidth == 0u || m_uDepth == 0u)
+        {
+            return E_INVALIDARG;
+        }
+
+        HRESULT hr = initialize(pDevice, pImmediateContext);
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        // Height in the first channel, block type in the second
+        D3D11_TEXTURE2D_DESC textureDesc =
+        {
+            .Width = m_uWidth,
+            .Height = m_uDepth,
+            .MipLevels = 1u,
+            .ArraySize = 1u,
+            .Format = DXGI_FORMAT_R16G16_UINT,
+            .SampleDesc = {.Count = 1u, .Quality = 0u },
+            .Usage = D3D11_USAGE_DEFAULT,
+            .BindFlags = D3D11_BIND_SHADER_RESOURCE,
+            .CPUAccessFlags = 0u,
+            .MiscFlags = 0u
+        };
+
+        D3D11_SUBRESOURCE_DATA textureData =
+        {
+            .pSysMem = m_aTexels.data(),
+            .SysMemPitch = m_uWidth * 2u * static_cast<UINT>(sizeof(WORD)),
+            .SysMemSlicePitch = 0u
+        };
+
+        hr = pDevice->CreateTexture2D(&textureDesc, &textureData, m_heightTexture.ReleaseAndGetAddressOf());
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        hr = pDevice->CreateShaderResourceView(m_heightTexture.Get(), nullptr, m_heightTextureView.ReleaseAndGetAddressOf());
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+        m_bDirty = FALSE;
+
+        D3D11_BUFFER_DESC patchBuffDesc =
+        {
+            .ByteWidth = static_cast<UINT>(sizeof(TerrainPatchData)) * std::max(m_uMaxNumPatches, 1u),
+            .Usage = D3D11_USAGE_DYNAMIC,
+            .BindFlags = D3D11_BIND_VERTEX_BUFFER,
+            .CPUAccessFlags = D3D11_CPU_ACCESS_WRITE,
+            .MiscFlags = 0u,
+            .StructureByteStride = 0u
+        };
+
+        hr = pDevice->CreateBuffer(&patchBuffDesc, nullptr, m_patchBuffer.ReleaseAndGetAddressOf());
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        D3D11_BUFFER_DESC cbTerrainDesc =
+        {
+            .ByteWidth = sizeof(CBTerrain),
+            .Usage = D3D11_USAGE_DEFAULT,
+            .BindFlags = D3D11_BIND_CONSTANT_BUFFER,
+            .CPUAccessFlags = 0u,
+            .MiscFlags = 0u,
+            .StructureByteStride = 0u
+        };
+
+        return pDevice->CreateBuffer(&cbTerrainDesc, nullptr, m_cbTerrain.ReleaseAndGetAddressOf());
+    }
+
+    void HeightfieldTerrain::Update(_In_ FLOAT deltaTime)
+    {
+        UNREFERENCED_PARAMETER(deltaTime);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HeightfieldTerrain::SetColumns
+
+      Summary:  Copies the height and the block type of a rectangle of
+                columns, updates the bounds of the quadtree and grows
+                the rectangle the next UpdatePatches copies to the
+                texture
+
+      Args:     UINT uX, UINT uZ
+                  First column of the rectangle
+                UINT uWidth, UINT uDepth
+                  Number of columns of the rectangle
+                const WORD* pHeights
+                  Heights of every column of the map, row by row
+                const VoxelColumn* pColumns
+                  Every column of the map, row by row
+
+      Modifies: [m_quadtree, m_aTexels, m_dirtyBox, m_bDirty].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void HeightfieldTerrain::SetColumns(_In_ UINT uX, _In_ UINT uZ, _In_ UINT uWidth, _In_ UINT uDepth, _In_ const WORD* pHeights, _In_ const VoxelColumn* pColumns)
+    {
+        if (uX >= m_uWidth || uZ >= m_uDepth || uWidth == 0u || uDepth == 0u)
+        {
+            return;
+        }
+
+        const UINT uEndX = std::min(uX + uWidth, m_uWidth);
+        const UINT uEndZ = std::min(uZ + uDepth, m_uDepth);
+        for (UINT z = uZ; z < uEndZ; ++z)
+        {
+            for (UINT x = uX; x < uEndX; ++x)
+            {
+                const size_t uColumnIdx = static_cast<size_t>(z) * m_uWidth + x;
+                m_aTexels[uColumnIdx * 2u] = pHeights[uColumnIdx];
+                m_aTexels[uColumnIdx * 2u + 1u] = static_cast<WORD>(static_cast<BYTE>(pColumns[uColumnIdx].BlockType));
+            }
+        }
+        m_quadtree.SetHeights(uX, uZ, uEndX - uX, uEndZ - uZ, pHeights);
+
+        if (!m_bDirty)
+        {
+            m_dirtyBox = D3D11_BOX{ .left = uX, .top = uZ, .front = 0u, .right = uEndX, .bottom = uEndZ, .back = 1u };
+            m_bDirty = TRUE;
+        }
+        else
+        {
+            m_dirtyBox.left = std::min<UINT>(m_dirtyBox.left, uX);
+            m_dirtyBox.top = std::min<UINT>(m_dirtyBox.top, uZ);
+            m_dirtyBox.right = std::max<UINT>(m_dirtyBox.right, uEndX);
+            m_dirtyBox.bottom = std::max<UINT>(m_dirtyBox.bottom, uEndZ);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HeightfieldTerrain::UpdatePatches
+
+      Summary:  Copies the changed columns to the texture, selects the
+                patches around the camera and writes them to the
+                buffer of the patches, whole patches first
+
+      Args:     ID3D11DeviceContext* pImmediateContext
+                  The Direct3D context to copy the columns and patches
+                const XMFLOAT3& eye
+                  Position of the camera in columns and cubes from the
+                  corner of the map
+
+      Modifies: [m_heightTexture, m_dirtyBox, m_bDirty, m_aPatches,
+                 m_aQuarterPatches, m_auNumPatches, m_patchBuffer,
+                 m_cbTerrain].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT HeightfieldTerrain::UpdatePatches(_In_ ID3D11DeviceContext* pImmediateContext, _In_ const XMFLOAT3& eye)
+    {
+        if (!m_patchBuffer)
+        {
+            return S_OK;
+        }
+
+        if (m_bDirty)
+        {
+            const size_t uFirstIdx = static_cast<size_t>(m_dirtyBox.top) * m_uWidth + m_dirtyBox.left;
+            pImmediateContext->UpdateSubresource(m_heightTexture.Get(), 0u, &m_dirtyBox, &m_aTexels[uFirstIdx * 2u], m_uWidth * 2u * static_cast<UINT>(sizeof(WORD)), 0u);
+            m_bDirty = FALSE;
+        }
+
+        m_quadtree.Select(eye.x, eye.y, eye.z, m_aPatches, m_aQuarterPatches);
+
+        D3D11_MAPPED_SUBRESOURCE mappedPatches = {};
+        HRESULT hr = pImmediateContext->Map(m_patchBuffer.Get(), 0u, D3D11_MAP_WRITE_DISCARD, 0u, &mappedPatches);
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        TerrainPatchData* pPatches = static_cast<TerrainPatchData*>(mappedPatches.pData);
+        m_auNumPatches[0] = std::min(static_cast<UINT>(m_aPatches.size()), m_uMaxNumPatches);
+        m_auNumPatches[1] = std::min(static_cast<UINT>(m_aQuarterPatches.size()), m_uMaxNumPatches - m_auNumPatches[0]);
+        const std::vector<TerrainPatch>* apMeshPatches[NUM_MESHES] = { &m_aPatches, &m_aQuarterPatches };
+        for (UINT uMeshIdx = 0u; uMeshIdx < NUM_MESHES; ++uMeshIdx)
+        {
+            for (UINT uPatchIdx = 0u; uPatchIdx < m_auNumPatches[uMeshIdx]; ++uPatchIdx)
+            {
+                const TerrainPatch& patch = (*apMeshPatches[uMeshIdx])[uPatchIdx];
+                *pPatches++ = TerrainPatchData
+                {
+                    .X = static_cast<FLOAT>(patch.X),
+                    .Z = static_cast<FLOAT>(patch.Z),
+                    .Size = static_cast<FLOAT>(patch.Size),
+                    .Lod = static_cast<FLOAT>(patch.Lod)
+                };
+            }
+        }
+        pImmediateContext->Unmap(m_patchBuffer.Get(), 0u);
+
+        CBTerrain cbTerrain =
+        {
+            .Eye = XMFLOAT4(eye.x, eye.y, eye.z, 1.0f),
+            .MorphRanges = {},
+            .MapSize = XMUINT4(m_uWidth, m_uDepth, 0u, 0u)
+        };
+        for (UINT uLod = 0u; uLod < m_quadtree.GetNumLods(); ++uLod)
+        {
+            FLOAT start = 0.0f;
+            FLOAT end = 0.0f;
+            m_quadtree.GetMorphRange(uLod, start, end);
+            cbTerrain.MorphRanges[uLod] = XMFLOAT4(start, end, 0.0f, 0.0f);
+        }
+        pImmediateContext->UpdateSubresource(m_cbTerrain.Get(), 0u, nullptr, &cbTerrain, 0u, 0u);
+
+        return S_OK;
+    }
+
+    ComPtr<ID3D11Buffer>& HeightfieldTerrain::GetPatchBuffer()
+    {
+        return m_patchBuffer;
+    }
+
+    ComPtr<ID3D11Buffer>& HeightfieldTerrain::GetTerrainConstantBuffer()
+    {
+        return m_cbTerrain;
+    }
+
+    ComPtr<ID3D11ShaderResourceView>& HeightfieldTerrain::GetHeightTextureView()
+    {
+        return m_heightTextureView;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HeightfieldTerrain::GetNumPatches
+
+      Summary:  Returns the number of patches drawn with a mesh. The
+                patches of mesh 1 follow those of mesh 0 in the buffer
+
+      Args:     UINT uMeshIndex
+                  0 for the whole patches, 1 for the quarter patches
+
+      Returns:  UINT
+                  Number of patches
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT HeightfieldTerrain::GetNumPatches(_In_ UINT uMeshIndex) const
+    {
+        return uMeshIndex < NUM_MESHES ? m_auNumPatches[uMeshIndex] : 0u;
+    }
+
+    const TerrainQuadtree& HeightfieldTerrain::GetQuadtree() const
+    {
+        return m_quadtree;
+    }
+
+    UINT HeightfieldTerrain::GetNumVertices() const
+    {
+        return static_cast<UINT>(m_aVertices.size());
+    }
+
+    UINT HeightfieldTerrain::GetNumIndices() const
+    {
+        return static_cast<UINT>(m_aIndices.size());
+    }
+
+    const SimpleVertex* HeightfieldTerrain::getVertices() const
+    {
+        return m_aVertices.data();
+    }
+
+    const WORD* HeightfieldTerrain::getIndices() const
+    {
+        return m_aIndices.data();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HeightfieldTerrain::buildGrid
+
+      Summary:  Builds the vertices of the grid over the unit square of
+                the xz plane, the indices of mesh 0 over every quad and
+                those of mesh 1 over every other vertex
+
+      Modifies: [m_aVertices, m_aIndices, m_aMeshes].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void HeightfieldTerrain::buildGrid()
+    {
+        constexpr const UINT uNumRowVertices = GRID_SIZE + 1u;
+        static_assert(uNumRowVertices * uNumRowVertices <= 65536u, "The grid is indexed with WORD");
+
+        m_aVertices.clear();
+        m_aVertices.reserve(static_cast<size_t>(uNumRowVertices) * uNumRowVertices);
+        for (UINT z = 0u; z < uNumRowVertices; ++z)
+        {
+            for (UINT x = 0u; x < uNumRowVertices; ++x)
+            {
+                const FLOAT u = static_cast<FLOAT>(x) / static_cast<FLOAT>(GRID_SIZE);
+                const FLOAT v = static_cast<FLOAT>(z) / static_cast<FLOAT>(GRID_SIZE);
+                m_aVertices.push_back(SimpleVertex{ .Position = XMFLOAT3(u, 0.0f, v), .TexCoord = XMFLOAT2(u, v), .Normal = XMFLOAT3(0.0f, 1.0f, 0.0f) });
+            }
+        }
+
+        m_aIndices.clear();
+        m_aMeshes.clear();
+        for (UINT uMeshIdx = 0u; uMeshIdx < NUM_MESHES; ++uMeshIdx)
+        {
+            const UINT uStep = 1u << uMeshIdx;
+            BasicMeshEntry mesh;
+            mesh.uBaseIndex = static_cast<UINT>(m_aIndices.size());
+            for (UINT z = 0u; z < GRID_SIZE; z += uStep)
+            {
+                for (UINT x = 0u; x < GRID_SIZE; x += uStep)
+                {
+                    const WORD v00 = static_cast<WORD>(z * uNumRowVertices + x);
+                    const WORD v10 = static_cast<WORD>(v00 + uStep);
+                    const WORD v01 = static_cast<WORD>(v00 + uStep * uNumRowVertices);
+                    const WORD v11 = static_cast<WORD>(v01 + uStep);
+                    m_aIndices.insert(m_aIndices.end(), { v00, v01, v11, v00, v11, v10 });
+                }
+            }
+            mesh.uNumIndices = static_cast<UINT>(m_aIndices.size()) - mesh.uBaseIndex;
+            m_aMeshes.push_back(mesh);
+        }
+    }
+}
@@ -0,0 +1,125 @@
+/*+===================================================================
+  File:      HEIGHTFIELDTERRAIN.H
+
+  Summary:   HeightfieldTerrain header file contains declarations of
+             the HeightfieldTerrain class that draws the columns of a
+             voxel map as a smooth surface instead of cubes.
+
+  Classes: HeightfieldTerrain
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include <algorithm>
+
+#include "Renderer/DataTypes.h"
+#include "Renderer/Renderable.h"
+#include "Scene/TerrainQuadtree.h"
+#include "Scene/VoxelMap.h"
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    HeightfieldTerrain
+
+      Summary:  Heightfield terrain drawn with a single grid mesh at
+                each patch the quadtree selects around the camera. The
+                vertex buffer holds a grid of GRID_SIZE x GRID_SIZE
+                quads over the unit square, mesh 0 indexes all of them
+                for the whole patches and mesh 1 every other vertex for
+                the quarter patches, so the patches of both meshes are
+                drawn with one instanced draw each. The height and the
+                block type of every column are in a texture the vertex
+                shader reads to place and morph the vertices, so the
+                number of triangles only depends on the number of
+                patches. Changed columns are copied to the texture by
+                the next UpdatePatches
+
+      Methods:  Initialize
+                  Creates the grid, the texture and the buffers
+                Update
+                  Does nothing, the patches follow the camera
+                SetColumns
+                  Copies a rectangle of columns
+                UpdatePatches
+                  Selects and uploads the patches around the camera
+                GetPatchBuffer
+                  Returns the buffer of the selected patches
+                GetTerrainConstantBuffer
+                  Returns the constant buffer of the morph ranges
+                GetHeightTextureView
+                  Returns the view of the texture of the columns
+                GetNumPatches
+                  Returns the number of patches drawn with a mesh
+                GetQuadtree
+                  Returns the quadtree
+                GetNumVertices
+                  Returns the number of vertices of the grid
+                GetNumIndices
+                  Returns the number of indices of both meshes
+                HeightfieldTerrain
+                  Constructor.
+                ~HeightfieldTerrain
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class HeightfieldTerrain : public Renderable
+    {
+    public:
+        static constexpr const UINT GRID_SIZE = TerrainQuadtree::PATCH_SIZE;
+        static constexpr const UINT NUM_MESHES = 2u;
+
+        static_assert(TerrainQuadtree::MAX_NUM_LODS == MAX_NUM_TERRAIN_LODS, "CBTerrain holds the morph range of every level");
+        static_assert(GRID_SIZE % 2u == 0u, "The quarter patches use every other vertex of the grid");
+
+    public:
+        HeightfieldTerrain(_In_ UINT uWidth, _In_ UINT uDepth, _In_ UINT uNumLods, _In_ FLOAT lodDistance, _In_ FLOAT morphRatio);
+        HeightfieldTerrain(const HeightfieldTerrain& other) = delete;
+        HeightfieldTerrain(HeightfieldTerrain&& other) = delete;
+        HeightfieldTerrain& operator=(const HeightfieldTerrain& other) = delete;
+        HeightfieldTerrain& operator=(HeightfieldTerrain&& other) = delete;
+        virtual ~HeightfieldTerrain() = default;
+
+        virtual HRESULT Initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext) override;
+        virtual void Update(_In_ FLOAT deltaTime) override;
+
+        void SetColumns(_In_ UINT uX, _In_ UINT uZ, _In_ UINT uWidth, _In_ UINT uDepth, _In_ const WORD* pHeights, _In_ const VoxelColumn* pColumns);
+        HRESULT UpdatePatches(_In_ ID3D11DeviceContext* pImmediateContext, _In_ const XMFLOAT3& eye);
+
+        ComPtr<ID3D11Buffer>& GetPatchBuffer();
+        ComPtr<ID3D11Buffer>& GetTerrainConstantBuffer();
+        ComPtr<ID3D11ShaderResourceView>& GetHeightTextureView();
+        UINT GetNumPatches(_In_ UINT uMeshIndex) const;
+        const TerrainQuadtree& GetQuadtree() const;
+
+        UINT GetNumVertices() const override;
+        UINT GetNumIndices() const override;
+
+    protected:
+        const SimpleVertex* getVertices() const override;
+        const WORD* getIndices() const override;
+
+    private:
+        void buildGrid();
+
+    private:
+        UINT m_uWidth;
+        UINT m_uDepth;
+        TerrainQuadtree m_quadtree;
+        std::vector<SimpleVertex> m_aVertices;
+        std::vector<WORD> m_aIndices;
+        std::vector<WORD> m_aTexels;
+        D3D11_BOX m_dirtyBox;
+        BOOL m_bDirty;
+        std::vector<TerrainPatch> m_aPatches;
+        std::vector<TerrainPatch> m_aQuarterPatches;
+        UINT m_auNumPatches[NUM_MESHES];
+        UINT m_uMaxNumPatches;
+        ComPtr<ID3D11Texture2D> m_heightTexture;
+        ComPtr<ID3D11ShaderResourceView> m_heightTextureView;
+        ComPtr<ID3D11Buffer> m_patchBuffer;
+        ComPtr<ID3D11Buffer> m_cbTerrain;
+    };
+}
@@ -0,0 +1,470 @@
+#include "Scene/PerlinNoise.h"
+
+#include <cmath>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#define PERLIN_NOISE_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   PerlinNoise::PerlinNoise
+
+      Summary:  Constructor. A non-zero seed shuffles the hashes with
+                a Fisher-Yates shuffle driven by a linear congruential
+                generator, so the table is the same on every platform
+                and standard library
+
+      Args:     UINT uSeed
+                  Seed of the noise
+
+      Modifies: [m_aHashes, m_uSeed].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    PerlinNoise::PerlinNoise(_In_ UINT uSeed)
+        : m_aHashes()
+        , m_uSeed(uSeed)
+    {
+        for (UINT i = 0u; i < NUM_HASHES; ++i)
+        {
+            m_aHashes[i] = ms_aDefaultHashes[i];
+        }
+
+        if (uSeed == 0u)
+        {
+            return;
+        }
+
+        UINT uState = uSeed;
+        for (UINT i = NUM_HASHES - 1u; i > 0u; --i)
+        {
+            uState = uState * 1664525u + 1013904223u;
+            std::swap(m_aHashes[i], m_aHashes[(uState >> 8u) % (i + 1u)]);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   PerlinNoise::GetPerlin2d
+
+      Summary:  Sums uDepth octaves of noise, doubling the frequency
+                and halving the amplitude of each octave
+
+      Args:     FLOAT x, FLOAT y
+                  Coordinates of the sample
+                FLOAT frequency
+                  Frequency of the first octave
+                UINT uDepth
+                  Number of octaves
+
+      Returns:  FLOAT
+                  Noise in [0, 1)
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    FLOAT PerlinNoise::GetPerlin2d(_In_ FLOAT x, _In_ FLOAT y, _In_ FLOAT frequency, _In_ UINT uDepth) const
+    {
+        FLOAT xa = x * frequency;
+        FLOAT ya = y * frequency;
+        FLOAT amp = 1.0f;
+        FLOAT fin = 0.0f;
+        FLOAT div = 0.0f;
+
+        for (UINT i = 0; i < uDepth; ++i)
+        {
+            div += 256.0f * amp;
+            fin += getNoise2d(xa, ya) * amp;
+            amp /= 2.0f;
+            xa *= 2.0f;
+            ya *= 2.0f;
+        }
+
+        return fin / div;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   PerlinNoise::GetPerlin2dBatch
+
+      Summary:  Evaluates GetPerlin2d over a grid of samples, four
+                samples of a row at a time with SSE2 where the target
+                has it. The hashes of the rows of the lattice are read
+                once per row and octave, and the arithmetic follows
+                the scalar path operation by operation, so each sample
+                is bit-identical to GetPerlin2d(x + i * step,
+                y + j * step, frequency, uDepth) for coordinates
+                between -2^31 and 2^31
+
+      Args:     FLOAT x, FLOAT y
+                  Coordinates of the first sample
+                FLOAT step
+                  Distance between two neighboring samples
+                UINT uNumX
+                  Number of samples of a row
+                UINT uNumY
+                  Number of rows
+                FLOAT frequency
+                  Frequency of the first octave
+                UINT uDepth
+                  Number of octaves
+                FLOAT* pSamples
+                  Receives the samples, row by row
+
+      Modifies: [pSamples].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void PerlinNoise::GetPerlin2dBatch(_In_ FLOAT x, _In_ FLOAT y, _In_ FLOAT step, _In_ UINT uNumX, _In_ UINT uNumY, _In_ FLOAT frequency, _In_ UINT uDepth, _Out_writes_(static_cast<size_t>(uNumX) * uNumY) FLOAT* pSamples) const
+    {
+#ifdef PERLIN_NOISE_SSE2
+        FLOAT amp = 1.0f;
+        FLOAT div = 0.0f;
+        for (UINT i = 0; i < uDepth; ++i)
+        {
+            div += 256.0f * amp;
+            amp /= 2.0f;
+        }
+
+        const __m128 two = _mm_set1_ps(2.0f);
+        const __m128 three = _mm_set1_ps(3.0f);
+#endif
+        for (UINT j = 0u; j < uNumY; ++j)
+        {
+            const FLOAT rowY = y + static_cast<FLOAT>(j) * step;
+            FLOAT* pRow = pSamples + static_cast<size_t>(j) * uNumX;
+
+            UINT i = 0u;
+#ifdef PERLIN_NOISE_SSE2
+            for (; i + 4u <= uNumX; i += 4u)
+            {
+                const __m128 sampleX = _mm_add_ps(
+                    _mm_set1_ps(x),
+                    _mm_mul_ps(_mm_setr_ps(static_cast<FLOAT>(i), static_cast<FLOAT>(i + 1u), static_cast<FLOAT>(i + 2u), static_cast<FLOAT>(i + 3u)), _mm_set1_ps(step))
+                );
+
+                __m128 xa = _mm_mul_ps(sampleX, _mm_set1_ps(frequency));
+                FLOAT ya = rowY * frequency;
+                __m128 fin = _mm_setzero_ps();
+                amp = 1.0f;
+                for (UINT uOctave = 0u; uOctave < uDepth; ++uOctave)
+                {
+                    // Every sample of the row shares the rows of the lattice
+                    const FLOAT yFloor = std::floor(ya);
+                    const UINT uY = static_cast<UINT>(static_cast<INT>(yFloor));
+                    const FLOAT yFrac = ya - yFloor;
+                    const UINT uLow = m_aHashes[uY % NUM_HASHES];
+                    const UINT uHigh = m_aHashes[(uY + 1u) % NUM_HASHES];
+
+                    // Truncation rounds negative coordinates up, 1 is taken back where it did as std::floor does
+                    alignas(16) INT aX[4];
+                    const __m128i truncated = _mm_cvttps_epi32(xa);
+                    const __m128i floors = _mm_add_epi32(truncated, _mm_castps_si128(_mm_cmplt_ps(xa, _mm_cvtepi32_ps(truncated))));
+                    _mm_store_si128(reinterpret_cast<__m128i*>(aX), floors);
+                    const __m128 xFrac = _mm_sub_ps(xa, _mm_cvtepi32_ps(floors));
+
+                    alignas(16) FLOAT aS[4];
+                    alignas(16) FLOAT aT[4];
+                    alignas(16) FLOAT aU[4];
+                    alignas(16) FLOAT aV[4];
+                    for (UINT uLane = 0u; uLane < 4u; ++uLane)
+                    {
+                        const UINT uX = static_cast<UINT>(aX[uLane]);
+                        aS[uLane] = static_cast<FLOAT>(m_aHashes[(uLow + uX) % NUM_HASHES]);
+                        aT[uLane] = static_cast<FLOAT>(m_aHashes[(uLow + uX + 1u) % NUM_HASHES]);
+                        aU[uLane] = static_cast<FLOAT>(m_aHashes[(uHigh + uX) % NUM_HASHES]);
+                        aV[uLane] = static_cast<FLOAT>(m_aHashes[(uHigh + uX + 1u) % NUM_HASHES]);
+                    }
+
+                    const __m128 s = _mm_load_ps(aS);
+                    const __m128 u = _mm_load_ps(aU);
+                    const __m128 xWeight = _mm_mul_ps(_mm_mul_ps(xFrac, xFrac), _mm_sub_ps(three, _mm_mul_ps(two, xFrac)));
+                    const __m128 low = _mm_add_ps(s, _mm_mul_ps(xWeight, _mm_sub_ps(_mm_load_ps(aT), s)));
+                    const __m128 high = _mm_add_ps(u, _mm_mul_ps(xWeight, _mm_sub_ps(_mm_load_ps(aV), u)));
+                    const __m128 yWeight = _mm_set1_ps(yFrac * yFrac * (3.0f - 2.0f * yFrac));
+                    const __m128 noise = _mm_add_ps(low, _mm_mul_ps(yWeight, _mm_sub_ps(high, low)));
+
+                    fin = _mm_add_ps(fin, _mm_mul_ps(noise, _mm_set1_ps(amp)));
+                    amp /= 2.0f;
+                    xa = _mm_mul_ps(xa, two);
+                    ya *= 2.0f;
+                }
+
+                _mm_storeu_ps(pRow + i, _mm_div_ps(fin, _mm_set1_ps(div)));
+            }
+#endif
+            for (; i < uNumX; ++i)
+            {
+                pRow[i] = GetPerlin2d(x + static_cast<FLOAT>(i) * step, rowY, frequency, uDepth);
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   PerlinNoise::GetGradient3d
+
+      Summary:  Sums uDepth octaves of gradient noise, doubling the
+                frequency and halving the amplitude of each octave
+
+      Args:     FLOAT x, FLOAT y, FLOAT z
+                  Coordinates of the sample
+                FLOAT frequency
+                  Frequency of the first octave
+                UINT uDepth
+                  Number of octaves
+
+      Returns:  FLOAT
+                  Noise in [-1, 1]
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    FLOAT PerlinNoise::GetGradient3d(_In_ FLOAT x, _In_ FLOAT y, _In_ FLOAT z, _In_ FLOAT frequency, _In_ UINT uDepth) const
+    {
+        FLOAT xa = x * frequency;
+        FLOAT ya = y * frequency;
+        FLOAT za = z * frequency;
+        FLOAT amp = 1.0f;
+        FLOAT fin = 0.0f;
+        FLOAT div = 0.0f;
+
+        for (UINT i = 0; i < uDepth; ++i)
+        {
+            div += amp;
+            fin += getGradient3d(xa, ya, za) * amp;
+            amp /= 2.0f;
+            xa *= 2.0f;
+            ya *= 2.0f;
+            za *= 2.0f;
+        }
+
+        return fin / div;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   PerlinNoise::GetGradient3dBatch
+
+      Summary:  Evaluates GetGradient3d along a row of samples, four
+                samples at a time with SSE2 where the target has it.
+                The samples of a row share the hashes of the lattice
+                along y and z, so only the last hash and the gradient
+                are looked up per sample. Each sample is bit-identical
+                to GetGradient3d(x + i * step, y, z, frequency, uDepth)
+                for coordinates between -2^31 and 2^31
+
+      Args:     FLOAT x, FLOAT y, FLOAT z
+                  Coordinates of the first sample
+                FLOAT step
+                  Distance between two neighboring samples
+                UINT uNumX
+                  Number of samples
+                FLOAT frequency
+                  Frequency of the first octave
+                UINT uDepth
+                  Number of octaves
+                FLOAT* pSamples
+                  Receives the samples
+
+      Modifies: [pSamples].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void PerlinNoise::GetGradient3dBatch(_In_ FLOAT x, _In_ FLOAT y, _In_ FLOAT z, _In_ FLOAT step, _In_ UINT uNumX, _In_ FLOAT frequency, _In_ UINT uDepth, _Out_writes_(uNumX) FLOAT* pSamples) const
+    {
+        UINT i = 0u;
+#ifdef PERLIN_NOISE_SSE2
+        FLOAT amp = 1.0f;
+        FLOAT div = 0.0f;
+        for (UINT uOctave = 0u; uOctave < uDepth; ++uOctave)
+        {
+            div += amp;
+            amp /= 2.0f;
+        }
+
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 two = _mm_set1_ps(2.0f);
+        const __m128 six = _mm_set1_ps(6.0f);
+        const __m128 ten = _mm_set1_ps(10.0f);
+        const __m128 fifteen = _mm_set1_ps(15.0f);
+        for (; i + 4u <= uNumX; i += 4u)
+        {
+            const __m128 sampleX = _mm_add_ps(
+                _mm_set1_ps(x),
+                _mm_mul_ps(_mm_setr_ps(static_cast<FLOAT>(i), static_cast<FLOAT>(i + 1u), static_cast<FLOAT>(i + 2u), static_cast<FLOAT>(i + 3u)), _mm_set1_ps(step))
+            );
+
+            __m128 xa = _mm_mul_ps(sampleX, _mm_set1_ps(frequency));
+            FLOAT ya = y * frequency;
+            FLOAT za = z * frequency;
+            __m128 fin = _mm_setzero_ps();
+            amp = 1.0f;
+            for (UINT uOctave = 0u; uOctave < uDepth; ++uOctave)
+            {
+                const FLOAT yFloor = std::floor(ya);
+                const FLOAT zFloor = std::floor(za);
+                const UINT uY = static_cast<UINT>(static_cast<INT>(yFloor));
+                const UINT uZ = static_cast<UINT>(static_cast<INT>(zFloor));
+                const FLOAT yFrac = ya - yFloor;
+                const FLOAT zFrac = za - zFloor;
+
+                // Every sample of the row shares the hashes of the 4 rows of the lattice around it
+                UINT aRowHashes[4];
+                for (UINT uRow = 0u; uRow < 4u; ++uRow)
+                {
+                    aRowHashes[uRow] = m_aHashes[(m_aHashes[(uZ + (uRow >> 1u)) % NUM_HASHES] + uY + (uRow & 1u)) % NUM_HASHES];
+                }
+
+                // Truncation rounds negative coordinates up, 1 is taken back where it did as std::floor does
+                alignas(16) INT aX[4];
+                const __m128i truncated = _mm_cvttps_epi32(xa);
+                const __m128i floors = _mm_add_epi32(truncated, _mm_castps_si128(_mm_cmplt_ps(xa, _mm_cvtepi32_ps(truncated))));
+                _mm_store_si128(reinterpret_cast<__m128i*>(aX), floors);
+                const __m128 xFrac = _mm_sub_ps(xa, _mm_cvtepi32_ps(floors));
+
+                __m128 aDots[8];
+                for (UINT uCorner = 0u; uCorner < 8u; ++uCorner)
+                {
+                    const UINT uOffsetX = uCorner & 1u;
+                    const UINT uRow = uCorner >> 1u;
+
+                    alignas(16) FLOAT aGradientX[4];
+                    alignas(16) FLOAT aGradientY[4];
+                    alignas(16) FLOAT aGradientZ[4];
+                    for (UINT uLane = 0u; uLane < 4u; ++uLane)
+                    {
+                        const FLOAT* pGradient = ms_aGradients[m_aHashes[(aRowHashes[uRow] + static_cast<UINT>(aX[uLane]) + uOffsetX) % NUM_HASHES] & 15u];
+                        aGradientX[uLane] = pGradient[0];
+                        aGradientY[uLane] = pGradient[1];
+                        aGradientZ[uLane] = pGradient[2];
+                    }
+
+                    const __m128 dx = uOffsetX ? _mm_sub_ps(xFrac, one) : xFrac;
+                    const __m128 dy = _mm_set1_ps((uRow & 1u) ? yFrac - 1.0f : yFrac);
+                    const __m128 dz = _mm_set1_ps((uRow >> 1u) ? zFrac - 1.0f : zFrac);
+                    aDots[uCorner] = _mm_add_ps(
+                        _mm_add_ps(_mm_mul_ps(_mm_load_ps(aGradientX), dx), _mm_mul_ps(_mm_load_ps(aGradientY), dy)),
+                        _mm_mul_ps(_mm_load_ps(aGradientZ), dz)
+                    );
+                }
+
+                const __m128 u = _mm_mul_ps(
+                    _mm_mul_ps(_mm_mul_ps(xFrac, xFrac), xFrac),
+                    _mm_add_ps(_mm_mul_ps(xFrac, _mm_sub_ps(_mm_mul_ps(xFrac, six), fifteen)), ten)
+                );
+                const __m128 v = _mm_set1_ps(fade(yFrac));
+                const __m128 w = _mm_set1_ps(fade(zFrac));
+
+                // Corner c is at (c & 1, (c >> 1) & 1, c >> 2)
+                __m128 aLerpsX[4];
+                for (UINT uRow = 0u; uRow < 4u; ++uRow)
+                {
+                    const __m128 low = aDots[uRow * 2u];
+                    aLerpsX[uRow] = _mm_add_ps(low, _mm_mul_ps(u, _mm_sub_ps(aDots[uRow * 2u + 1u], low)));
+                }
+                const __m128 low = _mm_add_ps(aLerpsX[0], _mm_mul_ps(v, _mm_sub_ps(aLerpsX[1], aLerpsX[0])));
+                const __m128 high = _mm_add_ps(aLerpsX[2], _mm_mul_ps(v, _mm_sub_ps(aLerpsX[3], aLerpsX[2])));
+                const __m128 noise = _mm_add_ps(low, _mm_mul_ps(w, _mm_sub_ps(high, low)));
+
+                fin = _mm_add_ps(fin, _mm_mul_ps(noise, _mm_set1_ps(amp)));
+                amp /= 2.0f;
+                xa = _mm_mul_ps(xa, two);
+                ya *= 2.0f;
+                za *= 2.0f;
+            }
+
+            _mm_storeu_ps(pSamples + i, _mm_div_ps(fin, _mm_set1_ps(div)));
+        }
+#endif
+        for (; i < uNumX; ++i)
+        {
+            pSamples[i] = GetGradient3d(x + static_cast<FLOAT>(i) * step, y, z, frequency, uDepth);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   PerlinNoise::GetSeed
+
+      Summary:  Returns the seed
+
+      Returns:  UINT
+                  Seed of the noise
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT PerlinNoise::GetSeed() const
+    {
+        return m_uSeed;
+    }
+
+    FLOAT PerlinNoise::getNoise2(_In_ UINT x, _In_ UINT y) const
+    {
+        UINT temp = m_aHashes[y % NUM_HASHES];
+
+        return static_cast<FLOAT>(m_aHashes[(temp + x) % NUM_HASHES]);
+    }
+
+    FLOAT PerlinNoise::getNoise2d(_In_ FLOAT x, _In_ FLOAT y) const
+    {
+        const FLOAT xFloor = std::floor(x);
+        const FLOAT yFloor = std::floor(y);
+        UINT uX = static_cast<UINT>(static_cast<INT>(xFloor));
+        UINT uY = static_cast<UINT>(static_cast<INT>(yFloor));
+        FLOAT xFrac = x - xFloor;
+        FLOAT yFrac = y - yFloor;
+
+        UINT s = static_cast<UINT>(getNoise2(uX, uY));
+        UINT t = static_cast<UINT>(getNoise2(uX + 1u, uY));
+        UINT u = static_cast<UINT>(getNoise2(uX, uY + 1u));
+        UINT v = static_cast<UINT>(getNoise2(uX + 1u, uY + 1u));
+
+        FLOAT low = smoothLerp(static_cast<FLOAT>(s), static_cast<FLOAT>(t), xFrac);
+        FLOAT high = smoothLerp(static_cast<FLOAT>(u), static_cast<FLOAT>(v), xFrac);
+
+        return smoothLerp(low, high, yFrac);
+    }
+
+    FLOAT PerlinNoise::lerp(_In_ FLOAT x, _In_ FLOAT y, _In_ FLOAT s)
+    {
+        return x + s * (y - x);
+    }
+
+    FLOAT PerlinNoise::smoothLerp(_In_ FLOAT x, _In_ FLOAT y, _In_ FLOAT s)
+    {
+        return lerp(x, y, s * s * (3.0f - 2.0f * s));
+    }
+
+    UINT PerlinNoise::getHash3(_In_ UINT x, _In_ UINT y, _In_ UINT z) const
+    {
+        return m_aHashes[(m_aHashes[(m_aHashes[z % NUM_HASHES] + y) % NUM_HASHES] + x) % NUM_HASHES];
+    }
+
+    FLOAT PerlinNoise::getGradient3d(_In_ FLOAT x, _In_ FLOAT y, _In_ FLOAT z) const
+    {
+        const FLOAT xFloor = std::floor(x);
+        const FLOAT yFloor = std::floor(y);
+        const FLOAT zFloor = std::floor(z);
+        UINT uX = static_cast<UINT>(static_cast<INT>(xFloor));
+        UINT uY = static_cast<UINT>(static_cast<INT>(yFloor));
+        UINT uZ = static_cast<UINT>(static_cast<INT>(zFloor));
+        FLOAT xFrac = x - xFloor;
+        FLOAT yFrac = y - yFloor;
+        FLOAT zFrac = z - zFloor;
+
+        FLOAT d000 = getGradientDot(getHash3(uX, uY, uZ), xFrac, yFrac, zFrac);
+        FLOAT d100 = getGradientDot(getHash3(uX + 1u, uY, uZ), xFrac - 1.0f, yFrac, zFrac);
+        FLOAT d010 = getGradientDot(getHash3(uX, uY + 1u, uZ), xFrac, yFrac - 1.0f, zFrac);
+        FLOAT d110 = getGradientDot(getHash3(uX + 1u, uY + 1u, uZ), xFrac - 1.0f, yFrac - 1.0f, zFrac);
+        FLOAT d001 = getGradientDot(getHash3(uX, uY, uZ + 1u), xFrac, yFrac, zFrac - 1.0f);
+        FLOAT d101 = getGradientDot(getHash3(uX + 1u, uY, uZ + 1u), xFrac - 1.0f, yFrac, zFrac - 1.0f);
+        FLOAT d011 = getGradientDot(getHash3(uX, uY + 1u, uZ + 1u), xFrac, yFrac - 1.0f, zFrac - 1.0f);
+        FLOAT d111 = getGradientDot(getHash3(uX + 1u, uY + 1u, uZ + 1u), xFrac - 1.0f, yFrac - 1.0f, zFrac - 1.0f);
+
+        FLOAT u = fade(xFrac);
+        FLOAT v = fade(yFrac);
+        FLOAT w = fade(zFrac);
+
+        FLOAT low = lerp(lerp(d000, d100, u), lerp(d010, d110, u), v);
+        FLOAT high = lerp(lerp(d001, d101, u), lerp(d011, d111, u), v);
+
+        return lerp(low, high, w);
+    }
+
+    FLOAT PerlinNoise::getGradientDot(_In_ UINT uHash, _In_ FLOAT x, _In_ FLOAT y, _In_ FLOAT z)
+    {
+        const FLOAT* pGradient = ms_aGradients[uHash & 15u];
+
+        return pGradient[0] * x + pGradient[1] * y + pGradient[2] * z;
+    }
+
+    FLOAT PerlinNoise::fade(_In_ FLOAT t)
+    {
+        return t * t * t * (t * (t * 6.0f - 15.0f) + 10.0f);
+    }
+}
@@ -0,0 +1,104 @@
+/*+===================================================================
+  File:      PERLINNOISE.H
+
+  Summary:   PerlinNoise header file contains declarations of the
+             PerlinNoise class that samples seeded value noise and
+             gradient noise for terrain generation, without
+             Direct3D.
+
+  Classes: PerlinNoise
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Platform.h"
+
+#include <utility>
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    PerlinNoise
+
+      Summary:  Octaves of smoothed 2D value noise and 3D gradient
+                noise over a lattice of 256 hashes. The seed shuffles
+                the hashes, and seed 0 keeps the original table. The
+                methods are const, so one instance can be sampled from
+                any number of threads
+
+      Methods:  GetPerlin2d
+                  Returns the value noise at a point
+                GetPerlin2dBatch
+                  Returns the value noise over a grid of points
+                GetGradient3d
+                  Returns the gradient noise at a point
+                GetGradient3dBatch
+                  Returns the gradient noise along a row of points
+                GetSeed
+                  Returns the seed
+                PerlinNoise
+                  Constructor.
+                ~PerlinNoise
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class PerlinNoise final
+    {
+    public:
+        static constexpr const UINT NUM_HASHES = 256u;
+
+    public:
+        explicit PerlinNoise(_In_ UINT uSeed = 0u);
+        PerlinNoise(const PerlinNoise& other) = delete;
+        PerlinNoise(PerlinNoise&& other) = delete;
+        PerlinNoise& operator=(const PerlinNoise& other) = delete;
+        PerlinNoise& operator=(PerlinNoise&& other) = delete;
+        ~PerlinNoise() = default;
+
+        FLOAT GetPerlin2d(_In_ FLOAT x, _In_ FLOAT y, _In_ FLOAT frequency, _In_ UINT uDepth) const;
+        void GetPerlin2dBatch(_In_ FLOAT x, _In_ FLOAT y, _In_ FLOAT step, _In_ UINT uNumX, _In_ UINT uNumY, _In_ FLOAT frequency, _In_ UINT uDepth, _Out_writes_(static_cast<size_t>(uNumX) * uNumY) FLOAT* pSamples) const;
+        FLOAT GetGradient3d(_In_ FLOAT x, _In_ FLOAT y, _In_ FLOAT z, _In_ FLOAT frequency, _In_ UINT uDepth) const;
+        void GetGradient3dBatch(_In_ FLOAT x, _In_ FLOAT y, _In_ FLOAT z, _In_ FLOAT step, _In_ UINT uNumX, _In_ FLOAT frequency, _In_ UINT uDepth, _Out_writes_(uNumX) FLOAT* pSamples) const;
+        UINT GetSeed() const;
+
+    private:
+        FLOAT getNoise2(_In_ UINT x, _In_ UINT y) const;
+        FLOAT getNoise2d(_In_ FLOAT x, _In_ FLOAT y) const;
+        static FLOAT lerp(_In_ FLOAT x, _In_ FLOAT y, _In_ FLOAT s);
+        static FLOAT smoothLerp(_In_ FLOAT x, _In_ FLOAT y, _In_ FLOAT s);
+        UINT getHash3(_In_ UINT x, _In_ UINT y, _In_ UINT z) const;
+        FLOAT getGradient3d(_In_ FLOAT x, _In_ FLOAT y, _In_ FLOAT z) const;
+        static FLOAT getGradientDot(_In_ UINT uHash, _In_ FLOAT x, _In_ FLOAT y, _In_ FLOAT z);
+        static FLOAT fade(_In_ FLOAT t);
+
+    private:
+        static constexpr const UINT ms_aDefaultHashes[NUM_HASHES] =
+        {
+            208,34,231,213,32,248,233,56,161,78,24,140,71,48,140,254,245,255,247,247,40,
+            185,248,251,245,28,124,204,204,76,36,1,107,28,234,163,202,224,245,128,167,204,
+            9,92,217,54,239,174,173,102,193,189,190,121,100,108,167,44,43,77,180,204,8,81,
+            70,223,11,38,24,254,210,210,177,32,81,195,243,125,8,169,112,32,97,53,195,13,
+            203,9,47,104,125,117,114,124,165,203,181,235,193,206,70,180,174,0,167,181,41,
+            164,30,116,127,198,245,146,87,224,149,206,57,4,192,210,65,210,129,240,178,105,
+            228,108,245,148,140,40,35,195,38,58,65,207,215,253,65,85,208,76,62,3,237,55,89,
+            232,50,217,64,244,157,199,121,252,90,17,212,203,149,152,140,187,234,177,73,174,
+            193,100,192,143,97,53,145,135,19,103,13,90,135,151,199,91,239,247,33,39,145,
+            101,120,99,3,186,86,99,41,237,203,111,79,220,135,158,42,30,154,120,67,87,167,
+            135,176,183,191,253,115,184,21,233,58,129,233,142,39,128,211,118,137,139,255,
+            114,20,218,113,154,27,127,246,250,1,8,198,250,209,92,222,173,21,88,102,219
+        };
+
+        // Directions to the 12 edges of a cube, with 4 of them repeated
+        static constexpr const FLOAT ms_aGradients[16][3] =
+        {
+            { 1.0f, 1.0f, 0.0f }, { -1.0f, 1.0f, 0.0f }, { 1.0f, -1.0f, 0.0f }, { -1.0f, -1.0f, 0.0f },
+            { 1.0f, 0.0f, 1.0f }, { -1.0f, 0.0f, 1.0f }, { 1.0f, 0.0f, -1.0f }, { -1.0f, 0.0f, -1.0f },
+            { 0.0f, 1.0f, 1.0f }, { 0.0f, -1.0f, 1.0f }, { 0.0f, 1.0f, -1.0f }, { 0.0f, -1.0f, -1.0f },
+            { 1.0f, 1.0f, 0.0f }, { -1.0f, 1.0f, 0.0f }, { 0.0f, -1.0f, 1.0f }, { 0.0f, -1.0f, -1.0f },
+        };
+
+    private:
+        UINT m_aHashes[NUM_HASHES];
+        UINT m_uSeed;
+    };
+}
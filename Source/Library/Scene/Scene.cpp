@@ -3,29 +3,152 @@
 namespace library
 {
 
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Scene::GetPerlin2d
+
+	  Summary:  Samples the unseeded PerlinNoise
+
+	  Args:     FLOAT x, FLOAT y
+				  Coordinates of the sample
+				FLOAT frequency
+				  Frequency of the first octave
+				UINT uDepth
+				  Number of octaves
+
+	  Returns:  FLOAT
+				  Noise in [0, 1)
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
 	FLOAT Scene::GetPerlin2d(FLOAT x, FLOAT y, FLOAT frequency, UINT uDepth)
 	{
-		FLOAT xa = x * frequency;
-		FLOAT ya = y * frequency;
-		FLOAT amp = 1.0f;
-		FLOAT fin = 0.0f;
-		FLOAT div = 0.0f;
+		static const PerlinNoise noise;
+
+		return noise.GetPerlin2d(x, y, frequency, uDepth);
+	}
 
-		for (UINT i = 0; i < uDepth; ++i)
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Scene::GetPerlin2dBatch
+
+	  Summary:  Samples the unseeded PerlinNoise over a grid, see
+				PerlinNoise::GetPerlin2dBatch
+
+	  Args:     FLOAT x, FLOAT y
+				  Coordinates of the first sample
+				FLOAT step
+				  Distance between two neighboring samples
+				UINT uNumX
+				  Number of samples of a row
+				UINT uNumY
+				  Number of rows
+				FLOAT frequency
+				  Frequency of the first octave
+				UINT uDepth
+				  Number of octaves
+				FLOAT* pSamples
+				  Receives the samples, row by row
+
+	  Modifies: [pSamples].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Scene::GetPerlin2dBatch(_In_ FLOAT x, _In_ FLOAT y, _In_ FLOAT step, _In_ UINT uNumX, _In_ UINT uNumY, _In_ FLOAT frequency, _In_ UINT uDepth, _Out_writes_(static_cast<size_t>(uNumX) * uNumY) FLOAT* pSamples)
+	{
+		static const PerlinNoise noise;
+
+		noise.GetPerlin2dBatch(x, y, step, uNumX, uNumY, frequency, uDepth, pSamples);
+	}
+
+	Scene::Scene(const std::filesystem::path& filePath, UINT uNumLoadingThreads, eVoxelRenderMode voxelRenderMode)
+		: m_filePath(filePath)
+		, m_voxels()
+		, m_voxelChunks()
+		, m_aColumns()
+		, m_voxelLods(VoxelChunk::NUM_LODS)
+		, m_aMapDimension{ 0u, }
+		, m_voxelOctree()
+		, m_bVoxelOctreeDirty(FALSE)
+		, m_voxelRayCaster()
+		, m_voxelRenderMode(voxelRenderMode)
+		, m_voxelMeshVertexShader()
+		, m_voxelInstanceBuffer()
+		, m_cbVoxelPalette()
+		, m_uMaxNumVoxelInstances(0u)
+		, m_aVoxelChunkStates()
+		, m_aDirtyVoxelChunks()
+		, m_voxelSlotAllocator()
+		, m_aVoxelStagingBuffers()
+		, m_aNumVoxelStagingSlots{ 0u, }
+		, m_uVoxelStagingIdx(0u)
+		, m_chunkStreamer()
+		, m_terrain()
+		, m_renderables()
+		, m_models()
+		, m_aPointLights{ nullptr }
+		, m_vertexShaders()
+		, m_pixelShaders()
+		, m_materials()
+		, m_skyBox()
+	{
+		UINT uNumThreads = uNumLoadingThreads > 0u ? uNumLoadingThreads : std::thread::hardware_concurrency();
+		if (uNumThreads == 0u)
 		{
-			div += 256.0f * amp;
-			fin += getNoise2d(xa, ya) * amp;
-			amp /= 2.0f;
-			xa *= 2.0f;
-			ya *= 2.0f;
+			uNumThreads = 1u;
 		}
 
-		return fin / div;
+		// A map that does not load is left empty
+		if (m_filePath.extension() == VoxelMapFile::EXTENSION)
+		{
+			loadVoxelMap();
+		}
+		else
+		{
+			loadHeightMap(uNumThreads);
+		}
+
+		buildVoxelMap(uNumThreads);
 	}
 
-	Scene::Scene(const std::filesystem::path& filePath)
-		: m_filePath(filePath)
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Scene::Scene
+
+	  Summary:  Constructor of a generated map. The map starts empty
+				and UpdateVoxelStreaming fills the chunks around the
+				camera as they are generated in the background
+
+	  Args:     UINT uSeed
+				  Seed of the terrain
+				UINT uWidth, UINT uHeight, UINT uDepth
+				  Dimensions of the map, in cubes. The generated
+				  chunks are cached in STREAMING_CACHE_DIRECTORY
+				const std::vector<XMFLOAT3>& aPalette
+				  Color of each block type, from GRASSLAND
+				eVoxelRenderMode voxelRenderMode
+				  How the chunks are drawn
+
+	  Modifies: [m_voxels, m_aColumns, m_aMapDimension,
+				 m_chunkStreamer, and everything buildVoxelMap
+				 modifies].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	Scene::Scene(UINT uSeed, UINT uWidth, UINT uHeight, UINT uDepth, const std::vector<XMFLOAT3>& aPalette, eVoxelRenderMode voxelRenderMode)
+		: m_filePath()
 		, m_voxels()
+		, m_voxelChunks()
+		, m_aColumns(static_cast<size_t>(uWidth) * uDepth, VoxelColumn{ .BlockType = 0, .Reserved = 0u, .Height = 0u })
+		, m_voxelLods(VoxelChunk::NUM_LODS)
+		, m_aMapDimension{ uWidth, uHeight, uDepth }
+		, m_voxelOctree()
+		, m_bVoxelOctreeDirty(FALSE)
+		, m_voxelRayCaster()
+		, m_voxelRenderMode(voxelRenderMode)
+		, m_voxelMeshVertexShader()
+		, m_voxelInstanceBuffer()
+		, m_cbVoxelPalette()
+		, m_uMaxNumVoxelInstances(0u)
+		, m_aVoxelChunkStates()
+		, m_aDirtyVoxelChunks()
+		, m_voxelSlotAllocator()
+		, m_aVoxelStagingBuffers()
+		, m_aNumVoxelStagingSlots{ 0u, }
+		, m_uVoxelStagingIdx(0u)
+		, m_chunkStreamer()
+		, m_terrain()
 		, m_renderables()
 		, m_models()
 		, m_aPointLights{ nullptr }
@@ -34,129 +157,1068 @@ namespace library
 		, m_materials()
 		, m_skyBox()
 	{
-		std::ifstream inputFile;
-		inputFile.open(m_filePath.string());
+		for (const XMFLOAT3& color : aPalette)
+		{
+			m_voxels.push_back(std::make_shared<Voxel>(XMFLOAT4(color.x, color.y, color.z, 1.0f)));
+		}
+
+		buildVoxelMap(std::max(std::thread::hardware_concurrency(), 1u));
+
+		// The frame loop keeps a core, the workers share the others
+		const UINT uNumStreamingThreads = std::max(std::thread::hardware_concurrency(), 2u) - 1u;
+		m_chunkStreamer = std::make_unique<ChunkStreamer>(
+			uSeed,
+			(uWidth + VoxelChunk::SIZE - 1u) / VoxelChunk::SIZE,
+			(uDepth + VoxelChunk::SIZE - 1u) / VoxelChunk::SIZE,
+			uHeight,
+			STREAMING_LOAD_RADIUS,
+			STREAMING_UNLOAD_RADIUS,
+			STREAMING_MAX_NUM_CHUNKS,
+			STREAMING_CACHE_DIRECTORY,
+			uNumStreamingThreads
+		);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Scene::buildVoxelMap
+
+	  Summary:  Places the voxels at the corner of the map and builds
+				what is derived from the columns: the octree, the
+				heights the rays walk, the coarser levels of detail
+				and the chunks
+
+	  Args:     UINT uNumThreads
+				  Number of threads building the chunks
+
+	  Modifies: [m_voxels, m_voxelOctree, m_voxelRayCaster,
+				 m_voxelLods, m_voxelChunks, m_aVoxelChunkStates,
+				 m_terrain].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Scene::buildVoxelMap(_In_ UINT uNumThreads)
+	{
+		const XMFLOAT3 origin = GetVoxelMapOrigin();
+		for (std::shared_ptr<Voxel>& voxel : m_voxels)
+		{
+			voxel->Translate(XMLoadFloat3(&origin));
+		}
+
+		if (m_aColumns.size() == static_cast<size_t>(m_aMapDimension[0]) * m_aMapDimension[2])
+		{
+			m_voxelOctree.Build(m_aColumns.data(), m_aMapDimension[0], m_aMapDimension[2], m_voxels.size());
+			m_voxelRayCaster.Build(m_aColumns.data(), m_aMapDimension[0], m_aMapDimension[2], m_voxels.size());
+		}
+
+		m_voxelLods.Build(m_aColumns.data(), m_aMapDimension[0], m_aMapDimension[2], m_voxels.size());
+
+		// The terrain draws the heights of the columns instead of the chunks
+		if (m_voxelRenderMode == eVoxelRenderMode::HEIGHTFIELD)
+		{
+			m_terrain = std::make_shared<HeightfieldTerrain>(m_aMapDimension[0], m_aMapDimension[2], TERRAIN_NUM_LODS, TERRAIN_LOD_DISTANCE, TERRAIN_MORPH_RATIO);
+			if (!m_voxelRayCaster.GetHeights().empty())
+			{
+				m_terrain->SetColumns(0u, 0u, m_aMapDimension[0], m_aMapDimension[2], m_voxelRayCaster.GetHeights().data(), m_aColumns.data());
+			}
+
+			// Columns span 2 world units from the corner of the map, and the vertices are at their centers
+			m_terrain->Scale(2.0f, 2.0f, 2.0f);
+			m_terrain->Translate(XMVectorAdd(XMLoadFloat3(&origin), XMVectorSet(1.0f, 0.0f, 1.0f, 0.0f)));
+			return;
+		}
+
+		buildVoxelChunks(uNumThreads);
+	}
+
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Scene::loadHeightMap
+
+	  Summary:  Parses a text height map into the columns of the map
+				and creates a voxel for each color of its palette
+
+	  Args:     UINT uNumThreads
+				  Number of threads parsing the map
+
+	  Modifies: [m_voxels, m_aColumns, m_aMapDimension].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Scene::loadHeightMap(_In_ UINT uNumThreads)
+	{
+		std::vector<XMFLOAT3> aPalette;
+		if (FAILED(HeightMapLoader::Load(m_filePath, uNumThreads, m_aMapDimension, aPalette, m_aColumns)))
+		{
+			return;
+		}
+
+		for (const XMFLOAT3& color : aPalette)
+		{
+			m_voxels.push_back(std::make_shared<Voxel>(XMFLOAT4(color.x, color.y, color.z, 1.0f)));
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Scene::loadVoxelMap
+
+	  Summary:  Memory-maps a binary voxel map, copies its columns and
+				creates a voxel for each color of its palette. The
+				map stays empty when a column is neither empty nor of
+				a block type of the palette
+
+	  Modifies: [m_voxels, m_aColumns, m_aMapDimension].
+
+	  Returns:  HRESULT
+				  Status code, E_INVALIDARG if a column does not fit
+				  the palette
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT Scene::loadVoxelMap()
+	{
+		VoxelMapFile voxelMapFile;
+		HRESULT hr = voxelMapFile.Open(m_filePath);
+		if (FAILED(hr))
+		{
+			return hr;
+		}
+
+		const VoxelMapHeader& header = voxelMapFile.GetHeader();
+		const VoxelColumn* pColumns = voxelMapFile.GetColumns();
+		for (size_t uColumnIdx = 0u; uColumnIdx < voxelMapFile.GetNumColumns(); ++uColumnIdx)
+		{
+			const VoxelColumn& column = pColumns[uColumnIdx];
+			if ((column.BlockType != 0 || column.Height != 0u) &&
+				static_cast<size_t>(column.BlockType) - static_cast<size_t>(eBlockType::GRASSLAND) >= header.NumColors)
+			{
+				return E_INVALIDARG;
+			}
+		}
+
+		m_aMapDimension[0] = header.Width;
+		m_aMapDimension[1] = header.Height;
+		m_aMapDimension[2] = header.Depth;
+
+		const XMFLOAT3* pPalette = voxelMapFile.GetPalette();
+		for (UINT uColorIdx = 0u; uColorIdx < header.NumColors; ++uColorIdx)
+		{
+			m_voxels.push_back(std::make_shared<Voxel>(XMFLOAT4(pPalette[uColorIdx].x, pPalette[uColorIdx].y, pPalette[uColorIdx].z, 1.0f)));
+		}
+
+		m_aColumns.assign(pColumns, pColumns + voxelMapFile.GetNumColumns());
+		return S_OK;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Scene::buildVoxelChunks
+
+	  Summary:  Splits the columns of the map into chunks of
+				VoxelChunk::SIZE x VoxelChunk::SIZE columns and
+				builds their instances, or their greedy meshes, at
+				every level of detail on several threads. Chunks
+				without any cube are dropped until a block is placed
+				in them
+
+	  Args:     UINT uNumThreads
+				  Number of worker threads
+
+	  Modifies: [m_voxelChunks, m_aVoxelChunkStates].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Scene::buildVoxelChunks(_In_ UINT uNumThreads)
+	{
+		const UINT uNumChunksX = (m_aMapDimension[0] + VoxelChunk::SIZE - 1u) / VoxelChunk::SIZE;
+		const UINT uNumChunksZ = (m_aMapDimension[2] + VoxelChunk::SIZE - 1u) / VoxelChunk::SIZE;
 
-		std::string trash;
-		UINT aDimension[4] = { 0u, };
-		UINT uDimensionIdx = 0u;
-		while (!inputFile.eof() && uDimensionIdx < ARRAYSIZE(aDimension))
+		std::vector<std::shared_ptr<VoxelChunk>> aChunks;
+		aChunks.reserve(static_cast<size_t>(uNumChunksX) * static_cast<size_t>(uNumChunksZ));
+		for (UINT uChunkZ = 0u; uChunkZ < uNumChunksZ; ++uChunkZ)
 		{
-			inputFile >> aDimension[uDimensionIdx];
+			for (UINT uChunkX = 0u; uChunkX < uNumChunksX; ++uChunkX)
+			{
+				aChunks.push_back(std::make_shared<VoxelChunk>(uChunkX, uChunkZ));
+			}
+		}
 
-			if (inputFile.fail())
+		std::atomic<size_t> uNextChunkIdx = 0u;
+		auto buildChunks = [this, &aChunks, &uNextChunkIdx]()
+		{
+			for (size_t uChunkIdx = uNextChunkIdx++; uChunkIdx < aChunks.size(); uChunkIdx = uNextChunkIdx++)
 			{
-				if (inputFile.eof())
+				for (UINT uLod = 0u; uLod < VoxelChunk::NUM_LODS; ++uLod)
 				{
-					break;
+					if (m_voxelRenderMode == eVoxelRenderMode::GREEDY_MESH)
+					{
+						buildVoxelChunkMesh(*aChunks[uChunkIdx], uLod);
+					}
+					else
+					{
+						buildVoxelChunk(*aChunks[uChunkIdx], uLod);
+					}
 				}
-				inputFile.clear();
-				inputFile >> trash;
+			}
+		};
+
+		std::vector<std::thread> aThreads;
+		aThreads.reserve(uNumThreads);
+		for (UINT i = 1u; i < uNumThreads && i < aChunks.size(); ++i)
+		{
+			aThreads.emplace_back(buildChunks);
+		}
+		buildChunks();
+		for (std::thread& thread : aThreads)
+		{
+			thread.join();
+		}
+
+		m_voxelChunks.clear();
+		m_aVoxelChunkStates.assign(aChunks.size(), VoxelChunkState{ .uChunkIdx = UINT_MAX, .slots = VoxelSlotRange{ .uFirstSlot = 0u, .uNumSlots = 0u }, .bRebuild = FALSE, .bUpload = FALSE, .uBuildVersion = 0u });
+		for (size_t uStateIdx = 0u; uStateIdx < aChunks.size(); ++uStateIdx)
+		{
+			if (aChunks[uStateIdx]->GetNumInstances() > 0u || aChunks[uStateIdx]->GetNumMeshIndices() > 0u)
+			{
+				m_aVoxelChunkStates[uStateIdx].uChunkIdx = static_cast<UINT>(m_voxelChunks.size());
+				m_voxelChunks.push_back(std::move(aChunks[uStateIdx]));
+			}
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Scene::buildVoxelChunk
+
+	  Summary:  Builds the instances of a chunk at a level of detail,
+				only the cubes with a face exposed to air
+
+	  Args:     VoxelChunk& chunk
+				  Chunk to build
+				UINT uLod
+				  Level of detail
+
+	  Modifies: [chunk].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Scene::buildVoxelChunk(_Inout_ VoxelChunk& chunk, _In_ UINT uLod) const
+	{
+		const UINT uLodWidth = getLodWidth(uLod);
+		const UINT uLodDepth = getLodDepth(uLod);
+		const UINT uBeginX = (chunk.GetChunkX() * VoxelChunk::SIZE) >> uLod;
+		const UINT uBeginZ = (chunk.GetChunkZ() * VoxelChunk::SIZE) >> uLod;
+		const UINT uEndX = std::min(uBeginX + (VoxelChunk::SIZE >> uLod), uLodWidth);
+		const UINT uEndZ = std::min(uBeginZ + (VoxelChunk::SIZE >> uLod), uLodDepth);
+
+		VoxelInstanceBuilder builder(getLodColumns(uLod).data(), uLodWidth, uLodDepth, m_voxels.size());
+		builder.Build(uLod, uBeginX, uBeginZ, uEndX, uEndZ);
+		if (builder.GetInstances().empty())
+		{
+			chunk.SetInstanceData(uLod, std::vector<InstanceData>(), BoundingBox());
+			return;
+		}
+
+		XMFLOAT3 minCorner = getVoxelCorner(m_aMapDimension, uLod, uBeginX, builder.GetMinHeight(), uBeginZ);
+		XMFLOAT3 maxCorner = getVoxelCorner(m_aMapDimension, uLod, uEndX, builder.GetMaxHeight(), uEndZ);
+		BoundingBox boundingBox;
+		BoundingBox::CreateFromPoints(boundingBox, XMLoadFloat3(&minCorner), XMLoadFloat3(&maxCorner));
+
+		chunk.SetInstanceData(uLod, std::move(builder.GetInstances()), boundingBox);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Scene::buildVoxelChunkMesh
+
+	  Summary:  Builds the greedy mesh of a chunk at a level of
+				detail. Faces against the cubes of neighboring chunks
+				are culled too
+
+	  Args:     VoxelChunk& chunk
+				  Chunk to build
+				UINT uLod
+				  Level of detail
+
+	  Modifies: [chunk].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Scene::buildVoxelChunkMesh(_Inout_ VoxelChunk& chunk, _In_ UINT uLod) const
+	{
+		// A column adds at most one quad per face direction, so WORD indices always fit
+		static_assert(6u * 4u * VoxelChunk::SIZE * VoxelChunk::SIZE <= 0x10000u);
+
+		const UINT uLodWidth = getLodWidth(uLod);
+		const UINT uLodDepth = getLodDepth(uLod);
+		const UINT uBeginX = (chunk.GetChunkX() * VoxelChunk::SIZE) >> uLod;
+		const UINT uBeginZ = (chunk.GetChunkZ() * VoxelChunk::SIZE) >> uLod;
+		const UINT uEndX = std::min(uBeginX + (VoxelChunk::SIZE >> uLod), uLodWidth);
+		const UINT uEndZ = std::min(uBeginZ + (VoxelChunk::SIZE >> uLod), uLodDepth);
+
+		// The vertices are relative to the corner of the map, like the instances
+		GreedyMesher mesher(getLodColumns(uLod).data(), uLodWidth, uLodDepth, m_voxels.size());
+		mesher.Build(uBeginX, uBeginZ, uEndX, uEndZ, XMFLOAT3(0.0f, 0.0f, 0.0f), 2.0f * static_cast<FLOAT>(1u << uLod));
+		if (mesher.GetIndices().empty())
+		{
+			chunk.SetMeshData(uLod, std::vector<SimpleVertex>(), std::vector<WORD>(), std::vector<VoxelMeshRange>(), BoundingBox());
+			return;
+		}
+
+		const XMFLOAT3 origin = GetVoxelMapOrigin();
+		BoundingBox boundingBox;
+		BoundingBox::CreateFromPoints(boundingBox, mesher.GetVertices().size(), &mesher.GetVertices()[0].Position, sizeof(SimpleVertex));
+		boundingBox.Center.x += origin.x;
+		boundingBox.Center.y += origin.y;
+		boundingBox.Center.z += origin.z;
+
+		chunk.SetMeshData(uLod, std::move(mesher.GetVertices()), std::move(mesher.GetIndices()), std::move(mesher.GetRanges()), boundingBox);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Scene::setVoxelColumn
+
+	  Summary:  Replaces a column of the map
+
+	  Args:     UINT x, UINT z
+				  Column of the map
+				const VoxelColumn& column
+				  New column
+
+	  Modifies: [see setVoxelColumns].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Scene::setVoxelColumn(_In_ UINT x, _In_ UINT z, _In_ const VoxelColumn& column)
+	{
+		setVoxelColumns(x, z, 1u, 1u, &column);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Scene::setVoxelColumns
+
+	  Summary:  Replaces a rectangle of columns of the map and updates
+				what is derived from it: the heights the rays walk, the
+				columns of the coarser levels of detail above it, the
+				terrain and the octree, which is rebuilt on its next
+				use. A column of level k culls against its neighbors,
+				so every chunk within 2^(k + 1) - 1 columns of the
+				coarsest level is marked for a rebuild
+
+	  Args:     UINT uX, UINT uZ
+				  First column of the rectangle
+				UINT uWidth, UINT uDepth
+				  Number of columns of the rectangle along x and z,
+				  at least 1, inside the map
+				const VoxelColumn* pColumns
+				  New columns, row by row
+
+	  Modifies: [m_aColumns, m_voxelLods, m_voxelRayCaster,
+				 m_aVoxelChunkStates, m_aDirtyVoxelChunks,
+				 m_bVoxelOctreeDirty, m_terrain].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Scene::setVoxelColumns(_In_ UINT uX, _In_ UINT uZ, _In_ UINT uWidth, _In_ UINT uDepth, _In_reads_(static_cast<size_t>(uWidth) * uDepth) const VoxelColumn* pColumns)
+	{
+		const UINT uMapWidth = m_aMapDimension[0];
+		const UINT uMapDepth = m_aMapDimension[2];
+		const UINT uEndX = uX + uWidth;
+		const UINT uEndZ = uZ + uDepth;
+		for (UINT z = uZ; z < uEndZ; ++z)
+		{
+			std::copy(pColumns + static_cast<size_t>(z - uZ) * uWidth, pColumns + static_cast<size_t>(z - uZ + 1u) * uWidth, m_aColumns.begin() + static_cast<size_t>(z) * uMapWidth + uX);
+		}
+		m_bVoxelOctreeDirty = TRUE;
+
+		if (!m_voxelRayCaster.GetHeights().empty())
+		{
+			m_voxelRayCaster.Update(m_aColumns.data(), uX, uZ, uWidth, uDepth);
+
+			if (m_terrain)
+			{
+				m_terrain->SetColumns(uX, uZ, uWidth, uDepth, m_voxelRayCaster.GetHeights().data(), m_aColumns.data());
+			}
+		}
+
+		m_voxelLods.Update(m_aColumns.data(), uX, uZ, uWidth, uDepth);
+
+		const UINT uReach = (2u << (VoxelChunk::NUM_LODS - 1u)) - 1u;
+		for (UINT uChunkZ = (uZ - std::min(uZ, uReach)) / VoxelChunk::SIZE; uChunkZ <= std::min(uEndZ - 1u + uReach, uMapDepth - 1u) / VoxelChunk::SIZE; ++uChunkZ)
+		{
+			for (UINT uChunkX = (uX - std::min(uX, uReach)) / VoxelChunk::SIZE; uChunkX <= std::min(uEndX - 1u + uReach, uMapWidth - 1u) / VoxelChunk::SIZE; ++uChunkX)
+			{
+				markVoxelChunkDirty(uChunkX, uChunkZ, TRUE);
+			}
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Scene::markVoxelChunkDirty
+
+	  Summary:  Queues a chunk for the next UpdateVoxelInstances
+
+	  Args:     UINT uChunkX, UINT uChunkZ
+				  Chunk column and row
+				BOOL bRebuild
+				  TRUE to rebuild the chunk from its columns, FALSE to
+				  only copy its instances to its slots
+
+	  Modifies: [m_aVoxelChunkStates, m_aDirtyVoxelChunks].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Scene::markVoxelChunkDirty(_In_ UINT uChunkX, _In_ UINT uChunkZ, _In_ BOOL bRebuild)
+	{
+		// The heightfield terrain has no chunk
+		if (m_aVoxelChunkStates.empty())
+		{
+			return;
+		}
+
+		const UINT uNumChunksX = (m_aMapDimension[0] + VoxelChunk::SIZE - 1u) / VoxelChunk::SIZE;
+		const UINT uStateIdx = uChunkZ * uNumChunksX + uChunkX;
+		VoxelChunkState& state = m_aVoxelChunkStates[uStateIdx];
+		if (!bRebuild && state.uChunkIdx == UINT_MAX)
+		{
+			return;
+		}
+
+		if (!state.bRebuild && !state.bUpload)
+		{
+			m_aDirtyVoxelChunks.push_back(uStateIdx);
+		}
+		state.bRebuild = state.bRebuild || bRebuild;
+		state.bUpload = state.bUpload || !bRebuild;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Scene::rebuildVoxelChunk
+
+	  Summary:  Rebuilds every level of detail of a chunk from its
+				columns, creating the chunk when it held no cube yet.
+				In greedy mesh mode the mesh buffers are recreated
+
+	  Args:     VoxelChunkState& state
+				  State of the chunk
+				UINT uStateIdx
+				  Index of the state, row by row of chunks
+				ID3D11Device* pDevice
+				  The Direct3D device to create the mesh buffers
+
+	  Modifies: [state, m_voxelChunks].
+
+	  Returns:  HRESULT
+				  Status code
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT Scene::rebuildVoxelChunk(_Inout_ VoxelChunkState& state, _In_ UINT uStateIdx, _In_ ID3D11Device* pDevice)
+	{
+		if (state.uChunkIdx == UINT_MAX)
+		{
+			const UINT uNumChunksX = (m_aMapDimension[0] + VoxelChunk::SIZE - 1u) / VoxelChunk::SIZE;
+			state.uChunkIdx = static_cast<UINT>(m_voxelChunks.size());
+			m_voxelChunks.push_back(std::make_shared<VoxelChunk>(uStateIdx % uNumChunksX, uStateIdx / uNumChunksX));
+		}
+
+		VoxelChunk& chunk = *m_voxelChunks[state.uChunkIdx];
+		for (UINT uLod = 0u; uLod < VoxelChunk::NUM_LODS; ++uLod)
+		{
+			if (m_voxelRenderMode == eVoxelRenderMode::GREEDY_MESH)
+			{
+				buildVoxelChunkMesh(chunk, uLod);
 			}
 			else
 			{
-				++uDimensionIdx;
+				buildVoxelChunk(chunk, uLod);
 			}
 		}
 
-		UINT uColorIdx = 0u;
-		XMFLOAT4 color;
-		while (!inputFile.eof() && uColorIdx < aDimension[3])
+		if (m_voxelRenderMode == eVoxelRenderMode::GREEDY_MESH)
 		{
-			inputFile >> color.x >> color.y >> color.z;
+			return chunk.Initialize(pDevice);
+		}
+
+		return S_OK;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Scene::queueVoxelChunkBuild
+
+	  Summary:  Copies the columns every level of detail of a chunk
+				is built from, with the border columns that cull its
+				faces, and queues them on the streaming workers
 
-			if (inputFile.fail())
+	  Args:     VoxelChunkState& state
+				  State of the chunk
+				UINT uStateIdx
+				  Index of the state, row by row of chunks
+
+	  Modifies: [state, m_chunkStreamer].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Scene::queueVoxelChunkBuild(_Inout_ VoxelChunkState& state, _In_ UINT uStateIdx)
+	{
+		const UINT uNumChunksX = (m_aMapDimension[0] + VoxelChunk::SIZE - 1u) / VoxelChunk::SIZE;
+		StreamedChunkBuild build =
+		{
+			.ChunkX = uStateIdx % uNumChunksX,
+			.ChunkZ = uStateIdx / uNumChunksX,
+			.Version = ++state.uBuildVersion,
+			.GreedyMesh = m_voxelRenderMode == eVoxelRenderMode::GREEDY_MESH,
+			.NumBlockTypes = m_voxels.size(),
+			.Levels = std::vector<StreamedChunkLevel>(VoxelChunk::NUM_LODS)
+		};
+
+		for (UINT uLod = 0u; uLod < VoxelChunk::NUM_LODS; ++uLod)
+		{
+			const std::vector<VoxelColumn>& aLodColumns = getLodColumns(uLod);
+			const UINT uLodWidth = getLodWidth(uLod);
+			const UINT uLodDepth = getLodDepth(uLod);
+
+			StreamedChunkLevel& level = build.Levels[uLod];
+			level.BeginX = (build.ChunkX * VoxelChunk::SIZE) >> uLod;
+			level.BeginZ = (build.ChunkZ * VoxelChunk::SIZE) >> uLod;
+			level.Width = std::min(level.BeginX + (VoxelChunk::SIZE >> uLod), uLodWidth) - level.BeginX;
+			level.Depth = std::min(level.BeginZ + (VoxelChunk::SIZE >> uLod), uLodDepth) - level.BeginZ;
+
+			// The border is empty outside of the map, like the columns the builders do not have
+			const UINT uWidth = level.Width + 2u;
+			level.Columns.assign(static_cast<size_t>(uWidth) * (level.Depth + 2u), VoxelColumn{ .BlockType = 0, .Reserved = 0u, .Height = 0u });
+			const UINT uBeginX = level.BeginX - std::min(level.BeginX, 1u);
+			const UINT uEndX = std::min(level.BeginX + level.Width + 1u, uLodWidth);
+			for (UINT z = level.BeginZ - std::min(level.BeginZ, 1u); z < std::min(level.BeginZ + level.Depth + 1u, uLodDepth); ++z)
 			{
-				if (inputFile.eof())
-				{
-					break;
-				}
-				inputFile.clear();
-				inputFile >> trash;
+				std::copy(
+					aLodColumns.begin() + static_cast<std::ptrdiff_t>(static_cast<size_t>(z) * uLodWidth + uBeginX),
+					aLodColumns.begin() + static_cast<std::ptrdiff_t>(static_cast<size_t>(z) * uLodWidth + uEndX),
+					level.Columns.begin() + static_cast<std::ptrdiff_t>(static_cast<size_t>(z + 1u - level.BeginZ) * uWidth + (uBeginX + 1u - level.BeginX))
+				);
+			}
+		}
+
+		m_chunkStreamer->QueueBuild(std::move(build));
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Scene::applyVoxelChunkBuild
+
+	  Summary:  Hands the levels of detail the streaming workers built
+				to their chunk, creating the chunk when it held no cube
+				yet, unless its columns changed again since. In greedy
+				mesh mode the mesh buffers are recreated, otherwise the
+				chunk is queued for its slots to be patched
+
+	  Args:     StreamedChunkBuild& build
+				  Built chunk, its levels are moved out
+				ID3D11Device* pDevice
+				  The Direct3D device to create the mesh buffers
+
+	  Modifies: [m_voxelChunks, m_aVoxelChunkStates,
+				 m_aDirtyVoxelChunks].
+
+	  Returns:  HRESULT
+				  Status code
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT Scene::applyVoxelChunkBuild(_Inout_ StreamedChunkBuild& build, _In_ ID3D11Device* pDevice)
+	{
+		const UINT uNumChunksX = (m_aMapDimension[0] + VoxelChunk::SIZE - 1u) / VoxelChunk::SIZE;
+		const UINT uStateIdx = build.ChunkZ * uNumChunksX + build.ChunkX;
+		VoxelChunkState& state = m_aVoxelChunkStates[uStateIdx];
+		if (build.Version != state.uBuildVersion)
+		{
+			return S_OK;
+		}
+
+		BOOL bEmpty = TRUE;
+		for (const StreamedChunkLevel& level : build.Levels)
+		{
+			bEmpty = bEmpty && level.Instances.empty() && level.Indices.empty();
+		}
+		if (bEmpty && state.uChunkIdx == UINT_MAX)
+		{
+			return S_OK;
+		}
+
+		if (state.uChunkIdx == UINT_MAX)
+		{
+			state.uChunkIdx = static_cast<UINT>(m_voxelChunks.size());
+			m_voxelChunks.push_back(std::make_shared<VoxelChunk>(build.ChunkX, build.ChunkZ));
+		}
+
+		const XMFLOAT3 origin = GetVoxelMapOrigin();
+		VoxelChunk& chunk = *m_voxelChunks[state.uChunkIdx];
+		for (UINT uLod = 0u; uLod < VoxelChunk::NUM_LODS; ++uLod)
+		{
+			StreamedChunkLevel& level = build.Levels[uLod];
+			BoundingBox boundingBox;
+			if (!level.Instances.empty() || !level.Indices.empty())
+			{
+				const XMFLOAT3 minCorner(origin.x + level.MinCorner.x, origin.y + level.MinCorner.y, origin.z + level.MinCorner.z);
+				const XMFLOAT3 maxCorner(origin.x + level.MaxCorner.x, origin.y + level.MaxCorner.y, origin.z + level.MaxCorner.z);
+				BoundingBox::CreateFromPoints(boundingBox, XMLoadFloat3(&minCorner), XMLoadFloat3(&maxCorner));
+			}
+
+			if (build.GreedyMesh)
+			{
+				chunk.SetMeshData(uLod, std::move(level.Vertices), std::move(level.Indices), std::move(level.Ranges), boundingBox);
 			}
 			else
 			{
-				color.w = 1.0f;
-				m_voxels.push_back(std::make_shared<Voxel>(color));
-				++uColorIdx;
+				chunk.SetInstanceData(uLod, std::move(level.Instances), boundingBox);
 			}
 		}
 
-		std::vector<std::vector<InstanceData>> aInstanceData;
-		aInstanceData.reserve(m_voxels.size());
-		for (UINT renderableIdx = 0u; renderableIdx < m_voxels.size(); ++renderableIdx)
+		if (m_voxelInstanceBuffer)
+		{
+			// The upload empties the slots of a chunk left without cubes before releasing it
+			markVoxelChunkDirty(build.ChunkX, build.ChunkZ, FALSE);
+			return S_OK;
+		}
+
+		if (bEmpty)
+		{
+			releaseVoxelChunk(state);
+			return S_OK;
+		}
+
+		return build.GreedyMesh ? chunk.Initialize(pDevice) : S_OK;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Scene::releaseVoxelChunk
+
+	  Summary:  Drops a chunk left without cubes, e.g. evicted by the
+				streamer. The last chunk takes its place so the chunks
+				stay packed. Its slots must have been freed
+
+	  Args:     VoxelChunkState& state
+				  State of the chunk
+
+	  Modifies: [state, m_voxelChunks, m_aVoxelChunkStates].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Scene::releaseVoxelChunk(_Inout_ VoxelChunkState& state)
+	{
+		const UINT uNumChunksX = (m_aMapDimension[0] + VoxelChunk::SIZE - 1u) / VoxelChunk::SIZE;
+		if (state.uChunkIdx + 1u != m_voxelChunks.size())
+		{
+			const VoxelChunk& lastChunk = *m_voxelChunks.back();
+			m_aVoxelChunkStates[lastChunk.GetChunkZ() * uNumChunksX + lastChunk.GetChunkX()].uChunkIdx = state.uChunkIdx;
+			m_voxelChunks[state.uChunkIdx] = std::move(m_voxelChunks.back());
+		}
+
+		m_voxelChunks.pop_back();
+		state.uChunkIdx = UINT_MAX;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Scene::growVoxelInstanceBuffer
+
+	  Summary:  Replaces the instance buffer with one at least half
+				larger that holds every used slot, and copies the old
+				buffer into it on the GPU
+
+	  Args:     ID3D11Device* pDevice
+				  The Direct3D device to create the buffer
+				ID3D11DeviceContext* pImmediateContext
+				  The Direct3D context to copy the instances
+
+	  Modifies: [m_voxelInstanceBuffer, m_uMaxNumVoxelInstances].
+
+	  Returns:  HRESULT
+				  Status code
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT Scene::growVoxelInstanceBuffer(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext)
+	{
+		const UINT uNumSlots = std::max(m_voxelSlotAllocator.GetNumSlots(), m_uMaxNumVoxelInstances + m_uMaxNumVoxelInstances / 2u);
+
+		D3D11_BUFFER_DESC instBuffDesc =
 		{
-			aInstanceData.push_back(std::vector<InstanceData>());
-			aInstanceData.back().reserve(
-				static_cast<size_t>(aDimension[0]) * static_cast<size_t>(aDimension[1]) * static_cast<size_t>(aDimension[2])
-			);
+			.ByteWidth = static_cast<UINT>(sizeof(InstanceData)) * uNumSlots,
+			.Usage = D3D11_USAGE_DEFAULT,
+			.BindFlags = D3D11_BIND_VERTEX_BUFFER,
+			.CPUAccessFlags = 0,
+			.MiscFlags = 0,
+			.StructureByteStride = 0
+		};
+
+		ComPtr<ID3D11Buffer> instanceBuffer;
+		HRESULT hr = pDevice->CreateBuffer(&instBuffDesc, nullptr, instanceBuffer.GetAddressOf());
+		if (FAILED(hr))
+		{
+			return hr;
 		}
 
-		UINT uDepthIdx = 0u;
-		UINT uWidthIdx = 0u;
-		CHAR voxelType;
-		FLOAT height;
-		while (!inputFile.eof())
+		const D3D11_BOX box =
 		{
-			inputFile >> voxelType >> height;
+			.left = 0u,
+			.top = 0u,
+			.front = 0u,
+			.right = m_uMaxNumVoxelInstances * static_cast<UINT>(sizeof(InstanceData)),
+			.bottom = 1u,
+			.back = 1u
+		};
+		pImmediateContext->CopySubresourceRegion(instanceBuffer.Get(), 0u, 0u, 0u, 0u, m_voxelInstanceBuffer.Get(), 0u, &box);
+
+		m_voxelInstanceBuffer = instanceBuffer;
+		m_uMaxNumVoxelInstances = uNumSlots;
+
+		return S_OK;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Scene::createVoxelStagingBuffer
+
+	  Summary:  Creates one staging buffer of the ring the instances
+				are written to before they are copied to their slots
+
+	  Args:     ID3D11Device* pDevice
+				  The Direct3D device to create the buffer
+				UINT uStagingIdx
+				  Index of the buffer in the ring
+				UINT uNumSlots
+				  Number of instances the buffer holds
+
+	  Modifies: [m_aVoxelStagingBuffers, m_aNumVoxelStagingSlots].
 
-			if (inputFile.fail())
+	  Returns:  HRESULT
+				  Status code
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT Scene::createVoxelStagingBuffer(_In_ ID3D11Device* pDevice, _In_ UINT uStagingIdx, _In_ UINT uNumSlots)
+	{
+		D3D11_BUFFER_DESC stagingBuffDesc =
+		{
+			.ByteWidth = static_cast<UINT>(sizeof(InstanceData)) * uNumSlots,
+			.Usage = D3D11_USAGE_STAGING,
+			.BindFlags = 0,
+			.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE,
+			.MiscFlags = 0,
+			.StructureByteStride = 0
+		};
+
+		HRESULT hr = pDevice->CreateBuffer(&stagingBuffDesc, nullptr, m_aVoxelStagingBuffers[uStagingIdx].ReleaseAndGetAddressOf());
+		if (FAILED(hr))
+		{
+			m_aNumVoxelStagingSlots[uStagingIdx] = 0u;
+			return hr;
+		}
+
+		m_aNumVoxelStagingSlots[uStagingIdx] = uNumSlots;
+
+		return S_OK;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Scene::mapVoxelStagingBuffer
+
+	  Summary:  Maps the next staging buffer of the ring the GPU is
+				done copying from, without waiting for it. A buffer
+				too small for the instances is replaced first, which
+				only grows the buffer about to be written
+
+	  Args:     ID3D11Device* pDevice
+				  The Direct3D device to create a larger buffer
+				ID3D11DeviceContext* pImmediateContext
+				  The Direct3D context to map the buffer
+				UINT uNumSlots
+				  Number of instances the buffer must hold at least
+				InstanceData** ppStagingInstances
+				  Mapped instances of the buffer, nullptr when none
+				  is free
+
+	  Modifies: [m_aVoxelStagingBuffers, m_aNumVoxelStagingSlots,
+				 m_uVoxelStagingIdx].
+
+	  Returns:  HRESULT
+				  S_OK when m_uVoxelStagingIdx is mapped, S_FALSE when
+				  every buffer is still being copied from, or an error
+				  status code
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT Scene::mapVoxelStagingBuffer(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext, _In_ UINT uNumSlots, _Out_ InstanceData** ppStagingInstances)
+	{
+		*ppStagingInstances = nullptr;
+		for (UINT i = 0u; i < NUM_VOXEL_STAGING_BUFFERS; ++i)
+		{
+			const UINT uStagingIdx = (m_uVoxelStagingIdx + i) % NUM_VOXEL_STAGING_BUFFERS;
+			HRESULT hr = S_OK;
+			if (m_aNumVoxelStagingSlots[uStagingIdx] < uNumSlots)
 			{
-				if (inputFile.eof())
+				hr = createVoxelStagingBuffer(pDevice, uStagingIdx, uNumSlots);
+				if (FAILED(hr))
 				{
-					break;
+					return hr;
 				}
-				inputFile.clear();
-				inputFile >> trash;
 			}
-			else if (static_cast<CHAR>(eBlockType::GRASSLAND) <= voxelType && voxelType < static_cast<CHAR>(eBlockType::COUNT))
+
+			D3D11_MAPPED_SUBRESOURCE mappedInstances;
+			hr = pImmediateContext->Map(m_aVoxelStagingBuffers[uStagingIdx].Get(), 0u, D3D11_MAP_WRITE, D3D11_MAP_FLAG_DO_NOT_WAIT, &mappedInstances);
+			if (hr == DXGI_ERROR_WAS_STILL_DRAWING)
 			{
-				for (UINT heightIdx = 0; heightIdx < static_cast<UINT>(static_cast<float>(aDimension[1]) * height); ++heightIdx)
-				{
-					aInstanceData[static_cast<size_t>(voxelType) - static_cast<size_t>(eBlockType::GRASSLAND)].push_back(
-						InstanceData
-						{
-							.Transformation = XMMatrixTranslation(
-								2.0f * (static_cast<FLOAT>(uWidthIdx) - static_cast<FLOAT>(aDimension[0]) / 2.0f),
-								2.0f * (static_cast<FLOAT>(heightIdx) - static_cast<FLOAT>(aDimension[1])) + (static_cast<FLOAT>(aDimension[1]) * 0.75f),
-								2.0f * (static_cast<FLOAT>(uDepthIdx) - static_cast<FLOAT>(aDimension[2]) / 2.0f)
-								)
-						}
-					);
-				}
-				++uWidthIdx;
-				if (uWidthIdx >= aDimension[0])
-				{
-					uWidthIdx -= aDimension[0];
-					++uDepthIdx;
+				continue;
+			}
+			if (FAILED(hr))
+			{
+				return hr;
+			}
 
-					if (uDepthIdx >= aDimension[2])
-					{
-						uDepthIdx -= aDimension[2];
-					}
-				}
+			m_uVoxelStagingIdx = uStagingIdx;
+			*ppStagingInstances = static_cast<InstanceData*>(mappedInstances.pData);
+			return S_OK;
+		}
+
+		return S_FALSE;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Scene::getLodColumns
+
+	  Summary:  Returns the columns of a level of detail
+
+	  Args:     UINT uLod
+				  Level of detail
+
+	  Returns:  const std::vector<VoxelColumn>&
+				  Columns in row-major (x fastest) order
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	const std::vector<VoxelColumn>& Scene::getLodColumns(_In_ UINT uLod) const
+	{
+		return uLod == 0u ? m_aColumns : m_voxelLods.GetColumns(uLod);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Scene::getLodWidth
+
+	  Summary:  Returns the number of columns along the width at a
+				level of detail
+
+	  Args:     UINT uLod
+				  Level of detail
+
+	  Returns:  UINT
+				  Width of the level
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT Scene::getLodWidth(_In_ UINT uLod) const
+	{
+		return (m_aMapDimension[0] + (1u << uLod) - 1u) >> uLod;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Scene::getLodDepth
+
+	  Summary:  Returns the number of columns along the depth at a
+				level of detail
+
+	  Args:     UINT uLod
+				  Level of detail
+
+	  Returns:  UINT
+				  Depth of the level
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT Scene::getLodDepth(_In_ UINT uLod) const
+	{
+		return (m_aMapDimension[2] + (1u << uLod) - 1u) >> uLod;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Scene::getColumnHeight
+
+	  Summary:  Returns the number of cubes drawn in a column
+
+	  Args:     UINT uLod
+				  Level of detail of the column
+				INT x, INT z
+				  Column of the level, may lie outside of it
+
+	  Returns:  UINT
+				  Height of the column, 0 outside of the map or when
+				  no voxel matches its block type
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT Scene::getColumnHeight(_In_ UINT uLod, _In_ INT x, _In_ INT z) const
+	{
+		const UINT uLodWidth = getLodWidth(uLod);
+		if (x < 0 || z < 0 || static_cast<UINT>(x) >= uLodWidth || static_cast<UINT>(z) >= getLodDepth(uLod))
+		{
+			return 0u;
+		}
+
+		const VoxelColumn& column = getLodColumns(uLod)[static_cast<size_t>(z) * uLodWidth + static_cast<size_t>(x)];
+		if (static_cast<size_t>(column.BlockType) - static_cast<size_t>(eBlockType::GRASSLAND) >= m_voxels.size())
+		{
+			return 0u;
+		}
+
+		return column.Height;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Scene::getVoxelPosition
+
+	  Summary:  Returns the center of the cube at a grid cell,
+				centering the map around the origin
+
+	  Args:     const UINT aDimension[3]
+				  Width, height and depth of the map
+				UINT x, UINT y, UINT z
+				  Grid cell of the cube
+
+	  Returns:  XMFLOAT3
+				  Center of the cube
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	XMFLOAT3 Scene::getVoxelPosition(_In_ const UINT aDimension[3], _In_ UINT x, _In_ UINT y, _In_ UINT z)
+	{
+		return XMFLOAT3(
+			2.0f * (static_cast<FLOAT>(x) - static_cast<FLOAT>(aDimension[0]) / 2.0f),
+			2.0f * (static_cast<FLOAT>(y) - static_cast<FLOAT>(aDimension[1])) + (static_cast<FLOAT>(aDimension[1]) * 0.75f),
+			2.0f * (static_cast<FLOAT>(z) - static_cast<FLOAT>(aDimension[2]) / 2.0f)
+		);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Scene::getVoxelCorner
+
+	  Summary:  Returns the corner with the lowest coordinates of a
+				grid cell at a level of detail
+
+	  Args:     const UINT aDimension[3]
+				  Width, height and depth of the map
+				UINT uLod
+				  Level of detail, a cell spans 2^uLod cubes
+				UINT x, UINT y, UINT z
+				  Grid cell of the level
+
+	  Returns:  XMFLOAT3
+				  Corner of the cell
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	XMFLOAT3 Scene::getVoxelCorner(_In_ const UINT aDimension[3], _In_ UINT uLod, _In_ UINT x, _In_ UINT y, _In_ UINT z)
+	{
+		// Cubes span one unit around their center
+		XMFLOAT3 position = getVoxelPosition(aDimension, x << uLod, y << uLod, z << uLod);
+		return XMFLOAT3(position.x - 1.0f, position.y - 1.0f, position.z - 1.0f);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Scene::getVoxelSlotCapacity
+
+	  Summary:  Returns the slots reserved for the instances of a
+				chunk, a quarter more and a row of columns so a chunk
+				does not move each time a block is placed in it
+
+	  Args:     UINT uNumInstances
+				  Number of instances of the chunk
+
+	  Returns:  UINT
+				  Number of slots
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT Scene::getVoxelSlotCapacity(_In_ UINT uNumInstances)
+	{
+		return uNumInstances + uNumInstances / 4u + VoxelChunk::SIZE;
+	}
+
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Scene::initializeVoxelPalette
+
+	  Summary:  Creates the palette constant buffer from the colors of
+				the voxels, read by the cubes and the terrain
+
+	  Args:     ID3D11Device* pDevice
+				  The Direct3D device to create the buffer
+
+	  Modifies: [m_cbVoxelPalette].
+
+	  Returns:  HRESULT
+				  Status code
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT Scene::initializeVoxelPalette(_In_ ID3D11Device* pDevice)
+	{
+		CBVoxelPalette cbPalette = {};
+		for (size_t uVoxelIdx = 0u; uVoxelIdx < m_voxels.size(); ++uVoxelIdx)
+		{
+			const size_t uBlockType = uVoxelIdx + static_cast<size_t>(eBlockType::GRASSLAND);
+			if (uBlockType < MAX_NUM_BLOCK_TYPES)
+			{
+				cbPalette.Colors[uBlockType] = m_voxels[uVoxelIdx]->GetOutputColor();
 			}
 		}
 
-		inputFile.close();
+		D3D11_BUFFER_DESC paletteDesc =
+		{
+			.ByteWidth = sizeof(CBVoxelPalette),
+			.Usage = D3D11_USAGE_IMMUTABLE,
+			.BindFlags = D3D11_BIND_CONSTANT_BUFFER,
+			.CPUAccessFlags = 0,
+			.MiscFlags = 0,
+			.StructureByteStride = 0
+		};
+
+		D3D11_SUBRESOURCE_DATA paletteData =
+		{
+			.pSysMem = &cbPalette,
+			.SysMemPitch = 0,
+			.SysMemSlicePitch = 0
+		};
+
+		return pDevice->CreateBuffer(&paletteDesc, &paletteData, m_cbVoxelPalette.ReleaseAndGetAddressOf());
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Scene::initializeVoxelInstances
+
+	  Summary:  Creates the instance buffer that holds the cubes of
+				every chunk so the whole map is a single instanced
+				draw. Each chunk owns a range of slots that
+				fits its largest level of detail with some room to
+				grow, and the slots it does not fill hold air, which
+				the shaders drop. The staging buffers that patch the
+				ranges are created too
 
-		UINT uVoxelIdx = 0u;
-		auto it = m_voxels.begin();
-		while (it != m_voxels.end())
+	  Args:     ID3D11Device* pDevice
+				  The Direct3D device to create the buffers
+
+	  Modifies: [m_voxelInstanceBuffer, m_uMaxNumVoxelInstances,
+				 m_aVoxelChunkStates, m_voxelSlotAllocator,
+				 m_aVoxelStagingBuffers, m_aNumVoxelStagingSlots].
+
+	  Returns:  HRESULT
+				  Status code
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT Scene::initializeVoxelInstances(_In_ ID3D11Device* pDevice)
+	{
+		m_voxelSlotAllocator.Reset();
+		UINT uMaxNumChunkSlots = 0u;
+		for (VoxelChunkState& state : m_aVoxelChunkStates)
 		{
-			if (aInstanceData[uVoxelIdx].size() <= 0)
+			if (state.uChunkIdx != UINT_MAX)
 			{
-				it = m_voxels.erase(it);
+				state.slots = m_voxelSlotAllocator.Allocate(getVoxelSlotCapacity(m_voxelChunks[state.uChunkIdx]->GetMaxNumInstances()));
+				uMaxNumChunkSlots = std::max(uMaxNumChunkSlots, state.slots.uNumSlots);
 			}
-			else
+		}
+
+		// Leave room for the chunks that outgrow their slots
+		const UINT uNumSlots = m_voxelSlotAllocator.GetNumSlots();
+		m_uMaxNumVoxelInstances = uNumSlots + uNumSlots / 8u + VoxelChunk::SIZE * VoxelChunk::SIZE;
+
+		std::vector<InstanceData> aInstanceData(m_uMaxNumVoxelInstances, InstanceData{});
+		for (const VoxelChunkState& state : m_aVoxelChunkStates)
+		{
+			if (state.uChunkIdx != UINT_MAX)
 			{
-				(*it)->SetInstanceData(std::move(aInstanceData[uVoxelIdx]));
-				++it;
+				const std::vector<InstanceData>& aChunkInstanceData = m_voxelChunks[state.uChunkIdx]->GetInstanceData();
+				std::copy(aChunkInstanceData.begin(), aChunkInstanceData.end(), aInstanceData.begin() + state.slots.uFirstSlot);
 			}
-			++uVoxelIdx;
 		}
-	}
 
+		D3D11_BUFFER_DESC instBuffDesc =
+		{
+			.ByteWidth = static_cast<UINT>(sizeof(InstanceData)) * m_uMaxNumVoxelInstances,
+			.Usage = D3D11_USAGE_DEFAULT,
+			.BindFlags = D3D11_BIND_VERTEX_BUFFER,
+			.CPUAccessFlags = 0,
+			.MiscFlags = 0,
+			.StructureByteStride = 0
+		};
+
+		D3D11_SUBRESOURCE_DATA instData =
+		{
+			.pSysMem = aInstanceData.data(),
+			.SysMemPitch = 0,
+			.SysMemSlicePitch = 0
+		};
+
+		HRESULT hr = pDevice->CreateBuffer(&instBuffDesc, &instData, m_voxelInstanceBuffer.ReleaseAndGetAddressOf());
+		if (FAILED(hr))
+		{
+			return hr;
+		}
+
+		for (UINT uStagingIdx = 0u; uStagingIdx < NUM_VOXEL_STAGING_BUFFERS; ++uStagingIdx)
+		{
+			hr = createVoxelStagingBuffer(pDevice, uStagingIdx, std::max(uMaxNumChunkSlots, VOXEL_STAGING_SLOTS));
+			if (FAILED(hr))
+			{
+				return hr;
+			}
+		}
+
+		return S_OK;
+	}
 
 	HRESULT Scene::Initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext)
 	{
@@ -169,6 +1231,45 @@ namespace library
 			}
 		}
 
+		for (auto& chunk : m_voxelChunks)
+		{
+			HRESULT hr = chunk->Initialize(pDevice);
+			if (FAILED(hr))
+			{
+				return hr;
+			}
+		}
+
+		if (m_voxelRenderMode == eVoxelRenderMode::INSTANCED)
+		{
+			HRESULT hr = initializeVoxelPalette(pDevice);
+			if (FAILED(hr))
+			{
+				return hr;
+			}
+
+			hr = initializeVoxelInstances(pDevice);
+			if (FAILED(hr))
+			{
+				return hr;
+			}
+		}
+
+		if (m_terrain)
+		{
+			HRESULT hr = initializeVoxelPalette(pDevice);
+			if (FAILED(hr))
+			{
+				return hr;
+			}
+
+			hr = m_terrain->Initialize(pDevice, pImmediateContext);
+			if (FAILED(hr))
+			{
+				return hr;
+			}
+		}
+
 		for (auto it = m_vertexShaders.begin(); it != m_vertexShaders.end(); ++it)
 		{
 			HRESULT hr = it->second->Initialize(pDevice);
@@ -367,11 +1468,551 @@ namespace library
 			m_skyBox->Update(deltaTime);
 	}
 
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Scene::UpdateVoxelStreaming
+
+	  Summary:  Feeds the camera to the chunk streamer of a generated
+				map and writes the columns of the chunks it promoted,
+				emptying the columns of the chunks it evicted. The
+				next UpdateVoxelInstances queues the chunks that see
+				the columns on the workers of the streamer, uploads
+				them once built and releases the evicted ones with
+				their slots. Never waits for the generation
+
+	  Args:     FXMVECTOR eye
+				  World space position of the camera
+
+	  Modifies: [m_chunkStreamer, and everything setVoxelColumns
+				 modifies].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Scene::UpdateVoxelStreaming(_In_ FXMVECTOR eye)
+	{
+		if (!m_chunkStreamer)
+		{
+			return;
+		}
+
+		// Cubes span 2 world units from the corner of the map
+		const XMFLOAT3 origin = GetVoxelMapOrigin();
+		const FLOAT cameraX = (XMVectorGetX(eye) - origin.x) * 0.5f;
+		const FLOAT cameraZ = (XMVectorGetZ(eye) - origin.z) * 0.5f;
+
+		std::vector<StreamedChunk> aPromoted;
+		std::vector<std::pair<UINT, UINT>> aEvicted;
+		m_chunkStreamer->Update(cameraX, cameraZ, STREAMING_CHUNKS_PER_FRAME, aPromoted, aEvicted);
+
+		std::vector<VoxelColumn> aColumns(static_cast<size_t>(VoxelChunk::SIZE) * VoxelChunk::SIZE);
+		for (const std::pair<UINT, UINT>& chunk : aEvicted)
+		{
+			const UINT uWidth = std::min(VoxelChunk::SIZE, m_aMapDimension[0] - chunk.first * VoxelChunk::SIZE);
+			const UINT uDepth = std::min(VoxelChunk::SIZE, m_aMapDimension[2] - chunk.second * VoxelChunk::SIZE);
+			std::fill(aColumns.begin(), aColumns.end(), VoxelColumn{ .BlockType = 0, .Reserved = 0u, .Height = 0u });
+			setVoxelColumns(chunk.first * VoxelChunk::SIZE, chunk.second * VoxelChunk::SIZE, uWidth, uDepth, aColumns.data());
+		}
+
+		for (const StreamedChunk& chunk : aPromoted)
+		{
+			const UINT uWidth = std::min(VoxelChunk::SIZE, m_aMapDimension[0] - chunk.ChunkX * VoxelChunk::SIZE);
+			const UINT uDepth = std::min(VoxelChunk::SIZE, m_aMapDimension[2] - chunk.ChunkZ * VoxelChunk::SIZE);
+			for (UINT z = 0u; z < uDepth; ++z)
+			{
+				for (UINT x = 0u; x < uWidth; ++x)
+				{
+					const size_t uSrcIdx = static_cast<size_t>(z) * VoxelChunk::SIZE + x;
+					aColumns[static_cast<size_t>(z) * uWidth + x] = VoxelColumn
+					{
+						.BlockType = static_cast<CHAR>(chunk.BlockTypes[uSrcIdx]),
+						.Reserved = 0u,
+						.Height = chunk.Heights[uSrcIdx]
+					};
+				}
+			}
+			setVoxelColumns(chunk.ChunkX * VoxelChunk::SIZE, chunk.ChunkZ * VoxelChunk::SIZE, uWidth, uDepth, aColumns.data());
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Scene::UpdateVoxelLods
+
+	  Summary:  Selects the level of detail of every chunk, and marks
+				the chunks whose level changed so their slots of the
+				instance buffer are patched
+
+	  Args:     FXMVECTOR eye
+				  World space position of the camera
+
+	  Modifies: [m_voxelChunks, m_aVoxelChunkStates,
+				 m_aDirtyVoxelChunks].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Scene::UpdateVoxelLods(_In_ FXMVECTOR eye)
+	{
+		for (std::shared_ptr<VoxelChunk>& chunk : m_voxelChunks)
+		{
+			const UINT uLod = chunk->GetLod();
+			chunk->UpdateLod(eye);
+			if (chunk->GetLod() != uLod && m_voxelInstanceBuffer)
+			{
+				markVoxelChunkDirty(chunk->GetChunkX(), chunk->GetChunkZ(), FALSE);
+			}
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Scene::UpdateVoxelInstances
+
+	  Summary:  Rebuilds the chunks whose columns changed and patches
+				the slots of the dirty chunks in the instance buffer.
+				On a streamed map the chunks are built by the workers
+				of the streamer and only uploaded here once built. A
+				chunk left without cubes gives its slots back and is
+				released. The instances are written to the next staging buffer
+				of a ring the GPU is done with and copied on the GPU,
+				so neither the buffer the frame draws from nor a busy
+				staging buffer is waited on. A chunk that outgrows its
+				slots moves to free slots, or to the end of the
+				buffer, which grows when full. Chunks that do not fit
+				in the staging buffer, or find every staging buffer
+				busy, wait for the next call
+
+	  Args:     ID3D11DeviceContext* pImmediateContext
+				  The Direct3D context to copy the instances
+
+	  Modifies: [m_voxelChunks, m_aVoxelChunkStates,
+				 m_aDirtyVoxelChunks, m_voxelSlotAllocator,
+				 m_voxelInstanceBuffer, m_uMaxNumVoxelInstances,
+				 m_aVoxelStagingBuffers, m_aNumVoxelStagingSlots,
+				 m_uVoxelStagingIdx].
+
+	  Returns:  HRESULT
+				  Status code
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT Scene::UpdateVoxelInstances(_In_ ID3D11DeviceContext* pImmediateContext)
+	{
+		ComPtr<ID3D11Device> device;
+		pImmediateContext->GetDevice(device.GetAddressOf());
+
+		HRESULT hr = S_OK;
+		if (m_chunkStreamer)
+		{
+			std::vector<StreamedChunkBuild> aBuilt;
+			m_chunkStreamer->CollectBuilds(aBuilt);
+			for (StreamedChunkBuild& build : aBuilt)
+			{
+				hr = applyVoxelChunkBuild(build, device.Get());
+				if (FAILED(hr))
+				{
+					return hr;
+				}
+			}
+		}
+
+		if (m_aDirtyVoxelChunks.empty())
+		{
+			return S_OK;
+		}
+
+		/*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+			Struct:   SlotCopy
+			Summary:  Slots of the staging buffer copied to the instance
+					  buffer
+		S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+		struct SlotCopy
+		{
+			UINT uStagingSlot;
+			VoxelSlotRange slots;
+		};
+
+		std::vector<SlotCopy> aCopies;
+		ID3D11Buffer* pStagingBuffer = nullptr;
+		InstanceData* pStagingInstances = nullptr;
+		UINT uNumStagingSlots = 0u;
+
+		size_t uNumUpdated = 0u;
+		for (; uNumUpdated < m_aDirtyVoxelChunks.size(); ++uNumUpdated)
+		{
+			const UINT uStateIdx = m_aDirtyVoxelChunks[uNumUpdated];
+			VoxelChunkState& state = m_aVoxelChunkStates[uStateIdx];
+			if (state.bRebuild && m_chunkStreamer)
+			{
+				// The current instances are still uploaded when the level of detail changed meanwhile
+				queueVoxelChunkBuild(state, uStateIdx);
+				state.bRebuild = FALSE;
+			}
+			else if (state.bRebuild)
+			{
+				hr = rebuildVoxelChunk(state, uStateIdx, device.Get());
+				if (FAILED(hr))
+				{
+					break;
+				}
+				state.bRebuild = FALSE;
+				state.bUpload = m_voxelInstanceBuffer ? TRUE : FALSE;
+
+				if (!m_voxelInstanceBuffer && m_voxelChunks[state.uChunkIdx]->IsEmpty())
+				{
+					releaseVoxelChunk(state);
+				}
+			}
+
+			if (!state.bUpload)
+			{
+				continue;
+			}
+
+			// A chunk without cubes writes air over its slots before handing them back
+			const BOOL bRelease = m_voxelChunks[state.uChunkIdx]->IsEmpty();
+			const std::vector<InstanceData>& aInstanceData = m_voxelChunks[state.uChunkIdx]->GetInstanceData();
+			const UINT uNumInstances = static_cast<UINT>(aInstanceData.size());
+			const BOOL bMove = !bRelease && uNumInstances > state.slots.uNumSlots;
+			const UINT uNumNewSlots = bRelease ? 0u : bMove ? getVoxelSlotCapacity(uNumInstances) : state.slots.uNumSlots;
+			const UINT uNumWrittenSlots = uNumNewSlots + (bMove || bRelease ? state.slots.uNumSlots : 0u);
+			if (uNumWrittenSlots == 0u)
+			{
+				state.bUpload = FALSE;
+				if (bRelease)
+				{
+					releaseVoxelChunk(state);
+				}
+				continue;
+			}
+
+			if (!pStagingInstances)
+			{
+				hr = mapVoxelStagingBuffer(device.Get(), pImmediateContext, uNumWrittenSlots, &pStagingInstances);
+				if (hr != S_OK)
+				{
+					break;
+				}
+				pStagingBuffer = m_aVoxelStagingBuffers[m_uVoxelStagingIdx].Get();
+			}
+			else if (uNumStagingSlots + uNumWrittenSlots > m_aNumVoxelStagingSlots[m_uVoxelStagingIdx])
+			{
+				break;
+			}
+
+			if (bMove || bRelease)
+			{
+				// Fill the old slots with air before handing them back
+				if (state.slots.uNumSlots > 0u)
+				{
+					std::fill(pStagingInstances + uNumStagingSlots, pStagingInstances + uNumStagingSlots + state.slots.uNumSlots, InstanceData{});
+					aCopies.push_back(SlotCopy{ .uStagingSlot = uNumStagingSlots, .slots = state.slots });
+					uNumStagingSlots += state.slots.uNumSlots;
+					m_voxelSlotAllocator.Free(state.slots);
+				}
+
+				// The copies run in order, so new slots overlapping the old ones are fine
+				state.slots = bRelease ? VoxelSlotRange{ .uFirstSlot = 0u, .uNumSlots = 0u } : m_voxelSlotAllocator.Allocate(uNumNewSlots);
+			}
+
+			if (bRelease)
+			{
+				state.bUpload = FALSE;
+				releaseVoxelChunk(state);
+				continue;
+			}
+
+			std::copy(aInstanceData.begin(), aInstanceData.end(), pStagingInstances + uNumStagingSlots);
+			std::fill(pStagingInstances + uNumStagingSlots + uNumInstances, pStagingInstances + uNumStagingSlots + state.slots.uNumSlots, InstanceData{});
+			aCopies.push_back(SlotCopy{ .uStagingSlot = uNumStagingSlots, .slots = state.slots });
+			uNumStagingSlots += state.slots.uNumSlots;
+			state.bUpload = FALSE;
+		}
+
+		if (pStagingInstances)
+		{
+			pImmediateContext->Unmap(pStagingBuffer, 0u);
+		}
+		m_aDirtyVoxelChunks.erase(m_aDirtyVoxelChunks.begin(), m_aDirtyVoxelChunks.begin() + static_cast<std::ptrdiff_t>(uNumUpdated));
+		if (FAILED(hr))
+		{
+			return hr;
+		}
+
+		if (m_voxelSlotAllocator.GetNumSlots() > m_uMaxNumVoxelInstances)
+		{
+			hr = growVoxelInstanceBuffer(device.Get(), pImmediateContext);
+			if (FAILED(hr))
+			{
+				return hr;
+			}
+		}
+
+		for (const SlotCopy& copy : aCopies)
+		{
+			const D3D11_BOX box =
+			{
+				.left = copy.uStagingSlot * static_cast<UINT>(sizeof(InstanceData)),
+				.top = 0u,
+				.front = 0u,
+				.right = (copy.uStagingSlot + copy.slots.uNumSlots) * static_cast<UINT>(sizeof(InstanceData)),
+				.bottom = 1u,
+				.back = 1u
+			};
+			pImmediateContext->CopySubresourceRegion(m_voxelInstanceBuffer.Get(), 0u, copy.slots.uFirstSlot * static_cast<UINT>(sizeof(InstanceData)), 0u, 0u, pStagingBuffer, 0u, &box);
+		}
+
+		if (!aCopies.empty())
+		{
+			m_uVoxelStagingIdx = (m_uVoxelStagingIdx + 1u) % NUM_VOXEL_STAGING_BUFFERS;
+		}
+
+		return S_OK;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Scene::UpdateTerrain
+
+	  Summary:  Selects the patches of the heightfield terrain around
+				the camera
+
+	  Args:     ID3D11DeviceContext* pImmediateContext
+				  The Direct3D context to copy the patches
+				FXMVECTOR eye
+				  World space position of the camera
+
+	  Modifies: [m_terrain].
+
+	  Returns:  HRESULT
+				  Status code
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT Scene::UpdateTerrain(_In_ ID3D11DeviceContext* pImmediateContext, _In_ FXMVECTOR eye)
+	{
+		if (!m_terrain)
+		{
+			return S_OK;
+		}
+
+		// Cubes span 2 world units from the corner of the map
+		const XMFLOAT3 origin = GetVoxelMapOrigin();
+		XMFLOAT3 cameraColumn;
+		XMStoreFloat3(&cameraColumn, XMVectorScale(XMVectorSubtract(eye, XMLoadFloat3(&origin)), 0.5f));
+
+		return m_terrain->UpdatePatches(pImmediateContext, cameraColumn);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Scene::PlaceBlock
+
+	  Summary:  Places a block on top of a column. The chunks that see
+				the column at any level of detail are marked dirty and
+				rebuilt by the next UpdateVoxelInstances. Columns hold
+				a single block type, so a block only goes on an empty
+				column or on a column of its own type
+
+	  Args:     const XMINT3& cell
+				  Grid cell of the block, right above its column
+				CHAR blockType
+				  Block type of the block
+
+	  Modifies: [m_aColumns, m_voxelLods, m_voxelRayCaster,
+				 m_aVoxelChunkStates, m_aDirtyVoxelChunks,
+				 m_bVoxelOctreeDirty].
+
+	  Returns:  HRESULT
+				  Status code, E_INVALIDARG when the cell is not the
+				  top of its column or the block type does not fit
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT Scene::PlaceBlock(_In_ const XMINT3& cell, _In_ CHAR blockType)
+	{
+		if (cell.x < 0 || cell.y < 0 || cell.z < 0 || static_cast<UINT>(cell.x) >= m_aMapDimension[0] || static_cast<UINT>(cell.z) >= m_aMapDimension[2] ||
+			m_aColumns.size() != static_cast<size_t>(m_aMapDimension[0]) * m_aMapDimension[2] ||
+			static_cast<size_t>(blockType) - static_cast<size_t>(eBlockType::GRASSLAND) >= m_voxels.size())
+		{
+			return E_INVALIDARG;
+		}
+
+		const UINT x = static_cast<UINT>(cell.x);
+		const UINT z = static_cast<UINT>(cell.z);
+		const VoxelColumn& column = m_aColumns[static_cast<size_t>(z) * m_aMapDimension[0] + x];
+		const UINT uHeight = getColumnHeight(0u, cell.x, cell.z);
+		if (static_cast<UINT>(cell.y) != uHeight || uHeight >= 0xFFFFu || (uHeight > 0u && column.BlockType != blockType))
+		{
+			return E_INVALIDARG;
+		}
+
+		setVoxelColumn(x, z, VoxelColumn{ .BlockType = blockType, .Reserved = column.Reserved, .Height = static_cast<WORD>(uHeight + 1u) });
+		return S_OK;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Scene::RemoveBlock
+
+	  Summary:  Removes the top block of a column. The chunks that see
+				the column at any level of detail are marked dirty and
+				rebuilt by the next UpdateVoxelInstances
+
+	  Args:     const XMINT3& cell
+				  Grid cell of the top block of its column
+
+	  Modifies: [m_aColumns, m_voxelLods, m_voxelRayCaster,
+				 m_aVoxelChunkStates, m_aDirtyVoxelChunks,
+				 m_bVoxelOctreeDirty].
+
+	  Returns:  HRESULT
+				  Status code, E_INVALIDARG when the cell is not the
+				  top block of its column
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT Scene::RemoveBlock(_In_ const XMINT3& cell)
+	{
+		if (cell.x < 0 || cell.y < 0 || cell.z < 0 || static_cast<UINT>(cell.x) >= m_aMapDimension[0] || static_cast<UINT>(cell.z) >= m_aMapDimension[2] ||
+			m_aColumns.size() != static_cast<size_t>(m_aMapDimension[0]) * m_aMapDimension[2])
+		{
+			return E_INVALIDARG;
+		}
+
+		const UINT x = static_cast<UINT>(cell.x);
+		const UINT z = static_cast<UINT>(cell.z);
+		const VoxelColumn& column = m_aColumns[static_cast<size_t>(z) * m_aMapDimension[0] + x];
+		const UINT uHeight = getColumnHeight(0u, cell.x, cell.z);
+		if (uHeight == 0u || static_cast<UINT>(cell.y) != uHeight - 1u)
+		{
+			return E_INVALIDARG;
+		}
+
+		setVoxelColumn(x, z, VoxelColumn{ .BlockType = column.BlockType, .Reserved = column.Reserved, .Height = static_cast<WORD>(uHeight - 1u) });
+		return S_OK;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Scene::RayCastVoxels
+
+	  Summary:  Finds the first cube of the map hit by a ray. Cells
+				span 2 world units from the corner of the map, so
+				the ray is cast through the grid in half units
+
+	  Args:     const XMFLOAT3& origin
+				  World space start of the ray
+				const XMFLOAT3& direction
+				  World space direction of the ray
+				FLOAT maxDistance
+				  Length of the ray in world units
+				VoxelRayHit& hit
+				  Grid cell, face normal and block type of the cube
+				  hit, and its distance in world units
+
+	  Modifies: [hit].
+
+	  Returns:  BOOL
+				  TRUE if the ray hits a cube
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	BOOL Scene::RayCastVoxels(_In_ const XMFLOAT3& origin, _In_ const XMFLOAT3& direction, _In_ FLOAT maxDistance, _Out_ VoxelRayHit& hit) const
+	{
+		const XMFLOAT3 mapOrigin = GetVoxelMapOrigin();
+		const XMFLOAT3 cellOrigin((origin.x - mapOrigin.x) * 0.5f, (origin.y - mapOrigin.y) * 0.5f, (origin.z - mapOrigin.z) * 0.5f);
+		if (!m_voxelRayCaster.RayCast(m_aColumns.data(), cellOrigin, direction, maxDistance * 0.5f, hit))
+		{
+			return FALSE;
+		}
+
+		hit.Distance *= 2.0f;
+		return TRUE;
+	}
+
 	std::vector<std::shared_ptr<Voxel>>& Scene::GetVoxels()
 	{
 		return m_voxels;
 	}
 
+	std::vector<std::shared_ptr<VoxelChunk>>& Scene::GetVoxelChunks()
+	{
+		return m_voxelChunks;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Scene::GetVoxelInstanceBuffer
+
+	  Summary:  Returns the instance buffer of every cube of the map
+
+	  Returns:  ComPtr<ID3D11Buffer>&
+				  Instance buffer
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	ComPtr<ID3D11Buffer>& Scene::GetVoxelInstanceBuffer()
+	{
+		return m_voxelInstanceBuffer;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Scene::GetNumVoxelInstances
+
+	  Summary:  Returns the number of slots of the instance buffer to
+				draw. Free slots and the slots a chunk does not fill
+				hold air, which the shaders drop
+
+	  Returns:  UINT
+				  Number of instances
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT Scene::GetNumVoxelInstances() const
+	{
+		return m_voxelSlotAllocator.GetNumSlots();
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Scene::GetVoxelPaletteConstantBuffer
+
+	  Summary:  Returns the constant buffer of the block type colors
+
+	  Returns:  ComPtr<ID3D11Buffer>&
+				  Palette constant buffer
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	ComPtr<ID3D11Buffer>& Scene::GetVoxelPaletteConstantBuffer()
+	{
+		return m_cbVoxelPalette;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Scene::GetVoxelMapOrigin
+
+	  Summary:  Returns the corner of the map the cube instances and
+				the greedy meshes are relative to
+
+	  Returns:  XMFLOAT3
+				  World space corner with the lowest coordinates
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	XMFLOAT3 Scene::GetVoxelMapOrigin() const
+	{
+		return getVoxelCorner(m_aMapDimension, 0u, 0u, 0u, 0u);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Scene::GetVoxelOctree
+
+	  Summary:  Returns the sparse octree of the map. Its cells are
+				the grid cells of the map, each spanning 2 world units
+				from the corner returned by GetVoxelMapOrigin. The
+				octree is rebuilt here after blocks were placed or
+				removed
+
+	  Modifies: [m_voxelOctree, m_bVoxelOctreeDirty].
+
+	  Returns:  const VoxelOctree&
+				  Octree of the columns of the map
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	const VoxelOctree& Scene::GetVoxelOctree()
+	{
+		if (m_bVoxelOctreeDirty)
+		{
+			m_voxelOctree.Build(m_aColumns.data(), m_aMapDimension[0], m_aMapDimension[2], m_voxels.size());
+			m_bVoxelOctreeDirty = FALSE;
+		}
+
+		return m_voxelOctree;
+	}
+
+	eVoxelRenderMode Scene::GetVoxelRenderMode() const
+	{
+		return m_voxelRenderMode;
+	}
+
+	std::shared_ptr<VertexShader>& Scene::GetVoxelMeshVertexShader()
+	{
+		return m_voxelMeshVertexShader;
+	}
+
+	std::shared_ptr<HeightfieldTerrain>& Scene::GetTerrain()
+	{
+		return m_terrain;
+	}
 
 	std::unordered_map<std::wstring, std::shared_ptr<Renderable>>& Scene::GetRenderables()
 	{
@@ -530,39 +2171,46 @@ namespace library
 		return S_OK;
 	}
 
-	FLOAT Scene::getNoise2(UINT x, UINT y)
+	HRESULT Scene::SetVertexShaderOfVoxelMesh(_In_ PCWSTR pszVertexShaderName)
 	{
-		UINT temp = ms_aHashes[y % 256u];
+		if (!m_vertexShaders.contains(pszVertexShaderName))
+		{
+			return E_FAIL;
+		}
 
-		return static_cast<FLOAT>(ms_aHashes[(temp + x) % 256u]);
+		m_voxelMeshVertexShader = m_vertexShaders[pszVertexShaderName];
+
+		return S_OK;
 	}
 
-	FLOAT Scene::getNoise2d(FLOAT x, FLOAT y)
+	HRESULT Scene::SetVertexShaderOfTerrain(_In_ PCWSTR pszVertexShaderName)
 	{
-		UINT uX = static_cast<UINT>(x);
-		UINT uY = static_cast<UINT>(y);
-		FLOAT xFrac = x - static_cast<FLOAT>(uX);
-		FLOAT yFrac = y - static_cast<FLOAT>(uY);
-
-		UINT s = static_cast<UINT>(getNoise2(uX, uY));
-		UINT t = static_cast<UINT>(getNoise2(uX + 1u, uY));
-		UINT u = static_cast<UINT>(getNoise2(uX, uY + 1u));
-		UINT v = static_cast<UINT>(getNoise2(uX + 1u, uY + 1u));
+		if (!m_vertexShaders.contains(pszVertexShaderName))
+		{
+			return E_FAIL;
+		}
 
-		FLOAT low = smoothLerp(static_cast<FLOAT>(s), static_cast<FLOAT>(t), xFrac);
-		FLOAT high = smoothLerp(static_cast<FLOAT>(u), static_cast<FLOAT>(v), xFrac);
+		if (m_terrain)
+		{
+			m_terrain->SetVertexShader(m_vertexShaders[pszVertexShaderName]);
+		}
 
-		return smoothLerp(low, high, yFrac);
+		return S_OK;
 	}
 
-	FLOAT Scene::lerp(FLOAT x, FLOAT y, FLOAT s)
+	HRESULT Scene::SetPixelShaderOfTerrain(_In_ PCWSTR pszPixelShaderName)
 	{
-		return x + s * (y - x);
-	}
+		if (!m_pixelShaders.contains(pszPixelShaderName))
+		{
+			return E_FAIL;
+		}
 
-	FLOAT Scene::smoothLerp(FLOAT x, FLOAT y, FLOAT s)
-	{
-		return lerp(x, y, s * s * (3.0f - 2.0f * s));
+		if (m_terrain)
+		{
+			m_terrain->SetPixelShader(m_pixelShaders[pszPixelShaderName]);
+		}
+
+		return S_OK;
 	}
 
 }
\ No newline at end of file
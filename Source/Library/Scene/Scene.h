@@ -13,23 +13,62 @@
 
 #include "Common.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cfloat>
+#include <climits>
+#include <cmath>
 #include <fstream>
+#include <thread>
 
 #include "Model/Model.h"
 #include "Light/PointLight.h"
 #include "Renderer/Skybox.h"
 #include "Renderer/Renderable.h"
+#include "Scene/ChunkStreamer.h"
+#include "Scene/GreedyMesher.h"
+#include "Scene/HeightMapLoader.h"
+#include "Scene/HeightfieldTerrain.h"
+#include "Scene/PerlinNoise.h"
 #include "Scene/Voxel.h"
+#include "Scene/VoxelChunk.h"
+#include "Scene/VoxelInstanceBuilder.h"
+#include "Scene/VoxelLods.h"
+#include "Scene/VoxelMap.h"
+#include "Scene/VoxelOctree.h"
+#include "Scene/VoxelRayCaster.h"
+#include "Scene/VoxelSlotAllocator.h"
 
 namespace library
 {
+	/*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+		Struct:   VoxelChunkState
+		Summary:  Chunk of a square of columns, as its index in the
+				  chunks of the scene or UINT_MAX while it holds no
+				  cube, and the slots its instances occupy. bRebuild
+				  is set when its columns changed, bUpload when its
+				  instances must be copied to its slots. uBuildVersion
+				  counts the builds queued on the streaming workers,
+				  only the last one is kept
+	S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+	struct VoxelChunkState
+	{
+		UINT uChunkIdx;
+		VoxelSlotRange slots;
+		BOOL bRebuild;
+		BOOL bUpload;
+		UINT uBuildVersion;
+	};
+
 	class Scene
 	{
 	public:
 		static FLOAT GetPerlin2d(FLOAT x, FLOAT y, FLOAT frequency, UINT uDepth);
+		static void GetPerlin2dBatch(_In_ FLOAT x, _In_ FLOAT y, _In_ FLOAT step, _In_ UINT uNumX, _In_ UINT uNumY, _In_ FLOAT frequency, _In_ UINT uDepth, _Out_writes_(static_cast<size_t>(uNumX) * uNumY) FLOAT* pSamples);
 
 		Scene() = delete;
-		Scene(const std::filesystem::path& filePath);
+		Scene(const std::filesystem::path& filePath, UINT uNumLoadingThreads = 0u, eVoxelRenderMode voxelRenderMode = eVoxelRenderMode::INSTANCED);
+		Scene(UINT uSeed, UINT uWidth, UINT uHeight, UINT uDepth, const std::vector<XMFLOAT3>& aPalette, eVoxelRenderMode voxelRenderMode = eVoxelRenderMode::INSTANCED);
 		Scene(const Scene& other) = delete;
 		Scene(Scene&& other) = delete;
 		Scene& operator=(const Scene& other) = delete;
@@ -48,8 +87,24 @@ namespace library
 		HRESULT AddMaterial(_In_ const std::shared_ptr<Material>& material);
 
 		void Update(_In_ FLOAT deltaTime);
+		void UpdateVoxelStreaming(_In_ FXMVECTOR eye);
+		void UpdateVoxelLods(_In_ FXMVECTOR eye);
+		HRESULT UpdateVoxelInstances(_In_ ID3D11DeviceContext* pImmediateContext);
+		HRESULT UpdateTerrain(_In_ ID3D11DeviceContext* pImmediateContext, _In_ FXMVECTOR eye);
+		HRESULT PlaceBlock(_In_ const XMINT3& cell, _In_ CHAR blockType);
+		HRESULT RemoveBlock(_In_ const XMINT3& cell);
+		BOOL RayCastVoxels(_In_ const XMFLOAT3& origin, _In_ const XMFLOAT3& direction, _In_ FLOAT maxDistance, _Out_ VoxelRayHit& hit) const;
 
 		std::vector<std::shared_ptr<Voxel>>& GetVoxels();
+		std::vector<std::shared_ptr<VoxelChunk>>& GetVoxelChunks();
+		ComPtr<ID3D11Buffer>& GetVoxelInstanceBuffer();
+		UINT GetNumVoxelInstances() const;
+		ComPtr<ID3D11Buffer>& GetVoxelPaletteConstantBuffer();
+		XMFLOAT3 GetVoxelMapOrigin() const;
+		const VoxelOctree& GetVoxelOctree();
+		eVoxelRenderMode GetVoxelRenderMode() const;
+		std::shared_ptr<VertexShader>& GetVoxelMeshVertexShader();
+		std::shared_ptr<HeightfieldTerrain>& GetTerrain();
 		std::unordered_map<std::wstring, std::shared_ptr<Renderable>>& GetRenderables();
 		std::unordered_map<std::wstring, std::shared_ptr<Model>>& GetModels();
 		std::shared_ptr<PointLight>& GetPointLight(_In_ size_t index);
@@ -70,34 +125,77 @@ namespace library
 		HRESULT SetVertexShaderOfVoxel(_In_ PCWSTR pszVertexShaderName);
 		HRESULT SetPixelShaderOfVoxel(_In_ PCWSTR pszPixelShaderName);
 		HRESULT SetMaterialOfVoxel(_In_ PCWSTR pszMaterialName);
+		HRESULT SetVertexShaderOfVoxelMesh(_In_ PCWSTR pszVertexShaderName);
+		HRESULT SetVertexShaderOfTerrain(_In_ PCWSTR pszVertexShaderName);
+		HRESULT SetPixelShaderOfTerrain(_In_ PCWSTR pszPixelShaderName);
 
 
 	private:
-		static FLOAT getNoise2(UINT x, UINT y);
-		static FLOAT getNoise2d(FLOAT x, FLOAT y);
-		static FLOAT lerp(FLOAT x, FLOAT y, FLOAT s);
-		static FLOAT smoothLerp(FLOAT x, FLOAT y, FLOAT s);
+		void loadHeightMap(_In_ UINT uNumThreads);
+		HRESULT loadVoxelMap();
+		void buildVoxelMap(_In_ UINT uNumThreads);
+		void buildVoxelChunks(_In_ UINT uNumThreads);
+		void buildVoxelChunk(_Inout_ VoxelChunk& chunk, _In_ UINT uLod) const;
+		void buildVoxelChunkMesh(_Inout_ VoxelChunk& chunk, _In_ UINT uLod) const;
+		void setVoxelColumn(_In_ UINT x, _In_ UINT z, _In_ const VoxelColumn& column);
+		void setVoxelColumns(_In_ UINT uX, _In_ UINT uZ, _In_ UINT uWidth, _In_ UINT uDepth, _In_reads_(static_cast<size_t>(uWidth) * uDepth) const VoxelColumn* pColumns);
+		void markVoxelChunkDirty(_In_ UINT uChunkX, _In_ UINT uChunkZ, _In_ BOOL bRebuild);
+		HRESULT rebuildVoxelChunk(_Inout_ VoxelChunkState& state, _In_ UINT uStateIdx, _In_ ID3D11Device* pDevice);
+		void queueVoxelChunkBuild(_Inout_ VoxelChunkState& state, _In_ UINT uStateIdx);
+		HRESULT applyVoxelChunkBuild(_Inout_ StreamedChunkBuild& build, _In_ ID3D11Device* pDevice);
+		void releaseVoxelChunk(_Inout_ VoxelChunkState& state);
+		HRESULT growVoxelInstanceBuffer(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext);
+		HRESULT createVoxelStagingBuffer(_In_ ID3D11Device* pDevice, _In_ UINT uStagingIdx, _In_ UINT uNumSlots);
+		HRESULT mapVoxelStagingBuffer(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext, _In_ UINT uNumSlots, _Out_ InstanceData** ppStagingInstances);
+		HRESULT initializeVoxelPalette(_In_ ID3D11Device* pDevice);
+		HRESULT initializeVoxelInstances(_In_ ID3D11Device* pDevice);
+		const std::vector<VoxelColumn>& getLodColumns(_In_ UINT uLod) const;
+		UINT getLodWidth(_In_ UINT uLod) const;
+		UINT getLodDepth(_In_ UINT uLod) const;
+		UINT getColumnHeight(_In_ UINT uLod, _In_ INT x, _In_ INT z) const;
+
+		static XMFLOAT3 getVoxelPosition(_In_ const UINT aDimension[3], _In_ UINT x, _In_ UINT y, _In_ UINT z);
+		static XMFLOAT3 getVoxelCorner(_In_ const UINT aDimension[3], _In_ UINT uLod, _In_ UINT x, _In_ UINT y, _In_ UINT z);
+		static UINT getVoxelSlotCapacity(_In_ UINT uNumInstances);
 
 	private:
-		static constexpr const UINT ms_aHashes[] =
-		{
-			208,34,231,213,32,248,233,56,161,78,24,140,71,48,140,254,245,255,247,247,40,
-			185,248,251,245,28,124,204,204,76,36,1,107,28,234,163,202,224,245,128,167,204,
-			9,92,217,54,239,174,173,102,193,189,190,121,100,108,167,44,43,77,180,204,8,81,
-			70,223,11,38,24,254,210,210,177,32,81,195,243,125,8,169,112,32,97,53,195,13,
-			203,9,47,104,125,117,114,124,165,203,181,235,193,206,70,180,174,0,167,181,41,
-			164,30,116,127,198,245,146,87,224,149,206,57,4,192,210,65,210,129,240,178,105,
-			228,108,245,148,140,40,35,195,38,58,65,207,215,253,65,85,208,76,62,3,237,55,89,
-			232,50,217,64,244,157,199,121,252,90,17,212,203,149,152,140,187,234,177,73,174,
-			193,100,192,143,97,53,145,135,19,103,13,90,135,151,199,91,239,247,33,39,145,
-			101,120,99,3,186,86,99,41,237,203,111,79,220,135,158,42,30,154,120,67,87,167,
-			135,176,183,191,253,115,184,21,233,58,129,233,142,39,128,211,118,137,139,255,
-			114,20,218,113,154,27,127,246,250,1,8,198,250,209,92,222,173,21,88,102,219
-		};
+		static constexpr const UINT NUM_VOXEL_STAGING_BUFFERS = 3u;
+		static constexpr const UINT VOXEL_STAGING_SLOTS = 65536u;
+		static constexpr const FLOAT STREAMING_LOAD_RADIUS = 8.0f;
+		static constexpr const FLOAT STREAMING_UNLOAD_RADIUS = 10.0f;
+		static constexpr const UINT STREAMING_MAX_NUM_CHUNKS = 384u;
+		static constexpr const UINT STREAMING_CHUNKS_PER_FRAME = 2u;
+		static constexpr const WCHAR STREAMING_CACHE_DIRECTORY[] = L"ChunkCache";
+		static constexpr const UINT TERRAIN_NUM_LODS = 7u;
+		static constexpr const FLOAT TERRAIN_LOD_DISTANCE = 96.0f;
+		static constexpr const FLOAT TERRAIN_MORPH_RATIO = 0.3f;
+
+		static_assert(ChunkStreamer::CHUNK_SIZE == VoxelChunk::SIZE, "Streamed chunks are the chunks of the scene");
+
 
 	private:
 		std::filesystem::path m_filePath;
 		std::vector<std::shared_ptr<Voxel>> m_voxels{};
+		std::vector<std::shared_ptr<VoxelChunk>> m_voxelChunks;
+		std::vector<VoxelColumn> m_aColumns;
+		VoxelLods m_voxelLods;
+		UINT m_aMapDimension[3];
+		VoxelOctree m_voxelOctree;
+		BOOL m_bVoxelOctreeDirty;
+		VoxelRayCaster m_voxelRayCaster;
+		eVoxelRenderMode m_voxelRenderMode;
+		std::shared_ptr<VertexShader> m_voxelMeshVertexShader;
+		ComPtr<ID3D11Buffer> m_voxelInstanceBuffer;
+		ComPtr<ID3D11Buffer> m_cbVoxelPalette;
+		UINT m_uMaxNumVoxelInstances;
+		std::vector<VoxelChunkState> m_aVoxelChunkStates;
+		std::vector<UINT> m_aDirtyVoxelChunks;
+		VoxelSlotAllocator m_voxelSlotAllocator;
+		ComPtr<ID3D11Buffer> m_aVoxelStagingBuffers[NUM_VOXEL_STAGING_BUFFERS];
+		UINT m_aNumVoxelStagingSlots[NUM_VOXEL_STAGING_BUFFERS];
+		UINT m_uVoxelStagingIdx;
+		std::unique_ptr<ChunkStreamer> m_chunkStreamer;
+		std::shared_ptr<HeightfieldTerrain> m_terrain;
 		std::unordered_map<std::wstring, std::shared_ptr<Renderable>> m_renderables;
 		std::unordered_map<std::wstring, std::shared_ptr<Model>> m_models;
 		std::shared_ptr<PointLight> m_aPointLights[NUM_LIGHTS];
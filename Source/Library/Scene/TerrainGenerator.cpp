@@ -0,0 +1,546 @@
+#include "Scene/TerrainGenerator.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainGenerator::TerrainGenerator
+
+      Summary:  Constructor. Starts uNumThreads - 1 threads, the
+                thread calling Generate is the last one
+
+      Args:     UINT uSeed
+                  Seed of the terrain
+                UINT uNumThreads
+                  Number of threads generating tiles, 0 for the
+                  number of hardware threads
+
+      Modifies: [m_heightNoise, m_moistureNoise, m_densityNoise,
+                 m_caveNoise, m_biomeClassifier, m_aThreads, m_mutex,
+                 m_jobCondition, m_doneCondition, m_job, m_uJobId,
+                 m_uNumBusyThreads, m_bStop, m_uNextTileIdx].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    TerrainGenerator::TerrainGenerator(_In_ UINT uSeed, _In_ UINT uNumThreads)
+        : m_heightNoise(uSeed)
+        , m_moistureNoise(uSeed ^ MOISTURE_SEED)
+        , m_densityNoise(uSeed ^ DENSITY_SEED)
+        , m_caveNoise(uSeed ^ CAVE_SEED)
+        , m_biomeClassifier()
+        , m_aThreads()
+        , m_mutex()
+        , m_jobCondition()
+        , m_doneCondition()
+        , m_job()
+        , m_uJobId(0u)
+        , m_uNumBusyThreads(0u)
+        , m_bStop(FALSE)
+        , m_uNextTileIdx(0u)
+    {
+        if (uNumThreads == 0u)
+        {
+            uNumThreads = std::max(std::thread::hardware_concurrency(), 1u);
+        }
+
+        m_aThreads.reserve(uNumThreads - 1u);
+        for (UINT i = 1u; i < uNumThreads; ++i)
+        {
+            m_aThreads.emplace_back(&TerrainGenerator::work, this);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainGenerator::~TerrainGenerator
+
+      Summary:  Destructor. Stops and joins the threads
+
+      Modifies: [m_aThreads, m_bStop].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    TerrainGenerator::~TerrainGenerator()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_bStop = TRUE;
+        }
+        m_jobCondition.notify_all();
+
+        for (std::thread& thread : m_aThreads)
+        {
+            thread.join();
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainGenerator::Generate
+
+      Summary:  Fills the grids of the uWidth x uDepth columns from
+                column (uX, uZ), row by row along the depth. The
+                threads of the pool and the calling thread generate
+                the tiles of the region, and the call returns once
+                every tile is done. Only one thread may call Generate
+                at a time
+
+      Args:     UINT uX, UINT uZ
+                  First column of the region
+                UINT uWidth
+                  Number of columns along the width
+                UINT uDepth
+                  Number of columns along the depth
+                FLOAT* pHeights
+                  Receives the heights in [0, 1.2^1.25), may be null
+                FLOAT* pMoistures
+                  Receives the moistures in [0, 1.2^1.25), may be null
+                eBlockType* pBlockTypes
+                  Receives the biomes, may be null
+
+      Modifies: [m_job, m_uJobId, m_uNumBusyThreads, m_uNextTileIdx,
+                 pHeights, pMoistures, pBlockTypes].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TerrainGenerator::Generate(_In_ UINT uX, _In_ UINT uZ, _In_ UINT uWidth, _In_ UINT uDepth, _Out_writes_opt_(static_cast<size_t>(uWidth) * uDepth) FLOAT* pHeights, _Out_writes_opt_(static_cast<size_t>(uWidth) * uDepth) FLOAT* pMoistures, _Out_writes_opt_(static_cast<size_t>(uWidth) * uDepth) eBlockType* pBlockTypes)
+    {
+        if (uWidth == 0u || uDepth == 0u)
+        {
+            return;
+        }
+
+        const UINT uNumTilesX = (uWidth + TILE_SIZE - 1u) / TILE_SIZE;
+        const UINT uNumTilesZ = (uDepth + TILE_SIZE - 1u) / TILE_SIZE;
+        const Job job =
+        {
+            .uX = uX,
+            .uZ = uZ,
+            .uWidth = uWidth,
+            .uDepth = uDepth,
+            .uNumTilesX = uNumTilesX,
+            .uNumTiles = uNumTilesX * uNumTilesZ,
+            .pHeights = pHeights,
+            .pMoistures = pMoistures,
+            .pBlockTypes = pBlockTypes,
+            .pChunks = nullptr,
+        };
+
+        run(job);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainGenerator::GenerateOccupancy
+
+      Summary:  Fills the occupancy of the uNumChunksX x uNumChunksZ
+                chunks from chunk (uChunkX, uChunkZ), row by row along
+                the depth. Chunk (x, z) holds the columns from
+                (x * VoxelOccupancy::SIZE, z * VoxelOccupancy::SIZE),
+                which Generate gives the biomes of, and keeps the
+                height it was resized to. Cells at y = 0 are always
+                solid. The threads of the pool and the calling thread
+                generate one chunk at a time. Only one thread may call
+                GenerateOccupancy or Generate at a time
+
+      Args:     UINT uChunkX, UINT uChunkZ
+                  First chunk of the region
+                UINT uNumChunksX
+                  Number of chunks along the width
+                UINT uNumChunksZ
+                  Number of chunks along the depth
+                VoxelOccupancy* pChunks
+                  Chunks to fill
+
+      Modifies: [m_job, m_uJobId, m_uNumBusyThreads, m_uNextTileIdx,
+                 pChunks].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TerrainGenerator::GenerateOccupancy(_In_ UINT uChunkX, _In_ UINT uChunkZ, _In_ UINT uNumChunksX, _In_ UINT uNumChunksZ, _Inout_ VoxelOccupancy* pChunks)
+    {
+        if (uNumChunksX == 0u || uNumChunksZ == 0u)
+        {
+            return;
+        }
+
+        const Job job =
+        {
+            .uX = uChunkX,
+            .uZ = uChunkZ,
+            .uWidth = uNumChunksX,
+            .uDepth = uNumChunksZ,
+            .uNumTilesX = uNumChunksX,
+            .uNumTiles = uNumChunksX * uNumChunksZ,
+            .pHeights = nullptr,
+            .pMoistures = nullptr,
+            .pBlockTypes = nullptr,
+            .pChunks = pChunks,
+        };
+
+        run(job);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainGenerator::SetBiomeRegions
+
+      Summary:  Replaces the regions that map the height and moisture
+                of a column to its biome. Must not be called during a
+                call to Generate
+
+      Args:     const BiomeRegion* pRegions
+                  Regions, in order of priority
+                size_t uNumRegions
+                  Number of regions
+
+      Modifies: [m_biomeClassifier].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TerrainGenerator::SetBiomeRegions(_In_reads_(uNumRegions) const BiomeRegion* pRegions, _In_ size_t uNumRegions)
+    {
+        m_biomeClassifier.SetRegions(pRegions, uNumRegions);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainGenerator::GetSeed
+
+      Summary:  Returns the seed
+
+      Returns:  UINT
+                  Seed of the terrain
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT TerrainGenerator::GetSeed() const
+    {
+        return m_heightNoise.GetSeed();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainGenerator::GetFingerprint
+
+      Summary:  Returns the 64-bit FNV-1a hash of the version, the
+                seed, the noise parameters and the biome table, so
+                terrain cached by a generator is only reused by a
+                generator that would generate the same terrain
+
+      Returns:  UINT64
+                  Fingerprint of the generator
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT64 TerrainGenerator::GetFingerprint() const
+    {
+        UINT64 uHash = 0xCBF29CE484222325ull;
+        const auto hash = [&uHash](const void* pData, size_t uSize)
+        {
+            const BYTE* pBytes = static_cast<const BYTE*>(pData);
+            for (size_t i = 0u; i < uSize; ++i)
+            {
+                uHash = (uHash ^ pBytes[i]) * 0x100000001B3ull;
+            }
+        };
+
+        const UINT uSeed = GetSeed();
+        const UINT aParameters[] = { VERSION, NUM_OCTAVES, DEPTH, MOISTURE_SEED, DENSITY_DEPTH, DENSITY_SEED, CAVE_DEPTH, CAVE_SEED };
+        const FLOAT aFrequencies[] = { FREQUENCY, DENSITY_FREQUENCY, DENSITY_FALLOFF, CAVE_FREQUENCY, CAVE_THRESHOLD };
+        hash(&uSeed, sizeof(uSeed));
+        hash(aParameters, sizeof(aParameters));
+        hash(aFrequencies, sizeof(aFrequencies));
+        hash(m_biomeClassifier.GetTable().data(), sizeof(BiomeClassifier::Table));
+
+        return uHash;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainGenerator::GetNumThreads
+
+      Summary:  Returns the number of threads generating tiles,
+                including the thread calling Generate
+
+      Returns:  UINT
+                  Number of threads
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT TerrainGenerator::GetNumThreads() const
+    {
+        return static_cast<UINT>(m_aThreads.size()) + 1u;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainGenerator::run
+
+      Summary:  Hands a job to the threads of the pool, works on it
+                and waits until every thread is done
+
+      Args:     const Job& job
+                  Job to run
+
+      Modifies: [m_job, m_uJobId, m_uNumBusyThreads, m_uNextTileIdx].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TerrainGenerator::run(_In_ const Job& job)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_job = job;
+            m_uNextTileIdx = 0u;
+            m_uNumBusyThreads = static_cast<UINT>(m_aThreads.size());
+            ++m_uJobId;
+        }
+        m_jobCondition.notify_all();
+
+        generateTiles(job);
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_doneCondition.wait(lock, [this]() { return m_uNumBusyThreads == 0u; });
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainGenerator::work
+
+      Summary:  Loop of a thread of the pool, which waits for a job,
+                generates tiles until none is left and reports that it
+                is done
+
+      Modifies: [m_uNumBusyThreads].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TerrainGenerator::work()
+    {
+        UINT64 uJobId = 0u;
+        for (;;)
+        {
+            Job job;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_jobCondition.wait(lock, [this, &uJobId]() { return m_bStop || m_uJobId != uJobId; });
+                if (m_bStop)
+                {
+                    return;
+                }
+
+                uJobId = m_uJobId;
+                job = m_job;
+            }
+
+            generateTiles(job);
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (--m_uNumBusyThreads == 0u)
+            {
+                m_doneCondition.notify_one();
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainGenerator::generateTiles
+
+      Summary:  Claims and generates tiles or chunks of a job until
+                none is left
+
+      Args:     const Job& job
+                  Region and grids to fill
+
+      Modifies: [m_uNextTileIdx].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TerrainGenerator::generateTiles(_In_ const Job& job)
+    {
+        std::vector<FLOAT> aNoise;
+        for (UINT uTileIdx = m_uNextTileIdx++; uTileIdx < job.uNumTiles; uTileIdx = m_uNextTileIdx++)
+        {
+            if (job.pChunks)
+            {
+                generateChunk(job, uTileIdx, aNoise);
+            }
+            else
+            {
+                generateTile(job, uTileIdx, aNoise);
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainGenerator::generateTile
+
+      Summary:  Samples the height and moisture of a tile when the job
+                needs them and writes the tile into the grids
+
+      Args:     const Job& job
+                  Region and grids to fill
+                UINT uTileIdx
+                  Tile of the region, row by row along the depth
+                std::vector<FLOAT>& aNoise
+                  Scratch memory of the calling thread
+
+      Modifies: [aNoise, job.pHeights, job.pMoistures,
+                 job.pBlockTypes].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TerrainGenerator::generateTile(_In_ const Job& job, _In_ UINT uTileIdx, _Inout_ std::vector<FLOAT>& aNoise) const
+    {
+        const UINT uTileX = (uTileIdx % job.uNumTilesX) * TILE_SIZE;
+        const UINT uTileZ = (uTileIdx / job.uNumTilesX) * TILE_SIZE;
+        const UINT uWidth = std::min(TILE_SIZE, job.uWidth - uTileX);
+        const UINT uDepth = std::min(TILE_SIZE, job.uDepth - uTileZ);
+        const size_t uNumColumns = static_cast<size_t>(uWidth) * uDepth;
+
+        aNoise.resize(uNumColumns * (NUM_OCTAVES + 2u));
+        FLOAT* pHeights = aNoise.data() + uNumColumns * NUM_OCTAVES;
+        FLOAT* pMoistures = pHeights + uNumColumns;
+        if (job.pHeights || job.pBlockTypes)
+        {
+            sampleTerrain(m_heightNoise, job.uX + uTileX, job.uZ + uTileZ, uWidth, uDepth, aNoise.data(), pHeights);
+        }
+        if (job.pMoistures || job.pBlockTypes)
+        {
+            sampleTerrain(m_moistureNoise, job.uX + uTileX, job.uZ + uTileZ, uWidth, uDepth, aNoise.data(), pMoistures);
+        }
+
+        for (UINT z = 0u; z < uDepth; ++z)
+        {
+            const size_t uRowIdx = static_cast<size_t>(uTileZ + z) * job.uWidth + uTileX;
+            const FLOAT* pRowHeights = pHeights + static_cast<size_t>(z) * uWidth;
+            const FLOAT* pRowMoistures = pMoistures + static_cast<size_t>(z) * uWidth;
+            if (job.pHeights)
+            {
+                std::copy(pRowHeights, pRowHeights + uWidth, job.pHeights + uRowIdx);
+            }
+            if (job.pMoistures)
+            {
+                std::copy(pRowMoistures, pRowMoistures + uWidth, job.pMoistures + uRowIdx);
+            }
+            if (job.pBlockTypes)
+            {
+                m_biomeClassifier.ClassifyRow(pRowHeights, pRowMoistures, uWidth, job.pBlockTypes + uRowIdx);
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainGenerator::generateChunk
+
+      Summary:  Fills the occupancy of a chunk one row of cells along
+                x at a time. The density of a cell is its distance
+                below the surface of the height field over
+                DENSITY_FALLOFF plus 3D gradient noise in [-1, 1], and
+                the cell is solid if the density is positive and the
+                cave noise is at most CAVE_THRESHOLD. Rows at least
+                DENSITY_FALLOFF below or above every column of the
+                row are solid or empty without sampling the density,
+                and the cave noise is only sampled for rows with a
+                solid cell
+
+      Args:     const Job& job
+                  Region of chunks to fill
+                UINT uTileIdx
+                  Chunk of the region, row by row along the depth
+                std::vector<FLOAT>& aNoise
+                  Scratch memory of the calling thread
+
+      Modifies: [aNoise, job.pChunks].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TerrainGenerator::generateChunk(_In_ const Job& job, _In_ UINT uTileIdx, _Inout_ std::vector<FLOAT>& aNoise) const
+    {
+        constexpr const UINT SIZE = VoxelOccupancy::SIZE;
+        constexpr const size_t NUM_COLUMNS = static_cast<size_t>(SIZE) * SIZE;
+
+        VoxelOccupancy& occupancy = job.pChunks[uTileIdx];
+        const UINT uHeight = occupancy.GetHeight();
+        const UINT uBeginX = (job.uX + uTileIdx % job.uNumTilesX) * SIZE;
+        const UINT uBeginZ = (job.uZ + uTileIdx / job.uNumTilesX) * SIZE;
+        occupancy.Clear();
+
+        aNoise.resize(NUM_COLUMNS * (NUM_OCTAVES + 1u) + 2u * SIZE);
+        FLOAT* pSurfaces = aNoise.data() + NUM_COLUMNS * NUM_OCTAVES;
+        FLOAT* pDensities = pSurfaces + NUM_COLUMNS;
+        FLOAT* pCaves = pDensities + SIZE;
+        sampleTerrain(m_heightNoise, uBeginX, uBeginZ, SIZE, SIZE, aNoise.data(), pSurfaces);
+
+        for (UINT z = 0u; z < SIZE; ++z)
+        {
+            const FLOAT* pRowSurfaces = pSurfaces + static_cast<size_t>(z) * SIZE;
+            FLOAT minSurface = FLT_MAX;
+            FLOAT maxSurface = 0.0f;
+            for (UINT x = 0u; x < SIZE; ++x)
+            {
+                minSurface = std::min(minSurface, pRowSurfaces[x] * static_cast<FLOAT>(uHeight));
+                maxSurface = std::max(maxSurface, pRowSurfaces[x] * static_cast<FLOAT>(uHeight));
+            }
+
+            const FLOAT sampleZ = static_cast<FLOAT>(uBeginZ + z);
+            for (UINT y = 0u; y < uHeight; ++y)
+            {
+                const FLOAT sampleY = static_cast<FLOAT>(y);
+                if (sampleY > maxSurface + DENSITY_FALLOFF)
+                {
+                    break;
+                }
+                if (y == 0u)
+                {
+                    occupancy.SetRow(y, z, ~0u);
+                    continue;
+                }
+
+                UINT uRow = ~0u;
+                if (sampleY >= minSurface - DENSITY_FALLOFF)
+                {
+                    uRow = 0u;
+                    m_densityNoise.GetGradient3dBatch(static_cast<FLOAT>(uBeginX), sampleY, sampleZ, 1.0f, SIZE, DENSITY_FREQUENCY, DENSITY_DEPTH, pDensities);
+                    for (UINT x = 0u; x < SIZE; ++x)
+                    {
+                        const FLOAT surface = pRowSurfaces[x] * static_cast<FLOAT>(uHeight);
+                        if ((surface - sampleY) / DENSITY_FALLOFF + pDensities[x] > 0.0f)
+                        {
+                            uRow |= 1u << x;
+                        }
+                    }
+                }
+
+                if (uRow != 0u)
+                {
+                    m_caveNoise.GetGradient3dBatch(static_cast<FLOAT>(uBeginX), sampleY, sampleZ, 1.0f, SIZE, CAVE_FREQUENCY, CAVE_DEPTH, pCaves);
+                    for (UINT x = 0u; x < SIZE; ++x)
+                    {
+                        if (pCaves[x] > CAVE_THRESHOLD)
+                        {
+                            uRow &= ~(1u << x);
+                        }
+                    }
+                }
+
+                occupancy.SetRow(y, z, uRow);
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainGenerator::sampleTerrain
+
+      Summary:  Sums NUM_OCTAVES layers of noise over a block of
+                columns, layer i sampled at 2^i times the column
+                coordinates and weighted by 2^-i, then shapes the sum
+                into a value in [0, 1.2^1.25). The lattice coordinates
+                are exact integers, so a column gets the same value in
+                any block
+
+      Args:     const PerlinNoise& noise
+                  Noise to sample
+                UINT uX, UINT uZ
+                  First column of the block
+                UINT uWidth
+                  Number of columns along the width
+                UINT uDepth
+                  Number of columns along the depth
+                FLOAT* pOctaves
+                  Scratch memory for the layers
+                FLOAT* pValues
+                  Receives the values, row by row along the depth
+
+      Modifies: [pOctaves, pValues].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TerrainGenerator::sampleTerrain(_In_ const PerlinNoise& noise, _In_ UINT uX, _In_ UINT uZ, _In_ UINT uWidth, _In_ UINT uDepth, _Out_writes_(static_cast<size_t>(uWidth) * uDepth * NUM_OCTAVES) FLOAT* pOctaves, _Out_writes_(static_cast<size_t>(uWidth) * uDepth) FLOAT* pValues)
+    {
+        const size_t uNumColumns = static_cast<size_t>(uWidth) * uDepth;
+        for (UINT i = 0u; i < NUM_OCTAVES; ++i)
+        {
+            const FLOAT frequency = static_cast<FLOAT>(1u << i);
+            noise.GetPerlin2dBatch(frequency * static_cast<FLOAT>(uX), frequency * static_cast<FLOAT>(uZ), frequency, uWidth, uDepth, FREQUENCY, DEPTH, pOctaves + uNumColumns * i);
+        }
+
+        for (size_t uColumnIdx = 0u; uColumnIdx < uNumColumns; ++uColumnIdx)
+        {
+            FLOAT value = 0.0f;
+            FLOAT frequencySum = 0.0f;
+            for (UINT i = 0u; i < NUM_OCTAVES; ++i)
+            {
+                const FLOAT frequency = static_cast<FLOAT>(1u << i);
+                frequencySum += 1.0f / frequency;
+                value += pOctaves[uNumColumns * i + uColumnIdx] / frequency;
+            }
+            value /= frequencySum;
+
+            pValues[uColumnIdx] = std::pow(value * 1.2f, 1.25f);
+        }
+    }
+}
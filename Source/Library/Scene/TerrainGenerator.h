@@ -0,0 +1,142 @@
+/*+===================================================================
+  File:      TERRAINGENERATOR.H
+
+  Summary:   TerrainGenerator header file contains declarations of
+             the TerrainGenerator class that generates the height,
+             moisture and block type grids of a voxel map, and the
+             occupancy of volumetric chunks, on a pool of threads,
+             without Direct3D.
+
+  Classes: TerrainGenerator
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Platform.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cfloat>
+#include <cmath>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "Scene/BiomeClassifier.h"
+#include "Scene/PerlinNoise.h"
+#include "Scene/VoxelOccupancy.h"
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    TerrainGenerator
+
+      Summary:  Generates the terrain of a voxel map from seeded noise.
+                A region of columns is split into TILE_SIZE x TILE_SIZE
+                tiles, or a region of chunks into chunks, that the
+                threads of the pool claim one at a time. Every column
+                and cell only depends on the seed and its own
+                coordinates, so the output is identical for any number
+                of threads, tile order or region that holds it.
+                Volumetric chunks add 3D gradient noise to the height
+                field near the surface, for overhangs, and carve caves
+                where a second gradient noise is high
+
+      Methods:  Generate
+                  Fills the grids of a region of columns
+                GenerateOccupancy
+                  Fills the occupancy of a region of chunks
+                SetBiomeRegions
+                  Replaces the regions of the biomes
+                GetSeed
+                  Returns the seed
+                GetFingerprint
+                  Returns a hash of everything the output depends on
+                GetNumThreads
+                  Returns the number of threads generating tiles
+                TerrainGenerator
+                  Constructor.
+                ~TerrainGenerator
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class TerrainGenerator final
+    {
+    public:
+        // Bump whenever the output changes for the same parameters
+        static constexpr const UINT VERSION = 1u;
+        static constexpr const UINT TILE_SIZE = 64u;
+        static constexpr const UINT NUM_OCTAVES = 4u;
+        static constexpr const FLOAT FREQUENCY = 0.1f;
+        static constexpr const UINT DEPTH = 4u;
+        static constexpr const UINT MOISTURE_SEED = 0x9E3779B9u;
+        static constexpr const FLOAT DENSITY_FREQUENCY = 0.05f;
+        static constexpr const UINT DENSITY_DEPTH = 3u;
+        static constexpr const FLOAT DENSITY_FALLOFF = 12.0f;
+        static constexpr const UINT DENSITY_SEED = 0x85EBCA6Bu;
+        static constexpr const FLOAT CAVE_FREQUENCY = 0.04f;
+        static constexpr const UINT CAVE_DEPTH = 2u;
+        static constexpr const FLOAT CAVE_THRESHOLD = 0.3f;
+        static constexpr const UINT CAVE_SEED = 0xC2B2AE35u;
+
+    public:
+        TerrainGenerator(_In_ UINT uSeed, _In_ UINT uNumThreads = 0u);
+        TerrainGenerator(const TerrainGenerator& other) = delete;
+        TerrainGenerator(TerrainGenerator&& other) = delete;
+        TerrainGenerator& operator=(const TerrainGenerator& other) = delete;
+        TerrainGenerator& operator=(TerrainGenerator&& other) = delete;
+        ~TerrainGenerator();
+
+        void Generate(_In_ UINT uX, _In_ UINT uZ, _In_ UINT uWidth, _In_ UINT uDepth, _Out_writes_opt_(static_cast<size_t>(uWidth) * uDepth) FLOAT* pHeights, _Out_writes_opt_(static_cast<size_t>(uWidth) * uDepth) FLOAT* pMoistures, _Out_writes_opt_(static_cast<size_t>(uWidth) * uDepth) eBlockType* pBlockTypes);
+        void GenerateOccupancy(_In_ UINT uChunkX, _In_ UINT uChunkZ, _In_ UINT uNumChunksX, _In_ UINT uNumChunksZ, _Inout_ VoxelOccupancy* pChunks);
+
+        void SetBiomeRegions(_In_reads_(uNumRegions) const BiomeRegion* pRegions, _In_ size_t uNumRegions);
+
+        UINT GetSeed() const;
+        UINT64 GetFingerprint() const;
+        UINT GetNumThreads() const;
+
+    private:
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+            Struct:   Job
+            Summary:  Region of columns and grids of a call to Generate,
+                      or region of chunks of a call to GenerateOccupancy
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct Job
+        {
+            UINT uX;
+            UINT uZ;
+            UINT uWidth;
+            UINT uDepth;
+            UINT uNumTilesX;
+            UINT uNumTiles;
+            FLOAT* pHeights;
+            FLOAT* pMoistures;
+            eBlockType* pBlockTypes;
+            VoxelOccupancy* pChunks;
+        };
+
+        void run(_In_ const Job& job);
+        void work();
+        void generateTiles(_In_ const Job& job);
+        void generateTile(_In_ const Job& job, _In_ UINT uTileIdx, _Inout_ std::vector<FLOAT>& aNoise) const;
+        void generateChunk(_In_ const Job& job, _In_ UINT uTileIdx, _Inout_ std::vector<FLOAT>& aNoise) const;
+        static void sampleTerrain(_In_ const PerlinNoise& noise, _In_ UINT uX, _In_ UINT uZ, _In_ UINT uWidth, _In_ UINT uDepth, _Out_writes_(static_cast<size_t>(uWidth) * uDepth * NUM_OCTAVES) FLOAT* pOctaves, _Out_writes_(static_cast<size_t>(uWidth) * uDepth) FLOAT* pValues);
+
+    private:
+        PerlinNoise m_heightNoise;
+        PerlinNoise m_moistureNoise;
+        PerlinNoise m_densityNoise;
+        PerlinNoise m_caveNoise;
+        BiomeClassifier m_biomeClassifier;
+        std::vector<std::thread> m_aThreads;
+        std::mutex m_mutex;
+        std::condition_variable m_jobCondition;
+        std::condition_variable m_doneCondition;
+        Job m_job;
+        UINT64 m_uJobId;
+        UINT m_uNumBusyThreads;
+        BOOL m_bStop;
+        std::atomic<UINT> m_uNextTileIdx;
+    };
+}
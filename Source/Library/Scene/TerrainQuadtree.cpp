@@ -0,0 +1,307 @@
+#include "Scene/TerrainQuadtree.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainQuadtree::TerrainQuadtree
+
+      Summary:  Constructor. Every column starts flat at height 0
+
+      Args:     UINT uWidth
+                  Number of columns along the width
+                UINT uDepth
+                  Number of columns along the depth
+                UINT uNumLods
+                  Number of levels of detail, up to MAX_NUM_LODS. The
+                  range of the coarsest level is how far the terrain
+                  is drawn
+                FLOAT lodDistance
+                  Range of the finest level, in columns. It is at least
+                  three patches, so a level has morphed completely
+                  where it meets the coarser level, before the coarser
+                  level starts to morph
+                FLOAT morphRatio
+                  Part of the range of a level where its vertices
+                  morph onto the coarser level, between 0 and 1
+
+      Modifies: [m_uWidth, m_uDepth, m_uNumLods, m_aRanges,
+                 m_aMorphStarts, m_aLevels].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    TerrainQuadtree::TerrainQuadtree(_In_ UINT uWidth, _In_ UINT uDepth, _In_ UINT uNumLods, _In_ FLOAT lodDistance, _In_ FLOAT morphRatio)
+        : m_uWidth(uWidth)
+        , m_uDepth(uDepth)
+        , m_uNumLods(std::clamp(uNumLods, 1u, MAX_NUM_LODS))
+        , m_aRanges()
+        , m_aMorphStarts()
+        , m_aLevels()
+    {
+        const FLOAT range = std::max(lodDistance, 3.0f * static_cast<FLOAT>(PATCH_SIZE));
+        const FLOAT ratio = std::clamp(morphRatio, 0.01f, 1.0f);
+        for (UINT uLod = 0u; uLod < m_uNumLods; ++uLod)
+        {
+            const FLOAT previousRange = uLod > 0u ? m_aRanges[uLod - 1u] : 0.0f;
+            m_aRanges[uLod] = range * static_cast<FLOAT>(1u << uLod);
+            m_aMorphStarts[uLod] = m_aRanges[uLod] - (m_aRanges[uLod] - previousRange) * ratio;
+            m_aLevels[uLod].assign(static_cast<size_t>(getNumNodesX(uLod)) * getNumNodesZ(uLod), TerrainNodeBounds{ .MinHeight = 0u, .MaxHeight = 0u });
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainQuadtree::SetHeights
+
+      Summary:  Updates the bounds of the leaves over a rectangle of
+                columns and of their ancestors. A leaf also spans the
+                first column of the next one, where their patches meet
+
+      Args:     UINT uX, UINT uZ
+                  First column of the rectangle
+                UINT uWidth, UINT uDepth
+                  Number of columns of the rectangle
+                const WORD* pHeights
+                  Heights of every column of the map, row by row
+
+      Modifies: [m_aLevels].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TerrainQuadtree::SetHeights(_In_ UINT uX, _In_ UINT uZ, _In_ UINT uWidth, _In_ UINT uDepth, _In_ const WORD* pHeights)
+    {
+        if (uX >= m_uWidth || uZ >= m_uDepth || uWidth == 0u || uDepth == 0u)
+        {
+            return;
+        }
+
+        const UINT uLastX = std::min(uX + uWidth, m_uWidth) - 1u;
+        const UINT uLastZ = std::min(uZ + uDepth, m_uDepth) - 1u;
+        UINT uMinNodeX = uX > 0u ? (uX - 1u) / PATCH_SIZE : 0u;
+        UINT uMinNodeZ = uZ > 0u ? (uZ - 1u) / PATCH_SIZE : 0u;
+        UINT uMaxNodeX = std::min(uLastX / PATCH_SIZE, getNumNodesX(0u) - 1u);
+        UINT uMaxNodeZ = std::min(uLastZ / PATCH_SIZE, getNumNodesZ(0u) - 1u);
+
+        for (UINT uNodeZ = uMinNodeZ; uNodeZ <= uMaxNodeZ; ++uNodeZ)
+        {
+            for (UINT uNodeX = uMinNodeX; uNodeX <= uMaxNodeX; ++uNodeX)
+            {
+                WORD minHeight = USHRT_MAX;
+                WORD maxHeight = 0u;
+                const UINT uEndX = std::min((uNodeX + 1u) * PATCH_SIZE, m_uWidth - 1u);
+                const UINT uEndZ = std::min((uNodeZ + 1u) * PATCH_SIZE, m_uDepth - 1u);
+                for (UINT z = uNodeZ * PATCH_SIZE; z <= uEndZ; ++z)
+                {
+                    const WORD* pRow = pHeights + static_cast<size_t>(z) * m_uWidth;
+                    for (UINT x = uNodeX * PATCH_SIZE; x <= uEndX; ++x)
+                    {
+                        minHeight = std::min(minHeight, pRow[x]);
+                        maxHeight = std::max(maxHeight, pRow[x]);
+                    }
+                }
+                m_aLevels[0][static_cast<size_t>(uNodeZ) * getNumNodesX(0u) + uNodeX] = TerrainNodeBounds{ .MinHeight = minHeight, .MaxHeight = maxHeight };
+            }
+        }
+
+        for (UINT uLod = 1u; uLod < m_uNumLods; ++uLod)
+        {
+            uMinNodeX >>= 1u;
+            uMinNodeZ >>= 1u;
+            uMaxNodeX >>= 1u;
+            uMaxNodeZ >>= 1u;
+            const UINT uNumChildrenX = getNumNodesX(uLod - 1u);
+            const UINT uNumChildrenZ = getNumNodesZ(uLod - 1u);
+            for (UINT uNodeZ = uMinNodeZ; uNodeZ <= uMaxNodeZ; ++uNodeZ)
+            {
+                for (UINT uNodeX = uMinNodeX; uNodeX <= uMaxNodeX; ++uNodeX)
+                {
+                    TerrainNodeBounds bounds = { .MinHeight = USHRT_MAX, .MaxHeight = 0u };
+                    for (UINT uChildZ = uNodeZ * 2u; uChildZ < std::min(uNodeZ * 2u + 2u, uNumChildrenZ); ++uChildZ)
+                    {
+                        for (UINT uChildX = uNodeX * 2u; uChildX < std::min(uNodeX * 2u + 2u, uNumChildrenX); ++uChildX)
+                        {
+                            const TerrainNodeBounds& child = m_aLevels[uLod - 1u][static_cast<size_t>(uChildZ) * uNumChildrenX + uChildX];
+                            bounds.MinHeight = std::min(bounds.MinHeight, child.MinHeight);
+                            bounds.MaxHeight = std::max(bounds.MaxHeight, child.MaxHeight);
+                        }
+                    }
+                    m_aLevels[uLod][static_cast<size_t>(uNodeZ) * getNumNodesX(uLod) + uNodeX] = bounds;
+                }
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainQuadtree::Select
+
+      Summary:  Selects the patches to draw from a position. The nodes
+                of the top level beyond its range are not drawn
+
+      Args:     FLOAT x, FLOAT y, FLOAT z
+                  Position in columns and cubes from the corner of the
+                  map
+                std::vector<TerrainPatch>& aPatches
+                  Receives the nodes drawn whole, with PATCH_SIZE
+                  columns between their vertices
+                std::vector<TerrainPatch>& aQuarterPatches
+                  Receives the children drawn as a quarter of their
+                  parent, with PATCH_SIZE / 2 columns between their
+                  vertices
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TerrainQuadtree::Select(_In_ FLOAT x, _In_ FLOAT y, _In_ FLOAT z, _Out_ std::vector<TerrainPatch>& aPatches, _Out_ std::vector<TerrainPatch>& aQuarterPatches) const
+    {
+        aPatches.clear();
+        aQuarterPatches.clear();
+
+        const UINT uTopLod = m_uNumLods - 1u;
+        for (UINT uNodeZ = 0u; uNodeZ < getNumNodesZ(uTopLod); ++uNodeZ)
+        {
+            for (UINT uNodeX = 0u; uNodeX < getNumNodesX(uTopLod); ++uNodeX)
+            {
+                selectNode(uTopLod, uNodeX, uNodeZ, x, y, z, aPatches, aQuarterPatches);
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainQuadtree::GetMorphRange
+
+      Summary:  Returns the distances a level morphs between. Its
+                vertices are on its own grid up to start and on the
+                grid of the coarser level from end
+
+      Args:     UINT uLod
+                  Level of detail
+                FLOAT& start
+                  Receives the distance the morph starts at, in columns
+                FLOAT& end
+                  Receives the range of the level, in columns
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TerrainQuadtree::GetMorphRange(_In_ UINT uLod, _Out_ FLOAT& start, _Out_ FLOAT& end) const
+    {
+        uLod = std::min(uLod, m_uNumLods - 1u);
+        start = m_aMorphStarts[uLod];
+        end = m_aRanges[uLod];
+    }
+
+    UINT TerrainQuadtree::GetNumLods() const
+    {
+        return m_uNumLods;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainQuadtree::GetMaxNumPatches
+
+      Summary:  Returns the most patches Select returns, whole and
+                quarters. A patch of level L covers a node of level
+                L - 1 that reaches within the range of level L, and the
+                range doubles with the size of the nodes, so each level
+                adds the same number of nodes whatever the size of
+                the map
+
+      Returns:  UINT
+                  Bound on the number of patches
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT TerrainQuadtree::GetMaxNumPatches() const
+    {
+        UINT uMaxNumPatches = 0u;
+        for (UINT uLod = 0u; uLod < m_uNumLods; ++uLod)
+        {
+            const UINT uNodeLod = uLod > 0u ? uLod - 1u : 0u;
+            const FLOAT nodeSize = static_cast<FLOAT>(PATCH_SIZE << uNodeLod);
+            const UINT uSpan = static_cast<UINT>(std::ceil(2.0f * m_aRanges[uLod] / nodeSize)) + 1u;
+            uMaxNumPatches += std::min(uSpan, getNumNodesX(uNodeLod)) * std::min(uSpan, getNumNodesZ(uNodeLod));
+        }
+
+        return uMaxNumPatches;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainQuadtree::selectNode
+
+      Summary:  Selects the patches of a node. A node within the range
+                of the finer level is split, and the children that
+                select nothing are drawn as quarters of it
+
+      Args:     UINT uLod
+                  Level of the node
+                UINT uNodeX, UINT uNodeZ
+                  Node of the level
+                FLOAT x, FLOAT y, FLOAT z
+                  Position in columns and cubes
+                std::vector<TerrainPatch>& aPatches
+                  Receives the nodes drawn whole
+                std::vector<TerrainPatch>& aQuarterPatches
+                  Receives the children drawn as quarters
+
+      Returns:  BOOL
+                  FALSE when the node is beyond the range of its level
+                  and its parent draws it instead
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL TerrainQuadtree::selectNode(_In_ UINT uLod, _In_ UINT uNodeX, _In_ UINT uNodeZ, _In_ FLOAT x, _In_ FLOAT y, _In_ FLOAT z, _Inout_ std::vector<TerrainPatch>& aPatches, _Inout_ std::vector<TerrainPatch>& aQuarterPatches) const
+    {
+        if (!isNodeInRange(uLod, uNodeX, uNodeZ, x, y, z, m_aRanges[uLod]))
+        {
+            return FALSE;
+        }
+
+        const UINT uSize = PATCH_SIZE << uLod;
+        if (uLod == 0u || !isNodeInRange(uLod, uNodeX, uNodeZ, x, y, z, m_aRanges[uLod - 1u]))
+        {
+            aPatches.push_back(TerrainPatch{ .X = uNodeX * uSize, .Z = uNodeZ * uSize, .Size = uSize, .Lod = uLod });
+            return TRUE;
+        }
+
+        const UINT uChildSize = uSize >> 1u;
+        for (UINT uChildZ = uNodeZ * 2u; uChildZ < std::min(uNodeZ * 2u + 2u, getNumNodesZ(uLod - 1u)); ++uChildZ)
+        {
+            for (UINT uChildX = uNodeX * 2u; uChildX < std::min(uNodeX * 2u + 2u, getNumNodesX(uLod - 1u)); ++uChildX)
+            {
+                if (!selectNode(uLod - 1u, uChildX, uChildZ, x, y, z, aPatches, aQuarterPatches))
+                {
+                    aQuarterPatches.push_back(TerrainPatch{ .X = uChildX * uChildSize, .Z = uChildZ * uChildSize, .Size = uChildSize, .Lod = uLod });
+                }
+            }
+        }
+
+        return TRUE;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainQuadtree::isNodeInRange
+
+      Summary:  Returns whether the box of a node, from its lowest to
+                its highest column, is within a distance of a position
+
+      Args:     UINT uLod
+                  Level of the node
+                UINT uNodeX, UINT uNodeZ
+                  Node of the level
+                FLOAT x, FLOAT y, FLOAT z
+                  Position in columns and cubes
+                FLOAT range
+                  Distance in columns
+
+      Returns:  BOOL
+                  TRUE when the box intersects the sphere
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL TerrainQuadtree::isNodeInRange(_In_ UINT uLod, _In_ UINT uNodeX, _In_ UINT uNodeZ, _In_ FLOAT x, _In_ FLOAT y, _In_ FLOAT z, _In_ FLOAT range) const
+    {
+        const UINT uSize = PATCH_SIZE << uLod;
+        const TerrainNodeBounds& bounds = m_aLevels[uLod][static_cast<size_t>(uNodeZ) * getNumNodesX(uLod) + uNodeX];
+        const FLOAT minX = static_cast<FLOAT>(uNodeX * uSize);
+        const FLOAT minZ = static_cast<FLOAT>(uNodeZ * uSize);
+        const FLOAT maxX = static_cast<FLOAT>(std::min((uNodeX + 1u) * uSize, m_uWidth - 1u));
+        const FLOAT maxZ = static_cast<FLOAT>(std::min((uNodeZ + 1u) * uSize, m_uDepth - 1u));
+
+        const FLOAT dx = std::max({ minX - x, 0.0f, x - maxX });
+        const FLOAT dy = std::max({ static_cast<FLOAT>(bounds.MinHeight) - y, 0.0f, y - static_cast<FLOAT>(bounds.MaxHeight) });
+        const FLOAT dz = std::max({ minZ - z, 0.0f, z - maxZ });
+
+        return dx * dx + dy * dy + dz * dz <= range * range;
+    }
+
+    UINT TerrainQuadtree::getNumNodesX(_In_ UINT uLod) const
+    {
+        return (m_uWidth + (PATCH_SIZE << uLod) - 1u) / (PATCH_SIZE << uLod);
+    }
+
+    UINT TerrainQuadtree::getNumNodesZ(_In_ UINT uLod) const
+    {
+        return (m_uDepth + (PATCH_SIZE << uLod) - 1u) / (PATCH_SIZE << uLod);
+    }
+}
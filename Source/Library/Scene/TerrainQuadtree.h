@@ -0,0 +1,114 @@
+/*+===================================================================
+  File:      TERRAINQUADTREE.H
+
+  Summary:   TerrainQuadtree header file contains declarations of the
+             TerrainQuadtree class that selects the grid patches of a
+             heightfield to draw around the camera, without Direct3D.
+
+  Classes: TerrainQuadtree
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Platform.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+        Struct:   TerrainPatch
+        Summary:  Square of Size x Size columns from column X, Z drawn
+                  with a grid of 2^Lod columns between its vertices
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct TerrainPatch
+    {
+        UINT X;
+        UINT Z;
+        UINT Size;
+        UINT Lod;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+        Struct:   TerrainNodeBounds
+        Summary:  Lowest and highest column under a node of the quadtree
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct TerrainNodeBounds
+    {
+        WORD MinHeight;
+        WORD MaxHeight;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    TerrainQuadtree
+
+      Summary:  Continuous distance-dependent level of detail (CDLOD)
+                over the column heights of a map. A node of level L
+                spans PATCH_SIZE << L columns and keeps the bounds of
+                the columns under it, the top level is a grid of nodes
+                over the map. Level L is drawn up to the range
+                lodDistance * 2^L from the camera, so a node within the
+                range of the finer level is split into its children,
+                and the children beyond it are drawn as quarters of
+                their parent. Every patch has PATCH_SIZE columns
+                between its vertices, a quarter PATCH_SIZE / 2, so the
+                number of patches depends on the ranges and not on the
+                size of the map. Within the last part of its range, a
+                level morphs its vertices onto the grid of the coarser
+                level, so neighboring levels meet without cracks or
+                popping. Positions are in columns and heights in cubes
+
+      Methods:  SetHeights
+                  Updates the bounds of the nodes over some columns
+                Select
+                  Selects the patches to draw around a position
+                GetMorphRange
+                  Returns the distances a level morphs between
+                GetNumLods
+                  Returns the number of levels of detail
+                GetMaxNumPatches
+                  Returns the most patches Select returns
+                TerrainQuadtree
+                  Constructor.
+                ~TerrainQuadtree
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class TerrainQuadtree final
+    {
+    public:
+        static constexpr const UINT PATCH_SIZE = 32u;
+        static constexpr const UINT MAX_NUM_LODS = 12u;
+
+    public:
+        TerrainQuadtree(_In_ UINT uWidth, _In_ UINT uDepth, _In_ UINT uNumLods, _In_ FLOAT lodDistance, _In_ FLOAT morphRatio);
+        TerrainQuadtree(const TerrainQuadtree& other) = delete;
+        TerrainQuadtree(TerrainQuadtree&& other) = delete;
+        TerrainQuadtree& operator=(const TerrainQuadtree& other) = delete;
+        TerrainQuadtree& operator=(TerrainQuadtree&& other) = delete;
+        ~TerrainQuadtree() = default;
+
+        void SetHeights(_In_ UINT uX, _In_ UINT uZ, _In_ UINT uWidth, _In_ UINT uDepth, _In_ const WORD* pHeights);
+        void Select(_In_ FLOAT x, _In_ FLOAT y, _In_ FLOAT z, _Out_ std::vector<TerrainPatch>& aPatches, _Out_ std::vector<TerrainPatch>& aQuarterPatches) const;
+
+        void GetMorphRange(_In_ UINT uLod, _Out_ FLOAT& start, _Out_ FLOAT& end) const;
+        UINT GetNumLods() const;
+        UINT GetMaxNumPatches() const;
+
+    private:
+        BOOL selectNode(_In_ UINT uLod, _In_ UINT uNodeX, _In_ UINT uNodeZ, _In_ FLOAT x, _In_ FLOAT y, _In_ FLOAT z, _Inout_ std::vector<TerrainPatch>& aPatches, _Inout_ std::vector<TerrainPatch>& aQuarterPatches) const;
+        BOOL isNodeInRange(_In_ UINT uLod, _In_ UINT uNodeX, _In_ UINT uNodeZ, _In_ FLOAT x, _In_ FLOAT y, _In_ FLOAT z, _In_ FLOAT range) const;
+        UINT getNumNodesX(_In_ UINT uLod) const;
+        UINT getNumNodesZ(_In_ UINT uLod) const;
+
+    private:
+        UINT m_uWidth;
+        UINT m_uDepth;
+        UINT m_uNumLods;
+        FLOAT m_aRanges[MAX_NUM_LODS];
+        FLOAT m_aMorphStarts[MAX_NUM_LODS];
+        std::vector<TerrainNodeBounds> m_aLevels[MAX_NUM_LODS];
+    };
+}
@@ -4,7 +4,9 @@
 
 namespace library
 {
-
+    ComPtr<ID3D11Buffer> Voxel::s_vertexBuffer;
+    ComPtr<ID3D11Buffer> Voxel::s_indexBuffer;
+    ComPtr<ID3D11Buffer> Voxel::s_normalBuffer;
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Voxel::Voxel
@@ -67,10 +69,14 @@ namespace library
             return hr;
         }
 
-        hr = initializeInstance(pDevice);
-        if (FAILED(hr))
+        // Voxels of a voxel map draw the instances of the scene chunks
+        if (!m_aInstanceData.empty())
         {
-            return hr;
+            hr = initializeInstance(pDevice);
+            if (FAILED(hr))
+            {
+                return hr;
+            }
         }
 
         if (HasTexture() > 0)
@@ -162,4 +168,70 @@ namespace library
         return INDICES;
     }
 
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Voxel::initialize
+
+      Summary:  Creates the buffers of the cube on the first call and
+                shares them with every later voxel, which only gets
+                its own constant buffer
+
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the buffers
+                ID3D11DeviceContext* pImmediateContext
+                  The Direct3D context to set buffers
+
+      Modifies: [m_vertexBuffer, m_indexBuffer, m_normalBuffer,
+                 m_constantBuffer, s_vertexBuffer, s_indexBuffer,
+                 s_normalBuffer].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Voxel::initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext)
+    {
+        if (!s_vertexBuffer)
+        {
+            HRESULT hr = InstancedRenderable::initialize(pDevice, pImmediateContext);
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+
+            s_vertexBuffer = m_vertexBuffer;
+            s_indexBuffer = m_indexBuffer;
+            s_normalBuffer = m_normalBuffer;
+
+            return S_OK;
+        }
+
+        m_vertexBuffer = s_vertexBuffer;
+        m_indexBuffer = s_indexBuffer;
+        m_normalBuffer = s_normalBuffer;
+
+        D3D11_BUFFER_DESC cBufferDesc =
+        {
+            .ByteWidth = sizeof(CBChangesEveryFrame),
+            .Usage = D3D11_USAGE_DEFAULT,
+            .BindFlags = D3D11_BIND_CONSTANT_BUFFER,
+            .CPUAccessFlags = 0,
+            .MiscFlags = 0,
+            .StructureByteStride = 0
+        };
+
+        CBChangesEveryFrame cb =
+        {
+            .World = XMMatrixTranspose(m_world),
+            .OutputColor = m_outputColor
+        };
+
+        D3D11_SUBRESOURCE_DATA cData =
+        {
+            .pSysMem = &cb,
+            .SysMemPitch = 0,
+            .SysMemSlicePitch = 0
+        };
+
+        return pDevice->CreateBuffer(&cBufferDesc, &cData, m_constantBuffer.ReleaseAndGetAddressOf());
+    }
 }
\ No newline at end of file
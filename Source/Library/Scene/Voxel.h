@@ -21,7 +21,9 @@ namespace library
     /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
       Class:    Voxel
 
-      Summary:  Base class for renderable 3d cube object
+      Summary:  Base class for renderable 3d cube object. Every voxel
+                shares the vertex, normal and index buffers of a
+                single cube
 
       Methods:  Voxel
                   Constructor.
@@ -48,6 +50,11 @@ namespace library
     protected:
         const SimpleVertex* getVertices() const override;
         const WORD* getIndices() const override;
+        HRESULT initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext) override;
+
+        static ComPtr<ID3D11Buffer> s_vertexBuffer;
+        static ComPtr<ID3D11Buffer> s_indexBuffer;
+        static ComPtr<ID3D11Buffer> s_normalBuffer;
 
         static constexpr const SimpleVertex VERTICES[] =
         {
@@ -0,0 +1,416 @@
+#include "Scene/VoxelChunk.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelChunk::VoxelChunk
+
+      Summary:  Constructor
+
+      Args:     UINT uChunkX
+                  Chunk column along the width of the map
+                UINT uChunkZ
+                  Chunk row along the depth of the map
+
+      Modifies: [m_aLevels, m_uLod, m_uChunkX, m_uChunkZ].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    VoxelChunk::VoxelChunk(_In_ UINT uChunkX, _In_ UINT uChunkZ)
+        : m_aLevels()
+        , m_uLod(0u)
+        , m_uChunkX(uChunkX)
+        , m_uChunkZ(uChunkZ)
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelChunk::Initialize
+
+      Summary:  Creates the mesh buffers of each level of detail of
+                the chunk
+
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the buffers
+
+      Modifies: [m_aLevels].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT VoxelChunk::Initialize(_In_ ID3D11Device* pDevice)
+    {
+        HRESULT hr = S_OK;
+
+        for (VoxelChunkLevel& level : m_aLevels)
+        {
+            if (!level.aMeshIndices.empty())
+            {
+                D3D11_BUFFER_DESC vertexBuffDesc =
+                {
+                    .ByteWidth = static_cast<UINT>(sizeof(SimpleVertex) * level.aMeshVertices.size()),
+                    .Usage = D3D11_USAGE_IMMUTABLE,
+                    .BindFlags = D3D11_BIND_VERTEX_BUFFER,
+                    .CPUAccessFlags = 0,
+                    .MiscFlags = 0,
+                    .StructureByteStride = 0
+                };
+
+                D3D11_SUBRESOURCE_DATA vertexData =
+                {
+                    .pSysMem = level.aMeshVertices.data(),
+                    .SysMemPitch = 0,
+                    .SysMemSlicePitch = 0
+                };
+
+                hr = pDevice->CreateBuffer(&vertexBuffDesc, &vertexData, level.meshVertexBuffer.ReleaseAndGetAddressOf());
+                if (FAILED(hr))
+                {
+                    return hr;
+                }
+
+                D3D11_BUFFER_DESC indexBuffDesc =
+                {
+                    .ByteWidth = static_cast<UINT>(sizeof(WORD) * level.aMeshIndices.size()),
+                    .Usage = D3D11_USAGE_IMMUTABLE,
+                    .BindFlags = D3D11_BIND_INDEX_BUFFER,
+                    .CPUAccessFlags = 0,
+                    .MiscFlags = 0,
+                    .StructureByteStride = 0
+                };
+
+                D3D11_SUBRESOURCE_DATA indexData =
+                {
+                    .pSysMem = level.aMeshIndices.data(),
+                    .SysMemPitch = 0,
+                    .SysMemSlicePitch = 0
+                };
+
+                hr = pDevice->CreateBuffer(&indexBuffDesc, &indexData, level.meshIndexBuffer.ReleaseAndGetAddressOf());
+                if (FAILED(hr))
+                {
+                    return hr;
+                }
+            }
+        }
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelChunk::SetInstanceData
+
+      Summary:  Sets the instances of a level of detail of the chunk
+
+      Args:     UINT uLod
+                  Level of detail
+                std::vector<InstanceData>&& aInstanceData
+                  Instances of the exposed cubes
+                const BoundingBox& boundingBox
+                  World space bounds of the instances
+
+      Modifies: [m_aLevels].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelChunk::SetInstanceData(_In_ UINT uLod, _In_ std::vector<InstanceData>&& aInstanceData, _In_ const BoundingBox& boundingBox)
+    {
+        if (uLod >= NUM_LODS)
+        {
+            return;
+        }
+
+        m_aLevels[uLod].aInstanceData = std::move(aInstanceData);
+        m_aLevels[uLod].boundingBox = boundingBox;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelChunk::SetMeshData
+
+      Summary:  Sets the greedy mesh of a level of detail of the chunk
+
+      Args:     UINT uLod
+                  Level of detail
+                std::vector<SimpleVertex>&& aVertices
+                  World space vertices of the mesh
+                std::vector<WORD>&& aIndices
+                  Indices grouped by block type
+                std::vector<VoxelMeshRange>&& aRanges
+                  Range of the indices of each voxel
+                const BoundingBox& boundingBox
+                  World space bounds of the mesh
+
+      Modifies: [m_aLevels].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelChunk::SetMeshData(_In_ UINT uLod, _In_ std::vector<SimpleVertex>&& aVertices, _In_ std::vector<WORD>&& aIndices, _In_ std::vector<VoxelMeshRange>&& aRanges, _In_ const BoundingBox& boundingBox)
+    {
+        if (uLod >= NUM_LODS)
+        {
+            return;
+        }
+
+        m_aLevels[uLod].aMeshVertices = std::move(aVertices);
+        m_aLevels[uLod].aMeshIndices = std::move(aIndices);
+        m_aLevels[uLod].aMeshRanges = std::move(aRanges);
+        m_aLevels[uLod].boundingBox = boundingBox;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelChunk::UpdateLod
+
+      Summary:  Selects the level of detail from the distance between
+                the camera and the full detail bounds of the chunk.
+                Level k starts at LOD_DISTANCE * 2^(k - 1), and a
+                level only changes once the distance is past its
+                threshold by LOD_HYSTERESIS, so a camera moving along
+                a threshold does not make the chunk pop back and forth
+
+      Args:     FXMVECTOR eye
+                  World space position of the camera
+
+      Modifies: [m_uLod].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelChunk::UpdateLod(_In_ FXMVECTOR eye)
+    {
+        const BoundingBox& boundingBox = m_aLevels[0].boundingBox;
+        XMVECTOR offset = XMVectorSubtract(XMVectorAbs(XMVectorSubtract(eye, XMLoadFloat3(&boundingBox.Center))), XMLoadFloat3(&boundingBox.Extents));
+        FLOAT distance = XMVectorGetX(XMVector3Length(XMVectorMax(offset, XMVectorZero())));
+
+        while (m_uLod + 1u < NUM_LODS && distance > getLodDistance(m_uLod + 1u) * (1.0f + LOD_HYSTERESIS))
+        {
+            ++m_uLod;
+        }
+        while (m_uLod > 0u && distance < getLodDistance(m_uLod) * (1.0f - LOD_HYSTERESIS))
+        {
+            --m_uLod;
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelChunk::GetLod
+
+      Summary:  Returns the current level of detail
+
+      Returns:  UINT
+                  Level of detail, 0 is full detail
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT VoxelChunk::GetLod() const
+    {
+        return m_uLod;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelChunk::GetInstanceData
+
+      Summary:  Returns the instances of the current level
+
+      Returns:  const std::vector<InstanceData>&
+                  Instances of the exposed cubes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const std::vector<InstanceData>& VoxelChunk::GetInstanceData() const
+    {
+        return m_aLevels[m_uLod].aInstanceData;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelChunk::GetNumInstances
+
+      Summary:  Returns the number of instances of the current level
+
+      Returns:  UINT
+                  Number of instances
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT VoxelChunk::GetNumInstances() const
+    {
+        return static_cast<UINT>(m_aLevels[m_uLod].aInstanceData.size());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelChunk::GetMaxNumInstances
+
+      Summary:  Returns the number of instances of the level of detail
+                with the most instances, which bounds the instances
+                the chunk can add to the scene
+
+      Returns:  UINT
+                  Number of instances
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT VoxelChunk::GetMaxNumInstances() const
+    {
+        size_t uMaxNumInstances = 0u;
+        for (const VoxelChunkLevel& level : m_aLevels)
+        {
+            uMaxNumInstances = std::max(uMaxNumInstances, level.aInstanceData.size());
+        }
+
+        return static_cast<UINT>(uMaxNumInstances);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelChunk::IsEmpty
+
+      Summary:  Returns whether the chunk has neither an instance nor
+                a mesh index at any level of detail
+
+      Returns:  BOOL
+                  TRUE if the chunk draws nothing
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL VoxelChunk::IsEmpty() const
+    {
+        for (const VoxelChunkLevel& level : m_aLevels)
+        {
+            if (!level.aInstanceData.empty() || !level.aMeshIndices.empty())
+            {
+                return FALSE;
+            }
+        }
+
+        return TRUE;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelChunk::GetMeshVertexBuffer
+
+      Summary:  Returns the vertex buffer of the greedy mesh of the
+                current level
+
+      Returns:  ComPtr<ID3D11Buffer>&
+                  Vertex buffer
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ComPtr<ID3D11Buffer>& VoxelChunk::GetMeshVertexBuffer()
+    {
+        return m_aLevels[m_uLod].meshVertexBuffer;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelChunk::GetMeshIndexBuffer
+
+      Summary:  Returns the index buffer of the greedy mesh of the
+                current level
+
+      Returns:  ComPtr<ID3D11Buffer>&
+                  Index buffer of WORD indices
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ComPtr<ID3D11Buffer>& VoxelChunk::GetMeshIndexBuffer()
+    {
+        return m_aLevels[m_uLod].meshIndexBuffer;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelChunk::GetNumMeshIndices
+
+      Summary:  Returns the number of indices of the greedy mesh of
+                the current level
+
+      Returns:  UINT
+                  Number of indices
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT VoxelChunk::GetNumMeshIndices() const
+    {
+        return static_cast<UINT>(m_aLevels[m_uLod].aMeshIndices.size());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelChunk::GetMeshVertices
+
+      Summary:  Returns the vertices of the greedy mesh of the current
+                level, kept after the vertex buffer is created, e.g.
+                to rasterize the mesh as an occluder
+
+      Returns:  const std::vector<SimpleVertex>&
+                  Vertices in the space of the voxel map
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const std::vector<SimpleVertex>& VoxelChunk::GetMeshVertices() const
+    {
+        return m_aLevels[m_uLod].aMeshVertices;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelChunk::GetMeshIndices
+
+      Summary:  Returns the indices of the greedy mesh of the current
+                level
+
+      Returns:  const std::vector<WORD>&
+                  3 indices per triangle
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const std::vector<WORD>& VoxelChunk::GetMeshIndices() const
+    {
+        return m_aLevels[m_uLod].aMeshIndices;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelChunk::GetMeshRange
+
+      Summary:  Returns the indices of a voxel in the greedy mesh of
+                the current level
+
+      Args:     size_t uVoxelIdx
+                  Index of the voxel in the scene
+
+      Returns:  VoxelMeshRange
+                  Range of the indices, empty if the chunk has none
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    VoxelMeshRange VoxelChunk::GetMeshRange(_In_ size_t uVoxelIdx) const
+    {
+        const std::vector<VoxelMeshRange>& aMeshRanges = m_aLevels[m_uLod].aMeshRanges;
+        if (uVoxelIdx >= aMeshRanges.size())
+        {
+            return VoxelMeshRange{ .uStartIndex = 0u, .uNumIndices = 0u };
+        }
+
+        return aMeshRanges[uVoxelIdx];
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelChunk::GetBoundingBox
+
+      Summary:  Returns the world space bounding box of the current
+                level
+
+      Returns:  const BoundingBox&
+                  Bounding box of the instances or of the mesh
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const BoundingBox& VoxelChunk::GetBoundingBox() const
+    {
+        return m_aLevels[m_uLod].boundingBox;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelChunk::GetChunkX
+
+      Summary:  Returns the chunk column along the width of the map
+
+      Returns:  UINT
+                  Chunk column
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT VoxelChunk::GetChunkX() const
+    {
+        return m_uChunkX;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelChunk::GetChunkZ
+
+      Summary:  Returns the chunk row along the depth of the map
+
+      Returns:  UINT
+                  Chunk row
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT VoxelChunk::GetChunkZ() const
+    {
+        return m_uChunkZ;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelChunk::getLodDistance
+
+      Summary:  Returns the distance at which a level of detail starts
+
+      Args:     UINT uLod
+                  Level of detail, at least 1
+
+      Returns:  FLOAT
+                  Distance from the camera to the chunk
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    FLOAT VoxelChunk::getLodDistance(_In_ UINT uLod)
+    {
+        return LOD_DISTANCE * static_cast<FLOAT>(1u << (uLod - 1u));
+    }
+}
@@ -0,0 +1,142 @@
+/*+===================================================================
+  File:      VOXELCHUNK.H
+
+  Summary:   VoxelChunk header file contains declarations of the
+             VoxelChunk class that holds the cube instances of a
+             square group of voxel map columns.
+
+  Classes: VoxelChunk
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include <algorithm>
+#include <DirectXCollision.h>
+
+#include "Renderer/DataTypes.h"
+#include "Scene/GreedyMesher.h"
+#include "Scene/VoxelOccupancy.h"
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+        Struct:   VoxelChunkLevel
+        Summary:  Instances or greedy mesh of a chunk at one level of
+                  detail, with their buffers and world space bounds
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct VoxelChunkLevel
+    {
+        std::vector<InstanceData> aInstanceData;
+        ComPtr<ID3D11Buffer> meshVertexBuffer;
+        ComPtr<ID3D11Buffer> meshIndexBuffer;
+        std::vector<SimpleVertex> aMeshVertices;
+        std::vector<WORD> aMeshIndices;
+        std::vector<VoxelMeshRange> aMeshRanges;
+        BoundingBox boundingBox;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    VoxelChunk
+
+      Summary:  SIZE x SIZE columns of a voxel map with their cube
+                instances, which the scene gathers into one instance
+                buffer, or their own static mesh in greedy mesh mode.
+                The indices are grouped by block type so each voxel
+                draws its range of the mesh. Level of detail k merges
+                2^k x 2^k x 2^k cubes into one, and the getters return
+                the data of the current level
+
+      Methods:  Initialize
+                  Creates the mesh buffers of every level of detail
+                SetInstanceData
+                  Sets the instances and bounding box
+                SetMeshData
+                  Sets the mesh, ranges and bounding box
+                UpdateLod
+                  Selects the level of detail from the camera
+                GetLod
+                  Returns the current level of detail
+                GetInstanceData
+                  Returns the instances
+                GetNumInstances
+                  Returns the number of instances
+                GetMaxNumInstances
+                  Returns the instances of the largest level
+                IsEmpty
+                  Returns whether no level has a cube
+                GetMeshVertexBuffer
+                  Returns the vertex buffer of the mesh
+                GetMeshIndexBuffer
+                  Returns the index buffer of the mesh
+                GetNumMeshIndices
+                  Returns the number of indices of the mesh
+                GetMeshVertices
+                  Returns the vertices of the mesh
+                GetMeshIndices
+                  Returns the indices of the mesh
+                GetMeshRange
+                  Returns the indices of a voxel
+                GetBoundingBox
+                  Returns the world space bounding box
+                GetChunkX
+                  Returns the chunk column along the width
+                GetChunkZ
+                  Returns the chunk row along the depth
+                VoxelChunk
+                  Constructor.
+                ~VoxelChunk
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class VoxelChunk final
+    {
+    public:
+        static constexpr const UINT SIZE = 32u;
+        static constexpr const UINT NUM_LODS = 4u;
+        static constexpr const FLOAT LOD_DISTANCE = 128.0f;
+        static constexpr const FLOAT LOD_HYSTERESIS = 0.1f;
+
+        static_assert((SIZE >> (NUM_LODS - 1u)) << (NUM_LODS - 1u) == SIZE, "Chunks must split evenly at every level of detail");
+        static_assert(SIZE == VoxelOccupancy::SIZE, "Volumetric chunks must cover the same columns as the chunks of the scene");
+
+    public:
+        VoxelChunk(_In_ UINT uChunkX, _In_ UINT uChunkZ);
+        VoxelChunk(const VoxelChunk& other) = delete;
+        VoxelChunk(VoxelChunk&& other) = delete;
+        VoxelChunk& operator=(const VoxelChunk& other) = delete;
+        VoxelChunk& operator=(VoxelChunk&& other) = delete;
+        ~VoxelChunk() = default;
+
+        HRESULT Initialize(_In_ ID3D11Device* pDevice);
+
+        void SetInstanceData(_In_ UINT uLod, _In_ std::vector<InstanceData>&& aInstanceData, _In_ const BoundingBox& boundingBox);
+        void SetMeshData(_In_ UINT uLod, _In_ std::vector<SimpleVertex>&& aVertices, _In_ std::vector<WORD>&& aIndices, _In_ std::vector<VoxelMeshRange>&& aRanges, _In_ const BoundingBox& boundingBox);
+        void UpdateLod(_In_ FXMVECTOR eye);
+        UINT GetLod() const;
+
+        const std::vector<InstanceData>& GetInstanceData() const;
+        UINT GetNumInstances() const;
+        UINT GetMaxNumInstances() const;
+        BOOL IsEmpty() const;
+        ComPtr<ID3D11Buffer>& GetMeshVertexBuffer();
+        ComPtr<ID3D11Buffer>& GetMeshIndexBuffer();
+        UINT GetNumMeshIndices() const;
+        const std::vector<SimpleVertex>& GetMeshVertices() const;
+        const std::vector<WORD>& GetMeshIndices() const;
+        VoxelMeshRange GetMeshRange(_In_ size_t uVoxelIdx) const;
+        const BoundingBox& GetBoundingBox() const;
+        UINT GetChunkX() const;
+        UINT GetChunkZ() const;
+
+    private:
+        static FLOAT getLodDistance(_In_ UINT uLod);
+
+    private:
+        VoxelChunkLevel m_aLevels[NUM_LODS];
+        UINT m_uLod;
+        UINT m_uChunkX;
+        UINT m_uChunkZ;
+    };
+}
@@ -0,0 +1,259 @@
+#include "Scene/VoxelInstanceBuilder.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelInstanceBuilder::VoxelInstanceBuilder
+
+      Summary:  Constructor
+
+      Args:     const VoxelColumn* pColumns
+                  Columns of the level in row-major (x fastest) order
+                UINT uWidth, UINT uDepth
+                  Number of columns of the level along x and z
+                size_t uNumBlockTypes
+                  Number of block types, starting at GRASSLAND, that
+                  have a voxel. Columns of other types are empty
+
+      Modifies: [m_pColumns, m_uWidth, m_uDepth, m_uNumBlockTypes,
+                 m_aInstances, m_uMinHeight, m_uMaxHeight].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    VoxelInstanceBuilder::VoxelInstanceBuilder(_In_ const VoxelColumn* pColumns, _In_ UINT uWidth, _In_ UINT uDepth, _In_ size_t uNumBlockTypes)
+        : m_pColumns(pColumns)
+        , m_uWidth(uWidth)
+        , m_uDepth(uDepth)
+        , m_uNumBlockTypes(uNumBlockTypes)
+        , m_aInstances()
+        , m_uMinHeight(0u)
+        , m_uMaxHeight(0u)
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelInstanceBuilder::Build
+
+      Summary:  Builds the instances of the columns [uBeginX, uEndX) x
+                [uBeginZ, uEndZ). The cubes are counted first so the
+                instance vector is allocated once
+
+      Args:     UINT uLod
+                  Level of detail of the columns, packed with the
+                  instances
+                UINT uBeginX, UINT uBeginZ
+                  First column of the rectangle
+                UINT uEndX, UINT uEndZ
+                  Column past the last one of the rectangle, inside
+                  the level
+                INT iOffsetX, INT iOffsetZ
+                  Added to the columns for the cells of the instances,
+                  for columns copied out of a larger level
+
+      Modifies: [m_aInstances, m_uMinHeight, m_uMaxHeight].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelInstanceBuilder::Build(_In_ UINT uLod, _In_ UINT uBeginX, _In_ UINT uBeginZ, _In_ UINT uEndX, _In_ UINT uEndZ, _In_ INT iOffsetX, _In_ INT iOffsetZ)
+    {
+        size_t uNumInstances = 0u;
+        m_uMinHeight = UINT_MAX;
+        m_uMaxHeight = 0u;
+        for (UINT z = uBeginZ; z < uEndZ; ++z)
+        {
+            for (UINT x = uBeginX; x < uEndX; ++x)
+            {
+                const UINT uHeight = getHeight(static_cast<INT>(x), static_cast<INT>(z));
+                if (uHeight > 0u)
+                {
+                    const UINT uExposedHeight = getExposedHeight(x, z);
+                    uNumInstances += uHeight - uExposedHeight;
+                    m_uMinHeight = std::min(m_uMinHeight, uExposedHeight);
+                    m_uMaxHeight = std::max(m_uMaxHeight, uHeight);
+                }
+            }
+        }
+
+        m_aInstances.clear();
+        if (uNumInstances == 0u)
+        {
+            m_uMinHeight = 0u;
+            return;
+        }
+
+        m_aInstances.reserve(uNumInstances);
+        for (UINT z = uBeginZ; z < uEndZ; ++z)
+        {
+            for (UINT x = uBeginX; x < uEndX; ++x)
+            {
+                const UINT uHeight = getHeight(static_cast<INT>(x), static_cast<INT>(z));
+                const CHAR blockType = m_pColumns[static_cast<size_t>(z) * m_uWidth + x].BlockType;
+                for (UINT y = uHeight > 0u ? getExposedHeight(x, z) : 0u; y < uHeight; ++y)
+                {
+                    m_aInstances.push_back(PackInstance(uLod, static_cast<UINT>(static_cast<INT>(x) + iOffsetX), y, static_cast<UINT>(static_cast<INT>(z) + iOffsetZ), blockType));
+                }
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelInstanceBuilder::BuildOccupancy
+
+      Summary:  Builds the instances of the cells of a volumetric chunk
+                with a visible face, at the finest level of detail. The
+                exposed cells of each row come out of the occupancy as
+                one mask, which is also what sizes the instance vector.
+                The columns given to the constructor are not read, and
+                cells of a column whose block type has no voxel are not
+                drawn
+
+      Args:     const VoxelOccupancy& chunk
+                  Occupancy of the chunk
+                const eBlockType* pBlockTypes
+                  Block type of each column of the chunk, x fastest
+                INT iOffsetX, INT iOffsetZ
+                  Added to the cells of the chunk for the cells of the
+                  instances, the first column of the chunk in the map
+
+      Modifies: [m_aInstances, m_uMinHeight, m_uMaxHeight].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelInstanceBuilder::BuildOccupancy(_In_ const VoxelOccupancy& chunk, _In_reads_(static_cast<size_t>(VoxelOccupancy::SIZE) * VoxelOccupancy::SIZE) const eBlockType* pBlockTypes, _In_ INT iOffsetX, _In_ INT iOffsetZ)
+    {
+        constexpr const UINT SIZE = VoxelOccupancy::SIZE;
+
+        // Columns without a voxel are masked out of every row
+        UINT aDrawnColumns[SIZE] = { 0u, };
+        for (UINT z = 0u; z < SIZE; ++z)
+        {
+            for (UINT x = 0u; x < SIZE; ++x)
+            {
+                if (static_cast<size_t>(pBlockTypes[z * SIZE + x]) - static_cast<size_t>(eBlockType::GRASSLAND) < m_uNumBlockTypes)
+                {
+                    aDrawnColumns[z] |= 1u << x;
+                }
+            }
+        }
+
+        m_aInstances.clear();
+        m_aInstances.reserve(chunk.GetNumExposed());
+        m_uMinHeight = UINT_MAX;
+        m_uMaxHeight = 0u;
+        for (UINT y = 0u; y < chunk.GetHeight(); ++y)
+        {
+            for (UINT z = 0u; z < SIZE; ++z)
+            {
+                UINT uExposed = chunk.GetExposedRow(y, z) & aDrawnColumns[z];
+                if (uExposed != 0u)
+                {
+                    m_uMinHeight = std::min(m_uMinHeight, y);
+                    m_uMaxHeight = y + 1u;
+                }
+
+                for (; uExposed != 0u; uExposed &= uExposed - 1u)
+                {
+                    const UINT x = static_cast<UINT>(std::countr_zero(uExposed));
+                    m_aInstances.push_back(PackInstance(0u, static_cast<UINT>(static_cast<INT>(x) + iOffsetX), y, static_cast<UINT>(static_cast<INT>(z) + iOffsetZ), static_cast<CHAR>(pBlockTypes[z * SIZE + x])));
+                }
+            }
+        }
+
+        if (m_aInstances.empty())
+        {
+            m_uMinHeight = 0u;
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelInstanceBuilder::GetInstances
+
+      Summary:  Returns the instances of the last rectangle, column by
+                column and bottom up, or of the last chunk, row by row
+                bottom up, which may be moved out
+
+      Returns:  std::vector<InstanceData>&
+                  Packed instances
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::vector<InstanceData>& VoxelInstanceBuilder::GetInstances()
+    {
+        return m_aInstances;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelInstanceBuilder::GetMinHeight
+
+      Summary:  Returns the level of the lowest cube of the last
+                rectangle
+
+      Returns:  UINT
+                  Lowest cube, 0 when the rectangle has none
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT VoxelInstanceBuilder::GetMinHeight() const
+    {
+        return m_uMinHeight;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelInstanceBuilder::GetMaxHeight
+
+      Summary:  Returns the height of the tallest column of the last
+                rectangle
+
+      Returns:  UINT
+                  Level right above the highest cube
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT VoxelInstanceBuilder::GetMaxHeight() const
+    {
+        return m_uMaxHeight;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelInstanceBuilder::getHeight
+
+      Summary:  Returns the number of cubes of a column
+
+      Args:     INT x, INT z
+                  Column of the level, may lie outside of it
+
+      Returns:  UINT
+                  Height of the column, 0 outside of the level or when
+                  no voxel matches its block type
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT VoxelInstanceBuilder::getHeight(_In_ INT x, _In_ INT z) const
+    {
+        if (x < 0 || z < 0 || static_cast<UINT>(x) >= m_uWidth || static_cast<UINT>(z) >= m_uDepth)
+        {
+            return 0u;
+        }
+
+        const VoxelColumn& column = m_pColumns[static_cast<size_t>(z) * m_uWidth + static_cast<size_t>(x)];
+        if (static_cast<size_t>(column.BlockType) - static_cast<size_t>(eBlockType::GRASSLAND) >= m_uNumBlockTypes)
+        {
+            return 0u;
+        }
+
+        return column.Height;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelInstanceBuilder::getExposedHeight
+
+      Summary:  Returns the level of the lowest cube of a column open
+                to air. The cubes below it are enclosed by the column
+                itself, its four neighbors and the ground
+
+      Args:     UINT x, UINT z
+                  Column of the level with at least one cube
+
+      Returns:  UINT
+                  Level of the lowest visible cube
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT VoxelInstanceBuilder::getExposedHeight(_In_ UINT x, _In_ UINT z) const
+    {
+        const INT iX = static_cast<INT>(x);
+        const INT iZ = static_cast<INT>(z);
+
+        UINT uExposedHeight = getHeight(iX, iZ) - 1u;
+        uExposedHeight = std::min(uExposedHeight, getHeight(iX - 1, iZ));
+        uExposedHeight = std::min(uExposedHeight, getHeight(iX + 1, iZ));
+        uExposedHeight = std::min(uExposedHeight, getHeight(iX, iZ - 1));
+        uExposedHeight = std::min(uExposedHeight, getHeight(iX, iZ + 1));
+
+        return uExposedHeight;
+    }
+}
@@ -0,0 +1,82 @@
+/*+===================================================================
+  File:      VOXELINSTANCEBUILDER.H
+
+  Summary:   VoxelInstanceBuilder header file contains declarations of
+             the VoxelInstanceBuilder class that turns the columns of
+             a voxel map, or the occupancy of a volumetric chunk, into
+             the cube instances of a chunk, without Direct3D.
+
+  Classes: VoxelInstanceBuilder
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Platform.h"
+
+#include <algorithm>
+#include <climits>
+
+#include "Renderer/InstanceData.h"
+#include "Scene/VoxelMap.h"
+#include "Scene/VoxelOccupancy.h"
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    VoxelInstanceBuilder
+
+      Summary:  Builds the instances of a rectangle of columns of one
+                level of detail. Only the cubes with a face exposed to
+                air are kept: the top cube of each column and the
+                cubes above its shortest neighbor column, columns
+                outside the level and of block types without a voxel
+                being empty. A volumetric chunk keeps the cells its
+                occupancy finds a visible face for
+
+      Methods:  Build
+                  Builds the instances of a rectangle of columns
+                BuildOccupancy
+                  Builds the instances of a volumetric chunk
+                GetInstances
+                  Returns the instances of the last rectangle
+                GetMinHeight
+                  Returns the lowest cube of the last rectangle
+                GetMaxHeight
+                  Returns the top of the last rectangle
+                VoxelInstanceBuilder
+                  Constructor.
+                ~VoxelInstanceBuilder
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class VoxelInstanceBuilder final
+    {
+    public:
+        VoxelInstanceBuilder(_In_ const VoxelColumn* pColumns, _In_ UINT uWidth, _In_ UINT uDepth, _In_ size_t uNumBlockTypes);
+        VoxelInstanceBuilder(const VoxelInstanceBuilder& other) = delete;
+        VoxelInstanceBuilder(VoxelInstanceBuilder&& other) = delete;
+        VoxelInstanceBuilder& operator=(const VoxelInstanceBuilder& other) = delete;
+        VoxelInstanceBuilder& operator=(VoxelInstanceBuilder&& other) = delete;
+        ~VoxelInstanceBuilder() = default;
+
+        void Build(_In_ UINT uLod, _In_ UINT uBeginX, _In_ UINT uBeginZ, _In_ UINT uEndX, _In_ UINT uEndZ, _In_ INT iOffsetX = 0, _In_ INT iOffsetZ = 0);
+        void BuildOccupancy(_In_ const VoxelOccupancy& chunk, _In_reads_(static_cast<size_t>(VoxelOccupancy::SIZE) * VoxelOccupancy::SIZE) const eBlockType* pBlockTypes, _In_ INT iOffsetX, _In_ INT iOffsetZ);
+
+        std::vector<InstanceData>& GetInstances();
+        UINT GetMinHeight() const;
+        UINT GetMaxHeight() const;
+
+    private:
+        UINT getHeight(_In_ INT x, _In_ INT z) const;
+        UINT getExposedHeight(_In_ UINT x, _In_ UINT z) const;
+
+    private:
+        const VoxelColumn* m_pColumns;
+        UINT m_uWidth;
+        UINT m_uDepth;
+        size_t m_uNumBlockTypes;
+        std::vector<InstanceData> m_aInstances;
+        UINT m_uMinHeight;
+        UINT m_uMaxHeight;
+    };
+}
@@ -0,0 +1,231 @@
+#include "Scene/VoxelLods.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelLods::BuildColumn
+
+      Summary:  Builds a column of a coarser level of detail from the
+                2^k x 2^k columns of the map it covers
+
+      Args:     const VoxelColumn* pColumns
+                  Columns of the map in row-major (x fastest) order
+                UINT uWidth, UINT uDepth
+                  Number of columns of the map along x and z
+                size_t uNumBlockTypes
+                  Number of block types, starting at GRASSLAND, that
+                  have a voxel
+                UINT uLod
+                  Level of detail, at least 1
+                UINT uLodX, UINT uLodZ
+                  Column of the level
+                std::vector<UINT>& aTypeCounts
+                  Scratch counts, resized to uNumBlockTypes
+
+      Modifies: [aTypeCounts].
+
+      Returns:  VoxelColumn
+                  Column of the level, empty when no column under it
+                  has a cube
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    VoxelColumn VoxelLods::BuildColumn(
+        _In_ const VoxelColumn* pColumns,
+        _In_ UINT uWidth,
+        _In_ UINT uDepth,
+        _In_ size_t uNumBlockTypes,
+        _In_ UINT uLod,
+        _In_ UINT uLodX,
+        _In_ UINT uLodZ,
+        _Inout_ std::vector<UINT>& aTypeCounts
+    )
+    {
+        const UINT uScale = 1u << uLod;
+        aTypeCounts.assign(uNumBlockTypes, 0u);
+        UINT uNumColumns = 0u;
+        UINT uSumHeight = 0u;
+
+        const UINT uEndX = std::min((uLodX + 1u) * uScale, uWidth);
+        const UINT uEndZ = std::min((uLodZ + 1u) * uScale, uDepth);
+        for (UINT z = uLodZ * uScale; z < uEndZ; ++z)
+        {
+            for (UINT x = uLodX * uScale; x < uEndX; ++x)
+            {
+                ++uNumColumns;
+                const VoxelColumn& column = pColumns[static_cast<size_t>(z) * uWidth + x];
+                const size_t uTypeIdx = static_cast<size_t>(column.BlockType) - static_cast<size_t>(eBlockType::GRASSLAND);
+                if (uTypeIdx < uNumBlockTypes && column.Height > 0u)
+                {
+                    uSumHeight += column.Height;
+                    ++aTypeCounts[uTypeIdx];
+                }
+            }
+        }
+
+        if (uSumHeight == 0u)
+        {
+            return VoxelColumn{ .BlockType = 0, .Reserved = 0u, .Height = 0u };
+        }
+
+        const size_t uTypeIdx = static_cast<size_t>(std::max_element(aTypeCounts.begin(), aTypeCounts.end()) - aTypeCounts.begin());
+        const UINT uLodHeight = std::max((uSumHeight + uNumColumns * uScale / 2u) / (uNumColumns * uScale), 1u);
+        return VoxelColumn
+        {
+            .BlockType = static_cast<CHAR>(static_cast<size_t>(eBlockType::GRASSLAND) + uTypeIdx),
+            .Reserved = 0u,
+            .Height = static_cast<WORD>(std::min(uLodHeight, 0xFFFFu))
+        };
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelLods::VoxelLods
+
+      Summary:  Constructor
+
+      Args:     UINT uNumLods
+                  Number of levels of detail, the map included
+
+      Modifies: [m_aLevels, m_aTypeCounts, m_uWidth, m_uDepth,
+                 m_uNumBlockTypes].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    VoxelLods::VoxelLods(_In_ UINT uNumLods)
+        : m_aLevels(std::max(uNumLods, 1u) - 1u)
+        , m_aTypeCounts()
+        , m_uWidth(0u)
+        , m_uDepth(0u)
+        , m_uNumBlockTypes(0u)
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelLods::Build
+
+      Summary:  Builds the columns of every coarser level of detail
+
+      Args:     const VoxelColumn* pColumns
+                  Columns of the map in row-major (x fastest) order
+                UINT uWidth, UINT uDepth
+                  Number of columns of the map along x and z
+                size_t uNumBlockTypes
+                  Number of block types, starting at GRASSLAND, that
+                  have a voxel
+
+      Modifies: [m_aLevels, m_aTypeCounts, m_uWidth, m_uDepth,
+                 m_uNumBlockTypes].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelLods::Build(_In_ const VoxelColumn* pColumns, _In_ UINT uWidth, _In_ UINT uDepth, _In_ size_t uNumBlockTypes)
+    {
+        m_uWidth = uWidth;
+        m_uDepth = uDepth;
+        m_uNumBlockTypes = uNumBlockTypes;
+
+        for (UINT uLod = 1u; uLod < GetNumLods(); ++uLod)
+        {
+            m_aLevels[uLod - 1u].assign(
+                static_cast<size_t>(GetWidth(uLod)) * static_cast<size_t>(GetDepth(uLod)),
+                VoxelColumn{ .BlockType = 0, .Reserved = 0u, .Height = 0u }
+            );
+        }
+
+        if (uWidth > 0u && uDepth > 0u)
+        {
+            Update(pColumns, 0u, 0u, uWidth, uDepth);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelLods::Update
+
+      Summary:  Rebuilds the columns of every coarser level that cover
+                a rectangle of the map
+
+      Args:     const VoxelColumn* pColumns
+                  Columns of the map in row-major (x fastest) order
+                UINT uX, UINT uZ
+                  First column of the rectangle
+                UINT uWidth, UINT uDepth
+                  Number of columns of the rectangle along x and z,
+                  at least 1, inside the map
+
+      Modifies: [m_aLevels, m_aTypeCounts].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelLods::Update(_In_ const VoxelColumn* pColumns, _In_ UINT uX, _In_ UINT uZ, _In_ UINT uWidth, _In_ UINT uDepth)
+    {
+        const UINT uEndX = uX + uWidth;
+        const UINT uEndZ = uZ + uDepth;
+        for (UINT uLod = 1u; uLod < GetNumLods(); ++uLod)
+        {
+            std::vector<VoxelColumn>& aLodColumns = m_aLevels[uLod - 1u];
+            const UINT uLodWidth = GetWidth(uLod);
+            for (UINT uLodZ = uZ >> uLod; uLodZ <= (uEndZ - 1u) >> uLod; ++uLodZ)
+            {
+                for (UINT uLodX = uX >> uLod; uLodX <= (uEndX - 1u) >> uLod; ++uLodX)
+                {
+                    aLodColumns[static_cast<size_t>(uLodZ) * uLodWidth + uLodX] = BuildColumn(pColumns, m_uWidth, m_uDepth, m_uNumBlockTypes, uLod, uLodX, uLodZ, m_aTypeCounts);
+                }
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelLods::GetColumns
+
+      Summary:  Returns the columns of a coarser level of detail
+
+      Args:     UINT uLod
+                  Level of detail, from 1 to GetNumLods() - 1
+
+      Returns:  const std::vector<VoxelColumn>&
+                  GetWidth(uLod) * GetDepth(uLod) columns, x fastest
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const std::vector<VoxelColumn>& VoxelLods::GetColumns(_In_ UINT uLod) const
+    {
+        assert(uLod > 0u && uLod < GetNumLods());
+
+        return m_aLevels[uLod - 1u];
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelLods::GetWidth
+
+      Summary:  Returns the number of columns of a level along x
+
+      Args:     UINT uLod
+                  Level of detail
+
+      Returns:  UINT
+                  Width of the map divided by 2^uLod, rounded up
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT VoxelLods::GetWidth(_In_ UINT uLod) const
+    {
+        return (m_uWidth + (1u << uLod) - 1u) >> uLod;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelLods::GetDepth
+
+      Summary:  Returns the number of columns of a level along z
+
+      Args:     UINT uLod
+                  Level of detail
+
+      Returns:  UINT
+                  Depth of the map divided by 2^uLod, rounded up
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT VoxelLods::GetDepth(_In_ UINT uLod) const
+    {
+        return (m_uDepth + (1u << uLod) - 1u) >> uLod;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelLods::GetNumLods
+
+      Summary:  Returns the number of levels of detail
+
+      Returns:  UINT
+                  Number of levels, the map included
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT VoxelLods::GetNumLods() const
+    {
+        return static_cast<UINT>(m_aLevels.size()) + 1u;
+    }
+}
@@ -0,0 +1,89 @@
+/*+===================================================================
+  File:      VOXELLODS.H
+
+  Summary:   VoxelLods header file contains declarations of the
+             VoxelLods class that downsamples the columns of a voxel
+             map into its coarser levels of detail, without Direct3D.
+
+  Classes: VoxelLods
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Platform.h"
+
+#include <algorithm>
+
+#include "Scene/VoxelMap.h"
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    VoxelLods
+
+      Summary:  Columns of the levels of detail 1 to NumLods - 1 of a
+                voxel map, level 0 being the map itself. A column of
+                level k covers 2^k x 2^k columns of the map: it takes
+                the block type most of them have, and its height is
+                their average height in cubes of 2^k, rounded, keeping
+                at least one cube when any of them has one. Columns
+                of block types without a voxel count as empty
+
+      Methods:  Build
+                  Builds every level from the columns of a map
+                Update
+                  Rebuilds the columns over a rectangle of the map
+                BuildColumn
+                  Builds one column of a level
+                GetColumns
+                  Returns the columns of a level
+                GetWidth
+                  Returns the number of columns of a level along x
+                GetDepth
+                  Returns the number of columns of a level along z
+                GetNumLods
+                  Returns the number of levels, the map included
+                VoxelLods
+                  Constructor.
+                ~VoxelLods
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class VoxelLods final
+    {
+    public:
+        static VoxelColumn BuildColumn(
+            _In_ const VoxelColumn* pColumns,
+            _In_ UINT uWidth,
+            _In_ UINT uDepth,
+            _In_ size_t uNumBlockTypes,
+            _In_ UINT uLod,
+            _In_ UINT uLodX,
+            _In_ UINT uLodZ,
+            _Inout_ std::vector<UINT>& aTypeCounts
+        );
+
+    public:
+        explicit VoxelLods(_In_ UINT uNumLods);
+        VoxelLods(const VoxelLods& other) = delete;
+        VoxelLods(VoxelLods&& other) = delete;
+        VoxelLods& operator=(const VoxelLods& other) = delete;
+        VoxelLods& operator=(VoxelLods&& other) = delete;
+        ~VoxelLods() = default;
+
+        void Build(_In_ const VoxelColumn* pColumns, _In_ UINT uWidth, _In_ UINT uDepth, _In_ size_t uNumBlockTypes);
+        void Update(_In_ const VoxelColumn* pColumns, _In_ UINT uX, _In_ UINT uZ, _In_ UINT uWidth, _In_ UINT uDepth);
+
+        const std::vector<VoxelColumn>& GetColumns(_In_ UINT uLod) const;
+        UINT GetWidth(_In_ UINT uLod) const;
+        UINT GetDepth(_In_ UINT uLod) const;
+        UINT GetNumLods() const;
+
+    private:
+        std::vector<std::vector<VoxelColumn>> m_aLevels;
+        std::vector<UINT> m_aTypeCounts;
+        UINT m_uWidth;
+        UINT m_uDepth;
+        size_t m_uNumBlockTypes;
+    };
+}
@@ -0,0 +1,467 @@
+#include "Scene/VoxelMap.h"
+
+#include <cstring>
+#include <fstream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // ! _WIN32
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelMapFile::Write
+
+      Summary:  Writes a binary voxel map
+
+      Args:     const std::filesystem::path& filePath
+                  Path of the file to write
+                UINT uWidth
+                  Number of columns along the x axis
+                UINT uHeight
+                  Maximum number of cubes in a column
+                UINT uDepth
+                  Number of columns along the z axis
+                const std::vector<XMFLOAT3>& aPalette
+                  Color of each block type
+                const std::vector<VoxelColumn>& aColumns
+                  uWidth * uDepth columns, x fastest
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT VoxelMapFile::Write(
+        _In_ const std::filesystem::path& filePath,
+        _In_ UINT uWidth,
+        _In_ UINT uHeight,
+        _In_ UINT uDepth,
+        _In_ const std::vector<XMFLOAT3>& aPalette,
+        _In_ const std::vector<VoxelColumn>& aColumns
+    )
+    {
+        if (aColumns.size() != static_cast<size_t>(uWidth) * static_cast<size_t>(uDepth))
+        {
+            return E_INVALIDARG;
+        }
+
+        std::ofstream outputFile(filePath, std::ios::binary | std::ios::trunc);
+        if (!outputFile.is_open())
+        {
+            return E_FAIL;
+        }
+
+        VoxelMapHeader header =
+        {
+            .Magic = { MAGIC[0], MAGIC[1], MAGIC[2], MAGIC[3] },
+            .Version = VERSION,
+            .Width = uWidth,
+            .Height = uHeight,
+            .Depth = uDepth,
+            .NumColors = static_cast<UINT>(aPalette.size())
+        };
+
+        outputFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        outputFile.write(reinterpret_cast<const char*>(aPalette.data()), static_cast<std::streamsize>(sizeof(XMFLOAT3) * aPalette.size()));
+        outputFile.write(reinterpret_cast<const char*>(aColumns.data()), static_cast<std::streamsize>(sizeof(VoxelColumn) * aColumns.size()));
+
+        if (outputFile.fail())
+        {
+            return E_FAIL;
+        }
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelMapFile::ReadText
+
+      Summary:  Reads a HeightMap.txt file into the sections of a binary
+                voxel map. Malformed tokens are skipped exactly like the
+                text loader of Scene does. More records than width *
+                depth, or a height the columns cannot store, fail
+                instead of being wrapped around or clamped
+
+      Args:     const std::filesystem::path& textFilePath
+                  Path of the text height map
+                VoxelMapHeader& header
+                  Header of the map
+                std::vector<XMFLOAT3>& aPalette
+                  Color of each block type
+                std::vector<VoxelColumn>& aColumns
+                  Width * Depth columns, x fastest. Columns without a
+                  record are empty
+
+      Returns:  HRESULT
+                  Status code, E_INVALIDARG if the map does not fit
+                  the binary format
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT VoxelMapFile::ReadText(
+        _In_ const std::filesystem::path& textFilePath,
+        _Out_ VoxelMapHeader& header,
+        _Out_ std::vector<XMFLOAT3>& aPalette,
+        _Out_ std::vector<VoxelColumn>& aColumns
+    )
+    {
+        aPalette.clear();
+        aColumns.clear();
+
+        std::ifstream inputFile;
+        inputFile.open(textFilePath.string());
+        if (!inputFile.is_open())
+        {
+            return E_FAIL;
+        }
+
+        std::string trash;
+        UINT aDimension[4] = { 0u, };
+        UINT uDimensionIdx = 0u;
+        while (!inputFile.eof() && uDimensionIdx < ARRAYSIZE(aDimension))
+        {
+            inputFile >> aDimension[uDimensionIdx];
+
+            if (inputFile.fail())
+            {
+                if (inputFile.eof())
+                {
+                    break;
+                }
+                inputFile.clear();
+                inputFile >> trash;
+            }
+            else
+            {
+                ++uDimensionIdx;
+            }
+        }
+
+        header =
+        {
+            .Magic = { MAGIC[0], MAGIC[1], MAGIC[2], MAGIC[3] },
+            .Version = VERSION,
+            .Width = aDimension[0],
+            .Height = aDimension[1],
+            .Depth = aDimension[2],
+            .NumColors = aDimension[3]
+        };
+
+        aPalette.reserve(aDimension[3]);
+        XMFLOAT3 color;
+        while (!inputFile.eof() && aPalette.size() < aDimension[3])
+        {
+            inputFile >> color.x >> color.y >> color.z;
+
+            if (inputFile.fail())
+            {
+                if (inputFile.eof())
+                {
+                    break;
+                }
+                inputFile.clear();
+                inputFile >> trash;
+            }
+            else
+            {
+                aPalette.push_back(color);
+            }
+        }
+        header.NumColors = static_cast<UINT>(aPalette.size());
+
+        aColumns.resize(static_cast<size_t>(aDimension[0]) * static_cast<size_t>(aDimension[2]), VoxelColumn{ .BlockType = 0, .Reserved = 0u, .Height = 0u });
+
+        size_t uColumnIdx = 0u;
+        CHAR voxelType;
+        FLOAT height;
+        while (!inputFile.eof())
+        {
+            inputFile >> voxelType >> height;
+
+            if (inputFile.fail())
+            {
+                if (inputFile.eof())
+                {
+                    break;
+                }
+                inputFile.clear();
+                inputFile >> trash;
+            }
+            else if (static_cast<CHAR>(eBlockType::GRASSLAND) <= voxelType && voxelType < static_cast<CHAR>(eBlockType::COUNT))
+            {
+                const FLOAT levels = static_cast<FLOAT>(aDimension[1]) * height;
+                if (uColumnIdx >= aColumns.size() || !(levels >= 0.0f && levels < 65536.0f))
+                {
+                    aPalette.clear();
+                    aColumns.clear();
+                    return E_INVALIDARG;
+                }
+
+                aColumns[uColumnIdx++] =
+                {
+                    .BlockType = voxelType,
+                    .Reserved = 0u,
+                    .Height = static_cast<WORD>(levels)
+                };
+            }
+        }
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelMapFile::ConvertFromText
+
+      Summary:  Converts a HeightMap.txt file into a binary voxel map
+
+      Args:     const std::filesystem::path& textFilePath
+                  Path of the text height map
+                const std::filesystem::path& binaryFilePath
+                  Path of the binary voxel map to write
+
+      Returns:  HRESULT
+                  Status code, E_INVALIDARG and no file written if the
+                  map does not fit the binary format
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT VoxelMapFile::ConvertFromText(_In_ const std::filesystem::path& textFilePath, _In_ const std::filesystem::path& binaryFilePath)
+    {
+        VoxelMapHeader header;
+        std::vector<XMFLOAT3> aPalette;
+        std::vector<VoxelColumn> aColumns;
+        HRESULT hr = ReadText(textFilePath, header, aPalette, aColumns);
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        return Write(binaryFilePath, header.Width, header.Height, header.Depth, aPalette, aColumns);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelMapFile::VoxelMapFile
+
+      Summary:  Constructor
+
+      Modifies: [m_hFile, m_hMapping, m_iFile, m_pView, m_uViewSize].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    VoxelMapFile::VoxelMapFile()
+#ifdef _WIN32
+        : m_hFile(INVALID_HANDLE_VALUE)
+        , m_hMapping(nullptr)
+#else
+        : m_iFile(-1)
+#endif // _WIN32
+        , m_pView(nullptr)
+        , m_uViewSize(0u)
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelMapFile::~VoxelMapFile
+
+      Summary:  Destructor
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    VoxelMapFile::~VoxelMapFile()
+    {
+        Close();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelMapFile::Open
+
+      Summary:  Maps the file into memory and validates the header and
+                the size of the palette and column sections
+
+      Args:     const std::filesystem::path& filePath
+                  Path of the binary voxel map
+
+      Modifies: [m_hFile, m_hMapping, m_iFile, m_pView, m_uViewSize].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT VoxelMapFile::Open(_In_ const std::filesystem::path& filePath)
+    {
+        Close();
+
+#ifdef _WIN32
+        m_hFile = CreateFileW(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (m_hFile == INVALID_HANDLE_VALUE)
+        {
+            return HRESULT_FROM_WIN32(GetLastError());
+        }
+
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(m_hFile, &fileSize))
+        {
+            HRESULT hr = HRESULT_FROM_WIN32(GetLastError());
+            Close();
+            return hr;
+        }
+
+        if (static_cast<ULONGLONG>(fileSize.QuadPart) < sizeof(VoxelMapHeader))
+        {
+            Close();
+            return E_FAIL;
+        }
+
+        m_hMapping = CreateFileMappingW(m_hFile, nullptr, PAGE_READONLY, 0u, 0u, nullptr);
+        if (!m_hMapping)
+        {
+            HRESULT hr = HRESULT_FROM_WIN32(GetLastError());
+            Close();
+            return hr;
+        }
+
+        m_pView = static_cast<const BYTE*>(MapViewOfFile(m_hMapping, FILE_MAP_READ, 0u, 0u, 0u));
+        if (!m_pView)
+        {
+            HRESULT hr = HRESULT_FROM_WIN32(GetLastError());
+            Close();
+            return hr;
+        }
+        m_uViewSize = static_cast<size_t>(fileSize.QuadPart);
+#else
+        m_iFile = open(filePath.c_str(), O_RDONLY);
+        if (m_iFile < 0)
+        {
+            return E_FAIL;
+        }
+
+        struct stat fileStat;
+        if (fstat(m_iFile, &fileStat) != 0 || static_cast<size_t>(fileStat.st_size) < sizeof(VoxelMapHeader))
+        {
+            Close();
+            return E_FAIL;
+        }
+
+        void* pView = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, m_iFile, 0);
+        if (pView == MAP_FAILED)
+        {
+            Close();
+            return E_FAIL;
+        }
+        m_pView = static_cast<const BYTE*>(pView);
+        m_uViewSize = static_cast<size_t>(fileStat.st_size);
+#endif // _WIN32
+
+        const VoxelMapHeader& header = GetHeader();
+        if (memcmp(header.Magic, MAGIC, sizeof(MAGIC)) != 0 || header.Version != VERSION)
+        {
+            Close();
+            return E_FAIL;
+        }
+
+        const UINT64 uExpectedSize = sizeof(VoxelMapHeader)
+            + sizeof(XMFLOAT3) * static_cast<UINT64>(header.NumColors)
+            + sizeof(VoxelColumn) * static_cast<UINT64>(header.Width) * static_cast<UINT64>(header.Depth);
+        if (static_cast<UINT64>(m_uViewSize) < uExpectedSize)
+        {
+            Close();
+            return E_FAIL;
+        }
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelMapFile::Close
+
+      Summary:  Unmaps the view and closes the handles
+
+      Modifies: [m_hFile, m_hMapping, m_iFile, m_pView, m_uViewSize].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelMapFile::Close()
+    {
+#ifdef _WIN32
+        if (m_pView)
+        {
+            UnmapViewOfFile(m_pView);
+            m_pView = nullptr;
+        }
+
+        if (m_hMapping)
+        {
+            CloseHandle(m_hMapping);
+            m_hMapping = nullptr;
+        }
+
+        if (m_hFile != INVALID_HANDLE_VALUE)
+        {
+            CloseHandle(m_hFile);
+            m_hFile = INVALID_HANDLE_VALUE;
+        }
+#else
+        if (m_pView)
+        {
+            munmap(const_cast<BYTE*>(m_pView), m_uViewSize);
+            m_pView = nullptr;
+        }
+
+        if (m_iFile >= 0)
+        {
+            close(m_iFile);
+            m_iFile = -1;
+        }
+#endif // _WIN32
+        m_uViewSize = 0u;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelMapFile::GetHeader
+
+      Summary:  Returns the header of the mapped file
+
+      Returns:  const VoxelMapHeader&
+                  Header
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const VoxelMapHeader& VoxelMapFile::GetHeader() const
+    {
+        assert(m_pView);
+
+        return *reinterpret_cast<const VoxelMapHeader*>(m_pView);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelMapFile::GetPalette
+
+      Summary:  Returns the color palette of the mapped file
+
+      Returns:  const XMFLOAT3*
+                  NumColors palette entries
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const XMFLOAT3* VoxelMapFile::GetPalette() const
+    {
+        assert(m_pView);
+
+        return reinterpret_cast<const XMFLOAT3*>(m_pView + sizeof(VoxelMapHeader));
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelMapFile::GetColumns
+
+      Summary:  Returns the packed columns of the mapped file
+
+      Returns:  const VoxelColumn*
+                  Width * Depth columns, x fastest
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const VoxelColumn* VoxelMapFile::GetColumns() const
+    {
+        assert(m_pView);
+
+        return reinterpret_cast<const VoxelColumn*>(m_pView + sizeof(VoxelMapHeader) + sizeof(XMFLOAT3) * GetHeader().NumColors);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelMapFile::GetNumColumns
+
+      Summary:  Returns the number of columns of the mapped file
+
+      Returns:  size_t
+                  Width * Depth
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    size_t VoxelMapFile::GetNumColumns() const
+    {
+        return static_cast<size_t>(GetHeader().Width) * static_cast<size_t>(GetHeader().Depth);
+    }
+}
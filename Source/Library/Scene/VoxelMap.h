@@ -0,0 +1,129 @@
+/*+===================================================================
+  File:      VOXELMAP.H
+
+  Summary:   VoxelMap header file contains declarations of the binary
+             voxel map format and the VoxelMapFile class that reads it
+             through a read-only memory mapping, without Direct3D.
+
+  Classes: VoxelMapFile
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Platform.h"
+
+#include <filesystem>
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+        Struct:   VoxelMapHeader
+        Summary:  Header at the beginning of a binary voxel map file.
+                  It is followed by NumColors XMFLOAT3 palette entries
+                  and Width * Depth VoxelColumn entries in row-major
+                  (x fastest) order
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct VoxelMapHeader
+    {
+        CHAR Magic[4];
+        UINT Version;
+        UINT Width;
+        UINT Height;
+        UINT Depth;
+        UINT NumColors;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+        Struct:   VoxelColumn
+        Summary:  Packed column of a voxel map. Height is the number of
+                  stacked cubes, already scaled by the map height
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct VoxelColumn
+    {
+        CHAR BlockType;
+        BYTE Reserved;
+        WORD Height;
+    };
+
+    static_assert(sizeof(VoxelMapHeader) == 24u, "VoxelMapHeader is part of the file format");
+    static_assert(sizeof(VoxelColumn) == 4u, "VoxelColumn is part of the file format");
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    VoxelMapFile
+
+      Summary:  Read-only memory-mapped view of a binary voxel map
+
+      Methods:  Open
+                  Maps the file and validates its header
+                Close
+                  Unmaps the file
+                GetHeader
+                  Returns the header
+                GetPalette
+                  Returns the color palette
+                GetColumns
+                  Returns the packed columns
+                GetNumColumns
+                  Returns the number of columns
+                Write
+                  Writes a binary voxel map
+                ReadText
+                  Reads a HeightMap.txt file
+                ConvertFromText
+                  Converts a HeightMap.txt file into a binary voxel map
+                VoxelMapFile
+                  Constructor.
+                ~VoxelMapFile
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class VoxelMapFile final
+    {
+    public:
+        static constexpr const CHAR MAGIC[4] = { 'V', 'X', 'M', 'P' };
+        static constexpr const UINT VERSION = 1u;
+        static constexpr const WCHAR EXTENSION[] = L".vxm";
+
+        static HRESULT Write(
+            _In_ const std::filesystem::path& filePath,
+            _In_ UINT uWidth,
+            _In_ UINT uHeight,
+            _In_ UINT uDepth,
+            _In_ const std::vector<XMFLOAT3>& aPalette,
+            _In_ const std::vector<VoxelColumn>& aColumns
+        );
+        static HRESULT ReadText(
+            _In_ const std::filesystem::path& textFilePath,
+            _Out_ VoxelMapHeader& header,
+            _Out_ std::vector<XMFLOAT3>& aPalette,
+            _Out_ std::vector<VoxelColumn>& aColumns
+        );
+        static HRESULT ConvertFromText(_In_ const std::filesystem::path& textFilePath, _In_ const std::filesystem::path& binaryFilePath);
+
+    public:
+        VoxelMapFile();
+        VoxelMapFile(const VoxelMapFile& other) = delete;
+        VoxelMapFile(VoxelMapFile&& other) = delete;
+        VoxelMapFile& operator=(const VoxelMapFile& other) = delete;
+        VoxelMapFile& operator=(VoxelMapFile&& other) = delete;
+        ~VoxelMapFile();
+
+        HRESULT Open(_In_ const std::filesystem::path& filePath);
+        void Close();
+
+        const VoxelMapHeader& GetHeader() const;
+        const XMFLOAT3* GetPalette() const;
+        const VoxelColumn* GetColumns() const;
+        size_t GetNumColumns() const;
+
+    private:
+#ifdef _WIN32
+        HANDLE m_hFile;
+        HANDLE m_hMapping;
+#else
+        INT m_iFile;
+#endif // _WIN32
+        const BYTE* m_pView;
+        size_t m_uViewSize;
+    };
+}
@@ -0,0 +1,241 @@
+#include "Scene/VoxelOccupancy.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelOccupancy::VoxelOccupancy
+
+      Summary:  Constructor
+
+      Modifies: [m_aRows, m_uHeight].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    VoxelOccupancy::VoxelOccupancy()
+        : m_aRows()
+        , m_uHeight(0u)
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelOccupancy::Resize
+
+      Summary:  Sets the number of cells along y and empties the chunk
+
+      Args:     UINT uHeight
+                  Number of cells along y
+
+      Modifies: [m_aRows, m_uHeight].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelOccupancy::Resize(_In_ UINT uHeight)
+    {
+        m_uHeight = uHeight;
+        m_aRows.assign(static_cast<size_t>(uHeight) * SIZE, 0u);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelOccupancy::Clear
+
+      Summary:  Empties every cell
+
+      Modifies: [m_aRows].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelOccupancy::Clear()
+    {
+        std::fill(m_aRows.begin(), m_aRows.end(), 0u);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelOccupancy::IsSolid
+
+      Summary:  Returns whether a cell is solid
+
+      Args:     UINT x, UINT y, UINT z
+                  Cell inside the chunk
+
+      Returns:  BOOL
+                  TRUE if the cell is solid
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL VoxelOccupancy::IsSolid(_In_ UINT x, _In_ UINT y, _In_ UINT z) const
+    {
+        assert(x < SIZE && y < m_uHeight && z < SIZE);
+
+        return (m_aRows[static_cast<size_t>(y) * SIZE + z] >> x) & 1u;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelOccupancy::SetSolid
+
+      Summary:  Sets whether a cell is solid
+
+      Args:     UINT x, UINT y, UINT z
+                  Cell inside the chunk
+                BOOL bSolid
+                  TRUE to fill the cell, FALSE to empty it
+
+      Modifies: [m_aRows].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelOccupancy::SetSolid(_In_ UINT x, _In_ UINT y, _In_ UINT z, _In_ BOOL bSolid)
+    {
+        assert(x < SIZE && y < m_uHeight && z < SIZE);
+
+        UINT& uRow = m_aRows[static_cast<size_t>(y) * SIZE + z];
+        uRow = bSolid ? uRow | (1u << x) : uRow & ~(1u << x);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelOccupancy::GetRow
+
+      Summary:  Returns the cells of a row, bit x for cell x
+
+      Args:     UINT y, UINT z
+                  Row inside the chunk
+
+      Returns:  UINT
+                  Solid cells of the row
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT VoxelOccupancy::GetRow(_In_ UINT y, _In_ UINT z) const
+    {
+        assert(y < m_uHeight && z < SIZE);
+
+        return m_aRows[static_cast<size_t>(y) * SIZE + z];
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelOccupancy::SetRow
+
+      Summary:  Sets the cells of a row, bit x for cell x
+
+      Args:     UINT y, UINT z
+                  Row inside the chunk
+                UINT uRow
+                  Solid cells of the row
+
+      Modifies: [m_aRows].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelOccupancy::SetRow(_In_ UINT y, _In_ UINT z, _In_ UINT uRow)
+    {
+        assert(y < m_uHeight && z < SIZE);
+
+        m_aRows[static_cast<size_t>(y) * SIZE + z] = uRow;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelOccupancy::GetFaceRow
+
+      Summary:  Returns the solid cells of a row whose neighbor across
+                a face is empty, so the face needs a quad
+
+      Args:     UINT uFace
+                  Face, -x, +x, -y, +y, -z, +z in that order
+                UINT y, UINT z
+                  Row inside the chunk
+
+      Returns:  UINT
+                  Cells of the row with the face visible
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT VoxelOccupancy::GetFaceRow(_In_ UINT uFace, _In_ UINT y, _In_ UINT z) const
+    {
+        const UINT uRow = GetRow(y, z);
+        switch (uFace)
+        {
+        case 0u:
+            return uRow & ~(uRow << 1u);
+        case 1u:
+            return uRow & ~(uRow >> 1u);
+        case 2u:
+            return y > 0u ? uRow & ~GetRow(y - 1u, z) : 0u;
+        case 3u:
+            return y + 1u < m_uHeight ? uRow & ~GetRow(y + 1u, z) : uRow;
+        case 4u:
+            return z > 0u ? uRow & ~GetRow(y, z - 1u) : uRow;
+        case 5u:
+            return z + 1u < SIZE ? uRow & ~GetRow(y, z + 1u) : uRow;
+        default:
+            assert(FALSE);
+            return 0u;
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelOccupancy::GetExposedRow
+
+      Summary:  Returns the solid cells of a row with at least one
+                visible face, which are the cubes a chunk has to draw
+
+      Args:     UINT y, UINT z
+                  Row inside the chunk
+
+      Returns:  UINT
+                  Cells of the row with a visible face
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT VoxelOccupancy::GetExposedRow(_In_ UINT y, _In_ UINT z) const
+    {
+        const UINT uRow = GetRow(y, z);
+        if (uRow == 0u)
+        {
+            return 0u;
+        }
+
+        UINT uCovered = (uRow << 1u) & (uRow >> 1u);
+        uCovered &= y > 0u ? GetRow(y - 1u, z) : ~0u;
+        uCovered &= y + 1u < m_uHeight ? GetRow(y + 1u, z) : 0u;
+        uCovered &= z > 0u ? GetRow(y, z - 1u) : 0u;
+        uCovered &= z + 1u < SIZE ? GetRow(y, z + 1u) : 0u;
+
+        return uRow & ~uCovered;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelOccupancy::GetNumSolid
+
+      Summary:  Returns the number of solid cells
+
+      Returns:  UINT
+                  Number of solid cells
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT VoxelOccupancy::GetNumSolid() const
+    {
+        UINT uNumSolid = 0u;
+        for (UINT uRow : m_aRows)
+        {
+            uNumSolid += static_cast<UINT>(std::popcount(uRow));
+        }
+
+        return uNumSolid;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelOccupancy::GetNumExposed
+
+      Summary:  Returns the number of solid cells with a visible face,
+                to size the instances of a chunk before filling them
+
+      Returns:  UINT
+                  Number of cells with a visible face
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT VoxelOccupancy::GetNumExposed() const
+    {
+        UINT uNumExposed = 0u;
+        for (UINT y = 0u; y < m_uHeight; ++y)
+        {
+            for (UINT z = 0u; z < SIZE; ++z)
+            {
+                uNumExposed += static_cast<UINT>(std::popcount(GetExposedRow(y, z)));
+            }
+        }
+
+        return uNumExposed;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelOccupancy::GetHeight
+
+      Summary:  Returns the number of cells along y
+
+      Returns:  UINT
+                  Height of the chunk
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT VoxelOccupancy::GetHeight() const
+    {
+        return m_uHeight;
+    }
+}
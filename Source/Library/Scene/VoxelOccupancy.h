@@ -0,0 +1,93 @@
+/*+===================================================================
+  File:      VOXELOCCUPANCY.H
+
+  Summary:   VoxelOccupancy header file contains declarations of the
+             VoxelOccupancy class that stores which cells of a chunk
+             of a volumetric voxel map are solid, one bit per cell.
+
+  Classes: VoxelOccupancy
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Platform.h"
+
+#include <algorithm>
+#include <bit>
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    VoxelOccupancy
+
+      Summary:  SIZE x height x SIZE cells of a chunk, stored as one
+                32-bit row per (y, z) with bit x set for a solid cell.
+                Rows are ordered by y, then z, so the neighbors of a
+                row along z are 1 row apart and along y SIZE rows
+                apart. Finding the faces of a row that need a quad is
+                a handful of shifts and masks over whole rows, faces
+                -x, +x, -y, +y, -z, +z in that order. Cells outside
+                the chunk count as empty, except below y = 0 which
+                counts as solid
+
+      Methods:  Resize
+                  Sets the height and empties the chunk
+                Clear
+                  Empties the chunk
+                IsSolid
+                  Returns whether a cell is solid
+                SetSolid
+                  Sets whether a cell is solid
+                GetRow
+                  Returns the cells of a row
+                SetRow
+                  Sets the cells of a row
+                GetFaceRow
+                  Returns the cells of a row with a visible face
+                GetExposedRow
+                  Returns the cells of a row with any visible face
+                GetNumSolid
+                  Returns the number of solid cells
+                GetNumExposed
+                  Returns the number of cells with a visible face
+                GetHeight
+                  Returns the number of cells along y
+                VoxelOccupancy
+                  Constructor.
+                ~VoxelOccupancy
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class VoxelOccupancy final
+    {
+    public:
+        static constexpr const UINT SIZE = 32u;
+        static constexpr const UINT NUM_FACES = 6u;
+
+    public:
+        VoxelOccupancy();
+        VoxelOccupancy(const VoxelOccupancy& other) = delete;
+        VoxelOccupancy(VoxelOccupancy&& other) = delete;
+        VoxelOccupancy& operator=(const VoxelOccupancy& other) = delete;
+        VoxelOccupancy& operator=(VoxelOccupancy&& other) = delete;
+        ~VoxelOccupancy() = default;
+
+        void Resize(_In_ UINT uHeight);
+        void Clear();
+
+        BOOL IsSolid(_In_ UINT x, _In_ UINT y, _In_ UINT z) const;
+        void SetSolid(_In_ UINT x, _In_ UINT y, _In_ UINT z, _In_ BOOL bSolid);
+        UINT GetRow(_In_ UINT y, _In_ UINT z) const;
+        void SetRow(_In_ UINT y, _In_ UINT z, _In_ UINT uRow);
+        UINT GetFaceRow(_In_ UINT uFace, _In_ UINT y, _In_ UINT z) const;
+        UINT GetExposedRow(_In_ UINT y, _In_ UINT z) const;
+
+        UINT GetNumSolid() const;
+        UINT GetNumExposed() const;
+        UINT GetHeight() const;
+
+    private:
+        std::vector<UINT> m_aRows;
+        UINT m_uHeight;
+    };
+}
@@ -0,0 +1,637 @@
+#include "Scene/VoxelOctree.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelOctree::VoxelOctree
+
+      Summary:  Constructor
+
+      Modifies: [m_aNodes, m_aColumnRanges, m_uWidth, m_uDepth,
+                 m_uSize].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    VoxelOctree::VoxelOctree()
+        : m_aNodes()
+        , m_aColumnRanges()
+        , m_uWidth(0u)
+        , m_uDepth(0u)
+        , m_uSize(0u)
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelOctree::Build
+
+      Summary:  Builds the octree from the columns of a map. The root
+                is the smallest power of two that holds the map, and
+                each mixed node is split into the octants that hold a
+                cube. The children of a node are appended together so
+                they stay next to each other
+
+      Args:     const VoxelColumn* pColumns
+                  Columns of the map, row by row along the depth
+                UINT uWidth
+                  Number of columns along the width
+                UINT uDepth
+                  Number of columns along the depth
+                size_t uNumBlockTypes
+                  Number of voxels, columns of other block types are
+                  empty
+
+      Modifies: [m_aNodes, m_aColumnRanges, m_uWidth, m_uDepth,
+                 m_uSize].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelOctree::Build(_In_ const VoxelColumn* pColumns, _In_ UINT uWidth, _In_ UINT uDepth, _In_ size_t uNumBlockTypes)
+    {
+        m_aNodes.clear();
+        m_uWidth = uWidth;
+        m_uDepth = uDepth;
+        m_uSize = 0u;
+        if (uWidth == 0u || uDepth == 0u)
+        {
+            return;
+        }
+
+        UINT uMaxHeight = 0u;
+        for (size_t i = 0u; i < static_cast<size_t>(uWidth) * uDepth; ++i)
+        {
+            uMaxHeight = std::max<UINT>(uMaxHeight, pColumns[i].Height);
+        }
+
+        m_uSize = std::bit_ceil(std::max({ uWidth, uDepth, uMaxHeight }));
+        buildColumnRanges(pColumns, uNumBlockTypes);
+
+        BOOL bEmpty = FALSE;
+        const VoxelOctreeNode root = classify(0u, 0u, 0u, m_uSize, bEmpty);
+        if (!bEmpty)
+        {
+            m_aNodes.push_back(root);
+            if (root.BlockType == MIXED_BLOCK_TYPE)
+            {
+                buildChildren(NodeBounds{ .uNodeIdx = 0u, .x = 0u, .y = 0u, .z = 0u, .uSize = m_uSize });
+            }
+        }
+
+        m_aColumnRanges.clear();
+        m_aColumnRanges.shrink_to_fit();
+        m_aNodes.shrink_to_fit();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelOctree::GetBlockType
+
+      Summary:  Returns the block type of the cube at a cell
+
+      Args:     INT x, INT y, INT z
+                  Grid cell, may lie outside of the octree
+
+      Returns:  CHAR
+                  Block type, 0 for air
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    CHAR VoxelOctree::GetBlockType(_In_ INT x, _In_ INT y, _In_ INT z) const
+    {
+        if (m_aNodes.empty() || x < 0 || y < 0 || z < 0 ||
+            static_cast<UINT>(x) >= m_uSize || static_cast<UINT>(y) >= m_uSize || static_cast<UINT>(z) >= m_uSize)
+        {
+            return 0;
+        }
+
+        UINT uNodeIdx = 0u;
+        for (UINT uHalf = m_uSize >> 1u; ; uHalf >>= 1u)
+        {
+            const VoxelOctreeNode& node = m_aNodes[uNodeIdx];
+            if (node.ChildMask == 0u)
+            {
+                return node.BlockType;
+            }
+
+            const UINT uOctant = (static_cast<UINT>(x) & uHalf ? 1u : 0u) | (static_cast<UINT>(y) & uHalf ? 2u : 0u) | (static_cast<UINT>(z) & uHalf ? 4u : 0u);
+            const UINT uBit = 1u << uOctant;
+            if (!(node.ChildMask & uBit))
+            {
+                return 0;
+            }
+
+            uNodeIdx = node.FirstChild + static_cast<UINT>(std::popcount(static_cast<UINT>(node.ChildMask) & (uBit - 1u)));
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelOctree::Overlaps
+
+      Summary:  Tests whether any cube lies in a box of cells. Nodes
+                outside of the box are skipped whole
+
+      Args:     const XMINT3& minCell
+                  Lowest cell of the box
+                const XMINT3& maxCell
+                  Cell past the highest cell of the box
+
+      Returns:  BOOL
+                  TRUE if a cube overlaps the box
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL VoxelOctree::Overlaps(_In_ const XMINT3& minCell, _In_ const XMINT3& maxCell) const
+    {
+        if (m_aNodes.empty() || minCell.x >= maxCell.x || minCell.y >= maxCell.y || minCell.z >= maxCell.z)
+        {
+            return FALSE;
+        }
+
+        NodeBounds aStack[MAX_STACK_SIZE];
+        UINT uStackSize = 0u;
+        aStack[uStackSize++] = NodeBounds{ .uNodeIdx = 0u, .x = 0u, .y = 0u, .z = 0u, .uSize = m_uSize };
+        while (uStackSize > 0u)
+        {
+            const NodeBounds bounds = aStack[--uStackSize];
+            if (!overlapsBounds(bounds, minCell, maxCell))
+            {
+                continue;
+            }
+
+            // Every node holds a cube, so a node inside the box needs no split
+            const VoxelOctreeNode& node = m_aNodes[bounds.uNodeIdx];
+            if (node.ChildMask == 0u || containsBounds(bounds, minCell, maxCell))
+            {
+                return TRUE;
+            }
+
+            const UINT uHalf = bounds.uSize >> 1u;
+            UINT uChildIdx = node.FirstChild;
+            for (UINT uOctant = 0u; uOctant < 8u; ++uOctant)
+            {
+                if (node.ChildMask & (1u << uOctant))
+                {
+                    aStack[uStackSize++] = NodeBounds
+                        {
+                            .uNodeIdx = uChildIdx++,
+                            .x = bounds.x + (uOctant & 1u ? uHalf : 0u),
+                            .y = bounds.y + (uOctant & 2u ? uHalf : 0u),
+                            .z = bounds.z + (uOctant & 4u ? uHalf : 0u),
+                            .uSize = uHalf
+                        };
+                }
+            }
+        }
+
+        return FALSE;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelOctree::QueryBox
+
+      Summary:  Appends the leaves that overlap a box of cells. Leaves
+                may stick out of the box
+
+      Args:     const XMINT3& minCell
+                  Lowest cell of the box
+                const XMINT3& maxCell
+                  Cell past the highest cell of the box
+                std::vector<VoxelOctreeLeaf>& aLeaves
+                  Leaves found
+
+      Modifies: [aLeaves].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelOctree::QueryBox(_In_ const XMINT3& minCell, _In_ const XMINT3& maxCell, _Inout_ std::vector<VoxelOctreeLeaf>& aLeaves) const
+    {
+        if (m_aNodes.empty() || minCell.x >= maxCell.x || minCell.y >= maxCell.y || minCell.z >= maxCell.z)
+        {
+            return;
+        }
+
+        NodeBounds aStack[MAX_STACK_SIZE];
+        UINT uStackSize = 0u;
+        aStack[uStackSize++] = NodeBounds{ .uNodeIdx = 0u, .x = 0u, .y = 0u, .z = 0u, .uSize = m_uSize };
+        while (uStackSize > 0u)
+        {
+            const NodeBounds bounds = aStack[--uStackSize];
+            if (!overlapsBounds(bounds, minCell, maxCell))
+            {
+                continue;
+            }
+
+            const VoxelOctreeNode& node = m_aNodes[bounds.uNodeIdx];
+            if (node.ChildMask == 0u)
+            {
+                aLeaves.push_back(VoxelOctreeLeaf
+                    {
+                        .Min = XMUINT3(bounds.x, bounds.y, bounds.z),
+                        .Size = bounds.uSize,
+                        .BlockType = node.BlockType
+                    });
+                continue;
+            }
+
+            const UINT uHalf = bounds.uSize >> 1u;
+            UINT uChildIdx = node.FirstChild;
+            for (UINT uOctant = 0u; uOctant < 8u; ++uOctant)
+            {
+                if (node.ChildMask & (1u << uOctant))
+                {
+                    aStack[uStackSize++] = NodeBounds
+                        {
+                            .uNodeIdx = uChildIdx++,
+                            .x = bounds.x + (uOctant & 1u ? uHalf : 0u),
+                            .y = bounds.y + (uOctant & 2u ? uHalf : 0u),
+                            .z = bounds.z + (uOctant & 4u ? uHalf : 0u),
+                            .uSize = uHalf
+                        };
+                }
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelOctree::RayCast
+
+      Summary:  Finds the first cube hit by a ray. The children of a
+                node are visited in the order the ray enters them, so
+                the first leaf reached is the closest hit and every
+                node behind it is never visited
+
+      Args:     const XMFLOAT3& origin
+                  Start of the ray in cells
+                const XMFLOAT3& direction
+                  Direction of the ray, not necessarily normalized
+                FLOAT maxDistance
+                  Length of the ray in units of direction
+                VoxelRayHit& hit
+                  First cube hit by the ray
+
+      Modifies: [hit].
+
+      Returns:  BOOL
+                  TRUE if the ray hits a cube
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL VoxelOctree::RayCast(_In_ const XMFLOAT3& origin, _In_ const XMFLOAT3& direction, _In_ FLOAT maxDistance, _Out_ VoxelRayHit& hit) const
+    {
+        hit = VoxelRayHit{ .Cell = XMINT3(0, 0, 0), .Normal = XMINT3(0, 0, 0), .Distance = 0.0f, .BlockType = 0 };
+        if (m_aNodes.empty())
+        {
+            return FALSE;
+        }
+
+        const FLOAT aOrigin[3] = { origin.x, origin.y, origin.z };
+        const FLOAT aDirection[3] = { direction.x, direction.y, direction.z };
+        FLOAT aInvDirection[3];
+        for (UINT uAxis = 0u; uAxis < 3u; ++uAxis)
+        {
+            aInvDirection[uAxis] = aDirection[uAxis] != 0.0f ? 1.0f / aDirection[uAxis] : FLT_MAX;
+        }
+
+        // Entry and exit distances of the ray through a cube of cells, and the axis it enters through
+        auto intersect = [&aOrigin, &aInvDirection](_In_ UINT x, _In_ UINT y, _In_ UINT z, _In_ UINT uSize, _Out_ FLOAT& tEnter, _Out_ FLOAT& tExit, _Out_ UINT& uEnterAxis)
+        {
+            const FLOAT aMin[3] = { static_cast<FLOAT>(x), static_cast<FLOAT>(y), static_cast<FLOAT>(z) };
+            tEnter = -FLT_MAX;
+            tExit = FLT_MAX;
+            uEnterAxis = 0u;
+            for (UINT uAxis = 0u; uAxis < 3u; ++uAxis)
+            {
+                FLOAT t0 = (aMin[uAxis] - aOrigin[uAxis]) * aInvDirection[uAxis];
+                FLOAT t1 = (aMin[uAxis] + static_cast<FLOAT>(uSize) - aOrigin[uAxis]) * aInvDirection[uAxis];
+                if (t0 > t1)
+                {
+                    std::swap(t0, t1);
+                }
+                if (t0 > tEnter)
+                {
+                    tEnter = t0;
+                    uEnterAxis = uAxis;
+                }
+                tExit = std::min(tExit, t1);
+            }
+        };
+
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+            Struct:   RayNode
+            Summary:  Node crossed by the ray with its entry distance
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct RayNode
+        {
+            NodeBounds Bounds;
+            FLOAT Enter;
+            UINT EnterAxis;
+        };
+
+        FLOAT tEnter;
+        FLOAT tExit;
+        UINT uEnterAxis;
+        intersect(0u, 0u, 0u, m_uSize, tEnter, tExit, uEnterAxis);
+        if (tEnter > tExit || tExit < 0.0f || tEnter > maxDistance)
+        {
+            return FALSE;
+        }
+
+        RayNode aStack[MAX_STACK_SIZE];
+        UINT uStackSize = 0u;
+        aStack[uStackSize++] = RayNode{ .Bounds = NodeBounds{ .uNodeIdx = 0u, .x = 0u, .y = 0u, .z = 0u, .uSize = m_uSize }, .Enter = tEnter, .EnterAxis = uEnterAxis };
+        while (uStackSize > 0u)
+        {
+            const RayNode rayNode = aStack[--uStackSize];
+
+            const NodeBounds& bounds = rayNode.Bounds;
+            const VoxelOctreeNode& node = m_aNodes[bounds.uNodeIdx];
+            if (node.ChildMask == 0u)
+            {
+                const FLOAT distance = std::max(rayNode.Enter, 0.0f);
+                const UINT aMin[3] = { bounds.x, bounds.y, bounds.z };
+                INT aCell[3];
+                INT aNormal[3] = { 0, 0, 0 };
+                for (UINT uAxis = 0u; uAxis < 3u; ++uAxis)
+                {
+                    const INT iMin = static_cast<INT>(aMin[uAxis]);
+                    const INT iMax = iMin + static_cast<INT>(bounds.uSize) - 1;
+                    if (rayNode.Enter > 0.0f && uAxis == rayNode.EnterAxis)
+                    {
+                        aCell[uAxis] = aDirection[uAxis] > 0.0f ? iMin : iMax;
+                        aNormal[uAxis] = aDirection[uAxis] > 0.0f ? -1 : 1;
+                    }
+                    else
+                    {
+                        const INT iCell = static_cast<INT>(std::floor(aOrigin[uAxis] + aDirection[uAxis] * distance));
+                        aCell[uAxis] = std::clamp(iCell, iMin, iMax);
+                    }
+                }
+
+                hit = VoxelRayHit
+                {
+                    .Cell = XMINT3(aCell[0], aCell[1], aCell[2]),
+                    .Normal = XMINT3(aNormal[0], aNormal[1], aNormal[2]),
+                    .Distance = distance,
+                    .BlockType = node.BlockType
+                };
+                return TRUE;
+            }
+
+            // Push the children crossed by the ray from the farthest to the closest
+            RayNode aChildren[8];
+            UINT uNumChildren = 0u;
+            const UINT uHalf = bounds.uSize >> 1u;
+            UINT uChildIdx = node.FirstChild;
+            for (UINT uOctant = 0u; uOctant < 8u; ++uOctant)
+            {
+                if (!(node.ChildMask & (1u << uOctant)))
+                {
+                    continue;
+                }
+
+                const NodeBounds childBounds =
+                {
+                    .uNodeIdx = uChildIdx++,
+                    .x = bounds.x + (uOctant & 1u ? uHalf : 0u),
+                    .y = bounds.y + (uOctant & 2u ? uHalf : 0u),
+                    .z = bounds.z + (uOctant & 4u ? uHalf : 0u),
+                    .uSize = uHalf
+                };
+                intersect(childBounds.x, childBounds.y, childBounds.z, uHalf, tEnter, tExit, uEnterAxis);
+                if (tEnter > tExit || tExit < 0.0f || tEnter > maxDistance)
+                {
+                    continue;
+                }
+
+                UINT i = uNumChildren++;
+                for (; i > 0u && aChildren[i - 1u].Enter < tEnter; --i)
+                {
+                    aChildren[i] = aChildren[i - 1u];
+                }
+                aChildren[i] = RayNode{ .Bounds = childBounds, .Enter = tEnter, .EnterAxis = uEnterAxis };
+            }
+
+            for (UINT i = 0u; i < uNumChildren; ++i)
+            {
+                aStack[uStackSize++] = aChildren[i];
+            }
+        }
+
+        return FALSE;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelOctree::GetNodes
+
+      Summary:  Returns the nodes, the root first
+
+      Returns:  const std::vector<VoxelOctreeNode>&
+                  Nodes of the octree, empty for a map without cubes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const std::vector<VoxelOctreeNode>& VoxelOctree::GetNodes() const
+    {
+        return m_aNodes;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelOctree::GetSize
+
+      Summary:  Returns the number of cells along an edge of the root
+
+      Returns:  UINT
+                  Power of two size of the root
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT VoxelOctree::GetSize() const
+    {
+        return m_uSize;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelOctree::buildColumnRanges
+
+      Summary:  Builds a pyramid of column ranges. Level k holds the
+                lowest and highest column of each aligned square of
+                2^k x 2^k columns, so a node is classified without
+                reading its columns. Squares that stick out of the map
+                have a lowest column of 0
+
+      Args:     const VoxelColumn* pColumns
+                  Columns of the map
+                size_t uNumBlockTypes
+                  Number of voxels
+
+      Modifies: [m_aColumnRanges].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelOctree::buildColumnRanges(_In_ const VoxelColumn* pColumns, _In_ size_t uNumBlockTypes)
+    {
+        const UINT uNumLevels = static_cast<UINT>(std::bit_width(m_uSize));
+        m_aColumnRanges.assign(uNumLevels, std::vector<ColumnRange>());
+
+        std::vector<ColumnRange>& aBase = m_aColumnRanges[0];
+        aBase.resize(static_cast<size_t>(m_uWidth) * m_uDepth);
+        for (size_t i = 0u; i < aBase.size(); ++i)
+        {
+            const BOOL bValid = static_cast<size_t>(pColumns[i].BlockType) - static_cast<size_t>(eBlockType::GRASSLAND) < uNumBlockTypes;
+            const WORD height = bValid ? pColumns[i].Height : static_cast<WORD>(0u);
+            aBase[i] = ColumnRange{ .MinHeight = height, .MaxHeight = height, .BlockType = pColumns[i].BlockType };
+        }
+
+        for (UINT uLevel = 1u; uLevel < uNumLevels; ++uLevel)
+        {
+            const UINT uPrevWidth = ((m_uWidth - 1u) >> (uLevel - 1u)) + 1u;
+            const UINT uPrevDepth = ((m_uDepth - 1u) >> (uLevel - 1u)) + 1u;
+            const UINT uLevelWidth = ((m_uWidth - 1u) >> uLevel) + 1u;
+            const UINT uLevelDepth = ((m_uDepth - 1u) >> uLevel) + 1u;
+            const std::vector<ColumnRange>& aPrev = m_aColumnRanges[uLevel - 1u];
+            std::vector<ColumnRange>& aLevel = m_aColumnRanges[uLevel];
+            aLevel.resize(static_cast<size_t>(uLevelWidth) * uLevelDepth);
+
+            for (UINT z = 0u; z < uLevelDepth; ++z)
+            {
+                for (UINT x = 0u; x < uLevelWidth; ++x)
+                {
+                    ColumnRange range = { .MinHeight = USHRT_MAX, .MaxHeight = 0u, .BlockType = 0 };
+                    BOOL bFirst = TRUE;
+                    for (UINT uQuadrant = 0u; uQuadrant < 4u; ++uQuadrant)
+                    {
+                        const UINT uPrevX = x * 2u + (uQuadrant & 1u);
+                        const UINT uPrevZ = z * 2u + (uQuadrant >> 1u);
+                        if (uPrevX >= uPrevWidth || uPrevZ >= uPrevDepth)
+                        {
+                            range.MinHeight = 0u;
+                            continue;
+                        }
+
+                        const ColumnRange& prev = aPrev[static_cast<size_t>(uPrevZ) * uPrevWidth + uPrevX];
+                        range.MinHeight = std::min(range.MinHeight, prev.MinHeight);
+                        range.MaxHeight = std::max(range.MaxHeight, prev.MaxHeight);
+                        range.BlockType = bFirst || range.BlockType == prev.BlockType ? prev.BlockType : MIXED_BLOCK_TYPE;
+                        bFirst = FALSE;
+                    }
+                    aLevel[static_cast<size_t>(z) * uLevelWidth + x] = range;
+                }
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelOctree::buildChildren
+
+      Summary:  Appends the non-empty octants of a mixed node next to
+                each other, then splits the mixed ones in turn
+
+      Args:     const NodeBounds& bounds
+                  Mixed node and its cube of cells
+
+      Modifies: [m_aNodes].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelOctree::buildChildren(_In_ const NodeBounds& bounds)
+    {
+        const UINT uHalf = bounds.uSize >> 1u;
+        const UINT uFirstChild = static_cast<UINT>(m_aNodes.size());
+        BYTE childMask = 0u;
+        NodeBounds aMixedChildren[8];
+        UINT uNumMixedChildren = 0u;
+
+        for (UINT uOctant = 0u; uOctant < 8u; ++uOctant)
+        {
+            const UINT x = bounds.x + (uOctant & 1u ? uHalf : 0u);
+            const UINT y = bounds.y + (uOctant & 2u ? uHalf : 0u);
+            const UINT z = bounds.z + (uOctant & 4u ? uHalf : 0u);
+
+            BOOL bEmpty = FALSE;
+            const VoxelOctreeNode child = classify(x, y, z, uHalf, bEmpty);
+            if (bEmpty)
+            {
+                continue;
+            }
+
+            childMask |= static_cast<BYTE>(1u << uOctant);
+            if (child.BlockType == MIXED_BLOCK_TYPE)
+            {
+                aMixedChildren[uNumMixedChildren++] = NodeBounds{ .uNodeIdx = static_cast<UINT>(m_aNodes.size()), .x = x, .y = y, .z = z, .uSize = uHalf };
+            }
+            m_aNodes.push_back(child);
+        }
+
+        m_aNodes[bounds.uNodeIdx].FirstChild = uFirstChild;
+        m_aNodes[bounds.uNodeIdx].ChildMask = childMask;
+        m_aNodes[bounds.uNodeIdx].BlockType = 0;
+
+        for (UINT i = 0u; i < uNumMixedChildren; ++i)
+        {
+            buildChildren(aMixedChildren[i]);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelOctree::classify
+
+      Summary:  Classifies an aligned cube of cells from the column
+                range of its footprint
+
+      Args:     UINT x, UINT y, UINT z
+                  Lowest cell of the cube
+                UINT uSize
+                  Power of two number of cells along an edge
+                BOOL& bEmpty
+                  TRUE if the cube holds no cube of the map
+
+      Returns:  VoxelOctreeNode
+                  Leaf of the block type filling the cube, or a node
+                  with MIXED_BLOCK_TYPE to split further
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    VoxelOctreeNode VoxelOctree::classify(_In_ UINT x, _In_ UINT y, _In_ UINT z, _In_ UINT uSize, _Out_ BOOL& bEmpty) const
+    {
+        VoxelOctreeNode node = { .FirstChild = 0u, .ChildMask = 0u, .BlockType = 0, .Reserved = 0u };
+        bEmpty = TRUE;
+        if (x >= m_uWidth || z >= m_uDepth)
+        {
+            return node;
+        }
+
+        const UINT uLevel = static_cast<UINT>(std::countr_zero(uSize));
+        const UINT uLevelWidth = ((m_uWidth - 1u) >> uLevel) + 1u;
+        const ColumnRange& range = m_aColumnRanges[uLevel][static_cast<size_t>(z >> uLevel) * uLevelWidth + (x >> uLevel)];
+        if (range.MaxHeight <= y)
+        {
+            return node;
+        }
+
+        bEmpty = FALSE;
+        node.BlockType = range.MinHeight >= y + uSize && range.BlockType != MIXED_BLOCK_TYPE ? range.BlockType : MIXED_BLOCK_TYPE;
+        return node;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelOctree::overlapsBounds
+
+      Summary:  Tests whether the cube of a node overlaps a box
+
+      Args:     const NodeBounds& bounds
+                  Node and its cube of cells
+                const XMINT3& minCell
+                  Lowest cell of the box
+                const XMINT3& maxCell
+                  Cell past the highest cell of the box
+
+      Returns:  BOOL
+                  TRUE if they share a cell
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL VoxelOctree::overlapsBounds(_In_ const NodeBounds& bounds, _In_ const XMINT3& minCell, _In_ const XMINT3& maxCell)
+    {
+        const INT64 iSize = static_cast<INT64>(bounds.uSize);
+        return static_cast<INT64>(bounds.x) < maxCell.x && static_cast<INT64>(bounds.x) + iSize > minCell.x &&
+            static_cast<INT64>(bounds.y) < maxCell.y && static_cast<INT64>(bounds.y) + iSize > minCell.y &&
+            static_cast<INT64>(bounds.z) < maxCell.z && static_cast<INT64>(bounds.z) + iSize > minCell.z;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelOctree::containsBounds
+
+      Summary:  Tests whether the cube of a node lies inside a box
+
+      Args:     const NodeBounds& bounds
+                  Node and its cube of cells
+                const XMINT3& minCell
+                  Lowest cell of the box
+                const XMINT3& maxCell
+                  Cell past the highest cell of the box
+
+      Returns:  BOOL
+                  TRUE if every cell of the node is in the box
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL VoxelOctree::containsBounds(_In_ const NodeBounds& bounds, _In_ const XMINT3& minCell, _In_ const XMINT3& maxCell)
+    {
+        const INT64 iSize = static_cast<INT64>(bounds.uSize);
+        return static_cast<INT64>(bounds.x) >= minCell.x && static_cast<INT64>(bounds.x) + iSize <= maxCell.x &&
+            static_cast<INT64>(bounds.y) >= minCell.y && static_cast<INT64>(bounds.y) + iSize <= maxCell.y &&
+            static_cast<INT64>(bounds.z) >= minCell.z && static_cast<INT64>(bounds.z) + iSize <= maxCell.z;
+    }
+}
@@ -0,0 +1,163 @@
+/*+===================================================================
+  File:      VOXELOCTREE.H
+
+  Summary:   VoxelOctree header file contains declarations of the
+             VoxelOctree class that stores the cubes of a voxel map
+             in a sparse octree for point, box and ray queries.
+
+  Classes: VoxelOctree
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Platform.h"
+
+#include <algorithm>
+#include <bit>
+#include <cfloat>
+#include <climits>
+#include <cmath>
+
+#include "Scene/VoxelMap.h"
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+        Struct:   VoxelOctreeNode
+        Summary:  Node of a sparse voxel octree. The children of a node
+                  are stored next to each other from FirstChild, only
+                  for the octants set in ChildMask. A node without
+                  children is a solid cube of BlockType
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct VoxelOctreeNode
+    {
+        UINT FirstChild;
+        BYTE ChildMask;
+        CHAR BlockType;
+        WORD Reserved;
+    };
+
+    static_assert(sizeof(VoxelOctreeNode) == 8u, "VoxelOctreeNode must stay compact");
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+        Struct:   VoxelOctreeLeaf
+        Summary:  Solid cube of a single block type found by a query.
+                  It spans Size grid cells from Min along each axis
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct VoxelOctreeLeaf
+    {
+        XMUINT3 Min;
+        UINT Size;
+        CHAR BlockType;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+        Struct:   VoxelRayHit
+        Summary:  First cube hit by a ray. Normal is the face the ray
+                  entered through, zero when the ray starts inside the
+                  cube. Distance is in units of the ray direction
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct VoxelRayHit
+    {
+        XMINT3 Cell;
+        XMINT3 Normal;
+        FLOAT Distance;
+        CHAR BlockType;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    VoxelOctree
+
+      Summary:  Sparse octree over the grid cells of a voxel map. A
+                cell (x, y, z) spans [x, x + 1) along each axis. Empty
+                octants have no node and solid octants of a single
+                block type are a single leaf, so only the surface of
+                the terrain is subdivided down to single cells
+
+      Methods:  Build
+                  Builds the octree from the columns of a map
+                GetBlockType
+                  Returns the block type of a cell
+                Overlaps
+                  Tests whether a box of cells holds a cube
+                QueryBox
+                  Returns the leaves overlapping a box of cells
+                RayCast
+                  Returns the first cube hit by a ray
+                GetNodes
+                  Returns the nodes
+                GetSize
+                  Returns the number of cells along an edge of the root
+                VoxelOctree
+                  Constructor.
+                ~VoxelOctree
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class VoxelOctree final
+    {
+    public:
+        VoxelOctree();
+        VoxelOctree(const VoxelOctree& other) = delete;
+        VoxelOctree(VoxelOctree&& other) = delete;
+        VoxelOctree& operator=(const VoxelOctree& other) = delete;
+        VoxelOctree& operator=(VoxelOctree&& other) = delete;
+        ~VoxelOctree() = default;
+
+        void Build(_In_ const VoxelColumn* pColumns, _In_ UINT uWidth, _In_ UINT uDepth, _In_ size_t uNumBlockTypes);
+
+        CHAR GetBlockType(_In_ INT x, _In_ INT y, _In_ INT z) const;
+        BOOL Overlaps(_In_ const XMINT3& minCell, _In_ const XMINT3& maxCell) const;
+        void QueryBox(_In_ const XMINT3& minCell, _In_ const XMINT3& maxCell, _Inout_ std::vector<VoxelOctreeLeaf>& aLeaves) const;
+        BOOL RayCast(_In_ const XMFLOAT3& origin, _In_ const XMFLOAT3& direction, _In_ FLOAT maxDistance, _Out_ VoxelRayHit& hit) const;
+
+        const std::vector<VoxelOctreeNode>& GetNodes() const;
+        UINT GetSize() const;
+
+    private:
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+            Struct:   ColumnRange
+            Summary:  Lowest and highest column of an aligned square of
+                      columns, and their block type if they all share
+                      it, else MIXED_BLOCK_TYPE
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct ColumnRange
+        {
+            WORD MinHeight;
+            WORD MaxHeight;
+            CHAR BlockType;
+        };
+
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+            Struct:   NodeBounds
+            Summary:  Node of the octree with its cube of cells
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct NodeBounds
+        {
+            UINT uNodeIdx;
+            UINT x;
+            UINT y;
+            UINT z;
+            UINT uSize;
+        };
+
+        static constexpr const CHAR MIXED_BLOCK_TYPE = -1;
+
+        // Depth-first traversals push at most 7 siblings per level of a
+        // root of up to 2^32 cells
+        static constexpr const UINT MAX_STACK_SIZE = 8u * 33u;
+
+        void buildColumnRanges(_In_ const VoxelColumn* pColumns, _In_ size_t uNumBlockTypes);
+        void buildChildren(_In_ const NodeBounds& bounds);
+        VoxelOctreeNode classify(_In_ UINT x, _In_ UINT y, _In_ UINT z, _In_ UINT uSize, _Out_ BOOL& bEmpty) const;
+        static BOOL overlapsBounds(_In_ const NodeBounds& bounds, _In_ const XMINT3& minCell, _In_ const XMINT3& maxCell);
+        static BOOL containsBounds(_In_ const NodeBounds& bounds, _In_ const XMINT3& minCell, _In_ const XMINT3& maxCell);
+
+    private:
+        std::vector<VoxelOctreeNode> m_aNodes;
+        std::vector<std::vector<ColumnRange>> m_aColumnRanges;
+        UINT m_uWidth;
+        UINT m_uDepth;
+        UINT m_uSize;
+    };
+}
@@ -0,0 +1,359 @@
+#include "Scene/VoxelRayCaster.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelRayCaster::VoxelRayCaster
+
+      Summary:  Constructor
+
+      Modifies: [m_aHeights, m_aBlockHeights, m_uWidth, m_uDepth,
+                 m_uMaxHeight, m_uNumBlockTypes].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    VoxelRayCaster::VoxelRayCaster()
+        : m_aHeights()
+        , m_aBlockHeights()
+        , m_uWidth(0u)
+        , m_uDepth(0u)
+        , m_uMaxHeight(0u)
+        , m_uNumBlockTypes(0u)
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelRayCaster::Build
+
+      Summary:  Builds the heights of the columns and of their blocks
+
+      Args:     const VoxelColumn* pColumns
+                  Columns of the map in row-major (x fastest) order
+                UINT uWidth, UINT uDepth
+                  Number of columns of the map along x and z
+                size_t uNumBlockTypes
+                  Number of block types, starting at GRASSLAND, that
+                  have a voxel
+
+      Modifies: [m_aHeights, m_aBlockHeights, m_uWidth, m_uDepth,
+                 m_uMaxHeight, m_uNumBlockTypes].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelRayCaster::Build(_In_ const VoxelColumn* pColumns, _In_ UINT uWidth, _In_ UINT uDepth, _In_ size_t uNumBlockTypes)
+    {
+        const UINT uBlockWidth = (uWidth + BLOCK_SIZE - 1u) / BLOCK_SIZE;
+        const UINT uBlockDepth = (uDepth + BLOCK_SIZE - 1u) / BLOCK_SIZE;
+
+        m_uWidth = uWidth;
+        m_uDepth = uDepth;
+        m_uNumBlockTypes = uNumBlockTypes;
+        m_aHeights.assign(static_cast<size_t>(uWidth) * uDepth, 0u);
+        m_aBlockHeights.assign(static_cast<size_t>(uBlockWidth) * uBlockDepth, 0u);
+        m_uMaxHeight = 0u;
+
+        for (UINT z = 0u; z < uDepth; ++z)
+        {
+            for (UINT x = 0u; x < uWidth; ++x)
+            {
+                const size_t uColumnIdx = static_cast<size_t>(z) * uWidth + x;
+                const WORD height = getHeight(pColumns[uColumnIdx]);
+                m_aHeights[uColumnIdx] = height;
+
+                WORD& blockHeight = m_aBlockHeights[static_cast<size_t>(z / BLOCK_SIZE) * uBlockWidth + x / BLOCK_SIZE];
+                blockHeight = std::max(blockHeight, height);
+                m_uMaxHeight = std::max<UINT>(m_uMaxHeight, height);
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelRayCaster::Update
+
+      Summary:  Updates the heights of the columns in a rectangle of
+                the map and of the blocks that cover it. The bound of
+                the heights only grows
+
+      Args:     const VoxelColumn* pColumns
+                  Columns of the map in row-major (x fastest) order
+                UINT uX, UINT uZ
+                  First column of the rectangle
+                UINT uWidth, UINT uDepth
+                  Number of columns of the rectangle along x and z,
+                  at least 1, inside the map
+
+      Modifies: [m_aHeights, m_aBlockHeights, m_uMaxHeight].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelRayCaster::Update(_In_ const VoxelColumn* pColumns, _In_ UINT uX, _In_ UINT uZ, _In_ UINT uWidth, _In_ UINT uDepth)
+    {
+        const UINT uEndX = uX + uWidth;
+        const UINT uEndZ = uZ + uDepth;
+        for (UINT z = uZ; z < uEndZ; ++z)
+        {
+            for (UINT x = uX; x < uEndX; ++x)
+            {
+                const size_t uColumnIdx = static_cast<size_t>(z) * m_uWidth + x;
+                const WORD height = getHeight(pColumns[uColumnIdx]);
+                m_aHeights[uColumnIdx] = height;
+                m_uMaxHeight = std::max<UINT>(m_uMaxHeight, height);
+            }
+        }
+
+        const UINT uBlockWidth = (m_uWidth + BLOCK_SIZE - 1u) / BLOCK_SIZE;
+        for (UINT uBlockZ = uZ / BLOCK_SIZE; uBlockZ <= (uEndZ - 1u) / BLOCK_SIZE; ++uBlockZ)
+        {
+            for (UINT uBlockX = uX / BLOCK_SIZE; uBlockX <= (uEndX - 1u) / BLOCK_SIZE; ++uBlockX)
+            {
+                WORD blockHeight = 0u;
+                for (UINT uColumnZ = uBlockZ * BLOCK_SIZE; uColumnZ < std::min((uBlockZ + 1u) * BLOCK_SIZE, m_uDepth); ++uColumnZ)
+                {
+                    for (UINT uColumnX = uBlockX * BLOCK_SIZE; uColumnX < std::min((uBlockX + 1u) * BLOCK_SIZE, m_uWidth); ++uColumnX)
+                    {
+                        blockHeight = std::max(blockHeight, m_aHeights[static_cast<size_t>(uColumnZ) * m_uWidth + uColumnX]);
+                    }
+                }
+                m_aBlockHeights[static_cast<size_t>(uBlockZ) * uBlockWidth + uBlockX] = blockHeight;
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelRayCaster::RayCast
+
+      Summary:  Finds the first cube of the map hit by a ray, walking
+                the columns it crosses one by one with a 2D DDA. The
+                ray is first clipped to the box of the map, and blocks
+                of columns it passes over are skipped whole
+
+      Args:     const VoxelColumn* pColumns
+                  Columns of the map the heights were built from, for
+                  the block type of the cube hit
+                const XMFLOAT3& origin
+                  Start of the ray in cells
+                const XMFLOAT3& direction
+                  Direction of the ray, not necessarily normalized
+                FLOAT maxDistance
+                  Length of the ray in cells
+                VoxelRayHit& hit
+                  Grid cell, face normal and block type of the cube
+                  hit, and its distance in cells
+
+      Modifies: [hit].
+
+      Returns:  BOOL
+                  TRUE if the ray hits a cube
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL VoxelRayCaster::RayCast(_In_ const VoxelColumn* pColumns, _In_ const XMFLOAT3& origin, _In_ const XMFLOAT3& direction, _In_ FLOAT maxDistance, _Out_ VoxelRayHit& hit) const
+    {
+        hit = VoxelRayHit{ .Cell = XMINT3(0, 0, 0), .Normal = XMINT3(0, 0, 0), .Distance = 0.0f, .BlockType = 0 };
+
+        const FLOAT length = std::sqrt(direction.x * direction.x + direction.y * direction.y + direction.z * direction.z);
+        if (m_aHeights.empty() || m_uMaxHeight == 0u || length == 0.0f)
+        {
+            return FALSE;
+        }
+
+        const UINT uBlockWidth = (m_uWidth + BLOCK_SIZE - 1u) / BLOCK_SIZE;
+        const INT aSize[3] = { static_cast<INT>(m_uWidth), static_cast<INT>(m_uMaxHeight), static_cast<INT>(m_uDepth) };
+        const FLOAT aOrigin[3] = { origin.x, origin.y, origin.z };
+        const FLOAT invLength = 1.0f / length;
+        const FLOAT aDirection[3] = { direction.x * invLength, direction.y * invLength, direction.z * invLength };
+        FLOAT aInvDirection[3];
+        INT aStep[3];
+        for (UINT uAxis = 0u; uAxis < 3u; ++uAxis)
+        {
+            aInvDirection[uAxis] = aDirection[uAxis] != 0.0f ? 1.0f / aDirection[uAxis] : FLT_MAX;
+            aStep[uAxis] = aDirection[uAxis] > 0.0f ? 1 : (aDirection[uAxis] < 0.0f ? -1 : 0);
+        }
+
+        FLOAT t = 0.0f;
+        FLOAT tExit = maxDistance;
+        UINT uEnterAxis = 3u;
+        for (UINT uAxis = 0u; uAxis < 3u; ++uAxis)
+        {
+            if (aStep[uAxis] == 0)
+            {
+                if (aOrigin[uAxis] < 0.0f || aOrigin[uAxis] >= static_cast<FLOAT>(aSize[uAxis]))
+                {
+                    return FALSE;
+                }
+                continue;
+            }
+
+            const FLOAT tNear = ((aStep[uAxis] > 0 ? 0.0f : static_cast<FLOAT>(aSize[uAxis])) - aOrigin[uAxis]) * aInvDirection[uAxis];
+            const FLOAT tFar = ((aStep[uAxis] > 0 ? static_cast<FLOAT>(aSize[uAxis]) : 0.0f) - aOrigin[uAxis]) * aInvDirection[uAxis];
+            if (tNear > t)
+            {
+                t = tNear;
+                uEnterAxis = uAxis;
+            }
+            tExit = std::min(tExit, tFar);
+        }
+        if (t > tExit)
+        {
+            return FALSE;
+        }
+
+        // Places the ray in the column it enters at t, through the face of uEnterAxis if any. Rounding
+        // may put the ray a column behind along the other axis, so the columns never move against the
+        // ray, else skipping a block could bring the ray back to the block it came from
+        const INT iStepX = aStep[0];
+        const INT iStepZ = aStep[2];
+        const FLOAT deltaX = std::fabs(aInvDirection[0]);
+        const FLOAT deltaZ = std::fabs(aInvDirection[2]);
+        const FLOAT originY = aOrigin[1];
+        const FLOAT directionY = aDirection[1];
+        INT x = iStepX < 0 ? aSize[0] - 1 : 0;
+        INT z = iStepZ < 0 ? aSize[2] - 1 : 0;
+        FLOAT nextX = FLT_MAX;
+        FLOAT nextZ = FLT_MAX;
+        UINT uLastAxis = uEnterAxis;
+        auto enterColumn = [&](_In_ FLOAT tEnter, _In_ UINT uAxisEntered, _In_ UINT uAxis, _Inout_ INT& iColumn, _Out_ FLOAT& next)
+        {
+            const FLOAT position = aOrigin[uAxis] + aDirection[uAxis] * tEnter;
+            if (uAxis == uAxisEntered)
+            {
+                iColumn = static_cast<INT>(position + 0.5f) - (aStep[uAxis] < 0 ? 1 : 0);
+            }
+            else
+            {
+                // Truncating instead of flooring is the same once clamped, and much cheaper than a call
+                const INT iPositionColumn = std::clamp(static_cast<INT>(position), 0, aSize[uAxis] - 1);
+                iColumn = aStep[uAxis] > 0 ? std::max(iPositionColumn, iColumn) : (aStep[uAxis] < 0 ? std::min(iPositionColumn, iColumn) : iPositionColumn);
+            }
+            next = aStep[uAxis] != 0 ? (static_cast<FLOAT>(iColumn + (aStep[uAxis] > 0 ? 1 : 0)) - aOrigin[uAxis]) * aInvDirection[uAxis] : FLT_MAX;
+        };
+        enterColumn(t, uEnterAxis, 0u, x, nextX);
+        enterColumn(t, uEnterAxis, 2u, z, nextZ);
+
+        // Walks the blocks of columns the ray crosses, skipping those it stays above
+        while (static_cast<UINT>(x) < m_uWidth && static_cast<UINT>(z) < m_uDepth)
+        {
+            const UINT uBlockX = static_cast<UINT>(x) / BLOCK_SIZE;
+            const UINT uBlockZ = static_cast<UINT>(z) / BLOCK_SIZE;
+            const FLOAT tBlockExitX = iStepX != 0 ? (static_cast<FLOAT>(iStepX > 0 ? std::min((uBlockX + 1u) * BLOCK_SIZE, m_uWidth) : uBlockX * BLOCK_SIZE) - aOrigin[0]) * aInvDirection[0] : FLT_MAX;
+            const FLOAT tBlockExitZ = iStepZ != 0 ? (static_cast<FLOAT>(iStepZ > 0 ? std::min((uBlockZ + 1u) * BLOCK_SIZE, m_uDepth) : uBlockZ * BLOCK_SIZE) - aOrigin[2]) * aInvDirection[2] : FLT_MAX;
+            const FLOAT tBlockExit = std::min(tBlockExitX, tBlockExitZ);
+            const FLOAT tBlockEnd = std::min(tBlockExit, tExit);
+            const FLOAT blockHeight = static_cast<FLOAT>(m_aBlockHeights[static_cast<size_t>(uBlockZ) * uBlockWidth + uBlockX]);
+            if (originY + directionY * (directionY < 0.0f ? tBlockEnd : t) >= blockHeight)
+            {
+                if (tBlockExit > tExit)
+                {
+                    return FALSE;
+                }
+
+                t = tBlockExit;
+                uLastAxis = tBlockExitX < tBlockExitZ ? 0u : 2u;
+                enterColumn(t, uLastAxis, 0u, x, nextX);
+                enterColumn(t, uLastAxis, 2u, z, nextZ);
+                continue;
+            }
+
+            // Walks the columns of the block. Columns are solid from the ground up, so the ray hits
+            // a column where it is lowest in it: where it enters, or on the top face on the way down.
+            // Leaving the block is told by the distance, the next block being found from the column
+            for (;;)
+            {
+                const size_t uColumnIdx = static_cast<size_t>(z) * m_uWidth + static_cast<size_t>(x);
+                const FLOAT enterHeight = originY + directionY * t;
+                const FLOAT lowestHeight = directionY < 0.0f ? originY + directionY * std::min(std::min(nextX, nextZ), tExit) : enterHeight;
+                const WORD height = m_aHeights[uColumnIdx];
+                if (lowestHeight < static_cast<FLOAT>(height) && height > 0u)
+                {
+                    const INT iHeight = static_cast<INT>(height);
+                    const BOOL bTopFace = enterHeight >= static_cast<FLOAT>(iHeight);
+                    INT aNormal[3] = { 0, 0, 0 };
+                    if (bTopFace)
+                    {
+                        aNormal[1] = 1;
+                    }
+                    else if (uLastAxis < 3u)
+                    {
+                        aNormal[uLastAxis] = -aStep[uLastAxis];
+                    }
+
+                    hit = VoxelRayHit
+                    {
+                        .Cell = XMINT3(x, bTopFace ? iHeight - 1 : std::clamp(static_cast<INT>(enterHeight), 0, iHeight - 1), z),
+                        .Normal = XMINT3(aNormal[0], aNormal[1], aNormal[2]),
+                        .Distance = bTopFace ? (static_cast<FLOAT>(iHeight) - originY) * aInvDirection[1] : t,
+                        .BlockType = pColumns[uColumnIdx].BlockType
+                    };
+                    return TRUE;
+                }
+
+                if (nextX < nextZ)
+                {
+                    t = nextX;
+                    x += iStepX;
+                    nextX += deltaX;
+                    uLastAxis = 0u;
+                }
+                else
+                {
+                    t = nextZ;
+                    z += iStepZ;
+                    nextZ += deltaZ;
+                    uLastAxis = 2u;
+                }
+
+                if (t >= tBlockEnd || static_cast<UINT>(x) >= m_uWidth || static_cast<UINT>(z) >= m_uDepth)
+                {
+                    if (t > tExit)
+                    {
+                        return FALSE;
+                    }
+                    break;
+                }
+            }
+        }
+
+        return FALSE;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelRayCaster::GetHeights
+
+      Summary:  Returns the heights of the columns
+
+      Returns:  const std::vector<WORD>&
+                  Number of cubes of each column, x fastest, 0 for
+                  block types without a voxel
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const std::vector<WORD>& VoxelRayCaster::GetHeights() const
+    {
+        return m_aHeights;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelRayCaster::GetMaxHeight
+
+      Summary:  Returns an upper bound of the heights of the columns
+
+      Returns:  UINT
+                  Highest column since the last Build
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT VoxelRayCaster::GetMaxHeight() const
+    {
+        return m_uMaxHeight;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelRayCaster::getHeight
+
+      Summary:  Returns the number of solid cells of a column
+
+      Args:     const VoxelColumn& column
+                  Column of the map
+
+      Returns:  WORD
+                  Height of the column, 0 when no voxel matches its
+                  block type
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    WORD VoxelRayCaster::getHeight(_In_ const VoxelColumn& column) const
+    {
+        if (static_cast<size_t>(column.BlockType) - static_cast<size_t>(eBlockType::GRASSLAND) >= m_uNumBlockTypes)
+        {
+            return 0u;
+        }
+
+        return column.Height;
+    }
+}
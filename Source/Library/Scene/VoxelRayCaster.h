@@ -0,0 +1,81 @@
+/*+===================================================================
+  File:      VOXELRAYCASTER.H
+
+  Summary:   VoxelRayCaster header file contains declarations of the
+             VoxelRayCaster class that finds the first cube of a voxel
+             map hit by a ray, without Direct3D.
+
+  Classes: VoxelRayCaster
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Platform.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#include "Scene/VoxelMap.h"
+#include "Scene/VoxelOctree.h"
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    VoxelRayCaster
+
+      Summary:  Heights of the columns of a voxel map that rays walk
+                with a 2D DDA. A cell (x, y, z) spans [x, x + 1) along
+                each axis and is solid below the height of its column,
+                columns of block types without a voxel having none.
+                Each block of BLOCK_SIZE x BLOCK_SIZE columns keeps its
+                highest column so rays skip the blocks they pass over
+
+      Methods:  Build
+                  Builds the heights from the columns of a map
+                Update
+                  Updates the heights over a rectangle of the map
+                RayCast
+                  Returns the first cube hit by a ray
+                GetHeights
+                  Returns the heights of the columns
+                GetMaxHeight
+                  Returns an upper bound of the heights
+                VoxelRayCaster
+                  Constructor.
+                ~VoxelRayCaster
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class VoxelRayCaster final
+    {
+    public:
+        static constexpr const UINT BLOCK_SIZE = 16u;
+
+    public:
+        VoxelRayCaster();
+        VoxelRayCaster(const VoxelRayCaster& other) = delete;
+        VoxelRayCaster(VoxelRayCaster&& other) = delete;
+        VoxelRayCaster& operator=(const VoxelRayCaster& other) = delete;
+        VoxelRayCaster& operator=(VoxelRayCaster&& other) = delete;
+        ~VoxelRayCaster() = default;
+
+        void Build(_In_ const VoxelColumn* pColumns, _In_ UINT uWidth, _In_ UINT uDepth, _In_ size_t uNumBlockTypes);
+        void Update(_In_ const VoxelColumn* pColumns, _In_ UINT uX, _In_ UINT uZ, _In_ UINT uWidth, _In_ UINT uDepth);
+        BOOL RayCast(_In_ const VoxelColumn* pColumns, _In_ const XMFLOAT3& origin, _In_ const XMFLOAT3& direction, _In_ FLOAT maxDistance, _Out_ VoxelRayHit& hit) const;
+
+        const std::vector<WORD>& GetHeights() const;
+        UINT GetMaxHeight() const;
+
+    private:
+        WORD getHeight(_In_ const VoxelColumn& column) const;
+
+    private:
+        std::vector<WORD> m_aHeights;
+        std::vector<WORD> m_aBlockHeights;
+        UINT m_uWidth;
+        UINT m_uDepth;
+        UINT m_uMaxHeight;
+        size_t m_uNumBlockTypes;
+    };
+}
@@ -0,0 +1,144 @@
+#include "Scene/VoxelSlotAllocator.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelSlotAllocator::VoxelSlotAllocator
+
+      Summary:  Constructor
+
+      Modifies: [m_aFreeRanges, m_uNumSlots].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    VoxelSlotAllocator::VoxelSlotAllocator()
+        : m_aFreeRanges()
+        , m_uNumSlots(0u)
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelSlotAllocator::Allocate
+
+      Summary:  Takes slots from the first free range large enough,
+                or from the end of the used slots. The instance buffer
+                must grow when the end passes it
+
+      Args:     UINT uNumSlots
+                  Number of slots, at least 1
+
+      Modifies: [m_aFreeRanges, m_uNumSlots].
+
+      Returns:  VoxelSlotRange
+                  Slots taken
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    VoxelSlotRange VoxelSlotAllocator::Allocate(_In_ UINT uNumSlots)
+    {
+        for (auto it = m_aFreeRanges.begin(); it != m_aFreeRanges.end(); ++it)
+        {
+            if (it->uNumSlots >= uNumSlots)
+            {
+                const VoxelSlotRange slots = { .uFirstSlot = it->uFirstSlot, .uNumSlots = uNumSlots };
+                it->uFirstSlot += uNumSlots;
+                it->uNumSlots -= uNumSlots;
+                if (it->uNumSlots == 0u)
+                {
+                    m_aFreeRanges.erase(it);
+                }
+                return slots;
+            }
+        }
+
+        const VoxelSlotRange slots = { .uFirstSlot = m_uNumSlots, .uNumSlots = uNumSlots };
+        m_uNumSlots += uNumSlots;
+        return slots;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelSlotAllocator::Free
+
+      Summary:  Gives slots back, merging them with the free ranges
+                right before and after them. Slots that end up at the
+                end of the used slots move the end back
+
+      Args:     const VoxelSlotRange& slots
+                  Slots taken by Allocate and not freed yet, possibly
+                  empty
+
+      Modifies: [m_aFreeRanges, m_uNumSlots].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelSlotAllocator::Free(_In_ const VoxelSlotRange& slots)
+    {
+        if (slots.uNumSlots == 0u)
+        {
+            return;
+        }
+
+        auto it = std::lower_bound(m_aFreeRanges.begin(), m_aFreeRanges.end(), slots.uFirstSlot, [](_In_ const VoxelSlotRange& range, _In_ UINT uFirstSlot)
+        {
+            return range.uFirstSlot < uFirstSlot;
+        });
+
+        VoxelSlotRange merged = slots;
+        if (it != m_aFreeRanges.begin() && std::prev(it)->uFirstSlot + std::prev(it)->uNumSlots == merged.uFirstSlot)
+        {
+            it = std::prev(it);
+            merged.uFirstSlot = it->uFirstSlot;
+            merged.uNumSlots += it->uNumSlots;
+            it = m_aFreeRanges.erase(it);
+        }
+        if (it != m_aFreeRanges.end() && merged.uFirstSlot + merged.uNumSlots == it->uFirstSlot)
+        {
+            merged.uNumSlots += it->uNumSlots;
+            it = m_aFreeRanges.erase(it);
+        }
+
+        // Only the last free range can reach the end
+        if (merged.uFirstSlot + merged.uNumSlots == m_uNumSlots)
+        {
+            m_uNumSlots = merged.uFirstSlot;
+            return;
+        }
+
+        m_aFreeRanges.insert(it, merged);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelSlotAllocator::Reset
+
+      Summary:  Frees every slot
+
+      Modifies: [m_aFreeRanges, m_uNumSlots].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelSlotAllocator::Reset()
+    {
+        m_aFreeRanges.clear();
+        m_uNumSlots = 0u;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelSlotAllocator::GetNumSlots
+
+      Summary:  Returns the end of the used slots
+
+      Returns:  UINT
+                  Slot past the last one taken
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT VoxelSlotAllocator::GetNumSlots() const
+    {
+        return m_uNumSlots;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelSlotAllocator::GetFreeRanges
+
+      Summary:  Returns the free ranges below the end of the used
+                slots
+
+      Returns:  const std::vector<VoxelSlotRange>&
+                  Free ranges sorted by first slot, none touching
+                  another
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const std::vector<VoxelSlotRange>& VoxelSlotAllocator::GetFreeRanges() const
+    {
+        return m_aFreeRanges;
+    }
+}
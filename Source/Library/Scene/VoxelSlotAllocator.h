@@ -0,0 +1,79 @@
+/*+===================================================================
+  File:      VOXELSLOTALLOCATOR.H
+
+  Summary:   VoxelSlotAllocator header file contains declarations of
+             the VoxelSlotAllocator class that hands out ranges of
+             slots of the instance buffer of a voxel map, without
+             Direct3D.
+
+  Classes: VoxelSlotAllocator
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Platform.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+        Struct:   VoxelSlotRange
+        Summary:  Consecutive slots of the instance buffer of the map
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct VoxelSlotRange
+    {
+        UINT uFirstSlot;
+        UINT uNumSlots;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    VoxelSlotAllocator
+
+      Summary:  Ranges of slots of an instance buffer that only grows.
+                The used slots end at GetNumSlots, which is what gets
+                drawn. Freed ranges are kept sorted and merged with
+                their neighbors, so chunks that move leave no run of
+                small holes, and a free range that reaches the end
+                gives its slots back to it
+
+      Methods:  Allocate
+                  Takes a range from the first free range large enough
+                  or from the end of the used slots
+                Free
+                  Gives a range back
+                Reset
+                  Frees every range
+                GetNumSlots
+                  Returns the end of the used slots
+                GetFreeRanges
+                  Returns the free ranges below the end
+                VoxelSlotAllocator
+                  Constructor.
+                ~VoxelSlotAllocator
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class VoxelSlotAllocator final
+    {
+    public:
+        VoxelSlotAllocator();
+        VoxelSlotAllocator(const VoxelSlotAllocator& other) = delete;
+        VoxelSlotAllocator(VoxelSlotAllocator&& other) = delete;
+        VoxelSlotAllocator& operator=(const VoxelSlotAllocator& other) = delete;
+        VoxelSlotAllocator& operator=(VoxelSlotAllocator&& other) = delete;
+        ~VoxelSlotAllocator() = default;
+
+        VoxelSlotRange Allocate(_In_ UINT uNumSlots);
+        void Free(_In_ const VoxelSlotRange& slots);
+        void Reset();
+
+        UINT GetNumSlots() const;
+        const std::vector<VoxelSlotRange>& GetFreeRanges() const;
+
+    private:
+        std::vector<VoxelSlotRange> m_aFreeRanges;
+        UINT m_uNumSlots;
+    };
+}
@@ -0,0 +1,47 @@
+/*+===================================================================
+  File:      TERRAINVERTEXSHADER.H
+
+  Summary:   TerrainVertexShader header file contains declarations of
+             TerrainVertexShader class that reads the patches of the
+             heightfield terrain.
+
+  Classes: TerrainVertexShader
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Shader/VertexShader.h"
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    TerrainVertexShader
+
+      Summary:  Vertex shader of the heightfield terrain. Slot 0 holds
+                the grid of a patch and slot 1 one TerrainPatchData per
+                patch
+
+      Methods:  Initialize
+                  Initializes the vertex shader and the input layout
+                TerrainVertexShader
+                  Constructor.
+                ~TerrainVertexShader
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class TerrainVertexShader : public VertexShader
+    {
+    public:
+        TerrainVertexShader() = delete;
+        TerrainVertexShader(_In_ PCWSTR pszFileName, _In_ PCSTR pszEntryPoint, _In_ PCSTR pszShaderModel);
+        TerrainVertexShader(const TerrainVertexShader& other) = delete;
+        TerrainVertexShader(TerrainVertexShader&& other) = delete;
+        TerrainVertexShader& operator=(const TerrainVertexShader& other) = delete;
+        TerrainVertexShader& operator=(TerrainVertexShader&& other) = delete;
+        virtual ~TerrainVertexShader() = default;
+
+        virtual HRESULT Initialize(_In_ ID3D11Device* pDevice) override;
+    };
+}
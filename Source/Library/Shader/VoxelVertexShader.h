@@ -0,0 +1,46 @@
+/*+===================================================================
+  File:      VOXELVERTEXSHADER.H
+
+  Summary:   VoxelVertexShader header file contains declarations of
+             VoxelVertexShader class that reads the packed instances
+             of the voxel map.
+
+  Classes: VoxelVertexShader
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Shader/VertexShader.h"
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    VoxelVertexShader
+
+      Summary:  Vertex shader of the voxel cubes. Slot 2 holds one
+                8-byte InstanceData per cube instead of a matrix
+
+      Methods:  Initialize
+                  Initializes the vertex shader and the input layout
+                VoxelVertexShader
+                  Constructor.
+                ~VoxelVertexShader
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class VoxelVertexShader : public VertexShader
+    {
+    public:
+        VoxelVertexShader() = delete;
+        VoxelVertexShader(_In_ PCWSTR pszFileName, _In_ PCSTR pszEntryPoint, _In_ PCSTR pszShaderModel);
+        VoxelVertexShader(const VoxelVertexShader& other) = delete;
+        VoxelVertexShader(VoxelVertexShader&& other) = delete;
+        VoxelVertexShader& operator=(const VoxelVertexShader& other) = delete;
+        VoxelVertexShader& operator=(VoxelVertexShader&& other) = delete;
+        virtual ~VoxelVertexShader() = default;
+
+        virtual HRESULT Initialize(_In_ ID3D11Device* pDevice) override;
+    };
+}
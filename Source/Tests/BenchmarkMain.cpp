@@ -0,0 +1,30 @@
+/*+===================================================================
+  File:      BENCHMARKMAIN.CPP
+
+  Summary:   Runs the registered benchmarks, or the ones whose name
+             contains the first argument. Each benchmark prints its
+             own timings and checks that its results are right.
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#include "Test.h"
+
+#include <cstring>
+
+int main(int argc, char** argv)
+{
+    const char* pszFilter = argc > 1 ? argv[1] : "";
+
+    for (const test::TestCase& benchmark : test::GetBenchmarks())
+    {
+        if (!std::strstr(benchmark.pszName, pszFilter))
+        {
+            continue;
+        }
+
+        std::printf("%s\n", benchmark.pszName);
+        benchmark.pfnRun();
+    }
+
+    return test::GetNumFailures() == 0u ? 0 : 1;
+}
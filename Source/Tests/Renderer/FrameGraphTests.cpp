@@ -0,0 +1,324 @@
+#include "Test.h"
+
+#include "Renderer/FrameGraph.h"
+#include "Renderer/RecordingRenderContext.h"
+
+using namespace library;
+
+namespace
+{
+    constexpr const FrameGraphTextureDesc HDR_DESC = { .uWidth = 1280u, .uHeight = 720u, .format = static_cast<DXGI_FORMAT>(10), .uBytesPerTexel = 8u };
+    constexpr const FrameGraphTextureDesc HALF_DESC = { .uWidth = 640u, .uHeight = 360u, .format = static_cast<DXGI_FORMAT>(10), .uBytesPerTexel = 8u };
+    constexpr const FrameGraphTextureDesc DEPTH_DESC = { .uWidth = 1280u, .uHeight = 720u, .format = static_cast<DXGI_FORMAT>(40), .uBytesPerTexel = 4u };
+
+    // A distinct non-null Direct3D object for every id, only ever compared
+    template <typename T>
+    T* getObject(_In_ UINT uId)
+    {
+        return reinterpret_cast<T*>(static_cast<std::uintptr_t>(uId + 1u) * 16u);
+    }
+
+    // Views of a texture, the render target and shader resource views of the same texture share an address
+    FrameGraphViews getViews(_In_ UINT uId)
+    {
+        return FrameGraphViews{
+            .pRenderTargetView = getObject<ID3D11RenderTargetView>(uId),
+            .pDepthStencilView = getObject<ID3D11DepthStencilView>(uId),
+            .pShaderResourceView = getObject<ID3D11ShaderResourceView>(uId)
+        };
+    }
+
+    UINT importBackBuffer(_Inout_ FrameGraph& graph)
+    {
+        return graph.ImportTexture(L"BackBuffer", FrameGraphViews{ .pRenderTargetView = getObject<ID3D11RenderTargetView>(0u), .pDepthStencilView = nullptr, .pShaderResourceView = nullptr }, TRUE);
+    }
+}
+
+TEST(FrameGraphCullsPassesNothingNeeds)
+{
+    FrameGraph graph;
+    const UINT uBackBuffer = importBackBuffer(graph);
+    const UINT uHistory = graph.ImportTexture(L"History", getViews(1u), FALSE);
+    const UINT uScene = graph.CreateTexture(L"Scene", HDR_DESC);
+    const UINT uDepth = graph.CreateTexture(L"Depth", DEPTH_DESC);
+    const UINT uUnread = graph.CreateTexture(L"Unread", HDR_DESC);
+    const UINT uReadBack = graph.CreateTexture(L"ReadBack", HALF_DESC);
+
+    const UINT uGeometry = graph.AddPass(L"Geometry", nullptr);
+    graph.Write(uGeometry, uScene, eFrameGraphUsage::RENDER_TARGET, FALSE);
+    graph.Write(uGeometry, uDepth, eFrameGraphUsage::DEPTH_STENCIL, FALSE);
+
+    // Written and never read
+    const UINT uDebug = graph.AddPass(L"Debug", nullptr);
+    graph.Write(uDebug, uUnread, eFrameGraphUsage::RENDER_TARGET, FALSE);
+    graph.Read(uDebug, uDepth, 0u);
+
+    // An imported texture that is not an output
+    const UINT uStoreHistory = graph.AddPass(L"StoreHistory", nullptr);
+    graph.Read(uStoreHistory, uScene, 0u);
+    graph.Write(uStoreHistory, uHistory, eFrameGraphUsage::RENDER_TARGET, FALSE);
+
+    // Kept by its side effects, with the pass it depends on
+    const UINT uDownsample = graph.AddPass(L"Downsample", nullptr);
+    graph.Read(uDownsample, uDepth, 0u);
+    graph.Write(uDownsample, uReadBack, eFrameGraphUsage::RENDER_TARGET, FALSE);
+    const UINT uCopyToCpu = graph.AddPass(L"CopyToCpu", nullptr);
+    graph.Read(uCopyToCpu, uReadBack, 0u);
+    graph.SetSideEffects(uCopyToCpu);
+
+    // The first write of the output is replaced by the second, which the last pass draws over
+    const UINT uClear = graph.AddPass(L"Clear", nullptr);
+    graph.Write(uClear, uBackBuffer, eFrameGraphUsage::RENDER_TARGET, FALSE);
+    const UINT uTonemap = graph.AddPass(L"Tonemap", nullptr);
+    graph.Read(uTonemap, uScene, 0u);
+    graph.Write(uTonemap, uBackBuffer, eFrameGraphUsage::RENDER_TARGET, FALSE);
+    const UINT uOverlay = graph.AddPass(L"Overlay", nullptr);
+    graph.Write(uOverlay, uBackBuffer, eFrameGraphUsage::RENDER_TARGET, TRUE);
+
+    CHECK(graph.Compile());
+    const UINT auExpected[] = { uGeometry, uDownsample, uCopyToCpu, uTonemap, uOverlay };
+    CHECK_EQUAL(static_cast<UINT>(std::size(auExpected)), graph.GetNumExecutedPasses());
+    for (UINT i = 0u; i < graph.GetNumExecutedPasses() && i < std::size(auExpected); ++i)
+    {
+        CHECK_EQUAL(auExpected[i], graph.GetExecutedPass(i));
+    }
+    CHECK(graph.IsPassCulled(uDebug));
+    CHECK(graph.IsPassCulled(uStoreHistory));
+    CHECK(graph.IsPassCulled(uClear));
+    CHECK(!graph.IsPassCulled(uGeometry));
+    CHECK(std::wstring(graph.GetPassName(uTonemap)) == L"Tonemap");
+
+    // The textures of culled passes take no memory
+    CHECK_EQUAL(8u, graph.GetStats().uNumPasses);
+    CHECK_EQUAL(3u, graph.GetStats().uNumCulledPasses);
+    CHECK_EQUAL(3u, graph.GetStats().uNumTransientTextures);
+    CHECK_EQUAL(FrameGraph::INVALID_INDEX, graph.GetPhysicalTexture(uUnread));
+    CHECK(graph.GetViews(uUnread).pRenderTargetView == nullptr);
+
+    // Without an output or side effects nothing is kept
+    FrameGraph emptyGraph;
+    const UINT uTexture = emptyGraph.CreateTexture(L"Texture", HDR_DESC);
+    emptyGraph.Write(emptyGraph.AddPass(L"Pass", nullptr), uTexture, eFrameGraphUsage::RENDER_TARGET, FALSE);
+    CHECK(emptyGraph.Compile());
+    CHECK_EQUAL(0u, emptyGraph.GetNumExecutedPasses());
+    CHECK_EQUAL(0u, emptyGraph.GetNumPhysicalTextures());
+}
+
+TEST(FrameGraphRejectsInvalidGraphs)
+{
+    // Builds a graph of a pass writing the back buffer, then lets a test add the passes to check
+    auto compile = [](_In_ const std::function<void(FrameGraph&, UINT)>& addPasses)
+    {
+        FrameGraph graph;
+        const UINT uBackBuffer = importBackBuffer(graph);
+        addPasses(graph, uBackBuffer);
+        return graph.Compile();
+    };
+
+    CHECK(compile([](FrameGraph& graph, UINT uBackBuffer)
+    {
+        const UINT uPass = graph.AddPass(L"Pass", nullptr);
+        graph.Write(uPass, uBackBuffer, eFrameGraphUsage::RENDER_TARGET, TRUE);
+    }));
+
+    // A transient texture read, or drawn over, before any pass wrote it
+    CHECK(!compile([](FrameGraph& graph, UINT uBackBuffer)
+    {
+        const UINT uTexture = graph.CreateTexture(L"Texture", HDR_DESC);
+        const UINT uPass = graph.AddPass(L"Pass", nullptr);
+        graph.Read(uPass, uTexture, 0u);
+        graph.Write(uPass, uBackBuffer, eFrameGraphUsage::RENDER_TARGET, FALSE);
+        graph.Write(graph.AddPass(L"Late", nullptr), uTexture, eFrameGraphUsage::RENDER_TARGET, FALSE);
+    }));
+    CHECK(!compile([](FrameGraph& graph, UINT)
+    {
+        const UINT uTexture = graph.CreateTexture(L"Texture", HDR_DESC);
+        graph.Write(graph.AddPass(L"Pass", nullptr), uTexture, eFrameGraphUsage::RENDER_TARGET, TRUE);
+    }));
+
+    // An imported texture has contents before the frame
+    CHECK(compile([](FrameGraph& graph, UINT uBackBuffer)
+    {
+        const UINT uHistory = graph.ImportTexture(L"History", getViews(1u), FALSE);
+        const UINT uPass = graph.AddPass(L"Pass", nullptr);
+        graph.Read(uPass, uHistory, 0u);
+        graph.Write(uPass, uBackBuffer, eFrameGraphUsage::RENDER_TARGET, FALSE);
+    }));
+
+    // A texture read and written by the same pass, or written twice
+    CHECK(!compile([](FrameGraph& graph, UINT uBackBuffer)
+    {
+        const UINT uTexture = graph.CreateTexture(L"Texture", HDR_DESC);
+        graph.Write(graph.AddPass(L"First", nullptr), uTexture, eFrameGraphUsage::RENDER_TARGET, FALSE);
+        const UINT uPass = graph.AddPass(L"Pass", nullptr);
+        graph.Read(uPass, uTexture, 0u);
+        graph.Write(uPass, uTexture, eFrameGraphUsage::RENDER_TARGET, TRUE);
+        graph.Write(uPass, uBackBuffer, eFrameGraphUsage::RENDER_TARGET, FALSE);
+    }));
+    CHECK(!compile([](FrameGraph& graph, UINT uBackBuffer)
+    {
+        const UINT uPass = graph.AddPass(L"Pass", nullptr);
+        graph.Write(uPass, uBackBuffer, eFrameGraphUsage::RENDER_TARGET, FALSE);
+        graph.Write(uPass, uBackBuffer, eFrameGraphUsage::RENDER_TARGET, FALSE);
+    }));
+
+    // Up to MAX_RENDER_TARGETS targets and one depth stencil
+    for (UINT uNumTargets : { FrameGraph::MAX_RENDER_TARGETS, FrameGraph::MAX_RENDER_TARGETS + 1u })
+    {
+        CHECK((uNumTargets <= FrameGraph::MAX_RENDER_TARGETS) == compile([uNumTargets](FrameGraph& graph, UINT uBackBuffer)
+        {
+            const UINT uPass = graph.AddPass(L"Pass", nullptr);
+            graph.Write(uPass, uBackBuffer, eFrameGraphUsage::RENDER_TARGET, FALSE);
+            for (UINT i = 1u; i < uNumTargets; ++i)
+            {
+                graph.Write(uPass, graph.CreateTexture(L"Target", HDR_DESC), eFrameGraphUsage::RENDER_TARGET, FALSE);
+            }
+            graph.Write(uPass, graph.CreateTexture(L"Depth", DEPTH_DESC), eFrameGraphUsage::DEPTH_STENCIL, FALSE);
+        }));
+    }
+    CHECK(!compile([](FrameGraph& graph, UINT uBackBuffer)
+    {
+        const UINT uPass = graph.AddPass(L"Pass", nullptr);
+        graph.Write(uPass, uBackBuffer, eFrameGraphUsage::RENDER_TARGET, FALSE);
+        graph.Write(uPass, graph.CreateTexture(L"Depth", DEPTH_DESC), eFrameGraphUsage::DEPTH_STENCIL, FALSE);
+        graph.Write(uPass, graph.CreateTexture(L"Stencil", DEPTH_DESC), eFrameGraphUsage::DEPTH_STENCIL, FALSE);
+    }));
+
+    // Textures that do not exist and slots out of range
+    CHECK(!compile([](FrameGraph& graph, UINT uBackBuffer)
+    {
+        const UINT uPass = graph.AddPass(L"Pass", nullptr);
+        graph.Read(uPass, uBackBuffer + 1u, 0u);
+        graph.Write(uPass, uBackBuffer, eFrameGraphUsage::RENDER_TARGET, FALSE);
+    }));
+    CHECK(!compile([](FrameGraph& graph, UINT uBackBuffer)
+    {
+        graph.Write(graph.AddPass(L"Pass", nullptr), uBackBuffer + 1u, eFrameGraphUsage::RENDER_TARGET, FALSE);
+    }));
+    CHECK(!compile([](FrameGraph& graph, UINT uBackBuffer)
+    {
+        const UINT uHistory = graph.ImportTexture(L"History", getViews(1u), FALSE);
+        const UINT uPass = graph.AddPass(L"Pass", nullptr);
+        graph.Read(uPass, uHistory, FrameGraph::NUM_SHADER_RESOURCE_SLOTS);
+        graph.Write(uPass, uBackBuffer, eFrameGraphUsage::RENDER_TARGET, FALSE);
+    }));
+}
+
+TEST(FrameGraphAliasesTransientTextures)
+{
+    // A chain of full-resolution passes, with a half-resolution texture living over all of them
+    FrameGraph graph;
+    const UINT uBackBuffer = importBackBuffer(graph);
+    const UINT uA = graph.CreateTexture(L"A", HDR_DESC);
+    const UINT uB = graph.CreateTexture(L"B", HDR_DESC);
+    const UINT uC = graph.CreateTexture(L"C", HDR_DESC);
+    const UINT uD = graph.CreateTexture(L"D", HDR_DESC);
+    const UINT uHalf = graph.CreateTexture(L"Half", HALF_DESC);
+
+    const UINT uFirst = graph.AddPass(L"First", nullptr);
+    graph.Write(uFirst, uA, eFrameGraphUsage::RENDER_TARGET, FALSE);
+    graph.Write(uFirst, uHalf, eFrameGraphUsage::RENDER_TARGET, FALSE);
+    const UINT uSecond = graph.AddPass(L"Second", nullptr);
+    graph.Read(uSecond, uA, 0u);
+    graph.Write(uSecond, uB, eFrameGraphUsage::RENDER_TARGET, FALSE);
+    const UINT uThird = graph.AddPass(L"Third", nullptr);
+    graph.Read(uThird, uB, 0u);
+    graph.Write(uThird, uC, eFrameGraphUsage::RENDER_TARGET, FALSE);
+    const UINT uFourth = graph.AddPass(L"Fourth", nullptr);
+    graph.Read(uFourth, uC, 0u);
+    graph.Write(uFourth, uD, eFrameGraphUsage::RENDER_TARGET, FALSE);
+    const UINT uLast = graph.AddPass(L"Last", nullptr);
+    graph.Read(uLast, uD, 0u);
+    graph.Read(uLast, uHalf, 1u);
+    graph.Write(uLast, uBackBuffer, eFrameGraphUsage::RENDER_TARGET, FALSE);
+    CHECK(graph.Compile());
+
+    // A and C, then B and D, share a texture, the one with another description does not
+    CHECK_EQUAL(3u, graph.GetNumPhysicalTextures());
+    CHECK_EQUAL(graph.GetPhysicalTexture(uA), graph.GetPhysicalTexture(uC));
+    CHECK_EQUAL(graph.GetPhysicalTexture(uB), graph.GetPhysicalTexture(uD));
+    CHECK(graph.GetPhysicalTexture(uA) != graph.GetPhysicalTexture(uB));
+    CHECK(graph.GetPhysicalTexture(uHalf) != graph.GetPhysicalTexture(uA) && graph.GetPhysicalTexture(uHalf) != graph.GetPhysicalTexture(uB));
+    CHECK_EQUAL(FrameGraph::INVALID_INDEX, graph.GetPhysicalTexture(uBackBuffer));
+    CHECK_EQUAL(HALF_DESC.uWidth, graph.GetPhysicalTextureDesc(graph.GetPhysicalTexture(uHalf)).uWidth);
+
+    const UINT64 uFullBytes = 1280ull * 720ull * 8ull;
+    const UINT64 uHalfBytes = 640ull * 360ull * 8ull;
+    CHECK_EQUAL(5u, graph.GetStats().uNumTransientTextures);
+    CHECK_EQUAL(3u, graph.GetStats().uNumPhysicalTextures);
+    CHECK_EQUAL(4u * uFullBytes + uHalfBytes, graph.GetStats().uTransientBytes);
+    CHECK_EQUAL(2u * uFullBytes + uHalfBytes, graph.GetStats().uAllocatedBytes);
+
+    // A texture in use on both sides of another's lifetime keeps its own, and the views follow the physical texture
+    for (UINT uPhysical = 0u; uPhysical < graph.GetNumPhysicalTextures(); ++uPhysical)
+    {
+        graph.SetPhysicalTextureViews(uPhysical, getViews(10u + uPhysical));
+    }
+    CHECK(graph.GetViews(uC).pShaderResourceView == graph.GetViews(uA).pShaderResourceView);
+    CHECK(graph.GetViews(uB).pRenderTargetView == getObject<ID3D11RenderTargetView>(10u + graph.GetPhysicalTexture(uB)));
+}
+
+TEST(FrameGraphUnbindsBeforeWriting)
+{
+    // Two ping-pong blurs over aliased textures, every pass checking the state it runs with
+    FrameGraph graph;
+    test::RecordingRenderContext context;
+    const UINT uBackBuffer = importBackBuffer(graph);
+    const UINT uScene = graph.CreateTexture(L"Scene", HDR_DESC);
+    const UINT uPing = graph.CreateTexture(L"Ping", HDR_DESC);
+    const UINT uPong = graph.CreateTexture(L"Pong", HDR_DESC);
+    const UINT uPing2 = graph.CreateTexture(L"Ping2", HDR_DESC);
+
+    std::vector<UINT> aRunPasses;
+    UINT uNumConflicts = 0u;
+    UINT uNumPasses = 0u;
+    auto addPass = [&](_In_ PCWSTR pszName, _In_ UINT uRead, _In_ UINT uWrite)
+    {
+        const UINT uPass = graph.AddPass(pszName, [&, uPassIdx = uNumPasses]()
+        {
+            // No texture is a target and a shader resource at once
+            for (const auto& [key, value] : context.GetState())
+            {
+                if (key.first == test::eRecordedCall::PS_SHADER_RESOURCES && value.first)
+                {
+                    for (const auto& [otherKey, otherValue] : context.GetState())
+                    {
+                        uNumConflicts += otherKey.first == test::eRecordedCall::RENDER_TARGETS && otherValue.first == value.first ? 1u : 0u;
+                    }
+                }
+            }
+            aRunPasses.push_back(uPassIdx);
+        });
+        if (uRead != FrameGraph::INVALID_INDEX)
+        {
+            // Alternating slots leave the previous input bound when the next target aliases it
+            graph.Read(uPass, uRead, uPass % 2u);
+        }
+        graph.Write(uPass, uWrite, eFrameGraphUsage::RENDER_TARGET, FALSE);
+        ++uNumPasses;
+        return uPass;
+    };
+    addPass(L"Scene", FrameGraph::INVALID_INDEX, uScene);
+    addPass(L"BlurX", uScene, uPing);
+    addPass(L"BlurY", uPing, uPong);
+    addPass(L"BlurX2", uPong, uPing2);
+    addPass(L"Composite", uPing2, uBackBuffer);
+    CHECK(graph.Compile());
+    CHECK(graph.GetNumPhysicalTextures() == 2u);
+    for (UINT uPhysical = 0u; uPhysical < graph.GetNumPhysicalTextures(); ++uPhysical)
+    {
+        graph.SetPhysicalTextureViews(uPhysical, getViews(10u + uPhysical));
+    }
+
+    graph.Execute(&context);
+
+    CHECK(aRunPasses == std::vector<UINT>({ 0u, 1u, 2u, 3u, 4u }));
+    CHECK_EQUAL(0u, uNumConflicts);
+    CHECK_EQUAL(5u, context.GetNumCalls(test::eRecordedCall::RENDER_TARGETS));
+
+    // Nothing stays bound for the next frame
+    for (const auto& [key, value] : context.GetState())
+    {
+        CHECK(key.first != test::eRecordedCall::PS_SHADER_RESOURCES || value.first == nullptr);
+    }
+}
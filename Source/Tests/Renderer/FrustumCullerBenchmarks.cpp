@@ -0,0 +1,70 @@
+#include "Test.h"
+
+#include <cmath>
+#include <random>
+
+#include "Renderer/FrustumCuller.h"
+
+using namespace library;
+
+namespace
+{
+    // The path FrustumCuller.cpp was built with, the benchmark is built with the same flags
+#if defined(FRUSTUM_CULLER_SCALAR)
+    constexpr const char* PATH_NAME = "scalar";
+#elif defined(__AVX__)
+    constexpr const char* PATH_NAME = "AVX";
+#else
+    constexpr const char* PATH_NAME = "SSE2";
+#endif
+}
+
+BENCHMARK(FrustumCuller100kBoxes)
+{
+    // 100k boxes around a camera at the origin, against a 60 degree frustum from 0.1 to 500
+    constexpr const UINT NUM_BOXES = 100000u;
+    constexpr const FLOAT FOV_Y = 1.0472f;
+    constexpr const FLOAT ASPECT_RATIO = 16.0f / 9.0f;
+    constexpr const FLOAT NEAR_Z = 0.1f;
+    constexpr const FLOAT FAR_Z = 500.0f;
+
+    const FLOAT yScale = 1.0f / std::tan(FOV_Y * 0.5f);
+    const FLOAT range = FAR_Z / (FAR_Z - NEAR_Z);
+    const FLOAT aViewProjection[16] = {
+        yScale / ASPECT_RATIO, 0.0f, 0.0f, 0.0f,
+        0.0f, yScale, 0.0f, 0.0f,
+        0.0f, 0.0f, range, 1.0f,
+        0.0f, 0.0f, -range * NEAR_Z, 0.0f,
+    };
+
+    std::mt19937 random(22u);
+    std::uniform_real_distribution<FLOAT> position(-600.0f, 600.0f);
+    std::uniform_real_distribution<FLOAT> extent(0.0f, 20.0f);
+    FrustumCuller culler;
+    culler.SetViewProjection(aViewProjection);
+    for (UINT i = 0u; i < NUM_BOXES; ++i)
+    {
+        const FLOAT aCenter[3] = { position(random), position(random), position(random) };
+        const FLOAT aExtents[3] = { extent(random), extent(random), extent(random) };
+        culler.AddBox(aCenter, aExtents);
+    }
+
+    const double milliseconds = test::MeasureMilliseconds(50u, [&]()
+    {
+        culler.Cull();
+    });
+
+    // The same boxes are visible whatever the path, the other builds print the same count
+    UINT uNumVisible = 0u;
+    UINT uHash = 0u;
+    for (UINT i = 0u; i < NUM_BOXES; ++i)
+    {
+        uNumVisible += culler.IsVisible(i) ? 1u : 0u;
+        uHash = uHash * 31u + (culler.IsVisible(i) ? i : 0u);
+    }
+    CHECK_EQUAL(uNumVisible, culler.GetNumVisible());
+    CHECK_EQUAL(NUM_BOXES - uNumVisible, culler.GetNumCulled());
+    CHECK(milliseconds < 10.0);
+
+    std::printf("  %-6s  %u boxes  %6.3f ms  %u visible  hash %08x\n", PATH_NAME, NUM_BOXES, milliseconds, uNumVisible, uHash);
+}
@@ -0,0 +1,162 @@
+#include "Test.h"
+
+#include <array>
+#include <cmath>
+#include <random>
+
+#include "Renderer/FrustumCuller.h"
+
+using namespace library;
+
+namespace
+{
+    // Left-handed perspective projection of a camera at the origin looking down +z, as XMMatrixPerspectiveFovLH
+    std::vector<FLOAT> getViewProjection(_In_ FLOAT fovY, _In_ FLOAT aspectRatio, _In_ FLOAT nearZ, _In_ FLOAT farZ)
+    {
+        const FLOAT yScale = 1.0f / std::tan(fovY * 0.5f);
+        const FLOAT range = farZ / (farZ - nearZ);
+        return {
+            yScale / aspectRatio, 0.0f, 0.0f, 0.0f,
+            0.0f, yScale, 0.0f, 0.0f,
+            0.0f, 0.0f, range, 1.0f,
+            0.0f, 0.0f, -range * nearZ, 0.0f,
+        };
+    }
+
+    // The test of a single box, written out separately from the culler
+    BOOL isReferenceVisible(_In_ const FLOAT aPlanes[FrustumCuller::NUM_PLANES][4], _In_reads_(3) const FLOAT* pCenter, _In_reads_(3) const FLOAT* pExtents)
+    {
+        for (UINT uPlane = 0u; uPlane < FrustumCuller::NUM_PLANES; ++uPlane)
+        {
+            FLOAT distance = aPlanes[uPlane][0] * pCenter[0] + aPlanes[uPlane][3];
+            distance += aPlanes[uPlane][1] * pCenter[1];
+            distance += aPlanes[uPlane][2] * pCenter[2];
+            distance += std::fabs(aPlanes[uPlane][0]) * pExtents[0];
+            distance += std::fabs(aPlanes[uPlane][1]) * pExtents[1];
+            distance += std::fabs(aPlanes[uPlane][2]) * pExtents[2];
+            if (!(distance >= 0.0f))
+            {
+                return FALSE;
+            }
+        }
+
+        return TRUE;
+    }
+
+    // Boxes all around the camera, and checks every one of them against the reference
+    void checkRandomBoxes(_In_ UINT uNumBoxes, _In_ UINT uSeed)
+    {
+        const std::vector<FLOAT> aViewProjection = getViewProjection(1.0472f, 16.0f / 9.0f, 0.1f, 500.0f);
+        FLOAT aPlanes[FrustumCuller::NUM_PLANES][4];
+        FrustumCuller::ExtractPlanes(aViewProjection.data(), aPlanes);
+
+        std::mt19937 random(uSeed);
+        std::uniform_real_distribution<FLOAT> position(-600.0f, 600.0f);
+        std::uniform_real_distribution<FLOAT> extent(0.0f, 20.0f);
+        std::vector<std::array<FLOAT, 6>> aBoxes(uNumBoxes);
+        FrustumCuller culler;
+        culler.SetViewProjection(aViewProjection.data());
+        for (std::array<FLOAT, 6>& box : aBoxes)
+        {
+            box = { position(random), position(random), position(random), extent(random), extent(random), extent(random) };
+            culler.AddBox(box.data(), box.data() + 3);
+        }
+        culler.Cull();
+
+        UINT uNumMismatches = 0u;
+        UINT uNumVisible = 0u;
+        for (UINT i = 0u; i < uNumBoxes; ++i)
+        {
+            const BOOL bVisible = isReferenceVisible(aPlanes, aBoxes[i].data(), aBoxes[i].data() + 3);
+            uNumMismatches += culler.IsVisible(i) == bVisible ? 0u : 1u;
+            uNumVisible += bVisible ? 1u : 0u;
+        }
+
+        CHECK_EQUAL(0u, uNumMismatches);
+        CHECK_EQUAL(uNumBoxes, culler.GetNumBoxes());
+        CHECK_EQUAL(uNumVisible, culler.GetNumVisible());
+        CHECK_EQUAL(uNumBoxes - uNumVisible, culler.GetNumCulled());
+    }
+}
+
+TEST(FrustumCullerExtractsPlanes)
+{
+    const std::vector<FLOAT> aViewProjection = getViewProjection(1.5708f, 1.0f, 1.0f, 100.0f);
+    FLOAT aPlanes[FrustumCuller::NUM_PLANES][4];
+    FrustumCuller::ExtractPlanes(aViewProjection.data(), aPlanes);
+
+    // Every normal points into the frustum: a point in it is in front of all of them, and one past each side is behind that one
+    const FLOAT aInside[3] = { 0.0f, 0.0f, 10.0f };
+    const FLOAT aaOutside[FrustumCuller::NUM_PLANES][3] = {
+        { -11.0f, 0.0f, 10.0f }, { 11.0f, 0.0f, 10.0f }, { 0.0f, -11.0f, 10.0f }, { 0.0f, 11.0f, 10.0f }, { 0.0f, 0.0f, 0.5f }, { 0.0f, 0.0f, 110.0f },
+    };
+    for (UINT uPlane = 0u; uPlane < FrustumCuller::NUM_PLANES; ++uPlane)
+    {
+        const FLOAT* pPlane = aPlanes[uPlane];
+        CHECK(pPlane[0] * aInside[0] + pPlane[1] * aInside[1] + pPlane[2] * aInside[2] + pPlane[3] > 0.0f);
+        for (UINT uPoint = 0u; uPoint < FrustumCuller::NUM_PLANES; ++uPoint)
+        {
+            const FLOAT* pPoint = aaOutside[uPoint];
+            const FLOAT distance = pPlane[0] * pPoint[0] + pPlane[1] * pPoint[1] + pPlane[2] * pPoint[2] + pPlane[3];
+            CHECK((distance < 0.0f) == (uPoint == uPlane));
+        }
+    }
+}
+
+TEST(FrustumCullerCullsBoxesOutOfTheFrustum)
+{
+    // A 90 degree frustum from 1 to 100: at z = 10 it spans x and y from -10 to 10
+    const std::vector<FLOAT> aViewProjection = getViewProjection(1.5708f, 1.0f, 1.0f, 100.0f);
+    const FLOAT aaBoxes[][6] = {
+        { 0.0f, 0.0f, 10.0f, 1.0f, 1.0f, 1.0f },     // Inside
+        { 0.0f, 0.0f, -10.0f, 1.0f, 1.0f, 1.0f },    // Behind the camera
+        { -14.0f, 0.0f, 10.0f, 1.0f, 1.0f, 1.0f },   // Left
+        { 0.0f, 14.0f, 10.0f, 1.0f, 1.0f, 1.0f },    // Above
+        { 0.0f, 0.0f, 110.0f, 1.0f, 1.0f, 1.0f },    // Past the far plane
+        { -10.5f, 0.0f, 10.0f, 1.0f, 1.0f, 1.0f },   // Crossing the left plane
+        { 0.0f, 0.0f, 100.5f, 1.0f, 1.0f, 1.0f },    // Crossing the far plane
+        { 0.0f, 0.0f, 0.0f, 200.0f, 200.0f, 200.0f }, // Around the whole frustum
+    };
+    const BOOL abVisible[] = { TRUE, FALSE, FALSE, FALSE, FALSE, TRUE, TRUE, TRUE };
+
+    // Repeated so the boxes go through the blocks of boxes and the last boxes alike
+    FrustumCuller culler;
+    culler.SetViewProjection(aViewProjection.data());
+    for (UINT uRepeat = 0u; uRepeat < 3u; ++uRepeat)
+    {
+        for (const FLOAT* pBox : aaBoxes)
+        {
+            culler.AddBox(pBox, pBox + 3);
+        }
+    }
+    culler.Cull();
+
+    for (UINT i = 0u; i < culler.GetNumBoxes(); ++i)
+    {
+        CHECK_EQUAL(abVisible[i % std::size(abVisible)], culler.IsVisible(i));
+    }
+    CHECK_EQUAL(3u * 4u, culler.GetNumVisible());
+    CHECK_EQUAL(3u * 4u, culler.GetNumCulled());
+
+    // The boxes of the next frame replace them
+    culler.Clear();
+    CHECK_EQUAL(0u, culler.GetNumBoxes());
+    culler.AddBox(aaBoxes[1], aaBoxes[1] + 3);
+    culler.Cull();
+    CHECK_EQUAL(0u, culler.GetNumVisible());
+    CHECK_EQUAL(1u, culler.GetNumCulled());
+}
+
+TEST(FrustumCullerCullsEveryNumberOfBoxes)
+{
+    // Every count of boxes left over after the blocks of 4 and 8
+    for (UINT uNumBoxes = 0u; uNumBoxes < 20u; ++uNumBoxes)
+    {
+        checkRandomBoxes(uNumBoxes, uNumBoxes);
+    }
+}
+
+TEST(FrustumCullerMatchesTheReference)
+{
+    checkRandomBoxes(100000u, 22u);
+}
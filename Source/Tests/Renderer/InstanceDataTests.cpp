@@ -0,0 +1,64 @@
+#include "Test.h"
+
+#include "Renderer/InstanceData.h"
+
+using namespace library;
+
+namespace
+{
+    constexpr const CHAR GRASSLAND = static_cast<CHAR>(eBlockType::GRASSLAND);
+    constexpr const CHAR LAST_BLOCK_TYPE = static_cast<CHAR>(eBlockType::COUNT) - 1;
+
+    BOOL isRoundTrip(_In_ UINT uLod, _In_ UINT x, _In_ UINT y, _In_ UINT z, _In_ CHAR blockType)
+    {
+        UINT aCell[3];
+        UINT uUnpackedLod = ~0u;
+        CHAR unpackedType = 0;
+        const BOOL bSolid = UnpackInstance(PackInstance(uLod, x, y, z, blockType), aCell, uUnpackedLod, unpackedType);
+
+        return bSolid == (blockType != 0) && aCell[0] == x && aCell[1] == y && aCell[2] == z && uUnpackedLod == uLod && unpackedType == blockType;
+    }
+}
+
+TEST(InstanceDataPacksGridBounds)
+{
+    CHECK(isRoundTrip(0u, 0u, 0u, 0u, GRASSLAND));
+    CHECK(isRoundTrip(0u, 0xFFFFu, 0u, 0u, GRASSLAND));
+    CHECK(isRoundTrip(0u, 0u, 0xFFFFu, 0u, GRASSLAND));
+    CHECK(isRoundTrip(0u, 0u, 0u, 0xFFFFu, GRASSLAND));
+    CHECK(isRoundTrip(0u, 0xFFFFu, 0xFFFFu, 0xFFFFu, LAST_BLOCK_TYPE));
+    CHECK(isRoundTrip(0u, 0x8000u, 0x7FFFu, 0x00FFu, GRASSLAND));
+}
+
+TEST(InstanceDataPacksLevelsOfDetail)
+{
+    for (UINT uLod = 0u; uLod < 8u; ++uLod)
+    {
+        CHECK(isRoundTrip(uLod, 0xFFFFu >> uLod, 1234u, 0xFFFFu >> uLod, GRASSLAND));
+    }
+    CHECK(isRoundTrip(0xFFu, 1u, 2u, 3u, GRASSLAND));
+}
+
+TEST(InstanceDataPacksBlockTypes)
+{
+    for (CHAR blockType = GRASSLAND; blockType <= LAST_BLOCK_TYPE; ++blockType)
+    {
+        CHECK(isRoundTrip(3u, 17u, 42u, 65000u, blockType));
+    }
+
+    // The level of detail shares the last component with the block type and must not leak into it
+    InstanceData instance = PackInstance(0xFFu, 0u, 0u, 0u, LAST_BLOCK_TYPE);
+    WORD aGrid[4];
+    std::memcpy(aGrid, &instance, sizeof(aGrid));
+    CHECK_EQUAL(static_cast<WORD>((0xFFu << 8u) | static_cast<UINT>(LAST_BLOCK_TYPE)), aGrid[3]);
+}
+
+TEST(InstanceDataUnpacksAirFromFreeSlots)
+{
+    UINT aCell[3];
+    UINT uLod;
+    CHAR blockType;
+    CHECK(!UnpackInstance(InstanceData{}, aCell, uLod, blockType));
+    CHECK_EQUAL(0, blockType);
+    CHECK(isRoundTrip(2u, 5u, 6u, 7u, 0));
+}
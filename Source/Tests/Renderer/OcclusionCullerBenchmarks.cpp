@@ -0,0 +1,68 @@
+#include "Test.h"
+
+#include "Renderer/OcclusionCuller.h"
+#include "Renderer/OcclusionScene.h"
+
+using namespace library;
+
+namespace
+{
+    // The path OcclusionCuller.cpp was built with, the benchmark is built with the same flags
+#if defined(OCCLUSION_CULLER_SCALAR)
+    constexpr const char* PATH_NAME = "scalar";
+#else
+    constexpr const char* PATH_NAME = "SSE2";
+#endif
+}
+
+BENCHMARK(OcclusionCullerWallsAndGround)
+{
+    // 20000 boxes behind 20 and 60 walls over a ground grid in the default buffer, on one thread
+    constexpr const UINT NUM_BOXES = 20000u;
+
+    for (UINT uNumWalls : { 20u, 60u })
+    {
+        const test::OcclusionScene scene(uNumWalls, NUM_BOXES, 24u);
+        OcclusionCuller culler(OcclusionCuller::DEFAULT_WIDTH, OcclusionCuller::DEFAULT_HEIGHT, 1u);
+        const double rasterizeMilliseconds = test::MeasureMilliseconds(50u, [&]()
+        {
+            culler.Clear();
+            scene.AddOccluders(culler);
+            culler.Rasterize();
+        });
+
+        UINT uNumCulled = 0u;
+        const double testMilliseconds = test::MeasureMilliseconds(20u, [&]()
+        {
+            uNumCulled = 0u;
+            for (const std::array<FLOAT, 6>& box : scene.GetBoxes())
+            {
+                uNumCulled += culler.IsBoxVisible(box.data(), box.data() + 3) ? 0u : 1u;
+            }
+        });
+
+        // Against the brute-force depth buffer, boxes off the buffer are culled by both
+        const test::ReferenceDepthBuffer reference(scene, culler.GetWidth(), culler.GetHeight());
+        UINT uNumOccluded = 0u;
+        UINT uNumCulledOnScreen = 0u;
+        UINT uNumFalseCulls = 0u;
+        for (const std::array<FLOAT, 6>& box : scene.GetBoxes())
+        {
+            if (!reference.IsBoxOnScreen(box))
+            {
+                continue;
+            }
+            const BOOL bCulled = !culler.IsBoxVisible(box.data(), box.data() + 3);
+            const BOOL bOccluded = reference.IsBoxOccluded(box);
+            uNumOccluded += bOccluded ? 1u : 0u;
+            uNumCulledOnScreen += bCulled ? 1u : 0u;
+            uNumFalseCulls += bCulled && !bOccluded ? 1u : 0u;
+        }
+        CHECK_EQUAL(0u, uNumFalseCulls);
+        CHECK(rasterizeMilliseconds < 5.0);
+        CHECK(testMilliseconds < 20.0);
+
+        std::printf("  %-6s  %2u walls  %4u triangles  rasterize %6.3f ms  %u boxes %6.3f ms  %u culled  %u of %u occluded on screen\n",
+            PATH_NAME, uNumWalls, culler.GetNumTriangles(), rasterizeMilliseconds, NUM_BOXES, testMilliseconds, uNumCulled, uNumCulledOnScreen, uNumOccluded);
+    }
+}
@@ -0,0 +1,177 @@
+#include "Test.h"
+
+#include "Renderer/OcclusionCuller.h"
+#include "Renderer/OcclusionScene.h"
+
+using namespace library;
+
+namespace
+{
+    const FLOAT IDENTITY[16] = { 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f };
+
+    // A 90 degree square frustum from 1 to 100 at the origin looking down +z: at z = 10 it spans x and y from -10 to 10
+    const FLOAT VIEW_PROJECTION[16] = {
+        1.0f, 0.0f, 0.0f, 0.0f,
+        0.0f, 1.0f, 0.0f, 0.0f,
+        0.0f, 0.0f, 100.0f / 99.0f, 1.0f,
+        0.0f, 0.0f, -100.0f / 99.0f, 0.0f,
+    };
+
+    // A quad facing the camera at depth z, from minX to maxX and from minY to maxY
+    void addQuad(_Inout_ OcclusionCuller& culler, _In_ FLOAT minX, _In_ FLOAT maxX, _In_ FLOAT minY, _In_ FLOAT maxY, _In_ FLOAT z)
+    {
+        const FLOAT aPositions[4][3] = { { minX, minY, z }, { maxX, minY, z }, { maxX, maxY, z }, { minX, maxY, z } };
+        const WORD auIndices[6] = { 0u, 1u, 2u, 0u, 2u, 3u };
+        culler.AddOccluder(IDENTITY, aPositions[0], sizeof(aPositions[0]), 4u, auIndices, 6u);
+    }
+
+    BOOL isBoxVisible(_In_ const OcclusionCuller& culler, _In_ FLOAT x, _In_ FLOAT y, _In_ FLOAT z, _In_ FLOAT extent)
+    {
+        const FLOAT aCenter[3] = { x, y, z };
+        const FLOAT aExtents[3] = { extent, extent, extent };
+        return culler.IsBoxVisible(aCenter, aExtents);
+    }
+}
+
+TEST(OcclusionCullerCullsBehindAWall)
+{
+    OcclusionCuller culler(128u, 64u, 1u);
+    culler.SetViewProjection(VIEW_PROJECTION);
+
+    // Nothing is drawn: every box on the buffer is visible, boxes off it or crossing the near plane are not tested
+    culler.Rasterize();
+    CHECK(isBoxVisible(culler, 0.0f, 0.0f, 50.0f, 1.0f));
+    CHECK(!isBoxVisible(culler, 100.0f, 0.0f, 50.0f, 1.0f));
+    CHECK(isBoxVisible(culler, 0.0f, 0.0f, 1.0f, 2.0f));
+
+    // A wall over the left half of the view at z = 20
+    addQuad(culler, -40.0f, 0.0f, -40.0f, 40.0f, 20.0f);
+    culler.Rasterize();
+    CHECK_EQUAL(2u, culler.GetNumTriangles());
+    CHECK(!isBoxVisible(culler, -10.0f, 0.0f, 50.0f, 1.0f));
+    CHECK(!isBoxVisible(culler, -10.0f, 5.0f, 25.0f, 2.0f));
+    CHECK(isBoxVisible(culler, -10.0f, 0.0f, 10.0f, 1.0f));
+    CHECK(isBoxVisible(culler, 10.0f, 0.0f, 50.0f, 1.0f));
+    CHECK(isBoxVisible(culler, 0.0f, 0.0f, 50.0f, 1.0f));
+
+    // The box of the wall itself is not culled by it
+    CHECK(isBoxVisible(culler, -20.0f, 0.0f, 20.0f, 0.5f));
+
+    // The depth of the wall, 1 on the other half
+    const FLOAT wallDepth = (20.0f - 1.0f) * 100.0f / 99.0f / 20.0f;
+    for (UINT y = 0u; y < culler.GetHeight(); ++y)
+    {
+        CHECK(std::abs(culler.GetMaxDepth(10u, y) - wallDepth) < 1.0e-5f);
+        CHECK_EQUAL(1.0f, culler.GetMaxDepth(100u, y));
+    }
+
+    // Removed by Clear
+    culler.Clear();
+    culler.Rasterize();
+    CHECK(isBoxVisible(culler, -10.0f, 0.0f, 50.0f, 1.0f));
+}
+
+TEST(OcclusionCullerMergesNearerWalls)
+{
+    OcclusionCuller culler(128u, 64u, 1u);
+    culler.SetViewProjection(VIEW_PROJECTION);
+
+    // Two halves at different depths cover the view together, and the nearer one in front of a farther full wall
+    addQuad(culler, -40.0f, 40.0f, -40.0f, 40.0f, 60.0f);
+    addQuad(culler, -40.0f, 0.0f, -40.0f, 40.0f, 20.0f);
+    addQuad(culler, 0.0f, 40.0f, -40.0f, 40.0f, 30.0f);
+    culler.Rasterize();
+
+    CHECK(!isBoxVisible(culler, -10.0f, 0.0f, 40.0f, 1.0f));
+    CHECK(!isBoxVisible(culler, 10.0f, 0.0f, 40.0f, 1.0f));
+    CHECK(!isBoxVisible(culler, 0.0f, 0.0f, 80.0f, 1.0f));
+    CHECK(isBoxVisible(culler, 10.0f, 0.0f, 25.0f, 1.0f));
+    CHECK(isBoxVisible(culler, -10.0f, 0.0f, 15.0f, 1.0f));
+}
+
+TEST(OcclusionCullerIsConservative)
+{
+    // Walls over a ground grid against a brute-force depth buffer: no pixel is nearer than the scene, no box is culled that is not behind it
+    const test::OcclusionScene scene(20u, 20000u, 24u);
+    OcclusionCuller culler(OcclusionCuller::DEFAULT_WIDTH, OcclusionCuller::DEFAULT_HEIGHT, 1u);
+    scene.AddOccluders(culler);
+    culler.Rasterize();
+    const test::ReferenceDepthBuffer reference(scene, culler.GetWidth(), culler.GetHeight());
+
+    UINT uNumNearerPixels = 0u;
+    UINT uNumCoveredPixels = 0u;
+    for (UINT y = 0u; y < culler.GetHeight(); ++y)
+    {
+        for (UINT x = 0u; x < culler.GetWidth(); ++x)
+        {
+            uNumNearerPixels += culler.GetMaxDepth(x, y) < reference.GetDepth(x, y) - test::ReferenceDepthBuffer::DEPTH_TOLERANCE ? 1u : 0u;
+            uNumCoveredPixels += culler.GetMaxDepth(x, y) < 1.0f ? 1u : 0u;
+        }
+    }
+    CHECK_EQUAL(0u, uNumNearerPixels);
+    CHECK(uNumCoveredPixels > culler.GetWidth() * culler.GetHeight() / 2u);
+
+    UINT uNumFalseCulls = 0u;
+    UINT uNumOccluded = 0u;
+    UINT uNumCulled = 0u;
+    for (const std::array<FLOAT, 6>& box : scene.GetBoxes())
+    {
+        if (!reference.IsBoxOnScreen(box))
+        {
+            continue;
+        }
+
+        const BOOL bCulled = !culler.IsBoxVisible(box.data(), box.data() + 3);
+        const BOOL bOccluded = reference.IsBoxOccluded(box);
+        uNumFalseCulls += bCulled && !bOccluded ? 1u : 0u;
+        uNumOccluded += bOccluded ? 1u : 0u;
+        uNumCulled += bCulled ? 1u : 0u;
+    }
+    CHECK_EQUAL(0u, uNumFalseCulls);
+    CHECK(uNumOccluded > 1000u);
+
+    // A tile keeps one farthest depth per layer, which hides less than the exact buffer where the ground spans a wide range of depths
+    CHECK(uNumCulled * 2u >= uNumOccluded);
+}
+
+TEST(OcclusionCullerIsIndependentOfThreads)
+{
+    const test::OcclusionScene scene(40u, 5000u, 25u);
+    std::vector<FLOAT> aExpectedDepths;
+    std::vector<BOOL> abExpectedVisible;
+    for (UINT uNumThreads : { 1u, 2u, 4u, 7u })
+    {
+        OcclusionCuller culler(OcclusionCuller::DEFAULT_WIDTH, OcclusionCuller::DEFAULT_HEIGHT, uNumThreads);
+        CHECK_EQUAL(uNumThreads, culler.GetNumThreads());
+
+        // Twice, the second frame clears the first
+        for (UINT uFrame = 0u; uFrame < 2u; ++uFrame)
+        {
+            culler.Clear();
+            scene.AddOccluders(culler);
+            culler.Rasterize();
+        }
+
+        std::vector<FLOAT> aDepths;
+        for (UINT y = 0u; y < culler.GetHeight(); ++y)
+        {
+            for (UINT x = 0u; x < culler.GetWidth(); ++x)
+            {
+                aDepths.push_back(culler.GetMaxDepth(x, y));
+            }
+        }
+        std::vector<BOOL> abVisible;
+        for (const std::array<FLOAT, 6>& box : scene.GetBoxes())
+        {
+            abVisible.push_back(culler.IsBoxVisible(box.data(), box.data() + 3));
+        }
+
+        if (aExpectedDepths.empty())
+        {
+            aExpectedDepths = aDepths;
+            abExpectedVisible = abVisible;
+        }
+        CHECK(aDepths == aExpectedDepths);
+        CHECK(abVisible == abExpectedVisible);
+    }
+}
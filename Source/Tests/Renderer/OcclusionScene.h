@@ -0,0 +1,344 @@
+/*+===================================================================
+  File:      OCCLUSIONSCENE.H
+
+  Summary:   OcclusionScene header file contains the synthetic scene
+             of walls over a ground grid that the occlusion culler is
+             tested and benchmarked with, and a brute-force depth
+             buffer of it to check the culler against.
+
+  Classes: OcclusionScene, ReferenceDepthBuffer
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Platform.h"
+
+#include <algorithm>
+#include <array>
+#include <cfloat>
+#include <cmath>
+#include <random>
+
+#include "Renderer/OcclusionCuller.h"
+
+namespace test
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    OcclusionScene
+
+      Summary:  A camera 2 units over a 400 x 400 ground grid looking
+                down +z with a 60 degree 16:9 frustum, walls standing
+                on the ground in front of it as boxes of 12 triangles,
+                and small boxes scattered over the ground to test.
+                Every vertex is in front of the camera, so the
+                triangles need no clipping
+
+      Methods:  GetViewProjection
+                  Returns the row-major view projection matrix
+                GetPositions
+                  Returns the world space positions of the occluders
+                GetIndices
+                  Returns the triangles of the occluders
+                GetBoxes
+                  Returns the center and extents of the boxes
+                AddOccluders
+                  Adds the occluders to a culler
+                OcclusionScene
+                  Constructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class OcclusionScene final
+    {
+    public:
+        static constexpr const UINT GRID_SIZE = 20u;
+
+    public:
+        OcclusionScene(_In_ UINT uNumWalls, _In_ UINT uNumBoxes, _In_ UINT uSeed)
+            : m_aViewProjection()
+            , m_aPositions()
+            , m_aIndices()
+            , m_aBoxes(uNumBoxes)
+        {
+            const FLOAT yScale = 1.0f / std::tan(1.0472f * 0.5f);
+            const FLOAT range = 1000.0f / (1000.0f - 0.1f);
+            m_aViewProjection = {
+                yScale * 9.0f / 16.0f, 0.0f, 0.0f, 0.0f,
+                0.0f, yScale, 0.0f, 0.0f,
+                0.0f, 0.0f, range, 1.0f,
+                0.0f, -2.0f * yScale, -range * 0.1f, 0.0f,
+            };
+
+            for (UINT z = 0u; z <= GRID_SIZE; ++z)
+            {
+                for (UINT x = 0u; x <= GRID_SIZE; ++x)
+                {
+                    m_aPositions.push_back({ -200.0f + 400.0f * x / GRID_SIZE, 0.0f, 1.0f + 400.0f * z / GRID_SIZE });
+                }
+            }
+            for (UINT z = 0u; z < GRID_SIZE; ++z)
+            {
+                for (UINT x = 0u; x < GRID_SIZE; ++x)
+                {
+                    const WORD uCorner = static_cast<WORD>(z * (GRID_SIZE + 1u) + x);
+                    const WORD uAbove = static_cast<WORD>(uCorner + GRID_SIZE + 1u);
+                    m_aIndices.insert(m_aIndices.end(), { uCorner, uAbove, static_cast<WORD>(uCorner + 1u), static_cast<WORD>(uCorner + 1u), uAbove, static_cast<WORD>(uAbove + 1u) });
+                }
+            }
+
+            std::mt19937 random(uSeed);
+            std::uniform_real_distribution<FLOAT> wallX(-60.0f, 60.0f);
+            std::uniform_real_distribution<FLOAT> wallZ(10.0f, 120.0f);
+            std::uniform_real_distribution<FLOAT> wallWidth(4.0f, 20.0f);
+            std::uniform_real_distribution<FLOAT> wallHeight(3.0f, 12.0f);
+            for (UINT uWall = 0u; uWall < uNumWalls; ++uWall)
+            {
+                addBox(wallX(random), wallZ(random), wallWidth(random), wallHeight(random), 1.0f);
+            }
+
+            std::uniform_real_distribution<FLOAT> boxX(-150.0f, 150.0f);
+            std::uniform_real_distribution<FLOAT> boxY(0.0f, 6.0f);
+            std::uniform_real_distribution<FLOAT> boxZ(5.0f, 300.0f);
+            std::uniform_real_distribution<FLOAT> extent(0.2f, 2.0f);
+            for (std::array<FLOAT, 6>& box : m_aBoxes)
+            {
+                box = { boxX(random), boxY(random), boxZ(random), extent(random), extent(random), extent(random) };
+            }
+        }
+
+        const FLOAT* GetViewProjection() const
+        {
+            return m_aViewProjection.data();
+        }
+
+        const std::vector<std::array<FLOAT, 3>>& GetPositions() const
+        {
+            return m_aPositions;
+        }
+
+        const std::vector<WORD>& GetIndices() const
+        {
+            return m_aIndices;
+        }
+
+        const std::vector<std::array<FLOAT, 6>>& GetBoxes() const
+        {
+            return m_aBoxes;
+        }
+
+        void AddOccluders(_Inout_ library::OcclusionCuller& culler) const
+        {
+            const FLOAT aIdentity[16] = { 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f };
+            culler.SetViewProjection(GetViewProjection());
+            culler.AddOccluder(aIdentity, m_aPositions[0].data(), sizeof(m_aPositions[0]), static_cast<UINT>(m_aPositions.size()), m_aIndices.data(), static_cast<UINT>(m_aIndices.size()));
+        }
+
+    private:
+        // A box on the ground of 8 vertices and 12 triangles
+        void addBox(_In_ FLOAT centerX, _In_ FLOAT minZ, _In_ FLOAT width, _In_ FLOAT height, _In_ FLOAT depth)
+        {
+            const WORD uFirst = static_cast<WORD>(m_aPositions.size());
+            for (UINT uCorner = 0u; uCorner < 8u; ++uCorner)
+            {
+                m_aPositions.push_back({ centerX + ((uCorner & 1u) ? 0.5f : -0.5f) * width, (uCorner & 2u) ? height : 0.0f, minZ + ((uCorner & 4u) ? depth : 0.0f) });
+            }
+
+            const WORD auFaces[6][4] = { { 0u, 1u, 3u, 2u }, { 4u, 5u, 7u, 6u }, { 0u, 2u, 6u, 4u }, { 1u, 3u, 7u, 5u }, { 2u, 3u, 7u, 6u }, { 0u, 1u, 5u, 4u } };
+            for (const WORD* puFace : auFaces)
+            {
+                m_aIndices.insert(m_aIndices.end(), {
+                    static_cast<WORD>(uFirst + puFace[0]), static_cast<WORD>(uFirst + puFace[1]), static_cast<WORD>(uFirst + puFace[2]),
+                    static_cast<WORD>(uFirst + puFace[0]), static_cast<WORD>(uFirst + puFace[2]), static_cast<WORD>(uFirst + puFace[3]) });
+            }
+        }
+
+    private:
+        std::vector<FLOAT> m_aViewProjection;
+        std::vector<std::array<FLOAT, 3>> m_aPositions;
+        std::vector<WORD> m_aIndices;
+        std::vector<std::array<FLOAT, 6>> m_aBoxes;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    ReferenceDepthBuffer
+
+      Summary:  Nearest depth of the triangles of a scene at the center
+                of every pixel, found triangle by triangle and pixel by
+                pixel. A pixel center within EDGE_TOLERANCE pixels of a
+                triangle counts as covered, so the reference is never
+                farther than a culler that rounds its edges the other
+                way
+
+      Methods:  GetDepth
+                  Returns the depth of a pixel
+                IsBoxOccluded
+                  Returns whether a box is behind the depth of every
+                  pixel of its screen rectangle
+                IsBoxOnScreen
+                  Returns whether a box is in front of the camera and
+                  its rectangle overlaps the buffer
+                ReferenceDepthBuffer
+                  Constructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class ReferenceDepthBuffer final
+    {
+    public:
+        static constexpr const FLOAT EDGE_TOLERANCE = 0.01f;
+        static constexpr const FLOAT DEPTH_TOLERANCE = 1.0e-5f;
+
+    public:
+        ReferenceDepthBuffer(_In_ const OcclusionScene& scene, _In_ UINT uWidth, _In_ UINT uHeight)
+            : m_aViewProjection(scene.GetViewProjection(), scene.GetViewProjection() + 16)
+            , m_uWidth(uWidth)
+            , m_uHeight(uHeight)
+            , m_aDepths(static_cast<size_t>(uWidth) * uHeight, 1.0f)
+        {
+            const std::vector<std::array<FLOAT, 3>>& aPositions = scene.GetPositions();
+            const std::vector<WORD>& aIndices = scene.GetIndices();
+            for (size_t i = 0u; i + 3u <= aIndices.size(); i += 3u)
+            {
+                FLOAT aX[3];
+                FLOAT aY[3];
+                FLOAT aDepths[3];
+                for (UINT j = 0u; j < 3u; ++j)
+                {
+                    project(aPositions[aIndices[i + j]].data(), aX[j], aY[j], aDepths[j]);
+                }
+
+                const FLOAT area = (aX[1] - aX[0]) * (aY[2] - aY[0]) - (aX[2] - aX[0]) * (aY[1] - aY[0]);
+                if (!(std::abs(area) > 0.0f))
+                {
+                    continue;
+                }
+
+                const INT iMinX = std::max(static_cast<INT>(std::floor(std::max(std::min({ aX[0], aX[1], aX[2] }), -1.0f))), 0);
+                const INT iMaxX = std::min(static_cast<INT>(std::floor(std::min(std::max({ aX[0], aX[1], aX[2] }), static_cast<FLOAT>(uWidth)))), static_cast<INT>(uWidth) - 1);
+                const INT iMinY = std::max(static_cast<INT>(std::floor(std::max(std::min({ aY[0], aY[1], aY[2] }), -1.0f))), 0);
+                const INT iMaxY = std::min(static_cast<INT>(std::floor(std::min(std::max({ aY[0], aY[1], aY[2] }), static_cast<FLOAT>(uHeight)))), static_cast<INT>(uHeight) - 1);
+                for (INT y = iMinY; y <= iMaxY; ++y)
+                {
+                    for (INT x = iMinX; x <= iMaxX; ++x)
+                    {
+                        // Signed distances of the center to the edges, in pixels, all positive inside
+                        const FLOAT centerX = static_cast<FLOAT>(x) + 0.5f;
+                        const FLOAT centerY = static_cast<FLOAT>(y) + 0.5f;
+                        FLOAT aWeights[3];
+                        BOOL bCovered = TRUE;
+                        for (UINT j = 0u; j < 3u; ++j)
+                        {
+                            const UINT uFrom = (j + 1u) % 3u;
+                            const UINT uTo = (j + 2u) % 3u;
+                            const FLOAT edgeX = aX[uTo] - aX[uFrom];
+                            const FLOAT edgeY = aY[uTo] - aY[uFrom];
+                            aWeights[j] = (edgeX * (centerY - aY[uFrom]) - edgeY * (centerX - aX[uFrom])) / area;
+                            const FLOAT distance = aWeights[j] * std::abs(area) / std::sqrt(edgeX * edgeX + edgeY * edgeY);
+                            bCovered = bCovered && distance >= -EDGE_TOLERANCE;
+                        }
+
+                        if (bCovered)
+                        {
+                            const FLOAT depth = aWeights[0] * aDepths[0] + aWeights[1] * aDepths[1] + aWeights[2] * aDepths[2];
+                            FLOAT& pixelDepth = m_aDepths[static_cast<size_t>(y) * uWidth + x];
+                            pixelDepth = std::min(pixelDepth, depth);
+                        }
+                    }
+                }
+            }
+        }
+
+        FLOAT GetDepth(_In_ UINT uX, _In_ UINT uY) const
+        {
+            return m_aDepths[static_cast<size_t>(uY) * m_uWidth + uX];
+        }
+
+        BOOL IsBoxOccluded(_In_ const std::array<FLOAT, 6>& box) const
+        {
+            INT aRect[4];
+            FLOAT minDepth;
+            if (!getRectangle(box, aRect, minDepth))
+            {
+                return FALSE;
+            }
+
+            for (INT y = aRect[1]; y <= aRect[3]; ++y)
+            {
+                for (INT x = aRect[0]; x <= aRect[2]; ++x)
+                {
+                    if (minDepth - library::OcclusionCuller::DEPTH_BIAS < GetDepth(static_cast<UINT>(x), static_cast<UINT>(y)) - DEPTH_TOLERANCE)
+                    {
+                        return FALSE;
+                    }
+                }
+            }
+
+            return TRUE;
+        }
+
+        BOOL IsBoxOnScreen(_In_ const std::array<FLOAT, 6>& box) const
+        {
+            INT aRect[4];
+            FLOAT minDepth;
+            return getRectangle(box, aRect, minDepth);
+        }
+
+    private:
+        void project(_In_reads_(3) const FLOAT* pPosition, _Out_ FLOAT& x, _Out_ FLOAT& y, _Out_ FLOAT& depth) const
+        {
+            FLOAT aClip[4];
+            for (UINT j = 0u; j < 4u; ++j)
+            {
+                aClip[j] = pPosition[0] * m_aViewProjection[j] + pPosition[1] * m_aViewProjection[4u + j] + pPosition[2] * m_aViewProjection[8u + j] + m_aViewProjection[12u + j];
+            }
+            x = (aClip[0] / aClip[3] * 0.5f + 0.5f) * static_cast<FLOAT>(m_uWidth);
+            y = (0.5f - aClip[1] / aClip[3] * 0.5f) * static_cast<FLOAT>(m_uHeight);
+            depth = aClip[2] / aClip[3];
+        }
+
+        // The pixels the screen rectangle of a box touches and its nearest depth, FALSE when the culler would not test pixels
+        BOOL getRectangle(_In_ const std::array<FLOAT, 6>& box, _Out_writes_(4) INT* pRect, _Out_ FLOAT& minDepth) const
+        {
+            FLOAT minX = FLT_MAX;
+            FLOAT minY = FLT_MAX;
+            FLOAT maxX = -FLT_MAX;
+            FLOAT maxY = -FLT_MAX;
+            minDepth = FLT_MAX;
+            for (UINT uCorner = 0u; uCorner < 8u; ++uCorner)
+            {
+                const FLOAT aCorner[3] = {
+                    box[0] + ((uCorner & 1u) ? box[3] : -box[3]),
+                    box[1] + ((uCorner & 2u) ? box[4] : -box[4]),
+                    box[2] + ((uCorner & 4u) ? box[5] : -box[5]),
+                };
+                FLOAT x;
+                FLOAT y;
+                FLOAT depth;
+                project(aCorner, x, y, depth);
+                if (depth < 0.0f)
+                {
+                    return FALSE;
+                }
+                minX = std::min(minX, x);
+                maxX = std::max(maxX, x);
+                minY = std::min(minY, y);
+                maxY = std::max(maxY, y);
+                minDepth = std::min(minDepth, depth);
+            }
+
+            if (maxX < 0.0f || maxY < 0.0f || minX >= static_cast<FLOAT>(m_uWidth) || minY >= static_cast<FLOAT>(m_uHeight))
+            {
+                return FALSE;
+            }
+
+            pRect[0] = static_cast<INT>(std::max(minX, 0.0f));
+            pRect[1] = static_cast<INT>(std::max(minY, 0.0f));
+            pRect[2] = static_cast<INT>(std::min(maxX, static_cast<FLOAT>(m_uWidth - 1u)));
+            pRect[3] = static_cast<INT>(std::min(maxY, static_cast<FLOAT>(m_uHeight - 1u)));
+            return TRUE;
+        }
+
+    private:
+        std::vector<FLOAT> m_aViewProjection;
+        UINT m_uWidth;
+        UINT m_uHeight;
+        std::vector<FLOAT> m_aDepths;
+    };
+}
@@ -0,0 +1,207 @@
+/*+===================================================================
+  File:      RECORDINGRENDERCONTEXT.H
+
+  Summary:   RecordingRenderContext header file contains the mock
+             RenderContext the tests submit to, recording every call
+             and the state bound at every draw.
+
+  Classes: RecordingRenderContext
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Platform.h"
+
+#include <map>
+#include <utility>
+
+#include "Renderer/RenderContext.h"
+
+namespace test
+{
+    /*E+E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E
+        Enum:     eRecordedCall
+        Summary:  Enumeration of the calls of a RenderContext
+    E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E-E*/
+    enum class eRecordedCall
+    {
+        INPUT_LAYOUT,
+        VERTEX_BUFFERS,
+        INDEX_BUFFER,
+        VERTEX_SHADER,
+        PIXEL_SHADER,
+        VS_CONSTANT_BUFFERS,
+        PS_CONSTANT_BUFFERS,
+        VS_SHADER_RESOURCES,
+        PS_SHADER_RESOURCES,
+        PS_SAMPLERS,
+        RENDER_TARGETS,
+        DRAW,
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   RecordedCall
+      Summary:  A call with its first slot, the objects it binds and
+                the values that go with them: the stride and offset of
+                every vertex buffer, the format and offset of an index
+                buffer, or the counts of a draw
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct RecordedCall
+    {
+        eRecordedCall Call;
+        UINT StartSlot;
+        std::vector<const void*> Objects;
+        std::vector<UINT64> Values;
+    };
+
+    // What a slot of a call is bound to, the object and its value
+    typedef std::map<std::pair<eRecordedCall, UINT>, std::pair<const void*, UINT64>> BoundState;
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    RecordingRenderContext
+
+      Summary:  RenderContext that records every call, keeps what every
+                slot is bound to the way the immediate context would,
+                and the state bound at every draw. Render targets do
+                not unbind the views, the mock does not know what they
+                view
+
+      Methods:  GetCalls
+                  Returns the calls in the order they were made
+                GetState
+                  Returns what every slot is bound to
+                GetDrawStates
+                  Returns the state bound at every draw
+                GetNumCalls
+                  Returns the number of calls of a kind
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class RecordingRenderContext final : public library::RenderContext
+    {
+    public:
+        void IASetInputLayout(_In_opt_ ID3D11InputLayout* pInputLayout) override
+        {
+            record(eRecordedCall::INPUT_LAYOUT, 0u, 1u, &pInputLayout, nullptr);
+        }
+
+        void IASetVertexBuffers(_In_ UINT uStartSlot, _In_ UINT uNumBuffers, _In_reads_(uNumBuffers) ID3D11Buffer* const* ppVertexBuffers, _In_reads_(uNumBuffers) const UINT* puStrides, _In_reads_(uNumBuffers) const UINT* puOffsets) override
+        {
+            std::vector<UINT64> aValues(uNumBuffers);
+            for (UINT i = 0u; i < uNumBuffers; ++i)
+            {
+                aValues[i] = (static_cast<UINT64>(puStrides[i]) << 32u) | puOffsets[i];
+            }
+            record(eRecordedCall::VERTEX_BUFFERS, uStartSlot, uNumBuffers, ppVertexBuffers, aValues.data());
+        }
+
+        void IASetIndexBuffer(_In_opt_ ID3D11Buffer* pIndexBuffer, _In_ DXGI_FORMAT format, _In_ UINT uOffset) override
+        {
+            const UINT64 uValue = (static_cast<UINT64>(static_cast<UINT>(format)) << 32u) | uOffset;
+            record(eRecordedCall::INDEX_BUFFER, 0u, 1u, &pIndexBuffer, &uValue);
+        }
+
+        void VSSetShader(_In_opt_ ID3D11VertexShader* pVertexShader) override
+        {
+            record(eRecordedCall::VERTEX_SHADER, 0u, 1u, &pVertexShader, nullptr);
+        }
+
+        void PSSetShader(_In_opt_ ID3D11PixelShader* pPixelShader) override
+        {
+            record(eRecordedCall::PIXEL_SHADER, 0u, 1u, &pPixelShader, nullptr);
+        }
+
+        void VSSetConstantBuffers(_In_ UINT uStartSlot, _In_ UINT uNumBuffers, _In_reads_(uNumBuffers) ID3D11Buffer* const* ppConstantBuffers) override
+        {
+            record(eRecordedCall::VS_CONSTANT_BUFFERS, uStartSlot, uNumBuffers, ppConstantBuffers, nullptr);
+        }
+
+        void PSSetConstantBuffers(_In_ UINT uStartSlot, _In_ UINT uNumBuffers, _In_reads_(uNumBuffers) ID3D11Buffer* const* ppConstantBuffers) override
+        {
+            record(eRecordedCall::PS_CONSTANT_BUFFERS, uStartSlot, uNumBuffers, ppConstantBuffers, nullptr);
+        }
+
+        void VSSetShaderResources(_In_ UINT uStartSlot, _In_ UINT uNumViews, _In_reads_(uNumViews) ID3D11ShaderResourceView* const* ppShaderResourceViews) override
+        {
+            record(eRecordedCall::VS_SHADER_RESOURCES, uStartSlot, uNumViews, ppShaderResourceViews, nullptr);
+        }
+
+        void PSSetShaderResources(_In_ UINT uStartSlot, _In_ UINT uNumViews, _In_reads_(uNumViews) ID3D11ShaderResourceView* const* ppShaderResourceViews) override
+        {
+            record(eRecordedCall::PS_SHADER_RESOURCES, uStartSlot, uNumViews, ppShaderResourceViews, nullptr);
+        }
+
+        void PSSetSamplers(_In_ UINT uStartSlot, _In_ UINT uNumSamplers, _In_reads_(uNumSamplers) ID3D11SamplerState* const* ppSamplers) override
+        {
+            record(eRecordedCall::PS_SAMPLERS, uStartSlot, uNumSamplers, ppSamplers, nullptr);
+        }
+
+        void OMSetRenderTargets(_In_ UINT uNumViews, _In_reads_opt_(uNumViews) ID3D11RenderTargetView* const* ppRenderTargetViews, _In_opt_ ID3D11DepthStencilView* pDepthStencilView) override
+        {
+            // The depth stencil view is the last slot, the targets past the ones bound are unbound
+            std::vector<const void*> aObjects(ppRenderTargetViews, ppRenderTargetViews + uNumViews);
+            aObjects.push_back(pDepthStencilView);
+            for (auto it = m_state.begin(); it != m_state.end();)
+            {
+                it = it->first.first == eRecordedCall::RENDER_TARGETS ? m_state.erase(it) : std::next(it);
+            }
+            record(eRecordedCall::RENDER_TARGETS, 0u, uNumViews + 1u, aObjects.data(), nullptr);
+        }
+
+        void DrawIndexed(_In_ UINT uIndexCount, _In_ UINT uStartIndexLocation, _In_ INT iBaseVertexLocation) override
+        {
+            m_aCalls.push_back(RecordedCall{ .Call = eRecordedCall::DRAW, .StartSlot = 0u, .Objects = {}, .Values = { uIndexCount, uStartIndexLocation, static_cast<UINT64>(iBaseVertexLocation) } });
+            m_aDrawStates.push_back(m_state);
+        }
+
+        void DrawIndexedInstanced(_In_ UINT uIndexCountPerInstance, _In_ UINT uInstanceCount, _In_ UINT uStartIndexLocation, _In_ INT iBaseVertexLocation, _In_ UINT uStartInstanceLocation) override
+        {
+            m_aCalls.push_back(RecordedCall{ .Call = eRecordedCall::DRAW, .StartSlot = 0u, .Objects = {}, .Values = { uIndexCountPerInstance, uInstanceCount, uStartIndexLocation, static_cast<UINT64>(iBaseVertexLocation), uStartInstanceLocation } });
+            m_aDrawStates.push_back(m_state);
+        }
+
+        const std::vector<RecordedCall>& GetCalls() const
+        {
+            return m_aCalls;
+        }
+
+        const BoundState& GetState() const
+        {
+            return m_state;
+        }
+
+        const std::vector<BoundState>& GetDrawStates() const
+        {
+            return m_aDrawStates;
+        }
+
+        UINT GetNumCalls(_In_ eRecordedCall call) const
+        {
+            UINT uNumCalls = 0u;
+            for (const RecordedCall& recordedCall : m_aCalls)
+            {
+                uNumCalls += recordedCall.Call == call ? 1u : 0u;
+            }
+            return uNumCalls;
+        }
+
+    private:
+        template <typename T>
+        void record(_In_ eRecordedCall call, _In_ UINT uStartSlot, _In_ UINT uCount, _In_reads_(uCount) T* const* apObjects, _In_reads_opt_(uCount) const UINT64* puValues)
+        {
+            RecordedCall recordedCall = { .Call = call, .StartSlot = uStartSlot, .Objects = {}, .Values = {} };
+            for (UINT i = 0u; i < uCount; ++i)
+            {
+                const UINT64 uValue = puValues ? puValues[i] : 0ull;
+                recordedCall.Objects.push_back(apObjects[i]);
+                recordedCall.Values.push_back(uValue);
+                m_state[std::make_pair(call, uStartSlot + i)] = std::make_pair(static_cast<const void*>(apObjects[i]), uValue);
+            }
+            m_aCalls.push_back(std::move(recordedCall));
+        }
+
+    private:
+        std::vector<RecordedCall> m_aCalls;
+        BoundState m_state;
+        std::vector<BoundState> m_aDrawStates;
+    };
+}
@@ -0,0 +1,89 @@
+#include "Test.h"
+
+#include <memory>
+#include <random>
+
+#include "Renderer/RenderQueue.h"
+#include "Renderer/StateFilteringContext.h"
+
+using namespace library;
+
+namespace
+{
+    template <typename T>
+    T* getObject(_In_ UINT uId)
+    {
+        return reinterpret_cast<T*>(static_cast<std::uintptr_t>(uId + 1u) * 16u);
+    }
+
+    // Drops every call, the filter in front of it does the work of a frame
+    class NullContext final : public RenderContext
+    {
+    public:
+        void IASetInputLayout(_In_opt_ ID3D11InputLayout*) override {}
+        void IASetVertexBuffers(_In_ UINT, _In_ UINT, _In_reads_(uNumBuffers) ID3D11Buffer* const*, _In_reads_(uNumBuffers) const UINT*, _In_reads_(uNumBuffers) const UINT*) override {}
+        void IASetIndexBuffer(_In_opt_ ID3D11Buffer*, _In_ DXGI_FORMAT, _In_ UINT) override {}
+        void VSSetShader(_In_opt_ ID3D11VertexShader*) override {}
+        void PSSetShader(_In_opt_ ID3D11PixelShader*) override {}
+        void VSSetConstantBuffers(_In_ UINT, _In_ UINT, _In_reads_(uNumBuffers) ID3D11Buffer* const*) override {}
+        void PSSetConstantBuffers(_In_ UINT, _In_ UINT, _In_reads_(uNumBuffers) ID3D11Buffer* const*) override {}
+        void VSSetShaderResources(_In_ UINT, _In_ UINT, _In_reads_(uNumViews) ID3D11ShaderResourceView* const*) override {}
+        void PSSetShaderResources(_In_ UINT, _In_ UINT, _In_reads_(uNumViews) ID3D11ShaderResourceView* const*) override {}
+        void PSSetSamplers(_In_ UINT, _In_ UINT, _In_reads_(uNumSamplers) ID3D11SamplerState* const*) override {}
+        void OMSetRenderTargets(_In_ UINT, _In_reads_opt_(uNumViews) ID3D11RenderTargetView* const*, _In_opt_ ID3D11DepthStencilView*) override {}
+        void DrawIndexed(_In_ UINT, _In_ UINT, _In_ INT) override {}
+        void DrawIndexedInstanced(_In_ UINT, _In_ UINT, _In_ UINT, _In_ INT, _In_ UINT) override {}
+    };
+}
+
+BENCHMARK(RenderQueueVoxelFrame)
+{
+    // The greedy meshes of 15 block types over 200 chunks, queued, sorted and submitted through a filter every frame
+    constexpr const UINT NUM_VOXELS = 15u;
+    constexpr const UINT NUM_CHUNKS = 200u;
+
+    std::mt19937 random(22u);
+    std::uniform_real_distribution<FLOAT> depth(1.0f, 500.0f);
+    std::vector<DrawCommand> aCommands;
+    std::vector<FLOAT> aDepths;
+    for (UINT uVoxel = 0u; uVoxel < NUM_VOXELS; ++uVoxel)
+    {
+        for (UINT uChunk = 0u; uChunk < NUM_CHUNKS; ++uChunk)
+        {
+            if ((uChunk * 7u + uVoxel * 3u) % NUM_VOXELS < 4u)
+            {
+                DrawCommand command = {};
+                command.pInputLayout = getObject<ID3D11InputLayout>(0u);
+                command.pVertexShader = getObject<ID3D11VertexShader>(0u);
+                command.pPixelShader = getObject<ID3D11PixelShader>(0u);
+                command.apVertexBuffers[0] = getObject<ID3D11Buffer>(1000u + uChunk);
+                command.apVertexBuffers[1] = getObject<ID3D11Buffer>(100u + uVoxel);
+                command.pIndexBuffer = getObject<ID3D11Buffer>(2000u + uChunk);
+                command.pConstantBuffer = getObject<ID3D11Buffer>(200u + uVoxel);
+                command.uNumIndices = 6u;
+                aCommands.push_back(command);
+                aDepths.push_back(depth(random));
+            }
+        }
+    }
+
+    RenderQueue queue;
+    StateFilteringContext filter(std::make_shared<NullContext>());
+    const double milliseconds = test::MeasureMilliseconds(200u, [&]()
+    {
+        queue.Clear();
+        for (size_t i = 0u; i < aCommands.size(); ++i)
+        {
+            queue.Push(eRenderPass::GEOMETRY, aDepths[i], aCommands[i]);
+        }
+        queue.Sort();
+        filter.Invalidate();
+        filter.ResetCounts();
+        queue.Submit(&filter);
+    });
+
+    CHECK_EQUAL(static_cast<UINT>(aCommands.size()), queue.GetNumCommands());
+    CHECK(milliseconds < 1.0);
+
+    std::printf("  %zu draws  %6.3f ms  %u binds issued  %u skipped\n", aCommands.size(), milliseconds, filter.GetNumIssuedCalls(), filter.GetNumSkippedCalls());
+}
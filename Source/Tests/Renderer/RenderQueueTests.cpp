@@ -0,0 +1,257 @@
+#include "Test.h"
+
+#include <algorithm>
+#include <memory>
+#include <random>
+
+#include "Renderer/RenderQueue.h"
+#include "Renderer/StateFilteringContext.h"
+
+using namespace library;
+
+namespace
+{
+    // A distinct non-null Direct3D object for every id, only ever compared
+    template <typename T>
+    T* getObject(_In_ UINT uId)
+    {
+        return reinterpret_cast<T*>(static_cast<std::uintptr_t>(uId + 1u) * 16u);
+    }
+
+    // Keeps the start index of every draw and the number of binds of each constant buffer, texture and vertex buffer slot
+    class CountingContext final : public RenderContext
+    {
+    public:
+        void IASetInputLayout(_In_opt_ ID3D11InputLayout*) override {}
+        void IASetVertexBuffers(_In_ UINT, _In_ UINT uNumBuffers, _In_reads_(uNumBuffers) ID3D11Buffer* const*, _In_reads_(uNumBuffers) const UINT*, _In_reads_(uNumBuffers) const UINT*) override { uNumVertexBufferBinds += uNumBuffers; }
+        void IASetIndexBuffer(_In_opt_ ID3D11Buffer*, _In_ DXGI_FORMAT, _In_ UINT) override {}
+        void VSSetShader(_In_opt_ ID3D11VertexShader*) override {}
+        void PSSetShader(_In_opt_ ID3D11PixelShader*) override {}
+        void VSSetConstantBuffers(_In_ UINT, _In_ UINT, _In_reads_(uNumBuffers) ID3D11Buffer* const*) override {}
+        void PSSetConstantBuffers(_In_ UINT, _In_ UINT uNumBuffers, _In_reads_(uNumBuffers) ID3D11Buffer* const*) override { uNumConstantBufferBinds += uNumBuffers; }
+        void VSSetShaderResources(_In_ UINT, _In_ UINT, _In_reads_(uNumViews) ID3D11ShaderResourceView* const*) override {}
+        void PSSetShaderResources(_In_ UINT, _In_ UINT uNumViews, _In_reads_(uNumViews) ID3D11ShaderResourceView* const*) override { uNumTextureBinds += uNumViews; }
+        void PSSetSamplers(_In_ UINT, _In_ UINT, _In_reads_(uNumSamplers) ID3D11SamplerState* const*) override {}
+        void OMSetRenderTargets(_In_ UINT, _In_reads_opt_(uNumViews) ID3D11RenderTargetView* const*, _In_opt_ ID3D11DepthStencilView*) override {}
+        void DrawIndexed(_In_ UINT, _In_ UINT uStartIndexLocation, _In_ INT) override { aDraws.push_back(uStartIndexLocation); }
+        void DrawIndexedInstanced(_In_ UINT, _In_ UINT, _In_ UINT uStartIndexLocation, _In_ INT, _In_ UINT) override { aDraws.push_back(uStartIndexLocation); }
+
+        std::vector<UINT> aDraws;
+        UINT uNumVertexBufferBinds = 0u;
+        UINT uNumConstantBufferBinds = 0u;
+        UINT uNumTextureBinds = 0u;
+    };
+
+    // Draws of a frame and the pass and depth each is pushed with
+    struct Frame
+    {
+        std::vector<DrawCommand> aCommands;
+        std::vector<eRenderPass> aPasses;
+        std::vector<FLOAT> aDepths;
+    };
+
+    // The greedy meshes of a voxel map the way the renderer pushes them: every block type is a voxel with its own
+    // constant buffer and normal buffer, and draws its range of the mesh of every chunk that has its faces
+    Frame getVoxelFrame(_In_ UINT uNumVoxels, _In_ UINT uNumChunks)
+    {
+        std::mt19937 random(20u);
+        std::uniform_real_distribution<FLOAT> depth(1.0f, 500.0f);
+        std::vector<FLOAT> aChunkDepths(uNumChunks);
+        for (FLOAT& chunkDepth : aChunkDepths)
+        {
+            chunkDepth = depth(random);
+        }
+
+        Frame frame;
+        for (UINT uVoxel = 0u; uVoxel < uNumVoxels; ++uVoxel)
+        {
+            for (UINT uChunk = 0u; uChunk < uNumChunks; ++uChunk)
+            {
+                if ((uChunk * 7u + uVoxel * 3u) % uNumVoxels >= 4u)
+                {
+                    continue;
+                }
+
+                DrawCommand command = {};
+                command.pInputLayout = getObject<ID3D11InputLayout>(0u);
+                command.pVertexShader = getObject<ID3D11VertexShader>(0u);
+                command.pPixelShader = getObject<ID3D11PixelShader>(0u);
+                command.apVertexBuffers[0] = getObject<ID3D11Buffer>(1000u + uChunk);
+                command.apVertexBuffers[1] = getObject<ID3D11Buffer>(100u + uVoxel);
+                command.auStrides[0] = 32u;
+                command.auStrides[1] = 24u;
+                command.pIndexBuffer = getObject<ID3D11Buffer>(2000u + uChunk);
+                command.pConstantBuffer = getObject<ID3D11Buffer>(200u + uVoxel);
+                command.apVSConstantBuffers[0] = getObject<ID3D11Buffer>(1u);
+                command.uNumIndices = 6u;
+                command.uStartIndex = static_cast<UINT>(frame.aCommands.size());
+
+                frame.aCommands.push_back(command);
+                frame.aPasses.push_back(eRenderPass::GEOMETRY);
+                frame.aDepths.push_back(aChunkDepths[uChunk]);
+            }
+        }
+        return frame;
+    }
+
+    // A model of 7 meshes sharing 6 normal-mapped materials, walked after a textured floor and an untextured light, then the sky
+    Frame getModelFrame()
+    {
+        Frame frame;
+        auto push = [&frame](_In_ eRenderPass pass, _In_ FLOAT depth, _In_ UINT uObject, _In_ UINT uShaders, _In_ UINT uMaterial, _In_ BOOL bNormalMap)
+        {
+            DrawCommand command = {};
+            command.pInputLayout = getObject<ID3D11InputLayout>(uShaders);
+            command.pVertexShader = getObject<ID3D11VertexShader>(uShaders);
+            command.pPixelShader = getObject<ID3D11PixelShader>(uShaders);
+            command.apVertexBuffers[0] = getObject<ID3D11Buffer>(10u + uObject);
+            command.apVertexBuffers[1] = getObject<ID3D11Buffer>(20u + uObject);
+            command.auStrides[0] = 32u;
+            command.auStrides[1] = 24u;
+            command.pIndexBuffer = getObject<ID3D11Buffer>(30u + uObject);
+            command.pConstantBuffer = getObject<ID3D11Buffer>(40u + uObject);
+            if (uMaterial != UINT_MAX)
+            {
+                command.apShaderResourceViews[0] = getObject<ID3D11ShaderResourceView>(uMaterial * 2u);
+                command.apSamplers[0] = getObject<ID3D11SamplerState>(0u);
+                if (bNormalMap)
+                {
+                    command.apShaderResourceViews[1] = getObject<ID3D11ShaderResourceView>(uMaterial * 2u + 1u);
+                    command.apSamplers[1] = getObject<ID3D11SamplerState>(0u);
+                }
+            }
+            command.uNumIndices = 3u;
+            command.uStartIndex = static_cast<UINT>(frame.aCommands.size());
+
+            frame.aCommands.push_back(command);
+            frame.aPasses.push_back(pass);
+            frame.aDepths.push_back(depth);
+        };
+
+        push(eRenderPass::GEOMETRY, 20.0f, 0u, 0u, 6u, FALSE);
+        push(eRenderPass::GEOMETRY, 8.0f, 1u, 1u, UINT_MAX, FALSE);
+        const UINT auMaterials[] = { 0u, 1u, 2u, 1u, 3u, 4u, 5u };
+        for (UINT uMaterial : auMaterials)
+        {
+            push(eRenderPass::GEOMETRY, 10.0f, 2u, 2u, uMaterial, TRUE);
+        }
+        push(eRenderPass::SKYBOX, 0.0f, 3u, 3u, 7u, FALSE);
+        return frame;
+    }
+
+    // Binds issued through a filter when the draws go sorted by the queue, or unsorted in the order the renderer walks them
+    UINT submit(_In_ const Frame& frame, _In_ BOOL bSort, _Out_opt_ CountingContext* pCounts)
+    {
+        RenderQueue queue;
+        for (size_t i = 0u; i < frame.aCommands.size(); ++i)
+        {
+            queue.Push(frame.aPasses[i], frame.aDepths[i], frame.aCommands[i]);
+        }
+        if (bSort)
+        {
+            queue.Sort();
+        }
+
+        const std::shared_ptr<CountingContext> counts = std::make_shared<CountingContext>();
+        StateFilteringContext filter(counts);
+        queue.Submit(&filter);
+
+        if (pCounts)
+        {
+            *pCounts = *counts;
+        }
+        return filter.GetNumIssuedCalls();
+    }
+}
+
+TEST(RenderQueueKeepsMaterialGroups)
+{
+    // 15 block types over 200 chunks: the constant buffer of a block type is bound once, only the chunk geometry changes between its draws
+    constexpr const UINT NUM_VOXELS = 15u;
+    const Frame frame = getVoxelFrame(NUM_VOXELS, 200u);
+    CountingContext counts;
+    const UINT uSorted = submit(frame, TRUE, &counts);
+    const UINT uUnsorted = submit(frame, FALSE, nullptr);
+
+    CHECK_EQUAL(frame.aCommands.size(), counts.aDraws.size());
+    CHECK_EQUAL(NUM_VOXELS, counts.uNumConstantBufferBinds);
+    CHECK(uSorted <= uUnsorted);
+
+    // Within a block type the chunks go from the nearest
+    for (size_t i = 1u; i < counts.aDraws.size(); ++i)
+    {
+        const DrawCommand& previous = frame.aCommands[counts.aDraws[i - 1u]];
+        const DrawCommand& current = frame.aCommands[counts.aDraws[i]];
+        CHECK(previous.pConstantBuffer != current.pConstantBuffer || frame.aDepths[counts.aDraws[i - 1u]] <= frame.aDepths[counts.aDraws[i]]);
+    }
+
+    std::printf("  voxel map: %zu draws, %u binds in the order of the walk, %u sorted\n", frame.aCommands.size(), uUnsorted, uSorted);
+}
+
+TEST(RenderQueueGroupsMaterialsAcrossObjects)
+{
+    // The two meshes sharing a material are drawn one after the other, and the sky still goes last
+    const Frame frame = getModelFrame();
+    CountingContext sortedCounts;
+    CountingContext unsortedCounts;
+    const UINT uSorted = submit(frame, TRUE, &sortedCounts);
+    const UINT uUnsorted = submit(frame, FALSE, &unsortedCounts);
+
+    CHECK_EQUAL(frame.aCommands.size(), sortedCounts.aDraws.size());
+    CHECK_EQUAL(static_cast<UINT>(frame.aCommands.size()) - 1u, sortedCounts.aDraws.back());
+    CHECK(sortedCounts.uNumTextureBinds < unsortedCounts.uNumTextureBinds);
+    CHECK(uSorted < uUnsorted);
+
+    std::printf("  model: %zu draws, %u binds in the order of the walk, %u sorted\n", frame.aCommands.size(), uUnsorted, uSorted);
+}
+
+TEST(RenderQueueSortIsStable)
+{
+    // Random passes, states and depths: every draw goes once, passes in order, and equal keys keep the order they were pushed in
+    std::mt19937 random(21u);
+    for (UINT uNumCommands : { 0u, 1u, 2u, 255u, 256u, 257u, 5000u, 100000u })
+    {
+        RenderQueue queue;
+        std::vector<eRenderPass> aPasses(uNumCommands);
+        std::vector<FLOAT> aDepths(uNumCommands);
+        std::vector<DrawCommand> aCommands(uNumCommands);
+        for (UINT i = 0u; i < uNumCommands; ++i)
+        {
+            DrawCommand& command = aCommands[i];
+            command = {};
+            command.pVertexShader = getObject<ID3D11VertexShader>(random() % 3u);
+            command.pConstantBuffer = getObject<ID3D11Buffer>(random() % 50u);
+            command.apVertexBuffers[0] = getObject<ID3D11Buffer>(100u + random() % 20u);
+            command.uStartIndex = i;
+            aPasses[i] = random() % 4u == 0u ? eRenderPass::SKYBOX : eRenderPass::GEOMETRY;
+            aDepths[i] = static_cast<FLOAT>(random() % 8u);
+            queue.Push(aPasses[i], aDepths[i], command);
+        }
+        queue.Sort();
+        CHECK_EQUAL(uNumCommands, queue.GetNumCommands());
+
+        CountingContext counts;
+        queue.Submit(&counts);
+        CHECK_EQUAL(static_cast<size_t>(uNumCommands), counts.aDraws.size());
+
+        std::vector<BOOL> aDrawn(uNumCommands, FALSE);
+        for (size_t i = 0u; i < counts.aDraws.size(); ++i)
+        {
+            const UINT uCommand = counts.aDraws[i];
+            CHECK(!aDrawn[uCommand]);
+            aDrawn[uCommand] = TRUE;
+            if (i == 0u)
+            {
+                continue;
+            }
+
+            const UINT uPrevious = counts.aDraws[i - 1u];
+            CHECK(aPasses[uPrevious] <= aPasses[uCommand]);
+            const BOOL bSameState = aPasses[uPrevious] == aPasses[uCommand] && aDepths[uPrevious] == aDepths[uCommand]
+                && aCommands[uPrevious].pVertexShader == aCommands[uCommand].pVertexShader
+                && aCommands[uPrevious].pConstantBuffer == aCommands[uCommand].pConstantBuffer
+                && aCommands[uPrevious].apVertexBuffers[0] == aCommands[uCommand].apVertexBuffers[0];
+            CHECK(!bSameState || uPrevious < uCommand);
+        }
+    }
+}
@@ -0,0 +1,211 @@
+#include "Test.h"
+
+#include <memory>
+#include <random>
+
+#include "Renderer/RecordingRenderContext.h"
+#include "Renderer/StateFilteringContext.h"
+
+using namespace library;
+
+namespace
+{
+    // A distinct non-null Direct3D object for every id, only ever compared
+    template <typename T>
+    T* getObject(_In_ UINT uId)
+    {
+        return reinterpret_cast<T*>(static_cast<std::uintptr_t>(uId + 1u) * 16u);
+    }
+
+    // A filter over a recording context
+    struct FilteredContext
+    {
+        std::shared_ptr<test::RecordingRenderContext> recording = std::make_shared<test::RecordingRenderContext>();
+        StateFilteringContext filter{ recording };
+    };
+}
+
+TEST(StateFilteringContextDropsRepeatedBinds)
+{
+    FilteredContext context;
+    ID3D11Buffer* pBuffer = getObject<ID3D11Buffer>(1u);
+    const UINT uStride = 32u;
+    const UINT uOffset = 0u;
+    for (UINT i = 0u; i < 3u; ++i)
+    {
+        context.filter.IASetInputLayout(getObject<ID3D11InputLayout>(0u));
+        context.filter.IASetVertexBuffers(0u, 1u, &pBuffer, &uStride, &uOffset);
+        context.filter.IASetIndexBuffer(pBuffer, DXGI_FORMAT_R16_UINT, 0u);
+        context.filter.VSSetShader(getObject<ID3D11VertexShader>(0u));
+        context.filter.PSSetShader(getObject<ID3D11PixelShader>(0u));
+        context.filter.VSSetConstantBuffers(2u, 1u, &pBuffer);
+        context.filter.PSSetConstantBuffers(2u, 1u, &pBuffer);
+        context.filter.DrawIndexed(36u, 0u, 0);
+    }
+
+    // Every bind once, every draw each time
+    CHECK_EQUAL(10u, context.recording->GetCalls().size());
+    CHECK_EQUAL(3u, context.recording->GetNumCalls(test::eRecordedCall::DRAW));
+    CHECK_EQUAL(7u, context.filter.GetNumIssuedCalls());
+    CHECK_EQUAL(14u, context.filter.GetNumSkippedCalls());
+
+    // A stride or an offset that changes is a new bind
+    const UINT uOtherOffset = 64u;
+    context.filter.IASetVertexBuffers(0u, 1u, &pBuffer, &uStride, &uOtherOffset);
+    context.filter.IASetIndexBuffer(pBuffer, DXGI_FORMAT_R16_UINT, 12u);
+    CHECK_EQUAL(1u + 1u, context.recording->GetNumCalls(test::eRecordedCall::VERTEX_BUFFERS));
+    CHECK_EQUAL(1u + 1u, context.recording->GetNumCalls(test::eRecordedCall::INDEX_BUFFER));
+
+    context.filter.ResetCounts();
+    CHECK_EQUAL(0u, context.filter.GetNumIssuedCalls());
+    CHECK_EQUAL(0u, context.filter.GetNumSkippedCalls());
+}
+
+TEST(StateFilteringContextNarrowsSlotRanges)
+{
+    FilteredContext context;
+    ID3D11ShaderResourceView* apViews[] = { getObject<ID3D11ShaderResourceView>(0u), getObject<ID3D11ShaderResourceView>(1u), getObject<ID3D11ShaderResourceView>(2u), getObject<ID3D11ShaderResourceView>(3u) };
+    context.filter.PSSetShaderResources(0u, 4u, apViews);
+
+    // Only the second slot changes, then only the first and the last, which goes out as the range between them
+    apViews[1] = getObject<ID3D11ShaderResourceView>(5u);
+    context.filter.PSSetShaderResources(0u, 4u, apViews);
+    apViews[0] = getObject<ID3D11ShaderResourceView>(6u);
+    apViews[3] = getObject<ID3D11ShaderResourceView>(7u);
+    context.filter.PSSetShaderResources(0u, 4u, apViews);
+    context.filter.PSSetShaderResources(0u, 4u, apViews);
+
+    const std::vector<test::RecordedCall>& aCalls = context.recording->GetCalls();
+    CHECK_EQUAL(3u, aCalls.size());
+    CHECK_EQUAL(1u, aCalls[1].StartSlot);
+    CHECK_EQUAL(1u, aCalls[1].Objects.size());
+    CHECK(aCalls[1].Objects[0] == apViews[1]);
+    CHECK_EQUAL(0u, aCalls[2].StartSlot);
+    CHECK_EQUAL(4u, aCalls[2].Objects.size());
+
+    // The vertex shader keeps its own views, the same view there is still a bind
+    context.filter.VSSetShaderResources(1u, 1u, &apViews[1]);
+    CHECK_EQUAL(4u, context.recording->GetCalls().size());
+}
+
+TEST(StateFilteringContextForgetsViewsOnRenderTargets)
+{
+    FilteredContext context;
+    ID3D11ShaderResourceView* pView = getObject<ID3D11ShaderResourceView>(0u);
+    ID3D11SamplerState* pSampler = getObject<ID3D11SamplerState>(0u);
+    ID3D11RenderTargetView* pTarget = getObject<ID3D11RenderTargetView>(0u);
+    ID3D11DepthStencilView* pDepth = getObject<ID3D11DepthStencilView>(0u);
+    context.filter.PSSetShaderResources(2u, 1u, &pView);
+    context.filter.VSSetShaderResources(2u, 1u, &pView);
+    context.filter.PSSetSamplers(2u, 1u, &pSampler);
+    context.filter.OMSetRenderTargets(1u, &pTarget, pDepth);
+    context.filter.OMSetRenderTargets(1u, &pTarget, pDepth);
+
+    // The view might have been unbound as an output, the sampler is still known
+    context.filter.PSSetShaderResources(2u, 1u, &pView);
+    context.filter.VSSetShaderResources(2u, 1u, &pView);
+    context.filter.PSSetSamplers(2u, 1u, &pSampler);
+    CHECK_EQUAL(1u, context.recording->GetNumCalls(test::eRecordedCall::RENDER_TARGETS));
+    CHECK_EQUAL(2u, context.recording->GetNumCalls(test::eRecordedCall::PS_SHADER_RESOURCES));
+    CHECK_EQUAL(2u, context.recording->GetNumCalls(test::eRecordedCall::VS_SHADER_RESOURCES));
+    CHECK_EQUAL(1u, context.recording->GetNumCalls(test::eRecordedCall::PS_SAMPLERS));
+
+    // Another depth stencil view or no render target is a new bind
+    context.filter.OMSetRenderTargets(1u, &pTarget, nullptr);
+    context.filter.OMSetRenderTargets(0u, nullptr, nullptr);
+    context.filter.OMSetRenderTargets(0u, nullptr, nullptr);
+    CHECK_EQUAL(3u, context.recording->GetNumCalls(test::eRecordedCall::RENDER_TARGETS));
+}
+
+TEST(StateFilteringContextStartsUnknown)
+{
+    FilteredContext context;
+
+    // Null is not assumed to be bound, and Invalidate forgets everything
+    context.filter.VSSetShader(nullptr);
+    context.filter.VSSetShader(nullptr);
+    ID3D11Buffer* pBuffer = nullptr;
+    context.filter.PSSetConstantBuffers(0u, 1u, &pBuffer);
+    context.filter.PSSetConstantBuffers(0u, 1u, &pBuffer);
+    CHECK_EQUAL(2u, context.recording->GetCalls().size());
+
+    context.filter.Invalidate();
+    context.filter.VSSetShader(nullptr);
+    context.filter.PSSetConstantBuffers(0u, 1u, &pBuffer);
+    CHECK_EQUAL(4u, context.recording->GetCalls().size());
+
+    // Slots past the ones tracked always go through
+    pBuffer = getObject<ID3D11Buffer>(0u);
+    context.filter.VSSetConstantBuffers(StateFilteringContext::NUM_CONSTANT_BUFFER_SLOTS, 1u, &pBuffer);
+    context.filter.VSSetConstantBuffers(StateFilteringContext::NUM_CONSTANT_BUFFER_SLOTS, 1u, &pBuffer);
+    CHECK_EQUAL(6u, context.recording->GetCalls().size());
+}
+
+TEST(StateFilteringContextKeepsWhatDrawsSee)
+{
+    // Random binds over a few objects: every draw sees the same state through the filter as without it
+    std::mt19937 random(21u);
+    FilteredContext context;
+    test::RecordingRenderContext direct;
+    std::vector<RenderContext*> apContexts = { &context.filter, &direct };
+    for (UINT uStep = 0u; uStep < 20000u; ++uStep)
+    {
+        const UINT uSlot = random() % 4u;
+        const UINT uCount = 1u + random() % 3u;
+        ID3D11Buffer* apBuffers[3] = { getObject<ID3D11Buffer>(random() % 3u), getObject<ID3D11Buffer>(random() % 3u), getObject<ID3D11Buffer>(random() % 3u) };
+        ID3D11ShaderResourceView* apViews[3] = { getObject<ID3D11ShaderResourceView>(random() % 3u), getObject<ID3D11ShaderResourceView>(random() % 3u), nullptr };
+        ID3D11SamplerState* pSampler = getObject<ID3D11SamplerState>(random() % 2u);
+        ID3D11RenderTargetView* pTarget = getObject<ID3D11RenderTargetView>(random() % 2u);
+        const UINT auStrides[3] = { 16u, 16u + 16u * static_cast<UINT>(random() % 2u), 32u };
+        const UINT auOffsets[3] = { 0u, 0u, 4u * static_cast<UINT>(random() % 2u) };
+        const UINT uCall = random() % 12u;
+        for (RenderContext* pContext : apContexts)
+        {
+            switch (uCall)
+            {
+            case 0u:
+                pContext->IASetInputLayout(getObject<ID3D11InputLayout>(uSlot % 2u));
+                break;
+            case 1u:
+                pContext->IASetVertexBuffers(uSlot, uCount, apBuffers, auStrides, auOffsets);
+                break;
+            case 2u:
+                pContext->IASetIndexBuffer(apBuffers[0], DXGI_FORMAT_R16_UINT, auOffsets[2]);
+                break;
+            case 3u:
+                pContext->VSSetShader(getObject<ID3D11VertexShader>(uSlot % 2u));
+                break;
+            case 4u:
+                pContext->PSSetShader(getObject<ID3D11PixelShader>(uSlot % 2u));
+                break;
+            case 5u:
+                pContext->VSSetConstantBuffers(uSlot, uCount, apBuffers);
+                break;
+            case 6u:
+                pContext->PSSetConstantBuffers(uSlot, uCount, apBuffers);
+                break;
+            case 7u:
+                pContext->VSSetShaderResources(uSlot, uCount, apViews);
+                break;
+            case 8u:
+                pContext->PSSetShaderResources(uSlot, uCount, apViews);
+                break;
+            case 9u:
+                pContext->PSSetSamplers(uSlot, 1u, &pSampler);
+                break;
+            case 10u:
+                pContext->OMSetRenderTargets(1u, &pTarget, nullptr);
+                break;
+            default:
+                pContext->DrawIndexedInstanced(6u, 1u + uSlot, 0u, 0, 0u);
+                break;
+            }
+        }
+    }
+
+    CHECK(context.recording->GetDrawStates().size() > 1000u);
+    CHECK(context.recording->GetDrawStates() == direct.GetDrawStates());
+    CHECK(context.recording->GetState() == direct.GetState());
+    CHECK(context.recording->GetCalls().size() < direct.GetCalls().size());
+    CHECK(context.filter.GetNumSkippedCalls() > 0u);
+}
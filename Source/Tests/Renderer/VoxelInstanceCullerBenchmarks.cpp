@@ -0,0 +1,79 @@
+#include "Test.h"
+
+#include <cmath>
+#include <cstring>
+#include <random>
+
+#include "Renderer/VoxelInstanceCuller.h"
+
+using namespace library;
+
+namespace
+{
+    // The path VoxelInstanceCuller.cpp was built with, the benchmark is built with the same flags
+#if defined(VOXEL_INSTANCE_CULLER_SCALAR)
+    constexpr const char* PATH_NAME = "scalar";
+#else
+    constexpr const char* PATH_NAME = "SSE2";
+#endif
+}
+
+BENCHMARK(VoxelInstanceCuller4MInstances)
+{
+    // 4M random cubes of levels 0 to 3 over a 1024x64x1024 map, a tenth of them air, against a 60 degree 16:9 frustum over it
+    constexpr const UINT NUM_INSTANCES = 4u * 1024u * 1024u;
+    constexpr const UINT MAP_SIZE = 1024u;
+    constexpr const UINT MAP_HEIGHT = 64u;
+    constexpr const UINT NUM_SPANS = 256u;
+
+    const FLOAT yScale = 1.0f / std::tan(1.0472f * 0.5f);
+    const FLOAT range = 4096.0f / (4096.0f - 0.1f);
+    const FLOAT aWorldViewProjection[16] = {
+        yScale * 9.0f / 16.0f, 0.0f, 0.0f, 0.0f,
+        0.0f, yScale, 0.0f, 0.0f,
+        0.0f, 0.0f, range, 1.0f,
+        -1024.0f * yScale * 9.0f / 16.0f, -100.0f * yScale, -1024.0f * range - range * 0.1f, -1024.0f,
+    };
+    FLOAT aPlanes[FrustumCuller::NUM_PLANES][4];
+    FrustumCuller::ExtractPlanes(aWorldViewProjection, aPlanes);
+
+    std::mt19937 random(23u);
+    std::vector<InstanceData> aInstances(NUM_INSTANCES);
+    for (InstanceData& instance : aInstances)
+    {
+        const UINT uLod = random() % 4u;
+        const CHAR blockType = random() % 10u == 0u ? 0 : static_cast<CHAR>(1u + random() % 15u);
+        instance = PackInstance(uLod, static_cast<UINT>(random() % (MAP_SIZE >> uLod)), static_cast<UINT>(random() % (MAP_HEIGHT >> uLod)), static_cast<UINT>(random() % (MAP_SIZE >> uLod)), blockType);
+    }
+    std::vector<InstanceSpan> aSpans;
+    for (UINT uSpanIdx = 0u; uSpanIdx < NUM_SPANS; ++uSpanIdx)
+    {
+        aSpans.push_back(InstanceSpan{ .pInstances = aInstances.data() + uSpanIdx * (NUM_INSTANCES / NUM_SPANS), .uNumInstances = NUM_INSTANCES / NUM_SPANS });
+    }
+
+    // The kernel on the calling thread
+    std::vector<InstanceData> aExpected(NUM_INSTANCES);
+    UINT uNumExpected = 0u;
+    const double kernelMilliseconds = test::MeasureMilliseconds(10u, [&]()
+    {
+        uNumExpected = VoxelInstanceCuller::CullInstances(aPlanes, aInstances.data(), NUM_INSTANCES, aExpected.data());
+    });
+    std::printf("  %-6s  kernel  %u instances  %7.3f ms  %u visible\n", PATH_NAME, NUM_INSTANCES, kernelMilliseconds, uNumExpected);
+    CHECK(kernelMilliseconds < 500.0);
+
+    // The pool over the spans of the chunks, its output is the kernel's whatever the number of threads
+    std::vector<InstanceData> aVisible(NUM_INSTANCES);
+    for (UINT uNumThreads : { 1u, 2u, 4u, 8u })
+    {
+        VoxelInstanceCuller culler(uNumThreads);
+        UINT uNumVisible = 0u;
+        const double milliseconds = test::MeasureMilliseconds(10u, [&]()
+        {
+            uNumVisible = culler.Cull(aWorldViewProjection, aSpans.data(), NUM_SPANS, aVisible.data());
+        });
+        CHECK_EQUAL(uNumExpected, uNumVisible);
+        CHECK(std::memcmp(aExpected.data(), aVisible.data(), sizeof(InstanceData) * uNumVisible) == 0);
+
+        std::printf("  %-6s  %2u threads  %7.3f ms\n", PATH_NAME, uNumThreads, milliseconds);
+    }
+}
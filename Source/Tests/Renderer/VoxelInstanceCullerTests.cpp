@@ -0,0 +1,184 @@
+#include "Test.h"
+
+#include <cmath>
+#include <cstring>
+#include <random>
+
+#include "Renderer/VoxelInstanceCuller.h"
+
+using namespace library;
+
+namespace
+{
+    constexpr const UINT MAP_SIZE = 1024u;
+    constexpr const UINT MAP_HEIGHT = 64u;
+
+    // A camera over the map looking down +z with a 60 degree 16:9 frustum, row vectors as in DirectXMath
+    std::vector<FLOAT> getWorldViewProjection(_In_ FLOAT eyeX, _In_ FLOAT eyeY, _In_ FLOAT eyeZ)
+    {
+        const FLOAT yScale = 1.0f / std::tan(1.0472f * 0.5f);
+        const FLOAT range = 4096.0f / (4096.0f - 0.1f);
+        return {
+            yScale * 9.0f / 16.0f, 0.0f, 0.0f, 0.0f,
+            0.0f, yScale, 0.0f, 0.0f,
+            0.0f, 0.0f, range, 1.0f,
+            -eyeX * yScale * 9.0f / 16.0f, -eyeY * yScale, -eyeZ * range - range * 0.1f, -eyeZ,
+        };
+    }
+
+    // Random cubes of every level of detail over the map, a tenth of them air
+    std::vector<InstanceData> getInstances(_In_ UINT uNumInstances, _In_ UINT uSeed)
+    {
+        std::mt19937 random(uSeed);
+        std::vector<InstanceData> aInstances(uNumInstances);
+        for (InstanceData& instance : aInstances)
+        {
+            const UINT uLod = random() % 4u;
+            const CHAR blockType = random() % 10u == 0u ? 0 : static_cast<CHAR>(1u + random() % 15u);
+            instance = PackInstance(uLod, static_cast<UINT>(random() % (MAP_SIZE >> uLod)), static_cast<UINT>(random() % (MAP_HEIGHT >> uLod)), static_cast<UINT>(random() % (MAP_SIZE >> uLod)), blockType);
+        }
+
+        return aInstances;
+    }
+
+    // Visible instances in their order, a cube being culled when its 8 corners are all behind one plane
+    std::vector<InstanceData> cullReference(_In_ const FLOAT aPlanes[FrustumCuller::NUM_PLANES][4], _In_ const std::vector<InstanceData>& aInstances)
+    {
+        std::vector<InstanceData> aVisible;
+        for (const InstanceData& instance : aInstances)
+        {
+            const FLOAT size = static_cast<FLOAT>(2u << instance.Lod);
+            const FLOAT aMin[3] = { instance.X * size, instance.Y * size, instance.Z * size };
+            BOOL bVisible = instance.BlockType != 0;
+            for (UINT uPlane = 0u; uPlane < FrustumCuller::NUM_PLANES && bVisible; ++uPlane)
+            {
+                BOOL bInFront = FALSE;
+                for (UINT uCorner = 0u; uCorner < 8u; ++uCorner)
+                {
+                    FLOAT distance = aPlanes[uPlane][3];
+                    for (UINT j = 0u; j < 3u; ++j)
+                    {
+                        distance += aPlanes[uPlane][j] * (aMin[j] + ((uCorner >> j) & 1u ? size : 0.0f));
+                    }
+                    bInFront = bInFront || distance >= 0.0f;
+                }
+                bVisible = bInFront;
+            }
+            if (bVisible)
+            {
+                aVisible.push_back(instance);
+            }
+        }
+
+        return aVisible;
+    }
+
+    BOOL isEqual(_In_ const InstanceData* pInstances, _In_ UINT uNumInstances, _In_ const std::vector<InstanceData>& aExpected)
+    {
+        return uNumInstances == aExpected.size() && std::memcmp(pInstances, aExpected.data(), sizeof(InstanceData) * uNumInstances) == 0;
+    }
+}
+
+TEST(VoxelInstanceCullerMatchesTheReference)
+{
+    const std::vector<FLOAT> aWorldViewProjection = getWorldViewProjection(1024.0f, 100.0f, 1024.0f);
+    FLOAT aPlanes[FrustumCuller::NUM_PLANES][4];
+    FrustumCuller::ExtractPlanes(aWorldViewProjection.data(), aPlanes);
+
+    const std::vector<InstanceData> aInstances = getInstances(200000u, 23u);
+    const std::vector<InstanceData> aExpected = cullReference(aPlanes, aInstances);
+    std::vector<InstanceData> aVisible(aInstances.size());
+    const UINT uNumVisible = VoxelInstanceCuller::CullInstances(aPlanes, aInstances.data(), static_cast<UINT>(aInstances.size()), aVisible.data());
+
+    CHECK(aExpected.size() > 10000u && aExpected.size() < aInstances.size() / 2u);
+    CHECK(isEqual(aVisible.data(), uNumVisible, aExpected));
+}
+
+TEST(VoxelInstanceCullerCullsEveryNumberOfInstances)
+{
+    // Every count left over after the blocks of 4, with the slot past the last visible instance written over
+    const std::vector<FLOAT> aWorldViewProjection = getWorldViewProjection(1024.0f, 100.0f, 1024.0f);
+    FLOAT aPlanes[FrustumCuller::NUM_PLANES][4];
+    FrustumCuller::ExtractPlanes(aWorldViewProjection.data(), aPlanes);
+
+    for (UINT uNumInstances = 0u; uNumInstances < 12u; ++uNumInstances)
+    {
+        std::vector<InstanceData> aInstances = getInstances(uNumInstances, uNumInstances);
+        for (UINT i = 0u; i < uNumInstances; i += 2u)
+        {
+            aInstances[i] = PackInstance(0u, 512u + i, 40u, 700u, 1);
+        }
+        std::vector<InstanceData> aVisible(uNumInstances);
+        const UINT uNumVisible = VoxelInstanceCuller::CullInstances(aPlanes, aInstances.data(), uNumInstances, aVisible.data());
+
+        CHECK(isEqual(aVisible.data(), uNumVisible, cullReference(aPlanes, aInstances)));
+        CHECK(uNumVisible >= (uNumInstances + 1u) / 2u);
+    }
+}
+
+TEST(VoxelInstanceCullerDropsAir)
+{
+    // The same cubes in front of the camera, solid then air
+    const std::vector<FLOAT> aWorldViewProjection = getWorldViewProjection(1024.0f, 100.0f, 1024.0f);
+    FLOAT aPlanes[FrustumCuller::NUM_PLANES][4];
+    FrustumCuller::ExtractPlanes(aWorldViewProjection.data(), aPlanes);
+
+    std::vector<InstanceData> aInstances;
+    for (UINT i = 0u; i < 10u; ++i)
+    {
+        aInstances.push_back(PackInstance(1u, 256u + i, 20u, 350u, static_cast<CHAR>(i % 2u == 0u ? 3 : 0)));
+    }
+    std::vector<InstanceData> aVisible(aInstances.size());
+    const UINT uNumVisible = VoxelInstanceCuller::CullInstances(aPlanes, aInstances.data(), static_cast<UINT>(aInstances.size()), aVisible.data());
+
+    CHECK_EQUAL(5u, uNumVisible);
+    for (UINT i = 0u; i < uNumVisible; ++i)
+    {
+        CHECK_EQUAL(256u + 2u * i, aVisible[i].X);
+        CHECK_EQUAL(3, aVisible[i].BlockType);
+    }
+}
+
+TEST(VoxelInstanceCullerIsIndependentOfThreads)
+{
+    // Spans of every size around a batch, empty ones included, in the order of the spans for any number of threads
+    const std::vector<FLOAT> aWorldViewProjection = getWorldViewProjection(1024.0f, 100.0f, 1024.0f);
+    FLOAT aPlanes[FrustumCuller::NUM_PLANES][4];
+    FrustumCuller::ExtractPlanes(aWorldViewProjection.data(), aPlanes);
+
+    const UINT auSpanSizes[] = { 0u, 1u, VoxelInstanceCuller::BATCH_SIZE - 1u, VoxelInstanceCuller::BATCH_SIZE, 0u, 3u * VoxelInstanceCuller::BATCH_SIZE + 7u, 5000u, 12u };
+    std::vector<std::vector<InstanceData>> aaInstances;
+    std::vector<InstanceData> aAllInstances;
+    for (UINT uSpanIdx = 0u; uSpanIdx < std::size(auSpanSizes); ++uSpanIdx)
+    {
+        aaInstances.push_back(getInstances(auSpanSizes[uSpanIdx], 100u + uSpanIdx));
+        aAllInstances.insert(aAllInstances.end(), aaInstances.back().begin(), aaInstances.back().end());
+    }
+    std::vector<InstanceSpan> aSpans;
+    for (const std::vector<InstanceData>& aInstances : aaInstances)
+    {
+        aSpans.push_back(InstanceSpan{ .pInstances = aInstances.data(), .uNumInstances = static_cast<UINT>(aInstances.size()) });
+    }
+    const std::vector<InstanceData> aExpected = cullReference(aPlanes, aAllInstances);
+
+    for (UINT uNumThreads : { 1u, 2u, 4u, 7u })
+    {
+        VoxelInstanceCuller culler(uNumThreads);
+        CHECK_EQUAL(uNumThreads, culler.GetNumThreads());
+
+        // Twice, the second frame reuses the scratch memory and the pool
+        for (UINT uFrame = 0u; uFrame < 2u; ++uFrame)
+        {
+            std::vector<InstanceData> aVisible(aAllInstances.size());
+            const UINT uNumVisible = culler.Cull(aWorldViewProjection.data(), aSpans.data(), static_cast<UINT>(aSpans.size()), aVisible.data());
+            CHECK(isEqual(aVisible.data(), uNumVisible, aExpected));
+        }
+
+        // A single batch is culled on the calling thread, no spans at all cull nothing
+        std::vector<InstanceData> aVisible(aAllInstances.size());
+        const UINT uNumVisible = culler.Cull(aWorldViewProjection.data(), &aSpans[3], 1u, aVisible.data());
+        CHECK(isEqual(aVisible.data(), uNumVisible, cullReference(aPlanes, aaInstances[3])));
+        CHECK_EQUAL(0u, culler.Cull(aWorldViewProjection.data(), aSpans.data(), 1u, aVisible.data()));
+        CHECK_EQUAL(0u, culler.Cull(aWorldViewProjection.data(), nullptr, 0u, aVisible.data()));
+    }
+}
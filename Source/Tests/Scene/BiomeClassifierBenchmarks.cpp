@@ -0,0 +1,70 @@
+#include "Test.h"
+
+#include <vector>
+
+#include "Scene/BiomeClassifier.h"
+#include "Scene/BiomeLadder.h"
+#include "Scene/PerlinNoise.h"
+
+using namespace library;
+
+BENCHMARK(BiomeClassifierTableVsLadder)
+{
+    // A 4096x4096 grid of the height and moisture noise the terrain is classified from
+    constexpr const UINT GRID_SIZE = 4096u;
+    constexpr const size_t NUM_COLUMNS = static_cast<size_t>(GRID_SIZE) * GRID_SIZE;
+    constexpr const FLOAT FREQUENCY = 0.0173f;
+    std::vector<FLOAT> aHeights(NUM_COLUMNS);
+    std::vector<FLOAT> aMoistures(NUM_COLUMNS);
+    PerlinNoise(16u).GetPerlin2dBatch(0.0f, 0.0f, 1.0f, GRID_SIZE, GRID_SIZE, FREQUENCY, 4u, aHeights.data());
+    PerlinNoise(61u).GetPerlin2dBatch(0.0f, 0.0f, 1.0f, GRID_SIZE, GRID_SIZE, FREQUENCY, 4u, aMoistures.data());
+
+    const BiomeClassifier classifier;
+    std::vector<eBlockType> aLadder(NUM_COLUMNS);
+    std::vector<eBlockType> aColumns(NUM_COLUMNS);
+    std::vector<eBlockType> aRows(NUM_COLUMNS);
+    const double ladderMilliseconds = test::MeasureMilliseconds(5u, [&]()
+    {
+        for (size_t i = 0u; i < NUM_COLUMNS; ++i)
+        {
+            aLadder[i] = test::GetLadderBiome(aHeights[i], aMoistures[i]);
+        }
+    });
+    const double columnMilliseconds = test::MeasureMilliseconds(5u, [&]()
+    {
+        for (size_t i = 0u; i < NUM_COLUMNS; ++i)
+        {
+            aColumns[i] = classifier.Classify(aHeights[i], aMoistures[i]);
+        }
+    });
+    const double rowMilliseconds = test::MeasureMilliseconds(5u, [&]()
+    {
+        for (size_t uRowIdx = 0u; uRowIdx < NUM_COLUMNS; uRowIdx += GRID_SIZE)
+        {
+            classifier.ClassifyRow(aHeights.data() + uRowIdx, aMoistures.data() + uRowIdx, GRID_SIZE, aRows.data() + uRowIdx);
+        }
+    });
+    CHECK(aColumns == aRows);
+
+    // Only the boundaries may differ from the ladder
+    UINT uNumMismatches = 0u;
+    UINT uNumBoundaryMismatches = 0u;
+    for (size_t i = 0u; i < NUM_COLUMNS; ++i)
+    {
+        if (aLadder[i] == aRows[i])
+        {
+            continue;
+        }
+        if (test::IsOnLadderBoundary(aHeights[i], aMoistures[i]))
+        {
+            ++uNumBoundaryMismatches;
+        }
+        else
+        {
+            ++uNumMismatches;
+        }
+    }
+    CHECK_EQUAL(0u, uNumMismatches);
+
+    std::printf("  %ux%u  ladder %7.3f ms  Classify %7.3f ms  ClassifyRow %7.3f ms  %.2fx  %u columns on a boundary\n", GRID_SIZE, GRID_SIZE, ladderMilliseconds, columnMilliseconds, rowMilliseconds, ladderMilliseconds / rowMilliseconds, uNumBoundaryMismatches);
+}
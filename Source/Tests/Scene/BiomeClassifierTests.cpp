@@ -0,0 +1,197 @@
+#include "Test.h"
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "Scene/BiomeClassifier.h"
+#include "Scene/BiomeLadder.h"
+
+using namespace library;
+
+namespace
+{
+    constexpr const UINT RESOLUTION = BiomeClassifier::RESOLUTION;
+
+    // Every threshold of the ladder along either axis
+    constexpr const FLOAT THRESHOLDS[] = { 0.1f, 0.12f, 0.16f, 0.2f, 0.3f, 0.33f, 0.5f, 0.6f, 0.66f, 0.8f, 0.83f };
+
+    // Column on one of the boundaries, with the biome of the table and the biome of the ladder
+    struct BoundaryColumn
+    {
+        FLOAT Height;
+        FLOAT Moisture;
+        eBlockType TableBlockType;
+        eBlockType LadderBlockType;
+    };
+
+    constexpr const BoundaryColumn BOUNDARY_COLUMNS[] = {
+        { 0.3f, 0.05f, eBlockType::TEMPERATE_DESERT, eBlockType::SUBTROPICAL_DESERT },
+        { 0.3f, 0.4f, eBlockType::GRASSLAND, eBlockType::TROPICAL_SEASONAL_FOREST },
+        { 0.3f, 0.6f, eBlockType::TEMPERATE_DECIDUOUS_FOREST, eBlockType::TROPICAL_SEASONAL_FOREST },
+        { 0.3f, 0.9f, eBlockType::TEMPERATE_RAIN_FOREST, eBlockType::TROPICAL_RAIN_FOREST },
+        { 0.6f, 0.25f, eBlockType::TEMPERATE_DESERT, eBlockType::GRASSLAND },
+        { 0.6f, 0.4f, eBlockType::SHRUBLAND, eBlockType::GRASSLAND },
+        { 0.6f, 0.7f, eBlockType::TAIGA, eBlockType::TEMPERATE_DECIDUOUS_FOREST },
+        { 0.6f, 0.9f, eBlockType::TAIGA, eBlockType::TEMPERATE_RAIN_FOREST },
+        { 0.8f, 0.05f, eBlockType::SCORCHED, eBlockType::TEMPERATE_DESERT },
+        { 0.8f, 0.15f, eBlockType::BARE, eBlockType::TEMPERATE_DESERT },
+        { 0.8f, 0.4f, eBlockType::TUNDRA, eBlockType::SHRUBLAND },
+        { 0.8f, 0.7f, eBlockType::SNOW, eBlockType::TAIGA },
+        { 0.2f, 0.329999983f, eBlockType::TROPICAL_SEASONAL_FOREST, eBlockType::GRASSLAND },
+        { 0.7f, 0.329999983f, eBlockType::SHRUBLAND, eBlockType::TEMPERATE_DESERT },
+        { 0.2f, 0.659999967f, eBlockType::TROPICAL_RAIN_FOREST, eBlockType::TROPICAL_SEASONAL_FOREST },
+        { 0.7f, 0.659999967f, eBlockType::TAIGA, eBlockType::SHRUBLAND },
+    };
+
+    // Center of a step of the table
+    FLOAT getCenter(_In_ UINT uStep)
+    {
+        return (static_cast<FLOAT>(uStep) + 0.5f) / BiomeClassifier::STEPS_PER_UNIT;
+    }
+}
+
+TEST(BiomeClassifierMatchesTheLadder)
+{
+    const BiomeClassifier classifier;
+    CHECK(classifier.GetTable() == BiomeClassifier::DEFAULT_TABLE);
+
+    // The center of every cell
+    UINT uNumMismatches = 0u;
+    for (UINT uHeightIdx = 0u; uHeightIdx < RESOLUTION; ++uHeightIdx)
+    {
+        for (UINT uMoistureIdx = 0u; uMoistureIdx < RESOLUTION; ++uMoistureIdx)
+        {
+            const eBlockType expected = test::GetLadderBiome(getCenter(uHeightIdx), getCenter(uMoistureIdx));
+            uNumMismatches += expected != classifier.GetTable()[static_cast<size_t>(uHeightIdx) * RESOLUTION + uMoistureIdx] ? 1u : 0u;
+            uNumMismatches += expected != classifier.Classify(getCenter(uHeightIdx), getCenter(uMoistureIdx)) ? 1u : 0u;
+        }
+    }
+    CHECK_EQUAL(0u, uNumMismatches);
+
+    // Every float within 64 ulps of each threshold, across the center of every cell of the other axis
+    UINT uNumBoundaryMismatches = 0u;
+    for (FLOAT threshold : THRESHOLDS)
+    {
+        FLOAT value = threshold;
+        for (UINT i = 0u; i < 64u; ++i)
+        {
+            value = std::nextafter(value, 0.0f);
+        }
+        for (UINT i = 0u; i <= 128u; ++i, value = std::nextafter(value, 1.0f))
+        {
+            for (UINT uStep = 0u; uStep < RESOLUTION; ++uStep)
+            {
+                const FLOAT aColumns[][2] = { { value, getCenter(uStep) }, { getCenter(uStep), value } };
+                for (const FLOAT(&column)[2] : aColumns)
+                {
+                    if (classifier.Classify(column[0], column[1]) == test::GetLadderBiome(column[0], column[1]))
+                    {
+                        continue;
+                    }
+                    if (test::IsOnLadderBoundary(column[0], column[1]))
+                    {
+                        ++uNumBoundaryMismatches;
+                    }
+                    else
+                    {
+                        ++uNumMismatches;
+                    }
+                }
+            }
+        }
+    }
+    CHECK_EQUAL(0u, uNumMismatches);
+    CHECK(uNumBoundaryMismatches > 0u);
+
+    // The boundaries themselves
+    for (const BoundaryColumn& column : BOUNDARY_COLUMNS)
+    {
+        CHECK(test::IsOnLadderBoundary(column.Height, column.Moisture));
+        CHECK(column.TableBlockType == classifier.Classify(column.Height, column.Moisture));
+        CHECK(column.LadderBlockType == test::GetLadderBiome(column.Height, column.Moisture));
+    }
+    CHECK_EQUAL(std::nextafter(0.33f, 0.0f), test::LADDER_BOUNDARY_MOISTURES[0]);
+    CHECK_EQUAL(std::nextafter(0.66f, 0.0f), test::LADDER_BOUNDARY_MOISTURES[1]);
+}
+
+TEST(BiomeClassifierClampsToTheTable)
+{
+    const BiomeClassifier classifier;
+    constexpr const FLOAT NOT_A_NUMBER = std::numeric_limits<FLOAT>::quiet_NaN();
+    constexpr const FLOAT INFINITE = std::numeric_limits<FLOAT>::infinity();
+
+    // Below the table, NaN included, is the first step, above it the last
+    for (FLOAT low : { -0.5f, -INFINITE, NOT_A_NUMBER, -NOT_A_NUMBER })
+    {
+        CHECK(classifier.Classify(low, 0.4f) == eBlockType::OCEAN);
+        CHECK(classifier.Classify(0.2f, low) == eBlockType::SUBTROPICAL_DESERT);
+        CHECK(classifier.Classify(low, low) == classifier.GetTable()[0]);
+    }
+    for (FLOAT high : { 1.27f, 1.5f, 1.0e9f, INFINITE })
+    {
+        CHECK(classifier.Classify(high, 0.05f) == eBlockType::SCORCHED);
+        CHECK(classifier.Classify(0.2f, high) == eBlockType::TROPICAL_RAIN_FOREST);
+        CHECK(classifier.Classify(high, high) == classifier.GetTable().back());
+    }
+}
+
+TEST(BiomeClassifierClassifiesRows)
+{
+    // Rows from shorter than a block of 4 to a few blocks and a tail, in and out of the table
+    const BiomeClassifier classifier;
+    std::mt19937 random(16u);
+    std::uniform_real_distribution<FLOAT> distribution(-0.2f, 1.5f);
+    UINT uNumMismatches = 0u;
+    for (UINT uNumColumns : { 1u, 3u, 4u, 7u, 64u, 1001u })
+    {
+        std::vector<FLOAT> aHeights(uNumColumns);
+        std::vector<FLOAT> aMoistures(uNumColumns);
+        for (UINT i = 0u; i < uNumColumns; ++i)
+        {
+            aHeights[i] = distribution(random);
+            aMoistures[i] = distribution(random);
+        }
+        aHeights[0] = std::numeric_limits<FLOAT>::quiet_NaN();
+        aMoistures[uNumColumns - 1u] = std::numeric_limits<FLOAT>::quiet_NaN();
+        for (UINT i = 1u; i < uNumColumns && i < std::size(BOUNDARY_COLUMNS); i += 2u)
+        {
+            aHeights[i] = BOUNDARY_COLUMNS[i].Height;
+            aMoistures[i] = BOUNDARY_COLUMNS[i].Moisture;
+        }
+
+        std::vector<eBlockType> aBlockTypes(uNumColumns);
+        classifier.ClassifyRow(aHeights.data(), aMoistures.data(), uNumColumns, aBlockTypes.data());
+        for (UINT i = 0u; i < uNumColumns; ++i)
+        {
+            uNumMismatches += aBlockTypes[i] != classifier.Classify(aHeights[i], aMoistures[i]) ? 1u : 0u;
+        }
+    }
+    CHECK_EQUAL(0u, uNumMismatches);
+}
+
+TEST(BiomeClassifierRebuildsItsTable)
+{
+    // Snow above 0.5 in front of the defaults, and back
+    BiomeClassifier classifier;
+    std::vector<BiomeRegion> aRegions = { { 0.5f, FLT_MAX, 0.0f, FLT_MAX, eBlockType::SNOW } };
+    aRegions.insert(aRegions.end(), std::begin(BiomeClassifier::DEFAULT_REGIONS), std::end(BiomeClassifier::DEFAULT_REGIONS));
+    classifier.SetRegions(aRegions.data(), aRegions.size());
+    CHECK(classifier.Classify(0.55f, 0.05f) == eBlockType::SNOW);
+    CHECK(classifier.Classify(0.5f, 0.9f) == eBlockType::SNOW);
+    CHECK(classifier.Classify(0.49f, 0.05f) == eBlockType::TEMPERATE_DESERT);
+    CHECK(classifier.Classify(0.05f, 0.05f) == eBlockType::OCEAN);
+
+    // No region at all is grassland everywhere
+    classifier.SetRegions(nullptr, 0u);
+    UINT uNumGrassland = 0u;
+    for (eBlockType blockType : classifier.GetTable())
+    {
+        uNumGrassland += blockType == eBlockType::GRASSLAND ? 1u : 0u;
+    }
+    CHECK_EQUAL(RESOLUTION * RESOLUTION, uNumGrassland);
+
+    classifier.SetRegions(BiomeClassifier::DEFAULT_REGIONS, std::size(BiomeClassifier::DEFAULT_REGIONS));
+    CHECK(classifier.GetTable() == BiomeClassifier::DEFAULT_TABLE);
+}
@@ -0,0 +1,145 @@
+/*+===================================================================
+  File:      BIOMELADDER.H
+
+  Summary:   BiomeLadder header file contains the if/else ladder of
+             thresholds that classified the columns before the
+             BiomeClassifier table, to test and benchmark the table
+             against.
+
+  Functions: GetLadderBiome, IsOnLadderBoundary
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Platform.h"
+
+namespace test
+{
+    // The only values the table and the ladder disagree on: the ladder puts a height of exactly 0.3, 0.6 or 0.8 in
+    // the band below, and x * 100 of the moisture right under 0.33 or 0.66 rounds up to the step above
+    constexpr const FLOAT LADDER_BOUNDARY_HEIGHTS[] = { 0.3f, 0.6f, 0.8f };
+    constexpr const FLOAT LADDER_BOUNDARY_MOISTURES[] = { 0.329999983f, 0.659999967f };
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: GetLadderBiome
+
+      Summary:  Returns the biome of a column the way the ladder did.
+                Its upper bands start above their threshold, where the
+                regions of the table start at it
+
+      Args:     FLOAT height
+                  Height of the column
+                FLOAT moisture
+                  Moisture of the column
+
+      Returns:  library::eBlockType
+                  Biome of the column
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    inline library::eBlockType GetLadderBiome(_In_ FLOAT height, _In_ FLOAT moisture)
+    {
+        if (height < 0.1f)
+        {
+            return library::eBlockType::OCEAN;
+        }
+        if (height < 0.12f)
+        {
+            return library::eBlockType::SAND;
+        }
+
+        if (height > 0.8f)
+        {
+            if (moisture < 0.1f)
+            {
+                return library::eBlockType::SCORCHED;
+            }
+            if (moisture < 0.2f)
+            {
+                return library::eBlockType::BARE;
+            }
+            if (moisture < 0.5f)
+            {
+                return library::eBlockType::TUNDRA;
+            }
+            return library::eBlockType::SNOW;
+        }
+
+        if (height > 0.6f)
+        {
+            if (moisture < 0.33f)
+            {
+                return library::eBlockType::TEMPERATE_DESERT;
+            }
+            if (moisture < 0.66f)
+            {
+                return library::eBlockType::SHRUBLAND;
+            }
+            return library::eBlockType::TAIGA;
+        }
+
+        if (height > 0.3f)
+        {
+            if (moisture < 0.16f)
+            {
+                return library::eBlockType::TEMPERATE_DESERT;
+            }
+            if (moisture < 0.5f)
+            {
+                return library::eBlockType::GRASSLAND;
+            }
+            if (moisture < 0.83f)
+            {
+                return library::eBlockType::TEMPERATE_DECIDUOUS_FOREST;
+            }
+            return library::eBlockType::TEMPERATE_RAIN_FOREST;
+        }
+
+        if (moisture < 0.16f)
+        {
+            return library::eBlockType::SUBTROPICAL_DESERT;
+        }
+        if (moisture < 0.33f)
+        {
+            return library::eBlockType::GRASSLAND;
+        }
+        if (moisture < 0.66f)
+        {
+            return library::eBlockType::TROPICAL_SEASONAL_FOREST;
+        }
+        return library::eBlockType::TROPICAL_RAIN_FOREST;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: IsOnLadderBoundary
+
+      Summary:  Returns whether a column is on one of the boundaries
+                the table and the ladder disagree on
+
+      Args:     FLOAT height
+                  Height of the column
+                FLOAT moisture
+                  Moisture of the column
+
+      Returns:  BOOL
+                  TRUE if the height or the moisture is a boundary
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    inline BOOL IsOnLadderBoundary(_In_ FLOAT height, _In_ FLOAT moisture)
+    {
+        for (FLOAT boundary : LADDER_BOUNDARY_HEIGHTS)
+        {
+            if (height == boundary)
+            {
+                return TRUE;
+            }
+        }
+        for (FLOAT boundary : LADDER_BOUNDARY_MOISTURES)
+        {
+            if (moisture == boundary)
+            {
+                return TRUE;
+            }
+        }
+
+        return FALSE;
+    }
+}
@@ -0,0 +1,117 @@
+#include "Test.h"
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <thread>
+#include <utility>
+
+#include "Scene/ChunkCache.h"
+#include "Scene/ChunkStreamer.h"
+
+using namespace library;
+
+namespace
+{
+    constexpr const UINT NUM_CHUNKS = 32u;
+    constexpr const UINT HEIGHT = 64u;
+    constexpr const UINT NUM_THREADS = 4u;
+
+    typedef std::map<std::pair<UINT, UINT>, StreamedChunk> ChunkMap;
+
+    // Milliseconds from creating a streamer to every chunk within 6 chunks of the center of the map being resident
+    double startUp(_In_ const std::filesystem::path& directory, _Out_ ChunkMap& chunks)
+    {
+        const FLOAT center = static_cast<FLOAT>(NUM_CHUNKS * ChunkStreamer::CHUNK_SIZE) * 0.5f;
+        const auto start = std::chrono::steady_clock::now();
+        ChunkStreamer streamer(9u, NUM_CHUNKS, NUM_CHUNKS, HEIGHT, 6.0f, 8.0f, 1000u, directory, NUM_THREADS);
+        chunks.clear();
+        do
+        {
+            std::vector<StreamedChunk> aPromoted;
+            std::vector<std::pair<UINT, UINT>> aEvicted;
+            streamer.Update(center, center, 1000u, aPromoted, aEvicted);
+            for (StreamedChunk& chunk : aPromoted)
+            {
+                chunks.emplace(std::make_pair(chunk.ChunkX, chunk.ChunkZ), std::move(chunk));
+            }
+            std::this_thread::yield();
+        } while (streamer.GetNumPending() > 0u);
+
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+BENCHMARK(ChunkCacheColdVsWarmStartup)
+{
+    // Generating and storing every chunk around the camera, then reading them back on the next launch
+    const std::filesystem::path directory = test::GetTemporaryPath("ChunkCacheBenchmark");
+    double coldMilliseconds = 1.0e9;
+    double warmMilliseconds = 1.0e9;
+    ChunkMap cold;
+    ChunkMap warm;
+    for (UINT uRepetition = 0u; uRepetition < 3u; ++uRepetition)
+    {
+        std::filesystem::remove_all(directory);
+        coldMilliseconds = std::min(coldMilliseconds, startUp(directory, cold));
+        warmMilliseconds = std::min(warmMilliseconds, startUp(directory, warm));
+    }
+
+    UINT uNumDifferent = cold.size() == warm.size() ? 0u : 1u;
+    for (const std::pair<const std::pair<UINT, UINT>, StreamedChunk>& chunk : cold)
+    {
+        const ChunkMap::const_iterator it = warm.find(chunk.first);
+        uNumDifferent += it != warm.end() && it->second.Heights == chunk.second.Heights && it->second.BlockTypes == chunk.second.BlockTypes ? 0u : 1u;
+    }
+    CHECK_EQUAL(0u, uNumDifferent);
+
+    std::printf("  %zu chunks on %u threads  cold %7.3f ms  warm %7.3f ms  %.2fx\n", cold.size(), NUM_THREADS, coldMilliseconds, warmMilliseconds, coldMilliseconds / warmMilliseconds);
+
+    // Every chunk of a region loaded from one thread and from several, which share the lock of the region
+    constexpr const UINT NUM_COLUMNS = ChunkCache::CHUNK_SIZE * ChunkCache::CHUNK_SIZE;
+    constexpr const UINT64 FINGERPRINT = 0x5EEDull;
+    std::filesystem::remove_all(directory);
+    {
+        ChunkCache cache(directory, FINGERPRINT, HEIGHT);
+        std::vector<WORD> aHeights(NUM_COLUMNS);
+        std::vector<eBlockType> aBlockTypes(NUM_COLUMNS, eBlockType::GRASSLAND);
+        for (UINT uChunkIdx = 0u; uChunkIdx < ChunkCache::REGION_SIZE * ChunkCache::REGION_SIZE; ++uChunkIdx)
+        {
+            for (UINT i = 0u; i < NUM_COLUMNS; ++i)
+            {
+                aHeights[i] = static_cast<WORD>((i * 7u + uChunkIdx) % HEIGHT);
+            }
+            cache.Store(uChunkIdx % ChunkCache::REGION_SIZE, uChunkIdx / ChunkCache::REGION_SIZE, aHeights.data(), aBlockTypes.data());
+        }
+    }
+
+    {
+        ChunkCache cache(directory, FINGERPRINT, HEIGHT);
+        const auto loadRegion = [&cache](_In_ UINT uNumThreads)
+        {
+            std::vector<std::thread> aThreads;
+            for (UINT uThreadIdx = 0u; uThreadIdx < uNumThreads; ++uThreadIdx)
+            {
+                aThreads.emplace_back([&cache, uThreadIdx, uNumThreads]()
+                {
+                    std::vector<WORD> aHeights(NUM_COLUMNS);
+                    std::vector<eBlockType> aBlockTypes(NUM_COLUMNS);
+                    for (UINT uChunkIdx = uThreadIdx; uChunkIdx < ChunkCache::REGION_SIZE * ChunkCache::REGION_SIZE; uChunkIdx += uNumThreads)
+                    {
+                        cache.Load(uChunkIdx % ChunkCache::REGION_SIZE, uChunkIdx / ChunkCache::REGION_SIZE, aHeights.data(), aBlockTypes.data());
+                    }
+                });
+            }
+            for (std::thread& thread : aThreads)
+            {
+                thread.join();
+            }
+        };
+        const double oneThreadMilliseconds = test::MeasureMilliseconds(5u, [&]() { loadRegion(1u); });
+        const double threadsMilliseconds = test::MeasureMilliseconds(5u, [&]() { loadRegion(NUM_THREADS); });
+        CHECK_EQUAL(0u, cache.GetNumMisses());
+
+        std::printf("  %u chunks of a region  1 thread %7.3f ms  %u threads %7.3f ms  %.2fx\n", ChunkCache::REGION_SIZE * ChunkCache::REGION_SIZE, oneThreadMilliseconds, NUM_THREADS, threadsMilliseconds, oneThreadMilliseconds / threadsMilliseconds);
+    }
+    std::filesystem::remove_all(directory);
+}
@@ -0,0 +1,404 @@
+#include "Test.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <random>
+#include <thread>
+
+#include "Scene/ChunkCache.h"
+
+using namespace library;
+
+namespace
+{
+    constexpr const UINT NUM_COLUMNS = ChunkCache::CHUNK_SIZE * ChunkCache::CHUNK_SIZE;
+    constexpr const UINT64 FINGERPRINT = 0x0123456789ABCDEFull;
+    constexpr const UINT HEIGHT = 64u;
+    constexpr const size_t TABLE_END = sizeof(ChunkRegionHeader) + sizeof(ChunkRegionEntry) * ChunkCache::REGION_SIZE * ChunkCache::REGION_SIZE;
+
+    struct Chunk
+    {
+        std::vector<WORD> aHeights;
+        std::vector<eBlockType> aBlockTypes;
+    };
+
+    // Gentle slopes under the height of the map and runs of up to 40 columns of a biome
+    Chunk makeChunk(_In_ UINT uSeed)
+    {
+        std::mt19937 random(uSeed);
+        Chunk chunk = { .aHeights = std::vector<WORD>(NUM_COLUMNS), .aBlockTypes = std::vector<eBlockType>(NUM_COLUMNS) };
+        INT iHeight = static_cast<INT>(random() % HEIGHT);
+        for (UINT i = 0u; i < NUM_COLUMNS;)
+        {
+            const UINT uRunLength = std::min(1u + static_cast<UINT>(random() % 40u), NUM_COLUMNS - i);
+            const eBlockType blockType = static_cast<eBlockType>(static_cast<UINT>(eBlockType::GRASSLAND) + random() % (static_cast<UINT>(eBlockType::COUNT) - static_cast<UINT>(eBlockType::GRASSLAND)));
+            for (UINT j = i; j < i + uRunLength; ++j)
+            {
+                iHeight = std::clamp(iHeight + static_cast<INT>(random() % 7u) - 3, 0, static_cast<INT>(HEIGHT));
+                chunk.aHeights[j] = static_cast<WORD>(iHeight);
+                chunk.aBlockTypes[j] = blockType;
+            }
+            i += uRunLength;
+        }
+
+        return chunk;
+    }
+
+    // Loads a chunk and compares it, a miss is never equal
+    BOOL loadsEqual(_Inout_ ChunkCache& cache, _In_ UINT uChunkX, _In_ UINT uChunkZ, _In_ const Chunk& expected)
+    {
+        Chunk chunk = { .aHeights = std::vector<WORD>(NUM_COLUMNS), .aBlockTypes = std::vector<eBlockType>(NUM_COLUMNS) };
+        return cache.Load(uChunkX, uChunkZ, chunk.aHeights.data(), chunk.aBlockTypes.data()) && chunk.aHeights == expected.aHeights && chunk.aBlockTypes == expected.aBlockTypes;
+    }
+
+    BOOL isMissing(_Inout_ ChunkCache& cache, _In_ UINT uChunkX, _In_ UINT uChunkZ)
+    {
+        WORD aHeights[NUM_COLUMNS];
+        eBlockType aBlockTypes[NUM_COLUMNS];
+        return !cache.Load(uChunkX, uChunkZ, aHeights, aBlockTypes);
+    }
+
+    // Where the cache keeps a region, after the format of ChunkCache.h
+    std::filesystem::path getRegionPath(_In_ const std::filesystem::path& directory, _In_ UINT64 uFingerprint, _In_ UINT uHeight, _In_ UINT uRegionX, _In_ UINT uRegionZ)
+    {
+        CHAR szName[32];
+        std::snprintf(szName, sizeof(szName), "%016llx-%u", static_cast<unsigned long long>(uFingerprint), uHeight);
+        return directory / szName / ("r." + std::to_string(uRegionX) + "." + std::to_string(uRegionZ) + ChunkCache::EXTENSION);
+    }
+
+    std::vector<BYTE> readFile(_In_ const std::filesystem::path& path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        return std::vector<BYTE>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    void writeFile(_In_ const std::filesystem::path& path, _In_ const std::vector<BYTE>& aData)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(aData.data()), static_cast<std::streamsize>(aData.size()));
+    }
+
+    ChunkRegionEntry getEntry(_In_ const std::vector<BYTE>& aRegion, _In_ UINT uEntryIdx)
+    {
+        ChunkRegionEntry entry;
+        std::memcpy(&entry, aRegion.data() + sizeof(ChunkRegionHeader) + sizeof(ChunkRegionEntry) * uEntryIdx, sizeof(entry));
+        return entry;
+    }
+
+    void setEntry(_Inout_ std::vector<BYTE>& aRegion, _In_ UINT uEntryIdx, _In_ const ChunkRegionEntry& entry)
+    {
+        std::memcpy(aRegion.data() + sizeof(ChunkRegionHeader) + sizeof(ChunkRegionEntry) * uEntryIdx, &entry, sizeof(entry));
+    }
+}
+
+TEST(ChunkCacheCompressesTheEndsOfAChunk)
+{
+    // A flat chunk of one biome: one byte per height and runs of 255, 255, 255, 255 and 4
+    Chunk flat = { .aHeights = std::vector<WORD>(NUM_COLUMNS, 0u), .aBlockTypes = std::vector<eBlockType>(NUM_COLUMNS, eBlockType::GRASSLAND) };
+    std::vector<BYTE> aFlat;
+    ChunkCache::Compress(flat.aHeights.data(), flat.aBlockTypes.data(), aFlat);
+    CHECK_EQUAL(NUM_COLUMNS + 5u * 2u, aFlat.size());
+    CHECK(aFlat[aFlat.size() - 2u] == 4u && aFlat[aFlat.size() - 4u] == 0xFFu);
+
+    // Deltas on both sides of each varint length, ending on a 3 byte jump to 65535, and a run of exactly 255 before a run of 1
+    Chunk edges = { .aHeights = std::vector<WORD>(NUM_COLUMNS, 0u), .aBlockTypes = std::vector<eBlockType>(NUM_COLUMNS, eBlockType::SNOW) };
+    constexpr const WORD HEIGHTS[] = { 63u, 127u, 63u, 128u, 63u, 8254u, 63u, 8255u, 0u, 65535u, 0u };
+    std::copy(std::begin(HEIGHTS), std::end(HEIGHTS), edges.aHeights.begin());
+    edges.aHeights[NUM_COLUMNS - 1u] = 65535u;
+    std::fill(edges.aBlockTypes.begin() + 768, edges.aBlockTypes.end(), eBlockType::SAND);
+    edges.aBlockTypes[NUM_COLUMNS - 1u] = eBlockType::OCEAN;
+
+    std::vector<BYTE> aEdges;
+    ChunkCache::Compress(edges.aHeights.data(), edges.aBlockTypes.data(), aEdges);
+    const std::vector<BYTE> aExpectedEnd = { 0xFEu, 0xFFu, 0x07u, 255u, static_cast<BYTE>(eBlockType::SNOW), 255u, static_cast<BYTE>(eBlockType::SNOW), 255u, static_cast<BYTE>(eBlockType::SNOW), 3u, static_cast<BYTE>(eBlockType::SNOW), 255u, static_cast<BYTE>(eBlockType::SAND), 1u, static_cast<BYTE>(eBlockType::OCEAN) };
+    CHECK(aEdges.size() > aExpectedEnd.size() && std::equal(aExpectedEnd.begin(), aExpectedEnd.end(), aEdges.end() - static_cast<std::ptrdiff_t>(aExpectedEnd.size())));
+
+    for (const Chunk* pChunk : { &flat, &edges })
+    {
+        std::vector<BYTE> aData;
+        ChunkCache::Compress(pChunk->aHeights.data(), pChunk->aBlockTypes.data(), aData);
+        Chunk decompressed = { .aHeights = std::vector<WORD>(NUM_COLUMNS), .aBlockTypes = std::vector<eBlockType>(NUM_COLUMNS) };
+        CHECK(ChunkCache::Decompress(aData.data(), aData.size(), decompressed.aHeights.data(), decompressed.aBlockTypes.data()));
+        CHECK(decompressed.aHeights == pChunk->aHeights);
+        CHECK(decompressed.aBlockTypes == pChunk->aBlockTypes);
+
+        // Every shorter prefix and a byte too many
+        UINT uNumAccepted = 0u;
+        for (size_t uSize = 0u; uSize < aData.size(); ++uSize)
+        {
+            uNumAccepted += ChunkCache::Decompress(aData.data(), uSize, decompressed.aHeights.data(), decompressed.aBlockTypes.data()) ? 1u : 0u;
+        }
+        CHECK_EQUAL(0u, uNumAccepted);
+        aData.push_back(0u);
+        CHECK(!ChunkCache::Decompress(aData.data(), aData.size(), decompressed.aHeights.data(), decompressed.aBlockTypes.data()));
+    }
+
+    // Broken data at the ends of the edge chunk
+    WORD aHeights[NUM_COLUMNS];
+    eBlockType aBlockTypes[NUM_COLUMNS];
+    const size_t uLastVarint = aEdges.size() - aExpectedEnd.size() + 2u;
+    const size_t uLastRun = aEdges.size() - 2u;
+    const std::function<void(std::vector<BYTE>&)> aBreaks[] = {
+        [](std::vector<BYTE>& aData) { aData[0] = 0x7Fu; },
+        [=](std::vector<BYTE>& aData) { aData[uLastVarint] |= 0x80u; },
+        [=](std::vector<BYTE>& aData) { aData[uLastVarint] = 0x08u; },
+        [=](std::vector<BYTE>& aData) { aData[uLastRun] = 2u; },
+        [=](std::vector<BYTE>& aData) { aData[uLastRun] = 0u; },
+        [=](std::vector<BYTE>& aData) { aData[uLastRun + 1u] = static_cast<BYTE>(eBlockType::COUNT); },
+        [=](std::vector<BYTE>& aData) { aData[uLastRun + 1u] = 0u; },
+        [=](std::vector<BYTE>& aData) { aData.insert(aData.begin() + static_cast<std::ptrdiff_t>(uLastRun), { 0u, static_cast<BYTE>(eBlockType::OCEAN) }); },
+    };
+    for (const std::function<void(std::vector<BYTE>&)>& breakData : aBreaks)
+    {
+        std::vector<BYTE> aData = aEdges;
+        breakData(aData);
+        CHECK(!ChunkCache::Decompress(aData.data(), aData.size(), aHeights, aBlockTypes));
+    }
+
+    // A varint longer than 32 bits
+    std::vector<BYTE> aLong = aFlat;
+    aLong.insert(aLong.begin(), { 0x80u, 0x80u, 0x80u, 0x80u, 0x80u });
+    CHECK(!ChunkCache::Decompress(aLong.data(), aLong.size(), aHeights, aBlockTypes));
+}
+
+TEST(ChunkCacheStoresAndLoads)
+{
+    const std::filesystem::path directory = test::GetTemporaryPath("ChunkCache");
+    std::filesystem::remove_all(directory);
+
+    // Both corners of the first region, the next regions along x and z and one far away
+    constexpr const UINT CHUNKS[][2] = { { 0u, 0u }, { 31u, 31u }, { 32u, 0u }, { 5u, 40u }, { 1000u, 3u } };
+    std::vector<Chunk> aChunks;
+    {
+        ChunkCache cache(directory, FINGERPRINT, HEIGHT);
+        for (const UINT(&chunk)[2] : CHUNKS)
+        {
+            aChunks.push_back(makeChunk(chunk[0] * 97u + chunk[1]));
+            cache.Store(chunk[0], chunk[1], aChunks.back().aHeights.data(), aChunks.back().aBlockTypes.data());
+        }
+        cache.Flush();
+
+        for (size_t i = 0u; i < aChunks.size(); ++i)
+        {
+            CHECK(loadsEqual(cache, CHUNKS[i][0], CHUNKS[i][1], aChunks[i]));
+        }
+        CHECK(isMissing(cache, 1u, 0u));
+        CHECK(isMissing(cache, 64u, 64u));
+        CHECK_EQUAL(static_cast<UINT>(aChunks.size()), cache.GetNumHits());
+        CHECK_EQUAL(2u, cache.GetNumMisses());
+    }
+
+    // Another launch, storing over a chunk and next to the others while they are loaded from several threads
+    {
+        ChunkCache cache(directory, FINGERPRINT, HEIGHT);
+        for (size_t i = 0u; i < aChunks.size(); ++i)
+        {
+            CHECK(loadsEqual(cache, CHUNKS[i][0], CHUNKS[i][1], aChunks[i]));
+        }
+
+        std::atomic<UINT> uNumWrong = 0u;
+        std::vector<std::thread> aThreads;
+        for (UINT uThreadIdx = 0u; uThreadIdx < 4u; ++uThreadIdx)
+        {
+            aThreads.emplace_back([&, uThreadIdx]()
+            {
+                for (UINT uPass = 0u; uPass < 200u; ++uPass)
+                {
+                    const size_t i = 1u + (uPass + uThreadIdx) % (aChunks.size() - 1u);
+                    uNumWrong += loadsEqual(cache, CHUNKS[i][0], CHUNKS[i][1], aChunks[i]) ? 0u : 1u;
+                }
+            });
+        }
+        const Chunk replaced = makeChunk(1u);
+        cache.Store(0u, 0u, replaced.aHeights.data(), replaced.aBlockTypes.data());
+        std::vector<Chunk> aAdded;
+        for (UINT x = 1u; x < 31u; ++x)
+        {
+            aAdded.push_back(makeChunk(1000u + x));
+            cache.Store(x, 5u, aAdded.back().aHeights.data(), aAdded.back().aBlockTypes.data());
+            CHECK(loadsEqual(cache, x, 5u, aAdded.back()));
+        }
+        for (std::thread& thread : aThreads)
+        {
+            thread.join();
+        }
+        CHECK_EQUAL(0u, uNumWrong.load());
+
+        cache.Flush();
+        CHECK(loadsEqual(cache, 0u, 0u, replaced));
+        for (UINT x = 1u; x < 31u; ++x)
+        {
+            CHECK(loadsEqual(cache, x, 5u, aAdded[x - 1u]));
+        }
+    }
+    std::filesystem::remove_all(directory);
+}
+
+TEST(ChunkCacheIsInvalidatedByItsKey)
+{
+    const std::filesystem::path directory = test::GetTemporaryPath("ChunkCacheKey");
+    std::filesystem::remove_all(directory);
+
+    const Chunk chunk = makeChunk(2u);
+    {
+        ChunkCache cache(directory, FINGERPRINT, HEIGHT);
+        cache.Store(3u, 4u, chunk.aHeights.data(), chunk.aBlockTypes.data());
+    }
+
+    // Another fingerprint or height misses, and storing under it leaves the first cache alone
+    const Chunk other = makeChunk(3u);
+    for (const std::pair<UINT64, UINT>& key : { std::make_pair(FINGERPRINT ^ 1u, HEIGHT), std::make_pair(FINGERPRINT, HEIGHT + 1u) })
+    {
+        ChunkCache cache(directory, key.first, key.second);
+        CHECK(isMissing(cache, 3u, 4u));
+        cache.Store(3u, 4u, other.aHeights.data(), other.aBlockTypes.data());
+        cache.Flush();
+        CHECK(loadsEqual(cache, 3u, 4u, other));
+    }
+    {
+        ChunkCache cache(directory, FINGERPRINT, HEIGHT);
+        CHECK(loadsEqual(cache, 3u, 4u, chunk));
+    }
+
+    // The region of another fingerprint under the name of this one is not read, and is replaced by the next write
+    const std::filesystem::path regionPath = getRegionPath(directory, FINGERPRINT, HEIGHT, 0u, 0u);
+    std::filesystem::copy_file(getRegionPath(directory, FINGERPRINT ^ 1u, HEIGHT, 0u, 0u), regionPath, std::filesystem::copy_options::overwrite_existing);
+    {
+        ChunkCache cache(directory, FINGERPRINT, HEIGHT);
+        CHECK(isMissing(cache, 3u, 4u));
+        cache.Store(7u, 7u, chunk.aHeights.data(), chunk.aBlockTypes.data());
+        cache.Flush();
+        CHECK(isMissing(cache, 3u, 4u));
+        CHECK(loadsEqual(cache, 7u, 7u, chunk));
+    }
+    ChunkRegionHeader header;
+    std::memcpy(&header, readFile(regionPath).data(), sizeof(header));
+    CHECK_EQUAL(FINGERPRINT, header.Fingerprint);
+    CHECK_EQUAL(HEIGHT, header.Height);
+    std::filesystem::remove_all(directory);
+}
+
+TEST(ChunkCacheRejectsDamagedRegions)
+{
+    const std::filesystem::path directory = test::GetTemporaryPath("ChunkCacheDamaged");
+    std::filesystem::remove_all(directory);
+
+    // Chunks 0 and 1 of a region, written in that order
+    const Chunk first = makeChunk(4u);
+    const Chunk second = makeChunk(5u);
+    {
+        ChunkCache cache(directory, FINGERPRINT, HEIGHT);
+        cache.Store(0u, 0u, first.aHeights.data(), first.aBlockTypes.data());
+        cache.Store(1u, 0u, second.aHeights.data(), second.aBlockTypes.data());
+    }
+    const std::filesystem::path regionPath = getRegionPath(directory, FINGERPRINT, HEIGHT, 0u, 0u);
+    const std::vector<BYTE> aRegion = readFile(regionPath);
+    const ChunkRegionEntry firstEntry = getEntry(aRegion, 0u);
+    const ChunkRegionEntry secondEntry = getEntry(aRegion, 1u);
+    CHECK_EQUAL(TABLE_END, static_cast<size_t>(firstEntry.Offset));
+    CHECK_EQUAL(static_cast<size_t>(secondEntry.Offset) + secondEntry.Size, aRegion.size());
+
+    // Damage the region, and whether each chunk still loads
+    struct Damage
+    {
+        std::function<void(std::vector<BYTE>&)> damage;
+        BOOL bFirstLoads;
+        BOOL bSecondLoads;
+    };
+    const Damage aDamages[] = {
+        { [](std::vector<BYTE>&) {}, TRUE, TRUE },
+        { [](std::vector<BYTE>& aData) { aData.resize(sizeof(ChunkRegionHeader) / 2u); }, FALSE, FALSE },
+        { [](std::vector<BYTE>& aData) { aData.resize(TABLE_END - 1u); }, FALSE, FALSE },
+        { [&](std::vector<BYTE>& aData) { aData.resize(secondEntry.Offset + secondEntry.Size / 2u); }, TRUE, FALSE },
+        { [&](std::vector<BYTE>& aData) { aData.resize(secondEntry.Offset + secondEntry.Size - 1u); }, TRUE, FALSE },
+        { [&](std::vector<BYTE>& aData) { setEntry(aData, 0u, ChunkRegionEntry{ .Offset = static_cast<UINT>(aData.size()), .Size = firstEntry.Size }); }, FALSE, TRUE },
+        { [&](std::vector<BYTE>& aData) { setEntry(aData, 0u, ChunkRegionEntry{ .Offset = firstEntry.Offset, .Size = UINT_MAX }); }, FALSE, TRUE },
+        { [&](std::vector<BYTE>& aData) { setEntry(aData, 1u, ChunkRegionEntry{ .Offset = UINT_MAX, .Size = 2u }); }, TRUE, FALSE },
+        { [&](std::vector<BYTE>& aData) { aData[firstEntry.Offset + firstEntry.Size - 1u] = 0u; }, FALSE, TRUE },
+        { [&](std::vector<BYTE>& aData) { aData[secondEntry.Offset] ^= 0x80u; }, TRUE, FALSE },
+        { [](std::vector<BYTE>& aData) { aData[0] = 'X'; }, FALSE, FALSE },
+        { [](std::vector<BYTE>& aData) { aData[offsetof(ChunkRegionHeader, Version)] += 1u; }, FALSE, FALSE },
+    };
+    for (const Damage& damage : aDamages)
+    {
+        std::vector<BYTE> aData = aRegion;
+        damage.damage(aData);
+        writeFile(regionPath, aData);
+
+        ChunkCache cache(directory, FINGERPRINT, HEIGHT);
+        CHECK_EQUAL(damage.bFirstLoads, loadsEqual(cache, 0u, 0u, first));
+        CHECK_EQUAL(damage.bSecondLoads, loadsEqual(cache, 1u, 0u, second));
+    }
+
+    // A region cut short of its table is written again from scratch
+    std::vector<BYTE> aCut = aRegion;
+    aCut.resize(TABLE_END - 8u);
+    writeFile(regionPath, aCut);
+    {
+        ChunkCache cache(directory, FINGERPRINT, HEIGHT);
+        cache.Store(2u, 0u, first.aHeights.data(), first.aBlockTypes.data());
+        cache.Flush();
+        CHECK(loadsEqual(cache, 2u, 0u, first));
+        CHECK(isMissing(cache, 0u, 0u));
+    }
+    CHECK_EQUAL(TABLE_END + firstEntry.Size, readFile(regionPath).size());
+    std::filesystem::remove_all(directory);
+}
+
+TEST(ChunkCacheLoadsQueuedChunks)
+{
+    // The directory of the cache is under a file, so no chunk is ever written and every hit comes from the queue
+    const std::filesystem::path file = test::GetTemporaryPath("ChunkCacheQueued");
+    std::filesystem::remove_all(file);
+    writeFile(file, { 0u });
+
+    UINT uNumQueued = 0u;
+    UINT uNumWrong = 0u;
+    std::vector<Chunk> aChunks;
+    {
+        ChunkCache cache(file / "Cache", FINGERPRINT, HEIGHT);
+        for (UINT x = 0u; x < 256u; ++x)
+        {
+            aChunks.push_back(makeChunk(x));
+            cache.Store(x, 9u, aChunks.back().aHeights.data(), aChunks.back().aBlockTypes.data());
+
+            Chunk chunk = { .aHeights = std::vector<WORD>(NUM_COLUMNS), .aBlockTypes = std::vector<eBlockType>(NUM_COLUMNS) };
+            if (cache.Load(x, 9u, chunk.aHeights.data(), chunk.aBlockTypes.data()))
+            {
+                ++uNumQueued;
+                uNumWrong += chunk.aHeights == aChunks.back().aHeights && chunk.aBlockTypes == aChunks.back().aBlockTypes ? 0u : 1u;
+            }
+        }
+        CHECK(uNumQueued > 0u);
+        CHECK_EQUAL(0u, uNumWrong);
+
+        cache.Flush();
+        UINT uNumMissing = 0u;
+        for (UINT x = 0u; x < 256u; ++x)
+        {
+            uNumMissing += isMissing(cache, x, 9u) ? 1u : 0u;
+        }
+        CHECK_EQUAL(256u, uNumMissing);
+    }
+    std::filesystem::remove(file);
+
+    // Loaded right after they are stored, a chunk is always either queued or written
+    const std::filesystem::path directory = test::GetTemporaryPath("ChunkCacheWritten");
+    std::filesystem::remove_all(directory);
+    {
+        ChunkCache cache(directory, FINGERPRINT, HEIGHT);
+        uNumWrong = 0u;
+        for (UINT x = 0u; x < 256u; ++x)
+        {
+            cache.Store(x, 9u, aChunks[x].aHeights.data(), aChunks[x].aBlockTypes.data());
+            uNumWrong += loadsEqual(cache, x, 9u, aChunks[x]) ? 0u : 1u;
+            uNumWrong += loadsEqual(cache, x / 2u, 9u, aChunks[x / 2u]) ? 0u : 1u;
+        }
+        CHECK_EQUAL(0u, uNumWrong);
+    }
+    std::filesystem::remove_all(directory);
+}
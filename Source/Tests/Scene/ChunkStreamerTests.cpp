@@ -0,0 +1,285 @@
+#include "Test.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <set>
+#include <thread>
+#include <utility>
+
+#include "Scene/ChunkStreamer.h"
+#include "Scene/VoxelLods.h"
+
+using namespace library;
+
+namespace
+{
+    constexpr const UINT CHUNK_SIZE = ChunkStreamer::CHUNK_SIZE;
+    constexpr const UINT NUM_CHUNKS = 16u;
+    constexpr const UINT HEIGHT = 64u;
+
+    typedef std::set<std::pair<UINT, UINT>> ChunkSet;
+
+    // Distance in chunks from a camera in columns to the center of a chunk, like the streamer
+    FLOAT getDistance(_In_ FLOAT x, _In_ FLOAT z, _In_ UINT uChunkX, _In_ UINT uChunkZ)
+    {
+        const FLOAT dx = static_cast<FLOAT>(uChunkX) + 0.5f - x / static_cast<FLOAT>(CHUNK_SIZE);
+        const FLOAT dz = static_cast<FLOAT>(uChunkZ) + 0.5f - z / static_cast<FLOAT>(CHUNK_SIZE);
+        return std::sqrt(dx * dx + dz * dz);
+    }
+
+    ChunkSet getChunksWithin(_In_ FLOAT x, _In_ FLOAT z, _In_ FLOAT radius)
+    {
+        ChunkSet chunks;
+        for (UINT uChunkZ = 0u; uChunkZ < NUM_CHUNKS; ++uChunkZ)
+        {
+            for (UINT uChunkX = 0u; uChunkX < NUM_CHUNKS; ++uChunkX)
+            {
+                if (getDistance(x, z, uChunkX, uChunkZ) <= radius)
+                {
+                    chunks.emplace(uChunkX, uChunkZ);
+                }
+            }
+        }
+        return chunks;
+    }
+
+    // Calls Update at a camera position until every chunk it asked for is promoted or dropped, tracking the resident chunks
+    void settle(_Inout_ ChunkStreamer& streamer, _In_ FLOAT x, _In_ FLOAT z, _Inout_ ChunkSet& resident, _Inout_ ChunkSet& evicted)
+    {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+        do
+        {
+            std::vector<StreamedChunk> aPromoted;
+            std::vector<std::pair<UINT, UINT>> aEvicted;
+            streamer.Update(x, z, 2u, aPromoted, aEvicted);
+            CHECK(aPromoted.size() <= 2u);
+
+            for (const std::pair<UINT, UINT>& chunk : aEvicted)
+            {
+                CHECK(resident.erase(chunk) == 1u);
+                evicted.insert(chunk);
+            }
+            for (const StreamedChunk& chunk : aPromoted)
+            {
+                CHECK(resident.emplace(chunk.ChunkX, chunk.ChunkZ).second);
+                CHECK_EQUAL(static_cast<size_t>(CHUNK_SIZE) * CHUNK_SIZE, chunk.Heights.size());
+                CHECK_EQUAL(static_cast<size_t>(CHUNK_SIZE) * CHUNK_SIZE, chunk.BlockTypes.size());
+            }
+            CHECK_EQUAL(resident.size(), static_cast<size_t>(streamer.GetNumResident()));
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        } while (streamer.GetNumPending() > 0u && std::chrono::steady_clock::now() < deadline);
+        CHECK_EQUAL(0u, streamer.GetNumPending());
+    }
+
+    // Copies the columns of a chunk at a level with their border, the way the scene queues them
+    StreamedChunkLevel copyLevel(_In_ const std::vector<VoxelColumn>& aColumns, _In_ UINT uWidth, _In_ UINT uDepth, _In_ UINT uChunkX, _In_ UINT uChunkZ, _In_ UINT uLod)
+    {
+        StreamedChunkLevel level = {};
+        level.BeginX = (uChunkX * CHUNK_SIZE) >> uLod;
+        level.BeginZ = (uChunkZ * CHUNK_SIZE) >> uLod;
+        level.Width = std::min(level.BeginX + (CHUNK_SIZE >> uLod), uWidth) - level.BeginX;
+        level.Depth = std::min(level.BeginZ + (CHUNK_SIZE >> uLod), uDepth) - level.BeginZ;
+        level.Columns.assign(static_cast<size_t>(level.Width + 2u) * (level.Depth + 2u), VoxelColumn{ .BlockType = 0, .Reserved = 0u, .Height = 0u });
+        for (UINT z = 0u; z < level.Depth + 2u; ++z)
+        {
+            for (UINT x = 0u; x < level.Width + 2u; ++x)
+            {
+                const INT iX = static_cast<INT>(level.BeginX + x) - 1;
+                const INT iZ = static_cast<INT>(level.BeginZ + z) - 1;
+                if (iX >= 0 && iZ >= 0 && static_cast<UINT>(iX) < uWidth && static_cast<UINT>(iZ) < uDepth)
+                {
+                    level.Columns[static_cast<size_t>(z) * (level.Width + 2u) + x] = aColumns[static_cast<size_t>(iZ) * uWidth + static_cast<size_t>(iX)];
+                }
+            }
+        }
+        return level;
+    }
+}
+
+TEST(ChunkStreamerBuildsLikeTheWholeLevel)
+{
+    // A map that does not end on a chunk edge, built chunk by chunk from copies and over the whole level
+    constexpr const UINT WIDTH = 80u;
+    constexpr const UINT DEPTH = 56u;
+    constexpr const UINT NUM_LODS = 4u;
+    constexpr const size_t NUM_BLOCK_TYPES = 3u;
+
+    std::mt19937 random(11u);
+    std::vector<VoxelColumn> aColumns(static_cast<size_t>(WIDTH) * DEPTH);
+    for (VoxelColumn& column : aColumns)
+    {
+        column = VoxelColumn{ .BlockType = static_cast<CHAR>(static_cast<UINT>(eBlockType::GRASSLAND) + random() % 4u), .Reserved = 0u, .Height = static_cast<WORD>(random() % 9u) };
+    }
+    VoxelLods lods(NUM_LODS);
+    lods.Build(aColumns.data(), WIDTH, DEPTH, NUM_BLOCK_TYPES);
+
+    for (BOOL bGreedyMesh : { FALSE, TRUE })
+    {
+        for (UINT uChunkZ = 0u; uChunkZ * CHUNK_SIZE < DEPTH; ++uChunkZ)
+        {
+            for (UINT uChunkX = 0u; uChunkX * CHUNK_SIZE < WIDTH; ++uChunkX)
+            {
+                StreamedChunkBuild build = { .ChunkX = uChunkX, .ChunkZ = uChunkZ, .Version = 7u, .GreedyMesh = bGreedyMesh, .NumBlockTypes = NUM_BLOCK_TYPES, .Levels = {} };
+                for (UINT uLod = 0u; uLod < NUM_LODS; ++uLod)
+                {
+                    build.Levels.push_back(copyLevel(uLod == 0u ? aColumns : lods.GetColumns(uLod), lods.GetWidth(uLod), lods.GetDepth(uLod), uChunkX, uChunkZ, uLod));
+                }
+                ChunkStreamer::BuildChunk(build);
+                CHECK_EQUAL(7u, build.Version);
+
+                for (UINT uLod = 0u; uLod < NUM_LODS; ++uLod)
+                {
+                    const StreamedChunkLevel& level = build.Levels[uLod];
+                    const VoxelColumn* pLevelColumns = uLod == 0u ? aColumns.data() : lods.GetColumns(uLod).data();
+                    if (bGreedyMesh)
+                    {
+                        const FLOAT cellSize = 2.0f * static_cast<FLOAT>(1u << uLod);
+                        GreedyMesher mesher(pLevelColumns, lods.GetWidth(uLod), lods.GetDepth(uLod), NUM_BLOCK_TYPES);
+                        mesher.Build(level.BeginX, level.BeginZ, level.BeginX + level.Width, level.BeginZ + level.Depth, XMFLOAT3(0.0f, 0.0f, 0.0f), cellSize);
+                        CHECK(mesher.GetIndices() == level.Indices);
+                        CHECK_EQUAL(mesher.GetVertices().size(), level.Vertices.size());
+                        CHECK(level.Vertices.size() != mesher.GetVertices().size() || std::memcmp(mesher.GetVertices().data(), level.Vertices.data(), sizeof(SimpleVertex) * level.Vertices.size()) == 0);
+                        for (const SimpleVertex& vertex : level.Vertices)
+                        {
+                            CHECK(vertex.Position.x >= level.MinCorner.x && vertex.Position.x <= level.MaxCorner.x);
+                            CHECK(vertex.Position.y >= level.MinCorner.y && vertex.Position.y <= level.MaxCorner.y);
+                        }
+                    }
+                    else
+                    {
+                        VoxelInstanceBuilder builder(pLevelColumns, lods.GetWidth(uLod), lods.GetDepth(uLod), NUM_BLOCK_TYPES);
+                        builder.Build(uLod, level.BeginX, level.BeginZ, level.BeginX + level.Width, level.BeginZ + level.Depth);
+                        CHECK_EQUAL(builder.GetInstances().size(), level.Instances.size());
+                        CHECK(level.Instances.size() != builder.GetInstances().size() || std::memcmp(builder.GetInstances().data(), level.Instances.data(), sizeof(InstanceData) * level.Instances.size()) == 0);
+                        if (!level.Instances.empty())
+                        {
+                            CHECK_EQUAL(static_cast<FLOAT>(builder.GetMaxHeight()) * 2.0f * static_cast<FLOAT>(1u << uLod), level.MaxCorner.y);
+                        }
+                    }
+                    CHECK(level.Columns.empty());
+                }
+            }
+        }
+    }
+}
+
+TEST(ChunkStreamerLoadsTheNearestChunks)
+{
+    ChunkStreamer streamer(1u, NUM_CHUNKS, NUM_CHUNKS, HEIGHT, 3.0f, 4.0f, 1000u, std::filesystem::path(), 2u);
+    ChunkSet resident;
+    ChunkSet evicted;
+    settle(streamer, 250.0f, 260.0f, resident, evicted);
+
+    CHECK(resident == getChunksWithin(250.0f, 260.0f, 3.0f));
+    CHECK(evicted.empty());
+}
+
+TEST(ChunkStreamerFollowsACameraPath)
+{
+    // A camera walking across the map and back evicts what falls beyond the unload radius and loads what it gets near
+    ChunkStreamer streamer(2u, NUM_CHUNKS, NUM_CHUNKS, HEIGHT, 2.5f, 3.5f, 1000u, std::filesystem::path(), 2u);
+    ChunkSet resident;
+    ChunkSet evicted;
+    for (FLOAT t = 0.0f; t <= 2.0f; t += 0.125f)
+    {
+        const FLOAT x = 48.0f + 400.0f * (t <= 1.0f ? t : 2.0f - t);
+        const FLOAT z = 200.0f + 40.0f * t;
+        evicted.clear();
+        settle(streamer, x, z, resident, evicted);
+
+        const ChunkSet near = getChunksWithin(x, z, 2.5f);
+        for (const std::pair<UINT, UINT>& chunk : near)
+        {
+            CHECK(resident.contains(chunk));
+        }
+        for (const std::pair<UINT, UINT>& chunk : resident)
+        {
+            CHECK(getDistance(x, z, chunk.first, chunk.second) <= 3.5f);
+        }
+        for (const std::pair<UINT, UINT>& chunk : evicted)
+        {
+            CHECK(getDistance(x, z, chunk.first, chunk.second) > 3.5f);
+        }
+    }
+}
+
+TEST(ChunkStreamerKeepsChunksAcrossAnEdge)
+{
+    // Going back and forth across a chunk edge loads the chunks ahead once and never evicts
+    ChunkStreamer streamer(3u, NUM_CHUNKS, NUM_CHUNKS, HEIGHT, 2.0f, 3.0f, 1000u, std::filesystem::path(), 2u);
+    ChunkSet resident;
+    ChunkSet evicted;
+    settle(streamer, 255.0f, 240.0f, resident, evicted);
+    settle(streamer, 257.0f, 240.0f, resident, evicted);
+    const ChunkSet both = resident;
+    for (UINT i = 0u; i < 8u; ++i)
+    {
+        settle(streamer, (i % 2u == 0u) ? 255.0f : 257.0f, 240.0f, resident, evicted);
+    }
+
+    CHECK(evicted.empty());
+    CHECK(resident == both);
+}
+
+TEST(ChunkStreamerKeepsTheBudget)
+{
+    // 10 chunks out of the 29 within the load radius, the nearest ones, even after the camera moved
+    ChunkStreamer streamer(4u, NUM_CHUNKS, NUM_CHUNKS, HEIGHT, 3.0f, 4.0f, 10u, std::filesystem::path(), 2u);
+    ChunkSet resident;
+    ChunkSet evicted;
+    for (FLOAT x : { 240.0f, 272.0f, 304.0f })
+    {
+        settle(streamer, x, 240.0f, resident, evicted);
+        CHECK_EQUAL(10u, resident.size());
+
+        FLOAT farthestResident = 0.0f;
+        for (const std::pair<UINT, UINT>& chunk : resident)
+        {
+            farthestResident = std::max(farthestResident, getDistance(x, 240.0f, chunk.first, chunk.second));
+        }
+        UINT uNumNearer = 0u;
+        for (const std::pair<UINT, UINT>& chunk : getChunksWithin(x, 240.0f, 3.0f))
+        {
+            uNumNearer += getDistance(x, 240.0f, chunk.first, chunk.second) < farthestResident ? 1u : 0u;
+        }
+        CHECK(uNumNearer < 10u);
+    }
+}
+
+TEST(ChunkStreamerBuildsQueuedChunks)
+{
+    ChunkStreamer streamer(5u, NUM_CHUNKS, NUM_CHUNKS, HEIGHT, 1.0f, 2.0f, 1000u, std::filesystem::path(), 2u);
+
+    // A lone column of 3 cubes in the middle of each chunk, built on the workers
+    for (UINT uVersion = 1u; uVersion <= 6u; ++uVersion)
+    {
+        std::vector<VoxelColumn> aColumns(static_cast<size_t>(CHUNK_SIZE) * CHUNK_SIZE, VoxelColumn{ .BlockType = 0, .Reserved = 0u, .Height = 0u });
+        aColumns[static_cast<size_t>(16u) * CHUNK_SIZE + 16u] = VoxelColumn{ .BlockType = static_cast<CHAR>(eBlockType::GRASSLAND), .Reserved = 0u, .Height = 3u };
+
+        StreamedChunkBuild build = { .ChunkX = uVersion, .ChunkZ = 2u, .Version = uVersion, .GreedyMesh = FALSE, .NumBlockTypes = 1u, .Levels = {} };
+        build.Levels.push_back(copyLevel(aColumns, CHUNK_SIZE, CHUNK_SIZE, 0u, 0u, 0u));
+        build.Levels[0].BeginX = uVersion * CHUNK_SIZE;
+        build.Levels[0].BeginZ = 2u * CHUNK_SIZE;
+        streamer.QueueBuild(std::move(build));
+    }
+
+    std::vector<StreamedChunkBuild> aBuilt;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+    while (streamer.GetNumBuilding() > 0u && std::chrono::steady_clock::now() < deadline)
+    {
+        streamer.CollectBuilds(aBuilt);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    CHECK_EQUAL(6u, aBuilt.size());
+    for (const StreamedChunkBuild& build : aBuilt)
+    {
+        CHECK_EQUAL(build.ChunkX, build.Version);
+        CHECK_EQUAL(3u, build.Levels[0].Instances.size());
+        CHECK_EQUAL(build.ChunkX * CHUNK_SIZE + 16u, build.Levels[0].Instances[0].X);
+        CHECK_EQUAL(2u * CHUNK_SIZE + 16u, build.Levels[0].Instances[0].Z);
+    }
+}
@@ -0,0 +1,188 @@
+#include "Test.h"
+
+#include <random>
+
+#include "Scene/GreedyMesher.h"
+
+using namespace library;
+
+namespace
+{
+    constexpr const CHAR GRASSLAND = static_cast<CHAR>(eBlockType::GRASSLAND);
+    constexpr const CHAR SNOW = static_cast<CHAR>(eBlockType::SNOW);
+    constexpr const size_t NUM_BLOCK_TYPES = 2u;
+
+    CHAR getReferenceBlockType(_In_ const std::vector<VoxelColumn>& aColumns, _In_ UINT uWidth, _In_ UINT uDepth, _In_ INT x, _In_ INT y, _In_ INT z)
+    {
+        if (x < 0 || y < 0 || z < 0 || x >= static_cast<INT>(uWidth) || z >= static_cast<INT>(uDepth))
+        {
+            return 0;
+        }
+
+        const VoxelColumn& column = aColumns[static_cast<size_t>(z) * uWidth + static_cast<size_t>(x)];
+        const size_t uTypeIdx = static_cast<size_t>(column.BlockType) - static_cast<size_t>(GRASSLAND);
+        return uTypeIdx < NUM_BLOCK_TYPES && y < static_cast<INT>(column.Height) ? column.BlockType : 0;
+    }
+
+    // Counts one face per side of a cube that does not touch another cube, by block type
+    std::vector<UINT> countReferenceFaces(_In_ const std::vector<VoxelColumn>& aColumns, _In_ UINT uWidth, _In_ UINT uDepth, _In_ UINT uBeginX, _In_ UINT uBeginZ, _In_ UINT uEndX, _In_ UINT uEndZ)
+    {
+        static constexpr const INT NEIGHBORS[6][3] = { { -1, 0, 0 }, { 1, 0, 0 }, { 0, -1, 0 }, { 0, 1, 0 }, { 0, 0, -1 }, { 0, 0, 1 } };
+
+        std::vector<UINT> aFaces(NUM_BLOCK_TYPES, 0u);
+        for (UINT z = uBeginZ; z < uEndZ; ++z)
+        {
+            for (UINT x = uBeginX; x < uEndX; ++x)
+            {
+                for (INT y = 0; y < static_cast<INT>(aColumns[static_cast<size_t>(z) * uWidth + x].Height); ++y)
+                {
+                    const CHAR blockType = getReferenceBlockType(aColumns, uWidth, uDepth, static_cast<INT>(x), y, static_cast<INT>(z));
+                    if (blockType == 0)
+                    {
+                        continue;
+                    }
+
+                    for (const INT* pNeighbor : NEIGHBORS)
+                    {
+                        if (getReferenceBlockType(aColumns, uWidth, uDepth, static_cast<INT>(x) + pNeighbor[0], y + pNeighbor[1], static_cast<INT>(z) + pNeighbor[2]) == 0)
+                        {
+                            ++aFaces[static_cast<size_t>(blockType - GRASSLAND)];
+                        }
+                    }
+                }
+            }
+        }
+
+        return aFaces;
+    }
+
+    // Sums the unit faces covered by the quads of each block type, and checks each quad faces its normal
+    std::vector<UINT> countMeshFaces(_In_ GreedyMesher& mesher)
+    {
+        const std::vector<SimpleVertex>& aVertices = mesher.GetVertices();
+        const std::vector<WORD>& aIndices = mesher.GetIndices();
+
+        std::vector<UINT> aFaces(NUM_BLOCK_TYPES, 0u);
+        for (size_t uTypeIdx = 0u; uTypeIdx < NUM_BLOCK_TYPES; ++uTypeIdx)
+        {
+            const VoxelMeshRange& range = mesher.GetRanges()[uTypeIdx];
+            CHECK_EQUAL(0u, range.uNumIndices % 6u);
+
+            FLOAT area = 0.0f;
+            for (UINT uIndex = range.uStartIndex; uIndex < range.uStartIndex + range.uNumIndices; uIndex += 3u)
+            {
+                const XMFLOAT3& p0 = aVertices[aIndices[uIndex]].Position;
+                const XMFLOAT3& p1 = aVertices[aIndices[uIndex + 1u]].Position;
+                const XMFLOAT3& p2 = aVertices[aIndices[uIndex + 2u]].Position;
+                const XMFLOAT3& normal = aVertices[aIndices[uIndex]].Normal;
+
+                // Clockwise triangles of a left-handed space face (p1 - p0) x (p2 - p0)
+                const FLOAT e1[3] = { p1.x - p0.x, p1.y - p0.y, p1.z - p0.z };
+                const FLOAT e2[3] = { p2.x - p0.x, p2.y - p0.y, p2.z - p0.z };
+                const FLOAT cross[3] = { e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+                const FLOAT facing = cross[0] * normal.x + cross[1] * normal.y + cross[2] * normal.z;
+                CHECK(facing > 0.0f);
+
+                area += 0.5f * facing;
+            }
+            aFaces[uTypeIdx] = static_cast<UINT>(area + 0.5f);
+        }
+
+        return aFaces;
+    }
+}
+
+TEST(GreedyMesherMergesSingleColumn)
+{
+    const std::vector<VoxelColumn> aColumns = { VoxelColumn{ .BlockType = GRASSLAND, .Reserved = 0u, .Height = 5u } };
+
+    GreedyMesher mesher(aColumns.data(), 1u, 1u, NUM_BLOCK_TYPES);
+    mesher.Build(0u, 0u, 1u, 1u, XMFLOAT3(0.0f, 0.0f, 0.0f), 1.0f);
+
+    CHECK_EQUAL(6u, mesher.GetNumQuads());
+    CHECK_EQUAL(36u, mesher.GetIndices().size());
+    CHECK_EQUAL(22u, countMeshFaces(mesher)[0]);
+}
+
+TEST(GreedyMesherMergesFlatPlate)
+{
+    const std::vector<VoxelColumn> aColumns(8u * 8u, VoxelColumn{ .BlockType = GRASSLAND, .Reserved = 0u, .Height = 1u });
+
+    GreedyMesher mesher(aColumns.data(), 8u, 8u, NUM_BLOCK_TYPES);
+    mesher.Build(0u, 0u, 8u, 8u, XMFLOAT3(0.0f, 0.0f, 0.0f), 1.0f);
+
+    CHECK_EQUAL(6u, mesher.GetNumQuads());
+    CHECK_EQUAL(8u * 8u * 2u + 8u * 4u, countMeshFaces(mesher)[0]);
+}
+
+TEST(GreedyMesherSplitsBlockTypes)
+{
+    // The faces between the two types are hidden like any other, so each half is a box of five quads
+    std::vector<VoxelColumn> aColumns(4u * 2u, VoxelColumn{ .BlockType = GRASSLAND, .Reserved = 0u, .Height = 3u });
+    for (UINT z = 0u; z < 2u; ++z)
+    {
+        aColumns[z * 4u + 2u].BlockType = SNOW;
+        aColumns[z * 4u + 3u].BlockType = SNOW;
+    }
+
+    GreedyMesher mesher(aColumns.data(), 4u, 2u, NUM_BLOCK_TYPES);
+    mesher.Build(0u, 0u, 4u, 2u, XMFLOAT3(0.0f, 0.0f, 0.0f), 1.0f);
+
+    CHECK_EQUAL(10u, mesher.GetNumQuads());
+    CHECK_EQUAL(60u, mesher.GetRanges()[0].uNumIndices + mesher.GetRanges()[1].uNumIndices);
+    CHECK_EQUAL(mesher.GetRanges()[0].uNumIndices, mesher.GetRanges()[1].uStartIndex);
+
+    const std::vector<UINT> aFaces = countMeshFaces(mesher);
+    CHECK_EQUAL(2u * 2u * 2u + 2u * 3u * 3u, aFaces[0]);
+    CHECK_EQUAL(aFaces[0], aFaces[1]);
+}
+
+TEST(GreedyMesherCullsFacesAgainstNeighborChunks)
+{
+    // The faces toward the columns of the next chunk are hidden, the ones toward the end of the map are not
+    const std::vector<VoxelColumn> aColumns(4u * 1u, VoxelColumn{ .BlockType = GRASSLAND, .Reserved = 0u, .Height = 2u });
+
+    GreedyMesher mesher(aColumns.data(), 4u, 1u, NUM_BLOCK_TYPES);
+    mesher.Build(0u, 0u, 2u, 1u, XMFLOAT3(0.0f, 0.0f, 0.0f), 1.0f);
+
+    CHECK_EQUAL(5u, mesher.GetNumQuads());
+    CHECK(countReferenceFaces(aColumns, 4u, 1u, 0u, 0u, 2u, 1u) == countMeshFaces(mesher));
+}
+
+TEST(GreedyMesherMatchesReferenceFaces)
+{
+    constexpr const UINT MAP_SIZE = 24u;
+
+    std::mt19937 random(3u);
+    std::uniform_int_distribution<INT> blockType(static_cast<INT>(GRASSLAND), static_cast<INT>(GRASSLAND) + 2);
+    std::uniform_int_distribution<INT> height(0, 6);
+
+    for (UINT uMap = 0u; uMap < 8u; ++uMap)
+    {
+        std::vector<VoxelColumn> aColumns(MAP_SIZE * MAP_SIZE);
+        for (VoxelColumn& column : aColumns)
+        {
+            // The third type has no voxel and meshes as air
+            column = VoxelColumn{ .BlockType = static_cast<CHAR>(blockType(random)), .Reserved = 0u, .Height = static_cast<WORD>(height(random)) };
+        }
+
+        GreedyMesher mesher(aColumns.data(), MAP_SIZE, MAP_SIZE, NUM_BLOCK_TYPES);
+        for (UINT uChunkZ = 0u; uChunkZ < MAP_SIZE; uChunkZ += 8u)
+        {
+            for (UINT uChunkX = 0u; uChunkX < MAP_SIZE; uChunkX += 8u)
+            {
+                mesher.Build(uChunkX, uChunkZ, uChunkX + 8u, uChunkZ + 8u, XMFLOAT3(-5.0f, 1.0f, 3.0f), 1.0f);
+
+                const std::vector<UINT> aReference = countReferenceFaces(aColumns, MAP_SIZE, MAP_SIZE, uChunkX, uChunkZ, uChunkX + 8u, uChunkZ + 8u);
+                CHECK(aReference == countMeshFaces(mesher));
+
+                UINT uNumReferenceFaces = 0u;
+                for (UINT uFaces : aReference)
+                {
+                    uNumReferenceFaces += uFaces;
+                }
+                CHECK(mesher.GetNumQuads() <= uNumReferenceFaces);
+            }
+        }
+    }
+}
@@ -0,0 +1,165 @@
+#include "Test.h"
+
+#include <cstring>
+#include <fstream>
+#include <random>
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "Scene/HeightMapLoader.h"
+
+using namespace library;
+
+namespace
+{
+    void writeHeightMap(_In_ const std::filesystem::path& filePath, _In_ UINT uWidth, _In_ UINT uHeight, _In_ UINT uDepth, _In_ size_t uNumRecords, _In_ BOOL bMalformed)
+    {
+        std::mt19937 random(7u);
+        std::uniform_int_distribution<INT> blockType(static_cast<INT>(eBlockType::GRASSLAND), static_cast<INT>(eBlockType::COUNT) - 1);
+        std::uniform_int_distribution<INT> height(0, 1000);
+
+        std::ofstream outputFile(filePath, std::ios::binary | std::ios::trunc);
+        outputFile << uWidth << ' ' << uHeight << ' ' << uDepth << " 15\n";
+        for (UINT uColorIdx = 0u; uColorIdx < 15u; ++uColorIdx)
+        {
+            outputFile << uColorIdx / 15.0f << " 0.5 1\n";
+        }
+
+        for (size_t uRecordIdx = 0u; uRecordIdx < uNumRecords; ++uRecordIdx)
+        {
+            if (bMalformed && uRecordIdx % 97u == 13u)
+            {
+                outputFile << "x? ";
+            }
+            outputFile << static_cast<CHAR>(blockType(random)) << static_cast<FLOAT>(height(random)) / 1000.0f << ' ';
+            if (uRecordIdx % uWidth == uWidth - 1u)
+            {
+                outputFile << '\n';
+            }
+        }
+    }
+
+    size_t getPages(_In_ UINT uField)
+    {
+        size_t aFields[2] = { 0u, 0u };
+        FILE* pFile = std::fopen("/proc/self/statm", "r");
+        if (pFile)
+        {
+            if (std::fscanf(pFile, "%zu %zu", &aFields[0], &aFields[1]) != 2)
+            {
+                aFields[0] = aFields[1] = 0u;
+            }
+            std::fclose(pFile);
+        }
+
+        return aFields[uField] * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    }
+}
+
+TEST(HeightMapLoaderParallelMatchesSerial)
+{
+    const std::filesystem::path filePath = test::GetTemporaryPath("Parallel.txt");
+
+    // More records than columns wrap around, and malformed tokens are skipped
+    for (size_t uNumRecords : { static_cast<size_t>(64u * 48u), static_cast<size_t>(64u * 48u * 2u + 17u) })
+    {
+        writeHeightMap(filePath, 64u, 32u, 48u, uNumRecords, TRUE);
+
+        UINT aSerialDimension[3];
+        std::vector<XMFLOAT3> aSerialPalette;
+        std::vector<VoxelColumn> aSerialColumns;
+        CHECK(SUCCEEDED(HeightMapLoader::Load(filePath, 1u, aSerialDimension, aSerialPalette, aSerialColumns)));
+        CHECK_EQUAL(64u, aSerialDimension[0]);
+        CHECK_EQUAL(32u, aSerialDimension[1]);
+        CHECK_EQUAL(48u, aSerialDimension[2]);
+        CHECK_EQUAL(15u, aSerialPalette.size());
+        CHECK_EQUAL(64u * 48u, aSerialColumns.size());
+
+        for (UINT uNumThreads : { 2u, 3u, 8u, 100u })
+        {
+            UINT aDimension[3];
+            std::vector<XMFLOAT3> aPalette;
+            std::vector<VoxelColumn> aColumns;
+            CHECK(SUCCEEDED(HeightMapLoader::Load(filePath, uNumThreads, aDimension, aPalette, aColumns)));
+            CHECK_EQUAL(aSerialColumns.size(), aColumns.size());
+            CHECK(std::memcmp(aSerialColumns.data(), aColumns.data(), sizeof(VoxelColumn) * aColumns.size()) == 0);
+        }
+    }
+
+    std::filesystem::remove(filePath);
+}
+
+TEST(HeightMapLoaderFailsWithoutFile)
+{
+    UINT aDimension[3];
+    std::vector<XMFLOAT3> aPalette;
+    std::vector<VoxelColumn> aColumns;
+    CHECK(FAILED(HeightMapLoader::Load(test::GetTemporaryPath("DoesNotExist.txt"), 1u, aDimension, aPalette, aColumns)));
+    CHECK_EQUAL(0u, aDimension[0]);
+    CHECK(aColumns.empty());
+}
+
+TEST(HeightMapLoaderStaysUnderMemoryCeiling)
+{
+    constexpr const UINT MAP_SIZE = 1024u;
+    constexpr const UINT MAP_HEIGHT = 64u;
+    constexpr const size_t NUM_COLUMNS = static_cast<size_t>(MAP_SIZE) * MAP_SIZE;
+
+    const std::filesystem::path filePath = test::GetTemporaryPath("Ceiling.txt");
+    writeHeightMap(filePath, MAP_SIZE, MAP_HEIGHT, MAP_SIZE, NUM_COLUMNS, FALSE);
+    const size_t uFileSize = static_cast<size_t>(std::filesystem::file_size(filePath));
+
+    for (UINT uNumThreads : { 1u, 4u })
+    {
+        // The columns, the body of the file and 8 bytes per record on several threads, and the thread stacks
+        const size_t uBudget = sizeof(VoxelColumn) * NUM_COLUMNS
+            + (uNumThreads > 1u ? uFileSize + sizeof(HeightMapRecord) * NUM_COLUMNS : 0u)
+            + (static_cast<size_t>(uNumThreads) + 8u) * (8u << 20u);
+
+        std::fflush(stdout);
+        const pid_t pid = fork();
+        if (pid == 0)
+        {
+            const size_t uStartAddressSpace = getPages(0u);
+            const size_t uStartResident = getPages(1u);
+
+            const rlimit limit = { .rlim_cur = uStartAddressSpace + uBudget, .rlim_max = uStartAddressSpace + uBudget };
+            setrlimit(RLIMIT_AS, &limit);
+
+            UINT aDimension[3];
+            std::vector<XMFLOAT3> aPalette;
+            std::vector<VoxelColumn> aColumns;
+            try
+            {
+                HeightMapLoader::Load(filePath, uNumThreads, aDimension, aPalette, aColumns);
+            }
+            catch (...)
+            {
+                _exit(2);
+            }
+
+            rusage usage;
+            getrusage(RUSAGE_SELF, &usage);
+            const size_t uPeakResident = static_cast<size_t>(usage.ru_maxrss) * 1024u;
+
+            // The loader used to reserve width * height * depth instances of 64 bytes for every color
+            std::printf("  %u threads: peak RSS +%.1f MB under a %.1f MB ceiling, %.1f GB before\n",
+                uNumThreads,
+                static_cast<double>(uPeakResident > uStartResident ? uPeakResident - uStartResident : 0u) / (1 << 20),
+                static_cast<double>(uBudget) / (1 << 20),
+                static_cast<double>(NUM_COLUMNS) * MAP_HEIGHT * 15.0 * 64.0 / (1 << 30));
+            std::fflush(stdout);
+            _exit(aColumns.size() == NUM_COLUMNS ? 0 : 1);
+        }
+
+        INT iStatus = 0;
+        CHECK(pid > 0);
+        CHECK(waitpid(pid, &iStatus, 0) == pid);
+        CHECK(WIFEXITED(iStatus));
+        CHECK_EQUAL(0, WEXITSTATUS(iStatus));
+    }
+
+    std::filesystem::remove(filePath);
+}
@@ -0,0 +1,56 @@
+#include "Test.h"
+
+#include <cstring>
+#include <vector>
+
+#include "Scene/PerlinNoise.h"
+
+using namespace library;
+
+BENCHMARK(PerlinNoiseBatchVsScalar)
+{
+    // The height and moisture fields of a 256x256 tile at 6 octaves, and the 3D noise of its rows at 4 octaves
+    constexpr const UINT TILE_SIZE = 256u;
+    constexpr const FLOAT FREQUENCY = 0.0173f;
+    const PerlinNoise noise(12345u);
+
+    std::vector<FLOAT> aScalar(TILE_SIZE * TILE_SIZE);
+    std::vector<FLOAT> aBatch(TILE_SIZE * TILE_SIZE);
+    const double scalar2dMilliseconds = test::MeasureMilliseconds(10u, [&]()
+    {
+        for (UINT j = 0u; j < TILE_SIZE; ++j)
+        {
+            for (UINT i = 0u; i < TILE_SIZE; ++i)
+            {
+                aScalar[j * TILE_SIZE + i] = noise.GetPerlin2d(-128.0f + static_cast<FLOAT>(i), 512.0f + static_cast<FLOAT>(j), FREQUENCY, 6u);
+            }
+        }
+    });
+    const double batch2dMilliseconds = test::MeasureMilliseconds(10u, [&]()
+    {
+        noise.GetPerlin2dBatch(-128.0f, 512.0f, 1.0f, TILE_SIZE, TILE_SIZE, FREQUENCY, 6u, aBatch.data());
+    });
+    CHECK(std::memcmp(aScalar.data(), aBatch.data(), sizeof(FLOAT) * aScalar.size()) == 0);
+
+    const double scalar3dMilliseconds = test::MeasureMilliseconds(10u, [&]()
+    {
+        for (UINT j = 0u; j < TILE_SIZE; ++j)
+        {
+            for (UINT i = 0u; i < TILE_SIZE; ++i)
+            {
+                aScalar[j * TILE_SIZE + i] = noise.GetGradient3d(-128.0f + static_cast<FLOAT>(i), 40.0f, 512.0f + static_cast<FLOAT>(j), FREQUENCY, 4u);
+            }
+        }
+    });
+    const double batch3dMilliseconds = test::MeasureMilliseconds(10u, [&]()
+    {
+        for (UINT j = 0u; j < TILE_SIZE; ++j)
+        {
+            noise.GetGradient3dBatch(-128.0f, 40.0f, 512.0f + static_cast<FLOAT>(j), 1.0f, TILE_SIZE, FREQUENCY, 4u, aBatch.data() + j * TILE_SIZE);
+        }
+    });
+    CHECK(std::memcmp(aScalar.data(), aBatch.data(), sizeof(FLOAT) * aScalar.size()) == 0);
+
+    std::printf("  2D %ux%u x 6 octaves  scalar %7.3f ms  batch %7.3f ms  %.2fx\n", TILE_SIZE, TILE_SIZE, scalar2dMilliseconds, batch2dMilliseconds, scalar2dMilliseconds / batch2dMilliseconds);
+    std::printf("  3D %ux%u x 4 octaves  scalar %7.3f ms  batch %7.3f ms  %.2fx\n", TILE_SIZE, TILE_SIZE, scalar3dMilliseconds, batch3dMilliseconds, scalar3dMilliseconds / batch3dMilliseconds);
+}
@@ -0,0 +1,130 @@
+#include "Test.h"
+
+#include <cmath>
+#include <cstring>
+
+#include "Scene/PerlinNoise.h"
+
+using namespace library;
+
+namespace
+{
+    constexpr const UINT SEEDS[] = { 0u, 7u, 12345u };
+    constexpr const FLOAT STEPS[] = { 1.0f, 0.37f, 3.0f };
+
+    // First samples of the rows: the origin, lattice points on both sides of it and of the end of the hashes, and points between them
+    constexpr const FLOAT ORIGINS[][3] = {
+        { 0.0f, 0.0f, 0.0f },
+        { -1.0f, -1.0f, -1.0f },
+        { -9.0f, 4.0f, -2.0f },
+        { 255.0f, 256.0f, 257.0f },
+        { -256.0f, -255.0f, 511.0f },
+        { 13.71f, -42.19f, 7.33f },
+        { -0.25f, 0.75f, -0.5f },
+        { -1000.3f, 2000.7f, -63.9f },
+    };
+
+    // Frequencies that put samples exactly on the lattice at every octave, and one that does not
+    constexpr const FLOAT FREQUENCIES[] = { 1.0f, 0.25f, 0.0173f };
+
+    // Samples per row, one more than a block of 4 to run the scalar tail as well
+    constexpr const UINT NUM_X = 13u;
+    constexpr const UINT NUM_Y = 5u;
+    constexpr const UINT NUM_OCTAVES = 6u;
+}
+
+TEST(PerlinNoiseBatch2dMatchesScalar)
+{
+    UINT uNumMismatches = 0u;
+    for (UINT uSeed : SEEDS)
+    {
+        const PerlinNoise noise(uSeed);
+        for (FLOAT step : STEPS)
+        {
+            for (const FLOAT(&origin)[3] : ORIGINS)
+            {
+                for (FLOAT frequency : FREQUENCIES)
+                {
+                    FLOAT aSamples[NUM_X * NUM_Y];
+                    noise.GetPerlin2dBatch(origin[0], origin[1], step, NUM_X, NUM_Y, frequency, NUM_OCTAVES, aSamples);
+                    for (UINT j = 0u; j < NUM_Y; ++j)
+                    {
+                        for (UINT i = 0u; i < NUM_X; ++i)
+                        {
+                            const FLOAT expected = noise.GetPerlin2d(origin[0] + static_cast<FLOAT>(i) * step, origin[1] + static_cast<FLOAT>(j) * step, frequency, NUM_OCTAVES);
+                            uNumMismatches += std::memcmp(&expected, &aSamples[j * NUM_X + i], sizeof(FLOAT)) != 0 ? 1u : 0u;
+                        }
+                    }
+                }
+            }
+        }
+    }
+    CHECK_EQUAL(0u, uNumMismatches);
+}
+
+TEST(PerlinNoiseBatch3dMatchesScalar)
+{
+    UINT uNumMismatches = 0u;
+    for (UINT uSeed : SEEDS)
+    {
+        const PerlinNoise noise(uSeed);
+        for (FLOAT step : STEPS)
+        {
+            for (const FLOAT(&origin)[3] : ORIGINS)
+            {
+                for (FLOAT frequency : FREQUENCIES)
+                {
+                    FLOAT aSamples[NUM_X];
+                    noise.GetGradient3dBatch(origin[0], origin[1], origin[2], step, NUM_X, frequency, NUM_OCTAVES, aSamples);
+                    for (UINT i = 0u; i < NUM_X; ++i)
+                    {
+                        const FLOAT expected = noise.GetGradient3d(origin[0] + static_cast<FLOAT>(i) * step, origin[1], origin[2], frequency, NUM_OCTAVES);
+                        uNumMismatches += std::memcmp(&expected, &aSamples[i], sizeof(FLOAT)) != 0 ? 1u : 0u;
+                    }
+                }
+            }
+        }
+    }
+    CHECK_EQUAL(0u, uNumMismatches);
+}
+
+TEST(PerlinNoiseIsContinuousAcrossZero)
+{
+    // The lattice cell of a negative coordinate is the one below it, so the noise does not jump where the coordinates change sign
+    const PerlinNoise noise(7u);
+    constexpr const FLOAT EPSILON = 1.0e-4f;
+    for (FLOAT y : { -3.5f, -0.5f, 0.0f, 2.25f })
+    {
+        CHECK(std::abs(noise.GetPerlin2d(-EPSILON, y, 1.0f, 1u) - noise.GetPerlin2d(EPSILON, y, 1.0f, 1u)) < 0.01f);
+        CHECK(std::abs(noise.GetGradient3d(-EPSILON, y, 0.5f, 1.0f, 1u) - noise.GetGradient3d(EPSILON, y, 0.5f, 1.0f, 1u)) < 0.01f);
+        CHECK(std::abs(noise.GetGradient3d(y, 0.5f, -1.0f - EPSILON, 1.0f, 1u) - noise.GetGradient3d(y, 0.5f, -1.0f + EPSILON, 1.0f, 1u)) < 0.01f);
+    }
+
+    // In range everywhere, and gradient noise is 0 on the lattice
+    for (FLOAT x = -300.0f; x < 300.0f; x += 0.7f)
+    {
+        const FLOAT value = noise.GetPerlin2d(x, x * 0.31f, 0.05f, 4u);
+        CHECK(value >= 0.0f && value < 1.0f);
+        CHECK(std::abs(noise.GetGradient3d(x, -x, x * 0.5f, 0.11f, 3u)) <= 1.0f);
+    }
+    CHECK_EQUAL(0.0f, noise.GetGradient3d(-3.0f, 5.0f, -260.0f, 1.0f, 1u));
+}
+
+TEST(PerlinNoiseIsSeeded)
+{
+    const PerlinNoise defaultNoise;
+    const PerlinNoise zeroNoise(0u);
+    const PerlinNoise seededNoise(7u);
+    const PerlinNoise sameNoise(7u);
+    CHECK_EQUAL(7u, seededNoise.GetSeed());
+
+    UINT uNumDifferent = 0u;
+    for (UINT i = 0u; i < 64u; ++i)
+    {
+        const FLOAT x = static_cast<FLOAT>(i) * 3.7f;
+        CHECK_EQUAL(defaultNoise.GetPerlin2d(x, 11.0f, 0.1f, 3u), zeroNoise.GetPerlin2d(x, 11.0f, 0.1f, 3u));
+        CHECK_EQUAL(seededNoise.GetPerlin2d(x, 11.0f, 0.1f, 3u), sameNoise.GetPerlin2d(x, 11.0f, 0.1f, 3u));
+        uNumDifferent += defaultNoise.GetPerlin2d(x, 11.0f, 0.1f, 3u) != seededNoise.GetPerlin2d(x, 11.0f, 0.1f, 3u) ? 1u : 0u;
+    }
+    CHECK(uNumDifferent > 48u);
+}
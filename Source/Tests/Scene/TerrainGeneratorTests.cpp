@@ -0,0 +1,238 @@
+#include "Test.h"
+
+#include <cstring>
+
+#include "Scene/TerrainGenerator.h"
+
+using namespace library;
+
+namespace
+{
+    // A region that starts and ends inside tiles, so the edge tiles are partial
+    constexpr const UINT REGION_X = 37u;
+    constexpr const UINT REGION_Z = 90u;
+    constexpr const UINT REGION_WIDTH = 300u;
+    constexpr const UINT REGION_DEPTH = 170u;
+    constexpr const size_t NUM_COLUMNS = static_cast<size_t>(REGION_WIDTH) * REGION_DEPTH;
+
+    constexpr const UINT NUM_CHUNKS_X = 5u;
+    constexpr const UINT NUM_CHUNKS_Z = 3u;
+    constexpr const UINT CHUNK_HEIGHT = 64u;
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   Region
+      Summary:  Grids of a region generated by one generator
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct Region
+    {
+        std::vector<FLOAT> aHeights;
+        std::vector<FLOAT> aMoistures;
+        std::vector<eBlockType> aBlockTypes;
+        std::vector<UINT> aOccupancyRows;
+    };
+
+    Region generateRegion(_Inout_ TerrainGenerator& generator)
+    {
+        Region region{ .aHeights = std::vector<FLOAT>(NUM_COLUMNS), .aMoistures = std::vector<FLOAT>(NUM_COLUMNS), .aBlockTypes = std::vector<eBlockType>(NUM_COLUMNS), .aOccupancyRows = {} };
+        generator.Generate(REGION_X, REGION_Z, REGION_WIDTH, REGION_DEPTH, region.aHeights.data(), region.aMoistures.data(), region.aBlockTypes.data());
+
+        std::vector<VoxelOccupancy> aChunks(NUM_CHUNKS_X * NUM_CHUNKS_Z);
+        for (VoxelOccupancy& chunk : aChunks)
+        {
+            chunk.Resize(CHUNK_HEIGHT);
+        }
+        generator.GenerateOccupancy(3u, 1u, NUM_CHUNKS_X, NUM_CHUNKS_Z, aChunks.data());
+        for (const VoxelOccupancy& chunk : aChunks)
+        {
+            for (UINT y = 0u; y < CHUNK_HEIGHT; ++y)
+            {
+                for (UINT z = 0u; z < VoxelOccupancy::SIZE; ++z)
+                {
+                    region.aOccupancyRows.push_back(chunk.GetRow(y, z));
+                }
+            }
+        }
+
+        return region;
+    }
+
+    // Bitwise, a float that differs in its last bit or a NaN is a difference
+    template <typename T>
+    BOOL isIdentical(_In_ const std::vector<T>& aExpected, _In_ const std::vector<T>& aActual)
+    {
+        return aExpected.size() == aActual.size() && std::memcmp(aExpected.data(), aActual.data(), sizeof(T) * aExpected.size()) == 0;
+    }
+
+    // The 64-bit FNV-1a hash GetFingerprint documents, over every input listed here
+    UINT64 getExpectedFingerprint(_In_ UINT uSeed, _In_ const BiomeClassifier::Table& table)
+    {
+        UINT64 uHash = 0xCBF29CE484222325ull;
+        const auto hash = [&uHash](const void* pData, size_t uSize)
+        {
+            for (size_t i = 0u; i < uSize; ++i)
+            {
+                uHash = (uHash ^ static_cast<const BYTE*>(pData)[i]) * 0x100000001B3ull;
+            }
+        };
+
+        const UINT aParameters[] = {
+            TerrainGenerator::VERSION, TerrainGenerator::NUM_OCTAVES, TerrainGenerator::DEPTH, TerrainGenerator::MOISTURE_SEED,
+            TerrainGenerator::DENSITY_DEPTH, TerrainGenerator::DENSITY_SEED, TerrainGenerator::CAVE_DEPTH, TerrainGenerator::CAVE_SEED
+        };
+        const FLOAT aFrequencies[] = {
+            TerrainGenerator::FREQUENCY, TerrainGenerator::DENSITY_FREQUENCY, TerrainGenerator::DENSITY_FALLOFF, TerrainGenerator::CAVE_FREQUENCY, TerrainGenerator::CAVE_THRESHOLD
+        };
+        hash(&uSeed, sizeof(uSeed));
+        hash(aParameters, sizeof(aParameters));
+        hash(aFrequencies, sizeof(aFrequencies));
+        hash(table.data(), sizeof(table));
+
+        return uHash;
+    }
+}
+
+TEST(TerrainGeneratorIsIndependentOfThreads)
+{
+    TerrainGenerator reference(42u, 1u);
+    const Region expected = generateRegion(reference);
+    CHECK(expected.aOccupancyRows.size() == static_cast<size_t>(NUM_CHUNKS_X) * NUM_CHUNKS_Z * CHUNK_HEIGHT * VoxelOccupancy::SIZE);
+
+    // More threads than tiles as well, and every generator twice so the pool runs a second job
+    for (UINT uNumThreads : { 1u, 2u, 3u, 8u, 24u })
+    {
+        TerrainGenerator generator(42u, uNumThreads);
+        CHECK_EQUAL(uNumThreads, generator.GetNumThreads());
+        for (UINT uRun = 0u; uRun < 2u; ++uRun)
+        {
+            const Region region = generateRegion(generator);
+            CHECK(isIdentical(expected.aHeights, region.aHeights));
+            CHECK(isIdentical(expected.aMoistures, region.aMoistures));
+            CHECK(isIdentical(expected.aBlockTypes, region.aBlockTypes));
+            CHECK(isIdentical(expected.aOccupancyRows, region.aOccupancyRows));
+        }
+    }
+
+    // Not a flat or uniform map
+    UINT uNumOcean = 0u;
+    UINT uNumMountains = 0u;
+    for (size_t i = 0u; i < NUM_COLUMNS; ++i)
+    {
+        uNumOcean += expected.aBlockTypes[i] == eBlockType::OCEAN ? 1u : 0u;
+        uNumMountains += expected.aHeights[i] >= 0.6f ? 1u : 0u;
+    }
+    CHECK(uNumOcean < NUM_COLUMNS && uNumMountains < NUM_COLUMNS && uNumOcean + uNumMountains > 0u);
+    CHECK(std::count_if(expected.aOccupancyRows.begin(), expected.aOccupancyRows.end(), [](UINT uRow) { return uRow != 0u && uRow != ~0u; }) > 1000);
+}
+
+TEST(TerrainGeneratorIsIndependentOfTheRegion)
+{
+    // A column gets the same values in a region of its own, and with only some of the grids asked for
+    TerrainGenerator generator(42u, 2u);
+    const Region expected = generateRegion(generator);
+    const UINT aColumns[][2] = { { 0u, 0u }, { 63u, 64u }, { 64u, 1u }, { REGION_WIDTH - 1u, REGION_DEPTH - 1u }, { 150u, 77u } };
+    for (const UINT(&column)[2] : aColumns)
+    {
+        FLOAT height = -1.0f;
+        eBlockType blockType = eBlockType::COUNT;
+        generator.Generate(REGION_X + column[0], REGION_Z + column[1], 1u, 1u, &height, nullptr, &blockType);
+        const size_t uColumnIdx = static_cast<size_t>(column[1]) * REGION_WIDTH + column[0];
+        CHECK(std::memcmp(&height, &expected.aHeights[uColumnIdx], sizeof(FLOAT)) == 0);
+        CHECK(blockType == expected.aBlockTypes[uColumnIdx]);
+    }
+
+    std::vector<FLOAT> aMoistures(static_cast<size_t>(REGION_WIDTH - 100u) * 40u);
+    generator.Generate(REGION_X + 100u, REGION_Z + 20u, REGION_WIDTH - 100u, 40u, nullptr, aMoistures.data(), nullptr);
+    UINT uNumMismatches = 0u;
+    for (UINT z = 0u; z < 40u; ++z)
+    {
+        uNumMismatches += std::memcmp(&aMoistures[static_cast<size_t>(z) * (REGION_WIDTH - 100u)], &expected.aMoistures[static_cast<size_t>(z + 20u) * REGION_WIDTH + 100u], sizeof(FLOAT) * (REGION_WIDTH - 100u)) != 0 ? 1u : 0u;
+    }
+    CHECK_EQUAL(0u, uNumMismatches);
+}
+
+TEST(TerrainGeneratorFollowsTheHeightsInChunks)
+{
+    // Cells far enough below the surface of their column are solid unless a cave is carved, far enough above are empty
+    constexpr const UINT SIZE = VoxelOccupancy::SIZE;
+    TerrainGenerator generator(42u, 2u);
+    std::vector<VoxelOccupancy> aChunks(NUM_CHUNKS_X * NUM_CHUNKS_Z);
+    for (VoxelOccupancy& chunk : aChunks)
+    {
+        chunk.Resize(CHUNK_HEIGHT);
+    }
+    generator.GenerateOccupancy(3u, 1u, NUM_CHUNKS_X, NUM_CHUNKS_Z, aChunks.data());
+
+    std::vector<FLOAT> aHeights(static_cast<size_t>(NUM_CHUNKS_X) * SIZE * NUM_CHUNKS_Z * SIZE);
+    generator.Generate(3u * SIZE, 1u * SIZE, NUM_CHUNKS_X * SIZE, NUM_CHUNKS_Z * SIZE, aHeights.data(), nullptr, nullptr);
+
+    UINT uNumFloating = 0u;
+    UINT uNumHoles = 0u;
+    UINT uNumBuried = 0u;
+    UINT uNumNearSurface = 0u;
+    UINT uNumSolidNearSurface = 0u;
+    for (UINT uChunkIdx = 0u; uChunkIdx < aChunks.size(); ++uChunkIdx)
+    {
+        const VoxelOccupancy& chunk = aChunks[uChunkIdx];
+        for (UINT z = 0u; z < SIZE; ++z)
+        {
+            for (UINT x = 0u; x < SIZE; ++x)
+            {
+                const size_t uColumnIdx = static_cast<size_t>((uChunkIdx / NUM_CHUNKS_X) * SIZE + z) * NUM_CHUNKS_X * SIZE + (uChunkIdx % NUM_CHUNKS_X) * SIZE + x;
+                const FLOAT surface = aHeights[uColumnIdx] * static_cast<FLOAT>(CHUNK_HEIGHT);
+                CHECK(chunk.IsSolid(x, 0u, z));
+                for (UINT y = 1u; y < CHUNK_HEIGHT; ++y)
+                {
+                    const FLOAT depth = surface - static_cast<FLOAT>(y);
+                    if (depth < -2.0f * TerrainGenerator::DENSITY_FALLOFF)
+                    {
+                        uNumFloating += chunk.IsSolid(x, y, z) ? 1u : 0u;
+                    }
+                    else if (depth > 2.0f * TerrainGenerator::DENSITY_FALLOFF)
+                    {
+                        ++uNumBuried;
+                        uNumHoles += chunk.IsSolid(x, y, z) ? 0u : 1u;
+                    }
+                    else
+                    {
+                        ++uNumNearSurface;
+                        uNumSolidNearSurface += chunk.IsSolid(x, y, z) ? 1u : 0u;
+                    }
+                }
+            }
+        }
+    }
+    CHECK_EQUAL(0u, uNumFloating);
+    CHECK(uNumBuried > 0u && uNumHoles * 4u < uNumBuried);
+
+    // Overhangs: near the surface the noise both fills and empties cells
+    CHECK(uNumSolidNearSurface > uNumNearSurface / 10u && uNumSolidNearSurface < uNumNearSurface * 9u / 10u);
+}
+
+TEST(TerrainGeneratorFingerprintsItsInputs)
+{
+    TerrainGenerator generator(42u, 1u);
+    TerrainGenerator sameGenerator(42u, 3u);
+    TerrainGenerator otherGenerator(43u, 1u);
+
+    // The seed, the version, every noise parameter and the biome table, not the number of threads. The noise
+    // parameters are constants, so the hash is pinned against one over all of them: a parameter left out of it fails
+    CHECK_EQUAL(getExpectedFingerprint(42u, BiomeClassifier::DEFAULT_TABLE), generator.GetFingerprint());
+    CHECK_EQUAL(generator.GetFingerprint(), sameGenerator.GetFingerprint());
+    CHECK(generator.GetFingerprint() != otherGenerator.GetFingerprint());
+
+    // Moving one threshold by a step of the table is a different terrain
+    BiomeRegion aRegions[std::size(BiomeClassifier::DEFAULT_REGIONS)];
+    std::copy(std::begin(BiomeClassifier::DEFAULT_REGIONS), std::end(BiomeClassifier::DEFAULT_REGIONS), aRegions);
+    aRegions[0].MaxHeight = 0.11f;
+    aRegions[1].MinHeight = 0.11f;
+    generator.SetBiomeRegions(aRegions, std::size(aRegions));
+    CHECK(generator.GetFingerprint() != sameGenerator.GetFingerprint());
+
+    BiomeClassifier classifier;
+    classifier.SetRegions(aRegions, std::size(aRegions));
+    CHECK_EQUAL(getExpectedFingerprint(42u, classifier.GetTable()), generator.GetFingerprint());
+
+    // And the same again once the table is back
+    generator.SetBiomeRegions(BiomeClassifier::DEFAULT_REGIONS, std::size(BiomeClassifier::DEFAULT_REGIONS));
+    CHECK_EQUAL(sameGenerator.GetFingerprint(), generator.GetFingerprint());
+}
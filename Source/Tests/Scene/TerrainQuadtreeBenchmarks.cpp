@@ -0,0 +1,55 @@
+#include "Test.h"
+
+#include <cmath>
+#include <random>
+
+#include "Scene/TerrainQuadtree.h"
+
+using namespace library;
+
+BENCHMARK(TerrainQuadtreeSelection2048x2048)
+{
+    // The levels of the scene over rolling hills, selected from 40 cameras walking over them
+    constexpr const UINT MAP_SIZE = 2048u;
+    constexpr const UINT NUM_CAMERAS = 40u;
+    constexpr const UINT TRIANGLES_PER_PATCH = 2u * TerrainQuadtree::PATCH_SIZE * TerrainQuadtree::PATCH_SIZE;
+
+    std::vector<WORD> aHeights(static_cast<size_t>(MAP_SIZE) * MAP_SIZE);
+    for (UINT z = 0u; z < MAP_SIZE; ++z)
+    {
+        for (UINT x = 0u; x < MAP_SIZE; ++x)
+        {
+            const FLOAT height = 48.0f + 24.0f * std::sin(static_cast<FLOAT>(x) * 0.013f) * std::cos(static_cast<FLOAT>(z) * 0.017f) + 6.0f * std::sin(static_cast<FLOAT>(x + 2u * z) * 0.11f);
+            aHeights[static_cast<size_t>(z) * MAP_SIZE + x] = static_cast<WORD>(std::max(height, 1.0f));
+        }
+    }
+
+    TerrainQuadtree quadtree(MAP_SIZE, MAP_SIZE, 7u, 96.0f, 0.3f);
+    quadtree.SetHeights(0u, 0u, MAP_SIZE, MAP_SIZE, aHeights.data());
+
+    std::mt19937 random(2u);
+    std::uniform_real_distribution<FLOAT> position(0.0f, static_cast<FLOAT>(MAP_SIZE - 1u));
+    std::vector<TerrainPatch> aPatches;
+    std::vector<TerrainPatch> aQuarterPatches;
+    double worstMilliseconds = 0.0;
+    size_t uMaxNumPatches = 0u;
+    for (UINT uCamera = 0u; uCamera < NUM_CAMERAS; ++uCamera)
+    {
+        const FLOAT x = position(random);
+        const FLOAT z = position(random);
+        const FLOAT y = static_cast<FLOAT>(aHeights[static_cast<size_t>(z) * MAP_SIZE + static_cast<size_t>(x)]) + 4.0f;
+        const double milliseconds = test::MeasureMilliseconds(100u, [&]()
+        {
+            quadtree.Select(x, y, z, aPatches, aQuarterPatches);
+        });
+        worstMilliseconds = std::max(worstMilliseconds, milliseconds);
+        uMaxNumPatches = std::max(uMaxNumPatches, aPatches.size() + aQuarterPatches.size());
+    }
+
+    // A quarter patch has a quarter of the triangles, counting it whole keeps the number an upper bound
+    CHECK(uMaxNumPatches <= quadtree.GetMaxNumPatches());
+    CHECK(worstMilliseconds < 0.5);
+
+    std::printf("  %u cameras  %6.3f ms worst  %zu patches at most  %zu triangles at most  %u patches bound\n",
+        NUM_CAMERAS, worstMilliseconds, uMaxNumPatches, uMaxNumPatches * TRIANGLES_PER_PATCH, quadtree.GetMaxNumPatches());
+}
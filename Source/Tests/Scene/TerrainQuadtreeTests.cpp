@@ -0,0 +1,193 @@
+#include "Test.h"
+
+#include <cmath>
+#include <random>
+
+#include "Scene/TerrainQuadtree.h"
+
+using namespace library;
+
+namespace
+{
+    constexpr const UINT PATCH_SIZE = TerrainQuadtree::PATCH_SIZE;
+
+    // Distance from a position to a square of columns lying flat at height 0, clamped to the last column like the quadtree
+    FLOAT getDistance(_In_ const TerrainPatch& patch, _In_ UINT uWidth, _In_ UINT uDepth, _In_ FLOAT x, _In_ FLOAT y, _In_ FLOAT z)
+    {
+        const FLOAT dx = std::max({ static_cast<FLOAT>(patch.X) - x, 0.0f, x - static_cast<FLOAT>(std::min(patch.X + patch.Size, uWidth - 1u)) });
+        const FLOAT dz = std::max({ static_cast<FLOAT>(patch.Z) - z, 0.0f, z - static_cast<FLOAT>(std::min(patch.Z + patch.Size, uDepth - 1u)) });
+        return std::sqrt(dx * dx + y * y + dz * dz);
+    }
+
+    // Level of the patch drawing each PATCH_SIZE square of the map, UINT_MAX where none does, FALSE if two patches overlap
+    BOOL getCoverage(_In_ const std::vector<TerrainPatch>& aPatches, _In_ const std::vector<TerrainPatch>& aQuarterPatches, _In_ UINT uNumCellsX, _In_ UINT uNumCellsZ, _Out_ std::vector<UINT>& aLods)
+    {
+        BOOL bDisjoint = TRUE;
+        aLods.assign(static_cast<size_t>(uNumCellsX) * uNumCellsZ, UINT_MAX);
+        for (const std::vector<TerrainPatch>* pPatches : { &aPatches, &aQuarterPatches })
+        {
+            for (const TerrainPatch& patch : *pPatches)
+            {
+                for (UINT uCellZ = patch.Z / PATCH_SIZE; uCellZ < std::min((patch.Z + patch.Size) / PATCH_SIZE, uNumCellsZ); ++uCellZ)
+                {
+                    for (UINT uCellX = patch.X / PATCH_SIZE; uCellX < std::min((patch.X + patch.Size) / PATCH_SIZE, uNumCellsX); ++uCellX)
+                    {
+                        UINT& uLod = aLods[static_cast<size_t>(uCellZ) * uNumCellsX + uCellX];
+                        bDisjoint = bDisjoint && uLod == UINT_MAX;
+                        uLod = patch.Lod;
+                    }
+                }
+            }
+        }
+        return bDisjoint;
+    }
+}
+
+TEST(TerrainQuadtreeCoversTheRangeOnce)
+{
+    // Flat map walked over by a camera: every square within the top range is drawn by exactly one patch, and neighbors differ by one level at most
+    constexpr const UINT SIZE = 2048u;
+    constexpr const UINT NUM_CELLS = SIZE / PATCH_SIZE;
+    TerrainQuadtree quadtree(SIZE, SIZE, 5u, 128.0f, 0.3f);
+
+    FLOAT morphStart = 0.0f;
+    FLOAT topRange = 0.0f;
+    quadtree.GetMorphRange(quadtree.GetNumLods() - 1u, morphStart, topRange);
+
+    std::mt19937 random(19u);
+    std::uniform_real_distribution<FLOAT> position(0.0f, static_cast<FLOAT>(SIZE));
+    std::vector<TerrainPatch> aPatches;
+    std::vector<TerrainPatch> aQuarterPatches;
+    std::vector<UINT> aLods;
+    for (UINT uCamera = 0u; uCamera < 40u; ++uCamera)
+    {
+        const FLOAT x = position(random);
+        const FLOAT y = 4.0f + static_cast<FLOAT>(uCamera);
+        const FLOAT z = position(random);
+        quadtree.Select(x, y, z, aPatches, aQuarterPatches);
+        CHECK(aPatches.size() + aQuarterPatches.size() <= quadtree.GetMaxNumPatches());
+        CHECK(getCoverage(aPatches, aQuarterPatches, NUM_CELLS, NUM_CELLS, aLods));
+
+        for (UINT uCellZ = 0u; uCellZ < NUM_CELLS; ++uCellZ)
+        {
+            for (UINT uCellX = 0u; uCellX < NUM_CELLS; ++uCellX)
+            {
+                const UINT uLod = aLods[static_cast<size_t>(uCellZ) * NUM_CELLS + uCellX];
+                const TerrainPatch cell = { .X = uCellX * PATCH_SIZE, .Z = uCellZ * PATCH_SIZE, .Size = PATCH_SIZE, .Lod = 0u };
+                CHECK(uLod != UINT_MAX || getDistance(cell, SIZE, SIZE, x, y, z) > topRange);
+                if (uLod == UINT_MAX)
+                {
+                    continue;
+                }
+                if (uCellX + 1u < NUM_CELLS && aLods[static_cast<size_t>(uCellZ) * NUM_CELLS + uCellX + 1u] != UINT_MAX)
+                {
+                    const UINT uRight = aLods[static_cast<size_t>(uCellZ) * NUM_CELLS + uCellX + 1u];
+                    CHECK(std::max(uLod, uRight) - std::min(uLod, uRight) <= 1u);
+                }
+                if (uCellZ + 1u < NUM_CELLS && aLods[static_cast<size_t>(uCellZ + 1u) * NUM_CELLS + uCellX] != UINT_MAX)
+                {
+                    const UINT uBelow = aLods[static_cast<size_t>(uCellZ + 1u) * NUM_CELLS + uCellX];
+                    CHECK(std::max(uLod, uBelow) - std::min(uLod, uBelow) <= 1u);
+                }
+            }
+        }
+    }
+}
+
+TEST(TerrainQuadtreeSelectsLevelsByDistance)
+{
+    // A patch of level L is beyond the range of level L - 1, a whole one within its own range, and level L morphs up to its range
+    constexpr const UINT SIZE = 1024u;
+    TerrainQuadtree quadtree(SIZE, SIZE, 4u, 100.0f, 0.5f);
+
+    FLOAT previousEnd = 0.0f;
+    for (UINT uLod = 0u; uLod < quadtree.GetNumLods(); ++uLod)
+    {
+        FLOAT start = 0.0f;
+        FLOAT end = 0.0f;
+        quadtree.GetMorphRange(uLod, start, end);
+        CHECK(start >= previousEnd && start < end);
+        CHECK(uLod == 0u || std::abs(end - 2.0f * previousEnd) < 1e-3f);
+        previousEnd = end;
+    }
+
+    std::vector<TerrainPatch> aPatches;
+    std::vector<TerrainPatch> aQuarterPatches;
+    quadtree.Select(300.0f, 10.0f, 700.0f, aPatches, aQuarterPatches);
+    CHECK(!aPatches.empty());
+    CHECK(!aQuarterPatches.empty());
+    for (const TerrainPatch& patch : aPatches)
+    {
+        FLOAT start = 0.0f;
+        FLOAT end = 0.0f;
+        quadtree.GetMorphRange(patch.Lod, start, end);
+        CHECK_EQUAL(PATCH_SIZE << patch.Lod, patch.Size);
+        CHECK(getDistance(patch, SIZE, SIZE, 300.0f, 10.0f, 700.0f) <= end);
+        if (patch.Lod > 0u)
+        {
+            quadtree.GetMorphRange(patch.Lod - 1u, start, end);
+            CHECK(getDistance(patch, SIZE, SIZE, 300.0f, 10.0f, 700.0f) > end);
+        }
+    }
+    for (const TerrainPatch& patch : aQuarterPatches)
+    {
+        FLOAT start = 0.0f;
+        FLOAT end = 0.0f;
+        quadtree.GetMorphRange(patch.Lod - 1u, start, end);
+        CHECK(patch.Lod > 0u);
+        CHECK_EQUAL(PATCH_SIZE << (patch.Lod - 1u), patch.Size);
+        CHECK(getDistance(patch, SIZE, SIZE, 300.0f, 10.0f, 700.0f) > end);
+    }
+}
+
+TEST(TerrainQuadtreeSplitsAroundHills)
+{
+    // High above a flat map nothing is fine, a hill rising under the camera brings the finest level back
+    constexpr const UINT SIZE = 512u;
+    TerrainQuadtree quadtree(SIZE, SIZE, 4u, 96.0f, 0.3f);
+    std::vector<TerrainPatch> aPatches;
+    std::vector<TerrainPatch> aQuarterPatches;
+    const auto countFinest = [&]()
+    {
+        quadtree.Select(256.0f, 300.0f, 256.0f, aPatches, aQuarterPatches);
+        UINT uNumFinest = 0u;
+        for (const TerrainPatch& patch : aPatches)
+        {
+            uNumFinest += patch.Lod == 0u ? 1u : 0u;
+        }
+        return uNumFinest;
+    };
+    CHECK_EQUAL(0u, countFinest());
+
+    std::vector<WORD> aHeights(static_cast<size_t>(SIZE) * SIZE, 0u);
+    for (UINT z = 240u; z < 272u; ++z)
+    {
+        for (UINT x = 240u; x < 272u; ++x)
+        {
+            aHeights[static_cast<size_t>(z) * SIZE + x] = 280u;
+        }
+    }
+    quadtree.SetHeights(240u, 240u, 32u, 32u, aHeights.data());
+    CHECK(countFinest() > 0u);
+
+    // Flattening it again gives the same selection as before
+    std::fill(aHeights.begin(), aHeights.end(), static_cast<WORD>(0u));
+    quadtree.SetHeights(240u, 240u, 32u, 32u, aHeights.data());
+    CHECK_EQUAL(0u, countFinest());
+}
+
+TEST(TerrainQuadtreeBoundDoesNotGrowWithTheMap)
+{
+    // The bound and the selection at the same place in the top nodes stay the same from a map of 4096 to one of 16384 columns
+    TerrainQuadtree small(4096u, 4096u, 4u, 128.0f, 0.3f);
+    TerrainQuadtree large(16384u, 16384u, 4u, 128.0f, 0.3f);
+    CHECK_EQUAL(small.GetMaxNumPatches(), large.GetMaxNumPatches());
+
+    std::vector<TerrainPatch> aPatches;
+    std::vector<TerrainPatch> aQuarterPatches;
+    large.Select(10192.0f, 20.0f, 8144.0f, aPatches, aQuarterPatches);
+    const size_t uNumLarge = aPatches.size() + aQuarterPatches.size();
+    small.Select(2000.0f, 20.0f, 2000.0f, aPatches, aQuarterPatches);
+    CHECK(uNumLarge <= large.GetMaxNumPatches());
+    CHECK_EQUAL(aPatches.size() + aQuarterPatches.size(), uNumLarge);
+}
@@ -0,0 +1,152 @@
+#include "Test.h"
+
+#include <cmath>
+#include <random>
+
+#include "Scene/VoxelInstanceBuilder.h"
+#include "Scene/VoxelLods.h"
+#include "Scene/VoxelRayCaster.h"
+#include "Scene/VoxelSlotAllocator.h"
+
+using namespace library;
+
+namespace
+{
+    constexpr const UINT CHUNK_SIZE = 32u;
+    constexpr const UINT NUM_LODS = 4u;
+
+    // Slots of a chunk the way the scene reserves them
+    UINT getSlotCapacity(_In_ UINT uNumInstances)
+    {
+        return uNumInstances + uNumInstances / 4u + CHUNK_SIZE;
+    }
+}
+
+BENCHMARK(VoxelEditFrame1024x1024)
+{
+    // The CPU side of a frame that places or removes a block on a map of about a million cubes: the
+    // levels of detail, the picking heights, every level of the chunks that see the column, the slots
+    // of the chunks that grow and the staging copy. The copy to the instance buffer runs on the GPU
+    constexpr const UINT MAP_SIZE = 1024u;
+    constexpr const UINT NUM_CHUNKS = MAP_SIZE / CHUNK_SIZE;
+    constexpr const UINT NUM_EDITS = 3000u;
+    constexpr const UINT STAGING_SLOTS = 65536u;
+    constexpr const size_t NUM_BLOCK_TYPES = static_cast<size_t>(eBlockType::COUNT) - static_cast<size_t>(eBlockType::GRASSLAND);
+
+    std::vector<VoxelColumn> aColumns(static_cast<size_t>(MAP_SIZE) * MAP_SIZE);
+    for (UINT z = 0u; z < MAP_SIZE; ++z)
+    {
+        for (UINT x = 0u; x < MAP_SIZE; ++x)
+        {
+            const FLOAT height = 48.0f + 24.0f * std::sin(static_cast<FLOAT>(x) * 0.013f) * std::cos(static_cast<FLOAT>(z) * 0.017f) + 6.0f * std::sin(static_cast<FLOAT>(x + 2u * z) * 0.11f);
+            const UINT uHeight = static_cast<UINT>(std::max(height, 1.0f));
+            aColumns[static_cast<size_t>(z) * MAP_SIZE + x] = VoxelColumn
+            {
+                .BlockType = static_cast<CHAR>(static_cast<UINT>(eBlockType::GRASSLAND) + std::min(uHeight / 16u, static_cast<UINT>(NUM_BLOCK_TYPES) - 1u)),
+                .Reserved = 0u,
+                .Height = static_cast<WORD>(uHeight)
+            };
+        }
+    }
+
+    VoxelLods lods(NUM_LODS);
+    lods.Build(aColumns.data(), MAP_SIZE, MAP_SIZE, NUM_BLOCK_TYPES);
+    VoxelRayCaster caster;
+    caster.Build(aColumns.data(), MAP_SIZE, MAP_SIZE, NUM_BLOCK_TYPES);
+
+    // Every chunk at its finest level, as close to the camera as a chunk gets
+    std::vector<std::vector<InstanceData>> aChunkInstances(static_cast<size_t>(NUM_CHUNKS) * NUM_CHUNKS);
+    std::vector<VoxelSlotRange> aChunkSlots(aChunkInstances.size());
+    VoxelSlotAllocator allocator;
+    for (UINT uChunkZ = 0u; uChunkZ < NUM_CHUNKS; ++uChunkZ)
+    {
+        for (UINT uChunkX = 0u; uChunkX < NUM_CHUNKS; ++uChunkX)
+        {
+            VoxelInstanceBuilder builder(aColumns.data(), MAP_SIZE, MAP_SIZE, NUM_BLOCK_TYPES);
+            builder.Build(0u, uChunkX * CHUNK_SIZE, uChunkZ * CHUNK_SIZE, (uChunkX + 1u) * CHUNK_SIZE, (uChunkZ + 1u) * CHUNK_SIZE);
+            const size_t uChunkIdx = static_cast<size_t>(uChunkZ) * NUM_CHUNKS + uChunkX;
+            aChunkInstances[uChunkIdx] = std::move(builder.GetInstances());
+            aChunkSlots[uChunkIdx] = allocator.Allocate(getSlotCapacity(static_cast<UINT>(aChunkInstances[uChunkIdx].size())));
+        }
+    }
+    const UINT uNumInitialSlots = allocator.GetNumSlots();
+
+    std::mt19937 random(5u);
+    std::uniform_int_distribution<UINT> position(MAP_SIZE / 2u + 8u, MAP_SIZE / 2u + 15u);
+    std::vector<InstanceData> aStaging(STAGING_SLOTS);
+    double totalMilliseconds = 0.0;
+    double worstMilliseconds = 0.0;
+    UINT uNumMoves = 0u;
+    for (UINT uEdit = 0u; uEdit < NUM_EDITS; ++uEdit)
+    {
+        // Pick straight down on a column of a building site inside a chunk, and mostly stack blocks so the chunk outgrows its slots
+        const UINT uPickX = position(random);
+        const UINT uPickZ = position(random);
+        const BOOL bPlace = random() % 4u != 0u;
+        const double milliseconds = test::MeasureMilliseconds(1u, [&]()
+        {
+            VoxelRayHit hit;
+            const XMFLOAT3 origin(static_cast<FLOAT>(uPickX) + 0.5f, 200.0f, static_cast<FLOAT>(uPickZ) + 0.5f);
+            if (!caster.RayCast(aColumns.data(), origin, XMFLOAT3(0.0f, -1.0f, 0.0f), 256.0f, hit))
+            {
+                return;
+            }
+
+            const UINT x = static_cast<UINT>(hit.Cell.x);
+            const UINT z = static_cast<UINT>(hit.Cell.z);
+            VoxelColumn& column = aColumns[static_cast<size_t>(z) * MAP_SIZE + x];
+            column.Height = static_cast<WORD>(bPlace ? column.Height + 1u : std::max(column.Height, static_cast<WORD>(2u)) - 1u);
+            lods.Update(aColumns.data(), x, z, 1u, 1u);
+            caster.Update(aColumns.data(), x, z, 1u, 1u);
+
+            // The chunks whose coarsest level covers the column or its neighbors
+            const UINT uReach = (2u << (NUM_LODS - 1u)) - 1u;
+            UINT uNumStagingSlots = 0u;
+            for (UINT uChunkZ = (z - std::min(z, uReach)) / CHUNK_SIZE; uChunkZ <= std::min(z + uReach, MAP_SIZE - 1u) / CHUNK_SIZE; ++uChunkZ)
+            {
+                for (UINT uChunkX = (x - std::min(x, uReach)) / CHUNK_SIZE; uChunkX <= std::min(x + uReach, MAP_SIZE - 1u) / CHUNK_SIZE; ++uChunkX)
+                {
+                    const size_t uChunkIdx = static_cast<size_t>(uChunkZ) * NUM_CHUNKS + uChunkX;
+                    for (UINT uLod = NUM_LODS; uLod-- > 0u;)
+                    {
+                        const UINT uLodWidth = lods.GetWidth(uLod);
+                        const UINT uLodDepth = lods.GetDepth(uLod);
+                        VoxelInstanceBuilder builder(uLod == 0u ? aColumns.data() : lods.GetColumns(uLod).data(), uLodWidth, uLodDepth, NUM_BLOCK_TYPES);
+                        builder.Build(uLod, (uChunkX * CHUNK_SIZE) >> uLod, (uChunkZ * CHUNK_SIZE) >> uLod,
+                            std::min(((uChunkX + 1u) * CHUNK_SIZE) >> uLod, uLodWidth), std::min(((uChunkZ + 1u) * CHUNK_SIZE) >> uLod, uLodDepth));
+                        if (uLod == 0u)
+                        {
+                            aChunkInstances[uChunkIdx] = std::move(builder.GetInstances());
+                        }
+                    }
+
+                    const std::vector<InstanceData>& aInstances = aChunkInstances[uChunkIdx];
+                    VoxelSlotRange& slots = aChunkSlots[uChunkIdx];
+                    if (aInstances.size() > slots.uNumSlots)
+                    {
+                        std::fill(aStaging.begin() + uNumStagingSlots, aStaging.begin() + uNumStagingSlots + slots.uNumSlots, InstanceData{});
+                        uNumStagingSlots += slots.uNumSlots;
+                        allocator.Free(slots);
+                        slots = allocator.Allocate(getSlotCapacity(static_cast<UINT>(aInstances.size())));
+                        ++uNumMoves;
+                    }
+                    std::copy(aInstances.begin(), aInstances.end(), aStaging.begin() + uNumStagingSlots);
+                    std::fill(aStaging.begin() + uNumStagingSlots + aInstances.size(), aStaging.begin() + uNumStagingSlots + slots.uNumSlots, InstanceData{});
+                    uNumStagingSlots += slots.uNumSlots;
+                }
+            }
+        });
+
+        totalMilliseconds += milliseconds;
+        worstMilliseconds = std::max(worstMilliseconds, milliseconds);
+    }
+
+    // A frame at 60 Hz has 16.7 ms, an edit should take a small part of it even when the machine gets in the way
+    CHECK(uNumInitialSlots > 1000000u);
+    CHECK(uNumMoves > 0u);
+    CHECK(totalMilliseconds / NUM_EDITS < 1.0);
+    CHECK(worstMilliseconds < 8.0);
+
+    std::printf("  %u slots  %u edits  %6.3f ms mean  %6.3f ms worst  %u moves  %u slots after  %zu free ranges\n",
+        uNumInitialSlots, NUM_EDITS, totalMilliseconds / NUM_EDITS, worstMilliseconds, uNumMoves, allocator.GetNumSlots(), allocator.GetFreeRanges().size());
+}
@@ -0,0 +1,200 @@
+#include "Test.h"
+
+#include <random>
+#include <set>
+#include <tuple>
+
+#include "Scene/VoxelInstanceBuilder.h"
+
+using namespace library;
+
+namespace
+{
+    constexpr const CHAR GRASSLAND = static_cast<CHAR>(eBlockType::GRASSLAND);
+    constexpr const CHAR SNOW = static_cast<CHAR>(eBlockType::SNOW);
+    constexpr const CHAR OCEAN = static_cast<CHAR>(eBlockType::OCEAN);
+
+    VoxelColumn column(_In_ CHAR blockType, _In_ WORD height)
+    {
+        return VoxelColumn{ .BlockType = blockType, .Reserved = 0u, .Height = height };
+    }
+
+    // Height of a column the way the builder sees it, 0 outside of the map or without a voxel
+    UINT getHeight(_In_ const std::vector<VoxelColumn>& aColumns, _In_ UINT uWidth, _In_ UINT uDepth, _In_ size_t uNumBlockTypes, _In_ INT x, _In_ INT z)
+    {
+        if (x < 0 || z < 0 || static_cast<UINT>(x) >= uWidth || static_cast<UINT>(z) >= uDepth)
+        {
+            return 0u;
+        }
+
+        const VoxelColumn& voxelColumn = aColumns[static_cast<size_t>(z) * uWidth + static_cast<size_t>(x)];
+        return static_cast<size_t>(voxelColumn.BlockType - GRASSLAND) < uNumBlockTypes ? voxelColumn.Height : 0u;
+    }
+}
+
+TEST(VoxelInstanceBuilderKeepsExposedCubes)
+{
+    // Every cube with its top or a side open to air, compared against each face of each cube
+    constexpr const UINT WIDTH = 24u;
+    constexpr const UINT DEPTH = 20u;
+    constexpr const size_t NUM_BLOCK_TYPES = 2u;
+
+    std::mt19937 random(3u);
+    std::vector<VoxelColumn> aColumns(static_cast<size_t>(WIDTH) * DEPTH);
+    for (VoxelColumn& voxelColumn : aColumns)
+    {
+        const CHAR aTypes[] = { GRASSLAND, SNOW, OCEAN };
+        voxelColumn = column(aTypes[random() % 3u], static_cast<WORD>(random() % 12u));
+    }
+
+    VoxelInstanceBuilder builder(aColumns.data(), WIDTH, DEPTH, NUM_BLOCK_TYPES);
+    for (UINT uBeginZ = 0u; uBeginZ < DEPTH; uBeginZ += 8u)
+    {
+        for (UINT uBeginX = 0u; uBeginX < WIDTH; uBeginX += 8u)
+        {
+            const UINT uEndX = std::min(uBeginX + 8u, WIDTH);
+            const UINT uEndZ = std::min(uBeginZ + 8u, DEPTH);
+            std::set<std::tuple<UINT, UINT, UINT>> expected;
+            UINT uMinHeight = UINT_MAX;
+            UINT uMaxHeight = 0u;
+            for (UINT z = uBeginZ; z < uEndZ; ++z)
+            {
+                for (UINT x = uBeginX; x < uEndX; ++x)
+                {
+                    const INT iX = static_cast<INT>(x);
+                    const INT iZ = static_cast<INT>(z);
+                    const UINT uHeight = getHeight(aColumns, WIDTH, DEPTH, NUM_BLOCK_TYPES, iX, iZ);
+                    for (UINT y = 0u; y < uHeight; ++y)
+                    {
+                        const BOOL bExposed = y + 1u == uHeight
+                            || getHeight(aColumns, WIDTH, DEPTH, NUM_BLOCK_TYPES, iX - 1, iZ) <= y
+                            || getHeight(aColumns, WIDTH, DEPTH, NUM_BLOCK_TYPES, iX + 1, iZ) <= y
+                            || getHeight(aColumns, WIDTH, DEPTH, NUM_BLOCK_TYPES, iX, iZ - 1) <= y
+                            || getHeight(aColumns, WIDTH, DEPTH, NUM_BLOCK_TYPES, iX, iZ + 1) <= y;
+                        if (bExposed)
+                        {
+                            expected.emplace(x, y, z);
+                            uMinHeight = std::min(uMinHeight, y);
+                            uMaxHeight = std::max(uMaxHeight, uHeight);
+                        }
+                    }
+                }
+            }
+
+            builder.Build(0u, uBeginX, uBeginZ, uEndX, uEndZ);
+            std::set<std::tuple<UINT, UINT, UINT>> actual;
+            for (const InstanceData& instance : builder.GetInstances())
+            {
+                actual.emplace(instance.X, instance.Y, instance.Z);
+            }
+            CHECK_EQUAL(expected.size(), builder.GetInstances().size());
+            CHECK(expected == actual);
+            CHECK_EQUAL(expected.empty() ? 0u : uMinHeight, builder.GetMinHeight());
+            CHECK_EQUAL(uMaxHeight, builder.GetMaxHeight());
+        }
+    }
+}
+
+TEST(VoxelInstanceBuilderPacksLevelAndType)
+{
+    // A lone snow column of 3 at level 2 keeps all of its cubes, an ocean column none
+    std::vector<VoxelColumn> aColumns(4u * 4u, column(GRASSLAND, 0u));
+    aColumns[5] = column(SNOW, 3u);
+    aColumns[10] = column(OCEAN, 5u);
+
+    VoxelInstanceBuilder builder(aColumns.data(), 4u, 4u, 2u);
+    builder.Build(2u, 0u, 0u, 4u, 4u);
+    CHECK_EQUAL(3u, builder.GetInstances().size());
+    CHECK_EQUAL(0u, builder.GetMinHeight());
+    CHECK_EQUAL(3u, builder.GetMaxHeight());
+    for (UINT y = 0u; y < builder.GetInstances().size(); ++y)
+    {
+        UINT aCell[3];
+        UINT uLod = 0u;
+        CHAR blockType = 0;
+        CHECK(UnpackInstance(builder.GetInstances()[y], aCell, uLod, blockType));
+        CHECK(aCell[0] == 1u && aCell[1] == y && aCell[2] == 1u);
+        CHECK_EQUAL(2u, uLod);
+        CHECK_EQUAL(SNOW, blockType);
+    }
+
+    // Nothing to build leaves no instance and no height
+    builder.Build(2u, 2u, 0u, 4u, 2u);
+    CHECK(builder.GetInstances().empty());
+    CHECK_EQUAL(0u, builder.GetMinHeight());
+    CHECK_EQUAL(0u, builder.GetMaxHeight());
+}
+
+TEST(VoxelInstanceBuilderBuildsOccupancy)
+{
+    // A chunk filled from columns gives the instances of the columns, the ocean column is not drawn
+    constexpr const UINT SIZE = VoxelOccupancy::SIZE;
+    constexpr const size_t NUM_BLOCK_TYPES = 2u;
+
+    std::mt19937 random(5u);
+    std::vector<VoxelColumn> aColumns(static_cast<size_t>(SIZE) * SIZE);
+    std::vector<eBlockType> aBlockTypes(aColumns.size());
+    VoxelOccupancy chunk;
+    chunk.Resize(16u);
+    for (UINT z = 0u; z < SIZE; ++z)
+    {
+        for (UINT x = 0u; x < SIZE; ++x)
+        {
+            const size_t uColumnIdx = static_cast<size_t>(z) * SIZE + x;
+            const CHAR blockType = uColumnIdx == 100u ? OCEAN : (random() % 2u ? GRASSLAND : SNOW);
+            aColumns[uColumnIdx] = column(blockType, static_cast<WORD>(uColumnIdx == 100u ? 0u : 1u + random() % 15u));
+            aBlockTypes[uColumnIdx] = static_cast<eBlockType>(blockType);
+            for (UINT y = 0u; y < aColumns[uColumnIdx].Height; ++y)
+            {
+                chunk.SetSolid(x, y, z, TRUE);
+            }
+        }
+    }
+
+    VoxelInstanceBuilder builder(aColumns.data(), SIZE, SIZE, NUM_BLOCK_TYPES);
+    builder.Build(0u, 0u, 0u, SIZE, SIZE, 64, 96);
+    std::set<std::tuple<UINT, UINT, UINT, CHAR>> expected;
+    for (const InstanceData& instance : builder.GetInstances())
+    {
+        expected.emplace(instance.X, instance.Y, instance.Z, instance.BlockType);
+    }
+    const UINT uMinHeight = builder.GetMinHeight();
+    const UINT uMaxHeight = builder.GetMaxHeight();
+
+    VoxelInstanceBuilder occupancyBuilder(nullptr, 0u, 0u, NUM_BLOCK_TYPES);
+    occupancyBuilder.BuildOccupancy(chunk, aBlockTypes.data(), 64, 96);
+    std::set<std::tuple<UINT, UINT, UINT, CHAR>> actual;
+    for (const InstanceData& instance : occupancyBuilder.GetInstances())
+    {
+        actual.emplace(instance.X, instance.Y, instance.Z, instance.BlockType);
+        CHECK_EQUAL(0u, static_cast<UINT>(instance.Lod));
+    }
+    CHECK_EQUAL(expected.size(), occupancyBuilder.GetInstances().size());
+    CHECK(expected == actual);
+    CHECK_EQUAL(uMinHeight, occupancyBuilder.GetMinHeight());
+    CHECK_EQUAL(uMaxHeight, occupancyBuilder.GetMaxHeight());
+
+    // An overhang shows its bottom, a cell buried in a column is hidden
+    chunk.Clear();
+    for (UINT x = 0u; x < 3u; ++x)
+    {
+        for (UINT z = 0u; z < 3u; ++z)
+        {
+            for (UINT y = 4u; y < 7u; ++y)
+            {
+                chunk.SetSolid(x + 10u, y, z + 10u, TRUE);
+            }
+        }
+    }
+    std::fill(aBlockTypes.begin(), aBlockTypes.end(), eBlockType::SNOW);
+    occupancyBuilder.BuildOccupancy(chunk, aBlockTypes.data(), 0, 0);
+    CHECK_EQUAL(27u - 1u, occupancyBuilder.GetInstances().size());
+    CHECK_EQUAL(4u, occupancyBuilder.GetMinHeight());
+    CHECK_EQUAL(7u, occupancyBuilder.GetMaxHeight());
+
+    chunk.Clear();
+    occupancyBuilder.BuildOccupancy(chunk, aBlockTypes.data(), 0, 0);
+    CHECK(occupancyBuilder.GetInstances().empty());
+    CHECK_EQUAL(0u, occupancyBuilder.GetMinHeight());
+    CHECK_EQUAL(0u, occupancyBuilder.GetMaxHeight());
+}
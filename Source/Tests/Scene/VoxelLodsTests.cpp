@@ -0,0 +1,133 @@
+#include "Test.h"
+
+#include <cstring>
+#include <random>
+
+#include "Scene/VoxelLods.h"
+
+using namespace library;
+
+namespace
+{
+    constexpr const CHAR GRASSLAND = static_cast<CHAR>(eBlockType::GRASSLAND);
+    constexpr const CHAR SNOW = static_cast<CHAR>(eBlockType::SNOW);
+    constexpr const CHAR OCEAN = static_cast<CHAR>(eBlockType::OCEAN);
+
+    VoxelColumn column(_In_ CHAR blockType, _In_ WORD height)
+    {
+        return VoxelColumn{ .BlockType = blockType, .Reserved = 0u, .Height = height };
+    }
+
+    BOOL isEqual(_In_ const std::vector<VoxelColumn>& aLeft, _In_ const std::vector<VoxelColumn>& aRight)
+    {
+        return aLeft.size() == aRight.size() && std::memcmp(aLeft.data(), aRight.data(), sizeof(VoxelColumn) * aLeft.size()) == 0;
+    }
+}
+
+TEST(VoxelLodsAveragesHeights)
+{
+    // Two snow columns outvote one grassland column, and 10 cubes over 4 columns of 2 round to 1
+    const std::vector<VoxelColumn> aColumns = { column(SNOW, 4u), column(GRASSLAND, 4u), column(SNOW, 2u), column(0, 0u) };
+
+    VoxelLods lods(2u);
+    lods.Build(aColumns.data(), 2u, 2u, 2u);
+
+    CHECK_EQUAL(2u, lods.GetNumLods());
+    CHECK_EQUAL(1u, lods.GetWidth(1u));
+    CHECK_EQUAL(1u, lods.GetColumns(1u).size());
+    CHECK_EQUAL(SNOW, lods.GetColumns(1u)[0].BlockType);
+    CHECK_EQUAL(1u, lods.GetColumns(1u)[0].Height);
+}
+
+TEST(VoxelLodsKeepsThinColumns)
+{
+    // One cube under 8 x 8 columns keeps a cube at level 3, and no cube leaves the column empty
+    std::vector<VoxelColumn> aColumns(8u * 8u, column(GRASSLAND, 0u));
+    aColumns[27] = column(SNOW, 1u);
+
+    VoxelLods lods(4u);
+    lods.Build(aColumns.data(), 8u, 8u, 2u);
+    for (UINT uLod = 1u; uLod < 4u; ++uLod)
+    {
+        UINT uNumSolid = 0u;
+        for (const VoxelColumn& lodColumn : lods.GetColumns(uLod))
+        {
+            uNumSolid += lodColumn.Height;
+            CHECK(lodColumn.Height == 0u || lodColumn.BlockType == SNOW);
+        }
+        CHECK_EQUAL(1u, uNumSolid);
+    }
+}
+
+TEST(VoxelLodsIgnoresBlockTypesWithoutVoxel)
+{
+    const std::vector<VoxelColumn> aColumns = { column(OCEAN, 8u), column(OCEAN, 8u), column(GRASSLAND, 2u), column(OCEAN, 8u) };
+
+    VoxelLods lods(2u);
+    lods.Build(aColumns.data(), 2u, 2u, 2u);
+
+    CHECK_EQUAL(GRASSLAND, lods.GetColumns(1u)[0].BlockType);
+    CHECK_EQUAL(1u, lods.GetColumns(1u)[0].Height);
+}
+
+TEST(VoxelLodsCoversPartialEdges)
+{
+    // The last column of level 1 only covers the last column of the map
+    const std::vector<VoxelColumn> aColumns = { column(GRASSLAND, 2u), column(GRASSLAND, 2u), column(SNOW, 6u) };
+
+    VoxelLods lods(3u);
+    lods.Build(aColumns.data(), 3u, 1u, 2u);
+
+    CHECK_EQUAL(2u, lods.GetWidth(1u));
+    CHECK_EQUAL(1u, lods.GetDepth(1u));
+    CHECK_EQUAL(1u, lods.GetWidth(2u));
+    CHECK_EQUAL(GRASSLAND, lods.GetColumns(1u)[0].BlockType);
+    CHECK_EQUAL(1u, lods.GetColumns(1u)[0].Height);
+    CHECK_EQUAL(SNOW, lods.GetColumns(1u)[1].BlockType);
+    CHECK_EQUAL(3u, lods.GetColumns(1u)[1].Height);
+    CHECK_EQUAL(1u, lods.GetColumns(2u)[0].Height);
+}
+
+TEST(VoxelLodsUpdateMatchesBuild)
+{
+    constexpr const UINT MAP_WIDTH = 45u;
+    constexpr const UINT MAP_DEPTH = 37u;
+
+    std::mt19937 random(11u);
+    std::uniform_int_distribution<INT> blockType(static_cast<INT>(GRASSLAND), static_cast<INT>(OCEAN));
+    std::uniform_int_distribution<INT> height(0, 40);
+    std::uniform_int_distribution<UINT> position(0u, 30u);
+    std::uniform_int_distribution<UINT> size(1u, 6u);
+
+    std::vector<VoxelColumn> aColumns(MAP_WIDTH * MAP_DEPTH);
+    for (VoxelColumn& mapColumn : aColumns)
+    {
+        mapColumn = column(static_cast<CHAR>(blockType(random)), static_cast<WORD>(height(random)));
+    }
+
+    VoxelLods lods(4u);
+    lods.Build(aColumns.data(), MAP_WIDTH, MAP_DEPTH, 2u);
+
+    for (UINT uEdit = 0u; uEdit < 50u; ++uEdit)
+    {
+        const UINT uX = position(random);
+        const UINT uZ = position(random);
+        const UINT uWidth = size(random);
+        const UINT uDepth = size(random);
+        for (UINT z = uZ; z < uZ + uDepth; ++z)
+        {
+            for (UINT x = uX; x < uX + uWidth; ++x)
+            {
+                aColumns[z * MAP_WIDTH + x] = column(static_cast<CHAR>(blockType(random)), static_cast<WORD>(height(random)));
+            }
+        }
+        lods.Update(aColumns.data(), uX, uZ, uWidth, uDepth);
+    }
+
+    VoxelLods reference(4u);
+    reference.Build(aColumns.data(), MAP_WIDTH, MAP_DEPTH, 2u);
+    for (UINT uLod = 1u; uLod < 4u; ++uLod)
+    {
+        CHECK(isEqual(reference.GetColumns(uLod), lods.GetColumns(uLod)));
+    }
+}
@@ -0,0 +1,69 @@
+#include "Test.h"
+
+#include <fstream>
+#include <random>
+
+#include "Scene/VoxelMap.h"
+
+using namespace library;
+
+BENCHMARK(VoxelMapLoad1024x1024)
+{
+    constexpr const UINT MAP_SIZE = 1024u;
+    constexpr const UINT MAP_HEIGHT = 64u;
+
+    const std::filesystem::path textPath = test::GetTemporaryPath("Benchmark.txt");
+    const std::filesystem::path binaryPath = test::GetTemporaryPath("Benchmark.vxm");
+
+    {
+        std::mt19937 random(1u);
+        std::uniform_int_distribution<INT> blockType(static_cast<INT>(eBlockType::GRASSLAND), static_cast<INT>(eBlockType::COUNT) - 1);
+        std::uniform_int_distribution<INT> height(0, 1000);
+
+        std::ofstream textFile(textPath, std::ios::binary | std::ios::trunc);
+        textFile << MAP_SIZE << ' ' << MAP_HEIGHT << ' ' << MAP_SIZE << " 1\n0.5 0.5 0.5\n";
+        for (UINT uColumnIdx = 0u; uColumnIdx < MAP_SIZE * MAP_SIZE; ++uColumnIdx)
+        {
+            textFile << static_cast<CHAR>(blockType(random)) << static_cast<FLOAT>(height(random)) / 1000.0f << ' ';
+        }
+    }
+    CHECK(SUCCEEDED(VoxelMapFile::ConvertFromText(textPath, binaryPath)));
+
+    UINT64 uTextCubes = 0u;
+    const double textMilliseconds = test::MeasureMilliseconds(3u, [&]()
+    {
+        VoxelMapHeader header;
+        std::vector<XMFLOAT3> aPalette;
+        std::vector<VoxelColumn> aColumns;
+        CHECK(SUCCEEDED(VoxelMapFile::ReadText(textPath, header, aPalette, aColumns)));
+
+        uTextCubes = 0u;
+        for (const VoxelColumn& column : aColumns)
+        {
+            uTextCubes += column.Height;
+        }
+    });
+
+    UINT64 uBinaryCubes = 0u;
+    const double binaryMilliseconds = test::MeasureMilliseconds(3u, [&]()
+    {
+        VoxelMapFile map;
+        CHECK(SUCCEEDED(map.Open(binaryPath)));
+
+        uBinaryCubes = 0u;
+        const VoxelColumn* pColumns = map.GetColumns();
+        for (size_t uColumnIdx = 0u; uColumnIdx < map.GetNumColumns(); ++uColumnIdx)
+        {
+            uBinaryCubes += pColumns[uColumnIdx].Height;
+        }
+    });
+
+    CHECK_EQUAL(uTextCubes, uBinaryCubes);
+
+    std::printf("  text   %9.2f ms  %9llu bytes\n", textMilliseconds, static_cast<unsigned long long>(std::filesystem::file_size(textPath)));
+    std::printf("  binary %9.2f ms  %9llu bytes\n", binaryMilliseconds, static_cast<unsigned long long>(std::filesystem::file_size(binaryPath)));
+    std::printf("  %llu cubes, %.1fx faster\n", static_cast<unsigned long long>(uBinaryCubes), textMilliseconds / binaryMilliseconds);
+
+    std::filesystem::remove(textPath);
+    std::filesystem::remove(binaryPath);
+}
@@ -0,0 +1,136 @@
+#include "Test.h"
+
+#include <fstream>
+
+#include "Scene/VoxelMap.h"
+
+using namespace library;
+
+namespace
+{
+    constexpr const CHAR GRASSLAND = static_cast<CHAR>(eBlockType::GRASSLAND);
+    constexpr const CHAR SNOW = static_cast<CHAR>(eBlockType::SNOW);
+
+    void writeText(_In_ const std::filesystem::path& filePath, _In_ const std::string& text)
+    {
+        std::ofstream outputFile(filePath, std::ios::binary | std::ios::trunc);
+        outputFile << text;
+    }
+
+    std::string record(_In_ CHAR blockType, _In_ const char* pszHeight)
+    {
+        return std::string(1u, blockType) + pszHeight + ' ';
+    }
+}
+
+TEST(VoxelMapConvertsTextMap)
+{
+    const std::filesystem::path textPath = test::GetTemporaryPath("Convert.txt");
+    const std::filesystem::path binaryPath = test::GetTemporaryPath("Convert.vxm");
+
+    writeText(textPath,
+        "3 10 2 2\n0.5 0.25 1\n1 1 1\n" +
+        record(GRASSLAND, "0.1") + record(SNOW, "1") + record(GRASSLAND, "0") +
+        "garbage " +
+        record(SNOW, "0.55") + record(GRASSLAND, "0.3") + record(SNOW, "0.9"));
+
+    CHECK(SUCCEEDED(VoxelMapFile::ConvertFromText(textPath, binaryPath)));
+
+    VoxelMapFile map;
+    CHECK(SUCCEEDED(map.Open(binaryPath)));
+    CHECK_EQUAL(3u, map.GetHeader().Width);
+    CHECK_EQUAL(10u, map.GetHeader().Height);
+    CHECK_EQUAL(2u, map.GetHeader().Depth);
+    CHECK_EQUAL(2u, map.GetHeader().NumColors);
+    CHECK_EQUAL(0.25f, map.GetPalette()[0].y);
+    CHECK_EQUAL(6u, map.GetNumColumns());
+
+    const WORD aExpectedHeights[] = { 1u, 10u, 0u, 5u, 3u, 9u };
+    const CHAR aExpectedTypes[] = { GRASSLAND, SNOW, GRASSLAND, SNOW, GRASSLAND, SNOW };
+    for (size_t i = 0u; i < ARRAYSIZE(aExpectedHeights); ++i)
+    {
+        CHECK_EQUAL(aExpectedHeights[i], map.GetColumns()[i].Height);
+        CHECK_EQUAL(aExpectedTypes[i], map.GetColumns()[i].BlockType);
+    }
+
+    map.Close();
+    std::filesystem::remove(textPath);
+    std::filesystem::remove(binaryPath);
+}
+
+TEST(VoxelMapLeavesMissingColumnsEmpty)
+{
+    const std::filesystem::path textPath = test::GetTemporaryPath("Missing.txt");
+
+    writeText(textPath, "2 4 2 0\n" + record(GRASSLAND, "1"));
+
+    VoxelMapHeader header;
+    std::vector<XMFLOAT3> aPalette;
+    std::vector<VoxelColumn> aColumns;
+    CHECK(SUCCEEDED(VoxelMapFile::ReadText(textPath, header, aPalette, aColumns)));
+    CHECK_EQUAL(4u, aColumns.size());
+    CHECK_EQUAL(4u, aColumns[0].Height);
+    CHECK_EQUAL(0u, aColumns[1].Height);
+    CHECK_EQUAL(0u, aColumns[3].Height);
+
+    std::filesystem::remove(textPath);
+}
+
+TEST(VoxelMapRejectsExtraRecords)
+{
+    const std::filesystem::path textPath = test::GetTemporaryPath("Extra.txt");
+    const std::filesystem::path binaryPath = test::GetTemporaryPath("Extra.vxm");
+    std::filesystem::remove(binaryPath);
+
+    writeText(textPath, "2 4 1 0\n" + record(GRASSLAND, "1") + record(GRASSLAND, "0.5") + record(SNOW, "0.25"));
+
+    CHECK_EQUAL(E_INVALIDARG, VoxelMapFile::ConvertFromText(textPath, binaryPath));
+    CHECK(!std::filesystem::exists(binaryPath));
+
+    std::filesystem::remove(textPath);
+}
+
+TEST(VoxelMapRejectsHeightsOutOfRange)
+{
+    const std::filesystem::path textPath = test::GetTemporaryPath("Range.txt");
+
+    VoxelMapHeader header;
+    std::vector<XMFLOAT3> aPalette;
+    std::vector<VoxelColumn> aColumns;
+
+    writeText(textPath, "1 65535 1 0\n" + record(GRASSLAND, "1"));
+    CHECK(SUCCEEDED(VoxelMapFile::ReadText(textPath, header, aPalette, aColumns)));
+    CHECK_EQUAL(65535u, aColumns[0].Height);
+
+    writeText(textPath, "1 65536 1 0\n" + record(GRASSLAND, "1"));
+    CHECK_EQUAL(E_INVALIDARG, VoxelMapFile::ReadText(textPath, header, aPalette, aColumns));
+    CHECK(aColumns.empty());
+
+    writeText(textPath, "1 16 1 0\n" + record(GRASSLAND, "-0.5"));
+    CHECK_EQUAL(E_INVALIDARG, VoxelMapFile::ReadText(textPath, header, aPalette, aColumns));
+
+    std::filesystem::remove(textPath);
+}
+
+TEST(VoxelMapRejectsCorruptFiles)
+{
+    const std::filesystem::path binaryPath = test::GetTemporaryPath("Corrupt.vxm");
+    VoxelMapFile map;
+
+    CHECK(FAILED(map.Open(test::GetTemporaryPath("DoesNotExist.vxm"))));
+
+    const std::vector<VoxelColumn> aColumns(4u, VoxelColumn{ .BlockType = GRASSLAND, .Reserved = 0u, .Height = 1u });
+    CHECK(SUCCEEDED(VoxelMapFile::Write(binaryPath, 2u, 1u, 2u, {}, aColumns)));
+    CHECK(SUCCEEDED(map.Open(binaryPath)));
+    map.Close();
+
+    CHECK_EQUAL(E_INVALIDARG, VoxelMapFile::Write(binaryPath, 3u, 1u, 2u, {}, aColumns));
+
+    std::filesystem::resize_file(binaryPath, sizeof(VoxelMapHeader) + 3u * sizeof(VoxelColumn));
+    CHECK(FAILED(map.Open(binaryPath)));
+
+    writeText(binaryPath, std::string(64u, 'x'));
+    CHECK(FAILED(map.Open(binaryPath)));
+
+    std::filesystem::remove(binaryPath);
+}
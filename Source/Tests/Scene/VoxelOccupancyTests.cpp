@@ -0,0 +1,140 @@
+#include "Test.h"
+
+#include <random>
+
+#include "Scene/VoxelOccupancy.h"
+
+using namespace library;
+
+namespace
+{
+    constexpr const UINT SIZE = VoxelOccupancy::SIZE;
+
+    // Neighbor of a cell across each face, -x, +x, -y, +y, -z, +z
+    constexpr const INT FACE_OFFSETS[VoxelOccupancy::NUM_FACES][3] = { { -1, 0, 0 }, { 1, 0, 0 }, { 0, -1, 0 }, { 0, 1, 0 }, { 0, 0, -1 }, { 0, 0, 1 } };
+
+    // A cell the way the chunk documents it: solid below y = 0, empty anywhere else outside
+    BOOL isSolid(_In_ const VoxelOccupancy& chunk, _In_ INT x, _In_ INT y, _In_ INT z)
+    {
+        if (y < 0)
+        {
+            return TRUE;
+        }
+        if (x < 0 || z < 0 || x >= static_cast<INT>(SIZE) || z >= static_cast<INT>(SIZE) || y >= static_cast<INT>(chunk.GetHeight()))
+        {
+            return FALSE;
+        }
+
+        return chunk.IsSolid(static_cast<UINT>(x), static_cast<UINT>(y), static_cast<UINT>(z));
+    }
+
+    // The row of a face asking each cell of the row about its neighbor
+    UINT getFaceRow(_In_ const VoxelOccupancy& chunk, _In_ UINT uFace, _In_ UINT y, _In_ UINT z)
+    {
+        UINT uRow = 0u;
+        for (UINT x = 0u; x < SIZE; ++x)
+        {
+            const INT* pOffset = FACE_OFFSETS[uFace];
+            if (chunk.IsSolid(x, y, z) && !isSolid(chunk, static_cast<INT>(x) + pOffset[0], static_cast<INT>(y) + pOffset[1], static_cast<INT>(z) + pOffset[2]))
+            {
+                uRow |= 1u << x;
+            }
+        }
+
+        return uRow;
+    }
+}
+
+TEST(VoxelOccupancyFindsFacesAtWordBoundaries)
+{
+    VoxelOccupancy chunk;
+    chunk.Resize(4u);
+    CHECK_EQUAL(4u, chunk.GetHeight());
+    CHECK_EQUAL(0u, chunk.GetNumSolid());
+
+    // Cells 0, 1, 30 and 31 of a row on the -z edge, with nothing around it
+    chunk.SetRow(1u, 0u, 0xC0000003u);
+    CHECK(chunk.IsSolid(0u, 1u, 0u) && chunk.IsSolid(31u, 1u, 0u) && !chunk.IsSolid(2u, 1u, 0u) && !chunk.IsSolid(29u, 1u, 0u));
+    CHECK_EQUAL(0x40000001u, chunk.GetFaceRow(0u, 1u, 0u));
+    CHECK_EQUAL(0x80000002u, chunk.GetFaceRow(1u, 1u, 0u));
+    for (UINT uFace = 2u; uFace < VoxelOccupancy::NUM_FACES; ++uFace)
+    {
+        CHECK_EQUAL(0xC0000003u, chunk.GetFaceRow(uFace, 1u, 0u));
+    }
+    CHECK_EQUAL(0xC0000003u, chunk.GetExposedRow(1u, 0u));
+
+    // A full row only shows its ends along x, and the ground hides its bottom
+    chunk.SetRow(0u, 5u, ~0u);
+    CHECK_EQUAL(1u, chunk.GetFaceRow(0u, 0u, 5u));
+    CHECK_EQUAL(0x80000000u, chunk.GetFaceRow(1u, 0u, 5u));
+    CHECK_EQUAL(0u, chunk.GetFaceRow(2u, 0u, 5u));
+    CHECK_EQUAL(~0u, chunk.GetFaceRow(3u, 0u, 5u));
+
+    // Buried on every side but +x at the +z edge of the top of the chunk, which is open
+    chunk.Clear();
+    for (UINT y = 0u; y < 4u; ++y)
+    {
+        for (UINT z = 29u; z < SIZE; ++z)
+        {
+            chunk.SetRow(y, z, 0x7FFFFFFFu);
+        }
+    }
+    CHECK_EQUAL(4u * 3u * 31u, chunk.GetNumSolid());
+    CHECK_EQUAL(0u, chunk.GetFaceRow(4u, 1u, 30u));
+    CHECK_EQUAL(0x7FFFFFFFu, chunk.GetFaceRow(4u, 1u, 29u));
+    CHECK_EQUAL(0x7FFFFFFFu, chunk.GetFaceRow(5u, 1u, 31u));
+    CHECK_EQUAL(0x7FFFFFFFu, chunk.GetFaceRow(3u, 3u, 30u));
+    CHECK_EQUAL(0x40000001u, chunk.GetExposedRow(1u, 30u));
+    CHECK_EQUAL(0x40000001u, chunk.GetExposedRow(0u, 30u));
+    CHECK_EQUAL(0x7FFFFFFFu, chunk.GetExposedRow(3u, 30u));
+
+    // Emptied cell by cell
+    chunk.SetSolid(30u, 1u, 30u, FALSE);
+    CHECK_EQUAL(0x3FFFFFFFu, chunk.GetRow(1u, 30u));
+    CHECK_EQUAL(0x20000001u, chunk.GetExposedRow(1u, 30u));
+    CHECK(chunk.GetFaceRow(3u, 0u, 30u) == 0x40000000u);
+}
+
+TEST(VoxelOccupancyMatchesNeighborTests)
+{
+    // Random chunks from sparse to dense against each face of each cell
+    std::mt19937 random(15u);
+    for (UINT uDensity : { 10u, 50u, 90u, 99u })
+    {
+        VoxelOccupancy chunk;
+        chunk.Resize(7u);
+        for (UINT y = 0u; y < chunk.GetHeight(); ++y)
+        {
+            for (UINT z = 0u; z < SIZE; ++z)
+            {
+                for (UINT x = 0u; x < SIZE; ++x)
+                {
+                    chunk.SetSolid(x, y, z, random() % 100u < uDensity);
+                }
+            }
+        }
+
+        UINT uNumMismatches = 0u;
+        UINT uNumSolid = 0u;
+        UINT uNumExposed = 0u;
+        for (UINT y = 0u; y < chunk.GetHeight(); ++y)
+        {
+            for (UINT z = 0u; z < SIZE; ++z)
+            {
+                UINT uExposed = 0u;
+                for (UINT uFace = 0u; uFace < VoxelOccupancy::NUM_FACES; ++uFace)
+                {
+                    const UINT uExpected = getFaceRow(chunk, uFace, y, z);
+                    uNumMismatches += uExpected != chunk.GetFaceRow(uFace, y, z) ? 1u : 0u;
+                    uExposed |= uExpected;
+                }
+                uNumMismatches += uExposed != chunk.GetExposedRow(y, z) ? 1u : 0u;
+                uNumSolid += static_cast<UINT>(std::popcount(chunk.GetRow(y, z)));
+                uNumExposed += static_cast<UINT>(std::popcount(uExposed));
+            }
+        }
+        CHECK_EQUAL(0u, uNumMismatches);
+        CHECK_EQUAL(uNumSolid, chunk.GetNumSolid());
+        CHECK_EQUAL(uNumExposed, chunk.GetNumExposed());
+    }
+}
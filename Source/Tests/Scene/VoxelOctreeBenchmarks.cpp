@@ -0,0 +1,202 @@
+#include "Test.h"
+
+#include <cmath>
+#include <random>
+
+#include "Scene/VoxelOctree.h"
+
+using namespace library;
+
+namespace
+{
+    constexpr const CHAR GRASSLAND = static_cast<CHAR>(eBlockType::GRASSLAND);
+    constexpr const size_t NUM_BLOCK_TYPES = static_cast<size_t>(eBlockType::COUNT) - static_cast<size_t>(eBlockType::GRASSLAND);
+    constexpr const UINT MAP_SIZE = 1024u;
+
+    CHAR getBlockType(_In_ const std::vector<VoxelColumn>& aColumns, _In_ INT x, _In_ INT y, _In_ INT z)
+    {
+        if (x < 0 || y < 0 || z < 0 || x >= static_cast<INT>(MAP_SIZE) || z >= static_cast<INT>(MAP_SIZE))
+        {
+            return 0;
+        }
+
+        const VoxelColumn& column = aColumns[static_cast<size_t>(z) * MAP_SIZE + static_cast<size_t>(x)];
+        return y < static_cast<INT>(column.Height) ? column.BlockType : 0;
+    }
+
+    // Walks the ray cell by cell through the columns of the map
+    BOOL rayCastGrid(_In_ const std::vector<VoxelColumn>& aColumns, _In_ const XMFLOAT3& origin, _In_ const XMFLOAT3& direction, _In_ FLOAT maxDistance, _Out_ FLOAT& distance)
+    {
+        const FLOAT aOrigin[3] = { origin.x, origin.y, origin.z };
+        const FLOAT aDirection[3] = { direction.x, direction.y, direction.z };
+        INT aCell[3];
+        INT aStep[3];
+        FLOAT aNext[3];
+        FLOAT aDelta[3];
+        for (UINT uAxis = 0u; uAxis < 3u; ++uAxis)
+        {
+            aCell[uAxis] = static_cast<INT>(std::floor(aOrigin[uAxis]));
+            aStep[uAxis] = aDirection[uAxis] > 0.0f ? 1 : -1;
+            aDelta[uAxis] = aDirection[uAxis] != 0.0f ? std::abs(1.0f / aDirection[uAxis]) : INFINITY;
+            const FLOAT boundary = static_cast<FLOAT>(aCell[uAxis] + (aDirection[uAxis] > 0.0f ? 1 : 0));
+            aNext[uAxis] = aDirection[uAxis] != 0.0f ? (boundary - aOrigin[uAxis]) / aDirection[uAxis] : INFINITY;
+        }
+
+        distance = 0.0f;
+        while (distance <= maxDistance)
+        {
+            if (getBlockType(aColumns, aCell[0], aCell[1], aCell[2]) != 0)
+            {
+                return TRUE;
+            }
+
+            const UINT uAxis = aNext[0] < aNext[1] ? (aNext[0] < aNext[2] ? 0u : 2u) : (aNext[1] < aNext[2] ? 1u : 2u);
+            distance = aNext[uAxis];
+            aNext[uAxis] += aDelta[uAxis];
+            aCell[uAxis] += aStep[uAxis];
+        }
+
+        return FALSE;
+    }
+
+    // Scans the columns under a box of cells
+    BOOL overlapsGrid(_In_ const std::vector<VoxelColumn>& aColumns, _In_ const XMINT3& minCell, _In_ const XMINT3& maxCell)
+    {
+        for (INT z = std::max(minCell.z, 0); z < std::min(maxCell.z, static_cast<INT>(MAP_SIZE)); ++z)
+        {
+            for (INT x = std::max(minCell.x, 0); x < std::min(maxCell.x, static_cast<INT>(MAP_SIZE)); ++x)
+            {
+                const VoxelColumn& column = aColumns[static_cast<size_t>(z) * MAP_SIZE + static_cast<size_t>(x)];
+                if (static_cast<INT>(column.Height) > std::max(minCell.y, 0) && minCell.y < maxCell.y)
+                {
+                    return TRUE;
+                }
+            }
+        }
+
+        return FALSE;
+    }
+}
+
+BENCHMARK(VoxelOctreeQueries1024x1024)
+{
+    constexpr const UINT NUM_RAYS = 100000u;
+    constexpr const UINT NUM_BOXES = 100000u;
+    constexpr const FLOAT MAX_DISTANCE = 256.0f;
+
+    // Rolling hills with a block type per band of height, like a generated map
+    std::vector<VoxelColumn> aColumns(static_cast<size_t>(MAP_SIZE) * MAP_SIZE);
+    for (UINT z = 0u; z < MAP_SIZE; ++z)
+    {
+        for (UINT x = 0u; x < MAP_SIZE; ++x)
+        {
+            const FLOAT height = 48.0f + 24.0f * std::sin(static_cast<FLOAT>(x) * 0.013f) * std::cos(static_cast<FLOAT>(z) * 0.017f) + 6.0f * std::sin(static_cast<FLOAT>(x + 2u * z) * 0.11f);
+            const UINT uHeight = static_cast<UINT>(std::max(height, 1.0f));
+            aColumns[static_cast<size_t>(z) * MAP_SIZE + x] = VoxelColumn
+            {
+                .BlockType = static_cast<CHAR>(static_cast<UINT>(GRASSLAND) + std::min(uHeight / 16u, static_cast<UINT>(NUM_BLOCK_TYPES) - 1u)),
+                .Reserved = 0u,
+                .Height = static_cast<WORD>(uHeight)
+            };
+        }
+    }
+
+    VoxelOctree octree;
+    const double buildMilliseconds = test::MeasureMilliseconds(1u, [&]()
+    {
+        octree.Build(aColumns.data(), MAP_SIZE, MAP_SIZE, NUM_BLOCK_TYPES);
+    });
+
+    std::mt19937 random(1u);
+    std::uniform_real_distribution<FLOAT> position(0.0f, static_cast<FLOAT>(MAP_SIZE));
+    std::uniform_real_distribution<FLOAT> height(60.0f, 120.0f);
+    std::normal_distribution<FLOAT> direction(0.0f, 1.0f);
+    std::uniform_int_distribution<INT> cell(0, static_cast<INT>(MAP_SIZE) - 1);
+    std::uniform_int_distribution<INT> size(1, 16);
+
+    // Rays from above the hills looking down, like picking from a camera, and rays over the hills that mostly miss
+    std::vector<XMFLOAT3> aOrigins(NUM_RAYS);
+    std::vector<XMFLOAT3> aDirections(NUM_RAYS);
+    for (UINT uRay = 0u; uRay < NUM_RAYS; ++uRay)
+    {
+        const BOOL bLong = uRay >= NUM_RAYS / 2u;
+        aOrigins[uRay] = XMFLOAT3(position(random), height(random) + (bLong ? 20.0f : 0.0f), position(random));
+        aDirections[uRay] = XMFLOAT3(direction(random), bLong ? direction(random) * 0.02f : -0.3f - std::abs(direction(random)) * 0.3f, direction(random));
+        const FLOAT length = std::sqrt(aDirections[uRay].x * aDirections[uRay].x + aDirections[uRay].y * aDirections[uRay].y + aDirections[uRay].z * aDirections[uRay].z);
+        aDirections[uRay] = XMFLOAT3(aDirections[uRay].x / length, aDirections[uRay].y / length, aDirections[uRay].z / length);
+    }
+
+    std::vector<XMINT3> aMinCells(NUM_BOXES);
+    std::vector<XMINT3> aMaxCells(NUM_BOXES);
+    for (UINT uBox = 0u; uBox < NUM_BOXES; ++uBox)
+    {
+        const INT x = cell(random);
+        const INT z = cell(random);
+        const INT y = cell(random) / 8;
+        const INT iSize = size(random);
+        aMinCells[uBox] = XMINT3(x, y, z);
+        aMaxCells[uBox] = XMINT3(x + iSize, y + iSize, z + iSize);
+    }
+
+    std::vector<FLOAT> aOctreeDistances(NUM_RAYS);
+    std::vector<FLOAT> aGridDistances(NUM_RAYS);
+    double aOctreeRayMilliseconds[2];
+    double aGridRayMilliseconds[2];
+    for (UINT uHalf = 0u; uHalf < 2u; ++uHalf)
+    {
+        const UINT uBegin = uHalf * NUM_RAYS / 2u;
+        const UINT uEnd = uBegin + NUM_RAYS / 2u;
+        aOctreeRayMilliseconds[uHalf] = test::MeasureMilliseconds(3u, [&]()
+        {
+            for (UINT uRay = uBegin; uRay < uEnd; ++uRay)
+            {
+                VoxelRayHit hit;
+                aOctreeDistances[uRay] = octree.RayCast(aOrigins[uRay], aDirections[uRay], MAX_DISTANCE, hit) ? hit.Distance : -1.0f;
+            }
+        });
+
+        aGridRayMilliseconds[uHalf] = test::MeasureMilliseconds(3u, [&]()
+        {
+            for (UINT uRay = uBegin; uRay < uEnd; ++uRay)
+            {
+                FLOAT distance;
+                aGridDistances[uRay] = rayCastGrid(aColumns, aOrigins[uRay], aDirections[uRay], MAX_DISTANCE, distance) ? distance : -1.0f;
+            }
+        });
+    }
+
+    UINT uNumHits = 0u;
+    UINT uNumMismatches = 0u;
+    for (UINT uRay = 0u; uRay < NUM_RAYS; ++uRay)
+    {
+        uNumHits += aOctreeDistances[uRay] >= 0.0f ? 1u : 0u;
+        uNumMismatches += std::abs(aOctreeDistances[uRay] - aGridDistances[uRay]) > 1e-2f ? 1u : 0u;
+    }
+    CHECK_EQUAL(0u, uNumMismatches);
+
+    UINT uNumOctreeOverlaps = 0u;
+    const double octreeBoxMilliseconds = test::MeasureMilliseconds(3u, [&]()
+    {
+        uNumOctreeOverlaps = 0u;
+        for (UINT uBox = 0u; uBox < NUM_BOXES; ++uBox)
+        {
+            uNumOctreeOverlaps += octree.Overlaps(aMinCells[uBox], aMaxCells[uBox]) ? 1u : 0u;
+        }
+    });
+
+    UINT uNumGridOverlaps = 0u;
+    const double gridBoxMilliseconds = test::MeasureMilliseconds(3u, [&]()
+    {
+        uNumGridOverlaps = 0u;
+        for (UINT uBox = 0u; uBox < NUM_BOXES; ++uBox)
+        {
+            uNumGridOverlaps += overlapsGrid(aColumns, aMinCells[uBox], aMaxCells[uBox]) ? 1u : 0u;
+        }
+    });
+    CHECK_EQUAL(uNumGridOverlaps, uNumOctreeOverlaps);
+
+    std::printf("  build      %9.2f ms  %zu nodes\n", buildMilliseconds, octree.GetNodes().size());
+    std::printf("  short rays %9.2f ms octree  %9.2f ms grid\n", aOctreeRayMilliseconds[0], aGridRayMilliseconds[0]);
+    std::printf("  long rays  %9.2f ms octree  %9.2f ms grid  %u of %u rays hit\n", aOctreeRayMilliseconds[1], aGridRayMilliseconds[1], uNumHits, NUM_RAYS);
+    std::printf("  boxes      %9.2f ms octree  %9.2f ms grid  %u of %u overlap\n", octreeBoxMilliseconds, gridBoxMilliseconds, uNumOctreeOverlaps, NUM_BOXES);
+}
@@ -0,0 +1,288 @@
+#include "Test.h"
+
+#include <cmath>
+#include <random>
+
+#include "Scene/VoxelOctree.h"
+
+using namespace library;
+
+namespace
+{
+    constexpr const CHAR GRASSLAND = static_cast<CHAR>(eBlockType::GRASSLAND);
+    constexpr const size_t NUM_BLOCK_TYPES = 2u;
+
+    // Columns of a map answered one cell at a time
+    struct ReferenceMap
+    {
+        std::vector<VoxelColumn> aColumns;
+        UINT uWidth;
+        UINT uDepth;
+        UINT uHeight;
+
+        CHAR GetBlockType(_In_ INT x, _In_ INT y, _In_ INT z) const
+        {
+            if (x < 0 || y < 0 || z < 0 || x >= static_cast<INT>(uWidth) || z >= static_cast<INT>(uDepth))
+            {
+                return 0;
+            }
+
+            const VoxelColumn& column = aColumns[static_cast<size_t>(z) * uWidth + static_cast<size_t>(x)];
+            const size_t uTypeIdx = static_cast<size_t>(column.BlockType) - static_cast<size_t>(GRASSLAND);
+            return uTypeIdx < NUM_BLOCK_TYPES && y < static_cast<INT>(column.Height) ? column.BlockType : 0;
+        }
+    };
+
+    // The third block type has no voxel and counts as air
+    ReferenceMap createMap(_In_ UINT uSeed, _In_ UINT uWidth, _In_ UINT uDepth, _In_ INT iMaxHeight)
+    {
+        std::mt19937 random(uSeed);
+        std::uniform_int_distribution<INT> blockType(static_cast<INT>(GRASSLAND), static_cast<INT>(GRASSLAND) + 2);
+        std::uniform_int_distribution<INT> height(0, iMaxHeight);
+
+        ReferenceMap map = { .aColumns = std::vector<VoxelColumn>(static_cast<size_t>(uWidth) * uDepth), .uWidth = uWidth, .uDepth = uDepth, .uHeight = static_cast<UINT>(iMaxHeight) };
+        for (VoxelColumn& column : map.aColumns)
+        {
+            column = VoxelColumn{ .BlockType = static_cast<CHAR>(blockType(random)), .Reserved = 0u, .Height = static_cast<WORD>(height(random)) };
+        }
+
+        // Plateaus of a single block type merge into large leaves
+        for (UINT z = 0u; z < uDepth / 2u; ++z)
+        {
+            for (UINT x = 0u; x < uWidth / 2u; ++x)
+            {
+                map.aColumns[static_cast<size_t>(z) * uWidth + x] = VoxelColumn{ .BlockType = GRASSLAND, .Reserved = 0u, .Height = static_cast<WORD>(iMaxHeight / 2) };
+            }
+        }
+
+        return map;
+    }
+
+    // Entry and exit distances of a ray through the cube of cells [aMin, aMin + uSize)
+    BOOL intersectCube(_In_ const FLOAT aOrigin[3], _In_ const FLOAT aDirection[3], _In_ const INT aMin[3], _In_ INT iSize, _Out_ FLOAT& tEnter, _Out_ FLOAT& tExit)
+    {
+        tEnter = -INFINITY;
+        tExit = INFINITY;
+        for (UINT uAxis = 0u; uAxis < 3u; ++uAxis)
+        {
+            const FLOAT lower = static_cast<FLOAT>(aMin[uAxis]);
+            const FLOAT upper = static_cast<FLOAT>(aMin[uAxis] + iSize);
+            if (aDirection[uAxis] == 0.0f)
+            {
+                if (aOrigin[uAxis] < lower || aOrigin[uAxis] > upper)
+                {
+                    return FALSE;
+                }
+                continue;
+            }
+
+            const FLOAT t0 = (lower - aOrigin[uAxis]) / aDirection[uAxis];
+            const FLOAT t1 = (upper - aOrigin[uAxis]) / aDirection[uAxis];
+            tEnter = std::max(tEnter, std::min(t0, t1));
+            tExit = std::min(tExit, std::max(t0, t1));
+        }
+
+        return tEnter <= tExit;
+    }
+
+    // Closest distance along the ray to any cube of the map
+    BOOL rayCastReference(_In_ const ReferenceMap& map, _In_ const XMFLOAT3& origin, _In_ const XMFLOAT3& direction, _In_ FLOAT maxDistance, _Out_ FLOAT& distance)
+    {
+        const FLOAT aOrigin[3] = { origin.x, origin.y, origin.z };
+        const FLOAT aDirection[3] = { direction.x, direction.y, direction.z };
+
+        BOOL bHit = FALSE;
+        distance = INFINITY;
+        for (INT z = 0; z < static_cast<INT>(map.uDepth); ++z)
+        {
+            for (INT x = 0; x < static_cast<INT>(map.uWidth); ++x)
+            {
+                for (INT y = 0; y < static_cast<INT>(map.uHeight); ++y)
+                {
+                    const INT aMin[3] = { x, y, z };
+                    FLOAT tEnter;
+                    FLOAT tExit;
+                    if (map.GetBlockType(x, y, z) != 0 && intersectCube(aOrigin, aDirection, aMin, 1, tEnter, tExit) && tExit >= 0.0f && tEnter <= maxDistance)
+                    {
+                        bHit = TRUE;
+                        distance = std::min(distance, std::max(tEnter, 0.0f));
+                    }
+                }
+            }
+        }
+
+        return bHit;
+    }
+
+    UINT countReferenceCubes(_In_ const ReferenceMap& map, _In_ const XMINT3& minCell, _In_ const XMINT3& maxCell)
+    {
+        UINT uNumCubes = 0u;
+        for (INT z = minCell.z; z < maxCell.z; ++z)
+        {
+            for (INT y = minCell.y; y < maxCell.y; ++y)
+            {
+                for (INT x = minCell.x; x < maxCell.x; ++x)
+                {
+                    uNumCubes += map.GetBlockType(x, y, z) != 0 ? 1u : 0u;
+                }
+            }
+        }
+
+        return uNumCubes;
+    }
+
+    INT getOverlap(_In_ INT iMin, _In_ INT iMax, _In_ INT iLeafMin, _In_ INT iLeafSize)
+    {
+        return std::max(std::min(iMax, iLeafMin + iLeafSize) - std::max(iMin, iLeafMin), 0);
+    }
+}
+
+TEST(VoxelOctreeMatchesReferencePoints)
+{
+    for (UINT uSeed = 0u; uSeed < 4u; ++uSeed)
+    {
+        const ReferenceMap map = createMap(uSeed, 23u + uSeed, 17u, 20);
+
+        VoxelOctree octree;
+        octree.Build(map.aColumns.data(), map.uWidth, map.uDepth, NUM_BLOCK_TYPES);
+        CHECK_EQUAL(32u, octree.GetSize());
+
+        for (INT z = -2; z < static_cast<INT>(map.uDepth) + 2; ++z)
+        {
+            for (INT y = -2; y < static_cast<INT>(map.uHeight) + 2; ++y)
+            {
+                for (INT x = -2; x < static_cast<INT>(map.uWidth) + 2; ++x)
+                {
+                    CHECK_EQUAL(map.GetBlockType(x, y, z), octree.GetBlockType(x, y, z));
+                }
+            }
+        }
+    }
+}
+
+TEST(VoxelOctreeMergesSolidOctants)
+{
+    // A 16 x 16 x 16 block of grassland is a single leaf under the root
+    const std::vector<VoxelColumn> aColumns(16u * 16u, VoxelColumn{ .BlockType = GRASSLAND, .Reserved = 0u, .Height = 16u });
+
+    VoxelOctree octree;
+    octree.Build(aColumns.data(), 16u, 16u, NUM_BLOCK_TYPES);
+
+    CHECK_EQUAL(1u, octree.GetNodes().size());
+    CHECK_EQUAL(0u, octree.GetNodes()[0].ChildMask);
+    CHECK_EQUAL(GRASSLAND, octree.GetBlockType(15, 15, 15));
+
+    // An empty map has no node
+    const std::vector<VoxelColumn> aEmptyColumns(4u, VoxelColumn{ .BlockType = GRASSLAND, .Reserved = 0u, .Height = 0u });
+    octree.Build(aEmptyColumns.data(), 2u, 2u, NUM_BLOCK_TYPES);
+    CHECK(octree.GetNodes().empty());
+    CHECK_EQUAL(0, octree.GetBlockType(0, 0, 0));
+}
+
+TEST(VoxelOctreeMatchesReferenceBoxes)
+{
+    const ReferenceMap map = createMap(7u, 29u, 21u, 24);
+
+    VoxelOctree octree;
+    octree.Build(map.aColumns.data(), map.uWidth, map.uDepth, NUM_BLOCK_TYPES);
+
+    std::mt19937 random(5u);
+    std::uniform_int_distribution<INT> position(-4, 32);
+    std::uniform_int_distribution<INT> size(0, 9);
+
+    std::vector<VoxelOctreeLeaf> aLeaves;
+    for (UINT uBox = 0u; uBox < 2000u; ++uBox)
+    {
+        const XMINT3 minCell(position(random), position(random), position(random));
+        const XMINT3 maxCell(minCell.x + size(random), minCell.y + size(random), minCell.z + size(random));
+        const UINT uNumCubes = countReferenceCubes(map, minCell, maxCell);
+
+        CHECK_EQUAL(uNumCubes > 0u, octree.Overlaps(minCell, maxCell) != FALSE);
+
+        // The leaves do not overlap, so the cells they share with the box add up to its cubes
+        aLeaves.clear();
+        octree.QueryBox(minCell, maxCell, aLeaves);
+
+        UINT uNumLeafCubes = 0u;
+        for (const VoxelOctreeLeaf& leaf : aLeaves)
+        {
+            const INT iSize = static_cast<INT>(leaf.Size);
+            const INT iOverlap =
+                getOverlap(minCell.x, maxCell.x, static_cast<INT>(leaf.Min.x), iSize) *
+                getOverlap(minCell.y, maxCell.y, static_cast<INT>(leaf.Min.y), iSize) *
+                getOverlap(minCell.z, maxCell.z, static_cast<INT>(leaf.Min.z), iSize);
+            CHECK(iOverlap > 0);
+            CHECK_EQUAL(map.GetBlockType(static_cast<INT>(leaf.Min.x), static_cast<INT>(leaf.Min.y), static_cast<INT>(leaf.Min.z)), leaf.BlockType);
+            CHECK_EQUAL(map.GetBlockType(static_cast<INT>(leaf.Min.x) + iSize - 1, static_cast<INT>(leaf.Min.y) + iSize - 1, static_cast<INT>(leaf.Min.z) + iSize - 1), leaf.BlockType);
+            uNumLeafCubes += static_cast<UINT>(iOverlap);
+        }
+        CHECK_EQUAL(uNumCubes, uNumLeafCubes);
+    }
+}
+
+TEST(VoxelOctreeMatchesReferenceRays)
+{
+    constexpr const FLOAT MAX_DISTANCE = 48.0f;
+    constexpr const FLOAT EPSILON = 1e-3f;
+
+    const ReferenceMap map = createMap(13u, 26u, 19u, 22);
+
+    VoxelOctree octree;
+    octree.Build(map.aColumns.data(), map.uWidth, map.uDepth, NUM_BLOCK_TYPES);
+
+    std::mt19937 random(17u);
+    std::uniform_real_distribution<FLOAT> position(-6.0f, 34.0f);
+    std::normal_distribution<FLOAT> direction(0.0f, 1.0f);
+    std::uniform_int_distribution<INT> axis(0, 5);
+
+    UINT uNumHits = 0u;
+    for (UINT uRay = 0u; uRay < 3000u; ++uRay)
+    {
+        const XMFLOAT3 origin(position(random), position(random), position(random));
+        XMFLOAT3 rayDirection(direction(random), direction(random), direction(random));
+        if (uRay % 4u == 0u)
+        {
+            // Rays along an axis divide by zero on the other two
+            const INT iAxis = axis(random);
+            const FLOAT sign = iAxis < 3 ? 1.0f : -1.0f;
+            rayDirection = XMFLOAT3(iAxis % 3 == 0 ? sign : 0.0f, iAxis % 3 == 1 ? sign : 0.0f, iAxis % 3 == 2 ? sign : 0.0f);
+        }
+
+        FLOAT referenceDistance;
+        const BOOL bReferenceHit = rayCastReference(map, origin, rayDirection, MAX_DISTANCE, referenceDistance);
+
+        VoxelRayHit hit;
+        const BOOL bHit = octree.RayCast(origin, rayDirection, MAX_DISTANCE, hit);
+        CHECK_EQUAL(bReferenceHit, bHit);
+        if (!bHit || !bReferenceHit)
+        {
+            continue;
+        }
+
+        ++uNumHits;
+        CHECK(std::abs(referenceDistance - hit.Distance) < EPSILON);
+        CHECK_EQUAL(map.GetBlockType(hit.Cell.x, hit.Cell.y, hit.Cell.z), hit.BlockType);
+
+        // The cell reported is solid and the ray reaches it at the distance reported
+        const FLOAT aOrigin[3] = { origin.x, origin.y, origin.z };
+        const FLOAT aDirection[3] = { rayDirection.x, rayDirection.y, rayDirection.z };
+        const INT aCell[3] = { hit.Cell.x, hit.Cell.y, hit.Cell.z };
+        FLOAT tEnter;
+        FLOAT tExit;
+        CHECK(intersectCube(aOrigin, aDirection, aCell, 1, tEnter, tExit));
+        CHECK(std::abs(std::max(tEnter, 0.0f) - hit.Distance) < EPSILON);
+
+        // The normal faces against the ray, and is zero when the ray starts inside a cube
+        const INT aNormal[3] = { hit.Normal.x, hit.Normal.y, hit.Normal.z };
+        INT iNormalLength = 0;
+        for (UINT uAxis = 0u; uAxis < 3u; ++uAxis)
+        {
+            iNormalLength += std::abs(aNormal[uAxis]);
+            CHECK(static_cast<FLOAT>(aNormal[uAxis]) * aDirection[uAxis] <= 0.0f);
+        }
+        CHECK_EQUAL(hit.Distance > 0.0f ? 1 : 0, iNormalLength);
+    }
+
+    // Enough rays hit for the comparison to mean something
+    CHECK(uNumHits > 500u);
+}
@@ -0,0 +1,88 @@
+#include "Test.h"
+
+#include <cmath>
+#include <random>
+
+#include "Scene/VoxelRayCaster.h"
+
+using namespace library;
+
+BENCHMARK(VoxelRayCasterPicking1024x1024)
+{
+    constexpr const UINT MAP_SIZE = 1024u;
+    constexpr const UINT NUM_RAYS = 4096u;
+    constexpr const FLOAT MAX_DISTANCE = 256.0f;
+    constexpr const size_t NUM_BLOCK_TYPES = static_cast<size_t>(eBlockType::COUNT) - static_cast<size_t>(eBlockType::GRASSLAND);
+
+    // Rolling hills with a block type per band of height, like a generated map
+    std::vector<VoxelColumn> aColumns(static_cast<size_t>(MAP_SIZE) * MAP_SIZE);
+    for (UINT z = 0u; z < MAP_SIZE; ++z)
+    {
+        for (UINT x = 0u; x < MAP_SIZE; ++x)
+        {
+            const FLOAT height = 48.0f + 24.0f * std::sin(static_cast<FLOAT>(x) * 0.013f) * std::cos(static_cast<FLOAT>(z) * 0.017f) + 6.0f * std::sin(static_cast<FLOAT>(x + 2u * z) * 0.11f);
+            const UINT uHeight = static_cast<UINT>(std::max(height, 1.0f));
+            aColumns[static_cast<size_t>(z) * MAP_SIZE + x] = VoxelColumn
+            {
+                .BlockType = static_cast<CHAR>(static_cast<UINT>(eBlockType::GRASSLAND) + std::min(uHeight / 16u, static_cast<UINT>(NUM_BLOCK_TYPES) - 1u)),
+                .Reserved = 0u,
+                .Height = static_cast<WORD>(uHeight)
+            };
+        }
+    }
+
+    VoxelRayCaster caster;
+    caster.Build(aColumns.data(), MAP_SIZE, MAP_SIZE, NUM_BLOCK_TYPES);
+
+    VoxelOctree octree;
+    octree.Build(aColumns.data(), MAP_SIZE, MAP_SIZE, NUM_BLOCK_TYPES);
+
+    // A 64 x 64 grid of picking rays through a 90 degree frustum of cameras walking over the hills
+    std::mt19937 random(1u);
+    std::uniform_real_distribution<FLOAT> position(64.0f, static_cast<FLOAT>(MAP_SIZE) - 64.0f);
+    std::uniform_real_distribution<FLOAT> angle(0.0f, 6.2831853f);
+    std::vector<XMFLOAT3> aOrigins(NUM_RAYS);
+    std::vector<XMFLOAT3> aDirections(NUM_RAYS);
+    for (UINT uCamera = 0u; uCamera < NUM_RAYS / 64u; ++uCamera)
+    {
+        const FLOAT x = position(random);
+        const FLOAT z = position(random);
+        const FLOAT yaw = angle(random);
+        const FLOAT y = static_cast<FLOAT>(aColumns[static_cast<size_t>(z) * MAP_SIZE + static_cast<size_t>(x)].Height) + 4.0f;
+        for (UINT uPixel = 0u; uPixel < 64u; ++uPixel)
+        {
+            const FLOAT u = (static_cast<FLOAT>(uPixel % 8u) + 0.5f) / 4.0f - 1.0f;
+            const FLOAT v = (static_cast<FLOAT>(uPixel / 8u) + 0.5f) / 4.0f - 1.0f;
+            const FLOAT direction[3] = { std::cos(yaw) - u * std::sin(yaw), -0.35f + 0.5f * v, std::sin(yaw) + u * std::cos(yaw) };
+            const FLOAT length = std::sqrt(direction[0] * direction[0] + direction[1] * direction[1] + direction[2] * direction[2]);
+
+            aOrigins[uCamera * 64u + uPixel] = XMFLOAT3(x, y, z);
+            aDirections[uCamera * 64u + uPixel] = XMFLOAT3(direction[0] / length, direction[1] / length, direction[2] / length);
+        }
+    }
+
+    std::vector<VoxelRayHit> aHits(NUM_RAYS);
+    UINT uNumHits = 0u;
+    const double milliseconds = test::MeasureMilliseconds(50u, [&]()
+    {
+        uNumHits = 0u;
+        for (UINT uRay = 0u; uRay < NUM_RAYS; ++uRay)
+        {
+            uNumHits += caster.RayCast(aColumns.data(), aOrigins[uRay], aDirections[uRay], MAX_DISTANCE, aHits[uRay]) ? 1u : 0u;
+        }
+    });
+
+    // The octree finds the same cubes
+    UINT uNumMismatches = 0u;
+    for (UINT uRay = 0u; uRay < NUM_RAYS; ++uRay)
+    {
+        VoxelRayHit octreeHit;
+        const BOOL bOctreeHit = octree.RayCast(aOrigins[uRay], aDirections[uRay], MAX_DISTANCE, octreeHit);
+        const BOOL bHit = aHits[uRay].BlockType != 0;
+        uNumMismatches += bOctreeHit != bHit || (bHit && std::abs(octreeHit.Distance - aHits[uRay].Distance) > 1e-2f) ? 1u : 0u;
+    }
+    CHECK_EQUAL(0u, uNumMismatches);
+    CHECK(milliseconds < 1.0);
+
+    std::printf("  %u rays  %6.3f ms  %5.1f ns per ray  %u hit\n", NUM_RAYS, milliseconds, milliseconds * 1e6 / NUM_RAYS, uNumHits);
+}
@@ -0,0 +1,306 @@
+#include "Test.h"
+
+#include <cmath>
+#include <random>
+
+#include "Scene/VoxelRayCaster.h"
+
+using namespace library;
+
+namespace
+{
+    constexpr const CHAR GRASSLAND = static_cast<CHAR>(eBlockType::GRASSLAND);
+    constexpr const CHAR SNOW = static_cast<CHAR>(eBlockType::SNOW);
+    constexpr const size_t NUM_BLOCK_TYPES = 2u;
+    constexpr const FLOAT EPSILON = 1e-3f;
+
+    CHAR getReferenceBlockType(_In_ const std::vector<VoxelColumn>& aColumns, _In_ UINT uWidth, _In_ UINT uDepth, _In_ INT x, _In_ INT y, _In_ INT z)
+    {
+        if (x < 0 || y < 0 || z < 0 || x >= static_cast<INT>(uWidth) || z >= static_cast<INT>(uDepth))
+        {
+            return 0;
+        }
+
+        const VoxelColumn& column = aColumns[static_cast<size_t>(z) * uWidth + static_cast<size_t>(x)];
+        const size_t uTypeIdx = static_cast<size_t>(column.BlockType) - static_cast<size_t>(GRASSLAND);
+        return uTypeIdx < NUM_BLOCK_TYPES && y < static_cast<INT>(column.Height) ? column.BlockType : 0;
+    }
+
+    // Entry and exit distances of a unit ray through the cell [aCell, aCell + 1)
+    BOOL intersectCell(_In_ const FLOAT aOrigin[3], _In_ const FLOAT aDirection[3], _In_ const INT aCell[3], _Out_ FLOAT& tEnter, _Out_ FLOAT& tExit)
+    {
+        tEnter = -INFINITY;
+        tExit = INFINITY;
+        for (UINT uAxis = 0u; uAxis < 3u; ++uAxis)
+        {
+            const FLOAT lower = static_cast<FLOAT>(aCell[uAxis]);
+            const FLOAT upper = lower + 1.0f;
+            if (aDirection[uAxis] == 0.0f)
+            {
+                if (aOrigin[uAxis] < lower || aOrigin[uAxis] >= upper)
+                {
+                    return FALSE;
+                }
+                continue;
+            }
+
+            const FLOAT t0 = (lower - aOrigin[uAxis]) / aDirection[uAxis];
+            const FLOAT t1 = (upper - aOrigin[uAxis]) / aDirection[uAxis];
+            tEnter = std::max(tEnter, std::min(t0, t1));
+            tExit = std::min(tExit, std::max(t0, t1));
+        }
+
+        return tEnter <= tExit;
+    }
+
+    // Closest distance along the ray to any solid cell of the map
+    BOOL rayCastReference(_In_ const std::vector<VoxelColumn>& aColumns, _In_ UINT uWidth, _In_ UINT uDepth, _In_ const FLOAT aOrigin[3], _In_ const FLOAT aDirection[3], _In_ FLOAT maxDistance, _Out_ FLOAT& distance)
+    {
+        BOOL bHit = FALSE;
+        distance = INFINITY;
+        for (INT z = 0; z < static_cast<INT>(uDepth); ++z)
+        {
+            for (INT x = 0; x < static_cast<INT>(uWidth); ++x)
+            {
+                for (INT y = 0; y < static_cast<INT>(aColumns[static_cast<size_t>(z) * uWidth + static_cast<size_t>(x)].Height); ++y)
+                {
+                    const INT aCell[3] = { x, y, z };
+                    FLOAT tEnter;
+                    FLOAT tExit;
+                    if (getReferenceBlockType(aColumns, uWidth, uDepth, x, y, z) != 0 && intersectCell(aOrigin, aDirection, aCell, tEnter, tExit) && tExit > 0.0f && tEnter <= maxDistance)
+                    {
+                        bHit = TRUE;
+                        distance = std::min(distance, std::max(tEnter, 0.0f));
+                    }
+                }
+            }
+        }
+
+        return bHit;
+    }
+
+    std::vector<VoxelColumn> createColumns(_In_ std::mt19937& random, _In_ UINT uWidth, _In_ UINT uDepth)
+    {
+        // The third block type has no voxel and counts as air
+        std::uniform_int_distribution<INT> blockType(static_cast<INT>(GRASSLAND), static_cast<INT>(GRASSLAND) + 2);
+        std::uniform_int_distribution<INT> height(0, 12);
+
+        std::vector<VoxelColumn> aColumns(static_cast<size_t>(uWidth) * uDepth);
+        for (VoxelColumn& column : aColumns)
+        {
+            column = VoxelColumn{ .BlockType = static_cast<CHAR>(blockType(random)), .Reserved = 0u, .Height = static_cast<WORD>(height(random)) };
+        }
+
+        // A flat, low corner lets the rays skip whole blocks of columns
+        for (UINT z = 0u; z < uDepth / 2u; ++z)
+        {
+            for (UINT x = 0u; x < uWidth / 2u; ++x)
+            {
+                aColumns[static_cast<size_t>(z) * uWidth + x].Height = std::min<WORD>(aColumns[static_cast<size_t>(z) * uWidth + x].Height, 1u);
+            }
+        }
+
+        return aColumns;
+    }
+
+    // Casts random rays and compares each with the reference, returns the number of hits
+    UINT checkRays(_In_ const VoxelRayCaster& caster, _In_ const std::vector<VoxelColumn>& aColumns, _In_ UINT uWidth, _In_ UINT uDepth, _In_ UINT uSeed, _In_ UINT uNumRays)
+    {
+        constexpr const FLOAT MAX_DISTANCE = 40.0f;
+
+        std::mt19937 random(uSeed);
+        std::uniform_real_distribution<FLOAT> position(-4.0f, static_cast<FLOAT>(std::max(uWidth, uDepth)) + 4.0f);
+        std::uniform_real_distribution<FLOAT> height(-2.0f, 16.0f);
+        std::normal_distribution<FLOAT> direction(0.0f, 1.0f);
+        std::uniform_int_distribution<INT> axis(0, 5);
+
+        UINT uNumHits = 0u;
+        for (UINT uRay = 0u; uRay < uNumRays; ++uRay)
+        {
+            FLOAT aOrigin[3] = { position(random), height(random), position(random) };
+            FLOAT aDirection[3] = { direction(random), direction(random), direction(random) };
+            if (uRay % 4u == 0u)
+            {
+                // Rays along an axis never cross the cells beside them
+                const INT iAxis = axis(random);
+                for (INT i = 0; i < 3; ++i)
+                {
+                    aDirection[i] = i == iAxis % 3 ? (iAxis < 3 ? 1.0f : -1.0f) : 0.0f;
+                }
+            }
+            const FLOAT length = std::sqrt(aDirection[0] * aDirection[0] + aDirection[1] * aDirection[1] + aDirection[2] * aDirection[2]);
+            for (FLOAT& component : aDirection)
+            {
+                component /= length;
+            }
+
+            FLOAT referenceDistance;
+            const BOOL bReferenceHit = rayCastReference(aColumns, uWidth, uDepth, aOrigin, aDirection, MAX_DISTANCE, referenceDistance);
+
+            VoxelRayHit hit;
+            const BOOL bHit = caster.RayCast(aColumns.data(), XMFLOAT3(aOrigin[0], aOrigin[1], aOrigin[2]), XMFLOAT3(aDirection[0], aDirection[1], aDirection[2]), MAX_DISTANCE, hit);
+            CHECK_EQUAL(bReferenceHit, bHit);
+            if (!bHit || !bReferenceHit)
+            {
+                continue;
+            }
+
+            ++uNumHits;
+            CHECK(std::abs(referenceDistance - hit.Distance) < EPSILON);
+            CHECK_EQUAL(getReferenceBlockType(aColumns, uWidth, uDepth, hit.Cell.x, hit.Cell.y, hit.Cell.z), hit.BlockType);
+
+            // The cell reported is solid and the ray reaches it at the distance reported
+            const INT aCell[3] = { hit.Cell.x, hit.Cell.y, hit.Cell.z };
+            FLOAT tEnter;
+            FLOAT tExit;
+            CHECK(intersectCell(aOrigin, aDirection, aCell, tEnter, tExit));
+            CHECK(std::abs(std::max(tEnter, 0.0f) - hit.Distance) < EPSILON);
+
+            // The normal is the face the ray entered through, zero when it starts inside the cube
+            const INT aNormal[3] = { hit.Normal.x, hit.Normal.y, hit.Normal.z };
+            INT iNormalLength = 0;
+            for (UINT uAxis = 0u; uAxis < 3u; ++uAxis)
+            {
+                iNormalLength += std::abs(aNormal[uAxis]);
+                CHECK(static_cast<FLOAT>(aNormal[uAxis]) * aDirection[uAxis] <= 0.0f);
+                if (aNormal[uAxis] != 0)
+                {
+                    const FLOAT face = static_cast<FLOAT>(aCell[uAxis] + (aNormal[uAxis] > 0 ? 1 : 0));
+                    CHECK(std::abs(aOrigin[uAxis] + aDirection[uAxis] * hit.Distance - face) < EPSILON);
+                }
+            }
+            CHECK_EQUAL(hit.Distance > 0.0f ? 1 : 0, iNormalLength);
+        }
+
+        return uNumHits;
+    }
+}
+
+TEST(VoxelRayCasterHitsTopFace)
+{
+    const std::vector<VoxelColumn> aColumns(4u * 4u, VoxelColumn{ .BlockType = SNOW, .Reserved = 0u, .Height = 3u });
+
+    VoxelRayCaster caster;
+    caster.Build(aColumns.data(), 4u, 4u, NUM_BLOCK_TYPES);
+    CHECK_EQUAL(3u, caster.GetMaxHeight());
+
+    VoxelRayHit hit;
+    CHECK(caster.RayCast(aColumns.data(), XMFLOAT3(1.5f, 10.0f, 2.5f), XMFLOAT3(0.0f, -2.0f, 0.0f), 20.0f, hit));
+    CHECK_EQUAL(1, hit.Cell.x);
+    CHECK_EQUAL(2, hit.Cell.y);
+    CHECK_EQUAL(2, hit.Cell.z);
+    CHECK_EQUAL(1, hit.Normal.y);
+    CHECK_EQUAL(SNOW, hit.BlockType);
+    CHECK(std::abs(hit.Distance - 7.0f) < EPSILON);
+
+    // Too short to reach the top, or pointing away from the map
+    CHECK(!caster.RayCast(aColumns.data(), XMFLOAT3(1.5f, 10.0f, 2.5f), XMFLOAT3(0.0f, -1.0f, 0.0f), 6.5f, hit));
+    CHECK(!caster.RayCast(aColumns.data(), XMFLOAT3(1.5f, 10.0f, 2.5f), XMFLOAT3(0.0f, 1.0f, 0.0f), 20.0f, hit));
+    CHECK(!caster.RayCast(aColumns.data(), XMFLOAT3(1.5f, 10.0f, 2.5f), XMFLOAT3(0.0f, 0.0f, 0.0f), 20.0f, hit));
+}
+
+TEST(VoxelRayCasterMatchesReferenceRays)
+{
+    std::mt19937 random(19u);
+    for (UINT uMap = 0u; uMap < 3u; ++uMap)
+    {
+        const UINT uWidth = 21u + uMap * 6u;
+        const UINT uDepth = 19u;
+        const std::vector<VoxelColumn> aColumns = createColumns(random, uWidth, uDepth);
+
+        VoxelRayCaster caster;
+        caster.Build(aColumns.data(), uWidth, uDepth, NUM_BLOCK_TYPES);
+
+        // Enough rays hit for the comparison to mean something
+        CHECK(checkRays(caster, aColumns, uWidth, uDepth, 23u + uMap, 1500u) > 300u);
+    }
+}
+
+TEST(VoxelRayCasterUpdateMatchesBuild)
+{
+    constexpr const UINT MAP_WIDTH = 27u;
+    constexpr const UINT MAP_DEPTH = 22u;
+
+    std::mt19937 random(29u);
+    std::vector<VoxelColumn> aColumns = createColumns(random, MAP_WIDTH, MAP_DEPTH);
+
+    VoxelRayCaster caster;
+    caster.Build(aColumns.data(), MAP_WIDTH, MAP_DEPTH, NUM_BLOCK_TYPES);
+
+    // Raise and lower rectangles of columns, including whole blocks that become empty
+    std::uniform_int_distribution<UINT> position(0u, 20u);
+    std::uniform_int_distribution<UINT> size(1u, 6u);
+    std::uniform_int_distribution<INT> height(0, 14);
+    for (UINT uEdit = 0u; uEdit < 40u; ++uEdit)
+    {
+        const UINT uX = position(random);
+        const UINT uZ = position(random) % (MAP_DEPTH - 6u);
+        const UINT uWidth = size(random);
+        const UINT uDepth = size(random);
+        const WORD newHeight = static_cast<WORD>(uEdit % 3u == 0u ? 0 : height(random));
+        for (UINT z = uZ; z < uZ + uDepth; ++z)
+        {
+            for (UINT x = uX; x < uX + uWidth; ++x)
+            {
+                aColumns[static_cast<size_t>(z) * MAP_WIDTH + x] = VoxelColumn{ .BlockType = SNOW, .Reserved = 0u, .Height = newHeight };
+            }
+        }
+        caster.Update(aColumns.data(), uX, uZ, uWidth, uDepth);
+    }
+
+    VoxelRayCaster reference;
+    reference.Build(aColumns.data(), MAP_WIDTH, MAP_DEPTH, NUM_BLOCK_TYPES);
+    CHECK(reference.GetHeights() == caster.GetHeights());
+    CHECK(reference.GetMaxHeight() <= caster.GetMaxHeight());
+    CHECK(checkRays(caster, aColumns, MAP_WIDTH, MAP_DEPTH, 31u, 1500u) > 300u);
+}
+
+TEST(VoxelRayCasterMatchesOctreeOverHills)
+{
+    constexpr const UINT MAP_SIZE = 256u;
+    constexpr const FLOAT MAX_DISTANCE = 128.0f;
+
+    // Rays skim the hills at shallow angles, so they skip blocks and leave them right next to their corners
+    std::vector<VoxelColumn> aColumns(static_cast<size_t>(MAP_SIZE) * MAP_SIZE);
+    for (UINT z = 0u; z < MAP_SIZE; ++z)
+    {
+        for (UINT x = 0u; x < MAP_SIZE; ++x)
+        {
+            const FLOAT height = 24.0f + 12.0f * std::sin(static_cast<FLOAT>(x) * 0.05f) * std::cos(static_cast<FLOAT>(z) * 0.07f) + 3.0f * std::sin(static_cast<FLOAT>(x + 2u * z) * 0.3f);
+            aColumns[static_cast<size_t>(z) * MAP_SIZE + x] = VoxelColumn{ .BlockType = x < z ? GRASSLAND : SNOW, .Reserved = 0u, .Height = static_cast<WORD>(height) };
+        }
+    }
+
+    VoxelRayCaster caster;
+    caster.Build(aColumns.data(), MAP_SIZE, MAP_SIZE, NUM_BLOCK_TYPES);
+    VoxelOctree octree;
+    octree.Build(aColumns.data(), MAP_SIZE, MAP_SIZE, NUM_BLOCK_TYPES);
+
+    std::mt19937 random(37u);
+    std::uniform_real_distribution<FLOAT> position(0.0f, static_cast<FLOAT>(MAP_SIZE));
+    std::uniform_real_distribution<FLOAT> height(30.0f, 45.0f);
+    std::uniform_real_distribution<FLOAT> angle(0.0f, 6.2831853f);
+    std::uniform_real_distribution<FLOAT> pitch(-0.4f, 0.1f);
+
+    UINT uNumHits = 0u;
+    for (UINT uRay = 0u; uRay < 20000u; ++uRay)
+    {
+        const FLOAT yaw = angle(random);
+        const XMFLOAT3 origin(position(random), height(random), position(random));
+        const XMFLOAT3 direction(std::cos(yaw), pitch(random), std::sin(yaw));
+        const FLOAT length = std::sqrt(direction.x * direction.x + direction.y * direction.y + direction.z * direction.z);
+        const XMFLOAT3 unitDirection(direction.x / length, direction.y / length, direction.z / length);
+
+        VoxelRayHit hit;
+        VoxelRayHit octreeHit;
+        const BOOL bCasterHit = caster.RayCast(aColumns.data(), origin, unitDirection, MAX_DISTANCE, hit);
+        CHECK_EQUAL(octree.RayCast(origin, unitDirection, MAX_DISTANCE, octreeHit), bCasterHit);
+        if (bCasterHit)
+        {
+            ++uNumHits;
+            CHECK(std::abs(octreeHit.Distance - hit.Distance) < 1e-2f);
+            CHECK_EQUAL(octreeHit.BlockType, hit.BlockType);
+        }
+    }
+    CHECK(uNumHits > 5000u);
+}
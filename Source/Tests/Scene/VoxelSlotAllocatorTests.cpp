@@ -0,0 +1,134 @@
+#include "Test.h"
+
+#include <random>
+
+#include "Scene/VoxelSlotAllocator.h"
+
+using namespace library;
+
+TEST(VoxelSlotAllocatorMergesNeighbors)
+{
+    VoxelSlotAllocator allocator;
+    const VoxelSlotRange first = allocator.Allocate(4u);
+    const VoxelSlotRange second = allocator.Allocate(8u);
+    const VoxelSlotRange third = allocator.Allocate(2u);
+    allocator.Allocate(1u);
+    CHECK_EQUAL(15u, allocator.GetNumSlots());
+
+    // The middle range merges with the one before it, then with the one after it
+    allocator.Free(first);
+    allocator.Free(third);
+    CHECK_EQUAL(2u, allocator.GetFreeRanges().size());
+    allocator.Free(second);
+    CHECK_EQUAL(1u, allocator.GetFreeRanges().size());
+    CHECK_EQUAL(0u, allocator.GetFreeRanges()[0].uFirstSlot);
+    CHECK_EQUAL(14u, allocator.GetFreeRanges()[0].uNumSlots);
+
+    // A range the merged hole fits no longer goes to the end
+    const VoxelSlotRange reused = allocator.Allocate(12u);
+    CHECK_EQUAL(0u, reused.uFirstSlot);
+    CHECK_EQUAL(15u, allocator.GetNumSlots());
+}
+
+TEST(VoxelSlotAllocatorGivesTheEndBack)
+{
+    VoxelSlotAllocator allocator;
+    allocator.Allocate(4u);
+    const VoxelSlotRange second = allocator.Allocate(4u);
+    const VoxelSlotRange third = allocator.Allocate(4u);
+
+    // Freeing the hole first then the last range moves the end over both
+    allocator.Free(second);
+    CHECK_EQUAL(12u, allocator.GetNumSlots());
+    allocator.Free(third);
+    CHECK_EQUAL(4u, allocator.GetNumSlots());
+    CHECK(allocator.GetFreeRanges().empty());
+
+    allocator.Reset();
+    CHECK_EQUAL(0u, allocator.GetNumSlots());
+    CHECK_EQUAL(0u, allocator.Allocate(3u).uFirstSlot);
+}
+
+TEST(VoxelSlotAllocatorTakesTheFirstFit)
+{
+    VoxelSlotAllocator allocator;
+    const VoxelSlotRange small = allocator.Allocate(2u);
+    allocator.Allocate(1u);
+    const VoxelSlotRange large = allocator.Allocate(6u);
+    allocator.Allocate(1u);
+    allocator.Free(small);
+    allocator.Free(large);
+
+    // Too large for the first hole, split off the front of the second
+    const VoxelSlotRange slots = allocator.Allocate(4u);
+    CHECK_EQUAL(large.uFirstSlot, slots.uFirstSlot);
+    CHECK_EQUAL(2u, allocator.GetFreeRanges().size());
+    CHECK_EQUAL(large.uFirstSlot + 4u, allocator.GetFreeRanges()[1].uFirstSlot);
+    CHECK_EQUAL(2u, allocator.GetFreeRanges()[1].uNumSlots);
+
+    // Empty ranges are ignored
+    allocator.Free(VoxelSlotRange{ .uFirstSlot = 0u, .uNumSlots = 0u });
+    CHECK_EQUAL(2u, allocator.GetFreeRanges().size());
+}
+
+TEST(VoxelSlotAllocatorMatchesBitmap)
+{
+    // Random chunks growing and moving, checked against a map of the taken slots
+    std::mt19937 random(7u);
+    VoxelSlotAllocator allocator;
+    std::vector<VoxelSlotRange> aTaken;
+    std::vector<BOOL> aUsed;
+    for (UINT uStep = 0u; uStep < 20000u; ++uStep)
+    {
+        if (aTaken.empty() || random() % 3u != 0u)
+        {
+            const VoxelSlotRange slots = allocator.Allocate(1u + random() % 64u);
+            aUsed.resize(std::max(aUsed.size(), static_cast<size_t>(allocator.GetNumSlots())), FALSE);
+            for (UINT uSlot = slots.uFirstSlot; uSlot < slots.uFirstSlot + slots.uNumSlots; ++uSlot)
+            {
+                CHECK(!aUsed[uSlot]);
+                aUsed[uSlot] = TRUE;
+            }
+            aTaken.push_back(slots);
+        }
+        else
+        {
+            const size_t uIdx = random() % aTaken.size();
+            const VoxelSlotRange slots = aTaken[uIdx];
+            aTaken[uIdx] = aTaken.back();
+            aTaken.pop_back();
+            allocator.Free(slots);
+            for (UINT uSlot = slots.uFirstSlot; uSlot < slots.uFirstSlot + slots.uNumSlots; ++uSlot)
+            {
+                aUsed[uSlot] = FALSE;
+            }
+        }
+
+        // The end is right past the last taken slot
+        size_t uEnd = aUsed.size();
+        while (uEnd > 0u && !aUsed[uEnd - 1u])
+        {
+            --uEnd;
+        }
+        CHECK_EQUAL(uEnd, static_cast<size_t>(allocator.GetNumSlots()));
+
+        // The free ranges are exactly the holes below the end
+        UINT uNumFree = 0u;
+        UINT uPrevEnd = 0u;
+        BOOL bPrev = FALSE;
+        for (const VoxelSlotRange& range : allocator.GetFreeRanges())
+        {
+            CHECK(!bPrev || range.uFirstSlot > uPrevEnd);
+            CHECK(range.uFirstSlot + range.uNumSlots < allocator.GetNumSlots());
+            uNumFree += range.uNumSlots;
+            uPrevEnd = range.uFirstSlot + range.uNumSlots;
+            bPrev = TRUE;
+        }
+        UINT uNumHoles = 0u;
+        for (size_t uSlot = 0u; uSlot < uEnd; ++uSlot)
+        {
+            uNumHoles += aUsed[uSlot] ? 0u : 1u;
+        }
+        CHECK_EQUAL(uNumHoles, uNumFree);
+    }
+}
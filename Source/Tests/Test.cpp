@@ -0,0 +1,117 @@
+#include "Test.h"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+namespace test
+{
+    namespace
+    {
+        UINT s_uNumFailures = 0u;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: GetTests
+
+      Summary:  Returns the registered tests
+
+      Returns:  std::vector<TestCase>&
+                  Tests in the order they are registered
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    std::vector<TestCase>& GetTests()
+    {
+        static std::vector<TestCase> s_aTests;
+        return s_aTests;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: GetBenchmarks
+
+      Summary:  Returns the registered benchmarks
+
+      Returns:  std::vector<TestCase>&
+                  Benchmarks in the order they are registered
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    std::vector<TestCase>& GetBenchmarks()
+    {
+        static std::vector<TestCase> s_aBenchmarks;
+        return s_aBenchmarks;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: ReportFailure
+
+      Summary:  Prints a failed check and counts it
+
+      Args:     const char* pszFile
+                  File of the check
+                INT iLine
+                  Line of the check
+                const char* pszExpression
+                  Expression that was false
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    void ReportFailure(_In_ const char* pszFile, _In_ INT iLine, _In_ const char* pszExpression)
+    {
+        std::fprintf(stderr, "%s(%d): CHECK(%s) failed\n", pszFile, iLine, pszExpression);
+        ++s_uNumFailures;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: GetNumFailures
+
+      Summary:  Returns the number of failed checks so far
+
+      Returns:  UINT
+                  Number of failed checks
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    UINT GetNumFailures()
+    {
+        return s_uNumFailures;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: MeasureMilliseconds
+
+      Summary:  Runs a function several times and returns its fastest
+                run, the one least disturbed by the rest of the machine
+
+      Args:     UINT uRepetitions
+                  Number of runs
+                const std::function<void()>& run
+                  Function to measure
+
+      Returns:  double
+                  Milliseconds of the fastest run
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    double MeasureMilliseconds(_In_ UINT uRepetitions, _In_ const std::function<void()>& run)
+    {
+        double best = std::numeric_limits<double>::max();
+        for (UINT i = 0u; i < uRepetitions; ++i)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            run();
+            const auto end = std::chrono::steady_clock::now();
+            best = std::min(best, std::chrono::duration<double, std::milli>(end - start).count());
+        }
+
+        return best;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: GetTemporaryPath
+
+      Summary:  Returns a path in the temporary directory for the files
+                a test writes
+
+      Args:     const char* pszName
+                  Name of the file
+
+      Returns:  std::filesystem::path
+                  Path of the file
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    std::filesystem::path GetTemporaryPath(_In_ const char* pszName)
+    {
+        return std::filesystem::temp_directory_path() / (std::string("LibraryTests-") + pszName);
+    }
+}
@@ -0,0 +1,74 @@
+/*+===================================================================
+  File:      TEST.H
+
+  Summary:   Test header file contains the macros that register the
+             tests and benchmarks of the headless parts of the Library
+             and check their results.
+
+  Functions: GetTests, GetBenchmarks, ReportFailure,
+             MeasureMilliseconds, GetTemporaryPath
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Platform.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <functional>
+
+namespace test
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   TestCase
+      Summary:  Name and body of a registered test or benchmark
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct TestCase
+    {
+        const char* pszName;
+        void (*pfnRun)();
+    };
+
+    std::vector<TestCase>& GetTests();
+    std::vector<TestCase>& GetBenchmarks();
+
+    void ReportFailure(_In_ const char* pszFile, _In_ INT iLine, _In_ const char* pszExpression);
+    UINT GetNumFailures();
+
+    double MeasureMilliseconds(_In_ UINT uRepetitions, _In_ const std::function<void()>& run);
+    std::filesystem::path GetTemporaryPath(_In_ const char* pszName);
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   Registrar
+      Summary:  Registers a test or benchmark before main runs
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct Registrar
+    {
+        Registrar(_Inout_ std::vector<TestCase>& aCases, _In_ const char* pszName, _In_ void (*pfnRun)())
+        {
+            aCases.push_back(TestCase{ .pszName = pszName, .pfnRun = pfnRun });
+        }
+    };
+}
+
+#define TEST(name) \
+    static void name(); \
+    static test::Registrar name##Registrar(test::GetTests(), #name, name); \
+    static void name()
+
+#define BENCHMARK(name) \
+    static void name(); \
+    static test::Registrar name##Registrar(test::GetBenchmarks(), #name, name); \
+    static void name()
+
+#define CHECK(expression) \
+    do \
+    { \
+        if (!(expression)) \
+        { \
+            test::ReportFailure(__FILE__, __LINE__, #expression); \
+        } \
+    } while (0)
+
+#define CHECK_EQUAL(expected, actual) CHECK((expected) == (actual))
@@ -0,0 +1,34 @@
+/*+===================================================================
+  File:      TESTMAIN.CPP
+
+  Summary:   Runs the registered tests, or the ones whose name
+             contains the first argument, and fails if a check failed.
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#include "Test.h"
+
+#include <cstring>
+
+int main(int argc, char** argv)
+{
+    const char* pszFilter = argc > 1 ? argv[1] : "";
+
+    UINT uNumRun = 0u;
+    for (const test::TestCase& testCase : test::GetTests())
+    {
+        if (!std::strstr(testCase.pszName, pszFilter))
+        {
+            continue;
+        }
+
+        const UINT uNumFailures = test::GetNumFailures();
+        testCase.pfnRun();
+        std::printf("%s %s\n", test::GetNumFailures() == uNumFailures ? "[  OK  ]" : "[ FAIL ]", testCase.pszName);
+        ++uNumRun;
+    }
+
+    std::printf("%u tests, %u failed checks\n", uNumRun, test::GetNumFailures());
+
+    return test::GetNumFailures() == 0u ? 0 : 1;
+}